@@ -24,6 +24,10 @@
 #ifndef CHIPPROJECTCONFIG_H
 #define CHIPPROJECTCONFIG_H
 
+#if CHIP_SYSTEM_CONFIG_TEST
+#include "TestProjectConfig.h"
+#endif // CHIP_SYSTEM_CONFIG_TEST
+
 #define CHIP_CONFIG_ENABLE_EPHEMERAL_UDP_PORT 1
 
 #define CHIP_CONFIG_EVENT_LOGGING_NUM_EXTERNAL_CALLBACKS 2
@@ -78,7 +82,9 @@
 // Default of 8 ECs is not sufficient for some of the unit tests
 // that try to validate multiple simultaneous interactions.
 //
+#ifndef CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS
 #define CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS 16
+#endif
 
 //
 // Set this to a value greater than the value for CHIP_IM_MAX_NUM_READ_HANDLER
@@ -89,6 +95,11 @@
 //
 #define CHIP_IM_MAX_NUM_READ_CLIENT 6
 
+//
+// Enough attribute paths for the 64 subscriptions of the SetDirty benchmark in TestReportingEngine.
+//
+#define CHIP_IM_SERVER_MAX_NUM_PATH_GROUPS 256
+
 #define CONFIG_IM_BUILD_FOR_UNIT_TEST 1
 
 #endif /* CHIPPROJECTCONFIG_H */
@@ -0,0 +1,53 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      CHIP project configuration overrides for standalone builds of the unit tests.
+ *
+ *      Included by CHIPProjectConfig.h when CHIP_SYSTEM_CONFIG_TEST is set, so that
+ *      settings only the tests need stay out of the standalone applications.
+ *
+ */
+#ifndef TESTPROJECTCONFIG_H
+#define TESTPROJECTCONFIG_H
+
+//
+// Enough sessions and exchanges for the 50 concurrent handshakes of the event loop latency
+// benchmark in TestCASESession. Each handshake holds an unauthenticated session, an exchange
+// with its timers and then a secure session at both ends. The timers only need room when the
+// pools are not on the heap.
+//
+#define CHIP_SYSTEM_CONFIG_NUM_TIMERS 256
+#define CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS 128
+#define CHIP_CONFIG_UNAUTHENTICATED_CONNECTION_POOL_SIZE 128
+#define CHIP_CONFIG_PEER_CONNECTION_POOL_SIZE 128
+#define CHIP_CONFIG_CASE_SERVER_MAX_HANDSHAKES 64
+
+//
+// Packet buffers rounded up to size classes and cached for reuse, so that the unit tests cover them
+// until the applications turn them on.
+//
+#define CHIP_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES 1
+
+//
+// Packet buffer allocations and copies counted for the tests that enable PacketBufferCounters, so
+// far only the receive path test of TestSessionManager.
+//
+#define CHIP_SYSTEM_CONFIG_PACKETBUFFER_COUNTERS 1
+
+#endif /* TESTPROJECTCONFIG_H */
@@ -90,7 +90,7 @@ public:
     uint64_t GetTransferLength(void);
 
     /* ota-provider-common/OTAProviderExample.cpp requires this */
-    void SetFilepath(const char * path) {}
+    CHIP_ERROR SetFilepath(const char * path) { return CHIP_NO_ERROR; }
 
 private:
     // Inherited from bdx::TransferFacilitator
@@ -16,25 +16,26 @@
  */
 
 #include <protocols/bdx/BdxTransferSession.h>
-#include <protocols/bdx/TransferFacilitator.h>
+#include <protocols/bdx/FileSender.h>
 
 #pragma once
 
-class BdxOtaSender : public chip::bdx::Responder
+/**
+ * Serves the OTA image to the OTA requestors, with up to CHIP_CONFIG_BDX_MAX_FILE_SENDERS concurrent transfers sharing a mapping
+ * of the image.
+ */
+class BdxOtaSender : public chip::bdx::FileSenderPool
 {
 public:
-    BdxOtaSender();
-
-    void SetFilepath(const char * path);
-
-private:
-    // Inherited from bdx::TransferFacilitator
-    void HandleTransferSessionOutput(chip::bdx::TransferSession::OutputEvent & event) override;
-
-    void Reset();
-
-    static constexpr size_t kFilepathMaxLength = 256;
-    char mFilepath[kFilepathMaxLength];
-
-    uint32_t mNumBytesSent = 0;
+    /**
+     * Map the image to serve. Fails with CHIP_ERROR_INCORRECT_STATE while transfers of another image are ongoing.
+     */
+    CHIP_ERROR SetFilepath(const char * path);
+
+    /**
+     * Set the parameters of the transfers started afterwards. Only receiver driven transfers, with the sender role, are supported.
+     */
+    CHIP_ERROR PrepareForTransfer(chip::System::Layer * layer, chip::bdx::TransferRole role,
+                                  chip::BitFlags<chip::bdx::TransferControlFlags> xferControlOpts, uint16_t maxBlockSize,
+                                  chip::System::Clock::Timeout timeout, chip::System::Clock::Timeout pollFreq);
 };
@@ -27,6 +27,8 @@
 #include <crypto/RandUtils.h>
 #include <lib/core/CHIPTLV.h>
 #include <lib/support/CHIPMemString.h>
+#include <platform/CHIPDeviceConfig.h>
+#include <protocols/bdx/BdxTransferSession.h>
 #include <protocols/bdx/BdxUri.h>
 
 #include <string.h>
@@ -54,7 +56,13 @@ constexpr size_t kUriMaxLen                  = 256;
 constexpr uint32_t kMinimumDelayedActionTime = 120; // Spec mentions delayed action time should be at least 120 seconds
 
 // Arbitrary BDX Transfer Params
-constexpr uint32_t kMaxBdxBlockSize                 = 1024;
+#if CHIP_DEVICE_LAYER_TARGET_LINUX || CHIP_DEVICE_LAYER_TARGET_DARWIN
+// The FileSenderPool based BdxOtaSender sends blocks straight from the mapped image
+constexpr uint16_t kMaxBdxBlockSize = chip::bdx::TransferSession::kMaxBlockSize; // The largest a message can carry
+#else
+// Other platforms bring their own BdxOtaSender, which may not handle larger blocks
+constexpr uint16_t kMaxBdxBlockSize = 1024;
+#endif
 constexpr chip::System::Clock::Timeout kBdxTimeout  = chip::System::Clock::Seconds16(5 * 60); // OTA Spec mandates >= 5 minutes
 constexpr chip::System::Clock::Timeout kBdxPollFreq = chip::System::Clock::Milliseconds32(500);
 
@@ -247,6 +255,17 @@ EmberAfStatus OTAProviderExample::HandleQueryImage(chip::app::CommandHandler * c
         break;
     }
 
+    if (queryStatus == OTAQueryStatus::kUpdateAvailable)
+    {
+        // The image is mapped before it is offered. Another image cannot be mapped until its ongoing transfers end.
+        CHIP_ERROR err = mBdxOtaSender.SetFilepath(otaFilePath);
+        if (err != CHIP_NO_ERROR)
+        {
+            queryStatus          = (err == CHIP_ERROR_INCORRECT_STATE) ? OTAQueryStatus::kBusy : OTAQueryStatus::kNotAvailable;
+            delayedActionTimeSec = std::max(kMinimumDelayedActionTime, delayedActionTimeSec);
+        }
+    }
+
     if (queryStatus == OTAQueryStatus::kUpdateAvailable)
     {
         GenerateUpdateToken(updateToken, kUpdateTokenLen);
@@ -265,7 +284,6 @@ EmberAfStatus OTAProviderExample::HandleQueryImage(chip::app::CommandHandler * c
         ChipLogDetail(SoftwareUpdate, "Generated URI: %.*s", static_cast<int>(uri.size()), uri.data());
 
         // Initialize the transfer session in prepartion for a BDX transfer
-        mBdxOtaSender.SetFilepath(otaFilePath);
         BitFlags<TransferControlFlags> bdxFlags;
         bdxFlags.Set(TransferControlFlags::kReceiverDrive);
         CHIP_ERROR err = mBdxOtaSender.PrepareForTransfer(&chip::DeviceLayer::SystemLayer(), chip::bdx::TransferRole::kSender,
@@ -19,6 +19,8 @@
 #include <platform/CHIPDeviceLayer.h>
 #include <platform/PlatformManager.h>
 
+#include <app/EventManagement.h>
+#include <app/FileEventStore.h>
 #include <app/clusters/network-commissioning/network-commissioning.h>
 #include <app/server/OnboardingCodesUtil.h>
 #include <app/server/Server.h>
@@ -87,6 +89,31 @@ void EventHandler(const DeviceLayer::ChipDeviceEvent * event, intptr_t arg)
         ChipLogProgress(DeviceLayer, "Receive kCHIPoBLEConnectionEstablished");
     }
 }
+
+#if CHIP_CONFIG_ENABLE_SERVER_IM_EVENT
+app::FileEventStore gEventStore;
+
+void InitEventStore(const char * path)
+{
+    CHIP_ERROR err = gEventStore.Init(path);
+    if (err == CHIP_NO_ERROR)
+    {
+        err = app::EventManagement::GetInstance().SetPersistentEventStore(&gEventStore);
+    }
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(AppServer, "Failed to set up the event store at %s: %" CHIP_ERROR_FORMAT, path, err.Format());
+    }
+}
+
+void ShutdownEventStore()
+{
+    // Stores the events still in the event buffers. The signal handlers exit without returning from the event loop, so
+    // on a signal only the events already evicted to the store are kept.
+    app::EventManagement::DestroyEventManagement();
+    gEventStore.Shutdown();
+}
+#endif // CHIP_CONFIG_ENABLE_SERVER_IM_EVENT
 } // namespace
 
 #if CHIP_DEVICE_CONFIG_ENABLE_WPA
@@ -511,6 +538,14 @@ void ChipLinuxAppMainLoop()
     // Init ZCL Data Model and CHIP App Server
     Server::GetInstance().Init(nullptr, securePort, unsecurePort);
 
+#if CHIP_CONFIG_ENABLE_SERVER_IM_EVENT
+    // Events are only logged once the event loop runs, so this comes before the first one as required.
+    if (LinuxDeviceOptions::GetInstance().eventStore != nullptr)
+    {
+        InitEventStore(LinuxDeviceOptions::GetInstance().eventStore);
+    }
+#endif // CHIP_CONFIG_ENABLE_SERVER_IM_EVENT
+
     // Now that the server has started and we are done with our startup logging,
     // log our discovery/onboarding information again so it's not lost in the
     // noise.
@@ -532,6 +567,13 @@ void ChipLinuxAppMainLoop()
 
     DeviceLayer::PlatformMgr().RunEventLoop();
 
+#if CHIP_CONFIG_ENABLE_SERVER_IM_EVENT
+    if (LinuxDeviceOptions::GetInstance().eventStore != nullptr)
+    {
+        ShutdownEventStore();
+    }
+#endif // CHIP_CONFIG_ENABLE_SERVER_IM_EVENT
+
 #if CHIP_DEVICE_CONFIG_ENABLE_BOTH_COMMISSIONER_AND_COMMISSIONEE
     ShutdownCommissioner();
 #endif // CHIP_DEVICE_CONFIG_ENABLE_BOTH_COMMISSIONER_AND_COMMISSIONEE
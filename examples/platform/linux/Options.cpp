@@ -48,7 +48,8 @@ enum
     kDeviceOption_UnsecuredCommissionerPort = 0x100c,
     kDeviceOption_Command                   = 0x100d,
     kDeviceOption_PICS                      = 0x100e,
-    kDeviceOption_KVS                       = 0x100f
+    kDeviceOption_KVS                       = 0x100f,
+    kDeviceOption_EventStore                = 0x1010
 };
 
 constexpr unsigned kAppUsageLength = 64;
@@ -76,6 +77,7 @@ OptionDef sDeviceOptionDefs[] = {
     { "command", kArgumentRequired, kDeviceOption_Command },
     { "PICS", kArgumentRequired, kDeviceOption_PICS },
     { "KVS", kArgumentRequired, kDeviceOption_KVS },
+    { "event-store", kArgumentRequired, kDeviceOption_EventStore },
     {}
 };
 
@@ -134,6 +136,9 @@ const char * sDeviceOptionHelp =
     "\n"
     "  --KVS <filepath>\n"
     "       A file to store Key Value Store items.\n"
+    "\n"
+    "  --event-store <filepath>\n"
+    "       Keep the events dropped from the event buffers in files at <filepath>.0 and <filepath>.1.\n"
     "\n";
 
 bool HandleOption(const char * aProgram, OptionSet * aOptions, int aIdentifier, const char * aName, const char * aValue)
@@ -222,6 +227,10 @@ bool HandleOption(const char * aProgram, OptionSet * aOptions, int aIdentifier,
         LinuxDeviceOptions::GetInstance().KVS = aValue;
         break;
 
+    case kDeviceOption_EventStore:
+        LinuxDeviceOptions::GetInstance().eventStore = aValue;
+        break;
+
     default:
         PrintArgError("%s: INTERNAL ERROR: Unhandled option: %s\n", aProgram, aName);
         retval = false;
@@ -41,6 +41,7 @@ struct LinuxDeviceOptions
     const char * command               = nullptr;
     const char * PICS                  = nullptr;
     const char * KVS                   = nullptr;
+    const char * eventStore            = nullptr;
 
     static LinuxDeviceOptions & GetInstance();
 };
@@ -18,6 +18,11 @@
 
 #include "AccessControl.h"
 
+#include <algorithm>
+#include <limits>
+
+#include <lib/support/TypeTraits.h>
+
 namespace {
 
 using chip::CATValues;
@@ -61,6 +66,22 @@ bool CheckRequestPrivilegeAgainstEntryPrivilege(Privilege requestPrivilege, Priv
     return false;
 }
 
+bool SubjectDescriptorsMatch(const SubjectDescriptor & a, const SubjectDescriptor & b)
+{
+    if (a.fabricIndex != b.fabricIndex || a.authMode != b.authMode || a.subject != b.subject)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < CATValues::size(); ++i)
+    {
+        if (a.cats.values[i] != b.cats.values[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 #if CHIP_DETAIL_LOGGING
 
 char GetAuthModeStringForLogging(AuthMode authMode)
@@ -156,12 +177,16 @@ AccessControl::Delegate AccessControl::mDefaultDelegate;
 CHIP_ERROR AccessControl::Init()
 {
     ChipLogDetail(DataManagement, "AccessControl: initializing");
+    InvalidateEntryIndex();
+    mDelegate.SetListener(mEntryListener);
     return mDelegate.Init();
 }
 
 CHIP_ERROR AccessControl::Finish()
 {
     ChipLogDetail(DataManagement, "AccessControl: finishing");
+    mDelegate.ClearListener();
+    InvalidateEntryIndex();
     return mDelegate.Finish();
 }
 
@@ -186,6 +211,50 @@ CHIP_ERROR AccessControl::Check(const SubjectDescriptor & subjectDescriptor, con
     // Operational PASE not supported for v1.0, so PASE implies commissioning, which has highest privilege.
     ReturnErrorCodeIf(subjectDescriptor.authMode == AuthMode::kPase, CHIP_NO_ERROR);
 
+    if (!mEntryIndexEnabled)
+    {
+        return CheckEntries(subjectDescriptor, requestPath, requestPrivilege);
+    }
+
+    if (const CachedDecision * decision = FindDecision(subjectDescriptor, requestPath, requestPrivilege))
+    {
+        return decision->allowed ? CHIP_NO_ERROR : CHIP_ERROR_ACCESS_DENIED;
+    }
+
+    if (mEntryIndexState == EntryIndexState::kStale)
+    {
+        CHIP_ERROR err = BuildEntryIndex();
+        if (err != CHIP_NO_ERROR)
+        {
+            // Entries that can't be indexed are still checked one by one, which reports the same errors as before.
+            ChipLogDetail(DataManagement, "AccessControl: unable to index entries (%" CHIP_ERROR_FORMAT ")", err.Format());
+            mEntryIndexState = EntryIndexState::kUnusable;
+            mGrants.Free();
+            mTargets.Free();
+            mGrantCount = 0;
+        }
+    }
+
+    CHIP_ERROR result;
+    if (mEntryIndexState == EntryIndexState::kBuilt)
+    {
+        result = CheckEntryIndex(subjectDescriptor, requestPath, requestPrivilege) ? CHIP_NO_ERROR : CHIP_ERROR_ACCESS_DENIED;
+    }
+    else
+    {
+        result = CheckEntries(subjectDescriptor, requestPath, requestPrivilege);
+    }
+
+    if (result == CHIP_NO_ERROR || result == CHIP_ERROR_ACCESS_DENIED)
+    {
+        AddDecision(subjectDescriptor, requestPath, requestPrivilege, result == CHIP_NO_ERROR);
+    }
+    return result;
+}
+
+CHIP_ERROR AccessControl::CheckEntries(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath,
+                                       Privilege requestPrivilege)
+{
     EntryIterator iterator;
     ReturnErrorOnFailure(Entries(iterator, &subjectDescriptor.fabricIndex));
 
@@ -291,6 +360,290 @@ CHIP_ERROR AccessControl::Check(const SubjectDescriptor & subjectDescriptor, con
     return CHIP_ERROR_ACCESS_DENIED;
 }
 
+void AccessControl::InvalidateEntryIndex()
+{
+    mEntryGeneration++;
+    mEntryIndexState = EntryIndexState::kStale;
+    mGrants.Free();
+    mTargets.Free();
+    mGrantCount = 0;
+
+#if CHIP_CONFIG_ACCESS_CONTROL_DECISION_CACHE_SIZE > 0
+    for (auto & decision : mDecisions)
+    {
+        decision.valid = false;
+    }
+    mNextDecision = 0;
+#endif
+}
+
+CHIP_ERROR AccessControl::CheckBatch::Check(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath,
+                                           Privilege requestPrivilege)
+{
+    if (mEntryGeneration != mAccessControl.mEntryGeneration || requestPath.cluster != mRequestPath.cluster ||
+        requestPath.endpoint != mRequestPath.endpoint || !SubjectDescriptorsMatch(subjectDescriptor, mSubjectDescriptor))
+    {
+        mEntryGeneration   = mAccessControl.mEntryGeneration;
+        mSubjectDescriptor = subjectDescriptor;
+        mRequestPath       = requestPath;
+        mCheckedPrivileges = 0;
+        mAllowedPrivileges = 0;
+    }
+
+    const uint8_t privilege = to_underlying(requestPrivilege);
+    if (mCheckedPrivileges & privilege)
+    {
+        return (mAllowedPrivileges & privilege) ? CHIP_NO_ERROR : CHIP_ERROR_ACCESS_DENIED;
+    }
+
+    CHIP_ERROR err = mAccessControl.Check(subjectDescriptor, requestPath, requestPrivilege);
+    if (err == CHIP_NO_ERROR || err == CHIP_ERROR_ACCESS_DENIED)
+    {
+        mCheckedPrivileges = static_cast<uint8_t>(mCheckedPrivileges | privilege);
+        if (err == CHIP_NO_ERROR)
+        {
+            mAllowedPrivileges = static_cast<uint8_t>(mAllowedPrivileges | privilege);
+        }
+    }
+    return err;
+}
+
+bool AccessControl::GrantLess(const IndexedGrant & a, const IndexedGrant & b)
+{
+    if (a.fabricIndex != b.fabricIndex)
+    {
+        return a.fabricIndex < b.fabricIndex;
+    }
+    if (a.authMode != b.authMode)
+    {
+        return a.authMode < b.authMode;
+    }
+    return a.subject < b.subject;
+}
+
+CHIP_ERROR AccessControl::BuildEntryIndex()
+{
+    mGrants.Free();
+    mTargets.Free();
+    mGrantCount = 0;
+
+    // First pass counts grants and targets, to size the index.
+    size_t grantCapacity  = 0;
+    size_t targetCapacity = 0;
+    {
+        EntryIterator iterator;
+        ReturnErrorOnFailure(Entries(iterator));
+
+        Entry entry;
+        while (iterator.Next(entry) == CHIP_NO_ERROR)
+        {
+            size_t subjectCount = 0;
+            ReturnErrorOnFailure(entry.GetSubjectCount(subjectCount));
+            size_t targetCount = 0;
+            ReturnErrorOnFailure(entry.GetTargetCount(targetCount));
+            grantCapacity += (subjectCount > 0) ? subjectCount : 1;
+            targetCapacity += targetCount;
+        }
+    }
+    VerifyOrReturnError(targetCapacity <= UINT16_MAX, CHIP_ERROR_NO_MEMORY);
+    if (grantCapacity > 0)
+    {
+        VerifyOrReturnError(mGrants.Calloc(grantCapacity), CHIP_ERROR_NO_MEMORY);
+    }
+    if (targetCapacity > 0)
+    {
+        VerifyOrReturnError(mTargets.Calloc(targetCapacity), CHIP_ERROR_NO_MEMORY);
+    }
+
+    // Second pass fills the index, rejecting the same entries as CheckEntries.
+    size_t targetIndex = 0;
+    {
+        EntryIterator iterator;
+        ReturnErrorOnFailure(Entries(iterator));
+
+        Entry entry;
+        while (iterator.Next(entry) == CHIP_NO_ERROR)
+        {
+            IndexedGrant grant;
+            ReturnErrorOnFailure(entry.GetFabricIndex(grant.fabricIndex));
+            ReturnErrorOnFailure(entry.GetAuthMode(grant.authMode));
+            // Operational PASE not supported for v1.0.
+            VerifyOrReturnError(grant.authMode == AuthMode::kCase || grant.authMode == AuthMode::kGroup,
+                                CHIP_ERROR_INCORRECT_STATE);
+            ReturnErrorOnFailure(entry.GetPrivilege(grant.privilege));
+
+            size_t targetCount = 0;
+            ReturnErrorOnFailure(entry.GetTargetCount(targetCount));
+            VerifyOrReturnError(targetCount <= UINT8_MAX && targetIndex + targetCount <= targetCapacity,
+                                CHIP_ERROR_INCORRECT_STATE);
+            grant.targetStart = static_cast<uint16_t>(targetIndex);
+            grant.targetCount = static_cast<uint8_t>(targetCount);
+            for (size_t i = 0; i < targetCount; ++i)
+            {
+                Entry::Target target;
+                ReturnErrorOnFailure(entry.GetTarget(i, target));
+                // TODO: index target.deviceType (requires lookup)
+                mTargets[targetIndex++] = { target.flags, target.cluster, target.endpoint };
+            }
+
+            size_t subjectCount = 0;
+            ReturnErrorOnFailure(entry.GetSubjectCount(subjectCount));
+            VerifyOrReturnError(mGrantCount + ((subjectCount > 0) ? subjectCount : 1) <= grantCapacity, CHIP_ERROR_INCORRECT_STATE);
+            if (subjectCount == 0)
+            {
+                grant.subject          = kUndefinedNodeId;
+                mGrants[mGrantCount++] = grant;
+            }
+            for (size_t i = 0; i < subjectCount; ++i)
+            {
+                NodeId subject = kUndefinedNodeId;
+                ReturnErrorOnFailure(entry.GetSubject(i, subject));
+                if (IsOperationalNodeId(subject) || IsCASEAuthTag(subject))
+                {
+                    VerifyOrReturnError(grant.authMode == AuthMode::kCase, CHIP_ERROR_INCORRECT_STATE);
+                }
+                else if (IsGroupId(subject))
+                {
+                    VerifyOrReturnError(grant.authMode == AuthMode::kGroup, CHIP_ERROR_INCORRECT_STATE);
+                }
+                else
+                {
+                    // Operational PASE not supported for v1.0.
+                    return CHIP_ERROR_INCORRECT_STATE;
+                }
+                grant.subject          = subject;
+                mGrants[mGrantCount++] = grant;
+            }
+        }
+    }
+
+    std::sort(mGrants.Get(), mGrants.Get() + mGrantCount, GrantLess);
+    mEntryIndexState = EntryIndexState::kBuilt;
+    return CHIP_NO_ERROR;
+}
+
+bool AccessControl::CheckEntryIndex(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath,
+                                    Privilege requestPrivilege) const
+{
+    const IndexedGrant * begin = mGrants.Get();
+    const IndexedGrant * end   = begin + mGrantCount;
+
+    // Narrow down to the grants of the fabric and auth mode...
+    IndexedGrant key;
+    key.fabricIndex = subjectDescriptor.fabricIndex;
+    key.authMode    = subjectDescriptor.authMode;
+    key.subject     = kUndefinedNodeId;
+    begin           = std::lower_bound(begin, end, key, GrantLess);
+    key.subject     = std::numeric_limits<NodeId>::max();
+    end             = std::upper_bound(begin, end, key, GrantLess);
+
+    // ...then look at those for any subject...
+    for (const IndexedGrant * grant = begin; grant != end && grant->subject == kUndefinedNodeId; ++grant)
+    {
+        if (CheckGrant(*grant, requestPath, requestPrivilege))
+        {
+            return true;
+        }
+    }
+
+    // ...for the subject itself...
+    if (subjectDescriptor.subject != kUndefinedNodeId && !IsCASEAuthTag(subjectDescriptor.subject))
+    {
+        key.subject = subjectDescriptor.subject;
+        auto range  = std::equal_range(begin, end, key, GrantLess);
+        for (const IndexedGrant * grant = range.first; grant != range.second; ++grant)
+        {
+            if (CheckGrant(*grant, requestPath, requestPrivilege))
+            {
+                return true;
+            }
+        }
+    }
+
+    // ...and for its CATs, with the same identifier and at most the same version.
+    if (subjectDescriptor.authMode == AuthMode::kCase)
+    {
+        for (auto cat : subjectDescriptor.cats.values)
+        {
+            if (cat == kUndefinedCAT)
+            {
+                break;
+            }
+            key.subject                = kMinCASEAuthTag | (cat & kTagIdentifierMask);
+            const IndexedGrant * first = std::lower_bound(begin, end, key, GrantLess);
+            key.subject                = kMinCASEAuthTag | cat;
+            const IndexedGrant * last  = std::upper_bound(first, end, key, GrantLess);
+            for (const IndexedGrant * grant = first; grant != last; ++grant)
+            {
+                if (CheckGrant(*grant, requestPath, requestPrivilege))
+                {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+bool AccessControl::CheckGrant(const IndexedGrant & grant, const RequestPath & requestPath, Privilege requestPrivilege) const
+{
+    if (!CheckRequestPrivilegeAgainstEntryPrivilege(requestPrivilege, grant.privilege))
+    {
+        return false;
+    }
+    if (grant.targetCount == 0)
+    {
+        return true;
+    }
+    for (size_t i = grant.targetStart; i < size_t(grant.targetStart) + grant.targetCount; ++i)
+    {
+        const IndexedTarget & target = mTargets[i];
+        if ((target.flags & Entry::Target::kCluster) && target.cluster != requestPath.cluster)
+        {
+            continue;
+        }
+        if ((target.flags & Entry::Target::kEndpoint) && target.endpoint != requestPath.endpoint)
+        {
+            continue;
+        }
+        return true;
+    }
+    return false;
+}
+
+const AccessControl::CachedDecision * AccessControl::FindDecision(const SubjectDescriptor & subjectDescriptor,
+                                                                  const RequestPath & requestPath,
+                                                                  Privilege requestPrivilege) const
+{
+#if CHIP_CONFIG_ACCESS_CONTROL_DECISION_CACHE_SIZE > 0
+    for (const auto & decision : mDecisions)
+    {
+        if (decision.valid && decision.privilege == requestPrivilege && decision.requestPath.cluster == requestPath.cluster &&
+            decision.requestPath.endpoint == requestPath.endpoint &&
+            SubjectDescriptorsMatch(decision.subjectDescriptor, subjectDescriptor))
+        {
+            return &decision;
+        }
+    }
+#endif
+    return nullptr;
+}
+
+void AccessControl::AddDecision(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath,
+                                Privilege requestPrivilege, bool allowed)
+{
+#if CHIP_CONFIG_ACCESS_CONTROL_DECISION_CACHE_SIZE > 0
+    CachedDecision & decision  = mDecisions[mNextDecision];
+    decision.subjectDescriptor = subjectDescriptor;
+    decision.requestPath       = requestPath;
+    decision.privilege         = requestPrivilege;
+    decision.allowed           = allowed;
+    decision.valid             = true;
+    mNextDecision              = (mNextDecision + 1) % kDecisionCacheSize;
+#endif
+}
+
 AccessControl & GetAccessControl()
 {
     return *globalAccessControl;
@@ -23,6 +23,7 @@
 #include "SubjectDescriptor.h"
 
 #include <lib/core/CHIPCore.h>
+#include <lib/support/ScopedBuffer.h>
 
 namespace chip {
 namespace Access {
@@ -344,13 +345,54 @@ public:
         virtual void SetListener(Listener & listener) { mListener = &listener; }
         virtual void ClearListener() { mListener = nullptr; }
 
+    protected:
+        // Implementations must call this whenever entries change other than through CreateEntry,
+        // UpdateEntry or DeleteEntry (e.g. when loaded from storage).
+        void NotifyEntryChanged()
+        {
+            if (mListener != nullptr)
+            {
+                mListener->OnEntryChanged();
+            }
+        }
+
     private:
         Listener * mListener = nullptr;
     };
 
-    AccessControl() = default;
+    /**
+     * Checks access for a sequence of request paths (e.g. while expanding a
+     * wildcard path), reusing the decision for a cluster on an endpoint across
+     * consecutive paths of that cluster, per privilege.
+     *
+     * Decisions are dropped when the subject descriptor or cluster changes, or
+     * when entries change. A batch is meant to live for one interaction.
+     */
+    class CheckBatch
+    {
+    public:
+        CheckBatch(AccessControl & accessControl) : mAccessControl(accessControl) {}
 
-    AccessControl(Delegate & delegate) : mDelegate(delegate) {}
+        CheckBatch(const CheckBatch &) = delete;
+        CheckBatch & operator=(const CheckBatch &) = delete;
+
+        /**
+         * Same as AccessControl::Check, but may reuse a previous decision.
+         */
+        CHIP_ERROR Check(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath, Privilege requestPrivilege);
+
+    private:
+        AccessControl & mAccessControl;
+        SubjectDescriptor mSubjectDescriptor;
+        RequestPath mRequestPath;
+        uint32_t mEntryGeneration = 0;
+        uint8_t mCheckedPrivileges = 0; // bitmask of privileges checked for mRequestPath
+        uint8_t mAllowedPrivileges = 0; // bitmask of privileges allowed for mRequestPath
+    };
+
+    AccessControl() : mEntryListener(*this) {}
+
+    AccessControl(Delegate & delegate) : mDelegate(delegate), mEntryListener(*this) {}
 
     AccessControl(const AccessControl &) = delete;
     AccessControl & operator=(const AccessControl &) = delete;
@@ -393,6 +435,7 @@ public:
      */
     CHIP_ERROR CreateEntry(size_t * index, const Entry & entry, FabricIndex * fabricIndex = nullptr)
     {
+        InvalidateEntryIndex();
         return mDelegate.CreateEntry(index, entry, fabricIndex);
     }
 
@@ -417,6 +460,7 @@ public:
      */
     CHIP_ERROR UpdateEntry(size_t index, const Entry & entry, const FabricIndex * fabricIndex = nullptr)
     {
+        InvalidateEntryIndex();
         return mDelegate.UpdateEntry(index, entry, fabricIndex);
     }
 
@@ -428,6 +472,7 @@ public:
      */
     CHIP_ERROR DeleteEntry(size_t index, const FabricIndex * fabricIndex = nullptr)
     {
+        InvalidateEntryIndex();
         return mDelegate.DeleteEntry(index, fabricIndex);
     }
 
@@ -452,9 +497,105 @@ public:
      */
     CHIP_ERROR Check(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath, Privilege requestPrivilege);
 
+    /**
+     * Enable or disable the compiled entry index and the decision cache. When
+     * disabled, every check iterates over all entries. Enabled by default.
+     */
+    void SetEntryIndexEnabled(bool enabled)
+    {
+        mEntryIndexEnabled = enabled;
+        InvalidateEntryIndex();
+    }
+
 private:
+    class EntryListener : public Listener
+    {
+    public:
+        EntryListener(AccessControl & accessControl) : mAccessControl(accessControl) {}
+
+        void OnEntryChanged() override { mAccessControl.InvalidateEntryIndex(); }
+        void OnExtensionChanged() override {}
+
+    private:
+        AccessControl & mAccessControl;
+    };
+
+    // An entry, compiled for one of its subjects (or for any subject if it has none).
+    //
+    // Grants are sorted by (fabric index, auth mode, subject), so those of one fabric and
+    // auth mode are contiguous, with the ones for any subject first.
+    //
+    // Targets are not part of the key: a subject has at most a few entries of a few targets
+    // each, which are quicker to scan than to look up (endpoint, cluster), (endpoint, any),
+    // (any, cluster) and (any, any) in a sorted index.
+    struct IndexedGrant
+    {
+        NodeId subject; // kUndefinedNodeId if any subject matches
+        FabricIndex fabricIndex;
+        AuthMode authMode;
+        Privilege privilege;
+        uint8_t targetCount; // 0 if any target matches
+        uint16_t targetStart;
+    };
+
+    struct IndexedTarget
+    {
+        Entry::Target::Flags flags;
+        ClusterId cluster;
+        EndpointId endpoint;
+    };
+
+    struct CachedDecision
+    {
+        SubjectDescriptor subjectDescriptor;
+        RequestPath requestPath;
+        Privilege privilege;
+        bool allowed;
+        bool valid;
+    };
+
+    enum class EntryIndexState : uint8_t
+    {
+        kStale,    // must be built before use
+        kBuilt,    // matches the entries
+        kUnusable, // entries can't be indexed, iterate them instead
+    };
+
+    static constexpr size_t kDecisionCacheSize = CHIP_CONFIG_ACCESS_CONTROL_DECISION_CACHE_SIZE;
+
+    static bool GrantLess(const IndexedGrant & a, const IndexedGrant & b);
+
+    void InvalidateEntryIndex();
+    CHIP_ERROR BuildEntryIndex();
+    bool CheckEntryIndex(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath,
+                         Privilege requestPrivilege) const;
+    bool CheckGrant(const IndexedGrant & grant, const RequestPath & requestPath, Privilege requestPrivilege) const;
+    CHIP_ERROR CheckEntries(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath,
+                            Privilege requestPrivilege);
+
+    const CachedDecision * FindDecision(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath,
+                                        Privilege requestPrivilege) const;
+    void AddDecision(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath, Privilege requestPrivilege,
+                     bool allowed);
+
     static Delegate mDefaultDelegate;
     Delegate & mDelegate = mDefaultDelegate;
+
+    EntryListener mEntryListener;
+
+    // Incremented whenever entries may have changed, so batches know to drop their decisions.
+    uint32_t mEntryGeneration = 0;
+
+    bool mEntryIndexEnabled          = true;
+    EntryIndexState mEntryIndexState = EntryIndexState::kStale;
+    Platform::ScopedMemoryBuffer<IndexedGrant> mGrants;
+    size_t mGrantCount = 0;
+    Platform::ScopedMemoryBuffer<IndexedTarget> mTargets;
+
+#if CHIP_CONFIG_ACCESS_CONTROL_DECISION_CACHE_SIZE > 0
+    CachedDecision mDecisions[kDecisionCacheSize];
+    size_t mNextDecision = 0;
+#endif
 };
 
 /**
@@ -1075,6 +1075,7 @@ public:
                 storage.Clear();
             }
         }
+        NotifyEntryChanged();
         return CHIP_NO_ERROR;
     }
 
@@ -1142,6 +1143,7 @@ public:
                 {
                     ChipLogDetail(DataManagement, "CreateEntry failed to save to flash");
                 }
+                NotifyEntryChanged();
             }
             return err;
         }
@@ -1175,6 +1177,7 @@ public:
                     ChipLogDetail(DataManagement, "UpdateEntry failed to save to flash");
                 }
             }
+            NotifyEntryChanged();
             return err;
         }
         return CHIP_ERROR_SENTINEL;
@@ -1217,6 +1220,7 @@ public:
             {
                 ChipLogDetail(DataManagement, "DeleteEntry failed to save to flash");
             }
+            NotifyEntryChanged();
             return CHIP_NO_ERROR;
         }
         return CHIP_ERROR_SENTINEL;
@@ -20,7 +20,10 @@
 #include "access/examples/ExampleAccessControlDelegate.h"
 
 #include <lib/core/CHIPCore.h>
+#include <lib/support/CHIPMem.h>
 #include <lib/support/UnitTestRegistration.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <system/SystemClock.h>
 
 #include <nlunit-test.h>
 
@@ -649,6 +652,217 @@ void TestCheck(nlTestSuite * inSuite, void * inContext)
     }
 }
 
+void TestCheckWithoutEntryIndex(nlTestSuite * inSuite, void * inContext)
+{
+    accessControl.SetEntryIndexEnabled(false);
+    LoadAccessControl(accessControl, entryData1, entryData1Count);
+    for (const auto & checkData : checkData1)
+    {
+        CHIP_ERROR expectedResult = checkData.allow ? CHIP_NO_ERROR : CHIP_ERROR_ACCESS_DENIED;
+        NL_TEST_ASSERT(inSuite,
+                       accessControl.Check(checkData.subjectDescriptor, checkData.requestPath, checkData.privilege) ==
+                           expectedResult);
+    }
+    accessControl.SetEntryIndexEnabled(true);
+}
+
+void TestCheckAfterEntryChange(nlTestSuite * inSuite, void * inContext)
+{
+    LoadAccessControl(accessControl, entryData1, entryData1Count);
+    for (const auto & checkData : checkData1)
+    {
+        accessControl.Check(checkData.subjectDescriptor, checkData.requestPath, checkData.privilege);
+    }
+
+    // Only PASE is still allowed once all entries are gone, whatever was checked before
+    NL_TEST_ASSERT(inSuite, ClearAccessControl(accessControl) == CHIP_NO_ERROR);
+    for (const auto & checkData : checkData1)
+    {
+        CHIP_ERROR expectedResult =
+            (checkData.subjectDescriptor.authMode == AuthMode::kPase) ? CHIP_NO_ERROR : CHIP_ERROR_ACCESS_DENIED;
+        NL_TEST_ASSERT(inSuite,
+                       accessControl.Check(checkData.subjectDescriptor, checkData.requestPath, checkData.privilege) ==
+                           expectedResult);
+    }
+
+    // Checks are correct again once entries are back
+    LoadAccessControl(accessControl, entryData1, entryData1Count);
+    for (const auto & checkData : checkData1)
+    {
+        CHIP_ERROR expectedResult = checkData.allow ? CHIP_NO_ERROR : CHIP_ERROR_ACCESS_DENIED;
+        NL_TEST_ASSERT(inSuite,
+                       accessControl.Check(checkData.subjectDescriptor, checkData.requestPath, checkData.privilege) ==
+                           expectedResult);
+    }
+}
+
+/**
+ * Measures the rate of access control checks against a full access control list, with the entry index and decision cache
+ * and with every check iterating over the entries.
+ */
+void BenchmarkCheck(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr uint32_t kCheckCount = 2000;
+    constexpr size_t kEntryCount =
+        CHIP_CONFIG_MAX_FABRICS * CHIP_CONFIG_EXAMPLE_ACCESS_CONTROL_MAX_ENTRIES_PER_FABRIC;
+    // More paths than the decision cache holds, so most checks go through the index
+    constexpr EndpointId kEndpointCount = 2 * CHIP_CONFIG_ACCESS_CONTROL_DECISION_CACHE_SIZE + 1;
+
+    // Each entry grants one node access to a cluster on all endpoints
+    for (size_t i = 0; i < kEntryCount; ++i)
+    {
+        EntryData data;
+        data.fabricIndex = static_cast<FabricIndex>(1 + i % CHIP_CONFIG_MAX_FABRICS);
+        data.authMode    = AuthMode::kCase;
+        data.privilege   = Privilege::kOperate;
+        data.AddSubject(nullptr, kOperationalNodeId0 + i);
+        data.AddTarget(nullptr, { .flags = Target::kCluster, .cluster = kOnOffCluster + static_cast<ClusterId>(i) });
+        NL_TEST_ASSERT(inSuite, LoadAccessControl(accessControl, &data, 1) == CHIP_NO_ERROR);
+    }
+
+    // The last entry of the last fabric is the one that matches
+    const size_t last = kEntryCount - 1;
+    SubjectDescriptor subjectDescriptor{ .fabricIndex = static_cast<FabricIndex>(1 + last % CHIP_CONFIG_MAX_FABRICS),
+                                         .authMode    = AuthMode::kCase,
+                                         .subject     = kOperationalNodeId0 + last };
+    RequestPath requestPath{ .cluster = kOnOffCluster + static_cast<ClusterId>(last) };
+
+    uint32_t allowed[2] = { 0, 0 };
+    for (bool enabled : { false, true })
+    {
+        accessControl.SetEntryIndexEnabled(enabled);
+
+        System::Clock::Microseconds64 start = System::SystemClock().GetMonotonicMicroseconds64();
+        for (uint32_t i = 0; i < kCheckCount; i++)
+        {
+            requestPath.endpoint = static_cast<EndpointId>(i % kEndpointCount);
+            if (accessControl.Check(subjectDescriptor, requestPath, Privilege::kView) == CHIP_NO_ERROR)
+            {
+                allowed[enabled]++;
+            }
+        }
+        System::Clock::Microseconds64 elapsed = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+        ChipLogProgress(DataManagement, "Access control check x%" PRIu32 " %s entry index: %" PRIu64 "us, %" PRIu64 " checks/s",
+                        kCheckCount, enabled ? "with" : "without", elapsed.count(),
+                        elapsed.count() ? (static_cast<uint64_t>(kCheckCount) * 1000000u / elapsed.count()) : 0);
+    }
+
+    NL_TEST_ASSERT(inSuite, allowed[0] == kCheckCount);
+    NL_TEST_ASSERT(inSuite, allowed[1] == kCheckCount);
+}
+
+void TestCheckBatch(nlTestSuite * inSuite, void * inContext)
+{
+    LoadAccessControl(accessControl, entryData1, entryData1Count);
+
+    // Each check twice, so the second one may reuse the decision
+    AccessControl::CheckBatch batch(accessControl);
+    for (const auto & checkData : checkData1)
+    {
+        CHIP_ERROR expectedResult = checkData.allow ? CHIP_NO_ERROR : CHIP_ERROR_ACCESS_DENIED;
+        for (int i = 0; i < 2; ++i)
+        {
+            NL_TEST_ASSERT(inSuite,
+                           batch.Check(checkData.subjectDescriptor, checkData.requestPath, checkData.privilege) == expectedResult);
+        }
+    }
+
+    // Decisions aren't reused once entries change
+    const auto & last = checkData1[ArraySize(checkData1) - 1];
+    NL_TEST_ASSERT(inSuite, last.allow);
+    NL_TEST_ASSERT(inSuite, ClearAccessControl(accessControl) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, batch.Check(last.subjectDescriptor, last.requestPath, last.privilege) == CHIP_ERROR_ACCESS_DENIED);
+}
+
+/**
+ * Reads the entries of another delegate, counting the times they are iterated over.
+ */
+class EntryIterationCounter : public AccessControl::Delegate
+{
+public:
+    EntryIterationCounter(AccessControl::Delegate & delegate) : mDelegate(delegate) {}
+
+    CHIP_ERROR GetMaxEntryCount(size_t & value) const override { return mDelegate.GetMaxEntryCount(value); }
+    CHIP_ERROR GetEntryCount(size_t & value) const override { return mDelegate.GetEntryCount(value); }
+    CHIP_ERROR ReadEntry(size_t index, Entry & entry, const FabricIndex * fabricIndex) const override
+    {
+        return mDelegate.ReadEntry(index, entry, fabricIndex);
+    }
+    CHIP_ERROR Entries(EntryIterator & iterator, const FabricIndex * fabricIndex) const override
+    {
+        mCount++;
+        return mDelegate.Entries(iterator, fabricIndex);
+    }
+
+    uint32_t GetCount() const { return mCount; }
+
+private:
+    AccessControl::Delegate & mDelegate;
+    mutable uint32_t mCount = 0;
+};
+
+/**
+ * Measures the rate of access control checks while expanding a wildcard path over many attributes of a few clusters, with
+ * each path checked on its own and with the checks batched per cluster.
+ */
+void BenchmarkCheckBatch(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr uint32_t kClusterCount         = 16;
+    constexpr uint32_t kAttributesPerCluster = 32;
+    constexpr uint32_t kPathCount            = kClusterCount * kAttributesPerCluster;
+    constexpr size_t kEntryCount             = CHIP_CONFIG_MAX_FABRICS * CHIP_CONFIG_EXAMPLE_ACCESS_CONTROL_MAX_ENTRIES_PER_FABRIC;
+
+    for (size_t i = 0; i < kEntryCount; ++i)
+    {
+        EntryData data;
+        data.fabricIndex = static_cast<FabricIndex>(1 + i % CHIP_CONFIG_MAX_FABRICS);
+        data.authMode    = AuthMode::kCase;
+        data.privilege   = Privilege::kView;
+        data.AddSubject(nullptr, kOperationalNodeId0 + i);
+        NL_TEST_ASSERT(inSuite, LoadAccessControl(accessControl, &data, 1) == CHIP_NO_ERROR);
+    }
+
+    const size_t last = kEntryCount - 1;
+    SubjectDescriptor subjectDescriptor{ .fabricIndex = static_cast<FabricIndex>(1 + last % CHIP_CONFIG_MAX_FABRICS),
+                                         .authMode    = AuthMode::kCase,
+                                         .subject     = kOperationalNodeId0 + last };
+
+    // Index disabled, so every check that isn't batched iterates over the entries
+    uint32_t allowed[2]    = { 0, 0 };
+    uint32_t iterations[2] = { 0, 0 };
+    for (bool batched : { false, true })
+    {
+        EntryIterationCounter counter(Examples::GetAccessControlDelegate(nullptr));
+        AccessControl countingAccessControl(counter);
+        countingAccessControl.SetEntryIndexEnabled(false);
+        AccessControl::CheckBatch batch(countingAccessControl);
+
+        System::Clock::Microseconds64 start = System::SystemClock().GetMonotonicMicroseconds64();
+        for (uint32_t i = 0; i < kPathCount; i++)
+        {
+            RequestPath requestPath{ .cluster = static_cast<ClusterId>(i / kAttributesPerCluster), .endpoint = 1 };
+            CHIP_ERROR err = batched ? batch.Check(subjectDescriptor, requestPath, Privilege::kView)
+                                     : countingAccessControl.Check(subjectDescriptor, requestPath, Privilege::kView);
+            if (err == CHIP_NO_ERROR)
+            {
+                allowed[batched]++;
+            }
+        }
+        System::Clock::Microseconds64 elapsed = System::SystemClock().GetMonotonicMicroseconds64() - start;
+        iterations[batched]                   = counter.GetCount();
+
+        ChipLogProgress(DataManagement,
+                        "Access control check x%" PRIu32 " paths %s: %" PRIu64 "us, %" PRIu32 " iterations over the entries",
+                        kPathCount, batched ? "batched per cluster" : "one by one", elapsed.count(), iterations[batched]);
+    }
+
+    NL_TEST_ASSERT(inSuite, allowed[0] == kPathCount);
+    NL_TEST_ASSERT(inSuite, allowed[1] == kPathCount);
+    NL_TEST_ASSERT(inSuite, iterations[0] == kPathCount);
+    NL_TEST_ASSERT(inSuite, iterations[1] == kClusterCount);
+}
+
 void TestCreateReadEntry(nlTestSuite * inSuite, void * inContext)
 {
     for (size_t i = 0; i < entryData1Count; ++i)
@@ -1076,6 +1290,10 @@ void TestUpdateEntry(nlTestSuite * inSuite, void * inContext)
 
 int Setup(void * inContext)
 {
+    if (chip::Platform::MemoryInit() != CHIP_NO_ERROR)
+    {
+        return FAILURE;
+    }
     SetAccessControl(accessControl);
     GetAccessControl().Init();
     return SUCCESS;
@@ -1084,6 +1302,7 @@ int Setup(void * inContext)
 int Teardown(void * inContext)
 {
     GetAccessControl().Finish();
+    chip::Platform::MemoryShutdown();
     return SUCCESS;
 }
 
@@ -1113,6 +1332,11 @@ int TestAccessControl()
         NL_TEST_DEF("TestFabricFilteredReadEntry", TestFabricFilteredReadEntry),
         NL_TEST_DEF("TestFabricFilteredCreateEntry", TestFabricFilteredCreateEntry),
         NL_TEST_DEF("TestCheck", TestCheck),
+        NL_TEST_DEF("TestCheckWithoutEntryIndex", TestCheckWithoutEntryIndex),
+        NL_TEST_DEF("TestCheckAfterEntryChange", TestCheckAfterEntryChange),
+        NL_TEST_DEF("BenchmarkCheck", BenchmarkCheck),
+        NL_TEST_DEF("TestCheckBatch", TestCheckBatch),
+        NL_TEST_DEF("BenchmarkCheckBatch", BenchmarkCheckBatch),
         NL_TEST_SENTINEL()
     };
     // clang-format on
@@ -16,80 +16,247 @@
  *    limitations under the License.
  */
 
-#include "system/SystemPacketBuffer.h"
+#include <algorithm>
 #include <app/AttributeCache.h>
 #include <app/InteractionModelEngine.h>
-#include <tuple>
+#include <new>
+#include <string.h>
 
 namespace chip {
 namespace app {
 
-CHIP_ERROR AttributeCache::UpdateCache(const ConcreteDataAttributePath & aPath, TLV::TLVReader * apData, const StatusIB & aStatus)
+namespace {
+
+// Most attribute values are a handful of bytes, so pack many of them into each block.
+constexpr size_t kArenaBlockSize = 4096;
+
+// Upper bound on the encoded size of a single cached attribute value.
+constexpr size_t kMaxAttributeValueSize = 1024 * 1024;
+
+} // namespace
+
+CHIP_ERROR AttributeCache::DataArena::AllocateBlock(size_t aSize, Block & aBlock)
 {
-    AttributeState state;
-    System::PacketBufferHandle handle;
-    System::PacketBufferTLVWriter writer;
+    aBlock.mData.reset(new (std::nothrow) uint8_t[aSize]);
+    VerifyOrReturnError(aBlock.mData != nullptr, CHIP_ERROR_NO_MEMORY);
+    aBlock.mSize = aSize;
+    aBlock.mUsed = 0;
+    return CHIP_NO_ERROR;
+}
 
-    if (apData)
+CHIP_ERROR AttributeCache::DataArena::WriteElement(const TLV::TLVReader & aData, Block & aBlock, uint32_t & aDataSize)
+{
+    TLV::TLVReader reader;
+    TLV::TLVWriter writer;
+
+    //
+    // CopyElement() advances the reader it is given, so work on a copy to allow retrying into a larger block.
+    //
+    reader.Init(aData);
+    writer.Init(aBlock.mData.get() + aBlock.mUsed, aBlock.mSize - aBlock.mUsed);
+
+    ReturnErrorOnFailure(writer.CopyElement(TLV::AnonymousTag(), reader));
+    ReturnErrorOnFailure(writer.Finalize());
+
+    aDataSize = writer.GetLengthWritten();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR AttributeCache::DataArena::Store(const TLV::TLVReader & aData, uint8_t *& apData, uint32_t & aDataSize)
+{
+    CHIP_ERROR err = CHIP_ERROR_BUFFER_TOO_SMALL;
+
+    if (!mBlocks.empty() && mBlocks.back().mUsed < mBlocks.back().mSize)
     {
-        handle = System::PacketBufferHandle::New(chip::app::kMaxSecureSduLengthBytes);
+        err = WriteElement(aData, mBlocks.back(), aDataSize);
+    }
 
-        writer.Init(std::move(handle), false);
+    //
+    // If the value doesn't fit in what is left of the current block, move on to a new one, growing it until the value fits.
+    // The unused tail of the previous block is simply left behind.
+    //
+    for (size_t blockSize = kArenaBlockSize; err == CHIP_ERROR_BUFFER_TOO_SMALL; blockSize *= 2)
+    {
+        Block block;
 
-        ReturnErrorOnFailure(writer.CopyElement(TLV::AnonymousTag(), *apData));
-        ReturnErrorOnFailure(writer.Finalize(&handle));
+        VerifyOrReturnError(blockSize <= kMaxAttributeValueSize, CHIP_ERROR_NO_MEMORY);
+        ReturnErrorOnFailure(AllocateBlock(blockSize, block));
 
-        //
-        // Compact the buffer down to a more reasonably sized packet buffer
-        // if we can.
-        //
-        handle.RightSize();
+        err = WriteElement(aData, block, aDataSize);
+        if (err == CHIP_NO_ERROR)
+        {
+            mAllocatedBytes += block.mSize;
+            mBlocks.push_back(std::move(block));
+        }
+    }
+    ReturnErrorOnFailure(err);
+
+    Block & block = mBlocks.back();
+    apData        = block.mData.get() + block.mUsed;
+    block.mUsed += aDataSize;
+    mLiveBytes += aDataSize;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR AttributeCache::DataArena::Reserve(size_t aSize)
+{
+    Block block;
+
+    ReturnErrorOnFailure(AllocateBlock(std::max(kArenaBlockSize, aSize), block));
+    mAllocatedBytes += block.mSize;
+    mBlocks.push_back(std::move(block));
+    return CHIP_NO_ERROR;
+}
 
-        state.Set<System::PacketBufferHandle>(std::move(handle));
+uint8_t * AttributeCache::DataArena::Store(const uint8_t * apData, uint32_t aDataSize)
+{
+    if (mBlocks.empty() || mBlocks.back().mSize - mBlocks.back().mUsed < aDataSize)
+    {
+        VerifyOrReturnError(Reserve(aDataSize) == CHIP_NO_ERROR, nullptr);
     }
-    else
+
+    Block & block  = mBlocks.back();
+    uint8_t * data = block.mData.get() + block.mUsed;
+    memcpy(data, apData, aDataSize);
+    block.mUsed += aDataSize;
+    mLiveBytes += aDataSize;
+    return data;
+}
+
+bool AttributeCache::DataArena::ShouldCompact() const
+{
+    size_t staleBytes = mAllocatedBytes - mLiveBytes;
+    return staleBytes > kArenaBlockSize && staleBytes >= mLiveBytes;
+}
+
+void AttributeCache::CompactArena()
+{
+    DataArena compacted;
+
+    //
+    // Reserving all of the live bytes up front means the copies below can't fail half-way through.
+    //
+    if (compacted.Reserve(mDataArena.GetLiveBytes()) != CHIP_NO_ERROR)
+    {
+        return;
+    }
+
+    for (auto & entry : mAttributes)
+    {
+        if (entry.mpData != nullptr)
+        {
+            entry.mpData = compacted.Store(entry.mpData, entry.mDataSize);
+        }
+    }
+
+    mDataArena = std::move(compacted);
+}
+
+size_t AttributeCache::LowerBound(const ConcreteAttributePath & aPath) const
+{
+    auto isBefore = [](const AttributeEntry & entry, const ConcreteAttributePath & path) { return entry.mPath < path; };
+    auto iter     = std::lower_bound(mAttributes.begin(), mAttributes.end(), aPath, isBefore);
+    return static_cast<size_t>(iter - mAttributes.begin());
+}
+
+const AttributeCache::AttributeEntry * AttributeCache::FindEntry(const ConcreteAttributePath & aPath) const
+{
+    size_t index = LowerBound(aPath);
+    if (index == mAttributes.size() || !(mAttributes[index].mPath == aPath))
+    {
+        return nullptr;
+    }
+    return &mAttributes[index];
+}
+
+CHIP_ERROR AttributeCache::UpdateCache(const ConcreteDataAttributePath & aPath, TLV::TLVReader * apData, const StatusIB & aStatus)
+{
+    const ConcreteAttributePath path(aPath.mEndpointId, aPath.mClusterId, aPath.mAttributeId);
+    uint8_t * data    = nullptr;
+    uint32_t dataSize = 0;
+
+    if (apData)
     {
-        state.Set<StatusIB>(aStatus);
+        ReturnErrorOnFailure(mDataArena.Store(*apData, data, dataSize));
     }
 
     //
-    // if the endpoint didn't exist previously, let's track the insertion
-    // so that we can inform our callback of a new endpoint being added appropriately.
+    // Reports generally carry attributes in path order, so priming the cache mostly appends to the end of the index.
     //
-    if (mCache.find(aPath.mEndpointId) == mCache.end())
+    size_t index = mAttributes.size();
+    if (!mAttributes.empty() && !(mAttributes.back().mPath < path))
+    {
+        index = LowerBound(path);
+    }
+
+    if (index == mAttributes.size() || !(mAttributes[index].mPath == path))
+    {
+        //
+        // if the endpoint didn't exist previously, let's track the insertion
+        // so that we can inform our callback of a new endpoint being added appropriately.
+        //
+        bool endpointExists = (index < mAttributes.size() && mAttributes[index].mPath.mEndpointId == path.mEndpointId) ||
+            (index > 0 && mAttributes[index - 1].mPath.mEndpointId == path.mEndpointId);
+        if (!endpointExists)
+        {
+            mAddedEndpoints.push_back(path.mEndpointId);
+        }
+
+        AttributeEntry entry;
+        entry.mPath = path;
+        mAttributes.insert(mAttributes.begin() + static_cast<std::ptrdiff_t>(index), entry);
+    }
+    else
     {
-        mAddedEndpoints.push_back(aPath.mEndpointId);
+        mDataArena.Release(mAttributes[index].mDataSize);
     }
 
-    mCache[aPath.mEndpointId][aPath.mClusterId][aPath.mAttributeId] = std::move(state);
-    mChangedAttributeSet.insert(aPath);
+    AttributeEntry & entry = mAttributes[index];
+    entry.mpData           = data;
+    entry.mDataSize        = dataSize;
+    entry.mStatus          = apData ? StatusIB() : aStatus;
+
+    mChangedAttributes.push_back(path);
     return CHIP_NO_ERROR;
 }
 
 void AttributeCache::OnReportBegin()
 {
-    mChangedAttributeSet.clear();
+    mChangedAttributes.clear();
     mAddedEndpoints.clear();
+
+    //
+    // Readers handed out by Get() can't be held across reports, so this is the one place where stored values can be moved.
+    //
+    if (mDataArena.ShouldCompact())
+    {
+        CompactArena();
+    }
+
     mCallback.OnReportBegin();
 }
 
 void AttributeCache::OnReportEnd()
 {
-    std::set<std::tuple<EndpointId, ClusterId>> changedClusters;
-
     //
-    // Add the EndpointId and ClusterId into a set so that we only
-    // convey unique combinations in the subsequent OnClusterChanged callback.
+    // Sort the changed paths so that we only convey unique attributes, and unique combinations of EndpointId and
+    // ClusterId in the subsequent OnClusterChanged callback.
     //
-    for (auto & path : mChangedAttributeSet)
+    std::sort(mChangedAttributes.begin(), mChangedAttributes.end());
+    mChangedAttributes.erase(std::unique(mChangedAttributes.begin(), mChangedAttributes.end()), mChangedAttributes.end());
+
+    for (auto & path : mChangedAttributes)
     {
         mCallback.OnAttributeChanged(this, path);
-        changedClusters.insert(std::make_tuple(path.mEndpointId, path.mClusterId));
     }
 
-    for (auto & item : changedClusters)
+    for (size_t i = 0; i < mChangedAttributes.size(); i++)
     {
-        mCallback.OnClusterChanged(this, std::get<0>(item), std::get<1>(item));
+        const ConcreteAttributePath & path = mChangedAttributes[i];
+        if (i == 0 || !(ConcreteClusterPath(mChangedAttributes[i - 1]) == ConcreteClusterPath(path)))
+        {
+            mCallback.OnClusterChanged(this, path.mEndpointId, path.mClusterId);
+        }
     }
 
     for (auto endpoint : mAddedEndpoints)
@@ -126,91 +293,41 @@ void AttributeCache::OnAttributeData(const ConcreteDataAttributePath & aPath, Da
 
 CHIP_ERROR AttributeCache::Get(const ConcreteAttributePath & path, TLV::TLVReader & reader)
 {
-    CHIP_ERROR err;
+    const AttributeEntry * entry = FindEntry(path);
+    VerifyOrReturnError(entry != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
 
-    auto attributeState = GetAttributeState(path.mEndpointId, path.mClusterId, path.mAttributeId, err);
-    ReturnErrorOnFailure(err);
-
-    if (attributeState->Is<StatusIB>())
+    if (entry->mpData == nullptr)
     {
         return CHIP_ERROR_IM_STATUS_CODE_RECEIVED;
     }
 
-    System::PacketBufferTLVReader bufReader;
-
-    bufReader.Init(attributeState->Get<System::PacketBufferHandle>().Retain());
-    ReturnErrorOnFailure(bufReader.Next());
-
-    reader.Init(bufReader);
-    return CHIP_NO_ERROR;
-}
-
-AttributeCache::EndpointState * AttributeCache::GetEndpointState(EndpointId endpointId, CHIP_ERROR & err)
-{
-    auto endpointIter = mCache.find(endpointId);
-    if (endpointIter == mCache.end())
-    {
-        err = CHIP_ERROR_KEY_NOT_FOUND;
-        return nullptr;
-    }
-
-    err = CHIP_NO_ERROR;
-    return &endpointIter->second;
-}
-
-AttributeCache::ClusterState * AttributeCache::GetClusterState(EndpointId endpointId, ClusterId clusterId, CHIP_ERROR & err)
-{
-    auto endpointState = GetEndpointState(endpointId, err);
-    if (err != CHIP_NO_ERROR)
-    {
-        return nullptr;
-    }
-
-    auto clusterState = endpointState->find(clusterId);
-    if (clusterState == endpointState->end())
-    {
-        err = CHIP_ERROR_KEY_NOT_FOUND;
-        return nullptr;
-    }
-
-    err = CHIP_NO_ERROR;
-    return &clusterState->second;
+    reader.Init(entry->mpData, entry->mDataSize);
+    return reader.Next();
 }
 
-AttributeCache::AttributeState * AttributeCache::GetAttributeState(EndpointId endpointId, ClusterId clusterId,
-                                                                   AttributeId attributeId, CHIP_ERROR & err)
+CHIP_ERROR AttributeCache::GetStatus(const ConcreteAttributePath & path, StatusIB & status)
 {
-    auto clusterState = GetClusterState(endpointId, clusterId, err);
-    if (err != CHIP_NO_ERROR)
-    {
-        return nullptr;
-    }
+    const AttributeEntry * entry = FindEntry(path);
+    VerifyOrReturnError(entry != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
 
-    auto attributeState = clusterState->find(attributeId);
-    if (attributeState == clusterState->end())
+    if (entry->mpData != nullptr)
     {
-        err = CHIP_ERROR_KEY_NOT_FOUND;
-        return nullptr;
+        return CHIP_ERROR_INVALID_ARGUMENT;
     }
 
-    err = CHIP_NO_ERROR;
-    return &attributeState->second;
+    status = entry->mStatus;
+    return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR AttributeCache::GetStatus(const ConcreteAttributePath & path, StatusIB & status)
+AttributeCache::MemoryUsage AttributeCache::GetMemoryUsage() const
 {
-    CHIP_ERROR err;
+    MemoryUsage usage;
 
-    auto attributeState = GetAttributeState(path.mEndpointId, path.mClusterId, path.mAttributeId, err);
-    ReturnErrorOnFailure(err);
-
-    if (!attributeState->Is<StatusIB>())
-    {
-        return CHIP_ERROR_INVALID_ARGUMENT;
-    }
-
-    status = attributeState->Get<StatusIB>();
-    return CHIP_NO_ERROR;
+    usage.mAttributeCount = mAttributes.size();
+    usage.mIndexBytes     = mAttributes.capacity() * sizeof(AttributeEntry);
+    usage.mDataBytes      = mDataArena.GetLiveBytes();
+    usage.mArenaBytes     = mDataArena.GetAllocatedBytes();
+    return usage;
 }
 
 } // namespace app
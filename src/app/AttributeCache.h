@@ -27,8 +27,7 @@
 #include <app/data-model/Decode.h>
 #include <lib/support/Variant.h>
 #include <list>
-#include <map>
-#include <set>
+#include <memory>
 #include <vector>
 
 namespace chip {
@@ -50,7 +49,9 @@ namespace app {
  * flexibility when dealing with interactions that use wildcards heavily.
  *
  * The data is stored internally in the cache as TLV. This permits re-use of the existing cluster objects
- * to de-serialize the state on-demand.
+ * to de-serialize the state on-demand. The attributes are kept in a single vector sorted by path, and their TLV
+ * encodings are packed back-to-back into a small number of large heap blocks, so that priming the cache with the full
+ * state of a node does not need a heap allocation per attribute.
  *
  * The cache serves as a callback adapter as well in that it 'forwards' the ReadClient::Callback calls transparently
  * through to a registered callback. In addition, it provides its own enhancements to the base ReadClient::Callback
@@ -235,14 +236,20 @@ public:
     template <typename IteratorFunc>
     CHIP_ERROR ForEachAttribute(EndpointId endpointId, ClusterId clusterId, IteratorFunc func)
     {
-        CHIP_ERROR err;
+        size_t begin = LowerBound(ConcreteAttributePath(endpointId, clusterId, 0));
+        size_t end   = begin;
 
-        auto clusterState = GetClusterState(endpointId, clusterId, err);
-        ReturnErrorOnFailure(err);
+        while (end < mAttributes.size() && mAttributes[end].mPath.mEndpointId == endpointId &&
+               mAttributes[end].mPath.mClusterId == clusterId)
+        {
+            end++;
+        }
+
+        VerifyOrReturnError(begin != end, CHIP_ERROR_KEY_NOT_FOUND);
 
-        for (auto & attributeIter : *clusterState)
+        for (size_t i = begin; i < end; i++)
         {
-            const ConcreteAttributePath path(endpointId, clusterId, attributeIter.first);
+            const ConcreteAttributePath path(endpointId, clusterId, mAttributes[i].mPath.mAttributeId);
             ReturnErrorOnFailure(func(path));
         }
 
@@ -265,18 +272,12 @@ public:
     template <typename IteratorFunc>
     CHIP_ERROR ForEachAttribute(ClusterId clusterId, IteratorFunc func)
     {
-        for (auto & endpointIter : mCache)
+        for (size_t i = 0; i < mAttributes.size(); i++)
         {
-            for (auto & clusterIter : endpointIter.second)
+            if (mAttributes[i].mPath.mClusterId == clusterId)
             {
-                if (clusterIter.first == clusterId)
-                {
-                    for (auto & attributeIter : clusterIter.second)
-                    {
-                        const ConcreteAttributePath path(endpointIter.first, clusterId, attributeIter.first);
-                        ReturnErrorOnFailure(func(path));
-                    }
-                }
+                const ConcreteAttributePath path(mAttributes[i].mPath.mEndpointId, clusterId, mAttributes[i].mPath.mAttributeId);
+                ReturnErrorOnFailure(func(path));
             }
         }
         return CHIP_NO_ERROR;
@@ -298,37 +299,99 @@ public:
     template <typename IteratorFunc>
     CHIP_ERROR ForEachCluster(EndpointId endpointId, IteratorFunc func)
     {
-        auto endpointIter = mCache.find(endpointId);
-        if (endpointIter->first == endpointId)
+        size_t begin = LowerBound(ConcreteAttributePath(endpointId, 0, 0));
+
+        for (size_t i = begin; i < mAttributes.size() && mAttributes[i].mPath.mEndpointId == endpointId; i++)
         {
-            for (auto & clusterIter : endpointIter->second)
+            if (i == begin || mAttributes[i - 1].mPath.mClusterId != mAttributes[i].mPath.mClusterId)
             {
-                ReturnErrorOnFailure(func(clusterIter.first));
+                ReturnErrorOnFailure(func(mAttributes[i].mPath.mClusterId));
             }
         }
+        return CHIP_NO_ERROR;
     }
 
+    /*
+     * A snapshot of how much memory the cache is using, to help size it for a given number of nodes.
+     */
+    struct MemoryUsage
+    {
+        size_t mAttributeCount = 0; // Number of attributes (data or status) in the cache
+        size_t mIndexBytes     = 0; // Bytes reserved for the sorted attribute index
+        size_t mDataBytes      = 0; // Bytes of TLV data currently referenced by the index
+        size_t mArenaBytes     = 0; // Bytes allocated for TLV data, including space held by stale values
+    };
+
+    MemoryUsage GetMemoryUsage() const;
+
 private:
-    using AttributeState = Variant<System::PacketBufferHandle, StatusIB>;
-    using ClusterState   = std::map<AttributeId, AttributeState>;
-    using EndpointState  = std::map<ClusterId, ClusterState>;
-    using NodeState      = std::map<EndpointId, EndpointState>;
+    struct AttributeEntry
+    {
+        ConcreteAttributePath mPath;
+        StatusIB mStatus;
+        uint8_t * mpData   = nullptr; // nullptr if the attribute holds mStatus instead of data.
+        uint32_t mDataSize = 0;
+    };
 
     /*
-     * These functions provide a way to index into the cached state with different sub-sets of a path, returning
-     * appropriate slices of the data as requested.
-     *
-     * In all variants, the respective slice is returned if a valid path is provided. 'err' is updated to reflect
-     * the status of the operation.
-     *
-     * Notable status values:
-     *      - If a cluster instance corresponding to endpointId and clusterId doesn't exist in the cache,
-     *        CHIP_ERROR_KEY_NOT_FOUND shall be returned.
-     *
+     * Append-only storage for the TLV encoding of the cached attribute values. Values are packed into blocks that never
+     * move once allocated, so the index can point straight into them. A value that is replaced is not reclaimed
+     * until the arena is compacted, which only happens at the start of a report, when no reader handed out by Get()
+     * may still be in use.
+     */
+    class DataArena
+    {
+    public:
+        /*
+         * Copy the element aData is positioned on into the arena. aData itself is not advanced.
+         */
+        CHIP_ERROR Store(const TLV::TLVReader & aData, uint8_t *& apData, uint32_t & aDataSize);
+
+        /*
+         * Make sure a single value of up to aSize bytes can be stored without another allocation.
+         */
+        CHIP_ERROR Reserve(size_t aSize);
+
+        /*
+         * Copy already encoded bytes into the arena, returns nullptr if out of memory.
+         */
+        uint8_t * Store(const uint8_t * apData, uint32_t aDataSize);
+
+        /*
+         * Record that aDataSize bytes previously stored are no longer referenced.
+         */
+        void Release(uint32_t aDataSize) { mLiveBytes -= aDataSize; }
+
+        bool ShouldCompact() const;
+        size_t GetLiveBytes() const { return mLiveBytes; }
+        size_t GetAllocatedBytes() const { return mAllocatedBytes; }
+
+    private:
+        struct Block
+        {
+            std::unique_ptr<uint8_t[]> mData;
+            size_t mSize = 0;
+            size_t mUsed = 0;
+        };
+
+        CHIP_ERROR AllocateBlock(size_t aSize, Block & aBlock);
+        static CHIP_ERROR WriteElement(const TLV::TLVReader & aData, Block & aBlock, uint32_t & aDataSize);
+
+        std::vector<Block> mBlocks;
+        size_t mLiveBytes      = 0;
+        size_t mAllocatedBytes = 0;
+    };
+
+    /*
+     * Index of the first entry whose path is not less than aPath.
+     */
+    size_t LowerBound(const ConcreteAttributePath & aPath) const;
+    const AttributeEntry * FindEntry(const ConcreteAttributePath & aPath) const;
+
+    /*
+     * Move every live value into a fresh arena, dropping the space held by stale values.
      */
-    EndpointState * GetEndpointState(EndpointId endpointId, CHIP_ERROR & err);
-    ClusterState * GetClusterState(EndpointId endpointId, ClusterId clusterId, CHIP_ERROR & err);
-    AttributeState * GetAttributeState(EndpointId endpointId, ClusterId clusterId, AttributeId attributeId, CHIP_ERROR & err);
+    void CompactArena();
 
     /*
      * Updates the state of an attribute in the cache given a reader. If the reader is null, the state is updated
@@ -361,8 +424,9 @@ private:
 
 private:
     Callback & mCallback;
-    NodeState mCache;
-    std::set<ConcreteAttributePath> mChangedAttributeSet;
+    std::vector<AttributeEntry> mAttributes;
+    DataArena mDataArena;
+    std::vector<ConcreteAttributePath> mChangedAttributes;
     std::vector<EndpointId> mAddedEndpoints;
     BufferedReadCallback mBufferedReader;
 };
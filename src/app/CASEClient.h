@@ -31,10 +31,11 @@ typedef void (*OnCASEConnectionFailure)(void * context, CASEClient * client, CHI
 
 struct CASEClientInitParams
 {
-    SessionManager * sessionManager          = nullptr;
-    Messaging::ExchangeManager * exchangeMgr = nullptr;
-    SessionIDAllocator * idAllocator         = nullptr;
-    FabricInfo * fabricInfo                  = nullptr;
+    SessionManager * sessionManager           = nullptr;
+    Messaging::ExchangeManager * exchangeMgr  = nullptr;
+    SessionIDAllocator * idAllocator          = nullptr;
+    FabricInfo * fabricInfo                   = nullptr;
+    CASESessionCache * sessionResumptionCache = nullptr;
 
     Optional<ReliableMessageProtocolConfig> mrpLocalConfig = Optional<ReliableMessageProtocolConfig>::Missing();
 };
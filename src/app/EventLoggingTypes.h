@@ -166,6 +166,7 @@ struct EventLoadOutContext
     ClusterInfo * mpInterestedEventPaths = nullptr;
     bool mFirst                          = true;
     FabricIndex mFabricIndex             = kUndefinedFabricIndex;
+    EventNumber mFirstEventNumberOfBoot  = 0; ///< The events numbered below were logged before the last restart
 };
 } // namespace app
 } // namespace chip
@@ -25,6 +25,8 @@
 #include <lib/support/ErrorStr.h>
 #include <lib/support/logging/CHIPLogging.h>
 
+#include <mutex>
+
 using namespace chip::TLV;
 
 namespace chip {
@@ -61,8 +63,12 @@ EventManagement & EventManagement::GetInstance(void)
 
 struct ReclaimEventCtx
 {
-    CircularEventBuffer * mpEventBuffer = nullptr;
-    size_t mSpaceNeededForMovedEvent    = 0;
+    CircularEventBuffer * mpEventBuffer           = nullptr;
+    size_t mSpaceNeededForMovedEvent              = 0;
+    PersistentEventStore * mpPersistentEventStore = nullptr; ///< Where the events dropped from their final buffer go
+#if CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    EventIndex::Entry mEvictedEvent; ///< The event at the head of mpEventBuffer, as seen by EvictEvent
+#endif
 };
 
 /**
@@ -164,8 +170,20 @@ void EventManagement::Init(Messaging::ExchangeManager * apExchangeManager, uint3
     mState        = EventManagementStates::Idle;
     mBytesWritten = 0;
 
+#if CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    for (auto & index : mEventIndex)
+    {
+        index.Clear();
+    }
+    mEventIndexValid = (aNumBuffers <= kNumPriorityLevel);
+#endif
+
 #if !CHIP_SYSTEM_CONFIG_NO_LOCKING
     CHIP_ERROR err = chip::System::Mutex::Init(mAccessLock);
+    if (err == CHIP_NO_ERROR)
+    {
+        err = chip::System::Mutex::Init(mStoreLock);
+    }
     if (err != CHIP_NO_ERROR)
     {
         ChipLogError(EventLogging, "mutex init fails with error %s", ErrorStr(err));
@@ -221,6 +239,8 @@ CHIP_ERROR EventManagement::EnsureSpaceInCircularBuffer(size_t aRequiredSpace)
     // check whether we actually need to do anything, exit if we don't
     VerifyOrExit(requiredSpace > eventBuffer->AvailableDataLength(), err = CHIP_NO_ERROR);
 
+    ctx.mpPersistentEventStore = mpPersistentEventStore;
+
     while (true)
     {
         // check that the request can ultimately be satisfied.
@@ -234,6 +254,13 @@ CHIP_ERROR EventManagement::EnsureSpaceInCircularBuffer(size_t aRequiredSpace)
             eventBuffer->mProcessEvictedElement = EvictEvent;
             eventBuffer->mAppData               = &ctx;
             err                                 = eventBuffer->EvictHead();
+#if CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+            if (err == CHIP_NO_ERROR)
+            {
+                // The head event was dropped
+                GetEventIndex(eventBuffer).RemoveHead();
+            }
+#endif
 
             // one of two things happened: either the element was evicted immediately if the head's priority is same as current
             // buffer(final one), or we figured out how much space we need to evict it into the next buffer, the check happens in
@@ -256,6 +283,19 @@ CHIP_ERROR EventManagement::EnsureSpaceInCircularBuffer(size_t aRequiredSpace)
                     // success; evict head unconditionally
                     eventBuffer->mProcessEvictedElement = nullptr;
                     err                                 = eventBuffer->EvictHead();
+#if CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+                    if (err == CHIP_NO_ERROR)
+                    {
+                        // The head event moved to the tail of the next buffer
+                        GetEventIndex(eventBuffer).RemoveHead();
+                        GetEventIndex(eventBuffer->GetNextCircularEventBuffer()).Append(ctx.mEvictedEvent);
+                    }
+                    else
+                    {
+                        // The event is now in both buffers
+                        mEventIndexValid = false;
+                    }
+#endif
                     // if unconditional eviction failed, this
                     // means that we have no way of further
                     // clearing the buffer.  fail out and let the
@@ -393,11 +433,66 @@ void EventManagement::CreateEventManagement(Messaging::ExchangeManager * apExcha
 void EventManagement::DestroyEventManagement()
 {
 #if !CHIP_SYSTEM_CONFIG_NO_LOCKING
-    ScopedLock lock(sInstance);
+    std::lock_guard<System::Mutex> storeLock(sInstance.mStoreLock);
 #endif // !CHIP_SYSTEM_CONFIG_NO_LOCKING
-    sInstance.mState        = EventManagementStates::Shutdown;
-    sInstance.mpEventBuffer = nullptr;
-    sInstance.mpExchangeMgr = nullptr;
+    PersistentEventStore * store = nullptr;
+    CHIP_ERROR err               = CHIP_NO_ERROR;
+    {
+#if !CHIP_SYSTEM_CONFIG_NO_LOCKING
+        ScopedLock lock(sInstance);
+#endif // !CHIP_SYSTEM_CONFIG_NO_LOCKING
+        if (sInstance.mState != EventManagementStates::Shutdown && sInstance.mpPersistentEventStore != nullptr)
+        {
+            // The events still in the buffers would be lost otherwise
+            store = sInstance.mpPersistentEventStore;
+            err   = sInstance.AppendEventsToPersistentStore();
+        }
+        sInstance.mState                  = EventManagementStates::Shutdown;
+        sInstance.mpEventBuffer           = nullptr;
+        sInstance.mpExchangeMgr           = nullptr;
+        sInstance.mpPersistentEventStore  = nullptr;
+        sInstance.mFirstEventNumberOfBoot = 0;
+    }
+
+    if (store != nullptr)
+    {
+        if (err == CHIP_NO_ERROR)
+        {
+            err = store->Flush();
+        }
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(EventLogging, "Failed to store the buffered events: %" CHIP_ERROR_FORMAT, err.Format());
+        }
+    }
+}
+
+CHIP_ERROR EventManagement::AppendEventsToPersistentStore()
+{
+    TLVReader reader;
+    CircularEventBufferWrapper bufWrapper;
+    ReturnErrorOnFailure(GetEventReader(reader, PriorityLevel::Critical, &bufWrapper));
+
+    CHIP_ERROR err = TLV::Utilities::Iterate(reader, AppendEventToPersistentStore, mpPersistentEventStore, false /* recurse */);
+    return (err == CHIP_END_OF_TLV) ? CHIP_NO_ERROR : err;
+}
+
+CHIP_ERROR EventManagement::AppendEventToPersistentStore(const TLVReader & aReader, size_t aDepth, void * apContext)
+{
+    TLVReader reader;
+    TLVType containerType;
+    TLVType containerType1;
+    EventEnvelopeContext context;
+
+    // Only the event number is needed, found as in EvictEvent
+    reader.Init(aReader);
+    ReturnErrorOnFailure(reader.EnterContainer(containerType));
+    ReturnErrorOnFailure(reader.Next());
+    ReturnErrorOnFailure(reader.EnterContainer(containerType1));
+    CHIP_ERROR err = TLV::Utilities::Iterate(reader, FetchEventParameters, &context, false /* recurse */);
+    VerifyOrReturnError(err == CHIP_NO_ERROR || err == CHIP_END_OF_TLV, err);
+
+    return static_cast<PersistentEventStore *>(apContext)->AppendEvent(context.mEventNumber, aReader);
 }
 
 CircularEventBuffer * EventManagement::GetPriorityBuffer(PriorityLevel aPriority) const
@@ -412,6 +507,13 @@ CircularEventBuffer * EventManagement::GetPriorityBuffer(PriorityLevel aPriority
     return buf;
 }
 
+// A delta can't go backwards, nor between timestamps of different types
+static bool CanUseDeltaTime(const EventLoadOutContext & aContext)
+{
+    return !aContext.mFirst && aContext.mCurrentTime.mType == aContext.mPreviousTime.mType &&
+        aContext.mCurrentTime.mValue >= aContext.mPreviousTime.mValue;
+}
+
 CHIP_ERROR EventManagement::CopyAndAdjustDeltaTime(const TLVReader & aReader, size_t aDepth, void * apContext)
 {
     CopyAndAdjustDeltaTimeContext * ctx = static_cast<CopyAndAdjustDeltaTimeContext *>(apContext);
@@ -422,12 +524,14 @@ CHIP_ERROR EventManagement::CopyAndAdjustDeltaTime(const TLVReader & aReader, si
         // Does not go on the wire.
         return CHIP_NO_ERROR;
     }
-    else if ((aReader.GetTag() == TLV::ContextTag(to_underlying(EventDataIB::Tag::kSystemTimestamp))) && !(ctx->mpContext->mFirst))
+    else if ((aReader.GetTag() == TLV::ContextTag(to_underlying(EventDataIB::Tag::kSystemTimestamp))) &&
+             CanUseDeltaTime(*ctx->mpContext))
     {
         return ctx->mpWriter->Put(TLV::ContextTag(to_underlying(EventDataIB::Tag::kDeltaSystemTimestamp)),
                                   ctx->mpContext->mCurrentTime.mValue - ctx->mpContext->mPreviousTime.mValue);
     }
-    else if ((aReader.GetTag() == TLV::ContextTag(to_underlying(EventDataIB::Tag::kEpochTimestamp))) && !(ctx->mpContext->mFirst))
+    else if ((aReader.GetTag() == TLV::ContextTag(to_underlying(EventDataIB::Tag::kEpochTimestamp))) &&
+             CanUseDeltaTime(*ctx->mpContext))
     {
         return ctx->mpWriter->Put(TLV::ContextTag(to_underlying(EventDataIB::Tag::kDeltaEpochTimestamp)),
                                   ctx->mpContext->mCurrentTime.mValue - ctx->mpContext->mPreviousTime.mValue);
@@ -464,10 +568,29 @@ CHIP_ERROR EventManagement::LogEvent(EventLoggingDelegate * apDelegate, const Ev
         VerifyOrExit(mState != EventManagementStates::Shutdown, err = CHIP_ERROR_INCORRECT_STATE);
         err = LogEventPrivate(apDelegate, aEventOptions, aEventNumber);
     }
+
+    FlushPersistentEventStore();
 exit:
     return err;
 }
 
+void EventManagement::FlushPersistentEventStore()
+{
+#if !CHIP_SYSTEM_CONFIG_NO_LOCKING
+    // Keeps the store from being replaced. Logging does not need it, so it goes on while the files are written.
+    std::lock_guard<System::Mutex> storeLock(mStoreLock);
+#endif // !CHIP_SYSTEM_CONFIG_NO_LOCKING
+
+    if (mpPersistentEventStore != nullptr)
+    {
+        CHIP_ERROR err = mpPersistentEventStore->Flush();
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(EventLogging, "Failed to write stored events: %" CHIP_ERROR_FORMAT, err.Format());
+        }
+    }
+}
+
 CHIP_ERROR EventManagement::LogEventPrivate(EventLoggingDelegate * apDelegate, const EventOptions & aEventOptions,
                                             EventNumber & aEventNumber)
 {
@@ -491,8 +614,6 @@ CHIP_ERROR EventManagement::LogEventPrivate(EventLoggingDelegate * apDelegate, c
 #endif
 
     opts = EventOptions(timestamp);
-    // Start the event container (anonymous structure) in the circular buffer
-    writer.Init(*mpEventBuffer);
 
     opts.mPriority = aEventOptions.mPriority;
     // Create all event specific data
@@ -512,9 +633,26 @@ CHIP_ERROR EventManagement::LogEventPrivate(EventLoggingDelegate * apDelegate, c
     err = EnsureSpaceInCircularBuffer(requestSize);
     SuccessOrExit(err);
 
+    // Start the event container (anonymous structure) in the circular buffer. Only once there is space: on a full buffer,
+    // the writer would have to evict an event on initialization, and be left unusable.
+    writer.Init(*mpEventBuffer);
+
     err = ConstructEvent(&ctxt, apDelegate, &opts);
     SuccessOrExit(err);
 
+#if CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    // The event is stored from here on, even if it is too large for the buffers below.
+    {
+        EventIndex::Entry entry;
+        entry.mEventNumber = ctxt.mCurrentEventNumber;
+        entry.mClusterId   = opts.mPath.mClusterId;
+        entry.mEventId     = opts.mPath.mEventId;
+        entry.mEndpointId  = opts.mPath.mEndpointId;
+        entry.mFabricIndex = opts.mFabricIndex;
+        GetEventIndex(mpEventBuffer).Append(entry);
+    }
+#endif
+
     // Check the number of bytes written.  If the event is too large
     // to be evicted from subsequent buffers, drop it now.
     buffer = mpEventBuffer;
@@ -590,19 +728,19 @@ CHIP_ERROR EventManagement::CopyEvent(const TLVReader & aReader, TLVWriter & aWr
     return CHIP_NO_ERROR;
 }
 
-static bool IsInterestedEventPaths(EventLoadOutContext * eventLoadOutContext, const EventEnvelopeContext & event)
+static bool IsInterestedEventPaths(const EventLoadOutContext * eventLoadOutContext, EventNumber aEventNumber,
+                                   FabricIndex aFabricIndex, const ConcreteEventPath & path)
 {
-    if (eventLoadOutContext->mCurrentEventNumber < eventLoadOutContext->mStartingEventNumber)
+    if (aEventNumber < eventLoadOutContext->mStartingEventNumber)
     {
         return false;
     }
 
-    if (event.mFabricIndex != kUndefinedFabricIndex && eventLoadOutContext->mFabricIndex != event.mFabricIndex)
+    if (aFabricIndex != kUndefinedFabricIndex && eventLoadOutContext->mFabricIndex != aFabricIndex)
     {
         return false;
     }
 
-    ConcreteEventPath path(event.mEndpointId, event.mClusterId, event.mEventId);
     for (auto * interestedPath = eventLoadOutContext->mpInterestedEventPaths; interestedPath != nullptr;
          interestedPath        = interestedPath->mpNext)
     {
@@ -614,6 +752,20 @@ static bool IsInterestedEventPaths(EventLoadOutContext * eventLoadOutContext, co
     return false;
 }
 
+static bool IsInterestedEventPaths(EventLoadOutContext * eventLoadOutContext, const EventEnvelopeContext & event)
+{
+    return IsInterestedEventPaths(eventLoadOutContext, eventLoadOutContext->mCurrentEventNumber, event.mFabricIndex,
+                                  ConcreteEventPath(event.mEndpointId, event.mClusterId, event.mEventId));
+}
+
+#if CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+static bool IsInterestedEventPaths(const EventLoadOutContext * eventLoadOutContext, const EventIndex::Entry & event)
+{
+    return IsInterestedEventPaths(eventLoadOutContext, event.mEventNumber, event.mFabricIndex,
+                                  ConcreteEventPath(event.mEndpointId, event.mClusterId, event.mEventId));
+}
+#endif
+
 CHIP_ERROR EventManagement::EventIterator(const TLVReader & aReader, size_t aDepth, EventLoadOutContext * apEventLoadOutContext)
 {
     CHIP_ERROR err = CHIP_NO_ERROR;
@@ -656,6 +808,14 @@ CHIP_ERROR EventManagement::CopyEventsSince(const TLVReader & aReader, size_t aD
     CHIP_ERROR err                             = EventIterator(aReader, aDepth, loadOutContext);
     if (err == CHIP_EVENT_ID_FOUND)
     {
+        // System timestamps logged before a restart count from another boot, so such events, and the first one after
+        // them, get full timestamps.
+        const bool beforeRestart = loadOutContext->mCurrentEventNumber < loadOutContext->mFirstEventNumberOfBoot;
+        if (beforeRestart)
+        {
+            loadOutContext->mFirst = true;
+        }
+
         // checkpoint the writer
         TLV::TLVWriter checkpoint = loadOutContext->mWriter;
 
@@ -671,13 +831,53 @@ CHIP_ERROR EventManagement::CopyEventsSince(const TLVReader & aReader, size_t aD
             return err;
         }
 
-        loadOutContext->mPreviousTime.mValue = loadOutContext->mCurrentTime.mValue;
-        loadOutContext->mFirst               = false;
+        loadOutContext->mPreviousTime = loadOutContext->mCurrentTime;
+        loadOutContext->mFirst        = beforeRestart;
         loadOutContext->mEventCount++;
     }
     return err;
 }
 
+CHIP_ERROR EventManagement::SetPersistentEventStore(PersistentEventStore * apStore)
+{
+#if !CHIP_SYSTEM_CONFIG_NO_LOCKING
+    std::lock_guard<System::Mutex> storeLock(mStoreLock);
+    ScopedLock lock(sInstance);
+#endif // !CHIP_SYSTEM_CONFIG_NO_LOCKING
+
+    EventNumber lastStoredEventNumber;
+
+    VerifyOrReturnError(mpEventNumberCounter != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    mpPersistentEventStore  = apStore;
+    mFirstEventNumberOfBoot = 0;
+    VerifyOrReturnError(apStore != nullptr && apStore->GetLastEventNumber(lastStoredEventNumber), CHIP_NO_ERROR);
+
+    // The stored events may come from before a restart. If not, treating them as such only costs full timestamps.
+    mFirstEventNumberOfBoot = lastStoredEventNumber + 1;
+
+    if (mpEventNumberCounter->GetValue() <= lastStoredEventNumber)
+    {
+        ChipLogProgress(EventLogging, "Event number counter moved past stored event 0x" ChipLogFormatX64,
+                        ChipLogValueX64(lastStoredEventNumber));
+        VerifyOrReturnError(lastStoredEventNumber < UINT32_MAX, CHIP_ERROR_INVALID_INTEGER_VALUE);
+        if (mpEventNumberCounter == &mNonPersistedCounter)
+        {
+            ReturnErrorOnFailure(mNonPersistedCounter.Init(static_cast<uint32_t>(lastStoredEventNumber + 1)));
+        }
+        else
+        {
+            // A persisted counter only writes to storage once per epoch, so advancing it is cheap
+            while (mpEventNumberCounter->GetValue() <= lastStoredEventNumber)
+            {
+                ReturnErrorOnFailure(mpEventNumberCounter->Advance());
+            }
+        }
+        mLastEventNumber = mpEventNumberCounter->GetValue();
+    }
+
+    return CHIP_NO_ERROR;
+}
+
 CHIP_ERROR EventManagement::FetchEventsSince(TLVWriter & aWriter, ClusterInfo * apClusterInfolist, EventNumber & aEventMin,
                                              size_t & aEventCount, FabricIndex aFabricIndex)
 {
@@ -689,18 +889,57 @@ CHIP_ERROR EventManagement::FetchEventsSince(TLVWriter & aWriter, ClusterInfo *
     EventLoadOutContext context(aWriter, PriorityLevel::Invalid, aEventMin);
 
 #if !CHIP_SYSTEM_CONFIG_NO_LOCKING
-    ScopedLock lock(sInstance);
+    // Keeps the store from being flushed or replaced while it is read
+    std::lock_guard<System::Mutex> storeLock(mStoreLock);
 #endif // !CHIP_SYSTEM_CONFIG_NO_LOCKING
 
-    context.mFabricIndex           = aFabricIndex;
-    context.mpInterestedEventPaths = apClusterInfolist;
-    err                            = GetEventReader(reader, PriorityLevel::Critical, &bufWrapper);
-    SuccessOrExit(err);
+    context.mFabricIndex            = aFabricIndex;
+    context.mpInterestedEventPaths  = apClusterInfolist;
+    context.mFirstEventNumberOfBoot = mFirstEventNumberOfBoot;
 
-    err = TLV::Utilities::Iterate(reader, CopyEventsSince, &context, recurse);
-    if (err == CHIP_END_OF_TLV)
+    if (mpPersistentEventStore != nullptr)
     {
-        err = CHIP_NO_ERROR;
+        // The events dropped from the buffers come first, they are older than the ones still there. The written ones are
+        // read without mAccessLock, so that events can be logged meanwhile.
+        err = mpPersistentEventStore->ForEachWrittenEventSince(aEventMin, CopyEventsSince, &context);
+        if (err == CHIP_END_OF_TLV)
+        {
+            err = CHIP_NO_ERROR;
+        }
+        SuccessOrExit(err);
+    }
+
+    {
+#if !CHIP_SYSTEM_CONFIG_NO_LOCKING
+        ScopedLock lock(sInstance);
+#endif // !CHIP_SYSTEM_CONFIG_NO_LOCKING
+
+        if (mpPersistentEventStore != nullptr)
+        {
+            err = mpPersistentEventStore->ForEachBufferedEventSince(aEventMin, CopyEventsSince, &context);
+            if (err == CHIP_END_OF_TLV)
+            {
+                err = CHIP_NO_ERROR;
+            }
+            SuccessOrExit(err);
+        }
+
+#if CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+        if (mEventIndexEnabled && mEventIndexValid)
+        {
+            err = FetchIndexedEventsSince(context);
+            ExitNow();
+        }
+#endif
+
+        err = GetEventReader(reader, PriorityLevel::Critical, &bufWrapper);
+        SuccessOrExit(err);
+
+        err = TLV::Utilities::Iterate(reader, CopyEventsSince, &context, recurse);
+        if (err == CHIP_END_OF_TLV)
+        {
+            err = CHIP_NO_ERROR;
+        }
     }
 
 exit:
@@ -709,6 +948,77 @@ exit:
     return err;
 }
 
+#if CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+CHIP_ERROR EventManagement::FetchIndexedEventsSince(EventLoadOutContext & aContext)
+{
+    // Events are read from the critical buffer first, then from buffers of lower priority, and in each buffer the events
+    // that are not indexed come first. Find how many events have to be read to reach the last one that is either not
+    // indexed or of interest: the ones after it are only accounted for.
+    CircularEventBuffer * const firstBuffer = GetPriorityBuffer(PriorityLevel::Critical);
+    size_t eventCount                       = 0;
+    size_t eventsToRead                     = 0;
+    EventNumber lastEventNumber             = 0;
+    for (CircularEventBuffer * buffer = firstBuffer; buffer != nullptr; buffer = buffer->GetPreviousCircularEventBuffer())
+    {
+        const EventIndex & index = GetEventIndex(buffer);
+        if (index.GetUnindexedCount() > 0)
+        {
+            eventCount += index.GetUnindexedCount();
+            eventsToRead = eventCount;
+        }
+        for (size_t i = 0; i < index.GetCount(); i++)
+        {
+            eventCount++;
+            lastEventNumber = index.Get(i).mEventNumber;
+            if (IsInterestedEventPaths(&aContext, index.Get(i)))
+            {
+                eventsToRead = eventCount;
+            }
+        }
+    }
+
+    if (eventsToRead > 0)
+    {
+        TLVReader reader;
+        CircularEventBufferWrapper bufWrapper;
+        ReturnErrorOnFailure(GetEventReader(reader, PriorityLevel::Critical, &bufWrapper));
+
+        size_t eventsRead = 0;
+        for (CircularEventBuffer * buffer = firstBuffer; buffer != nullptr && eventsRead < eventsToRead;
+             buffer                       = buffer->GetPreviousCircularEventBuffer())
+        {
+            const EventIndex & index = GetEventIndex(buffer);
+            const size_t count       = index.GetUnindexedCount() + index.GetCount();
+            for (size_t i = 0; i < count && eventsRead < eventsToRead; i++, eventsRead++)
+            {
+                CHIP_ERROR err = reader.Next();
+                VerifyOrReturnError(err != CHIP_END_OF_TLV, CHIP_NO_ERROR);
+                ReturnErrorOnFailure(err);
+
+                if (i >= index.GetUnindexedCount())
+                {
+                    const EventIndex::Entry & event = index.Get(i - index.GetUnindexedCount());
+                    if (!IsInterestedEventPaths(&aContext, event))
+                    {
+                        // Skipped without decoding
+                        aContext.mCurrentEventNumber = event.mEventNumber;
+                        continue;
+                    }
+                }
+                ReturnErrorOnFailure(CopyEventsSince(reader, 0, &aContext));
+            }
+        }
+    }
+
+    if (eventCount > eventsToRead)
+    {
+        // Only indexed events that are not of interest remain
+        aContext.mCurrentEventNumber = lastEventNumber;
+    }
+    return CHIP_NO_ERROR;
+}
+#endif // CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+
 CHIP_ERROR EventManagement::GetEventReader(TLVReader & aReader, PriorityLevel aPriority, CircularEventBufferWrapper * apBufWrapper)
 {
     CircularEventBuffer * buffer = GetPriorityBuffer(aPriority);
@@ -776,6 +1086,10 @@ CHIP_ERROR EventManagement::FetchEventParameters(const TLVReader & aReader, size
 
 CHIP_ERROR EventManagement::EvictEvent(CHIPCircularTLVBuffer & apBuffer, void * apAppData, TLVReader & aReader)
 {
+    // Before the event, for handing it to the persistent store
+    TLVReader eventReader;
+    eventReader.Init(aReader);
+
     // pull out the delta time, pull out the priority
     ReturnErrorOnFailure(aReader.Next());
 
@@ -800,6 +1114,13 @@ CHIP_ERROR EventManagement::EvictEvent(CHIPCircularTLVBuffer & apBuffer, void *
 
     ReclaimEventCtx * const ctx             = static_cast<ReclaimEventCtx *>(apAppData);
     CircularEventBuffer * const eventBuffer = ctx->mpEventBuffer;
+#if CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    ctx->mEvictedEvent.mEventNumber = context.mEventNumber;
+    ctx->mEvictedEvent.mClusterId   = context.mClusterId;
+    ctx->mEvictedEvent.mEventId     = context.mEventId;
+    ctx->mEvictedEvent.mEndpointId  = context.mEndpointId;
+    ctx->mEvictedEvent.mFabricIndex = context.mFabricIndex;
+#endif
     if (eventBuffer->IsFinalDestinationForPriority(imp))
     {
         ChipLogProgress(EventLogging,
@@ -807,6 +1128,20 @@ CHIP_ERROR EventManagement::EvictEvent(CHIPCircularTLVBuffer & apBuffer, void *
                         " due to overflow: event priority_level: %u",
                         static_cast<unsigned>(eventBuffer->GetPriority()), ChipLogValueX64(context.mEventNumber),
                         static_cast<unsigned>(imp));
+        if (ctx->mpPersistentEventStore != nullptr)
+        {
+            // Failing to persist the event does not prevent dropping it
+            err = eventReader.Next();
+            if (err == CHIP_NO_ERROR)
+            {
+                err = ctx->mpPersistentEventStore->AppendEvent(context.mEventNumber, eventReader);
+            }
+            if (err != CHIP_NO_ERROR)
+            {
+                ChipLogError(EventLogging, "Failed to persist event 0x" ChipLogFormatX64 ": %" CHIP_ERROR_FORMAT,
+                             ChipLogValueX64(context.mEventNumber), err.Format());
+            }
+        }
         ctx->mSpaceNeededForMovedEvent = 0;
         return CHIP_NO_ERROR;
     }
@@ -826,6 +1161,41 @@ void EventManagement::SetScheduledEventInfo(EventNumber & aEventNumber, uint32_t
     aInitialWrittenEventBytes = mBytesWritten;
 }
 
+#if CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+void EventIndex::Clear()
+{
+    mHead           = 0;
+    mCount          = 0;
+    mUnindexedCount = 0;
+}
+
+void EventIndex::Append(const Entry & aEntry)
+{
+    if (mCount == kCapacity)
+    {
+        // Forget the oldest event, which will be decoded when needed
+        mHead = (mHead + 1) % kCapacity;
+        mCount--;
+        mUnindexedCount++;
+    }
+    mEntries[(mHead + mCount) % kCapacity] = aEntry;
+    mCount++;
+}
+
+void EventIndex::RemoveHead()
+{
+    if (mUnindexedCount > 0)
+    {
+        mUnindexedCount--;
+    }
+    else if (mCount > 0)
+    {
+        mHead = (mHead + 1) % kCapacity;
+        mCount--;
+    }
+}
+#endif // CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+
 void CircularEventBuffer::Init(uint8_t * apBuffer, uint32_t aBufferLength, CircularEventBuffer * apPrev,
                                CircularEventBuffer * apNext, PriorityLevel aPriorityLevel)
 {
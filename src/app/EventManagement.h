@@ -30,6 +30,7 @@
 #include "EventLoggingTypes.h"
 #include <app/ClusterInfo.h>
 #include <app/MessageDef/EventDataIB.h>
+#include <app/PersistentEventStore.h>
 #include <app/util/basic-types.h>
 #include <lib/core/CHIPCircularTLVBuffer.h>
 #include <lib/support/PersistedCounter.h>
@@ -134,6 +135,56 @@ private:
     CHIP_ERROR GetNextBuffer(chip::TLV::TLVReader & aReader, const uint8_t *& aBufStart, uint32_t & aBufLen) override;
 };
 
+#if CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+/**
+ * @brief
+ *   The number, path and fabric of the events stored in one CircularEventBuffer, oldest first (internal API).
+ *
+ *   FetchEventsSince uses it to skip the events a reader is not interested in without decoding them. When the buffer
+ *   holds more events than the index, the oldest ones are only counted, and they get decoded as before.
+ */
+class EventIndex
+{
+public:
+    struct Entry
+    {
+        EventNumber mEventNumber;
+        ClusterId mClusterId;
+        EventId mEventId;
+        EndpointId mEndpointId;
+        FabricIndex mFabricIndex;
+    };
+
+    void Clear();
+
+    /**
+     * @brief Add the event logged (or moved) at the tail of the buffer.
+     */
+    void Append(const Entry & aEntry);
+
+    /**
+     * @brief Forget the event evicted from the head of the buffer.
+     */
+    void RemoveHead();
+
+    /**
+     * @brief The number of events at the head of the buffer which are not indexed.
+     */
+    size_t GetUnindexedCount() const { return mUnindexedCount; }
+
+    size_t GetCount() const { return mCount; }
+    const Entry & Get(size_t aIndex) const { return mEntries[(mHead + aIndex) % kCapacity]; }
+
+private:
+    static constexpr size_t kCapacity = CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE;
+
+    Entry mEntries[kCapacity];
+    size_t mHead           = 0;
+    size_t mCount          = 0;
+    size_t mUnindexedCount = 0;
+};
+#endif // CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+
 enum class EventManagementStates
 {
     Idle       = 1, // No log offload in progress, log offload can begin without any constraints
@@ -362,6 +413,27 @@ public:
      */
     void SetScheduledEventInfo(EventNumber & aEventNumber, uint32_t & aInitialWrittenEventBytes);
 
+    /**
+     * @brief
+     *   Enable or disable the event index in FetchEventsSince, which otherwise decodes every stored event. The index is
+     *   maintained either way. Enabled by default, no effect if CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE is 0.
+     */
+    void SetEventIndexEnabled(bool aEnabled) { mEventIndexEnabled = aEnabled; }
+
+    /**
+     * @brief
+     *   Keep the events dropped from the event buffers in apStore, and serve them from there to readers that have not
+     *   seen them yet. Pass nullptr to stop using the store. The store must outlive its use. DestroyEventManagement also
+     *   stores the events still in the buffers, so that they are not lost on shutdown.
+     *
+     *   Must be called before the first LogEvent, e.g. right after Server::Init, so that the events of this boot are
+     *   told apart from the stored ones.
+     *
+     *   If the store holds events numbered at or past the event number counter, as after a restart without a persisted
+     *   counter, the counter is moved past them so that event numbers are not reused.
+     */
+    CHIP_ERROR SetPersistentEventStore(PersistentEventStore * apStore);
+
 private:
     void VendEventNumber();
     CHIP_ERROR CalculateEventSize(EventLoggingDelegate * apDelegate, const EventOptions * apOptions, uint32_t & requiredSize);
@@ -446,6 +518,12 @@ private:
      * requires, and return.
      */
     static CHIP_ERROR EvictEvent(chip::TLV::CHIPCircularTLVBuffer & aBuffer, void * apAppData, TLV::TLVReader & aReader);
+
+    /**
+     * @brief Appends all the events in the buffers to mpPersistentEventStore, on shutdown.
+     */
+    CHIP_ERROR AppendEventsToPersistentStore();
+    static CHIP_ERROR AppendEventToPersistentStore(const TLV::TLVReader & aReader, size_t aDepth, void * apContext);
     static CHIP_ERROR AlwaysFail(chip::TLV::CHIPCircularTLVBuffer & aBuffer, void * apAppData, TLV::TLVReader & aReader)
     {
         return CHIP_ERROR_NO_MEMORY;
@@ -466,6 +544,20 @@ private:
      */
     CircularEventBuffer * GetPriorityBuffer(PriorityLevel aPriority) const;
 
+#if CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    EventIndex & GetEventIndex(const CircularEventBuffer * apBuffer) { return mEventIndex[apBuffer - mpEventBuffer]; }
+
+    /**
+     * @brief Implements #FetchEventsSince using the event index, decoding only the events that can't be skipped.
+     */
+    CHIP_ERROR FetchIndexedEventsSince(EventLoadOutContext & aContext);
+#endif
+
+    /**
+     * @brief Writes the events evicted to mpPersistentEventStore, without holding mAccessLock.
+     */
+    void FlushPersistentEventStore();
+
     // EventBuffer for debug level,
     CircularEventBuffer * mpEventBuffer        = nullptr;
     Messaging::ExchangeManager * mpExchangeMgr = nullptr;
@@ -473,6 +565,9 @@ private:
     uint32_t mBytesWritten                     = 0;
 #if !CHIP_SYSTEM_CONFIG_NO_LOCKING
     System::Mutex mAccessLock;
+    // Serializes the file accesses of mpPersistentEventStore, taken before mAccessLock. Changing mpPersistentEventStore
+    // takes both.
+    System::Mutex mStoreLock;
 #endif // !CHIP_SYSTEM_CONFIG_NO_LOCKING
 
     // The counter we're going to actually use.
@@ -483,6 +578,15 @@ private:
 
     EventNumber mLastEventNumber = 0; ///< Last event Number vended for this priority
     Timestamp mLastEventTimestamp;    ///< The timestamp of the last event in this buffer
+
+#if CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    EventIndex mEventIndex[kNumPriorityLevel]; ///< One per buffer, in the order of mpEventBuffer
+    bool mEventIndexValid = false;             ///< False if the index may not match the stored events
+#endif
+    bool mEventIndexEnabled = true;
+
+    PersistentEventStore * mpPersistentEventStore = nullptr;
+    EventNumber mFirstEventNumberOfBoot           = 0; ///< Past the events in mpPersistentEventStore when it was set
 };
 } // namespace app
 } // namespace chip
@@ -0,0 +1,464 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *         This file implements a PersistentEventStore for Linux.
+ *
+ *         Each segment file starts with an 8 byte magic, followed by records of:
+ *
+ *           uint64_t eventNumber
+ *           uint32_t length
+ *           the event TLV, of that length
+ *
+ *         with all integers little-endian.
+ *
+ */
+
+#include <app/FileEventStore.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <lib/core/CHIPEncoding.h>
+#include <lib/support/CHIPMemString.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <algorithm>
+
+namespace chip {
+namespace app {
+
+namespace {
+
+constexpr uint8_t kMagic[8] = { 'C', 'H', 'I', 'P', 'E', 'V', 'L', 1 };
+
+bool ReadAll(int fd, uint8_t * data, size_t length, size_t offset)
+{
+    size_t done = 0;
+
+    while (done < length)
+    {
+        ssize_t result = pread(fd, data + done, length - done, static_cast<off_t>(offset + done));
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (result <= 0)
+        {
+            return false;
+        }
+        done += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+bool WriteAll(int fd, const uint8_t * data, size_t length)
+{
+    size_t written = 0;
+
+    while (written < length)
+    {
+        ssize_t result = write(fd, data + written, length - written);
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (result <= 0)
+        {
+            return false;
+        }
+        written += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+} // namespace
+
+FileEventStore::~FileEventStore()
+{
+    Shutdown();
+}
+
+CHIP_ERROR FileEventStore::Init(const char * apPath, size_t aMaxSegmentSize)
+{
+    VerifyOrReturnError(apPath != nullptr && strlen(apPath) < kMaxPathLength, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(aMaxSegmentSize >= sizeof(kMagic) + sizeof(mRecord), CHIP_ERROR_INVALID_ARGUMENT);
+
+    Shutdown();
+
+    Platform::CopyString(mPath, apPath);
+    mMaxSegmentSize = aMaxSegmentSize;
+    // Blocks start at least this far apart, so a full segment needs no more than kIndexSize of them.
+    mBlockSize = (aMaxSegmentSize - sizeof(kMagic) + kIndexSize - 1) / kIndexSize;
+
+    for (size_t i = 0; i < kSegmentCount; i++)
+    {
+        CHIP_ERROR err = OpenSegment(i, false /* aTruncate */);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(EventLogging, "failed to open event store (%s): %" CHIP_ERROR_FORMAT, apPath, err.Format());
+            Shutdown();
+            return err;
+        }
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+void FileEventStore::Shutdown()
+{
+    for (auto & segment : mSegments)
+    {
+        if (segment.mFd != -1)
+        {
+            close(segment.mFd);
+            segment.mFd = -1;
+        }
+        segment.mSize       = 0;
+        segment.mBlockCount = 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mLock);
+    mMaxSegmentSize = 0;
+    mBuffered.clear();
+    mHasEvents       = false;
+    mLastEventNumber = 0;
+}
+
+CHIP_ERROR FileEventStore::AppendEvent(EventNumber aEventNumber, const TLV::TLVReader & aEvent)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    VerifyOrReturnError(mMaxSegmentSize != 0, CHIP_ERROR_INCORRECT_STATE);
+    // Only reached if Flush keeps failing, past that the oldest buffered events would be rotated out anyway.
+    VerifyOrReturnError(mBuffered.size() + sizeof(mRecord) <= mMaxSegmentSize, CHIP_ERROR_NO_MEMORY);
+
+    const size_t offset = mBuffered.size();
+    mBuffered.resize(offset + sizeof(mRecord));
+
+    TLV::TLVReader reader;
+    TLV::TLVWriter writer;
+    reader.Init(aEvent);
+    writer.Init(&mBuffered[offset + kRecordHeaderSize], kMaxEventSize);
+    CHIP_ERROR err = writer.CopyElement(reader);
+    if (err == CHIP_NO_ERROR)
+    {
+        err = writer.Finalize();
+    }
+    if (err != CHIP_NO_ERROR)
+    {
+        mBuffered.resize(offset);
+        return err;
+    }
+
+    const size_t length = writer.GetLengthWritten();
+    Encoding::LittleEndian::Put64(&mBuffered[offset], aEventNumber);
+    Encoding::LittleEndian::Put32(&mBuffered[offset + sizeof(uint64_t)], static_cast<uint32_t>(length));
+    mBuffered.resize(offset + kRecordHeaderSize + length);
+
+    if (!mHasEvents || aEventNumber > mLastEventNumber)
+    {
+        mLastEventNumber = aEventNumber;
+        mHasEvents       = true;
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR FileEventStore::Flush()
+{
+    std::vector<uint8_t> records;
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        records.swap(mBuffered);
+    }
+
+    size_t written = 0;
+    CHIP_ERROR err = WriteRecords(records, written);
+    if (err != CHIP_NO_ERROR)
+    {
+        // The records not written go back ahead of those appended meanwhile, for the next Flush.
+        std::lock_guard<std::mutex> lock(mLock);
+        mBuffered.insert(mBuffered.begin(), records.begin() + static_cast<std::ptrdiff_t>(written), records.end());
+    }
+    return err;
+}
+
+CHIP_ERROR FileEventStore::WriteRecords(const std::vector<uint8_t> & aRecords, size_t & aWritten)
+{
+    while (aWritten < aRecords.size())
+    {
+        VerifyOrReturnError(mSegments[kSegmentCount - 1].mFd != -1, CHIP_ERROR_INCORRECT_STATE);
+        if (mSegments[kSegmentCount - 1].mSize + GetRecordSize(&aRecords[aWritten]) > mMaxSegmentSize)
+        {
+            ReturnErrorOnFailure(StartNewSegment());
+        }
+
+        // All the records that fit in the segment go in a single write.
+        Segment & segment = mSegments[kSegmentCount - 1];
+        size_t end        = aWritten;
+        while (end < aRecords.size() && segment.mSize + (end - aWritten) + GetRecordSize(&aRecords[end]) <= mMaxSegmentSize)
+        {
+            end += GetRecordSize(&aRecords[end]);
+        }
+
+        if (!WriteAll(segment.mFd, &aRecords[aWritten], end - aWritten))
+        {
+            ChipLogError(EventLogging, "failed to write event store, %s (%d)", strerror(errno), errno);
+            // Part of a record would end the segment at the next startup, hiding the records appended after it.
+            if (ftruncate(segment.mFd, static_cast<off_t>(segment.mSize)) != 0)
+            {
+                close(segment.mFd);
+                segment.mFd = -1;
+            }
+            return CHIP_ERROR_WRITE_FAILED;
+        }
+
+        for (; aWritten < end; aWritten += GetRecordSize(&aRecords[aWritten]))
+        {
+            AddToIndex(segment, segment.mSize, Encoding::LittleEndian::Get64(&aRecords[aWritten]));
+            segment.mSize += GetRecordSize(&aRecords[aWritten]);
+        }
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+bool FileEventStore::GetLastEventNumber(EventNumber & aEventNumber)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    aEventNumber = mLastEventNumber;
+    return mHasEvents;
+}
+
+CHIP_ERROR FileEventStore::ForEachWrittenEventSince(EventNumber aEventMin, TLV::Utilities::IterateHandler aHandler,
+                                                    void * apContext)
+{
+    // Events are evicted from the buffers of each priority separately, so they were not written in order.
+    std::vector<RecordLocation> records;
+    for (const auto & segment : mSegments)
+    {
+        for (size_t i = 0; i < segment.mBlockCount; i++)
+        {
+            if (segment.mIndex[i].mMaxEventNumber >= aEventMin)
+            {
+                ReturnErrorOnFailure(FindRecordsInBlock(segment, i, aEventMin, records));
+            }
+        }
+    }
+    std::stable_sort(records.begin(), records.end(),
+                     [](const RecordLocation & a, const RecordLocation & b) { return a.mEventNumber < b.mEventNumber; });
+
+    for (const auto & record : records)
+    {
+        VerifyOrReturnError(ReadAll(record.mSegment->mFd, mRecord, kRecordHeaderSize + record.mLength, record.mOffset),
+                            CHIP_ERROR_READ_FAILED);
+        ReturnErrorOnFailure(HandleRecord(mRecord, aEventMin, aHandler, apContext));
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR FileEventStore::ForEachBufferedEventSince(EventNumber aEventMin, TLV::Utilities::IterateHandler aHandler,
+                                                     void * apContext)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    std::vector<size_t> offsets;
+    for (size_t offset = 0; offset < mBuffered.size(); offset += GetRecordSize(&mBuffered[offset]))
+    {
+        if (Encoding::LittleEndian::Get64(&mBuffered[offset]) >= aEventMin)
+        {
+            offsets.push_back(offset);
+        }
+    }
+    std::stable_sort(offsets.begin(), offsets.end(), [this](size_t a, size_t b) {
+        return Encoding::LittleEndian::Get64(&mBuffered[a]) < Encoding::LittleEndian::Get64(&mBuffered[b]);
+    });
+
+    for (size_t offset : offsets)
+    {
+        ReturnErrorOnFailure(HandleRecord(&mBuffered[offset], aEventMin, aHandler, apContext));
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR FileEventStore::OpenSegment(size_t aSegment, bool aTruncate)
+{
+    char path[kMaxPathLength + 2];
+    GetSegmentPath(aSegment, path);
+
+    Segment & segment = mSegments[aSegment];
+    segment.mFd       = open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC | (aTruncate ? O_TRUNC : 0), S_IRUSR | S_IWUSR);
+    if (segment.mFd == -1)
+    {
+        ChipLogError(EventLogging, "failed to open (%s), %s (%d)", path, strerror(errno), errno);
+        return CHIP_ERROR_OPEN_FAILED;
+    }
+
+    return LoadSegment(segment);
+}
+
+CHIP_ERROR FileEventStore::LoadSegment(Segment & aSegment)
+{
+    struct stat info;
+
+    VerifyOrReturnError(fstat(aSegment.mFd, &info) == 0, CHIP_ERROR_OPEN_FAILED);
+    const size_t fileSize = static_cast<size_t>(info.st_size);
+
+    aSegment.mBlockCount = 0;
+
+    if (fileSize < sizeof(kMagic))
+    {
+        // New, or cut short before the magic was written.
+        VerifyOrReturnError(ftruncate(aSegment.mFd, 0) == 0 && WriteAll(aSegment.mFd, kMagic, sizeof(kMagic)),
+                            CHIP_ERROR_WRITE_FAILED);
+        aSegment.mSize = sizeof(kMagic);
+        return CHIP_NO_ERROR;
+    }
+
+    uint8_t magic[sizeof(kMagic)];
+    VerifyOrReturnError(ReadAll(aSegment.mFd, magic, sizeof(magic), 0), CHIP_ERROR_READ_FAILED);
+    VerifyOrReturnError(memcmp(magic, kMagic, sizeof(kMagic)) == 0, CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+
+    // Only the record headers are read, the events themselves are parsed when they are fetched.
+    size_t offset = sizeof(kMagic);
+    while (offset + kRecordHeaderSize <= fileSize)
+    {
+        uint8_t header[kRecordHeaderSize];
+        VerifyOrReturnError(ReadAll(aSegment.mFd, header, sizeof(header), offset), CHIP_ERROR_READ_FAILED);
+
+        const EventNumber eventNumber = Encoding::LittleEndian::Get64(header);
+        const size_t length           = Encoding::LittleEndian::Get32(header + sizeof(uint64_t));
+        if (length == 0 || length > kMaxEventSize || offset + kRecordHeaderSize + length > fileSize)
+        {
+            break;
+        }
+
+        AddToIndex(aSegment, offset, eventNumber);
+        offset += kRecordHeaderSize + length;
+
+        if (!mHasEvents || eventNumber > mLastEventNumber)
+        {
+            mLastEventNumber = eventNumber;
+            mHasEvents       = true;
+        }
+    }
+
+    if (offset < fileSize)
+    {
+        ChipLogError(EventLogging, "dropping %u bytes after the last complete event record",
+                     static_cast<unsigned>(fileSize - offset));
+        VerifyOrReturnError(ftruncate(aSegment.mFd, static_cast<off_t>(offset)) == 0, CHIP_ERROR_WRITE_FAILED);
+    }
+    aSegment.mSize = offset;
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR FileEventStore::StartNewSegment()
+{
+    char olderPath[kMaxPathLength + 2];
+    char newerPath[kMaxPathLength + 2];
+    GetSegmentPath(0, olderPath);
+    GetSegmentPath(1, newerPath);
+
+    // The current segment replaces the previous one, dropping its events.
+    if (rename(newerPath, olderPath) != 0)
+    {
+        ChipLogError(EventLogging, "failed to rename (%s), %s (%d)", newerPath, strerror(errno), errno);
+        return CHIP_ERROR_WRITE_FAILED;
+    }
+
+    close(mSegments[0].mFd);
+    mSegments[0]     = mSegments[1];
+    mSegments[1].mFd = -1;
+
+    return OpenSegment(1, true /* aTruncate */);
+}
+
+void FileEventStore::AddToIndex(Segment & aSegment, size_t aOffset, EventNumber aEventNumber)
+{
+    if (aSegment.mBlockCount == 0 ||
+        (aOffset >= aSegment.mIndex[aSegment.mBlockCount - 1].mOffset + mBlockSize && aSegment.mBlockCount < kIndexSize))
+    {
+        aSegment.mIndex[aSegment.mBlockCount++] = { aOffset, aEventNumber };
+    }
+    else if (aEventNumber > aSegment.mIndex[aSegment.mBlockCount - 1].mMaxEventNumber)
+    {
+        aSegment.mIndex[aSegment.mBlockCount - 1].mMaxEventNumber = aEventNumber;
+    }
+}
+
+CHIP_ERROR FileEventStore::FindRecordsInBlock(const Segment & aSegment, size_t aBlock, EventNumber aEventMin,
+                                              std::vector<RecordLocation> & aRecords)
+{
+    const size_t end = (aBlock + 1 < aSegment.mBlockCount) ? aSegment.mIndex[aBlock + 1].mOffset : aSegment.mSize;
+    size_t offset    = aSegment.mIndex[aBlock].mOffset;
+
+    while (offset < end)
+    {
+        uint8_t header[kRecordHeaderSize];
+        VerifyOrReturnError(ReadAll(aSegment.mFd, header, sizeof(header), offset), CHIP_ERROR_READ_FAILED);
+
+        const EventNumber eventNumber = Encoding::LittleEndian::Get64(header);
+        const size_t length           = Encoding::LittleEndian::Get32(header + sizeof(uint64_t));
+        VerifyOrReturnError(length <= kMaxEventSize, CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+
+        if (eventNumber >= aEventMin)
+        {
+            aRecords.push_back({ eventNumber, &aSegment, offset, length });
+        }
+        offset += kRecordHeaderSize + length;
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+void FileEventStore::GetSegmentPath(size_t aSegment, char (&aPath)[kMaxPathLength + 2]) const
+{
+    snprintf(aPath, sizeof(aPath), "%s.%u", mPath, static_cast<unsigned>(aSegment));
+}
+
+size_t FileEventStore::GetRecordSize(const uint8_t * apRecord)
+{
+    return kRecordHeaderSize + Encoding::LittleEndian::Get32(apRecord + sizeof(uint64_t));
+}
+
+CHIP_ERROR FileEventStore::HandleRecord(const uint8_t * apRecord, EventNumber aEventMin, TLV::Utilities::IterateHandler aHandler,
+                                        void * apContext)
+{
+    const EventNumber eventNumber = Encoding::LittleEndian::Get64(apRecord);
+    VerifyOrReturnError(eventNumber >= aEventMin, CHIP_NO_ERROR);
+
+    TLV::TLVReader reader;
+    reader.Init(apRecord + kRecordHeaderSize, GetRecordSize(apRecord) - kRecordHeaderSize);
+    if (reader.Next() != CHIP_NO_ERROR)
+    {
+        ChipLogError(EventLogging, "skipping unreadable stored event 0x" ChipLogFormatX64, ChipLogValueX64(eventNumber));
+        return CHIP_NO_ERROR;
+    }
+    return aHandler(reader, 0, apContext);
+}
+
+} // namespace app
+} // namespace chip
@@ -0,0 +1,148 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *         This file defines a PersistentEventStore for Linux and macOS, which keeps
+ *         the events evicted from the event buffers in files.
+ *
+ *         Events are appended to a segment file. Once it reaches its maximum
+ *         size, it replaces the previous segment and a new one is started, so
+ *         the oldest events are dropped and at most two segments are kept.
+ *         For each segment, an in-memory index records the highest event
+ *         number in each of a fixed number of blocks of the file, so reads
+ *         only go through the blocks holding recent enough events. The index
+ *         is rebuilt from the record headers at startup, where a record cut
+ *         short by a crash ends the segment.
+ *
+ *         Events come in the order they are evicted, which is not the order
+ *         of their numbers when several priority buffers evict to the store,
+ *         so they are sorted by number when they are read.
+ *
+ *         Appended events are kept in memory until the next Flush, which
+ *         EventManagement calls after each LogEvent without holding its lock,
+ *         so that logging does not wait on the files. A Flush that fails keeps
+ *         the events it could not write for the next one. They are written
+ *         without fsync, so the events logged just before a power loss may
+ *         be lost, but not those before a crash of the process.
+ *
+ */
+
+#pragma once
+
+#include <app/PersistentEventStore.h>
+#include <lib/core/CHIPConfig.h>
+
+#include <mutex>
+#include <vector>
+
+namespace chip {
+namespace app {
+
+class FileEventStore : public PersistentEventStore
+{
+public:
+    static constexpr size_t kDefaultMaxSegmentSize = 1024 * 1024;
+
+    FileEventStore() = default;
+    ~FileEventStore() override;
+
+    FileEventStore(const FileEventStore &) = delete;
+    FileEventStore & operator=(const FileEventStore &) = delete;
+
+    /**
+     * Open the segments at `<apPath>.0` (older) and `<apPath>.1`, creating
+     * them if needed, and index their records.
+     *
+     * aMaxSegmentSize has to fit at least one event of the largest size,
+     * CHIP_CONFIG_EVENT_LOGGING_FILE_STORE_MAX_EVENT_SIZE.
+     */
+    CHIP_ERROR Init(const char * apPath, size_t aMaxSegmentSize = kDefaultMaxSegmentSize);
+
+    /**
+     * Close the segments, dropping the events not flushed yet. Called by the
+     * destructor.
+     */
+    void Shutdown();
+
+    // PersistentEventStore implementation.
+    CHIP_ERROR AppendEvent(EventNumber aEventNumber, const TLV::TLVReader & aEvent) override;
+    CHIP_ERROR Flush() override;
+    bool GetLastEventNumber(EventNumber & aEventNumber) override;
+    CHIP_ERROR ForEachWrittenEventSince(EventNumber aEventMin, TLV::Utilities::IterateHandler aHandler,
+                                        void * apContext) override;
+    CHIP_ERROR ForEachBufferedEventSince(EventNumber aEventMin, TLV::Utilities::IterateHandler aHandler,
+                                         void * apContext) override;
+
+private:
+    static constexpr size_t kSegmentCount     = 2;
+    static constexpr size_t kRecordHeaderSize = sizeof(uint32_t) + sizeof(uint64_t);
+    static constexpr size_t kMaxEventSize     = CHIP_CONFIG_EVENT_LOGGING_FILE_STORE_MAX_EVENT_SIZE;
+    static constexpr size_t kIndexSize        = CHIP_CONFIG_EVENT_LOGGING_FILE_STORE_INDEX_SIZE;
+    static constexpr size_t kMaxPathLength    = 256;
+
+    struct Block
+    {
+        size_t mOffset;              // Of the first record in the block
+        EventNumber mMaxEventNumber; // Of all the records in the block
+    };
+
+    struct Segment
+    {
+        int mFd      = -1;
+        size_t mSize = 0; // End of the last valid record
+        Block mIndex[kIndexSize];
+        size_t mBlockCount = 0;
+    };
+
+    struct RecordLocation
+    {
+        EventNumber mEventNumber;
+        const Segment * mSegment;
+        size_t mOffset;
+        size_t mLength; // Of the event
+    };
+
+    CHIP_ERROR OpenSegment(size_t aSegment, bool aTruncate);
+    CHIP_ERROR LoadSegment(Segment & aSegment);
+    CHIP_ERROR StartNewSegment();
+    CHIP_ERROR WriteRecords(const std::vector<uint8_t> & aRecords, size_t & aWritten);
+    void AddToIndex(Segment & aSegment, size_t aOffset, EventNumber aEventNumber);
+    CHIP_ERROR FindRecordsInBlock(const Segment & aSegment, size_t aBlock, EventNumber aEventMin,
+                                  std::vector<RecordLocation> & aRecords);
+    void GetSegmentPath(size_t aSegment, char (&aPath)[kMaxPathLength + 2]) const;
+    static size_t GetRecordSize(const uint8_t * apRecord);
+    static CHIP_ERROR HandleRecord(const uint8_t * apRecord, EventNumber aEventMin, TLV::Utilities::IterateHandler aHandler,
+                                   void * apContext);
+
+    char mPath[kMaxPathLength] = {};
+    size_t mMaxSegmentSize     = 0;
+    size_t mBlockSize          = 0;
+    Segment mSegments[kSegmentCount]; // Oldest first
+
+    // Shared between AppendEvent, called by EventManagement with its lock held, and Flush
+    std::mutex mLock;
+    std::vector<uint8_t> mBuffered; // Records not written yet, at most mMaxSegmentSize bytes of them
+    bool mHasEvents              = false;
+    EventNumber mLastEventNumber = 0;
+
+    // One record, for reading
+    uint8_t mRecord[kRecordHeaderSize + kMaxEventSize];
+};
+
+} // namespace app
+} // namespace chip
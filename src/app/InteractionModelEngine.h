@@ -129,7 +129,6 @@ public:
 
     void ReleaseClusterInfoList(ClusterInfo *& aClusterInfo);
     CHIP_ERROR PushFront(ClusterInfo *& aClusterInfoLisst, ClusterInfo & aClusterInfo);
-    bool IsOverlappedAttributePath(ClusterInfo & aAttributePath);
 
     CHIP_ERROR RegisterCommandHandler(CommandHandlerInterface * handler);
     CHIP_ERROR UnregisterCommandHandler(CommandHandlerInterface * handler);
@@ -327,17 +326,22 @@ Protocols::InteractionModel::Status ServerClusterCommandExists(const ConcreteCom
  *  @param[in]    aSubjectDescriptor    The subject descriptor for the read.
  *  @param[in]    aPath                 The concrete path of the data being read.
  *  @param[in]    aAttributeReports      The TLV Builder for Cluter attribute builder.
+ *  @param[in]    aAccessCheckBatch     The access checks of the read so far, reused for paths of the same cluster.
  *
  *  @retval  CHIP_NO_ERROR on success
  */
 CHIP_ERROR ReadSingleClusterData(const Access::SubjectDescriptor & aSubjectDescriptor, bool aIsFabricFiltered,
                                  const ConcreteReadAttributePath & aPath, AttributeReportIBs::Builder & aAttributeReports,
-                                 AttributeValueEncoder::AttributeEncodeState * apEncoderState);
+                                 AttributeValueEncoder::AttributeEncodeState * apEncoderState,
+                                 Access::AccessControl::CheckBatch & aAccessCheckBatch);
 
 /**
  * TODO: Document.
+ *
+ * Access is checked through aAccessCheckBatch, which is shared by all the writes of one request.
  */
 CHIP_ERROR WriteSingleClusterData(const Access::SubjectDescriptor & aSubjectDescriptor, ClusterInfo & aClusterInfo,
-                                  TLV::TLVReader & aReader, WriteHandler * apWriteHandler);
+                                  TLV::TLVReader & aReader, WriteHandler * apWriteHandler,
+                                  Access::AccessControl::CheckBatch & aAccessCheckBatch);
 } // namespace app
 } // namespace chip
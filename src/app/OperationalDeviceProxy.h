@@ -49,11 +49,12 @@ namespace chip {
 
 struct DeviceProxyInitParams
 {
-    SessionManager * sessionManager          = nullptr;
-    Messaging::ExchangeManager * exchangeMgr = nullptr;
-    SessionIDAllocator * idAllocator         = nullptr;
-    FabricTable * fabricTable                = nullptr;
-    CASEClientPoolDelegate * clientPool      = nullptr;
+    SessionManager * sessionManager           = nullptr;
+    Messaging::ExchangeManager * exchangeMgr  = nullptr;
+    SessionIDAllocator * idAllocator          = nullptr;
+    FabricTable * fabricTable                 = nullptr;
+    CASEClientPoolDelegate * clientPool       = nullptr;
+    CASESessionCache * sessionResumptionCache = nullptr;
 
     Optional<ReliableMessageProtocolConfig> mrpLocalConfig = Optional<ReliableMessageProtocolConfig>::Missing();
 
@@ -0,0 +1,89 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/core/CHIPTLV.h>
+#include <lib/core/CHIPTLVUtilities.hpp>
+#include <lib/core/DataModelTypes.h>
+
+namespace chip {
+namespace app {
+
+/**
+ * Interface for keeping events past their eviction from the in-memory event
+ * buffers of EventManagement, see EventManagement::SetPersistentEventStore.
+ *
+ * Eviction happens while EventManagement holds its lock, so AppendEvent and
+ * ForEachBufferedEventSince must not block on storage: events are buffered by
+ * AppendEvent and only written by Flush. Flush and ForEachWrittenEventSince
+ * are called without that lock, but never concurrently with each other, and
+ * no Flush happens between the ForEachWrittenEventSince and the
+ * ForEachBufferedEventSince of a single fetch. Implementations still have to
+ * protect what AppendEvent shares with Flush.
+ */
+class PersistentEventStore
+{
+public:
+    virtual ~PersistentEventStore() = default;
+    PersistentEventStore()          = default;
+
+    /**
+     * Buffer an event that is being dropped from the last event buffer that
+     * could hold it, until the next Flush.
+     *
+     * @param [in] aEventNumber the number of the event.
+     * @param [in] aEvent a reader positioned on the event, an anonymous
+     *             structure as written to the event buffers.
+     */
+    virtual CHIP_ERROR AppendEvent(EventNumber aEventNumber, const TLV::TLVReader & aEvent) = 0;
+
+    /**
+     * Write the events buffered by AppendEvent to storage. The events that
+     * could not be written stay buffered.
+     */
+    virtual CHIP_ERROR Flush() = 0;
+
+    /**
+     * Get the highest number of the events appended to the store so far,
+     * including those that have since been dropped from it.
+     *
+     * @return false if no event was ever stored.
+     */
+    virtual bool GetLastEventNumber(EventNumber & aEventNumber) = 0;
+
+    /**
+     * Call aHandler for each written event numbered aEventMin or above, in
+     * increasing event number order whatever order they were appended in, with
+     * a reader positioned on the event and a depth of 0.  Stops at the first
+     * error returned by aHandler, and returns it, so that a fetch cut short can
+     * resume past the last event handled.
+     */
+    virtual CHIP_ERROR ForEachWrittenEventSince(EventNumber aEventMin, TLV::Utilities::IterateHandler aHandler,
+                                                void * apContext) = 0;
+
+    /**
+     * Same as ForEachWrittenEventSince, for the events not written yet. As
+     * EventManagement flushes the store after each LogEvent, these are only
+     * the events evicted since, such as while the written ones were read.
+     */
+    virtual CHIP_ERROR ForEachBufferedEventSince(EventNumber aEventMin, TLV::Utilities::IterateHandler aHandler,
+                                                 void * apContext) = 0;
+};
+
+} // namespace app
+} // namespace chip
@@ -96,6 +96,7 @@ ReadHandler::~ReadHandler()
         InteractionModelEngine::GetInstance()->GetReportingEngine().OnReportConfirm();
     }
 
+    InteractionModelEngine::GetInstance()->GetReportingEngine().UnregisterReadHandlerInterest(*this);
     InteractionModelEngine::GetInstance()->ReleaseClusterInfoList(mpAttributeClusterInfoList);
     InteractionModelEngine::GetInstance()->ReleaseClusterInfoList(mpEventClusterInfoList);
 }
@@ -414,7 +415,8 @@ CHIP_ERROR ReadHandler::ProcessAttributePathList(AttributePathIBs::Parser & aAtt
     if (CHIP_END_OF_TLV == err)
     {
         mAttributePathExpandIterator = AttributePathExpandIterator(mpAttributeClusterInfoList);
-        err                          = CHIP_NO_ERROR;
+
+        err = InteractionModelEngine::GetInstance()->GetReportingEngine().RegisterReadHandlerInterest(*this);
     }
 
 exit:
@@ -51,6 +51,7 @@ namespace app {
 //
 namespace reporting {
 class Engine;
+class TestReportingEngine;
 }
 
 /**
@@ -177,6 +178,7 @@ public:
 
 private:
     friend class TestReadInteraction;
+    friend class chip::app::reporting::TestReportingEngine;
 
     //
     // The engine needs to be able to Abort/Close a ReadHandler instance upon completion of work for a given read/subscribe
@@ -189,6 +189,7 @@ CHIP_ERROR WriteHandler::ProcessAttributeDataIBs(TLV::TLVReader & aAttributeData
 
     ReturnErrorCodeIf(mpExchangeCtx == nullptr, CHIP_ERROR_INTERNAL);
     const Access::SubjectDescriptor subjectDescriptor = mpExchangeCtx->GetSessionHandle()->GetSubjectDescriptor();
+    Access::AccessControl::CheckBatch accessCheckBatch(Access::GetAccessControl());
 
     while (CHIP_NO_ERROR == (err = aAttributeDataIBsReader.Next()))
     {
@@ -241,7 +242,7 @@ CHIP_ERROR WriteHandler::ProcessAttributeDataIBs(TLV::TLVReader & aAttributeData
             MatterPreAttributeWriteCallback(concretePath);
             TLV::TLVWriter backup;
             mWriteResponseBuilder.Checkpoint(backup);
-            err = WriteSingleClusterData(subjectDescriptor, clusterInfo, dataReader, this);
+            err = WriteSingleClusterData(subjectDescriptor, clusterInfo, dataReader, this, accessCheckBatch);
             if (err != CHIP_NO_ERROR)
             {
                 mWriteResponseBuilder.Rollback(backup);
@@ -267,6 +268,7 @@ CHIP_ERROR WriteHandler::ProcessGroupAttributeDataIBs(TLV::TLVReader & aAttribut
 
     ReturnErrorCodeIf(mpExchangeCtx == nullptr, CHIP_ERROR_INTERNAL);
     const Access::SubjectDescriptor subjectDescriptor = mpExchangeCtx->GetSessionHandle()->AsGroupSession()->GetSubjectDescriptor();
+    Access::AccessControl::CheckBatch accessCheckBatch(Access::GetAccessControl());
 
     while (CHIP_NO_ERROR == (err = aAttributeDataIBsReader.Next()))
     {
@@ -353,7 +355,7 @@ CHIP_ERROR WriteHandler::ProcessGroupAttributeDataIBs(TLV::TLVReader & aAttribut
             const ConcreteAttributePath concretePath(clusterInfo.mEndpointId, clusterInfo.mClusterId, clusterInfo.mAttributeId);
 
             MatterPreAttributeWriteCallback(concretePath);
-            err = WriteSingleClusterData(subjectDescriptor, clusterInfo, tmpDataReader, this);
+            err = WriteSingleClusterData(subjectDescriptor, clusterInfo, tmpDataReader, this, accessCheckBatch);
 
             if (err != CHIP_NO_ERROR)
             {
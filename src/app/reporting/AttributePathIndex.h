@@ -0,0 +1,199 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Defines an index of attribute paths bucketed by (endpoint, cluster), used by the reporting engine to find the
+ *      dirty paths and the subscriber interests that may intersect a given path without scanning all of them.
+ */
+
+#pragma once
+
+#include <app/ClusterInfo.h>
+#include <lib/core/CHIPConfig.h>
+#include <lib/core/CHIPError.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/Iterators.h>
+#include <lib/support/Pool.h>
+
+namespace chip {
+namespace app {
+namespace reporting {
+
+/**
+ * AttributePathIndex keeps non-owning references to ClusterInfo attribute paths, each tagged with an owner, and hashes them
+ * by (endpoint, cluster). Paths with a wildcard endpoint or cluster are kept on a separate list that every lookup visits.
+ *
+ * A lookup for a concrete (endpoint, cluster) only visits the matching bucket plus the wildcard list; a lookup with a wildcard
+ * endpoint or cluster visits every entry. Lookups only return candidates: entries in the same bucket may belong to a different
+ * (endpoint, cluster), so callers are expected to apply their exact path predicate on what is visited.
+ *
+ * The referenced ClusterInfo objects must outlive their entries in the index. The endpoint and cluster of an indexed path must
+ * not change while it is in the index.
+ */
+template <typename OwnerType, size_t kEntryCount, size_t kBucketCount = CHIP_IM_SERVER_PATH_INDEX_BUCKETS>
+class AttributePathIndex
+{
+public:
+    static_assert(kBucketCount > 0, "AttributePathIndex needs at least one bucket");
+
+    AttributePathIndex() { ClearBuckets(); }
+    ~AttributePathIndex() { ReleaseAll(); }
+
+    /**
+     * Add aPath to the index, tagged with apOwner.
+     *
+     * @retval #CHIP_ERROR_NO_MEMORY if the index is full.
+     */
+    CHIP_ERROR Insert(ClusterInfo & aPath, OwnerType * apOwner)
+    {
+        Entry * entry = mEntryPool.CreateObject();
+        VerifyOrReturnError(entry != nullptr, CHIP_ERROR_NO_MEMORY);
+
+        entry->mpPath  = &aPath;
+        entry->mpOwner = apOwner;
+
+        Entry *& head = ChainFor(aPath.mEndpointId, aPath.mClusterId);
+        entry->mpNext = head;
+        head          = entry;
+        return CHIP_NO_ERROR;
+    }
+
+    /**
+     * Remove every entry tagged with apOwner.
+     */
+    void Remove(OwnerType * apOwner)
+    {
+        RemoveFromChain(mWildcardChain, apOwner);
+        for (auto & bucket : mBuckets)
+        {
+            RemoveFromChain(bucket, apOwner);
+        }
+    }
+
+    void ReleaseAll()
+    {
+        mEntryPool.ReleaseAll();
+        ClearBuckets();
+    }
+
+    /**
+     * Visit every indexed path that may intersect the given endpoint and cluster, either of which may be a wildcard
+     * (kInvalidEndpointId / kInvalidClusterId).
+     *
+     * @param aFunction A functor of type `Loop (*)(ClusterInfo &, OwnerType *)`, return Loop::Break to stop the iteration.
+     * @return Loop::Break if aFunction returned Loop::Break, Loop::Finish otherwise.
+     */
+    template <typename Function>
+    Loop ForEachCandidate(EndpointId aEndpointId, ClusterId aClusterId, Function && aFunction) const
+    {
+        if (VisitChain(mWildcardChain, aFunction) == Loop::Break)
+        {
+            return Loop::Break;
+        }
+
+        if (aEndpointId != kInvalidEndpointId && aClusterId != kInvalidClusterId)
+        {
+            return VisitChain(mBuckets[BucketIndex(aEndpointId, aClusterId)], aFunction);
+        }
+
+        for (const auto & bucket : mBuckets)
+        {
+            if (VisitChain(bucket, aFunction) == Loop::Break)
+            {
+                return Loop::Break;
+            }
+        }
+        return Loop::Finish;
+    }
+
+    size_t Allocated() const { return mEntryPool.Allocated(); }
+
+private:
+    struct Entry
+    {
+        ClusterInfo * mpPath = nullptr;
+        OwnerType * mpOwner  = nullptr;
+        Entry * mpNext       = nullptr;
+    };
+
+    static size_t BucketIndex(EndpointId aEndpointId, ClusterId aClusterId)
+    {
+        // Cluster ids are MEIs, so fold the vendor prefix into the low bits before mixing in the endpoint.
+        uint32_t hash = (aClusterId ^ (aClusterId >> 16)) * 0x9E3779B1u;
+        hash ^= static_cast<uint32_t>(aEndpointId) * 0x85EBCA6Bu;
+        return (hash ^ (hash >> 16)) % kBucketCount;
+    }
+
+    Entry *& ChainFor(EndpointId aEndpointId, ClusterId aClusterId)
+    {
+        if (aEndpointId == kInvalidEndpointId || aClusterId == kInvalidClusterId)
+        {
+            return mWildcardChain;
+        }
+        return mBuckets[BucketIndex(aEndpointId, aClusterId)];
+    }
+
+    void RemoveFromChain(Entry *& aHead, OwnerType * apOwner)
+    {
+        Entry ** link = &aHead;
+        while (*link != nullptr)
+        {
+            Entry * entry = *link;
+            if (entry->mpOwner == apOwner)
+            {
+                *link = entry->mpNext;
+                mEntryPool.ReleaseObject(entry);
+            }
+            else
+            {
+                link = &entry->mpNext;
+            }
+        }
+    }
+
+    template <typename Function>
+    static Loop VisitChain(const Entry * apHead, Function & aFunction)
+    {
+        for (const Entry * entry = apHead; entry != nullptr; entry = entry->mpNext)
+        {
+            if (aFunction(*entry->mpPath, entry->mpOwner) == Loop::Break)
+            {
+                return Loop::Break;
+            }
+        }
+        return Loop::Finish;
+    }
+
+    void ClearBuckets()
+    {
+        mWildcardChain = nullptr;
+        for (auto & bucket : mBuckets)
+        {
+            bucket = nullptr;
+        }
+    }
+
+    Entry * mWildcardChain = nullptr;
+    Entry * mBuckets[kBucketCount];
+    ObjectPool<Entry, kEntryCount> mEntryPool;
+};
+
+} // namespace reporting
+} // namespace app
+} // namespace chip
@@ -44,18 +44,21 @@ void Engine::Shutdown()
 {
     mNumReportsInFlight = 0;
     mCurReadHandlerIdx  = 0;
-    mGlobalDirtySet.ReleaseAll();
+    ReleaseDirtySet();
+    mReadHandlerInterestIndex.ReleaseAll();
 }
 
 CHIP_ERROR
 Engine::RetrieveClusterData(const SubjectDescriptor & aSubjectDescriptor, bool aIsFabricFiltered,
                             AttributeReportIBs::Builder & aAttributeReportIBs, const ConcreteReadAttributePath & aPath,
-                            AttributeValueEncoder::AttributeEncodeState * aEncoderState)
+                            AttributeValueEncoder::AttributeEncodeState * aEncoderState,
+                            Access::AccessControl::CheckBatch & aAccessCheckBatch)
 {
     ChipLogDetail(DataManagement, "<RE:Run> Cluster %" PRIx32 ", Attribute %" PRIx32 " is dirty", aPath.mClusterId,
                   aPath.mAttributeId);
     MatterPreAttributeReadCallback(aPath);
-    ReturnErrorOnFailure(ReadSingleClusterData(aSubjectDescriptor, aIsFabricFiltered, aPath, aAttributeReportIBs, aEncoderState));
+    ReturnErrorOnFailure(
+        ReadSingleClusterData(aSubjectDescriptor, aIsFabricFiltered, aPath, aAttributeReportIBs, aEncoderState, aAccessCheckBatch));
     MatterPostAttributeReadCallback(aPath);
     return CHIP_NO_ERROR;
 }
@@ -87,29 +90,18 @@ CHIP_ERROR Engine::BuildSingleReportDataAttributeReportIBs(ReportDataMessage::Bu
         // TODO: Figure out how AttributePathExpandIterator should handle read
         // vs write paths.
         ConcreteAttributePath readPath;
+        // Consecutive paths of a wildcard expansion mostly share a cluster, so check access once per cluster.
+        Access::AccessControl::CheckBatch accessCheckBatch(Access::GetAccessControl());
 
         // For each path included in the interested path of the read handler...
         for (; apReadHandler->GetAttributePathExpandIterator()->Get(readPath);
              apReadHandler->GetAttributePathExpandIterator()->Next())
         {
-            if (!apReadHandler->IsPriming())
+            // TODO: Optimize this implementation by making the iterator only emit intersected paths.
+            if (!apReadHandler->IsPriming() && !IsDirtyPath(readPath))
             {
-                bool concretePathDirty = false;
-                // TODO: Optimize this implementation by making the iterator only emit intersected paths.
-                mGlobalDirtySet.ForEachActiveObject([&](auto * dirtyPath) {
-                    if (dirtyPath->IsAttributePathSupersetOf(readPath))
-                    {
-                        concretePathDirty = true;
-                        return Loop::Break;
-                    }
-                    return Loop::Continue;
-                });
-
-                if (!concretePathDirty)
-                {
-                    // This attribute is not dirty, we just skip this one.
-                    continue;
-                }
+                // This attribute is not dirty, we just skip this one.
+                continue;
             }
 
             // If we are processing a read request, or the initial report of a subscription, just regard all paths as dirty paths.
@@ -119,7 +111,7 @@ CHIP_ERROR Engine::BuildSingleReportDataAttributeReportIBs(ReportDataMessage::Bu
             // Load the saved state from previous encoding session for chunking of one single attribute (list chunking).
             AttributeValueEncoder::AttributeEncodeState encodeState = apReadHandler->GetAttributeEncodeState();
             err = RetrieveClusterData(apReadHandler->GetSubjectDescriptor(), apReadHandler->IsFabricFiltered(), attributeReportIBs,
-                                      pathForRetrieval, &encodeState);
+                                      pathForRetrieval, &encodeState, accessCheckBatch);
             if (err != CHIP_NO_ERROR)
             {
                 ChipLogError(DataManagement,
@@ -536,59 +528,114 @@ void Engine::Run()
 
     if (allReadClean)
     {
-        mGlobalDirtySet.ReleaseAll();
+        ReleaseDirtySet();
     }
 }
 
 bool Engine::MergeOverlappedAttributePath(ClusterInfo & aAttributePath)
 {
-    return Loop::Break == mGlobalDirtySet.ForEachActiveObject([&](auto * path) {
-        if (path->IsAttributePathSupersetOf(aAttributePath))
+    auto mergeWith = [&aAttributePath](ClusterInfo & path, void *) {
+        if (path.IsAttributePathSupersetOf(aAttributePath))
         {
             return Loop::Break;
         }
-        if (aAttributePath.IsAttributePathSupersetOf(*path))
+        if (aAttributePath.IsAttributePathSupersetOf(path))
         {
-            path->mListIndex   = aAttributePath.mListIndex;
-            path->mAttributeId = aAttributePath.mAttributeId;
+            path.mListIndex   = aAttributePath.mListIndex;
+            path.mAttributeId = aAttributePath.mAttributeId;
             return Loop::Break;
         }
         return Loop::Continue;
-    });
+    };
+
+    // Any dirty path that is a superset or a subset of aAttributePath shares its endpoint and cluster (or has wildcards there),
+    // so the candidates from the index cover every path the full scan would have merged with.
+    return Loop::Break == mGlobalDirtySetIndex.ForEachCandidate(aAttributePath.mEndpointId, aAttributePath.mClusterId, mergeWith);
 }
 
-CHIP_ERROR Engine::SetDirty(ClusterInfo & aClusterInfo)
+CHIP_ERROR Engine::InsertPathIntoDirtySet(const ClusterInfo & aAttributePath)
+{
+    ClusterInfo * clusterInfo = mGlobalDirtySet.CreateObject();
+    if (clusterInfo == nullptr)
+    {
+        ChipLogError(DataManagement, "mGlobalDirtySet pool full, cannot handle more entries!");
+        return CHIP_ERROR_NO_MEMORY;
+    }
+    *clusterInfo        = aAttributePath;
+    clusterInfo->mpNext = nullptr;
+
+    CHIP_ERROR err = mGlobalDirtySetIndex.Insert(*clusterInfo, nullptr);
+    if (err != CHIP_NO_ERROR)
+    {
+        mGlobalDirtySet.ReleaseObject(clusterInfo);
+    }
+    return err;
+}
+
+bool Engine::IsDirtyPath(const ConcreteAttributePath & aPath) const
+{
+    auto isSuperset = [&aPath](ClusterInfo & path, void *) {
+        return path.IsAttributePathSupersetOf(aPath) ? Loop::Break : Loop::Continue;
+    };
+    return Loop::Break == mGlobalDirtySetIndex.ForEachCandidate(aPath.mEndpointId, aPath.mClusterId, isSuperset);
+}
+
+bool Engine::IntersectsDirtySet(const ClusterInfo & aAttributePath) const
 {
-    InteractionModelEngine::GetInstance()->mReadHandlers.ForEachActiveObject([&aClusterInfo](ReadHandler * handler) {
-        // We call SetDirty for both read interactions and subscribe interactions, since we may sent inconsistent attribute data
-        // between two chunks. SetDirty will be ignored automatically by read handlers which is waiting for response to last message
-        // chunk for read interactions.
-        if (handler->IsGeneratingReports() || handler->IsAwaitingReportResponse())
+    auto intersects = [&aAttributePath](ClusterInfo & path, void *) {
+        if (path.IsAttributePathSupersetOf(aAttributePath) || aAttributePath.IsAttributePathSupersetOf(path))
         {
-            for (auto clusterInfo = handler->GetAttributeClusterInfolist(); clusterInfo != nullptr;
-                 clusterInfo      = clusterInfo->mpNext)
+            return Loop::Break;
+        }
+        return Loop::Continue;
+    };
+    return Loop::Break == mGlobalDirtySetIndex.ForEachCandidate(aAttributePath.mEndpointId, aAttributePath.mClusterId, intersects);
+}
+
+void Engine::ReleaseDirtySet()
+{
+    mGlobalDirtySetIndex.ReleaseAll();
+    mGlobalDirtySet.ReleaseAll();
+}
+
+CHIP_ERROR Engine::RegisterReadHandlerInterest(ReadHandler & aReadHandler)
+{
+    // On failure, the entries inserted so far are dropped by UnregisterReadHandlerInterest when the handler goes away.
+    for (auto clusterInfo = aReadHandler.GetAttributeClusterInfolist(); clusterInfo != nullptr; clusterInfo = clusterInfo->mpNext)
+    {
+        ReturnErrorOnFailure(mReadHandlerInterestIndex.Insert(*clusterInfo, &aReadHandler));
+    }
+    return CHIP_NO_ERROR;
+}
+
+void Engine::UnregisterReadHandlerInterest(ReadHandler & aReadHandler)
+{
+    mReadHandlerInterestIndex.Remove(&aReadHandler);
+}
+
+CHIP_ERROR Engine::SetDirty(ClusterInfo & aClusterInfo)
+{
+    bool intersectsSubscription = false;
+
+    // Only the handlers with a path in the same (endpoint, cluster) bucket, or with a wildcard endpoint or cluster, are visited.
+    mReadHandlerInterestIndex.ForEachCandidate(
+        aClusterInfo.mEndpointId, aClusterInfo.mClusterId, [&](ClusterInfo & path, ReadHandler * handler) {
+            // We call SetDirty for both read interactions and subscribe interactions, since we may sent inconsistent attribute
+            // data between two chunks. SetDirty will be ignored automatically by read handlers which is waiting for response to
+            // last message chunk for read interactions.
+            if ((handler->IsGeneratingReports() || handler->IsAwaitingReportResponse()) &&
+                (aClusterInfo.IsAttributePathSupersetOf(path) || path.IsAttributePathSupersetOf(aClusterInfo)))
             {
-                if (aClusterInfo.IsAttributePathSupersetOf(*clusterInfo) || clusterInfo->IsAttributePathSupersetOf(aClusterInfo))
-                {
-                    handler->SetDirty();
-                    break;
-                }
+                handler->SetDirty();
+                intersectsSubscription = intersectsSubscription || handler->IsType(ReadHandler::InteractionType::Subscribe);
             }
-        }
 
-        return Loop::Continue;
-    });
+            return Loop::Continue;
+        });
 
-    if (!MergeOverlappedAttributePath(aClusterInfo) &&
-        InteractionModelEngine::GetInstance()->IsOverlappedAttributePath(aClusterInfo))
+    if (!MergeOverlappedAttributePath(aClusterInfo) && intersectsSubscription)
     {
-        ClusterInfo * clusterInfo = mGlobalDirtySet.CreateObject();
-        if (clusterInfo == nullptr)
-        {
-            ChipLogError(DataManagement, "mGlobalDirtySet pool full, cannot handle more entries!");
-            return CHIP_ERROR_NO_MEMORY;
-        }
-        *clusterInfo = aClusterInfo;
+        ReturnErrorOnFailure(InsertPathIntoDirtySet(aClusterInfo));
     }
 
     return CHIP_NO_ERROR;
@@ -609,16 +656,9 @@ void Engine::UpdateReadHandlerDirty(ReadHandler & aReadHandler)
     bool intersected = false;
     for (auto clusterInfo = aReadHandler.GetAttributeClusterInfolist(); clusterInfo != nullptr; clusterInfo = clusterInfo->mpNext)
     {
-        mGlobalDirtySet.ForEachActiveObject([&](auto * path) {
-            if (path->IsAttributePathSupersetOf(*clusterInfo) || clusterInfo->IsAttributePathSupersetOf(*path))
-            {
-                intersected = true;
-                return Loop::Break;
-            }
-            return Loop::Continue;
-        });
-        if (intersected)
+        if (IntersectsDirtySet(*clusterInfo))
         {
+            intersected = true;
             break;
         }
     }
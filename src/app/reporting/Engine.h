@@ -27,6 +27,7 @@
 #include <access/AccessControl.h>
 #include <app/MessageDef/ReportDataMessage.h>
 #include <app/ReadHandler.h>
+#include <app/reporting/AttributePathIndex.h>
 #include <app/util/basic-types.h>
 #include <lib/core/CHIPCore.h>
 #include <lib/support/CodeUtils.h>
@@ -89,6 +90,14 @@ public:
      */
     CHIP_ERROR SetDirty(ClusterInfo & aClusterInfo);
 
+    /**
+     * Index the attribute paths of a read handler so that SetDirty only visits the handlers whose paths may intersect the
+     * changed path. Must be called once the attribute path list of the handler is final, and balanced with
+     * UnregisterReadHandlerInterest before that list is released.
+     */
+    CHIP_ERROR RegisterReadHandlerInterest(ReadHandler & aReadHandler);
+    void UnregisterReadHandlerInterest(ReadHandler & aReadHandler);
+
     /**
      * @brief
      *  Schedule the event delivery
@@ -116,7 +125,8 @@ private:
     CHIP_ERROR RetrieveClusterData(const Access::SubjectDescriptor & aSubjectDescriptor, bool aIsFabricFiltered,
                                    AttributeReportIBs::Builder & aAttributeReportIBs,
                                    const ConcreteReadAttributePath & aClusterInfo,
-                                   AttributeValueEncoder::AttributeEncodeState * apEncoderState);
+                                   AttributeValueEncoder::AttributeEncodeState * apEncoderState,
+                                   Access::AccessControl::CheckBatch & aAccessCheckBatch);
 
     /**
      * Check all active subscription, if the subscription has no paths that intersect with global dirty set,
@@ -148,6 +158,23 @@ private:
      */
     bool MergeOverlappedAttributePath(ClusterInfo & aAttributePath);
 
+    /**
+     * Add a copy of aAttributePath to mGlobalDirtySet and index it.
+     */
+    CHIP_ERROR InsertPathIntoDirtySet(const ClusterInfo & aAttributePath);
+
+    /**
+     * Return whether one of the paths in mGlobalDirtySet is a superset of aPath.
+     */
+    bool IsDirtyPath(const ConcreteAttributePath & aPath) const;
+
+    /**
+     * Return whether one of the paths in mGlobalDirtySet intersects aAttributePath.
+     */
+    bool IntersectsDirtySet(const ClusterInfo & aAttributePath) const;
+
+    void ReleaseDirtySet();
+
     /**
      * Boolean to indicate if ScheduleRun is pending. This flag is used to prevent calling ScheduleRun multiple times
      * within the same execution context to avoid applying too much pressure on platforms that use small, fixed size event queues.
@@ -173,6 +200,18 @@ private:
      */
     ObjectPool<ClusterInfo, CHIP_IM_SERVER_MAX_NUM_DIRTY_SET> mGlobalDirtySet;
 
+    /**
+     *  (endpoint, cluster) index over the paths in mGlobalDirtySet.
+     *
+     */
+    AttributePathIndex<void, CHIP_IM_SERVER_MAX_NUM_DIRTY_SET> mGlobalDirtySetIndex;
+
+    /**
+     *  (endpoint, cluster) index over the attribute paths of the registered read handlers.
+     *
+     */
+    AttributePathIndex<ReadHandler, CHIP_IM_SERVER_MAX_NUM_PATH_GROUPS> mReadHandlerInterestIndex;
+
 #if CONFIG_IM_BUILD_FOR_UNIT_TEST
     uint32_t mReservedSize = 0;
 #endif
@@ -84,11 +84,12 @@ static ::chip::app::CircularEventBuffer sLoggingBuffer[CHIP_NUM_EVENT_LOGGING_BU
 Server::Server() :
     mCASESessionManager(CASESessionManagerConfig {
         .sessionInitParams =  {
-            .sessionManager = &mSessions,
-            .exchangeMgr    = &mExchangeMgr,
-            .idAllocator    = &mSessionIDAllocator,
-            .fabricTable    = &mFabrics,
-            .clientPool     = &mCASEClientPool,
+            .sessionManager         = &mSessions,
+            .exchangeMgr            = &mExchangeMgr,
+            .idAllocator            = &mSessionIDAllocator,
+            .fabricTable            = &mFabrics,
+            .clientPool             = &mCASEClientPool,
+            .sessionResumptionCache = &mCASESessionCache,
         },
         .dnsCache          = nullptr,
         .devicePool        = &mDevicePool,
@@ -118,6 +119,13 @@ CHIP_ERROR Server::Init(AppDelegate * delegate, uint16_t secureServicePort, uint
     err = mFabrics.Init(&mDeviceStorage);
     SuccessOrExit(err);
 
+    // Sessions established before a restart can be resumed rather than set up again.
+    err = mCASESessionCache.Init(&mDeviceStorage);
+    SuccessOrExit(err);
+    mSessionResumptionFabricDelegate.Init(&mCASESessionCache);
+    err = mFabrics.AddFabricDelegate(&mSessionResumptionFabricDelegate);
+    SuccessOrExit(err);
+
     // Group data provider must be initialized after mDeviceStorage
     err = mGroupsProvider.Init();
     SuccessOrExit(err);
@@ -225,6 +233,7 @@ CHIP_ERROR Server::Init(AppDelegate * delegate, uint16_t secureServicePort, uint
     app::DnssdServer::Instance().StartServer();
 #endif
 
+    mCASEServer.SetSessionResumptionCache(&mCASESessionCache);
     err = mCASEServer.ListenForSessionEstablishment(&mExchangeMgr, &mTransports, chip::DeviceLayer::ConnectivityMgr().GetBleLayer(),
                                                     &mSessions, &mFabrics, &mSessionIDAllocator);
     SuccessOrExit(err);
@@ -280,6 +289,10 @@ exit:
 void Server::Shutdown()
 {
     chip::Dnssd::ServiceAdvertiser::Instance().Shutdown();
+#if CHIP_CONFIG_ENABLE_SERVER_IM_EVENT
+    // Stores the buffered events if a persistent event store is set
+    chip::app::EventManagement::DestroyEventManagement();
+#endif // CHIP_CONFIG_ENABLE_SERVER_IM_EVENT
     chip::app::InteractionModelEngine::GetInstance()->Shutdown();
     mExchangeMgr.Shutdown();
     mSessions.Shutdown();
@@ -32,6 +32,7 @@
 #include <messaging/ExchangeMgr.h>
 #include <platform/KeyValueStoreManager.h>
 #include <protocols/secure_channel/CASEServer.h>
+#include <protocols/secure_channel/CASESessionCache.h>
 #include <protocols/secure_channel/MessageCounterManager.h>
 #include <protocols/secure_channel/PASESession.h>
 #include <protocols/secure_channel/RendezvousParameters.h>
@@ -166,13 +167,33 @@ private:
         ServerTransportMgr * mTransports;
     };
 
+    class SessionResumptionFabricDelegate final : public FabricTableDelegate
+    {
+    public:
+        void Init(CASESessionCache * cache) { mCache = cache; }
+
+        // A removed fabric's sessions must not be resumed by whichever fabric gets its index next.
+        void OnFabricDeletedFromStorage(CompressedFabricId compressedId, FabricIndex fabricIndex) override
+        {
+            mCache->RemoveFabric(fabricIndex);
+        }
+        void OnFabricRetrievedFromStorage(FabricInfo * fabricInfo) override {}
+        void OnFabricPersistedToStorage(FabricInfo * fabricInfo) override {}
+
+    private:
+        CASESessionCache * mCache = nullptr;
+    };
+
 #if CONFIG_NETWORK_LAYER_BLE
     Ble::BleLayer * mBleLayer = nullptr;
 #endif
 
     ServerTransportMgr mTransports;
     SessionManager mSessions;
+    // Before mCASEServer, which keeps a pointer to it, so that it is destroyed after the server.
+    CASESessionCache mCASESessionCache;
     CASEServer mCASEServer;
+    SessionResumptionFabricDelegate mSessionResumptionFabricDelegate;
 
     CASESessionManager mCASESessionManager;
     CASEClientPool<CHIP_CONFIG_DEVICE_MAX_ACTIVE_CASE_CLIENTS> mCASEClientPool;
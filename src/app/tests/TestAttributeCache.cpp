@@ -24,12 +24,17 @@
 #include "system/TLVPacketBufferBackingStore.h"
 #include <app-common/zap-generated/cluster-objects.h>
 #include <app/AttributeCache.h>
+#include <app/StatusResponse.h>
 #include <app/data-model/DecodableList.h>
 #include <app/data-model/Decode.h>
 #include <app/tests/AppTestContext.h>
 #include <lib/support/UnitTestRegistration.h>
+#include <map>
 #include <nlunit-test.h>
+#include <set>
 #include <string.h>
+#include <system/SystemClock.h>
+#include <tuple>
 #include <vector>
 
 using TestContext = chip::Test::AppContext;
@@ -529,10 +534,272 @@ void TestCache(nlTestSuite * apSuite, void * apContext)
                              AttributeInstruction(AttributeInstruction::kAttributeB, 0, AttributeInstruction::kData) });
 }
 
+class CountingCallback : public AttributeCache::Callback
+{
+public:
+    void OnDone() override {}
+    void OnAttributeChanged(AttributeCache * cache, const ConcreteAttributePath & path) override { mAttributesChanged++; }
+    void OnClusterChanged(AttributeCache * cache, EndpointId endpointId, ClusterId clusterId) override { mClustersChanged++; }
+    void OnEndpointAdded(AttributeCache * cache, EndpointId endpointId) override { mEndpointsAdded++; }
+
+    size_t mAttributesChanged = 0;
+    size_t mClustersChanged   = 0;
+    size_t mEndpointsAdded    = 0;
+};
+
+void GenerateLargeReport(ReadClient::Callback & callback, EndpointId endpointCount, ClusterId clusterCount,
+                         AttributeId attributeCount, uint16_t valueOffset)
+{
+    callback.OnReportBegin();
+
+    for (EndpointId endpoint = 0; endpoint < endpointCount; endpoint++)
+    {
+        for (ClusterId cluster = 0; cluster < clusterCount; cluster++)
+        {
+            for (AttributeId attribute = 0; attribute < attributeCount; attribute++)
+            {
+                uint8_t buf[8];
+                TLV::TLVWriter writer;
+                TLV::TLVReader reader;
+                ConcreteDataAttributePath path(endpoint, cluster, attribute);
+
+                writer.Init(buf);
+                NL_TEST_ASSERT(gSuite,
+                               writer.Put(TLV::AnonymousTag(), static_cast<uint16_t>(attribute + valueOffset)) == CHIP_NO_ERROR);
+                NL_TEST_ASSERT(gSuite, writer.Finalize() == CHIP_NO_ERROR);
+
+                reader.Init(buf, writer.GetLengthWritten());
+                NL_TEST_ASSERT(gSuite, reader.Next() == CHIP_NO_ERROR);
+                callback.OnAttributeData(path, kUndefinedDataVersion, &reader, StatusIB());
+            }
+        }
+    }
+
+    callback.OnReportEnd();
+}
+
+/*
+ * The storage AttributeCache used before its sorted index and TLV arena: nested maps down to a right-sized PacketBuffer per
+ * attribute, with the same change tracking. Only kept as the baseline of BenchmarkPrimeLargeCache.
+ */
+class MapAttributeCache : public ReadClient::Callback
+{
+public:
+    MapAttributeCache() : mBufferedReader(*this) {}
+
+    ReadClient::Callback & GetBufferedCallback() { return mBufferedReader; }
+
+    CHIP_ERROR Get(const ConcreteAttributePath & path, TLV::TLVReader & reader)
+    {
+        auto endpointIter = mCache.find(path.mEndpointId);
+        VerifyOrReturnError(endpointIter != mCache.end(), CHIP_ERROR_KEY_NOT_FOUND);
+        auto clusterIter = endpointIter->second.find(path.mClusterId);
+        VerifyOrReturnError(clusterIter != endpointIter->second.end(), CHIP_ERROR_KEY_NOT_FOUND);
+        auto attributeIter = clusterIter->second.find(path.mAttributeId);
+        VerifyOrReturnError(attributeIter != clusterIter->second.end(), CHIP_ERROR_KEY_NOT_FOUND);
+
+        System::PacketBufferTLVReader bufReader;
+        bufReader.Init(attributeIter->second.Retain());
+        ReturnErrorOnFailure(bufReader.Next());
+
+        reader.Init(bufReader);
+        return CHIP_NO_ERROR;
+    }
+
+    template <typename IteratorFunc>
+    CHIP_ERROR ForEachCluster(EndpointId endpointId, IteratorFunc func)
+    {
+        auto endpointIter = mCache.find(endpointId);
+        VerifyOrReturnError(endpointIter != mCache.end(), CHIP_ERROR_KEY_NOT_FOUND);
+        for (auto & clusterIter : endpointIter->second)
+        {
+            ReturnErrorOnFailure(func(clusterIter.first));
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    template <typename IteratorFunc>
+    CHIP_ERROR ForEachAttribute(EndpointId endpointId, ClusterId clusterId, IteratorFunc func)
+    {
+        auto endpointIter = mCache.find(endpointId);
+        VerifyOrReturnError(endpointIter != mCache.end(), CHIP_ERROR_KEY_NOT_FOUND);
+        auto clusterIter = endpointIter->second.find(clusterId);
+        VerifyOrReturnError(clusterIter != endpointIter->second.end(), CHIP_ERROR_KEY_NOT_FOUND);
+        for (auto & attributeIter : clusterIter->second)
+        {
+            ReturnErrorOnFailure(func(ConcreteAttributePath(endpointId, clusterId, attributeIter.first)));
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    size_t mAttributesChanged = 0;
+    size_t mClustersChanged   = 0;
+    size_t mEndpointsAdded    = 0;
+
+private:
+    void OnDone() override {}
+
+    void OnReportBegin() override
+    {
+        mChangedAttributeSet.clear();
+        mAddedEndpoints.clear();
+    }
+
+    void OnReportEnd() override
+    {
+        std::set<std::tuple<EndpointId, ClusterId>> changedClusters;
+        for (auto & path : mChangedAttributeSet)
+        {
+            mAttributesChanged++;
+            changedClusters.insert(std::make_tuple(path.mEndpointId, path.mClusterId));
+        }
+        mClustersChanged += changedClusters.size();
+        mEndpointsAdded += mAddedEndpoints.size();
+    }
+
+    void OnAttributeData(const ConcreteDataAttributePath & aPath, DataVersion aVersion, TLV::TLVReader * apData,
+                         const StatusIB & aStatus) override
+    {
+        VerifyOrReturn(apData != nullptr);
+
+        System::PacketBufferHandle handle = System::PacketBufferHandle::New(chip::app::kMaxSecureSduLengthBytes);
+        System::PacketBufferTLVWriter writer;
+
+        writer.Init(std::move(handle), false);
+        VerifyOrReturn(writer.CopyElement(TLV::AnonymousTag(), *apData) == CHIP_NO_ERROR);
+        VerifyOrReturn(writer.Finalize(&handle) == CHIP_NO_ERROR);
+        handle.RightSize();
+
+        if (mCache.find(aPath.mEndpointId) == mCache.end())
+        {
+            mAddedEndpoints.push_back(aPath.mEndpointId);
+        }
+
+        mCache[aPath.mEndpointId][aPath.mClusterId][aPath.mAttributeId] = std::move(handle);
+        mChangedAttributeSet.insert(aPath);
+    }
+
+    std::map<EndpointId, std::map<ClusterId, std::map<AttributeId, System::PacketBufferHandle>>> mCache;
+    std::set<ConcreteAttributePath> mChangedAttributeSet;
+    std::vector<EndpointId> mAddedEndpoints;
+    BufferedReadCallback mBufferedReader;
+};
+
+/*
+ * Reads back every attribute of a cache filled by GenerateLargeReport, checking its value. Returns the number of attributes read.
+ */
+template <typename CacheT>
+size_t ReadBackLargeCache(nlTestSuite * apSuite, CacheT & cache, EndpointId endpointCount, uint16_t valueOffset)
+{
+    size_t visited = 0;
+    for (EndpointId endpoint = 0; endpoint < endpointCount; endpoint++)
+    {
+        CHIP_ERROR err = cache.ForEachCluster(endpoint, [&](ClusterId cluster) {
+            return cache.ForEachAttribute(endpoint, cluster, [&](const ConcreteAttributePath & path) {
+                TLV::TLVReader reader;
+                uint16_t value = 0;
+
+                ReturnErrorOnFailure(cache.Get(path, reader));
+                ReturnErrorOnFailure(reader.Get(value));
+                VerifyOrReturnError(value == path.mAttributeId + valueOffset, CHIP_ERROR_INTERNAL);
+                visited++;
+                return CHIP_NO_ERROR;
+            });
+        });
+        NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
+    }
+    return visited;
+}
+
+/*
+ * Primes a cache with the state of a large node (as a controller does when it first subscribes to everything on a bridge),
+ * then replaces every value, and reports the time taken and the memory used along the way. The same reports and reads go
+ * through the map-based storage the cache had before, for comparison.
+ */
+void BenchmarkPrimeLargeCache(nlTestSuite * apSuite, void * apContext)
+{
+    constexpr EndpointId kEndpointCount   = 64;
+    constexpr ClusterId kClusterCount     = 16;
+    constexpr AttributeId kAttributeCount = 16;
+    constexpr size_t kTotalAttributes     = kEndpointCount * kClusterCount * kAttributeCount;
+
+    CountingCallback callback;
+    AttributeCache cache(callback);
+
+    System::Clock::Microseconds64 start = System::SystemClock().GetMonotonicMicroseconds64();
+    GenerateLargeReport(cache.GetBufferedCallback(), kEndpointCount, kClusterCount, kAttributeCount, 0);
+    System::Clock::Microseconds64 primeTime = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+    AttributeCache::MemoryUsage usage = cache.GetMemoryUsage();
+    ChipLogProgress(DataManagement, "Primed %u attributes in %" PRIu64 "us: index %u bytes, data %u/%u bytes",
+                    static_cast<unsigned>(usage.mAttributeCount), primeTime.count(), static_cast<unsigned>(usage.mIndexBytes),
+                    static_cast<unsigned>(usage.mDataBytes), static_cast<unsigned>(usage.mArenaBytes));
+
+    NL_TEST_ASSERT(apSuite, usage.mAttributeCount == kTotalAttributes);
+    NL_TEST_ASSERT(apSuite, usage.mDataBytes <= usage.mArenaBytes);
+    NL_TEST_ASSERT(apSuite, callback.mAttributesChanged == kTotalAttributes);
+    NL_TEST_ASSERT(apSuite, callback.mClustersChanged == kEndpointCount * kClusterCount);
+    NL_TEST_ASSERT(apSuite, callback.mEndpointsAdded == kEndpointCount);
+
+    start = System::SystemClock().GetMonotonicMicroseconds64();
+    GenerateLargeReport(cache.GetBufferedCallback(), kEndpointCount, kClusterCount, kAttributeCount, 100);
+    System::Clock::Microseconds64 updateTime = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+    //
+    // The second report doesn't add anything, so the stale values from the first one should get compacted away
+    // when the next report begins.
+    //
+    NL_TEST_ASSERT(apSuite, cache.GetMemoryUsage().mArenaBytes > usage.mArenaBytes);
+    cache.GetBufferedCallback().OnReportBegin();
+    cache.GetBufferedCallback().OnReportEnd();
+
+    usage = cache.GetMemoryUsage();
+    ChipLogProgress(DataManagement, "Updated %u attributes in %" PRIu64 "us: index %u bytes, data %u/%u bytes",
+                    static_cast<unsigned>(usage.mAttributeCount), updateTime.count(), static_cast<unsigned>(usage.mIndexBytes),
+                    static_cast<unsigned>(usage.mDataBytes), static_cast<unsigned>(usage.mArenaBytes));
+
+    NL_TEST_ASSERT(apSuite, usage.mAttributeCount == kTotalAttributes);
+    NL_TEST_ASSERT(apSuite, usage.mArenaBytes < 2 * usage.mDataBytes);
+
+    start                                  = System::SystemClock().GetMonotonicMicroseconds64();
+    size_t visited                         = ReadBackLargeCache(apSuite, cache, kEndpointCount, 100);
+    System::Clock::Microseconds64 readTime = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+    ChipLogProgress(DataManagement, "Read back %u attributes in %" PRIu64 "us", static_cast<unsigned>(visited), readTime.count());
+    NL_TEST_ASSERT(apSuite, visited == kTotalAttributes);
+
+    // The same reports and reads through the map-based storage AttributeCache had before.
+    MapAttributeCache baseline;
+
+    start = System::SystemClock().GetMonotonicMicroseconds64();
+    GenerateLargeReport(baseline.GetBufferedCallback(), kEndpointCount, kClusterCount, kAttributeCount, 0);
+    System::Clock::Microseconds64 baselinePrimeTime = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+    start = System::SystemClock().GetMonotonicMicroseconds64();
+    GenerateLargeReport(baseline.GetBufferedCallback(), kEndpointCount, kClusterCount, kAttributeCount, 100);
+    System::Clock::Microseconds64 baselineUpdateTime = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+    start                                          = System::SystemClock().GetMonotonicMicroseconds64();
+    size_t baselineVisited                         = ReadBackLargeCache(apSuite, baseline, kEndpointCount, 100);
+    System::Clock::Microseconds64 baselineReadTime = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+    NL_TEST_ASSERT(apSuite, baselineVisited == kTotalAttributes);
+    NL_TEST_ASSERT(apSuite, baseline.mAttributesChanged == 2 * kTotalAttributes);
+    NL_TEST_ASSERT(apSuite, baseline.mEndpointsAdded == kEndpointCount);
+
+    ChipLogProgress(DataManagement, "%u attributes, sorted vector vs nested maps: prime %" PRIu64 "us vs %" PRIu64 "us",
+                    static_cast<unsigned>(kTotalAttributes), primeTime.count(), baselinePrimeTime.count());
+    ChipLogProgress(DataManagement, "%u attributes, sorted vector vs nested maps: update %" PRIu64 "us vs %" PRIu64 "us",
+                    static_cast<unsigned>(kTotalAttributes), updateTime.count(), baselineUpdateTime.count());
+    ChipLogProgress(DataManagement, "%u attributes, sorted vector vs nested maps: read back %" PRIu64 "us vs %" PRIu64 "us",
+                    static_cast<unsigned>(kTotalAttributes), readTime.count(), baselineReadTime.count());
+}
+
 // clang-format off
 const nlTest sTests[] =
 {
     NL_TEST_DEF("TestCache", TestCache),
+    NL_TEST_DEF("BenchmarkPrimeLargeCache", BenchmarkPrimeLargeCache),
     NL_TEST_SENTINEL()
 };
 
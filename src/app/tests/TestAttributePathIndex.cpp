@@ -0,0 +1,145 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests for the reporting engine AttributePathIndex.
+ *
+ */
+
+#include <app/ClusterInfo.h>
+#include <app/reporting/AttributePathIndex.h>
+#include <lib/support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+namespace chip {
+namespace app {
+namespace TestAttributePathIndex {
+
+using reporting::AttributePathIndex;
+
+struct Subscriber
+{
+    uint32_t mHits = 0;
+};
+
+ClusterInfo MakePath(EndpointId aEndpointId, ClusterId aClusterId, AttributeId aAttributeId = kInvalidAttributeId)
+{
+    ClusterInfo path;
+    path.mEndpointId  = aEndpointId;
+    path.mClusterId   = aClusterId;
+    path.mAttributeId = aAttributeId;
+    return path;
+}
+
+bool Intersects(const ClusterInfo & aLhs, const ClusterInfo & aRhs)
+{
+    return aLhs.IsAttributePathSupersetOf(aRhs) || aRhs.IsAttributePathSupersetOf(aLhs);
+}
+
+template <typename Index>
+uint32_t CountIntersecting(Index & aIndex, const ClusterInfo & aPath, Subscriber * apExpectedOwner = nullptr)
+{
+    uint32_t count = 0;
+    aIndex.ForEachCandidate(aPath.mEndpointId, aPath.mClusterId, [&](ClusterInfo & path, Subscriber * owner) {
+        if (Intersects(path, aPath) && (apExpectedOwner == nullptr || owner == apExpectedOwner))
+        {
+            count++;
+        }
+        return Loop::Continue;
+    });
+    return count;
+}
+
+void TestConcreteAndWildcardLookup(nlTestSuite * apSuite, void * apContext)
+{
+    AttributePathIndex<Subscriber, 8, 4> index;
+    Subscriber concrete, wildcardEndpoint, wildcardCluster;
+
+    ClusterInfo onOff             = MakePath(1, 6);
+    ClusterInfo levelControl      = MakePath(1, 8, 0);
+    ClusterInfo anyEndpointOnOff  = MakePath(kInvalidEndpointId, 6);
+    ClusterInfo anyClusterOnEp2   = MakePath(2, kInvalidClusterId);
+    ClusterInfo otherEndpointSame = MakePath(3, 6, 0);
+
+    NL_TEST_ASSERT(apSuite, index.Insert(onOff, &concrete) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Insert(levelControl, &concrete) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Insert(otherEndpointSame, &concrete) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Insert(anyEndpointOnOff, &wildcardEndpoint) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Insert(anyClusterOnEp2, &wildcardCluster) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Allocated() == 5);
+
+    NL_TEST_ASSERT(apSuite, CountIntersecting(index, MakePath(1, 6, 0)) == 2);
+    NL_TEST_ASSERT(apSuite, CountIntersecting(index, MakePath(1, 6, 0), &concrete) == 1);
+    NL_TEST_ASSERT(apSuite, CountIntersecting(index, MakePath(1, 6, 0), &wildcardEndpoint) == 1);
+    NL_TEST_ASSERT(apSuite, CountIntersecting(index, MakePath(1, 8, 0)) == 1);
+    NL_TEST_ASSERT(apSuite, CountIntersecting(index, MakePath(1, 8, 1)) == 0);
+    NL_TEST_ASSERT(apSuite, CountIntersecting(index, MakePath(2, 0x300, 7), &wildcardCluster) == 1);
+    NL_TEST_ASSERT(apSuite, CountIntersecting(index, MakePath(4, 0x300, 7)) == 0);
+
+    // Wildcard lookups have to visit everything.
+    NL_TEST_ASSERT(apSuite, CountIntersecting(index, MakePath(kInvalidEndpointId, 6)) == 3);
+    NL_TEST_ASSERT(apSuite, CountIntersecting(index, MakePath(1, kInvalidClusterId)) == 2);
+
+    index.Remove(&concrete);
+    NL_TEST_ASSERT(apSuite, index.Allocated() == 2);
+    NL_TEST_ASSERT(apSuite, CountIntersecting(index, MakePath(1, 6, 0), &concrete) == 0);
+    NL_TEST_ASSERT(apSuite, CountIntersecting(index, MakePath(1, 6, 0)) == 1);
+
+    index.ReleaseAll();
+    NL_TEST_ASSERT(apSuite, index.Allocated() == 0);
+    NL_TEST_ASSERT(apSuite, CountIntersecting(index, MakePath(kInvalidEndpointId, kInvalidClusterId)) == 0);
+}
+
+void TestInsertWhenFull(nlTestSuite * apSuite, void * apContext)
+{
+    AttributePathIndex<Subscriber, 2, 4> index;
+    Subscriber subscriber;
+    ClusterInfo paths[3] = { MakePath(1, 6), MakePath(2, 6), MakePath(3, 6) };
+
+    NL_TEST_ASSERT(apSuite, index.Insert(paths[0], &subscriber) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Insert(paths[1], &subscriber) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Insert(paths[2], &subscriber) == CHIP_ERROR_NO_MEMORY);
+
+    index.Remove(&subscriber);
+    NL_TEST_ASSERT(apSuite, index.Insert(paths[2], &subscriber) == CHIP_NO_ERROR);
+    index.ReleaseAll();
+}
+
+} // namespace TestAttributePathIndex
+} // namespace app
+} // namespace chip
+
+namespace {
+const nlTest sTests[] = {
+    NL_TEST_DEF("TestConcreteAndWildcardLookup", chip::app::TestAttributePathIndex::TestConcreteAndWildcardLookup),
+    NL_TEST_DEF("TestInsertWhenFull", chip::app::TestAttributePathIndex::TestInsertWhenFull),
+    NL_TEST_SENTINEL()
+};
+}
+
+int TestAttributePathIndex()
+{
+    nlTestSuite theSuite = { "AttributePathIndex", &sTests[0], nullptr, nullptr };
+    nlTestRunner(&theSuite, nullptr);
+
+    return (nlTestRunnerStats(&theSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestAttributePathIndex)
@@ -0,0 +1,196 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests for the CASEClient.
+ */
+
+#include <app/CASEClient.h>
+#include <credentials/FabricTable.h>
+#include <credentials/tests/CHIPCert_test_vectors.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/TestPersistentStorageDelegate.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <messaging/tests/MessagingContext.h>
+#include <protocols/secure_channel/CASEServer.h>
+#include <protocols/secure_channel/CASESessionCache.h>
+#include <protocols/secure_channel/SessionIDAllocator.h>
+
+#include <nlunit-test.h>
+
+using namespace chip;
+using namespace chip::Credentials;
+using namespace chip::TestCerts;
+
+using TestContext = chip::Test::LoopbackMessagingContext<>;
+
+namespace {
+
+TestContext sContext;
+
+auto & gLoopback = sContext.GetLoopback();
+
+chip::TestPersistentStorageDelegate gInitiatorStorage;
+chip::TestPersistentStorageDelegate gResponderStorage;
+FabricTable gInitiatorFabrics;
+FabricIndex gInitiatorFabricIndex;
+FabricTable gResponderFabrics;
+
+constexpr NodeId kResponderNodeId = 0xDEDEDEDE00010001;
+
+CHIP_ERROR AddNode01_01Fabric(FabricTable & fabrics, FabricIndex * fabricIndex)
+{
+    FabricInfo fabric;
+
+    P256SerializedKeypair opKeysSerialized;
+    memcpy((uint8_t *) (opKeysSerialized), sTestCert_Node01_01_PublicKey, sTestCert_Node01_01_PublicKey_Len);
+    memcpy((uint8_t *) (opKeysSerialized) + sTestCert_Node01_01_PublicKey_Len, sTestCert_Node01_01_PrivateKey,
+           sTestCert_Node01_01_PrivateKey_Len);
+    ReturnErrorOnFailure(opKeysSerialized.SetLength(sTestCert_Node01_01_PublicKey_Len + sTestCert_Node01_01_PrivateKey_Len));
+
+    P256Keypair opKey;
+    ReturnErrorOnFailure(opKey.Deserialize(opKeysSerialized));
+    ReturnErrorOnFailure(fabric.SetOperationalKeypair(&opKey));
+
+    ReturnErrorOnFailure(fabric.SetRootCert(ByteSpan(sTestCert_Root01_Chip, sTestCert_Root01_Chip_Len)));
+    ReturnErrorOnFailure(fabric.SetICACert(ByteSpan(sTestCert_ICA01_Chip, sTestCert_ICA01_Chip_Len)));
+    ReturnErrorOnFailure(fabric.SetNOCCert(ByteSpan(sTestCert_Node01_01_Chip, sTestCert_Node01_01_Chip_Len)));
+
+    return fabrics.AddNewFabric(fabric, fabricIndex);
+}
+
+struct ConnectionResult
+{
+    int mConnected = 0;
+    int mFailed    = 0;
+
+    static void OnConnected(void * context, CASEClient * client) { static_cast<ConnectionResult *>(context)->mConnected++; }
+    static void OnFailure(void * context, CASEClient * client, CHIP_ERROR error)
+    {
+        static_cast<ConnectionResult *>(context)->mFailed++;
+    }
+};
+
+/**
+ * Connects to a CASE server twice through CASEClient. The client records the first session in its
+ * resumption cache, so the second handshake resumes it.
+ */
+void TestCASEClient_SessionResumption(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    CASESessionCache initiatorCache;
+    CASESessionCache responderCache;
+    SessionIDAllocator initiatorIdAllocator;
+    SessionIDAllocator responderIdAllocator;
+    CASEServer server;
+
+    server.SetSessionResumptionCache(&responderCache);
+    NL_TEST_ASSERT(inSuite,
+                   server.ListenForSessionEstablishment(&ctx.GetExchangeManager(), &ctx.GetTransportMgr(), nullptr,
+                                                        &ctx.GetSecureSessionManager(), &gResponderFabrics,
+                                                        &responderIdAllocator) == CHIP_NO_ERROR);
+
+    FabricInfo * fabric = gInitiatorFabrics.FindFabricWithIndex(gInitiatorFabricIndex);
+    NL_TEST_ASSERT(inSuite, fabric != nullptr);
+
+    CASEClientInitParams params;
+    params.sessionManager         = &ctx.GetSecureSessionManager();
+    params.exchangeMgr            = &ctx.GetExchangeManager();
+    params.idAllocator            = &initiatorIdAllocator;
+    params.fabricInfo             = fabric;
+    params.sessionResumptionCache = &initiatorCache;
+
+    const Transport::PeerAddress peerAddress = Transport::PeerAddress::UDP(TestContext::GetAddress(), CHIP_PORT);
+
+    for (bool resume : { false, true })
+    {
+        CASEClient client(params);
+        ConnectionResult result;
+
+        gLoopback.mSentMessageCount = 0;
+
+        NL_TEST_ASSERT(inSuite,
+                       client.EstablishSession(fabric->GetPeerIdForNode(kResponderNodeId), peerAddress, GetLocalMRPConfig(),
+                                               ConnectionResult::OnConnected, ConnectionResult::OnFailure,
+                                               &result) == CHIP_NO_ERROR);
+        ctx.DrainAndServiceIO();
+
+        NL_TEST_ASSERT(inSuite, result.mConnected == 1);
+        NL_TEST_ASSERT(inSuite, result.mFailed == 0);
+        // Resuming leaves out Sigma2 and Sigma3, and the ack of Sigma2 that Sigma3 carries.
+        NL_TEST_ASSERT(inSuite, gLoopback.mSentMessageCount == (resume ? 4u : 5u));
+
+        // The client recorded the session it established, under the peer it connected to.
+        CASESessionCachable record;
+        NL_TEST_ASSERT(inSuite, initiatorCache.Count() == 1);
+        NL_TEST_ASSERT(inSuite, initiatorCache.Get(gInitiatorFabricIndex, kResponderNodeId, record) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, responderCache.Get(ResumptionID(record.mResumptionId), record) == CHIP_NO_ERROR);
+
+        SessionHolder session;
+        NL_TEST_ASSERT(inSuite, client.DeriveSecureSessionHandle(session) == CHIP_NO_ERROR);
+    }
+
+    NL_TEST_ASSERT(inSuite, server.GetActiveHandshakeCount() == 0);
+}
+
+// clang-format off
+const nlTest sTests[] =
+{
+    NL_TEST_DEF("TestCASEClient_SessionResumption", TestCASEClient_SessionResumption),
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+int Initialize(void * aContext)
+{
+    VerifyOrReturnError(TestContext::InitializeAsync(aContext) == SUCCESS, FAILURE);
+
+    TestContext & ctx = *static_cast<TestContext *>(aContext);
+    ctx.SetBobNodeId(kPlaceholderNodeId);
+    ctx.SetAliceNodeId(kPlaceholderNodeId);
+    ctx.SetBobKeyId(0);
+    ctx.SetAliceKeyId(0);
+    ctx.SetFabricIndex(kUndefinedFabricIndex);
+
+    FabricIndex responderFabricIndex;
+    VerifyOrReturnError(gInitiatorFabrics.Init(&gInitiatorStorage) == CHIP_NO_ERROR, FAILURE);
+    VerifyOrReturnError(gResponderFabrics.Init(&gResponderStorage) == CHIP_NO_ERROR, FAILURE);
+    VerifyOrReturnError(AddNode01_01Fabric(gInitiatorFabrics, &gInitiatorFabricIndex) == CHIP_NO_ERROR, FAILURE);
+    VerifyOrReturnError(AddNode01_01Fabric(gResponderFabrics, &responderFabricIndex) == CHIP_NO_ERROR, FAILURE);
+
+    return SUCCESS;
+}
+
+int Finalize(void * aContext)
+{
+    gInitiatorFabrics.Reset();
+    gResponderFabrics.Reset();
+    return TestContext::Finalize(aContext);
+}
+
+} // namespace
+
+int TestCASEClient()
+{
+    nlTestSuite theSuite = { "Test-CHIP-CASEClient", &sTests[0], Initialize, Finalize };
+    nlTestRunner(&theSuite, &sContext);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestCASEClient)
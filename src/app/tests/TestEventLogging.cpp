@@ -39,10 +39,13 @@
 #include <messaging/ExchangeContext.h>
 #include <messaging/Flags.h>
 #include <platform/CHIPDeviceLayer.h>
+#include <system/SystemClock.h>
 #include <system/TLVPacketBufferBackingStore.h>
 
 #include <nlunit-test.h>
 
+#include <cstring>
+
 namespace {
 
 static const chip::NodeId kTestDeviceNodeId1      = 0x18B4300000000001ULL;
@@ -57,6 +60,11 @@ static uint8_t gInfoEventBuffer[128];
 static uint8_t gCritEventBuffer[128];
 static chip::app::CircularEventBuffer gCircularEventBuffer[3];
 
+// 16 KB in total, for the fetch benchmark
+static uint8_t gLargeDebugEventBuffer[4096];
+static uint8_t gLargeInfoEventBuffer[4096];
+static uint8_t gLargeCritEventBuffer[8192];
+
 class TestContext : public chip::Test::AppContext
 {
 public:
@@ -282,12 +290,170 @@ static void CheckLogEventWithDiscardLowEvent(nlTestSuite * apSuite, void * apCon
     NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
     CheckLogState(apSuite, logMgmt, 3, chip::app::PriorityLevel::Debug);
 }
+
+static void CreateEventManagement(TestContext & aContext, uint8_t * apDebugBuffer, size_t aDebugSize, uint8_t * apInfoBuffer,
+                                  size_t aInfoSize, uint8_t * apCritBuffer, size_t aCritSize)
+{
+    chip::app::LogStorageResources logStorageResources[] = {
+        { apDebugBuffer, aDebugSize, chip::app::PriorityLevel::Debug },
+        { apInfoBuffer, aInfoSize, chip::app::PriorityLevel::Info },
+        { apCritBuffer, aCritSize, chip::app::PriorityLevel::Critical },
+    };
+
+    chip::app::EventManagement::DestroyEventManagement();
+    chip::app::EventManagement::CreateEventManagement(&aContext.GetExchangeManager(),
+                                                      sizeof(logStorageResources) / sizeof(logStorageResources[0]),
+                                                      gCircularEventBuffer, logStorageResources, nullptr, 0, nullptr);
+}
+
+static void CheckFetchEventsWithEventIndex(nlTestSuite * apSuite, void * apContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(apContext);
+    CreateEventManagement(ctx, gDebugEventBuffer, sizeof(gDebugEventBuffer), gInfoEventBuffer, sizeof(gInfoEventBuffer),
+                          gCritEventBuffer, sizeof(gCritEventBuffer));
+
+    chip::app::EventManagement & logMgmt = chip::app::EventManagement::GetInstance();
+    TestEventGenerator testEventGenerator;
+    chip::EventNumber lastEventNumber = 0;
+
+    // Enough events of all priorities to get some moved to the next buffer and some dropped
+    for (int32_t i = 0; i < 12; i++)
+    {
+        chip::app::EventOptions options;
+        options.mPath     = { (i % 2) ? kTestEndpointId2 : kTestEndpointId1, kLivenessClusterId, kLivenessChangeEvent };
+        options.mPriority = static_cast<chip::app::PriorityLevel>(
+            chip::to_underlying(chip::app::PriorityLevel::Debug) + static_cast<uint8_t>(i % kNumPriorityLevel));
+        testEventGenerator.SetStatus(i);
+        NL_TEST_ASSERT(apSuite, logMgmt.LogEvent(&testEventGenerator, options, lastEventNumber) == CHIP_NO_ERROR);
+    }
+
+    chip::app::ClusterInfo testClusterInfo1;
+    testClusterInfo1.mNodeId     = kTestDeviceNodeId1;
+    testClusterInfo1.mEndpointId = kTestEndpointId1;
+    testClusterInfo1.mClusterId  = kLivenessClusterId;
+    chip::app::ClusterInfo testClusterInfo2;
+    testClusterInfo2.mNodeId     = kTestDeviceNodeId1;
+    testClusterInfo2.mEndpointId = kTestEndpointId2;
+    testClusterInfo2.mClusterId  = kLivenessClusterId;
+
+    // The same events, in the same encoding, must be fetched with and without the index
+    for (chip::app::ClusterInfo * clusterInfo : { &testClusterInfo1, &testClusterInfo2 })
+    {
+        for (chip::EventNumber startingEventNumber = 0; startingEventNumber <= lastEventNumber + 1; startingEventNumber++)
+        {
+            uint8_t backingStore[2][1024];
+            uint32_t lengthWritten[2];
+            chip::EventNumber eventMin[2];
+            size_t eventCount[2] = { 0, 0 };
+
+            for (bool enabled : { false, true })
+            {
+                chip::TLV::TLVWriter writer;
+                writer.Init(backingStore[enabled], sizeof(backingStore[enabled]));
+                eventMin[enabled] = startingEventNumber;
+
+                logMgmt.SetEventIndexEnabled(enabled);
+                CHIP_ERROR err = logMgmt.FetchEventsSince(writer, clusterInfo, eventMin[enabled], eventCount[enabled], 0);
+                NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR || err == CHIP_END_OF_TLV);
+                lengthWritten[enabled] = writer.GetLengthWritten();
+            }
+
+            NL_TEST_ASSERT(apSuite, eventCount[0] == eventCount[1]);
+            NL_TEST_ASSERT(apSuite, eventMin[0] == eventMin[1]);
+            NL_TEST_ASSERT(apSuite, lengthWritten[0] == lengthWritten[1]);
+            NL_TEST_ASSERT(apSuite, memcmp(backingStore[0], backingStore[1], lengthWritten[0]) == 0);
+        }
+    }
+
+    logMgmt.SetEventIndexEnabled(true);
+}
+
+static void BenchmarkFetchEvents(nlTestSuite * apSuite, void * apContext)
+{
+    constexpr size_t kSubscriberCount = 8;
+    constexpr uint32_t kRoundCount    = 200;
+
+    TestContext & ctx = *static_cast<TestContext *>(apContext);
+    CreateEventManagement(ctx, gLargeDebugEventBuffer, sizeof(gLargeDebugEventBuffer), gLargeInfoEventBuffer,
+                          sizeof(gLargeInfoEventBuffer), gLargeCritEventBuffer, sizeof(gLargeCritEventBuffer));
+
+    chip::app::EventManagement & logMgmt = chip::app::EventManagement::GetInstance();
+    TestEventGenerator testEventGenerator;
+    chip::EventNumber eventNumber = 0;
+    uint32_t logged               = 0;
+
+    // Each subscriber is interested in the events of its own cluster, and all of them get logged in turn
+    chip::app::ClusterInfo clusterInfo[kSubscriberCount];
+    for (size_t i = 0; i < kSubscriberCount; i++)
+    {
+        clusterInfo[i].mNodeId     = kTestDeviceNodeId1;
+        clusterInfo[i].mEndpointId = kTestEndpointId1;
+        clusterInfo[i].mClusterId  = kLivenessClusterId + static_cast<chip::ClusterId>(i);
+    }
+
+    auto logEvent = [&]() {
+        chip::app::EventOptions options;
+        options.mPath     = { kTestEndpointId1, kLivenessClusterId + static_cast<chip::ClusterId>(logged % kSubscriberCount),
+                          kLivenessChangeEvent };
+        options.mPriority = static_cast<chip::app::PriorityLevel>(
+            chip::to_underlying(chip::app::PriorityLevel::Debug) + static_cast<uint8_t>(logged % kNumPriorityLevel));
+        testEventGenerator.SetStatus(static_cast<int32_t>(logged));
+        logged++;
+        return logMgmt.LogEvent(&testEventGenerator, options, eventNumber);
+    };
+
+    // Fill all the buffers
+    while (logged < 2000)
+    {
+        NL_TEST_ASSERT(apSuite, logEvent() == CHIP_NO_ERROR);
+    }
+
+    size_t fetched[2] = { 0, 0 };
+    for (bool enabled : { false, true })
+    {
+        chip::EventNumber eventMin[kSubscriberCount];
+        for (auto & min : eventMin)
+        {
+            min = eventNumber + 1;
+        }
+
+        logMgmt.SetEventIndexEnabled(enabled);
+
+        chip::System::Clock::Microseconds64 start = chip::System::SystemClock().GetMonotonicMicroseconds64();
+        for (uint32_t round = 0; round < kRoundCount; round++)
+        {
+            NL_TEST_ASSERT(apSuite, logEvent() == CHIP_NO_ERROR);
+            for (size_t i = 0; i < kSubscriberCount; i++)
+            {
+                uint8_t backingStore[256];
+                chip::TLV::TLVWriter writer;
+                writer.Init(backingStore, sizeof(backingStore));
+                CHIP_ERROR err = logMgmt.FetchEventsSince(writer, &clusterInfo[i], eventMin[i], fetched[enabled], 0);
+                NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR || err == CHIP_END_OF_TLV);
+            }
+        }
+        chip::System::Clock::Microseconds64 elapsed = chip::System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+        ChipLogProgress(EventLogging, "FetchEventsSince x%" PRIu32 " %s event index: %" PRIu64 "us, %" PRIu64 " fetches/s",
+                        static_cast<uint32_t>(kRoundCount * kSubscriberCount), enabled ? "with" : "without", elapsed.count(),
+                        elapsed.count() ? (static_cast<uint64_t>(kRoundCount * kSubscriberCount) * 1000000u / elapsed.count())
+                                        : 0);
+    }
+
+    // Every event logged in a round is fetched by exactly one subscriber
+    NL_TEST_ASSERT(apSuite, fetched[0] == kRoundCount);
+    NL_TEST_ASSERT(apSuite, fetched[1] == kRoundCount);
+}
+
 /**
  *   Test Suite. It lists all the test functions.
  */
 
 const nlTest sTests[] = { NL_TEST_DEF("CheckLogEventWithEvictToNextBuffer", CheckLogEventWithEvictToNextBuffer),
-                          NL_TEST_DEF("CheckLogEventWithDiscardLowEvent", CheckLogEventWithDiscardLowEvent), NL_TEST_SENTINEL() };
+                          NL_TEST_DEF("CheckLogEventWithDiscardLowEvent", CheckLogEventWithDiscardLowEvent),
+                          NL_TEST_DEF("CheckFetchEventsWithEventIndex", CheckFetchEventsWithEventIndex),
+                          NL_TEST_DEF("BenchmarkFetchEvents", BenchmarkFetchEvents),
+                          NL_TEST_SENTINEL() };
 
 // clang-format off
 nlTestSuite sSuite =
@@ -0,0 +1,654 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a test for the file event store, on its own and
+ *      under EventManagement.
+ *
+ */
+
+#include <app/ClusterInfo.h>
+#include <app/EventLoggingDelegate.h>
+#include <app/EventManagement.h>
+#include <app/FileEventStore.h>
+#include <app/MessageDef/EventReportIB.h>
+#include <app/tests/AppTestContext.h>
+#include <lib/core/CHIPCore.h>
+#include <lib/core/CHIPTLV.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <system/SystemClock.h>
+
+#include <nlunit-test.h>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+using namespace chip;
+
+namespace {
+
+constexpr ClusterId kTestClusterId   = 0x00000022;
+constexpr EventId kTestEventId       = 1;
+constexpr EndpointId kTestEndpointId = 2;
+constexpr TLV::Tag kTestNumberTag    = TLV::ContextTag(1);
+constexpr size_t kTestSegmentSize    = 4096;
+
+uint8_t gDebugEventBuffer[128];
+uint8_t gInfoEventBuffer[128];
+uint8_t gCritEventBuffer[128];
+app::CircularEventBuffer gCircularEventBuffer[3];
+
+class TestContext : public Test::AppContext
+{
+public:
+    static int Initialize(void * context)
+    {
+        if (AppContext::Initialize(context) != SUCCESS)
+            return FAILURE;
+
+        static_cast<TestContext *>(context)->RestartEventManagement();
+
+        return SUCCESS;
+    }
+
+    static int Finalize(void * context)
+    {
+        app::EventManagement::DestroyEventManagement();
+
+        if (AppContext::Finalize(context) != SUCCESS)
+            return FAILURE;
+
+        return SUCCESS;
+    }
+
+    // Event management with empty buffers and a new event number counter, as after a restart
+    void RestartEventManagement()
+    {
+        app::LogStorageResources logStorageResources[] = {
+            { &gDebugEventBuffer[0], sizeof(gDebugEventBuffer), app::PriorityLevel::Debug },
+            { &gInfoEventBuffer[0], sizeof(gInfoEventBuffer), app::PriorityLevel::Info },
+            { &gCritEventBuffer[0], sizeof(gCritEventBuffer), app::PriorityLevel::Critical },
+        };
+
+        app::EventManagement::DestroyEventManagement();
+        app::EventManagement::CreateEventManagement(&GetExchangeManager(),
+                                                    sizeof(logStorageResources) / sizeof(logStorageResources[0]),
+                                                    gCircularEventBuffer, logStorageResources, nullptr, 0, nullptr);
+    }
+};
+
+std::string MakePath()
+{
+    char path[] = "/tmp/chip_event_store_test-XXXXXX";
+    int fd      = mkstemp(path);
+    if (fd != -1)
+    {
+        close(fd);
+        unlink(path);
+    }
+    return path;
+}
+
+void RemoveStore(const std::string & path)
+{
+    unlink((path + ".0").c_str());
+    unlink((path + ".1").c_str());
+}
+
+size_t FileSize(const std::string & path)
+{
+    struct stat info;
+    return (stat(path.c_str(), &info) == 0) ? static_cast<size_t>(info.st_size) : 0;
+}
+
+// Appends an event holding its own number, as an anonymous structure like in the event buffers
+CHIP_ERROR AppendTestEvent(app::FileEventStore & store, EventNumber eventNumber)
+{
+    uint8_t buffer[32];
+    TLV::TLVWriter writer;
+    TLV::TLVType containerType;
+    writer.Init(buffer, sizeof(buffer));
+    ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, containerType));
+    ReturnErrorOnFailure(writer.Put(kTestNumberTag, eventNumber));
+    ReturnErrorOnFailure(writer.EndContainer(containerType));
+    ReturnErrorOnFailure(writer.Finalize());
+
+    TLV::TLVReader reader;
+    reader.Init(buffer, writer.GetLengthWritten());
+    ReturnErrorOnFailure(reader.Next());
+    return store.AppendEvent(eventNumber, reader);
+}
+
+struct FetchedEvents
+{
+    EventNumber mEventNumbers[1024];
+    size_t mCount = 0;
+};
+
+CHIP_ERROR CollectEvent(const TLV::TLVReader & aReader, size_t aDepth, void * apContext)
+{
+    auto * fetched = static_cast<FetchedEvents *>(apContext);
+    TLV::TLVReader reader;
+    TLV::TLVType containerType;
+    EventNumber eventNumber;
+
+    VerifyOrReturnError(fetched->mCount < ArraySize(fetched->mEventNumbers), CHIP_ERROR_NO_MEMORY);
+    reader.Init(aReader);
+    ReturnErrorOnFailure(reader.EnterContainer(containerType));
+    ReturnErrorOnFailure(reader.Next(kTestNumberTag));
+    ReturnErrorOnFailure(reader.Get(eventNumber));
+    fetched->mEventNumbers[fetched->mCount++] = eventNumber;
+    return CHIP_NO_ERROR;
+}
+
+// Checks that the events are numbered aFirst to aLast, in order
+void CheckFetched(nlTestSuite * apSuite, const FetchedEvents & fetched, EventNumber aFirst, EventNumber aLast)
+{
+    NL_TEST_ASSERT(apSuite, fetched.mCount == aLast - aFirst + 1);
+    for (size_t i = 0; i < fetched.mCount; i++)
+    {
+        NL_TEST_ASSERT(apSuite, fetched.mEventNumbers[i] == aFirst + i);
+    }
+}
+
+class TestEventGenerator : public app::EventLoggingDelegate
+{
+public:
+    CHIP_ERROR WriteEvent(TLV::TLVWriter & aWriter)
+    {
+        TLV::TLVType dataContainerType;
+        ReturnErrorOnFailure(aWriter.StartContainer(TLV::ContextTag(to_underlying(app::EventDataIB::Tag::kData)),
+                                                    TLV::kTLVType_Structure, dataContainerType));
+        ReturnErrorOnFailure(aWriter.Put(kTestNumberTag, mStatus));
+        return aWriter.EndContainer(dataContainerType);
+    }
+
+    void SetStatus(int32_t aStatus) { mStatus = aStatus; }
+
+private:
+    int32_t mStatus = 0;
+};
+
+CHIP_ERROR LogTestEvent(TestEventGenerator & generator, int32_t status, EventNumber & eventNumber)
+{
+    app::EventOptions options;
+    options.mPath     = { kTestEndpointId, kTestClusterId, kTestEventId };
+    options.mPriority = app::PriorityLevel::Info;
+    generator.SetStatus(status);
+    return app::EventManagement::GetInstance().LogEvent(&generator, options, eventNumber);
+}
+
+// Counts the fetched events with a timestamp relative to the event before
+CHIP_ERROR CountDeltaTimestamps(const uint8_t * apData, size_t aLength, size_t & aCount)
+{
+    TLV::TLVReader reader;
+    CHIP_ERROR err;
+
+    aCount = 0;
+    reader.Init(apData, aLength);
+    while ((err = reader.Next()) == CHIP_NO_ERROR)
+    {
+        TLV::TLVType reportContainerType;
+        TLV::TLVType dataContainerType;
+        ReturnErrorOnFailure(reader.EnterContainer(reportContainerType));
+        ReturnErrorOnFailure(reader.Next(TLV::ContextTag(to_underlying(app::EventReportIB::Tag::kEventData))));
+        ReturnErrorOnFailure(reader.EnterContainer(dataContainerType));
+        while ((err = reader.Next()) == CHIP_NO_ERROR)
+        {
+            if (reader.GetTag() == TLV::ContextTag(to_underlying(app::EventDataIB::Tag::kDeltaSystemTimestamp)) ||
+                reader.GetTag() == TLV::ContextTag(to_underlying(app::EventDataIB::Tag::kDeltaEpochTimestamp)))
+            {
+                aCount++;
+            }
+        }
+        VerifyOrReturnError(err == CHIP_END_OF_TLV, err);
+        ReturnErrorOnFailure(reader.ExitContainer(dataContainerType));
+        ReturnErrorOnFailure(reader.ExitContainer(reportContainerType));
+    }
+    return (err == CHIP_END_OF_TLV) ? CHIP_NO_ERROR : err;
+}
+
+size_t FetchAllEvents(nlTestSuite * apSuite, EventNumber eventMin, size_t * apDeltaTimestampCount = nullptr)
+{
+    uint8_t backingStore[4096];
+    TLV::TLVWriter writer;
+    size_t eventCount = 0;
+    app::ClusterInfo clusterInfo;
+    clusterInfo.mEndpointId = kTestEndpointId;
+    clusterInfo.mClusterId  = kTestClusterId;
+
+    writer.Init(backingStore, sizeof(backingStore));
+    CHIP_ERROR err = app::EventManagement::GetInstance().FetchEventsSince(writer, &clusterInfo, eventMin, eventCount, 0);
+    NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR || err == CHIP_END_OF_TLV);
+    if (apDeltaTimestampCount != nullptr)
+    {
+        NL_TEST_ASSERT(apSuite,
+                       CountDeltaTimestamps(backingStore, writer.GetLengthWritten(), *apDeltaTimestampCount) == CHIP_NO_ERROR);
+    }
+    return eventCount;
+}
+
+void TestAppendAndFetch(nlTestSuite * apSuite, void * apContext)
+{
+    std::string path = MakePath();
+    app::FileEventStore store;
+    EventNumber lastEventNumber;
+
+    NL_TEST_ASSERT(apSuite, store.Init(path.c_str(), kTestSegmentSize) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, !store.GetLastEventNumber(lastEventNumber));
+
+    for (EventNumber i = 0; i < 100; i++)
+    {
+        NL_TEST_ASSERT(apSuite, AppendTestEvent(store, i) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(apSuite, store.GetLastEventNumber(lastEventNumber) && lastEventNumber == 99);
+
+    // Nothing is written until the store is flushed
+    FetchedEvents buffered;
+    FetchedEvents written;
+    NL_TEST_ASSERT(apSuite, store.ForEachBufferedEventSince(0, CollectEvent, &buffered) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, store.ForEachWrittenEventSince(0, CollectEvent, &written) == CHIP_NO_ERROR);
+    CheckFetched(apSuite, buffered, 0, 99);
+    NL_TEST_ASSERT(apSuite, written.mCount == 0);
+
+    NL_TEST_ASSERT(apSuite, store.Flush() == CHIP_NO_ERROR);
+    FetchedEvents none;
+    NL_TEST_ASSERT(apSuite, store.ForEachBufferedEventSince(0, CollectEvent, &none) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, none.mCount == 0);
+
+    FetchedEvents all;
+    NL_TEST_ASSERT(apSuite, store.ForEachWrittenEventSince(0, CollectEvent, &all) == CHIP_NO_ERROR);
+    CheckFetched(apSuite, all, 0, 99);
+
+    FetchedEvents recent;
+    NL_TEST_ASSERT(apSuite, store.ForEachWrittenEventSince(60, CollectEvent, &recent) == CHIP_NO_ERROR);
+    CheckFetched(apSuite, recent, 60, 99);
+
+    NL_TEST_ASSERT(apSuite, store.ForEachWrittenEventSince(100, CollectEvent, &none) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, none.mCount == 0);
+
+    store.Shutdown();
+    RemoveStore(path);
+}
+
+void TestSegmentRotation(nlTestSuite * apSuite, void * apContext)
+{
+    std::string path = MakePath();
+    app::FileEventStore store;
+    EventNumber lastEventNumber;
+
+    NL_TEST_ASSERT(apSuite, store.Init(path.c_str(), kTestSegmentSize) == CHIP_NO_ERROR);
+    for (EventNumber i = 0; i < 1000; i++)
+    {
+        NL_TEST_ASSERT(apSuite, AppendTestEvent(store, i) == CHIP_NO_ERROR);
+        if (i % 10 == 9)
+        {
+            NL_TEST_ASSERT(apSuite, store.Flush() == CHIP_NO_ERROR);
+        }
+    }
+    NL_TEST_ASSERT(apSuite, store.GetLastEventNumber(lastEventNumber) && lastEventNumber == 999);
+    NL_TEST_ASSERT(apSuite, FileSize(path + ".0") <= kTestSegmentSize);
+    NL_TEST_ASSERT(apSuite, FileSize(path + ".1") <= kTestSegmentSize);
+
+    // The oldest events are gone, and the others are all there
+    FetchedEvents fetched;
+    NL_TEST_ASSERT(apSuite, store.ForEachWrittenEventSince(0, CollectEvent, &fetched) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, fetched.mCount > 0 && fetched.mEventNumbers[0] > 0);
+    CheckFetched(apSuite, fetched, fetched.mEventNumbers[0], 999);
+
+    store.Shutdown();
+    RemoveStore(path);
+}
+
+void TestReopen(nlTestSuite * apSuite, void * apContext)
+{
+    std::string path = MakePath();
+    app::FileEventStore store;
+    EventNumber lastEventNumber;
+
+    NL_TEST_ASSERT(apSuite, store.Init(path.c_str(), kTestSegmentSize) == CHIP_NO_ERROR);
+    for (EventNumber i = 0; i < 50; i++)
+    {
+        NL_TEST_ASSERT(apSuite, AppendTestEvent(store, i) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(apSuite, store.Flush() == CHIP_NO_ERROR);
+    store.Shutdown();
+
+    // Part of a record, as left by a crash while appending
+    int fd = open((path + ".1").c_str(), O_WRONLY | O_APPEND);
+    NL_TEST_ASSERT(apSuite, fd != -1);
+    const uint8_t partialRecord[5] = { 50, 0, 0, 0, 0 };
+    NL_TEST_ASSERT(apSuite, write(fd, partialRecord, sizeof(partialRecord)) == static_cast<ssize_t>(sizeof(partialRecord)));
+    close(fd);
+
+    NL_TEST_ASSERT(apSuite, store.Init(path.c_str(), kTestSegmentSize) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, store.GetLastEventNumber(lastEventNumber) && lastEventNumber == 49);
+    NL_TEST_ASSERT(apSuite, AppendTestEvent(store, 50) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, store.Flush() == CHIP_NO_ERROR);
+    store.Shutdown();
+
+    NL_TEST_ASSERT(apSuite, store.Init(path.c_str(), kTestSegmentSize) == CHIP_NO_ERROR);
+    FetchedEvents fetched;
+    NL_TEST_ASSERT(apSuite, store.ForEachWrittenEventSince(0, CollectEvent, &fetched) == CHIP_NO_ERROR);
+    CheckFetched(apSuite, fetched, 0, 50);
+
+    store.Shutdown();
+    RemoveStore(path);
+}
+
+// Handles events until the fetched events are full, like a report that runs out of room
+CHIP_ERROR CollectSomeEvents(const TLV::TLVReader & aReader, size_t aDepth, void * apContext)
+{
+    auto * fetched = static_cast<FetchedEvents *>(apContext);
+    VerifyOrReturnError(fetched->mCount < 4, CHIP_ERROR_BUFFER_TOO_SMALL);
+    return CollectEvent(aReader, aDepth, apContext);
+}
+
+void TestFetchOutOfOrderEvents(nlTestSuite * apSuite, void * apContext)
+{
+    // Events evicted from the buffers of different priorities, which do not come in order
+    constexpr EventNumber kEventNumbers[] = { 5, 1, 4, 0, 3, 2, 11, 6, 10, 7, 9, 8 };
+
+    std::string path = MakePath();
+    app::FileEventStore store;
+
+    NL_TEST_ASSERT(apSuite, store.Init(path.c_str(), kTestSegmentSize) == CHIP_NO_ERROR);
+    for (EventNumber eventNumber : kEventNumbers)
+    {
+        NL_TEST_ASSERT(apSuite, AppendTestEvent(store, eventNumber) == CHIP_NO_ERROR);
+    }
+
+    FetchedEvents buffered;
+    NL_TEST_ASSERT(apSuite, store.ForEachBufferedEventSince(0, CollectEvent, &buffered) == CHIP_NO_ERROR);
+    CheckFetched(apSuite, buffered, 0, 11);
+
+    // Fetched a few at a time, each fetch resuming past the last event of the one before
+    NL_TEST_ASSERT(apSuite, store.Flush() == CHIP_NO_ERROR);
+    FetchedEvents all;
+    EventNumber eventMin = 0;
+    for (size_t i = 0; i < ArraySize(kEventNumbers) && all.mCount < ArraySize(kEventNumbers); i++)
+    {
+        FetchedEvents some;
+        CHIP_ERROR err = store.ForEachWrittenEventSince(eventMin, CollectSomeEvents, &some);
+        NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR || err == CHIP_ERROR_BUFFER_TOO_SMALL);
+        NL_TEST_ASSERT(apSuite, some.mCount > 0);
+        for (size_t j = 0; j < some.mCount; j++)
+        {
+            all.mEventNumbers[all.mCount++] = some.mEventNumbers[j];
+        }
+        eventMin = all.mEventNumbers[all.mCount - 1] + 1;
+    }
+    CheckFetched(apSuite, all, 0, 11);
+
+    store.Shutdown();
+    RemoveStore(path);
+}
+
+void TestFlushFailure(nlTestSuite * apSuite, void * apContext)
+{
+    std::string path = MakePath();
+    app::FileEventStore store;
+    EventNumber eventNumber = 0;
+
+    NL_TEST_ASSERT(apSuite, store.Init(path.c_str(), kTestSegmentSize) == CHIP_NO_ERROR);
+    while (FileSize(path + ".1") < kTestSegmentSize - 32)
+    {
+        NL_TEST_ASSERT(apSuite, AppendTestEvent(store, eventNumber++) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(apSuite, store.Flush() == CHIP_NO_ERROR);
+    }
+
+    // Without the current segment, the next one cannot be started
+    unlink((path + ".1").c_str());
+    for (size_t i = 0; i < 20; i++)
+    {
+        NL_TEST_ASSERT(apSuite, AppendTestEvent(store, eventNumber++) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(apSuite, store.Flush() != CHIP_NO_ERROR);
+
+    // The events that could not be written are still there, ahead of those appended since
+    NL_TEST_ASSERT(apSuite, AppendTestEvent(store, eventNumber++) == CHIP_NO_ERROR);
+    FetchedEvents written;
+    FetchedEvents buffered;
+    NL_TEST_ASSERT(apSuite, store.ForEachWrittenEventSince(0, CollectEvent, &written) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, store.ForEachBufferedEventSince(0, CollectEvent, &buffered) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, written.mCount > 0);
+    CheckFetched(apSuite, written, 0, written.mEventNumbers[written.mCount - 1]);
+    NL_TEST_ASSERT(apSuite, buffered.mCount > 1);
+    CheckFetched(apSuite, buffered, written.mCount, eventNumber - 1);
+
+    // And written by the next Flush that succeeds
+    int fd = open((path + ".1").c_str(), O_WRONLY | O_CREAT, 0600);
+    NL_TEST_ASSERT(apSuite, fd != -1);
+    close(fd);
+    NL_TEST_ASSERT(apSuite, store.Flush() == CHIP_NO_ERROR);
+
+    FetchedEvents all;
+    FetchedEvents none;
+    NL_TEST_ASSERT(apSuite, store.ForEachWrittenEventSince(0, CollectEvent, &all) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, store.ForEachBufferedEventSince(0, CollectEvent, &none) == CHIP_NO_ERROR);
+    CheckFetched(apSuite, all, 0, eventNumber - 1);
+    NL_TEST_ASSERT(apSuite, none.mCount == 0);
+
+    store.Shutdown();
+    RemoveStore(path);
+}
+
+void TestFetchEventsFromStore(nlTestSuite * apSuite, void * apContext)
+{
+    constexpr size_t kEventCount = 30;
+
+    TestContext & ctx = *static_cast<TestContext *>(apContext);
+    std::string path  = MakePath();
+    app::FileEventStore store;
+    TestEventGenerator generator;
+    EventNumber eventNumber = 0;
+    EventNumber lastStoredEventNumber;
+
+    ctx.RestartEventManagement();
+    NL_TEST_ASSERT(apSuite, store.Init(path.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, app::EventManagement::GetInstance().SetPersistentEventStore(&store) == CHIP_NO_ERROR);
+
+    // Far more than the buffers hold, so that most get evicted to the store
+    for (size_t i = 0; i < kEventCount; i++)
+    {
+        NL_TEST_ASSERT(apSuite, LogTestEvent(generator, static_cast<int32_t>(i), eventNumber) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(apSuite, store.GetLastEventNumber(lastStoredEventNumber) && lastStoredEventNumber < eventNumber);
+
+    // LogEvent writes the evicted events once it has released the event lock
+    FetchedEvents buffered;
+    NL_TEST_ASSERT(apSuite, store.ForEachBufferedEventSince(0, CollectEvent, &buffered) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, buffered.mCount == 0);
+
+    NL_TEST_ASSERT(apSuite, FetchAllEvents(apSuite, 0) == kEventCount);
+    NL_TEST_ASSERT(apSuite, FetchAllEvents(apSuite, eventNumber) == 1);
+
+    NL_TEST_ASSERT(apSuite, app::EventManagement::GetInstance().SetPersistentEventStore(nullptr) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, FetchAllEvents(apSuite, 0) < kEventCount);
+
+    // After a restart, the event number counter starts over, past the stored events
+    ctx.RestartEventManagement();
+    NL_TEST_ASSERT(apSuite, app::EventManagement::GetInstance().SetPersistentEventStore(&store) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, LogTestEvent(generator, static_cast<int32_t>(kEventCount), eventNumber) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, eventNumber > lastStoredEventNumber);
+    NL_TEST_ASSERT(apSuite, FetchAllEvents(apSuite, lastStoredEventNumber) == 2);
+
+    app::EventManagement::GetInstance().SetPersistentEventStore(nullptr);
+    store.Shutdown();
+    RemoveStore(path);
+}
+
+void TestStoreOnShutdown(nlTestSuite * apSuite, void * apContext)
+{
+    constexpr size_t kEventCount = 2;
+
+    TestContext & ctx = *static_cast<TestContext *>(apContext);
+    std::string path  = MakePath();
+    app::FileEventStore store;
+    TestEventGenerator generator;
+    EventNumber eventNumber = 0;
+    EventNumber lastStoredEventNumber;
+
+    ctx.RestartEventManagement();
+    NL_TEST_ASSERT(apSuite, store.Init(path.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, app::EventManagement::GetInstance().SetPersistentEventStore(&store) == CHIP_NO_ERROR);
+
+    // Few enough that none gets evicted
+    for (size_t i = 0; i < kEventCount; i++)
+    {
+        NL_TEST_ASSERT(apSuite, LogTestEvent(generator, static_cast<int32_t>(i), eventNumber) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(apSuite, !store.GetLastEventNumber(lastStoredEventNumber));
+
+    // They are stored on shutdown, and still there after a restart
+    ctx.RestartEventManagement();
+    NL_TEST_ASSERT(apSuite, store.GetLastEventNumber(lastStoredEventNumber) && lastStoredEventNumber == eventNumber);
+    NL_TEST_ASSERT(apSuite, app::EventManagement::GetInstance().SetPersistentEventStore(&store) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, FetchAllEvents(apSuite, 0) == kEventCount);
+
+    app::EventManagement::GetInstance().SetPersistentEventStore(nullptr);
+    store.Shutdown();
+    RemoveStore(path);
+}
+
+void TestTimestampsAcrossRestart(nlTestSuite * apSuite, void * apContext)
+{
+    constexpr size_t kEventCount = 30;
+
+    TestContext & ctx = *static_cast<TestContext *>(apContext);
+    std::string path  = MakePath();
+    app::FileEventStore store;
+    TestEventGenerator generator;
+    EventNumber eventNumber = 0;
+    size_t deltaTimestampCount;
+
+    ctx.RestartEventManagement();
+    NL_TEST_ASSERT(apSuite, store.Init(path.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, app::EventManagement::GetInstance().SetPersistentEventStore(&store) == CHIP_NO_ERROR);
+    for (size_t i = 0; i < kEventCount; i++)
+    {
+        NL_TEST_ASSERT(apSuite, LogTestEvent(generator, static_cast<int32_t>(i), eventNumber) == CHIP_NO_ERROR);
+    }
+
+    // Before the restart, all but the first are relative to the event before
+    NL_TEST_ASSERT(apSuite, FetchAllEvents(apSuite, 0, &deltaTimestampCount) == kEventCount);
+    NL_TEST_ASSERT(apSuite, deltaTimestampCount == kEventCount - 1);
+
+    // After it, the system timestamps of the events before count from another boot, so neither they nor the first event
+    // after them can be relative to the event before
+    ctx.RestartEventManagement();
+    NL_TEST_ASSERT(apSuite, app::EventManagement::GetInstance().SetPersistentEventStore(&store) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, LogTestEvent(generator, static_cast<int32_t>(kEventCount), eventNumber) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, LogTestEvent(generator, static_cast<int32_t>(kEventCount + 1), eventNumber) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, FetchAllEvents(apSuite, 0, &deltaTimestampCount) == kEventCount + 2);
+    NL_TEST_ASSERT(apSuite, deltaTimestampCount == 1);
+
+    app::EventManagement::GetInstance().SetPersistentEventStore(nullptr);
+    store.Shutdown();
+    RemoveStore(path);
+}
+
+void BenchmarkLogEvent(nlTestSuite * apSuite, void * apContext)
+{
+    // The event rate the store has to keep up with
+    constexpr uint32_t kEventCount = 10000;
+
+    TestContext & ctx = *static_cast<TestContext *>(apContext);
+    std::string path  = MakePath();
+    app::FileEventStore store;
+    TestEventGenerator generator;
+
+    NL_TEST_ASSERT(apSuite, store.Init(path.c_str()) == CHIP_NO_ERROR);
+
+    uint32_t logged[2] = { 0, 0 };
+    for (bool withStore : { false, true })
+    {
+        EventNumber eventNumber;
+
+        ctx.RestartEventManagement();
+        NL_TEST_ASSERT(apSuite,
+                       app::EventManagement::GetInstance().SetPersistentEventStore(withStore ? &store : nullptr) == CHIP_NO_ERROR);
+
+        System::Clock::Microseconds64 start = System::SystemClock().GetMonotonicMicroseconds64();
+        for (uint32_t i = 0; i < kEventCount; i++)
+        {
+            if (LogTestEvent(generator, static_cast<int32_t>(i), eventNumber) == CHIP_NO_ERROR)
+            {
+                logged[withStore]++;
+            }
+        }
+        System::Clock::Microseconds64 elapsed = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+        ChipLogProgress(EventLogging, "LogEvent x%" PRIu32 " %s file store: %" PRIu64 "us, %" PRIu64 " events/s", kEventCount,
+                        withStore ? "with" : "without", elapsed.count(),
+                        elapsed.count() ? (static_cast<uint64_t>(kEventCount) * 1000000u / elapsed.count()) : 0);
+    }
+
+    NL_TEST_ASSERT(apSuite, logged[0] == kEventCount);
+    NL_TEST_ASSERT(apSuite, logged[1] == kEventCount);
+
+    EventNumber lastStoredEventNumber;
+    NL_TEST_ASSERT(apSuite, store.GetLastEventNumber(lastStoredEventNumber));
+
+    app::EventManagement::GetInstance().SetPersistentEventStore(nullptr);
+    store.Shutdown();
+    RemoveStore(path);
+}
+
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("TestAppendAndFetch", TestAppendAndFetch),
+    NL_TEST_DEF("TestSegmentRotation", TestSegmentRotation),
+    NL_TEST_DEF("TestReopen", TestReopen),
+    NL_TEST_DEF("TestFetchOutOfOrderEvents", TestFetchOutOfOrderEvents),
+    NL_TEST_DEF("TestFlushFailure", TestFlushFailure),
+    NL_TEST_DEF("TestFetchEventsFromStore", TestFetchEventsFromStore),
+    NL_TEST_DEF("TestStoreOnShutdown", TestStoreOnShutdown),
+    NL_TEST_DEF("TestTimestampsAcrossRestart", TestTimestampsAcrossRestart),
+    NL_TEST_DEF("BenchmarkLogEvent", BenchmarkLogEvent),
+    NL_TEST_SENTINEL(),
+};
+
+// clang-format off
+nlTestSuite sSuite =
+{
+    "FileEventStore",
+    &sTests[0],
+    TestContext::Initialize,
+    TestContext::Finalize
+};
+// clang-format on
+
+} // namespace
+
+int TestFileEventStore()
+{
+    TestContext gContext;
+    nlTestRunner(&sSuite, &gContext);
+    return (nlTestRunnerStats(&sSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestFileEventStore)
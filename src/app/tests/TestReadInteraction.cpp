@@ -198,7 +198,8 @@ namespace chip {
 namespace app {
 CHIP_ERROR ReadSingleClusterData(const Access::SubjectDescriptor & aSubjectDescriptor, bool aIsFabricFiltered,
                                  const ConcreteReadAttributePath & aPath, AttributeReportIBs::Builder & aAttributeReports,
-                                 AttributeValueEncoder::AttributeEncodeState * apEncoderState)
+                                 AttributeValueEncoder::AttributeEncodeState * apEncoderState,
+                                 Access::AccessControl::CheckBatch & aAccessCheckBatch)
 {
     if (aPath.mClusterId >= Test::kMockEndpointMin)
     {
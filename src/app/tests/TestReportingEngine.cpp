@@ -32,11 +32,15 @@
 #include <lib/core/CHIPTLVUtilities.hpp>
 #include <lib/support/ErrorStr.h>
 #include <lib/support/UnitTestRegistration.h>
+#include <lib/support/logging/CHIPLogging.h>
 #include <messaging/ExchangeContext.h>
 #include <messaging/Flags.h>
+#include <system/SystemClock.h>
 
 #include <nlunit-test.h>
 
+#include <algorithm>
+
 using TestContext = chip::Test::AppContext;
 
 namespace chip {
@@ -53,6 +57,7 @@ class TestReportingEngine
 public:
     static void TestBuildAndSendSingleReportData(nlTestSuite * apSuite, void * apContext);
     static void TestMergeOverlappedAttributePath(nlTestSuite * apSuite, void * apContext);
+    static void BenchmarkSetDirty(nlTestSuite * apSuite, void * apContext);
 };
 
 class TestExchangeDelegate : public Messaging::ExchangeDelegate
@@ -120,8 +125,10 @@ void TestReportingEngine::TestMergeOverlappedAttributePath(nlTestSuite * apSuite
     err               = InteractionModelEngine::GetInstance()->Init(&ctx.GetExchangeManager());
     NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
 
-    ClusterInfo * clusterInfo = InteractionModelEngine::GetInstance()->GetReportingEngine().mGlobalDirtySet.CreateObject();
-    clusterInfo->mAttributeId = 1;
+    ClusterInfo dirtyPath;
+    dirtyPath.mAttributeId = 1;
+    err = InteractionModelEngine::GetInstance()->GetReportingEngine().InsertPathIntoDirtySet(dirtyPath);
+    NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
 
     {
         chip::app::ClusterInfo testClusterInfo;
@@ -140,6 +147,117 @@ void TestReportingEngine::TestMergeOverlappedAttributePath(nlTestSuite * apSuite
     InteractionModelEngine::GetInstance()->GetReportingEngine().Shutdown();
 }
 
+/**
+ * Drives 10k SetDirty calls against 64 concurrent subscriptions, each watching whole clusters on its own endpoint, and compares
+ * the time taken with the scan of every handler path the engine used to do for each call.
+ */
+void TestReportingEngine::BenchmarkSetDirty(nlTestSuite * apSuite, void * apContext)
+{
+    constexpr ClusterId kClusters[]       = { 0x0006, 0x0008, 0x0300, 0x0402 };
+    constexpr size_t kPathsPerHandler     = sizeof(kClusters) / sizeof(kClusters[0]);
+    constexpr uint32_t kSetDirtyCount     = 10000;
+    constexpr EndpointId kUnwatchedOffset = 100;
+
+    // 64 with the standalone config, fewer where the path pool cannot hold the paths of that many subscriptions.
+    constexpr size_t kHandlerCount = std::min<size_t>(64, CHIP_IM_SERVER_MAX_NUM_PATH_GROUPS / kPathsPerHandler);
+    static_assert(kHandlerCount > 0, "Every handler needs its paths");
+
+    TestContext & ctx = *static_cast<TestContext *>(apContext);
+    Engine & engine   = InteractionModelEngine::GetInstance()->GetReportingEngine();
+    CHIP_ERROR err    = InteractionModelEngine::GetInstance()->Init(&ctx.GetExchangeManager());
+    NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
+
+    TestExchangeDelegate delegate;
+    DummyDelegate dummy;
+    ReadHandler * handlers[kHandlerCount];
+
+    // Handler i subscribes to whole clusters on endpoint i + 1.
+    for (size_t i = 0; i < kHandlerCount; i++)
+    {
+        handlers[i] = new ReadHandler(dummy, ctx.NewExchangeToAlice(&delegate), ReadHandler::InteractionType::Subscribe);
+
+        // The handlers never send anything, so let their exchanges go for all of them to fit in the exchange pool.
+        handlers[i]->mpExchangeCtx->SetDelegate(nullptr);
+        handlers[i]->mpExchangeCtx->Abort();
+        handlers[i]->mpExchangeCtx = nullptr;
+
+        for (size_t j = 0; j < kPathsPerHandler; j++)
+        {
+            ClusterInfo path;
+            path.mEndpointId = static_cast<EndpointId>(i + 1);
+            path.mClusterId  = kClusters[j];
+            NL_TEST_ASSERT(apSuite,
+                           InteractionModelEngine::GetInstance()->PushFront(handlers[i]->mpAttributeClusterInfoList, path) ==
+                               CHIP_NO_ERROR);
+        }
+        NL_TEST_ASSERT(apSuite, engine.RegisterReadHandlerInterest(*handlers[i]) == CHIP_NO_ERROR);
+        handlers[i]->MoveToState(ReadHandler::HandlerState::GeneratingReports);
+    }
+
+    // Every other change is to an endpoint nobody watches, the others go round the watched endpoints.
+    auto dirtyPath = [&](uint32_t i) {
+        ClusterInfo path;
+        path.mEndpointId  = static_cast<EndpointId>((i / 2) % kHandlerCount + 1 + ((i % 2) ? kUnwatchedOffset : 0));
+        path.mClusterId   = kClusters[0];
+        path.mAttributeId = 0;
+        return path;
+    };
+
+    uint64_t indexedDirtied = 0;
+    System::Clock::Microseconds64 start = System::SystemClock().GetMonotonicMicroseconds64();
+    for (uint32_t i = 0; i < kSetDirtyCount; i++)
+    {
+        ClusterInfo path = dirtyPath(i);
+        NL_TEST_ASSERT(apSuite, engine.SetDirty(path) == CHIP_NO_ERROR);
+        for (auto handler : handlers)
+        {
+            indexedDirtied += handler->IsDirty() ? 1 : 0;
+            handler->ClearDirty();
+        }
+        // As a report run would, so that the dirty set does not fill up.
+        engine.ReleaseDirtySet();
+    }
+    System::Clock::Microseconds64 indexedTime = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+    // The scan SetDirty did before the index, over the same handlers.
+    uint64_t linearDirtied = 0;
+    start                  = System::SystemClock().GetMonotonicMicroseconds64();
+    for (uint32_t i = 0; i < kSetDirtyCount; i++)
+    {
+        ClusterInfo path = dirtyPath(i);
+        for (auto handler : handlers)
+        {
+            for (auto clusterInfo = handler->GetAttributeClusterInfolist(); clusterInfo != nullptr;
+                 clusterInfo = clusterInfo->mpNext)
+            {
+                if (handler->IsGeneratingReports() &&
+                    (path.IsAttributePathSupersetOf(*clusterInfo) || clusterInfo->IsAttributePathSupersetOf(path)))
+                {
+                    handler->SetDirty();
+                    break;
+                }
+            }
+            linearDirtied += handler->IsDirty() ? 1 : 0;
+            handler->ClearDirty();
+        }
+        engine.ReleaseDirtySet();
+    }
+    System::Clock::Microseconds64 linearTime = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+    ChipLogProgress(DataManagement, "SetDirty x%" PRIu32 " over %u subscriptions: indexed %" PRIu64 "us, linear scan %" PRIu64 "us",
+                    kSetDirtyCount, static_cast<unsigned>(kHandlerCount), indexedTime.count(), linearTime.count());
+
+    // Only the changes to watched endpoints dirty a handler, and exactly one.
+    NL_TEST_ASSERT(apSuite, indexedDirtied == kSetDirtyCount / 2);
+    NL_TEST_ASSERT(apSuite, indexedDirtied == linearDirtied);
+
+    for (auto handler : handlers)
+    {
+        delete handler;
+    }
+    engine.Shutdown();
+}
+
 } // namespace reporting
 } // namespace app
 } // namespace chip
@@ -150,6 +268,7 @@ const nlTest sTests[] =
 {
     NL_TEST_DEF("CheckBuildAndSendSingleReportData", chip::app::reporting::TestReportingEngine::TestBuildAndSendSingleReportData),
     NL_TEST_DEF("TestMergeOverlappedAttributePath", chip::app::reporting::TestReportingEngine::TestMergeOverlappedAttributePath),
+    NL_TEST_DEF("BenchmarkSetDirty", chip::app::reporting::TestReportingEngine::BenchmarkSetDirty),
     NL_TEST_SENTINEL()
 };
 // clang-format on
@@ -326,7 +326,8 @@ void TestWriteInteraction::TestWriteHandler(nlTestSuite * apSuite, void * apCont
 }
 
 CHIP_ERROR WriteSingleClusterData(const Access::SubjectDescriptor & aSubjectDescriptor, ClusterInfo & aClusterInfo,
-                                  TLV::TLVReader & aReader, WriteHandler * aWriteHandler)
+                                  TLV::TLVReader & aReader, WriteHandler * aWriteHandler,
+                                  Access::AccessControl::CheckBatch & aAccessCheckBatch)
 {
     TLV::TLVWriter writer;
     writer.Init(attributeDataTLV);
@@ -113,6 +113,55 @@ DataVersion fixedEndpointDataVersions[ZAP_FIXED_ENDPOINT_DATA_VERSION_COUNT];
 #endif
 
 app::AttributeAccessInterface * gAttributeAccessOverrides = nullptr;
+
+// Open-addressed table mapping endpoint ids to their index in emAfEndpoints, so
+// that endpoint lookups do not have to walk every defined endpoint. It is
+// rebuilt whenever the set of defined endpoints changes, which only happens in
+// emberAfEndpointConfigure and when dynamic endpoints are set or cleared.
+constexpr uint16_t kEndpointIndexTableEmptySlot = 0xFFFF;
+
+constexpr uint16_t EndpointIndexTableSize(uint32_t size = 1)
+{
+    // Keep the load factor at or below 1/2 so probe sequences stay short.
+    return (size >= 2 * MAX_ENDPOINT_COUNT) ? static_cast<uint16_t>(size) : EndpointIndexTableSize(size * 2);
+}
+
+constexpr uint16_t kEndpointIndexTableSize = EndpointIndexTableSize();
+static_assert((kEndpointIndexTableSize & (kEndpointIndexTableSize - 1)) == 0, "Endpoint index table size must be a power of 2");
+
+uint16_t endpointIndexTable[kEndpointIndexTableSize];
+
+// Offset of the attribute storage of each fixed endpoint in attributeData.
+// Dynamic endpoints only have external storage.
+uint16_t fixedEndpointStorageOffsets[FIXED_ENDPOINT_COUNT > 0 ? FIXED_ENDPOINT_COUNT : 1];
+
+inline uint16_t endpointIndexTableSlot(EndpointId endpoint)
+{
+    return static_cast<uint16_t>(endpoint & (kEndpointIndexTableSize - 1));
+}
+
+void rebuildEndpointIndexTable()
+{
+    for (auto & slot : endpointIndexTable)
+    {
+        slot = kEndpointIndexTableEmptySlot;
+    }
+
+    for (uint16_t index = 0; index < emberAfEndpointCount(); index++)
+    {
+        if (emAfEndpoints[index].endpoint == kInvalidEndpointId)
+        {
+            continue;
+        }
+
+        uint16_t slot = endpointIndexTableSlot(emAfEndpoints[index].endpoint);
+        while (endpointIndexTable[slot] != kEndpointIndexTableEmptySlot)
+        {
+            slot = static_cast<uint16_t>((slot + 1) & (kEndpointIndexTableSize - 1));
+        }
+        endpointIndexTable[slot] = index;
+    }
+}
 } // anonymous namespace
 
 //------------------------------------------------------------------------------
@@ -150,6 +199,7 @@ void emberAfEndpointConfigure(void)
 
     emberEndpointCount                = FIXED_ENDPOINT_COUNT;
     DataVersion * currentDataVersions = fixedEndpointDataVersions;
+    uint16_t currentStorageOffset     = 0;
     for (ep = 0; ep < FIXED_ENDPOINT_COUNT; ep++)
     {
         emAfEndpoints[ep].endpoint      = endpointNumber(ep);
@@ -162,6 +212,10 @@ void emberAfEndpointConfigure(void)
         // Increment currentDataVersions by 1 (slot) for every server cluster
         // this endpoint has.
         currentDataVersions += emberAfClusterCountByIndex(ep, /* server = */ true);
+
+        // Storage for the attributes of fixed endpoints is laid out in endpoint order.
+        fixedEndpointStorageOffsets[ep] = currentStorageOffset;
+        currentStorageOffset            = static_cast<uint16_t>(currentStorageOffset + endpointTypeMacro(ep)->endpointSize);
     }
 
 #if CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT
@@ -177,11 +231,14 @@ void emberAfEndpointConfigure(void)
         }
     }
 #endif
+
+    rebuildEndpointIndexTable();
 }
 
 void emberAfSetDynamicEndpointCount(uint16_t dynamicEndpointCount)
 {
     emberEndpointCount = static_cast<uint16_t>(FIXED_ENDPOINT_COUNT + dynamicEndpointCount);
+    rebuildEndpointIndexTable();
 }
 
 uint16_t emberAfGetDynamicIndexFromEndpoint(EndpointId id)
@@ -267,6 +324,7 @@ EndpointId emberAfClearDynamicEndpoint(uint16_t index)
         emberAfSetDeviceEnabled(ep, false);
         emberAfEndpointEnableDisable(ep, false);
         emAfEndpoints[index].endpoint = kInvalidEndpointId;
+        rebuildEndpointIndexTable();
     }
 
     return ep;
@@ -549,114 +607,99 @@ bool emAfMatchAttribute(const EmberAfCluster * cluster, const EmberAfAttributeMe
 EmberAfStatus emAfReadOrWriteAttribute(EmberAfAttributeSearchRecord * attRecord, const EmberAfAttributeMetadata ** metadata,
                                        uint8_t * buffer, uint16_t readLength, bool write)
 {
-    uint16_t attributeOffsetIndex = 0;
-
-    for (uint8_t ep = 0; ep < emberAfEndpointCount(); ep++)
+    uint16_t ep = emberAfIndexFromEndpoint(attRecord->endpoint);
+    if (ep == 0xFFFF)
     {
-        // Is this a dynamic endpoint?
-        bool isDynamicEndpoint = (ep >= emberAfFixedEndpointCount());
+        return EMBER_ZCL_STATUS_UNSUPPORTED_ATTRIBUTE; // Sorry, attribute was not found.
+    }
 
-        if (emAfEndpoints[ep].endpoint == attRecord->endpoint)
-        {
-            const EmberAfEndpointType * endpointType = emAfEndpoints[ep].endpointType;
-            uint8_t clusterIndex;
-            if (!emberAfEndpointIndexIsEnabled(ep))
-            {
-                continue;
-            }
-            for (clusterIndex = 0; clusterIndex < endpointType->clusterCount; clusterIndex++)
+    // Is this a dynamic endpoint?
+    bool isDynamicEndpoint = (ep >= emberAfFixedEndpointCount());
+
+    // Dynamic endpoints are external and don't factor into storage size
+    uint16_t attributeOffsetIndex            = isDynamicEndpoint ? 0 : fixedEndpointStorageOffsets[ep];
+    const EmberAfEndpointType * endpointType = emAfEndpoints[ep].endpointType;
+    uint8_t clusterIndex;
+    for (clusterIndex = 0; clusterIndex < endpointType->clusterCount; clusterIndex++)
+    {
+        const EmberAfCluster * cluster = &(endpointType->cluster[clusterIndex]);
+        if (emAfMatchCluster(cluster, attRecord))
+        { // Got the cluster
+            uint16_t attrIndex;
+            for (attrIndex = 0; attrIndex < cluster->attributeCount; attrIndex++)
             {
-                const EmberAfCluster * cluster = &(endpointType->cluster[clusterIndex]);
-                if (emAfMatchCluster(cluster, attRecord))
-                { // Got the cluster
-                    uint16_t attrIndex;
-                    for (attrIndex = 0; attrIndex < cluster->attributeCount; attrIndex++)
+                const EmberAfAttributeMetadata * am = &(cluster->attributes[attrIndex]);
+                if (emAfMatchAttribute(cluster, am, attRecord))
+                { // Got the attribute
+                    // If passed metadata location is not null, populate
+                    if (metadata != NULL)
+                    {
+                        *metadata = am;
+                    }
+
                     {
-                        const EmberAfAttributeMetadata * am = &(cluster->attributes[attrIndex]);
-                        if (emAfMatchAttribute(cluster, am, attRecord))
-                        { // Got the attribute
-                            // If passed metadata location is not null, populate
-                            if (metadata != NULL)
+                        uint8_t * attributeLocation = (am->mask & ATTRIBUTE_MASK_SINGLETON ? singletonAttributeLocation(am)
+                                                                                          : attributeData + attributeOffsetIndex);
+                        uint8_t *src, *dst;
+                        if (write)
+                        {
+                            src = buffer;
+                            dst = attributeLocation;
+                            if (!emberAfAttributeWriteAccessCallback(attRecord->endpoint, attRecord->clusterId, am->attributeId))
+                            {
+                                return EMBER_ZCL_STATUS_NOT_AUTHORIZED;
+                            }
+                        }
+                        else
+                        {
+                            if (buffer == NULL)
                             {
-                                *metadata = am;
+                                return EMBER_ZCL_STATUS_SUCCESS;
                             }
 
+                            src = attributeLocation;
+                            dst = buffer;
+                            if (!emberAfAttributeReadAccessCallback(attRecord->endpoint, attRecord->clusterId, am->attributeId))
                             {
-                                uint8_t * attributeLocation =
-                                    (am->mask & ATTRIBUTE_MASK_SINGLETON ? singletonAttributeLocation(am)
-                                                                         : attributeData + attributeOffsetIndex);
-                                uint8_t *src, *dst;
-                                if (write)
-                                {
-                                    src = buffer;
-                                    dst = attributeLocation;
-                                    if (!emberAfAttributeWriteAccessCallback(attRecord->endpoint, attRecord->clusterId,
-                                                                             am->attributeId))
-                                    {
-                                        return EMBER_ZCL_STATUS_NOT_AUTHORIZED;
-                                    }
-                                }
-                                else
-                                {
-                                    if (buffer == NULL)
-                                    {
-                                        return EMBER_ZCL_STATUS_SUCCESS;
-                                    }
-
-                                    src = attributeLocation;
-                                    dst = buffer;
-                                    if (!emberAfAttributeReadAccessCallback(attRecord->endpoint, attRecord->clusterId,
-                                                                            am->attributeId))
-                                    {
-                                        return EMBER_ZCL_STATUS_NOT_AUTHORIZED;
-                                    }
-                                }
-
-                                // Is the attribute externally stored?
-                                if (am->mask & ATTRIBUTE_MASK_EXTERNAL_STORAGE)
-                                {
-                                    return (write ? emberAfExternalAttributeWriteCallback(attRecord->endpoint, attRecord->clusterId,
-                                                                                          am, buffer)
-                                                  : emberAfExternalAttributeReadCallback(attRecord->endpoint, attRecord->clusterId,
-                                                                                         am, buffer, emberAfAttributeSize(am)));
-                                }
-                                else
-                                {
-                                    // Internal storage is only supported for fixed endpoints
-                                    if (!isDynamicEndpoint)
-                                    {
-                                        return typeSensitiveMemCopy(attRecord->clusterId, dst, src, am, write, readLength);
-                                    }
-                                    else
-                                    {
-                                        return EMBER_ZCL_STATUS_FAILURE;
-                                    }
-                                }
+                                return EMBER_ZCL_STATUS_NOT_AUTHORIZED;
                             }
                         }
+
+                        // Is the attribute externally stored?
+                        if (am->mask & ATTRIBUTE_MASK_EXTERNAL_STORAGE)
+                        {
+                            return (write ? emberAfExternalAttributeWriteCallback(attRecord->endpoint, attRecord->clusterId, am,
+                                                                                  buffer)
+                                          : emberAfExternalAttributeReadCallback(attRecord->endpoint, attRecord->clusterId, am,
+                                                                                 buffer, emberAfAttributeSize(am)));
+                        }
                         else
-                        { // Not the attribute we are looking for
-                            // Increase the index if attribute is not externally stored
-                            if (!(am->mask & ATTRIBUTE_MASK_EXTERNAL_STORAGE) && !(am->mask & ATTRIBUTE_MASK_SINGLETON))
+                        {
+                            // Internal storage is only supported for fixed endpoints
+                            if (!isDynamicEndpoint)
                             {
-                                attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + emberAfAttributeSize(am));
+                                return typeSensitiveMemCopy(attRecord->clusterId, dst, src, am, write, readLength);
+                            }
+                            else
+                            {
+                                return EMBER_ZCL_STATUS_FAILURE;
                             }
                         }
                     }
                 }
                 else
-                { // Not the cluster we are looking for
-                    attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + cluster->clusterSize);
+                { // Not the attribute we are looking for
+                    // Increase the index if attribute is not externally stored
+                    if (!(am->mask & ATTRIBUTE_MASK_EXTERNAL_STORAGE) && !(am->mask & ATTRIBUTE_MASK_SINGLETON))
+                    {
+                        attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + emberAfAttributeSize(am));
+                    }
                 }
             }
         }
         else
-        { // Not the endpoint we are looking for
-            // Dynamic endpoints are external and don't factor into storage size
-            if (!isDynamicEndpoint)
-            {
-                attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + emAfEndpoints[ep].endpointType->endpointSize);
-            }
+        { // Not the cluster we are looking for
+            attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + cluster->clusterSize);
         }
     }
     return EMBER_ZCL_STATUS_UNSUPPORTED_ATTRIBUTE; // Sorry, attribute was not found.
@@ -704,19 +747,16 @@ const EmberAfCluster * emberAfFindClusterInType(const EmberAfEndpointType * endp
 
 uint8_t emberAfClusterIndex(EndpointId endpoint, ClusterId clusterId, EmberAfClusterMask mask)
 {
-    for (uint8_t ep = 0; ep < emberAfEndpointCount(); ep++)
+    uint16_t ep = emberAfIndexFromEndpointIncludingDisabledEndpoints(endpoint);
+    if (ep == 0xFFFF)
     {
-        // Check the endpoint id first, because that way we avoid examining the
-        // endpoint type for endpoints that are not actually defined.
-        if (emAfEndpoints[ep].endpoint == endpoint)
-        {
-            const EmberAfEndpointType * endpointType = emAfEndpoints[ep].endpointType;
-            uint8_t index                            = 0xFF;
-            if (emberAfFindClusterInType(endpointType, clusterId, mask, &index) != NULL)
-            {
-                return index;
-            }
-        }
+        return 0xFF;
+    }
+
+    uint8_t index = 0xFF;
+    if (emberAfFindClusterInType(emAfEndpoints[ep].endpointType, clusterId, mask, &index) != NULL)
+    {
+        return index;
     }
     return 0xFF;
 }
@@ -840,8 +880,15 @@ static uint16_t findClusterEndpointIndex(EndpointId endpoint, ClusterId clusterI
         {
             break;
         }
-        epi = static_cast<uint16_t>(
-            epi + ((emberAfFindClusterIncludingDisabledEndpoints(emAfEndpoints[i].endpoint, clusterId, mask) != NULL) ? 1 : 0));
+        if (emAfEndpoints[i].endpoint == kInvalidEndpointId)
+        {
+            // Unused dynamic endpoint slot.
+            continue;
+        }
+        if (emberAfFindClusterInType(emAfEndpoints[i].endpointType, clusterId, mask) != NULL)
+        {
+            epi++;
+        }
     }
 
     return epi;
@@ -849,16 +896,28 @@ static uint16_t findClusterEndpointIndex(EndpointId endpoint, ClusterId clusterI
 
 static uint16_t findIndexFromEndpoint(EndpointId endpoint, bool ignoreDisabledEndpoints)
 {
-    uint16_t epi;
-    for (epi = 0; epi < emberAfEndpointCount(); epi++)
+    if (endpoint == kInvalidEndpointId)
     {
-        if (emAfEndpoints[epi].endpoint == endpoint &&
+        return 0xFFFF;
+    }
+
+    // The same endpoint id could in theory be defined more than once (a
+    // dynamic endpoint is not checked against the fixed ones), so walk the
+    // whole probe sequence and return the lowest matching index, as a linear
+    // scan of emAfEndpoints would.
+    uint16_t found = 0xFFFF;
+    uint16_t slot  = endpointIndexTableSlot(endpoint);
+    while (endpointIndexTable[slot] != kEndpointIndexTableEmptySlot)
+    {
+        uint16_t epi = endpointIndexTable[slot];
+        if (epi < emberAfEndpointCount() && epi < found && emAfEndpoints[epi].endpoint == endpoint &&
             (!ignoreDisabledEndpoints || emAfEndpoints[epi].bitmask & EMBER_AF_ENDPOINT_ENABLED))
         {
-            return epi;
+            found = epi;
         }
+        slot = static_cast<uint16_t>((slot + 1) & (kEndpointIndexTableSize - 1));
     }
-    return 0xFFFF;
+    return found;
 }
 
 bool emberAfEndpointIsEnabled(EndpointId endpoint)
@@ -1439,10 +1498,8 @@ DataVersion * emberAfDataVersionStorage(chip::EndpointId endpointId, chip::Clust
         return nullptr;
     }
 
-    // This does a second walk over endpoints to find the right one, but
-    // probably worth it to avoid duplicating code.
-    auto clusterIndex = emberAfClusterIndex(endpointId, clusterId, CLUSTER_MASK_SERVER);
-    if (clusterIndex == 0xFF)
+    uint8_t clusterIndex = 0xFF;
+    if (emberAfFindClusterInType(ep.endpointType, clusterId, CLUSTER_MASK_SERVER, &clusterIndex) == nullptr)
     {
         // No such cluster on this endpoint.
         return nullptr;
@@ -141,12 +141,13 @@ CHIP_ERROR DeviceController::Init(ControllerInitParams params)
     }
 
     DeviceProxyInitParams deviceInitParams = {
-        .sessionManager = params.systemState->SessionMgr(),
-        .exchangeMgr    = params.systemState->ExchangeMgr(),
-        .idAllocator    = &mIDAllocator,
-        .fabricTable    = params.systemState->Fabrics(),
-        .clientPool     = &mCASEClientPool,
-        .mrpLocalConfig = Optional<ReliableMessageProtocolConfig>::Value(GetLocalMRPConfig()),
+        .sessionManager         = params.systemState->SessionMgr(),
+        .exchangeMgr            = params.systemState->ExchangeMgr(),
+        .idAllocator            = &mIDAllocator,
+        .fabricTable            = params.systemState->Fabrics(),
+        .clientPool             = &mCASEClientPool,
+        .sessionResumptionCache = &mCASESessionCache,
+        .mrpLocalConfig         = Optional<ReliableMessageProtocolConfig>::Value(GetLocalMRPConfig()),
     };
 
     CASESessionManagerConfig sessionManagerConfig = {
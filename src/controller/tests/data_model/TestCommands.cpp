@@ -151,13 +151,15 @@ InteractionModel::Status ServerClusterCommandExists(const ConcreteCommandPath &
 
 CHIP_ERROR ReadSingleClusterData(const Access::SubjectDescriptor & aSubjectDescriptor, bool aIsFabricFiltered,
                                  const ConcreteReadAttributePath & aPath, AttributeReportIBs::Builder & aAttributeReports,
-                                 AttributeValueEncoder::AttributeEncodeState * apEncoderState)
+                                 AttributeValueEncoder::AttributeEncodeState * apEncoderState,
+                                 Access::AccessControl::CheckBatch & aAccessCheckBatch)
 {
     return CHIP_ERROR_UNSUPPORTED_CHIP_FEATURE;
 }
 
 CHIP_ERROR WriteSingleClusterData(const Access::SubjectDescriptor & aSubjectDescriptor, ClusterInfo & aClusterInfo,
-                                  TLV::TLVReader & aReader, WriteHandler * aWriteHandler)
+                                  TLV::TLVReader & aReader, WriteHandler * aWriteHandler,
+                                  Access::AccessControl::CheckBatch & aAccessCheckBatch)
 {
     return CHIP_ERROR_UNSUPPORTED_CHIP_FEATURE;
 }
@@ -541,6 +541,21 @@ CHIP_ERROR FabricInfo::SetFabricInfo(FabricInfo & newFabric)
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR FabricInfo::CopyCredentialsTo(FabricInfo & copy)
+{
+    copy.Reset();
+    ReturnErrorOnFailure(copy.SetOperationalKeypair(GetOperationalKey()));
+    ReturnErrorOnFailure(copy.SetRootCert(mRootCert));
+    ReturnErrorOnFailure(copy.SetICACert(mICACert));
+    ReturnErrorOnFailure(copy.SetNOCCert(mNOCCert));
+
+    copy.mOperationalId = mOperationalId;
+    copy.mFabric        = mFabric;
+    copy.mFabricId      = mFabricId;
+    copy.mVendorId      = mVendorId;
+    return CHIP_NO_ERROR;
+}
+
 FabricIndex FabricTable::FindDestinationIDCandidate(const ByteSpan & destinationId, const ByteSpan & initiatorRandom,
                                                     const ByteSpan * ipkList, size_t ipkListEntries)
 {
@@ -245,6 +245,12 @@ public:
 
     CHIP_ERROR SetFabricInfo(FabricInfo & fabric);
 
+    /**
+     *  Copy the identity, certificates and operational key of this fabric into copy, which then
+     *  stays usable if this fabric is updated or removed.
+     */
+    CHIP_ERROR CopyCredentialsTo(FabricInfo & copy);
+
     /* Generate a compressed peer ID (containing compressed fabric ID) using provided fabric ID, node ID and
        root public key of the fabric. The generated compressed ID is returned via compressedPeerId
        output parameter */
@@ -877,10 +877,12 @@ struct KeySetData : PersistentData<kPersistentBufferMax>
 
 constexpr size_t GroupDataProvider::GroupInfo::kGroupNameMax;
 constexpr size_t GroupDataProviderImpl::kIteratorsMax;
+constexpr size_t GroupDataProviderImpl::kKeyCacheSize;
 
 CHIP_ERROR GroupDataProviderImpl::Init()
 {
     mInitialized = true;
+    InvalidateKeyCache();
     return CHIP_NO_ERROR;
 }
 
@@ -891,6 +893,7 @@ void GroupDataProviderImpl::Finish()
     mGroupKeyIterators.ReleaseAll();
     mEndpointIterators.ReleaseAll();
     mKeySetIterators.ReleaseAll();
+    InvalidateKeyCache();
 }
 
 //
@@ -1411,6 +1414,8 @@ CHIP_ERROR GroupDataProviderImpl::SetGroupKeyAt(chip::FabricIndex fabric_index,
 {
     VerifyOrReturnError(mInitialized, CHIP_ERROR_INTERNAL);
 
+    InvalidateKeyCache();
+
     FabricData fabric(fabric_index);
     KeyMapData map(fabric_index);
 
@@ -1429,32 +1434,38 @@ CHIP_ERROR GroupDataProviderImpl::SetGroupKeyAt(chip::FabricIndex fabric_index,
     if (found)
     {
         // Update existing map
-        return map.Save(mStorage);
-    }
-
-    // Insert last
-    VerifyOrReturnError(fabric.map_count == index, CHIP_ERROR_INVALID_ARGUMENT);
-    // TODO: VerifyOrReturnError(fabric.map_count < mMaxGroupKeysPerFabric, CHIP_ERROR_INVALID_LIST_LENGTH);
-
-    map.next = 0;
-    ReturnErrorOnFailure(map.Save(mStorage));
-
-    if (map.first)
-    {
-        // First map, update fabric
-        fabric.first_map = map.id;
+        ReturnErrorOnFailure(map.Save(mStorage));
     }
     else
     {
-        // Last map, update previous
-        KeyMapData prev(fabric_index, map.prev);
-        ReturnErrorOnFailure(prev.Load(mStorage));
-        prev.next = map.id;
-        ReturnErrorOnFailure(prev.Save(mStorage));
+        // Insert last
+        VerifyOrReturnError(fabric.map_count == index, CHIP_ERROR_INVALID_ARGUMENT);
+        // TODO: VerifyOrReturnError(fabric.map_count < mMaxGroupKeysPerFabric, CHIP_ERROR_INVALID_LIST_LENGTH);
+
+        map.next = 0;
+        ReturnErrorOnFailure(map.Save(mStorage));
+
+        if (map.first)
+        {
+            // First map, update fabric
+            fabric.first_map = map.id;
+        }
+        else
+        {
+            // Last map, update previous
+            KeyMapData prev(fabric_index, map.prev);
+            ReturnErrorOnFailure(prev.Load(mStorage));
+            prev.next = map.id;
+            ReturnErrorOnFailure(prev.Save(mStorage));
+        }
+        // Update fabric
+        fabric.map_count++;
+        ReturnErrorOnFailure(fabric.Save(mStorage));
     }
-    // Update fabric
-    fabric.map_count++;
-    return fabric.Save(mStorage);
+
+    // Set up the keys of the new mapping now rather than on the first group message
+    LoadKeyCache();
+    return CHIP_NO_ERROR;
 }
 
 CHIP_ERROR GroupDataProviderImpl::GetGroupKeyAt(chip::FabricIndex fabric_index, size_t index, GroupKey & out_map)
@@ -1477,6 +1488,8 @@ CHIP_ERROR GroupDataProviderImpl::RemoveGroupKeyAt(chip::FabricIndex fabric_inde
 {
     VerifyOrReturnError(mInitialized, CHIP_ERROR_INTERNAL);
 
+    InvalidateKeyCache();
+
     FabricData fabric(fabric_index);
     KeyMapData map;
 
@@ -1509,6 +1522,8 @@ CHIP_ERROR GroupDataProviderImpl::RemoveGroupKeys(chip::FabricIndex fabric_index
 {
     VerifyOrReturnError(mInitialized, CHIP_ERROR_INTERNAL);
 
+    InvalidateKeyCache();
+
     FabricData fabric(fabric_index);
     VerifyOrReturnError(CHIP_NO_ERROR == fabric.Load(mStorage), CHIP_ERROR_INVALID_FABRIC_ID);
 
@@ -1584,6 +1599,8 @@ CHIP_ERROR GroupDataProviderImpl::SetKeySet(chip::FabricIndex fabric_index, cons
 {
     VerifyOrReturnError(mInitialized, CHIP_ERROR_INTERNAL);
 
+    InvalidateKeyCache();
+
     FabricData fabric(fabric_index);
     KeySetData keyset;
 
@@ -1613,7 +1630,7 @@ CHIP_ERROR GroupDataProviderImpl::SetKeySet(chip::FabricIndex fabric_index, cons
     if (found)
     {
         // Update existing keyset info, keep next
-        return keyset.Save(mStorage);
+        ReturnErrorOnFailure(keyset.Save(mStorage));
     }
     else
     {
@@ -1623,8 +1640,12 @@ CHIP_ERROR GroupDataProviderImpl::SetKeySet(chip::FabricIndex fabric_index, cons
         // Update fabric
         fabric.keyset_count++;
         fabric.first_keyset = in_keyset.keyset_id;
-        return fabric.Save(mStorage);
+        ReturnErrorOnFailure(fabric.Save(mStorage));
     }
+
+    // Set up the new keys now rather than on the first group message
+    LoadKeyCache();
+    return CHIP_NO_ERROR;
 }
 
 CHIP_ERROR GroupDataProviderImpl::GetKeySet(chip::FabricIndex fabric_index, uint16_t target_id, KeySet & out_keyset)
@@ -1653,6 +1674,8 @@ CHIP_ERROR GroupDataProviderImpl::RemoveKeySet(chip::FabricIndex fabric_index, u
 {
     VerifyOrReturnError(mInitialized, CHIP_ERROR_INTERNAL);
 
+    InvalidateKeyCache();
+
     FabricData fabric(fabric_index);
     KeySetData keyset;
 
@@ -1737,6 +1760,8 @@ CHIP_ERROR GroupDataProviderImpl::RemoveFabric(chip::FabricIndex fabric_index)
 {
     FabricData fabric(fabric_index);
 
+    InvalidateKeyCache();
+
     // Fabric data defaults to zero, so if not entry is found, no mappings, or keys are removed
     // However, states has a separate list, and needs to be removed regardless
     CHIP_ERROR err = fabric.Load(mStorage);
@@ -1783,6 +1808,30 @@ CHIP_ERROR GroupDataProviderImpl::RemoveFabric(chip::FabricIndex fabric_index)
 
 Crypto::SymmetricKeyContext * GroupDataProviderImpl::GetKeyContext(FabricIndex fabric_index, GroupId group_id)
 {
+    if (LoadKeyCache())
+    {
+        // The current key of the first mapping of the group, as found by the walk through storage below
+        const CachedGroupKey * found = nullptr;
+        size_t found_index           = 0;
+        for (size_t i = 0; i < mKeyCacheCount; ++i)
+        {
+            const CachedGroupKey & entry = mKeyCache[i];
+            // GroupKeySetID of 0 is reserved for the Identity Protection Key (IPK)
+            if (entry.current && entry.keyset_id > 0 && entry.fabric_index == fabric_index && entry.group_id == group_id &&
+                (nullptr == found || entry.order < found->order))
+            {
+                found       = &entry;
+                found_index = i;
+            }
+        }
+        VerifyOrReturnError(nullptr != found, nullptr);
+
+        GroupKeyContext * context = mKeyContexPool.CreateObject(*this, ByteSpan(found->value), found->session_id);
+        VerifyOrReturnError(nullptr != context, nullptr);
+        context->SetCachedCipher(&mKeyCacheCiphers[found_index], mKeyCacheGeneration);
+        return context;
+    }
+
     FabricData fabric(fabric_index);
     VerifyOrReturnError(CHIP_NO_ERROR == fabric.Load(mStorage), nullptr);
 
@@ -1797,7 +1846,11 @@ Crypto::SymmetricKeyContext * GroupDataProviderImpl::GetKeyContext(FabricIndex f
         {
             // Group found, get the keyset
             KeySetData keyset;
-            VerifyOrReturnError(keyset.Find(mStorage, fabric, mapping.keyset_id), nullptr);
+            if (!keyset.Find(mStorage, fabric, mapping.keyset_id))
+            {
+                // Mapped to a keyset that is not set yet
+                continue;
+            }
             OperationalKey * key = keyset.GetCurrentKey();
             if (nullptr != key)
             {
@@ -1812,14 +1865,27 @@ Crypto::SymmetricKeyContext * GroupDataProviderImpl::GetKeyContext(FabricIndex f
 void GroupDataProviderImpl::GroupKeyContext::Release()
 {
     memset(mKeyValue, 0, sizeof(mKeyValue));
+    mCipher = nullptr;
     mProvider.mKeyContexPool.ReleaseObject(this);
 }
 
+Crypto::AesCcmKeyContext * GroupDataProviderImpl::GroupKeyContext::GetCachedCipher() const
+{
+    // The cipher belongs to the key cache, and goes away when the cache is dropped
+    return (mCipherGeneration == mProvider.mKeyCacheGeneration) ? mCipher : nullptr;
+}
+
 CHIP_ERROR GroupDataProviderImpl::GroupKeyContext::EncryptMessage(const ByteSpan & plaintext, const ByteSpan & aad,
                                                                   const ByteSpan & nonce, MutableByteSpan & mic,
                                                                   MutableByteSpan & ciphertext) const
 {
-    uint8_t * output = ciphertext.data();
+    uint8_t * output                  = ciphertext.data();
+    Crypto::AesCcmKeyContext * cipher = GetCachedCipher();
+    if (nullptr != cipher)
+    {
+        return cipher->Encrypt(plaintext.data(), plaintext.size(), aad.data(), aad.size(), nonce.data(), nonce.size(), output,
+                               mic.data(), mic.size());
+    }
     return Crypto::AES_CCM_encrypt(plaintext.data(), plaintext.size(), aad.data(), aad.size(), mKeyValue,
                                    Crypto::kAES_CCM128_Key_Length, nonce.data(), nonce.size(), output, mic.data(), mic.size());
 }
@@ -1828,7 +1894,13 @@ CHIP_ERROR GroupDataProviderImpl::GroupKeyContext::DecryptMessage(const ByteSpan
                                                                   const ByteSpan & nonce, const ByteSpan & mic,
                                                                   MutableByteSpan & plaintext) const
 {
-    uint8_t * output = plaintext.data();
+    uint8_t * output                  = plaintext.data();
+    Crypto::AesCcmKeyContext * cipher = GetCachedCipher();
+    if (nullptr != cipher)
+    {
+        return cipher->Decrypt(ciphertext.data(), ciphertext.size(), aad.data(), aad.size(), mic.data(), mic.size(), nonce.data(),
+                               nonce.size(), output);
+    }
     return Crypto::AES_CCM_decrypt(ciphertext.data(), ciphertext.size(), aad.data(), aad.size(), mic.data(), mic.size(), mKeyValue,
                                    Crypto::kAES_CCM128_Key_Length, nonce.data(), nonce.size(), output);
 }
@@ -1854,6 +1926,14 @@ GroupDataProviderImpl::GroupSessionIterator * GroupDataProviderImpl::IterateGrou
 GroupDataProviderImpl::GroupSessionIteratorImpl::GroupSessionIteratorImpl(GroupDataProviderImpl & provider, uint16_t session_id) :
     mProvider(provider), mSessionId(session_id), mKeyContext(provider)
 {
+    if (provider.LoadKeyCache())
+    {
+        mCached          = true;
+        mCacheIndex      = provider.FindFirstCachedKey(session_id);
+        mCacheGeneration = provider.mKeyCacheGeneration;
+        return;
+    }
+
     FabricList fabric_list;
     ReturnOnFailure(fabric_list.Load(provider.mStorage));
     mFirstFabric = fabric_list.first_fabric;
@@ -1866,9 +1946,21 @@ GroupDataProviderImpl::GroupSessionIteratorImpl::GroupSessionIteratorImpl(GroupD
 
 size_t GroupDataProviderImpl::GroupSessionIteratorImpl::Count()
 {
-    FabricData fabric(mFirstFabric);
     size_t count = 0;
 
+    if (mCached)
+    {
+        VerifyOrReturnError(mCacheGeneration == mProvider.mKeyCacheGeneration, 0);
+        for (size_t i = mProvider.FindFirstCachedKey(mSessionId);
+             i < mProvider.mKeyCacheCount && mProvider.mKeyCache[i].session_id == mSessionId; ++i)
+        {
+            count++;
+        }
+        return count;
+    }
+
+    FabricData fabric(mFirstFabric);
+
     for (size_t i = 0; i < mFabricTotal; i++, fabric.fabric_index = fabric.next)
     {
         if (CHIP_NO_ERROR != fabric.Load(mProvider.mStorage))
@@ -1891,7 +1983,8 @@ size_t GroupDataProviderImpl::GroupSessionIteratorImpl::Count()
             KeySetData keyset;
             if (!keyset.Find(mProvider.mStorage, fabric, mapping.keyset_id))
             {
-                break;
+                // Mapped to a keyset that is not set yet
+                continue;
             }
             for (uint16_t k = 0; k < keyset.keys_count; ++k)
             {
@@ -1907,6 +2000,26 @@ size_t GroupDataProviderImpl::GroupSessionIteratorImpl::Count()
 
 bool GroupDataProviderImpl::GroupSessionIteratorImpl::Next(GroupSession & output)
 {
+    if (mCached)
+    {
+        // Stop if the keys changed since the iterator was created
+        VerifyOrReturnError(mCacheGeneration == mProvider.mKeyCacheGeneration, false);
+        VerifyOrReturnError(mCacheIndex < mProvider.mKeyCacheCount, false);
+
+        const CachedGroupKey & entry = mProvider.mKeyCache[mCacheIndex];
+        VerifyOrReturnError(entry.session_id == mSessionId, false);
+
+        mKeyContext.SetKey(ByteSpan(entry.value), mSessionId);
+        mKeyContext.SetCachedCipher(&mProvider.mKeyCacheCiphers[mCacheIndex], mCacheGeneration);
+        mCacheIndex++;
+
+        output.fabric_index    = entry.fabric_index;
+        output.group_id        = entry.group_id;
+        output.security_policy = entry.policy;
+        output.key             = &mKeyContext;
+        return true;
+    }
+
     while (mFabricCount < mFabricTotal)
     {
         FabricData fabric(mFabric);
@@ -1933,11 +2046,9 @@ bool GroupDataProviderImpl::GroupSessionIteratorImpl::Next(GroupSession & output
 
         // Group found, get the keyset
         KeySetData keyset;
-        VerifyOrReturnError(keyset.Find(mProvider.mStorage, fabric, mapping.keyset_id), false);
-
-        if (mKeyIndex >= keyset.keys_count)
+        if (!keyset.Find(mProvider.mStorage, fabric, mapping.keyset_id) || mKeyIndex >= keyset.keys_count)
         {
-            // No more keys in current keyset, try next
+            // No keyset set yet, or no more keys in current keyset, try next
             mMapping = mapping.next;
             mMapCount++;
             mKeyIndex = 0;
@@ -1964,6 +2075,132 @@ void GroupDataProviderImpl::GroupSessionIteratorImpl::Release()
     mProvider.mGroupSessionsIterator.ReleaseObject(this);
 }
 
+//
+// Key cache
+//
+
+void GroupDataProviderImpl::SetKeyCacheEnabled(bool enabled)
+{
+    mKeyCacheState = (enabled && kKeyCacheSize > 0) ? KeyCacheState::kStale : KeyCacheState::kDisabled;
+    InvalidateKeyCache();
+}
+
+void GroupDataProviderImpl::InvalidateKeyCache()
+{
+    for (size_t i = 0; i < mKeyCacheCount; ++i)
+    {
+        mKeyCacheCiphers[i].Clear();
+    }
+    Crypto::ClearSecretData(reinterpret_cast<uint8_t *>(mKeyCache), sizeof(mKeyCache));
+    mKeyCacheCount = 0;
+    mKeyCacheGeneration++;
+
+    if (KeyCacheState::kDisabled != mKeyCacheState)
+    {
+        mKeyCacheState = KeyCacheState::kStale;
+    }
+}
+
+bool GroupDataProviderImpl::LoadKeyCache()
+{
+    VerifyOrReturnError(KeyCacheState::kValid != mKeyCacheState, true);
+    VerifyOrReturnError(KeyCacheState::kStale == mKeyCacheState, false);
+
+    InvalidateKeyCache();
+
+    FabricList fabric_list;
+    CHIP_ERROR err = fabric_list.Load(mStorage);
+    VerifyOrReturnError(CHIP_NO_ERROR == err || CHIP_ERROR_NOT_FOUND == err, false);
+
+    FabricData fabric(fabric_list.first_fabric);
+    uint16_t order = 0;
+
+    for (size_t i = 0; i < fabric_list.fabric_count; i++, fabric.fabric_index = fabric.next)
+    {
+        VerifyOrReturnError(CHIP_NO_ERROR == fabric.Load(mStorage), false);
+
+        KeyMapData mapping(fabric.fabric_index, fabric.first_map);
+        for (uint16_t j = 0; j < fabric.map_count; ++j, mapping.id = mapping.next)
+        {
+            VerifyOrReturnError(CHIP_NO_ERROR == mapping.Load(mStorage), false);
+
+            KeySetData keyset;
+            if (!keyset.Find(mStorage, fabric, mapping.keyset_id))
+            {
+                // Mapped to a keyset that is not set yet
+                continue;
+            }
+
+            const OperationalKey * current = keyset.GetCurrentKey();
+            for (uint16_t k = 0; k < keyset.keys_count && k < KeySet::kEpochKeysMax; ++k)
+            {
+                if (mKeyCacheCount >= kKeyCacheSize)
+                {
+                    InvalidateKeyCache();
+                    mKeyCacheState = KeyCacheState::kOverflow;
+                    return false;
+                }
+
+                const OperationalKey & key = keyset.operational_keys[k];
+                CachedGroupKey & entry     = mKeyCache[mKeyCacheCount++];
+                entry.session_id           = key.hash;
+                entry.order                = order++;
+                entry.fabric_index         = fabric.fabric_index;
+                entry.group_id             = mapping.group_id;
+                entry.keyset_id            = mapping.keyset_id;
+                entry.policy               = keyset.policy;
+                entry.current              = (&key == current);
+                memcpy(entry.value, key.value, sizeof(entry.value));
+            }
+        }
+    }
+
+    // Sort by session id, keeping the mapping order of each session id. The cache is small, and insertion sort does not need
+    // any scratch memory.
+    for (size_t i = 1; i < mKeyCacheCount; ++i)
+    {
+        CachedGroupKey entry = mKeyCache[i];
+        size_t j             = i;
+        for (; j > 0 && mKeyCache[j - 1].session_id > entry.session_id; --j)
+        {
+            mKeyCache[j] = mKeyCache[j - 1];
+        }
+        mKeyCache[j] = entry;
+        Crypto::ClearSecretData(entry.value, sizeof(entry.value));
+    }
+
+    for (size_t i = 0; i < mKeyCacheCount; ++i)
+    {
+        if (CHIP_NO_ERROR != mKeyCacheCiphers[i].Init(mKeyCache[i].value, sizeof(mKeyCache[i].value)))
+        {
+            InvalidateKeyCache();
+            return false;
+        }
+    }
+
+    mKeyCacheState = KeyCacheState::kValid;
+    return true;
+}
+
+size_t GroupDataProviderImpl::FindFirstCachedKey(uint16_t session_id) const
+{
+    size_t low  = 0;
+    size_t high = mKeyCacheCount;
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+        if (mKeyCache[mid].session_id < session_id)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
 namespace {
 
 GroupDataProvider * gGroupsProvider = nullptr;
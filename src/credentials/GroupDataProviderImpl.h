@@ -27,6 +27,7 @@ class GroupDataProviderImpl : public GroupDataProvider
 {
 public:
     static constexpr size_t kIteratorsMax = CHIP_CONFIG_MAX_GROUP_CONCURRENT_ITERATORS;
+    static constexpr size_t kKeyCacheSize = CHIP_CONFIG_GROUP_KEY_CACHE_SIZE;
 
     GroupDataProviderImpl(chip::PersistentStorageDelegate & storage_delegate) : mStorage(storage_delegate) {}
     GroupDataProviderImpl(chip::PersistentStorageDelegate & storage_delegate, uint16_t maxGroupsPerFabric,
@@ -86,7 +87,38 @@ public:
     Crypto::SymmetricKeyContext * GetKeyContext(FabricIndex fabric_index, GroupId group_id) override;
     GroupSessionIterator * IterateGroupSessions(uint16_t session_id) override;
 
+    /**
+     * Enable or disable the in-memory cache of operational group keys. The cache is enabled by default when
+     * CHIP_CONFIG_GROUP_KEY_CACHE_SIZE is not zero; without it, each group session lookup walks the stored fabrics, mappings
+     * and keysets.
+     */
+    void SetKeyCacheEnabled(bool enabled);
+
 protected:
+    /**
+     * An operational group key of a keyset-group mapping. The key cache holds one per epoch key of each mapping, sorted by
+     * session id (and by mapping order for the same session id).
+     */
+    struct CachedGroupKey
+    {
+        uint16_t session_id;
+        uint16_t order;
+        FabricIndex fabric_index;
+        GroupId group_id;
+        KeysetId keyset_id;
+        SecurityPolicy policy;
+        bool current;
+        uint8_t value[Crypto::CHIP_CRYPTO_SYMMETRIC_KEY_LENGTH_BYTES];
+    };
+
+    enum class KeyCacheState : uint8_t
+    {
+        kStale,    /**< Must be loaded from storage before use. */
+        kValid,    /**< Matches the stored keysets and mappings. */
+        kOverflow, /**< The stored mappings need more than kKeyCacheSize entries; lookups go to storage. */
+        kDisabled, /**< Lookups go to storage. */
+    };
+
     class GroupInfoIteratorImpl : public GroupInfoIterator
     {
     public:
@@ -154,6 +186,14 @@ protected:
         {
             mKeyHash = hash;
             memcpy(mKeyValue, key.data(), std::min(key.size(), sizeof(mKeyValue)));
+            mCipher = nullptr;
+        }
+
+        // Use a cipher of the key cache, already set up for the key, for as long as the cache is not reloaded.
+        void SetCachedCipher(Crypto::AesCcmKeyContext * cipher, uint32_t generation)
+        {
+            mCipher           = cipher;
+            mCipherGeneration = generation;
         }
 
         uint16_t GetKeyHash() override { return mKeyHash; }
@@ -170,9 +210,13 @@ protected:
         void Release() override;
 
     protected:
+        Crypto::AesCcmKeyContext * GetCachedCipher() const;
+
         GroupDataProviderImpl & mProvider;
         uint16_t mKeyHash                                                 = 0;
         uint8_t mKeyValue[Crypto::CHIP_CRYPTO_SYMMETRIC_KEY_LENGTH_BYTES] = { 0 };
+        Crypto::AesCcmKeyContext * mCipher                                = nullptr;
+        uint32_t mCipherGeneration                                        = 0;
     };
 
     class KeySetIteratorImpl : public KeySetIterator
@@ -212,9 +256,20 @@ protected:
         uint16_t mKeyCount       = 0;
         bool mFirstMap           = true;
         GroupKeyContext mKeyContext;
+
+        // Position in the key cache, if it was valid when the iterator was created.
+        bool mCached              = false;
+        size_t mCacheIndex        = 0;
+        uint32_t mCacheGeneration = 0;
     };
     CHIP_ERROR RemoveEndpoints(FabricIndex fabric_index, GroupId group_id);
 
+    // Make sure the key cache matches storage, loading it if needed. Returns false if lookups have to go to storage.
+    bool LoadKeyCache();
+    // Drop the cached keys, to be loaded again on the next lookup. Called before any change to keysets or mappings.
+    void InvalidateKeyCache();
+    size_t FindFirstCachedKey(uint16_t session_id) const;
+
     chip::PersistentStorageDelegate & mStorage;
     bool mInitialized = false;
     ObjectPool<GroupInfoIteratorImpl, kIteratorsMax> mGroupInfoIterators;
@@ -223,6 +278,16 @@ protected:
     ObjectPool<KeySetIteratorImpl, kIteratorsMax> mKeySetIterators;
     ObjectPool<GroupSessionIteratorImpl, kIteratorsMax> mGroupSessionsIterator;
     ObjectPool<GroupKeyContext, kIteratorsMax> mKeyContexPool;
+
+    // Operational keys of all the keyset-group mappings, with a cipher set up for each, so that group messages do not have to
+    // read storage or expand a key. The generation changes whenever the cache is dropped, so that key contexts handed out
+    // earlier stop using its ciphers.
+    static constexpr size_t kKeyCacheCapacity = (kKeyCacheSize > 0) ? kKeyCacheSize : 1;
+    KeyCacheState mKeyCacheState              = (kKeyCacheSize > 0) ? KeyCacheState::kStale : KeyCacheState::kDisabled;
+    size_t mKeyCacheCount                     = 0;
+    uint32_t mKeyCacheGeneration              = 0;
+    CachedGroupKey mKeyCache[kKeyCacheCapacity];
+    Crypto::AesCcmKeyContext mKeyCacheCiphers[kKeyCacheCapacity];
 };
 
 } // namespace Credentials
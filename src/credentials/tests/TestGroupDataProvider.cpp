@@ -21,9 +21,11 @@
 #include <lib/support/CHIPMem.h>
 #include <lib/support/TestPersistentStorageDelegate.h>
 #include <lib/support/UnitTestRegistration.h>
+#include <lib/support/logging/CHIPLogging.h>
 #include <nlunit-test.h>
 #include <platform/KeyValueStoreManager.h>
 #include <set>
+#include <system/SystemClock.h>
 #include <string.h>
 #include <tuple>
 #include <utility>
@@ -1105,6 +1107,191 @@ void TestGroupDecryption(nlTestSuite * apSuite, void * apContext)
     }
 }
 
+// Encrypts kMessage with the current key of the given group, then decrypts it with every group session that matches,
+// returning the number of sessions that decrypted it.
+size_t EncryptAndDecrypt(nlTestSuite * apSuite, GroupDataProvider * provider, FabricIndex fabric_index, GroupId group_id,
+                         uint16_t & session_id)
+{
+    const uint8_t kMessage[10] = { 0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9 };
+    const uint8_t nonce[13]    = { 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x18, 0x1a, 0x1b, 0x1c };
+    const uint8_t aad[8]       = { 0x0a, 0x1a, 0x2a, 0x3a, 0x4a, 0x5a, 0x6a, 0x7a };
+    uint8_t mic[16]            = { 0 };
+    uint8_t ciphertext_buffer[sizeof(kMessage)];
+    uint8_t plaintext_buffer[sizeof(kMessage)];
+    MutableByteSpan ciphertext(ciphertext_buffer);
+    MutableByteSpan plaintext(plaintext_buffer);
+    MutableByteSpan tag(mic);
+
+    Crypto::SymmetricKeyContext * key_context = provider->GetKeyContext(fabric_index, group_id);
+    NL_TEST_ASSERT(apSuite, nullptr != key_context);
+    VerifyOrReturnError(nullptr != key_context, 0);
+    session_id = key_context->GetKeyHash();
+    NL_TEST_ASSERT(apSuite,
+                   CHIP_NO_ERROR ==
+                       key_context->EncryptMessage(ByteSpan(kMessage), ByteSpan(aad), ByteSpan(nonce), tag, ciphertext));
+    key_context->Release();
+
+    size_t count = 0;
+    GroupSession session;
+    auto it = provider->IterateGroupSessions(session_id);
+    NL_TEST_ASSERT(apSuite, it);
+    VerifyOrReturnError(it, 0);
+    while (it->Next(session))
+    {
+        if (CHIP_NO_ERROR == session.key->DecryptMessage(ciphertext, ByteSpan(aad), ByteSpan(nonce), tag, plaintext))
+        {
+            NL_TEST_ASSERT(apSuite, session.fabric_index == fabric_index && session.group_id == group_id);
+            NL_TEST_ASSERT(apSuite, 0 == memcmp(plaintext.data(), kMessage, sizeof(kMessage)));
+            count++;
+        }
+    }
+    it->Release();
+    return count;
+}
+
+size_t CountGroupSessions(GroupDataProvider * provider, uint16_t session_id)
+{
+    auto it = provider->IterateGroupSessions(session_id);
+    VerifyOrReturnError(it, 0);
+    size_t count = it->Count();
+    it->Release();
+    return count;
+}
+
+void TestGroupKeyCache(nlTestSuite * apSuite, void * apContext)
+{
+    GroupDataProviderImpl * provider = static_cast<GroupDataProviderImpl *>(GetGroupDataProvider());
+    NL_TEST_ASSERT(apSuite, provider);
+
+    // Reset test
+    provider->RemoveFabric(kFabric1);
+    provider->RemoveFabric(kFabric2);
+
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetKeySet(kFabric1, kKeySet2));
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetKeySet(kFabric2, kKeySet1));
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetKeySet(kFabric2, kKeySet3));
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetGroupKeyAt(kFabric1, 0, kGroup1Keyset2));
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetGroupKeyAt(kFabric2, 0, kGroup2Keyset1));
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetGroupKeyAt(kFabric2, 1, kGroup3Keyset3));
+
+    // Lookups through the cache and through storage must agree
+    uint16_t session1 = 0, session2 = 0, session3 = 0;
+    for (bool enabled : { true, false })
+    {
+        provider->SetKeyCacheEnabled(enabled);
+        NL_TEST_ASSERT(apSuite, 1 == EncryptAndDecrypt(apSuite, provider, kFabric1, kGroup1, session1));
+        NL_TEST_ASSERT(apSuite, 1 == EncryptAndDecrypt(apSuite, provider, kFabric2, kGroup2, session2));
+        NL_TEST_ASSERT(apSuite, 1 == EncryptAndDecrypt(apSuite, provider, kFabric2, kGroup3, session3));
+        NL_TEST_ASSERT(apSuite, 1 == CountGroupSessions(provider, session1));
+        NL_TEST_ASSERT(apSuite, 1 == CountGroupSessions(provider, session2));
+        NL_TEST_ASSERT(apSuite, 1 == CountGroupSessions(provider, session3));
+        NL_TEST_ASSERT(apSuite, nullptr == provider->GetKeyContext(kFabric1, kGroup2));
+    }
+    provider->SetKeyCacheEnabled(true);
+
+    // A removed keyset must not decrypt anymore
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->RemoveKeySet(kFabric2, kKeysetId1));
+    NL_TEST_ASSERT(apSuite, 0 == CountGroupSessions(provider, session2));
+    NL_TEST_ASSERT(apSuite, nullptr == provider->GetKeyContext(kFabric2, kGroup2));
+    NL_TEST_ASSERT(apSuite, 1 == CountGroupSessions(provider, session3));
+
+    // Neither must a removed mapping
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->RemoveGroupKeyAt(kFabric2, 1));
+    NL_TEST_ASSERT(apSuite, 0 == CountGroupSessions(provider, session3));
+    NL_TEST_ASSERT(apSuite, nullptr == provider->GetKeyContext(kFabric2, kGroup3));
+
+    // A cached iterator stops when the keys change under it
+    auto it = provider->IterateGroupSessions(session1);
+    NL_TEST_ASSERT(apSuite, it);
+    if (it)
+    {
+        GroupSession session;
+        NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetKeySet(kFabric2, kKeySet1));
+        NL_TEST_ASSERT(apSuite, GroupDataProviderImpl::kKeyCacheSize == 0 || !it->Next(session));
+        it->Release();
+    }
+    NL_TEST_ASSERT(apSuite, 1 == CountGroupSessions(provider, session1));
+
+    // Restoring a mapping restores its sessions
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetGroupKeyAt(kFabric2, 1, kGroup3Keyset3));
+    NL_TEST_ASSERT(apSuite, 1 == EncryptAndDecrypt(apSuite, provider, kFabric2, kGroup2, session2));
+    NL_TEST_ASSERT(apSuite, 1 == EncryptAndDecrypt(apSuite, provider, kFabric2, kGroup3, session3));
+}
+
+/**
+ * Measures the rate of incoming group messages that can be matched to a session and decrypted, with the key cache and with
+ * every lookup going through storage.
+ */
+void BenchmarkGroupDecryption(nlTestSuite * apSuite, void * apContext)
+{
+    constexpr uint32_t kMessageCount = 2000;
+
+    GroupDataProviderImpl * provider = static_cast<GroupDataProviderImpl *>(GetGroupDataProvider());
+    NL_TEST_ASSERT(apSuite, provider);
+
+    // Reset test
+    provider->RemoveFabric(kFabric1);
+    provider->RemoveFabric(kFabric2);
+
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetKeySet(kFabric1, kKeySet0));
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetKeySet(kFabric1, kKeySet2));
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetKeySet(kFabric2, kKeySet1));
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetKeySet(kFabric2, kKeySet3));
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetGroupKeyAt(kFabric1, 0, kGroup1Keyset2));
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetGroupKeyAt(kFabric1, 1, kGroup3Keyset2));
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetGroupKeyAt(kFabric2, 0, kGroup2Keyset1));
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetGroupKeyAt(kFabric2, 1, kGroup2Keyset3));
+
+    const uint8_t nonce[13] = { 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x18, 0x1a, 0x1b, 0x1c };
+    const uint8_t aad[8]    = { 0x0a, 0x1a, 0x2a, 0x3a, 0x4a, 0x5a, 0x6a, 0x7a };
+    uint8_t message[64]     = { 0 };
+    uint8_t mic[16]         = { 0 };
+    uint8_t ciphertext_buffer[sizeof(message)];
+    uint8_t plaintext_buffer[sizeof(message)];
+    MutableByteSpan ciphertext(ciphertext_buffer);
+    MutableByteSpan tag(mic);
+
+    Crypto::SymmetricKeyContext * key_context = provider->GetKeyContext(kFabric2, kGroup2);
+    NL_TEST_ASSERT(apSuite, nullptr != key_context);
+    VerifyOrReturn(nullptr != key_context);
+    uint16_t session_id = key_context->GetKeyHash();
+    NL_TEST_ASSERT(apSuite,
+                   CHIP_NO_ERROR == key_context->EncryptMessage(ByteSpan(message), ByteSpan(aad), ByteSpan(nonce), tag, ciphertext));
+    key_context->Release();
+
+    uint32_t decrypted[2] = { 0, 0 };
+    for (bool enabled : { false, true })
+    {
+        provider->SetKeyCacheEnabled(enabled);
+
+        System::Clock::Microseconds64 start = System::SystemClock().GetMonotonicMicroseconds64();
+        for (uint32_t i = 0; i < kMessageCount; i++)
+        {
+            GroupSession session;
+            auto it = provider->IterateGroupSessions(session_id);
+            VerifyOrReturn(it, NL_TEST_ASSERT(apSuite, false));
+            while (it->Next(session))
+            {
+                MutableByteSpan plaintext(plaintext_buffer);
+                if (CHIP_NO_ERROR == session.key->DecryptMessage(ciphertext, ByteSpan(aad), ByteSpan(nonce), tag, plaintext))
+                {
+                    decrypted[enabled]++;
+                    break;
+                }
+            }
+            it->Release();
+        }
+        System::Clock::Microseconds64 elapsed = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+        ChipLogProgress(Crypto, "Group decryption x%" PRIu32 " %s key cache: %" PRIu64 "us, %" PRIu64 " msg/s", kMessageCount,
+                        enabled ? "with" : "without", elapsed.count(),
+                        elapsed.count() ? (static_cast<uint64_t>(kMessageCount) * 1000000u / elapsed.count()) : 0);
+    }
+
+    NL_TEST_ASSERT(apSuite, decrypted[0] == kMessageCount);
+    NL_TEST_ASSERT(apSuite, decrypted[1] == kMessageCount);
+}
+
 } // namespace TestGroups
 } // namespace app
 } // namespace chip
@@ -1181,6 +1368,8 @@ const nlTest sTests[] = { NL_TEST_DEF("TestStorageDelegate", chip::app::TestGrou
                           NL_TEST_DEF("TestKeySetIterator", chip::app::TestGroups::TestKeySetIterator),
                           NL_TEST_DEF("TestPerFabricData", chip::app::TestGroups::TestPerFabricData),
                           NL_TEST_DEF("TestGroupDecryption", chip::app::TestGroups::TestGroupDecryption),
+                          NL_TEST_DEF("TestGroupKeyCache", chip::app::TestGroups::TestGroupKeyCache),
+                          NL_TEST_DEF("BenchmarkGroupDecryption", chip::app::TestGroups::BenchmarkGroupDecryption),
                           NL_TEST_SENTINEL() };
 } // namespace
 
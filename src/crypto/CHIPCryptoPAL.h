@@ -92,6 +92,8 @@ constexpr size_t kEmitDerIntegerOverhead           = 3; // Tag + Length byte + 1
 
 constexpr size_t kMAX_Hash_SHA256_Context_Size = CHIP_CONFIG_SHA256_CONTEXT_SIZE;
 
+constexpr size_t kMAX_AES_CCM_Context_Size = CHIP_CONFIG_AES_CCM_CONTEXT_SIZE;
+
 /*
  * Overhead to encode a raw ECDSA signature in X9.62 format in ASN.1 DER
  *
@@ -584,6 +586,89 @@ CHIP_ERROR AES_CCM_decrypt(const uint8_t * ciphertext, size_t ciphertext_length,
                            const uint8_t * tag, size_t tag_length, const uint8_t * key, size_t key_length, const uint8_t * iv,
                            size_t iv_length, uint8_t * plaintext);
 
+struct alignas(size_t) AesCcmOpaqueContext
+{
+    uint8_t mOpaque[kMAX_AES_CCM_Context_Size];
+};
+
+/**
+ * @brief One message of a batch passed to AesCcmKeyContext::EncryptBatch() or AesCcmKeyContext::DecryptBatch().
+ *
+ * The input is the plaintext when encrypting and the ciphertext when decrypting, and output receives the other; they may be
+ * the same buffer. The tag is written when encrypting and checked when decrypting.
+ */
+struct AesCcmMessage
+{
+    const uint8_t * input;
+    size_t length;
+    const uint8_t * aad;
+    size_t aad_length;
+    const uint8_t * iv;
+    uint8_t * output;
+    uint8_t * tag;
+};
+
+/**
+ * @brief An AES-CCM key with the cipher state for it kept between messages.
+ *
+ * AES_CCM_encrypt() and AES_CCM_decrypt() set up a cipher and run the key schedule on every call. An AesCcmKeyContext does
+ * that once, in Init() or on the first message, so that protecting a stream of messages with the same key (such as the
+ * messages of a secure session) only costs the encryption itself. The parameters and results of Encrypt() and Decrypt() are
+ * the same as those of AES_CCM_encrypt() and AES_CCM_decrypt().
+ */
+class AesCcmKeyContext
+{
+public:
+    AesCcmKeyContext();
+    ~AesCcmKeyContext();
+
+    AesCcmKeyContext(const AesCcmKeyContext &) = delete;
+    AesCcmKeyContext & operator=(const AesCcmKeyContext &) = delete;
+
+    /**
+     * @brief Set the key used by later calls to Encrypt() and Decrypt(), replacing any previous one.
+     *
+     * @param key Encryption key
+     * @param key_length Length of encryption key (in bytes)
+     * @return Returns CHIP_ERROR_INVALID_ARGUMENT if the key is null or of an unsupported length, another CHIP_ERROR on other
+     *         errors, CHIP_NO_ERROR otherwise
+     */
+    CHIP_ERROR Init(const uint8_t * key, size_t key_length);
+
+    bool IsInitialized() const { return mInitialized; }
+
+    CHIP_ERROR Encrypt(const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad, size_t aad_length,
+                       const uint8_t * iv, size_t iv_length, uint8_t * ciphertext, uint8_t * tag, size_t tag_length);
+
+    CHIP_ERROR Decrypt(const uint8_t * ciphertext, size_t ciphertext_length, const uint8_t * aad, size_t aad_length,
+                       const uint8_t * tag, size_t tag_length, const uint8_t * iv, size_t iv_length, uint8_t * plaintext);
+
+    /**
+     * @brief Encrypt or decrypt several messages in one call.
+     *
+     * All the messages of a batch use the same nonce and tag lengths, so the cipher is looked up and checked once for the
+     * batch, and an implementation is free to interleave the messages to keep the AES pipeline full. Processing stops at the
+     * first message that fails, whose error is returned; the messages before it have been processed.
+     *
+     * @param messages The messages to process
+     * @param count Number of messages
+     * @param iv_length Length of the nonce of every message (in bytes)
+     * @param tag_length Length of the tag of every message (in bytes)
+     * @return Returns a CHIP_ERROR on error, CHIP_NO_ERROR otherwise
+     */
+    CHIP_ERROR EncryptBatch(AesCcmMessage * messages, size_t count, size_t iv_length, size_t tag_length);
+    CHIP_ERROR DecryptBatch(AesCcmMessage * messages, size_t count, size_t iv_length, size_t tag_length);
+
+    /**
+     * @brief Release the cipher state and clear the key.
+     */
+    void Clear();
+
+private:
+    AesCcmOpaqueContext mContext;
+    bool mInitialized = false;
+};
+
 /**
  * @brief Verify the Certificate Signing Request (CSR). If successfully verified, it outputs the public key from the CSR.
  * @param csr CSR in DER format
@@ -124,16 +124,49 @@ static const EVP_MD * _digestForType(DigestType digestType)
     }
 }
 
-CHIP_ERROR AES_CCM_encrypt(const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad, size_t aad_length,
-                           const uint8_t * key, size_t key_length, const uint8_t * iv, size_t iv_length, uint8_t * ciphertext,
-                           uint8_t * tag, size_t tag_length)
+// Set up a context for AES-CCM with the given key, nonce length and tag length. The nonce is passed with each message.
+static CHIP_ERROR _AES_CCM_setup_context(EVP_CIPHER_CTX * context, bool encrypt, const uint8_t * key, size_t key_length,
+                                         size_t iv_length, size_t tag_length)
+{
+    const int enc = encrypt ? 1 : 0;
+
+    VerifyOrReturnError(key != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(_isValidKeyLength(key_length), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(iv_length > 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(CanCastTo<int>(iv_length), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(_isValidTagLength(tag_length), CHIP_ERROR_INVALID_ARGUMENT);
+
+    // TODO: Remove support for AES-256 since not in 1.0
+    // Determine crypto type by key length
+    const EVP_CIPHER * type = (key_length == kAES_CCM128_Key_Length) ? EVP_aes_128_ccm() : EVP_aes_256_ccm();
+
+    // Pass in cipher
+    int result = EVP_CipherInit_ex(context, type, nullptr, nullptr, nullptr, enc);
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+
+    // Pass in IV length.  Cast is safe because we checked with CanCastTo.
+    result = EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_CCM_SET_IVLEN, static_cast<int>(iv_length), nullptr);
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+
+    // Pass in tag length. Cast is safe because we checked _isValidTagLength.
+    result = EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_CCM_SET_TAG, static_cast<int>(tag_length), nullptr);
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+
+    // Pass in key
+    result = EVP_CipherInit_ex(context, nullptr, nullptr, Uint8::to_const_uchar(key), nullptr, enc);
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+
+    return CHIP_NO_ERROR;
+}
+
+// Encrypt one message with a context set up by _AES_CCM_setup_context(). The context can be reused afterwards.
+static CHIP_ERROR _AES_CCM_encrypt_message(EVP_CIPHER_CTX * context, const uint8_t * plaintext, size_t plaintext_length,
+                                           const uint8_t * aad, size_t aad_length, const uint8_t * iv, uint8_t * ciphertext,
+                                           uint8_t * tag, size_t tag_length)
 {
-    EVP_CIPHER_CTX * context = nullptr;
     int bytesWritten         = 0;
     size_t ciphertext_length = 0;
-    CHIP_ERROR error         = CHIP_NO_ERROR;
     int result               = 1;
-    const EVP_CIPHER * type  = nullptr;
 
     // Placeholder location for avoiding null params for plaintexts when
     // size is zero.
@@ -159,92 +192,56 @@ CHIP_ERROR AES_CCM_encrypt(const uint8_t * plaintext, size_t plaintext_length, c
         }
     }
 
-    VerifyOrExit((key_length == kAES_CCM128_Key_Length) || (key_length == kAES_CCM256_Key_Length),
-                 error = CHIP_ERROR_INVALID_ARGUMENT);
-    VerifyOrExit((plaintext_length != 0) || ciphertext_was_null, error = CHIP_ERROR_INVALID_ARGUMENT);
-    VerifyOrExit(plaintext != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
-    VerifyOrExit(ciphertext != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
-    VerifyOrExit(key != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
-    VerifyOrExit(_isValidKeyLength(key_length), error = CHIP_ERROR_INVALID_ARGUMENT);
-    VerifyOrExit(iv != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
-    VerifyOrExit(iv_length > 0, error = CHIP_ERROR_INVALID_ARGUMENT);
-    VerifyOrExit(CanCastTo<int>(iv_length), error = CHIP_ERROR_INVALID_ARGUMENT);
-    VerifyOrExit(tag != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
-    VerifyOrExit(_isValidTagLength(tag_length), error = CHIP_ERROR_INVALID_ARGUMENT);
-
-    // TODO: Remove support for AES-256 since not in 1.0
-    // Determine crypto type by key length
-    type = (key_length == kAES_CCM128_Key_Length) ? EVP_aes_128_ccm() : EVP_aes_256_ccm();
-
-    context = EVP_CIPHER_CTX_new();
-    VerifyOrExit(context != nullptr, error = CHIP_ERROR_INTERNAL);
-
-    // Pass in cipher
-    result = EVP_EncryptInit_ex(context, type, nullptr, nullptr, nullptr);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
-
-    // Pass in IV length.  Cast is safe because we checked with CanCastTo.
-    result = EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_CCM_SET_IVLEN, static_cast<int>(iv_length), nullptr);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
-
-    // Pass in tag length. Cast is safe because we checked _isValidTagLength.
-    result = EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_CCM_SET_TAG, static_cast<int>(tag_length), nullptr);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    VerifyOrReturnError((plaintext_length != 0) || ciphertext_was_null, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(plaintext != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(ciphertext != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(iv != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(tag != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
 
-    // Pass in key + iv
-    result = EVP_EncryptInit_ex(context, nullptr, nullptr, Uint8::to_const_uchar(key), Uint8::to_const_uchar(iv));
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    // Pass in iv
+    result = EVP_EncryptInit_ex(context, nullptr, nullptr, nullptr, Uint8::to_const_uchar(iv));
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
 
     // Pass in plain text length
-    VerifyOrExit(CanCastTo<int>(plaintext_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(CanCastTo<int>(plaintext_length), CHIP_ERROR_INVALID_ARGUMENT);
     result = EVP_EncryptUpdate(context, nullptr, &bytesWritten, nullptr, static_cast<int>(plaintext_length));
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
 
     // Pass in AAD
     if (aad_length > 0 && aad != nullptr)
     {
-        VerifyOrExit(CanCastTo<int>(aad_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+        VerifyOrReturnError(CanCastTo<int>(aad_length), CHIP_ERROR_INVALID_ARGUMENT);
         result = EVP_EncryptUpdate(context, nullptr, &bytesWritten, Uint8::to_const_uchar(aad), static_cast<int>(aad_length));
-        VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+        VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
     }
 
     // Encrypt
-    VerifyOrExit(CanCastTo<int>(plaintext_length), error = CHIP_ERROR_INVALID_ARGUMENT);
     result = EVP_EncryptUpdate(context, Uint8::to_uchar(ciphertext), &bytesWritten, Uint8::to_const_uchar(plaintext),
                                static_cast<int>(plaintext_length));
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
-    VerifyOrExit((ciphertext_was_null && bytesWritten == 0) || (bytesWritten >= 0), error = CHIP_ERROR_INTERNAL);
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+    VerifyOrReturnError((ciphertext_was_null && bytesWritten == 0) || (bytesWritten >= 0), CHIP_ERROR_INTERNAL);
     ciphertext_length = static_cast<unsigned int>(bytesWritten);
 
     // Finalize encryption
     result = EVP_EncryptFinal_ex(context, ciphertext + ciphertext_length, &bytesWritten);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
-    VerifyOrExit(bytesWritten >= 0 && bytesWritten <= static_cast<int>(plaintext_length), error = CHIP_ERROR_INTERNAL);
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+    VerifyOrReturnError(bytesWritten >= 0 && bytesWritten <= static_cast<int>(plaintext_length), CHIP_ERROR_INTERNAL);
 
     // Get tag
-    VerifyOrExit(CanCastTo<int>(tag_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(CanCastTo<int>(tag_length), CHIP_ERROR_INVALID_ARGUMENT);
     result = EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_CCM_GET_TAG, static_cast<int>(tag_length), Uint8::to_uchar(tag));
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
-
-exit:
-    if (context != nullptr)
-    {
-        EVP_CIPHER_CTX_free(context);
-        context = nullptr;
-    }
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
 
-    return error;
+    return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR AES_CCM_decrypt(const uint8_t * ciphertext, size_t ciphertext_length, const uint8_t * aad, size_t aad_length,
-                           const uint8_t * tag, size_t tag_length, const uint8_t * key, size_t key_length, const uint8_t * iv,
-                           size_t iv_length, uint8_t * plaintext)
+// Decrypt and verify one message with a context set up by _AES_CCM_setup_context(). The context can be reused afterwards.
+static CHIP_ERROR _AES_CCM_decrypt_message(EVP_CIPHER_CTX * context, const uint8_t * ciphertext, size_t ciphertext_length,
+                                           const uint8_t * aad, size_t aad_length, const uint8_t * tag, size_t tag_length,
+                                           const uint8_t * iv, uint8_t * plaintext)
 {
-    EVP_CIPHER_CTX * context = nullptr;
-    CHIP_ERROR error         = CHIP_NO_ERROR;
-    int bytesOutput          = 0;
-    int result               = 1;
-    const EVP_CIPHER * type  = nullptr;
+    int bytesOutput = 0;
+    int result      = 1;
 
     // Placeholder location for avoiding null params for ciphertext when
     // size is zero.
@@ -270,80 +267,251 @@ CHIP_ERROR AES_CCM_decrypt(const uint8_t * ciphertext, size_t ciphertext_length,
         }
     }
 
-    VerifyOrExit((key_length == kAES_CCM128_Key_Length) || (key_length == kAES_CCM256_Key_Length),
-                 error = CHIP_ERROR_INVALID_ARGUMENT);
-    VerifyOrExit(ciphertext != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
-    VerifyOrExit(plaintext != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
-    VerifyOrExit(tag != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
-    VerifyOrExit(_isValidTagLength(tag_length), error = CHIP_ERROR_INVALID_ARGUMENT);
-    VerifyOrExit(key != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
-    VerifyOrExit(_isValidKeyLength(key_length), error = CHIP_ERROR_INVALID_ARGUMENT);
-    VerifyOrExit(iv != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
-    VerifyOrExit(iv_length > 0, error = CHIP_ERROR_INVALID_ARGUMENT);
-
-    // TODO: Remove support for AES-256 since not in 1.0
-    // Determine crypto type by key length
-    type = (key_length == kAES_CCM128_Key_Length) ? EVP_aes_128_ccm() : EVP_aes_256_ccm();
-
-    context = EVP_CIPHER_CTX_new();
-    VerifyOrExit(context != nullptr, error = CHIP_ERROR_INTERNAL);
-
-    // Pass in cipher
-    result = EVP_DecryptInit_ex(context, type, nullptr, nullptr, nullptr);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
-
-    // Pass in IV length
-    VerifyOrExit(CanCastTo<int>(iv_length), error = CHIP_ERROR_INVALID_ARGUMENT);
-    result = EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_CCM_SET_IVLEN, static_cast<int>(iv_length), nullptr);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    VerifyOrReturnError(ciphertext != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(plaintext != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(tag != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(iv != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
 
     // Pass in expected tag
     // Removing "const" from |tag| here should hopefully be safe as
     // we're writing the tag, not reading.
-    VerifyOrExit(CanCastTo<int>(tag_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(CanCastTo<int>(tag_length), CHIP_ERROR_INVALID_ARGUMENT);
     result = EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_CCM_SET_TAG, static_cast<int>(tag_length),
                                  const_cast<void *>(static_cast<const void *>(tag)));
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
 
-    // Pass in key + iv
-    result = EVP_DecryptInit_ex(context, nullptr, nullptr, Uint8::to_const_uchar(key), Uint8::to_const_uchar(iv));
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    // Pass in iv
+    result = EVP_DecryptInit_ex(context, nullptr, nullptr, nullptr, Uint8::to_const_uchar(iv));
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
 
     // Pass in cipher text length
-    VerifyOrExit(CanCastTo<int>(ciphertext_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(CanCastTo<int>(ciphertext_length), CHIP_ERROR_INVALID_ARGUMENT);
     result = EVP_DecryptUpdate(context, nullptr, &bytesOutput, nullptr, static_cast<int>(ciphertext_length));
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
-    VerifyOrExit(bytesOutput <= static_cast<int>(ciphertext_length), error = CHIP_ERROR_INTERNAL);
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+    VerifyOrReturnError(bytesOutput <= static_cast<int>(ciphertext_length), CHIP_ERROR_INTERNAL);
 
     // Pass in aad
     if (aad_length > 0 && aad != nullptr)
     {
-        VerifyOrExit(CanCastTo<int>(aad_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+        VerifyOrReturnError(CanCastTo<int>(aad_length), CHIP_ERROR_INVALID_ARGUMENT);
         result = EVP_DecryptUpdate(context, nullptr, &bytesOutput, Uint8::to_const_uchar(aad), static_cast<int>(aad_length));
-        VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
-        VerifyOrExit(bytesOutput <= static_cast<int>(aad_length), error = CHIP_ERROR_INTERNAL);
+        VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+        VerifyOrReturnError(bytesOutput <= static_cast<int>(aad_length), CHIP_ERROR_INTERNAL);
     }
 
     // Pass in ciphertext. We wont get anything if validation fails.
-    VerifyOrExit(CanCastTo<int>(ciphertext_length), error = CHIP_ERROR_INVALID_ARGUMENT);
     result = EVP_DecryptUpdate(context, Uint8::to_uchar(plaintext), &bytesOutput, Uint8::to_const_uchar(ciphertext),
                                static_cast<int>(ciphertext_length));
     if (plaintext_was_null)
     {
-        VerifyOrExit(bytesOutput <= static_cast<int>(sizeof(placeholder_plaintext)), error = CHIP_ERROR_INTERNAL);
+        VerifyOrReturnError(bytesOutput <= static_cast<int>(sizeof(placeholder_plaintext)), CHIP_ERROR_INTERNAL);
     }
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
 
-exit:
-    if (context != nullptr)
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR AES_CCM_encrypt(const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad, size_t aad_length,
+                           const uint8_t * key, size_t key_length, const uint8_t * iv, size_t iv_length, uint8_t * ciphertext,
+                           uint8_t * tag, size_t tag_length)
+{
+    VerifyOrReturnError(iv != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(tag != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    EVP_CIPHER_CTX * context = EVP_CIPHER_CTX_new();
+    VerifyOrReturnError(context != nullptr, CHIP_ERROR_INTERNAL);
+
+    CHIP_ERROR error = _AES_CCM_setup_context(context, true, key, key_length, iv_length, tag_length);
+    if (error == CHIP_NO_ERROR)
     {
-        EVP_CIPHER_CTX_free(context);
-        context = nullptr;
+        error = _AES_CCM_encrypt_message(context, plaintext, plaintext_length, aad, aad_length, iv, ciphertext, tag, tag_length);
+    }
+
+    EVP_CIPHER_CTX_free(context);
+    return error;
+}
+
+CHIP_ERROR AES_CCM_decrypt(const uint8_t * ciphertext, size_t ciphertext_length, const uint8_t * aad, size_t aad_length,
+                           const uint8_t * tag, size_t tag_length, const uint8_t * key, size_t key_length, const uint8_t * iv,
+                           size_t iv_length, uint8_t * plaintext)
+{
+    VerifyOrReturnError(iv != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(tag != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    EVP_CIPHER_CTX * context = EVP_CIPHER_CTX_new();
+    VerifyOrReturnError(context != nullptr, CHIP_ERROR_INTERNAL);
+
+    CHIP_ERROR error = _AES_CCM_setup_context(context, false, key, key_length, iv_length, tag_length);
+    if (error == CHIP_NO_ERROR)
+    {
+        error = _AES_CCM_decrypt_message(context, ciphertext, ciphertext_length, aad, aad_length, tag, tag_length, iv, plaintext);
     }
 
+    EVP_CIPHER_CTX_free(context);
     return error;
 }
 
+namespace {
+
+// State of an AesCcmKeyContext: one cipher context per direction, each created on first use and set up for the nonce and tag
+// lengths of the messages it has processed so far, since OpenSSL fixes those when the key is set.
+struct AesCcmKeyContextState
+{
+    struct Cipher
+    {
+        EVP_CIPHER_CTX * mContext;
+        uint8_t mIvLength;
+        uint8_t mTagLength;
+    };
+
+    Cipher mEncrypt;
+    Cipher mDecrypt;
+    uint8_t mKey[kAES_CCM256_Key_Length];
+    uint8_t mKeyLength;
+};
+
+} // namespace
+
+static_assert(kMAX_AES_CCM_Context_Size >= sizeof(AesCcmKeyContextState),
+              "kMAX_AES_CCM_Context_Size is too small for the size of underlying AesCcmKeyContextState");
+
+static inline AesCcmKeyContextState * to_inner_aes_ccm_context(AesCcmOpaqueContext * context)
+{
+    return SafePointerCast<AesCcmKeyContextState *>(context);
+}
+
+static CHIP_ERROR _AES_CCM_get_cipher(AesCcmKeyContextState * state, bool encrypt, size_t iv_length, size_t tag_length,
+                                      EVP_CIPHER_CTX *& out_context)
+{
+    AesCcmKeyContextState::Cipher & cipher = encrypt ? state->mEncrypt : state->mDecrypt;
+
+    if (cipher.mContext != nullptr && cipher.mIvLength == iv_length && cipher.mTagLength == tag_length)
+    {
+        out_context = cipher.mContext;
+        return CHIP_NO_ERROR;
+    }
+
+    if (cipher.mContext == nullptr)
+    {
+        cipher.mContext = EVP_CIPHER_CTX_new();
+        VerifyOrReturnError(cipher.mContext != nullptr, CHIP_ERROR_NO_MEMORY);
+    }
+    else
+    {
+        EVP_CIPHER_CTX_reset(cipher.mContext);
+    }
+
+    CHIP_ERROR error = _AES_CCM_setup_context(cipher.mContext, encrypt, state->mKey, state->mKeyLength, iv_length, tag_length);
+    if (error != CHIP_NO_ERROR)
+    {
+        EVP_CIPHER_CTX_free(cipher.mContext);
+        cipher.mContext = nullptr;
+        return error;
+    }
+
+    // Casts are safe because OpenSSL only accepts CCM nonces of 7 to 13 bytes, and we checked _isValidTagLength.
+    cipher.mIvLength  = static_cast<uint8_t>(iv_length);
+    cipher.mTagLength = static_cast<uint8_t>(tag_length);
+    out_context       = cipher.mContext;
+    return CHIP_NO_ERROR;
+}
+
+AesCcmKeyContext::AesCcmKeyContext()
+{
+    memset(&mContext, 0, sizeof(mContext));
+}
+
+AesCcmKeyContext::~AesCcmKeyContext()
+{
+    Clear();
+}
+
+CHIP_ERROR AesCcmKeyContext::Init(const uint8_t * key, size_t key_length)
+{
+    VerifyOrReturnError(key != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(_isValidKeyLength(key_length), CHIP_ERROR_INVALID_ARGUMENT);
+
+    Clear();
+
+    AesCcmKeyContextState * const state = to_inner_aes_ccm_context(&mContext);
+    memcpy(state->mKey, key, key_length);
+    state->mKeyLength = static_cast<uint8_t>(key_length);
+    mInitialized      = true;
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR AesCcmKeyContext::Encrypt(const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad, size_t aad_length,
+                                     const uint8_t * iv, size_t iv_length, uint8_t * ciphertext, uint8_t * tag, size_t tag_length)
+{
+    EVP_CIPHER_CTX * context = nullptr;
+
+    VerifyOrReturnError(mInitialized, CHIP_ERROR_INCORRECT_STATE);
+    ReturnErrorOnFailure(_AES_CCM_get_cipher(to_inner_aes_ccm_context(&mContext), true, iv_length, tag_length, context));
+
+    return _AES_CCM_encrypt_message(context, plaintext, plaintext_length, aad, aad_length, iv, ciphertext, tag, tag_length);
+}
+
+CHIP_ERROR AesCcmKeyContext::Decrypt(const uint8_t * ciphertext, size_t ciphertext_length, const uint8_t * aad, size_t aad_length,
+                                     const uint8_t * tag, size_t tag_length, const uint8_t * iv, size_t iv_length,
+                                     uint8_t * plaintext)
+{
+    EVP_CIPHER_CTX * context = nullptr;
+
+    VerifyOrReturnError(mInitialized, CHIP_ERROR_INCORRECT_STATE);
+    ReturnErrorOnFailure(_AES_CCM_get_cipher(to_inner_aes_ccm_context(&mContext), false, iv_length, tag_length, context));
+
+    return _AES_CCM_decrypt_message(context, ciphertext, ciphertext_length, aad, aad_length, tag, tag_length, iv, plaintext);
+}
+
+CHIP_ERROR AesCcmKeyContext::EncryptBatch(AesCcmMessage * messages, size_t count, size_t iv_length, size_t tag_length)
+{
+    EVP_CIPHER_CTX * context = nullptr;
+
+    VerifyOrReturnError(mInitialized, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(messages != nullptr || count == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    ReturnErrorOnFailure(_AES_CCM_get_cipher(to_inner_aes_ccm_context(&mContext), true, iv_length, tag_length, context));
+
+    // The key schedule and the nonce and tag lengths stay in the context, so each message only resets the nonce. OpenSSL has no
+    // multi-buffer CCM, but running the messages back to back on one context keeps the expanded key hot for AES-NI.
+    for (size_t i = 0; i < count; i++)
+    {
+        AesCcmMessage & message = messages[i];
+        ReturnErrorOnFailure(_AES_CCM_encrypt_message(context, message.input, message.length, message.aad, message.aad_length,
+                                                      message.iv, message.output, message.tag, tag_length));
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR AesCcmKeyContext::DecryptBatch(AesCcmMessage * messages, size_t count, size_t iv_length, size_t tag_length)
+{
+    EVP_CIPHER_CTX * context = nullptr;
+
+    VerifyOrReturnError(mInitialized, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(messages != nullptr || count == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    ReturnErrorOnFailure(_AES_CCM_get_cipher(to_inner_aes_ccm_context(&mContext), false, iv_length, tag_length, context));
+
+    for (size_t i = 0; i < count; i++)
+    {
+        AesCcmMessage & message = messages[i];
+        ReturnErrorOnFailure(_AES_CCM_decrypt_message(context, message.input, message.length, message.aad, message.aad_length,
+                                                      message.tag, tag_length, message.iv, message.output));
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+void AesCcmKeyContext::Clear()
+{
+    AesCcmKeyContextState * const state = to_inner_aes_ccm_context(&mContext);
+
+    EVP_CIPHER_CTX_free(state->mEncrypt.mContext);
+    EVP_CIPHER_CTX_free(state->mDecrypt.mContext);
+    OPENSSL_cleanse(&mContext, sizeof(mContext));
+    mInitialized = false;
+}
+
 CHIP_ERROR Hash_SHA256(const uint8_t * data, const size_t data_length, uint8_t * out_buffer)
 {
     // zero data length hash is supported.
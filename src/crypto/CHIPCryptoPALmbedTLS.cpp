@@ -47,6 +47,7 @@
 #include <lib/core/CHIPSafeCasts.h>
 #include <lib/support/BufferWriter.h>
 #include <lib/support/CHIPArgParser.hpp>
+#include <lib/support/CHIPMem.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/SafePointerCast.h>
 #include <lib/support/logging/CHIPLogging.h>
@@ -192,6 +193,150 @@ exit:
     return error;
 }
 
+namespace {
+
+// State of an AesCcmKeyContext. The mbedTLS CCM context allocates the cipher context itself, so it is kept on the heap as well
+// rather than making every AesCcmKeyContext as large as the biggest mbedTLS configuration.
+struct AesCcmKeyContextState
+{
+    mbedtls_ccm_context * mContext;
+};
+
+} // namespace
+
+static_assert(kMAX_AES_CCM_Context_Size >= sizeof(AesCcmKeyContextState),
+              "kMAX_AES_CCM_Context_Size is too small for the size of underlying AesCcmKeyContextState");
+
+static inline AesCcmKeyContextState * to_inner_aes_ccm_context(AesCcmOpaqueContext * context)
+{
+    return SafePointerCast<AesCcmKeyContextState *>(context);
+}
+
+AesCcmKeyContext::AesCcmKeyContext()
+{
+    memset(&mContext, 0, sizeof(mContext));
+}
+
+AesCcmKeyContext::~AesCcmKeyContext()
+{
+    Clear();
+}
+
+CHIP_ERROR AesCcmKeyContext::Init(const uint8_t * key, size_t key_length)
+{
+    VerifyOrReturnError(key != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(_isValidKeyLength(key_length), CHIP_ERROR_INVALID_ARGUMENT);
+
+    Clear();
+
+    AesCcmKeyContextState * const state = to_inner_aes_ccm_context(&mContext);
+
+    state->mContext = static_cast<mbedtls_ccm_context *>(chip::Platform::MemoryCalloc(1, sizeof(mbedtls_ccm_context)));
+    VerifyOrReturnError(state->mContext != nullptr, CHIP_ERROR_NO_MEMORY);
+    mbedtls_ccm_init(state->mContext);
+
+    // Size of key = key_length * number of bits in a byte (8)
+    // Cast is safe because we called _isValidKeyLength above.
+    const int result = mbedtls_ccm_setkey(state->mContext, MBEDTLS_CIPHER_ID_AES, Uint8::to_const_uchar(key),
+                                          static_cast<unsigned int>(key_length * 8));
+    if (result != 0)
+    {
+        Clear();
+        return CHIP_ERROR_INTERNAL;
+    }
+
+    mInitialized = true;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR AesCcmKeyContext::Encrypt(const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad, size_t aad_length,
+                                     const uint8_t * iv, size_t iv_length, uint8_t * ciphertext, uint8_t * tag, size_t tag_length)
+{
+    VerifyOrReturnError(mInitialized, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(plaintext != nullptr || plaintext_length == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(ciphertext != nullptr || plaintext_length == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(iv != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(iv_length > 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(tag != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(_isValidTagLength(tag_length), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(aad != nullptr || aad_length == 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    const int result = mbedtls_ccm_encrypt_and_tag(to_inner_aes_ccm_context(&mContext)->mContext, plaintext_length,
+                                                   Uint8::to_const_uchar(iv), iv_length, Uint8::to_const_uchar(aad), aad_length,
+                                                   Uint8::to_const_uchar(plaintext), Uint8::to_uchar(ciphertext),
+                                                   Uint8::to_uchar(tag), tag_length);
+    _log_mbedTLS_error(result);
+    VerifyOrReturnError(result == 0, CHIP_ERROR_INTERNAL);
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR AesCcmKeyContext::Decrypt(const uint8_t * ciphertext, size_t ciphertext_length, const uint8_t * aad, size_t aad_length,
+                                     const uint8_t * tag, size_t tag_length, const uint8_t * iv, size_t iv_length,
+                                     uint8_t * plaintext)
+{
+    VerifyOrReturnError(mInitialized, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(plaintext != nullptr || ciphertext_length == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(ciphertext != nullptr || ciphertext_length == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(tag != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(_isValidTagLength(tag_length), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(iv != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(iv_length > 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(aad != nullptr || aad_length == 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    const int result = mbedtls_ccm_auth_decrypt(to_inner_aes_ccm_context(&mContext)->mContext, ciphertext_length,
+                                                Uint8::to_const_uchar(iv), iv_length, Uint8::to_const_uchar(aad), aad_length,
+                                                Uint8::to_const_uchar(ciphertext), Uint8::to_uchar(plaintext),
+                                                Uint8::to_const_uchar(tag), tag_length);
+    _log_mbedTLS_error(result);
+    VerifyOrReturnError(result == 0, CHIP_ERROR_INTERNAL);
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR AesCcmKeyContext::EncryptBatch(AesCcmMessage * messages, size_t count, size_t iv_length, size_t tag_length)
+{
+    VerifyOrReturnError(messages != nullptr || count == 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    // mbedTLS has no multi-buffer CCM; the key schedule is already shared by every message of the context.
+    for (size_t i = 0; i < count; i++)
+    {
+        AesCcmMessage & message = messages[i];
+        ReturnErrorOnFailure(Encrypt(message.input, message.length, message.aad, message.aad_length, message.iv, iv_length,
+                                     message.output, message.tag, tag_length));
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR AesCcmKeyContext::DecryptBatch(AesCcmMessage * messages, size_t count, size_t iv_length, size_t tag_length)
+{
+    VerifyOrReturnError(messages != nullptr || count == 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        AesCcmMessage & message = messages[i];
+        ReturnErrorOnFailure(Decrypt(message.input, message.length, message.aad, message.aad_length, message.tag, tag_length,
+                                     message.iv, iv_length, message.output));
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+void AesCcmKeyContext::Clear()
+{
+    AesCcmKeyContextState * const state = to_inner_aes_ccm_context(&mContext);
+
+    if (state->mContext != nullptr)
+    {
+        // mbedtls_ccm_free() wipes the expanded key.
+        mbedtls_ccm_free(state->mContext);
+        chip::Platform::MemoryFree(state->mContext);
+        state->mContext = nullptr;
+    }
+    mInitialized = false;
+}
+
 CHIP_ERROR Hash_SHA256(const uint8_t * data, const size_t data_length, uint8_t * out_buffer)
 {
     // zero data length hash is supported.
@@ -0,0 +1,50 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "CryptoJobQueue.h"
+
+#include <lib/support/CHIPMem.h>
+
+namespace chip {
+namespace Crypto {
+
+namespace {
+
+InlineCryptoJobQueue gInlineCryptoJobQueue;
+CryptoJobQueue * gCryptoJobQueue = &gInlineCryptoJobQueue;
+
+} // namespace
+
+void InlineCryptoJobQueue::Post(CryptoJob * job)
+{
+    job->OnComplete(job->Run());
+    Platform::Delete(job);
+}
+
+CryptoJobQueue & GetCryptoJobQueue()
+{
+    return *gCryptoJobQueue;
+}
+
+void SetCryptoJobQueue(CryptoJobQueue * queue)
+{
+    gCryptoJobQueue = (queue != nullptr) ? queue : &gInlineCryptoJobQueue;
+}
+
+} // namespace Crypto
+} // namespace chip
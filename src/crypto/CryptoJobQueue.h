@@ -0,0 +1,103 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines an interface for running expensive CHIPCryptoPAL
+ *      operations (ECDH, ECDSA, certificate chain validation, SPAKE2+) off
+ *      the CHIP stack thread, and the default implementation that runs them
+ *      inline.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+
+namespace chip {
+namespace Crypto {
+
+/**
+ * A unit of crypto work posted to a CryptoJobQueue.
+ *
+ * Run() may be called on any thread, and must only touch state that the poster does not use until
+ * OnComplete() is called. OnComplete() is always called on the CHIP stack thread, with the stack
+ * lock held.
+ */
+class CryptoJob
+{
+public:
+    virtual ~CryptoJob() {}
+
+    /**
+     * Do the work. Called on a crypto worker thread, or inline by the default queue.
+     */
+    virtual CHIP_ERROR Run() = 0;
+
+    /**
+     * Called on the CHIP stack thread with the result of Run(). The job is destroyed after this returns.
+     */
+    virtual void OnComplete(CHIP_ERROR err) = 0;
+};
+
+class CryptoJobQueue
+{
+public:
+    virtual ~CryptoJobQueue() {}
+
+    /**
+     * Queue a job, taking ownership of it. The job must have been allocated with Platform::New,
+     * and is destroyed with Platform::Delete once OnComplete() has returned or the job is cancelled.
+     *
+     * OnComplete() may be called before Post() returns, so posting a job must be the last thing the
+     * caller does with any state that the completion can free.
+     */
+    virtual void Post(CryptoJob * job) = 0;
+
+    /**
+     * Make sure a posted job's OnComplete() is never called. If Run() is in progress, waits for it to
+     * return. Must be called on the CHIP stack thread, and only for a job whose OnComplete() has
+     * not yet been called.
+     */
+    virtual void Cancel(CryptoJob * job) = 0;
+};
+
+/**
+ * Runs every job synchronously, within Post().
+ */
+class InlineCryptoJobQueue : public CryptoJobQueue
+{
+public:
+    void Post(CryptoJob * job) override;
+    void Cancel(CryptoJob * job) override {}
+};
+
+/**
+ * Get the queue used for session establishment crypto. Defaults to an InlineCryptoJobQueue.
+ */
+CryptoJobQueue & GetCryptoJobQueue();
+
+/**
+ * Set the queue used for session establishment crypto. Passing nullptr restores the default.
+ *
+ * Jobs still outstanding on the previous queue are not cancelled through the new one, so the
+ * previous queue has to dispose of them itself, as CryptoWorkerPool::Shutdown() does on Linux.
+ */
+void SetCryptoJobQueue(CryptoJobQueue * queue);
+
+} // namespace Crypto
+} // namespace chip
@@ -44,7 +44,9 @@
 #include <lib/support/CodeUtils.h>
 #include <lib/support/ScopedBuffer.h>
 #include <lib/support/UnitTestRegistration.h>
+#include <lib/support/logging/CHIPLogging.h>
 #include <nlunit-test.h>
+#include <system/SystemClock.h>
 
 #include <stdarg.h>
 #include <stdint.h>
@@ -628,6 +630,183 @@ static void TestAES_CCM_128Containers(nlTestSuite * inSuite, void * inContext)
     NL_TEST_ASSERT(inSuite, memcmp(testVector, deepCopy.Span().data(), deepCopy.Span().size()) == 0);
 }
 
+static void TestAES_CCM_128KeyContextTestVectors(nlTestSuite * inSuite, void * inContext)
+{
+    HeapChecker heapChecker(inSuite);
+    int numOfTestVectors = ArraySize(ccm_128_test_vectors);
+    int numOfTestsRan    = 0;
+    AesCcmKeyContext context;
+
+    NL_TEST_ASSERT(inSuite, !context.IsInitialized());
+    NL_TEST_ASSERT(inSuite, context.Init(nullptr, kAES_CCM128_Key_Length) == CHIP_ERROR_INVALID_ARGUMENT);
+
+    // Every PAL rejects a key that is not of an AES key length the same way.
+    uint8_t badKey[kAES_CCM128_Key_Length + 1] = {};
+    NL_TEST_ASSERT(inSuite, context.Init(badKey, sizeof(badKey)) == CHIP_ERROR_INVALID_ARGUMENT);
+    NL_TEST_ASSERT(inSuite, !context.IsInitialized());
+
+    for (int vectorIndex = 0; vectorIndex < numOfTestVectors; vectorIndex++)
+    {
+        const ccm_128_test_vector * vector = ccm_128_test_vectors[vectorIndex];
+        if (vector->pt_len == 0 || vector->result != CHIP_NO_ERROR)
+        {
+            continue;
+        }
+        numOfTestsRan++;
+
+        chip::Platform::ScopedMemoryBuffer<uint8_t> out_ct;
+        chip::Platform::ScopedMemoryBuffer<uint8_t> out_pt;
+        uint8_t out_tag[kAES_CCM256_Block_Length];
+        uint8_t bad_tag[kAES_CCM256_Block_Length];
+        out_ct.Alloc(vector->ct_len);
+        out_pt.Alloc(vector->pt_len);
+        NL_TEST_ASSERT(inSuite, out_ct && out_pt);
+
+        NL_TEST_ASSERT(inSuite, context.Init(vector->key, vector->key_len) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, context.IsInitialized());
+
+        // Every message must come out the same when the cipher state is reused.
+        for (int pass = 0; pass < 2; pass++)
+        {
+            memset(out_ct.Get(), 0, vector->ct_len);
+            CHIP_ERROR err = context.Encrypt(vector->pt, vector->pt_len, vector->aad, vector->aad_len, vector->iv, vector->iv_len,
+                                             out_ct.Get(), out_tag, vector->tag_len);
+            NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(inSuite, memcmp(out_ct.Get(), vector->ct, vector->ct_len) == 0);
+            NL_TEST_ASSERT(inSuite, memcmp(out_tag, vector->tag, vector->tag_len) == 0);
+        }
+
+        // A message that fails authentication must not affect the next one.
+        memcpy(bad_tag, vector->tag, vector->tag_len);
+        bad_tag[0] ^= 0x01;
+        CHIP_ERROR err = context.Decrypt(vector->ct, vector->ct_len, vector->aad, vector->aad_len, bad_tag, vector->tag_len,
+                                         vector->iv, vector->iv_len, out_pt.Get());
+        NL_TEST_ASSERT(inSuite, err != CHIP_NO_ERROR);
+
+        err = context.Decrypt(vector->ct, vector->ct_len, vector->aad, vector->aad_len, vector->tag, vector->tag_len, vector->iv,
+                              vector->iv_len, out_pt.Get());
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, memcmp(out_pt.Get(), vector->pt, vector->pt_len) == 0);
+    }
+    NL_TEST_ASSERT(inSuite, numOfTestsRan > 0);
+
+    context.Clear();
+    NL_TEST_ASSERT(inSuite, !context.IsInitialized());
+}
+
+static void TestAES_CCM_128KeyContextTagLengths(nlTestSuite * inSuite, void * inContext)
+{
+    HeapChecker heapChecker(inSuite);
+    const size_t tagLengths[] = { 16, 8, 12, 16 };
+    uint8_t key[kAES_CCM128_Key_Length];
+    uint8_t iv[13];
+    uint8_t plaintext[100];
+    uint8_t ciphertext[sizeof(plaintext)];
+    uint8_t expected[sizeof(plaintext)];
+    uint8_t tag[16];
+    uint8_t expectedTag[16];
+    AesCcmKeyContext context;
+
+    NL_TEST_ASSERT(inSuite, DRBG_get_bytes(key, sizeof(key)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, DRBG_get_bytes(iv, sizeof(iv)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, DRBG_get_bytes(plaintext, sizeof(plaintext)) == CHIP_NO_ERROR);
+
+    uint8_t dummy = 0;
+    NL_TEST_ASSERT(inSuite,
+                   context.Encrypt(plaintext, sizeof(plaintext), nullptr, 0, iv, sizeof(iv), ciphertext, tag, sizeof(tag)) ==
+                       CHIP_ERROR_INCORRECT_STATE);
+    NL_TEST_ASSERT(inSuite, context.Decrypt(&dummy, 1, nullptr, 0, tag, sizeof(tag), iv, sizeof(iv), &dummy) ==
+                       CHIP_ERROR_INCORRECT_STATE);
+    NL_TEST_ASSERT(inSuite, context.Init(key, sizeof(key)) == CHIP_NO_ERROR);
+
+    // Changing the tag length between messages must give the same results as a fresh cipher.
+    for (size_t tagLength : tagLengths)
+    {
+        NL_TEST_ASSERT(inSuite,
+                       AES_CCM_encrypt(plaintext, sizeof(plaintext), iv, sizeof(iv), key, sizeof(key), iv, sizeof(iv), expected,
+                                       expectedTag, tagLength) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite,
+                       context.Encrypt(plaintext, sizeof(plaintext), iv, sizeof(iv), iv, sizeof(iv), ciphertext, tag, tagLength) ==
+                           CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, memcmp(ciphertext, expected, sizeof(ciphertext)) == 0);
+        NL_TEST_ASSERT(inSuite, memcmp(tag, expectedTag, tagLength) == 0);
+
+        NL_TEST_ASSERT(inSuite,
+                       context.Decrypt(ciphertext, sizeof(ciphertext), iv, sizeof(iv), tag, tagLength, iv, sizeof(iv),
+                                       expected) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, memcmp(expected, plaintext, sizeof(plaintext)) == 0);
+    }
+
+    NL_TEST_ASSERT(inSuite,
+                   context.Encrypt(plaintext, sizeof(plaintext), nullptr, 0, iv, sizeof(iv), ciphertext, tag, 5) ==
+                       CHIP_ERROR_INVALID_ARGUMENT);
+}
+
+/**
+ * Compares the message rate of AES_CCM_encrypt()/AES_CCM_decrypt() against an AesCcmKeyContext kept for the whole run, for
+ * payloads of the size of a small command, a typical report and a full IPv6 MTU message.
+ */
+static void TestAES_CCM_128KeyContextThroughput(nlTestSuite * inSuite, void * inContext)
+{
+    HeapChecker heapChecker(inSuite);
+    constexpr size_t kPayloadSizes[] = { 64, 512, 1200 };
+    constexpr uint32_t kMessages     = 2000;
+    constexpr size_t kTagLength      = 16;
+
+    uint8_t key[kAES_CCM128_Key_Length];
+    uint8_t iv[13];
+    uint8_t aad[24];
+    uint8_t tag[kTagLength];
+    chip::Platform::ScopedMemoryBuffer<uint8_t> plaintext;
+    chip::Platform::ScopedMemoryBuffer<uint8_t> ciphertext;
+    chip::Platform::ScopedMemoryBuffer<uint8_t> decrypted;
+    AesCcmKeyContext encryptContext;
+    AesCcmKeyContext decryptContext;
+
+    NL_TEST_ASSERT(inSuite, plaintext.Alloc(1200) && ciphertext.Alloc(1200) && decrypted.Alloc(1200));
+    NL_TEST_ASSERT(inSuite, DRBG_get_bytes(key, sizeof(key)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, DRBG_get_bytes(aad, sizeof(aad)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, DRBG_get_bytes(plaintext.Get(), 1200) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, encryptContext.Init(key, sizeof(key)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, decryptContext.Init(key, sizeof(key)) == CHIP_NO_ERROR);
+    memset(iv, 0, sizeof(iv));
+
+    for (size_t payloadSize : kPayloadSizes)
+    {
+        uint32_t failures = 0;
+
+        // The nonce carries a message counter, as for session messages.
+        System::Clock::Microseconds64 start = System::SystemClock().GetMonotonicMicroseconds64();
+        for (uint32_t i = 0; i < kMessages; i++)
+        {
+            memcpy(&iv[1], &i, sizeof(i));
+            failures += (AES_CCM_encrypt(plaintext.Get(), payloadSize, aad, sizeof(aad), key, sizeof(key), iv, sizeof(iv),
+                                         ciphertext.Get(), tag, kTagLength) != CHIP_NO_ERROR);
+            failures += (AES_CCM_decrypt(ciphertext.Get(), payloadSize, aad, sizeof(aad), tag, kTagLength, key, sizeof(key), iv,
+                                         sizeof(iv), decrypted.Get()) != CHIP_NO_ERROR);
+        }
+        System::Clock::Microseconds64 oneShotTime = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+        start = System::SystemClock().GetMonotonicMicroseconds64();
+        for (uint32_t i = 0; i < kMessages; i++)
+        {
+            memcpy(&iv[1], &i, sizeof(i));
+            failures += (encryptContext.Encrypt(plaintext.Get(), payloadSize, aad, sizeof(aad), iv, sizeof(iv), ciphertext.Get(),
+                                                tag, kTagLength) != CHIP_NO_ERROR);
+            failures += (decryptContext.Decrypt(ciphertext.Get(), payloadSize, aad, sizeof(aad), tag, kTagLength, iv, sizeof(iv),
+                                                decrypted.Get()) != CHIP_NO_ERROR);
+        }
+        System::Clock::Microseconds64 contextTime = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+        ChipLogProgress(Crypto, "AES-CCM %u-byte encrypt+decrypt: one-shot %" PRIu64 " msgs/s, key context %" PRIu64 " msgs/s",
+                        static_cast<unsigned>(payloadSize), (kMessages * UINT64_C(1000000)) / (oneShotTime.count() + 1),
+                        (kMessages * UINT64_C(1000000)) / (contextTime.count() + 1));
+
+        NL_TEST_ASSERT(inSuite, failures == 0);
+        NL_TEST_ASSERT(inSuite, memcmp(decrypted.Get(), plaintext.Get(), payloadSize) == 0);
+    }
+}
+
 static void TestAsn1Conversions(nlTestSuite * inSuite, void * inContext)
 {
     HeapChecker heapChecker(inSuite);
@@ -2222,6 +2401,9 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("Test decrypting AES-CCM-128 invalid key", TestAES_CCM_128DecryptInvalidKey),
     NL_TEST_DEF("Test decrypting AES-CCM-128 invalid IV", TestAES_CCM_128DecryptInvalidIVLen),
     NL_TEST_DEF("Test decrypting AES-CCM-128 Containers", TestAES_CCM_128Containers),
+    NL_TEST_DEF("Test AES-CCM-128 key context with test vectors", TestAES_CCM_128KeyContextTestVectors),
+    NL_TEST_DEF("Test AES-CCM-128 key context with varying tag lengths", TestAES_CCM_128KeyContextTagLengths),
+    NL_TEST_DEF("Test AES-CCM-128 key context throughput", TestAES_CCM_128KeyContextThroughput),
     NL_TEST_DEF("Test encrypting AES-CCM-256 test vectors", TestAES_CCM_256EncryptTestVectors),
     NL_TEST_DEF("Test decrypting AES-CCM-256 test vectors", TestAES_CCM_256DecryptTestVectors),
     NL_TEST_DEF("Test encrypting AES-CCM-256 using nil key", TestAES_CCM_256EncryptNilKey),
@@ -115,6 +115,44 @@
 #define INET_CONFIG_NUM_UDP_ENDPOINTS                       64
 #endif // INET_CONFIG_NUM_UDP_ENDPOINTS
 
+/**
+ *  @def INET_CONFIG_UDP_SOCKET_RECEIVE_BATCH_SIZE
+ *
+ *  @brief
+ *    This is the number of datagrams a sockets-based UDP end point
+ *    reads with one system call, when the platform provides
+ *    recvmmsg() (HAVE_RECVMMSG).
+ *
+ *  @details
+ *    When it is greater than one, each listening end point keeps
+ *    this many maximum-size packet buffers ready to receive into,
+ *    and replaces those it passes up after each read. It should
+ *    therefore only be raised on platforms that allocate packet
+ *    buffers from the heap.
+ *
+ */
+#ifndef INET_CONFIG_UDP_SOCKET_RECEIVE_BATCH_SIZE
+#define INET_CONFIG_UDP_SOCKET_RECEIVE_BATCH_SIZE           1
+#endif // INET_CONFIG_UDP_SOCKET_RECEIVE_BATCH_SIZE
+
+/**
+ *  @def INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE
+ *
+ *  @brief
+ *    This is the largest number of datagrams a sockets-based UDP
+ *    end point passes to one sendmmsg() call, when the platform
+ *    provides it (HAVE_SENDMMSG).
+ *
+ *  @details
+ *    It also bounds the number of messages a UDP transport queues
+ *    between flushes. When it is one, queued messages are sent right
+ *    away.
+ *
+ */
+#ifndef INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE
+#define INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE              1
+#endif // INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE
+
 /**
  *  @def INET_TCP_IDLE_CHECK_INTERVAL
  *
@@ -227,6 +227,25 @@ public:
      */
     CHIP_ERROR SendMsg(const IPPacketInfo * pktInfo, chip::System::PacketBufferHandle && msg);
 
+    /**
+     * Send several UDP messages.
+     *
+     *  Send each message in \c msgs to the destination given in the matching entry of \c pktInfos, as \c SendMsg would.
+     *  Where the platform allows it (sendmmsg() on Linux), the messages are passed to the network stack with fewer system
+     *  calls than sending them one at a time; elsewhere they are sent one at a time. The messages are sent in order, and
+     *  sending stops at the first one that fails.
+     *
+     * @param[in]   pktInfos    Source and destination information for each of the UDP messages.
+     * @param[in]   msgs        Packet buffers containing the UDP messages. The handles are left in an unspecified state.
+     * @param[in]   count       Number of messages.
+     * @param[out]  sentCount   Number of messages, starting from the first, that were queued for transmit. This is set on
+     *                          failure too, so that the caller only sends the messages after them again.
+     *
+     * @retval  CHIP_NO_ERROR   Success: all the messages are queued for transmit.
+     * @retval  other           The error \c SendMsg returns for the message at index \c sentCount.
+     */
+    CHIP_ERROR SendMsgs(const IPPacketInfo * pktInfos, chip::System::PacketBufferHandle * msgs, size_t count, size_t & sentCount);
+
     /**
      * Close the endpoint.
      *
@@ -295,6 +314,8 @@ protected:
     virtual CHIP_ERROR BindInterfaceImpl(IPAddressType addressType, InterfaceId interfaceId)                                  = 0;
     virtual CHIP_ERROR ListenImpl()                                                                                           = 0;
     virtual CHIP_ERROR SendMsgImpl(const IPPacketInfo * pktInfo, chip::System::PacketBufferHandle && msg)                     = 0;
+    virtual CHIP_ERROR SendMsgsImpl(const IPPacketInfo * pktInfos, chip::System::PacketBufferHandle * msgs, size_t count,
+                                    size_t & sentCount);
     virtual void CloseImpl()                                                                                                  = 0;
 };
 
@@ -78,6 +78,10 @@
 namespace chip {
 namespace Inet {
 
+#if INET_CONFIG_TEST
+uint32_t UDPEndPointImplSockets::sSendSyscallCount = 0;
+#endif // INET_CONFIG_TEST
+
 namespace {
 
 CHIP_ERROR IPv6Bind(int socket, const IPAddress & address, uint16_t port, InterfaceId interface)
@@ -156,6 +160,199 @@ CHIP_ERROR IPv4Bind(int socket, const IPAddress & address, uint16_t port)
 }
 #endif // INET_CONFIG_ENABLE_IPV4
 
+// Everything a message header passed to sendmsg() or sendmmsg() points to.
+struct OutgoingMsg
+{
+    struct iovec msgIOV;
+    SockAddr peerSockAddr;
+#if defined(IP_PKTINFO) || defined(IPV6_PKTINFO)
+    uint8_t controlData[256];
+#endif // defined(IP_PKTINFO) || defined(IPV6_PKTINFO)
+};
+
+// Fills in the header for sending a message from an end point of the given address type to the destination in aPktInfo.
+CHIP_ERROR PrepareOutgoingMsg(IPAddressType addrType, InterfaceId boundIntfId, const IPPacketInfo & aPktInfo,
+                              const System::PacketBufferHandle & msg, OutgoingMsg & outgoing, struct msghdr & msgHeader)
+{
+    // For now the entire message must fit within a single buffer.
+    VerifyOrReturnError(!msg->HasChainedBuffer(), CHIP_ERROR_MESSAGE_TOO_LONG);
+
+    struct iovec & msgIOV = outgoing.msgIOV;
+    msgIOV.iov_base       = msg->Start();
+    msgIOV.iov_len        = msg->DataLength();
+
+#if defined(IP_PKTINFO) || defined(IPV6_PKTINFO)
+    uint8_t * controlData = outgoing.controlData;
+    memset(controlData, 0, sizeof(outgoing.controlData));
+#endif // defined(IP_PKTINFO) || defined(IPV6_PKTINFO)
+
+    memset(&msgHeader, 0, sizeof(msgHeader));
+    msgHeader.msg_iov    = &msgIOV;
+    msgHeader.msg_iovlen = 1;
+
+    // Construct a sockaddr_in/sockaddr_in6 structure containing the destination information.
+    SockAddr & peerSockAddr = outgoing.peerSockAddr;
+    memset(&peerSockAddr, 0, sizeof(peerSockAddr));
+    msgHeader.msg_name = &peerSockAddr;
+    if (addrType == IPAddressType::kIPv6)
+    {
+        peerSockAddr.in6.sin6_family     = AF_INET6;
+        peerSockAddr.in6.sin6_port       = htons(aPktInfo.DestPort);
+        peerSockAddr.in6.sin6_addr       = aPktInfo.DestAddress.ToIPv6();
+        InterfaceId::PlatformType intfId = aPktInfo.Interface.GetPlatformInterface();
+        VerifyOrReturnError(CanCastTo<decltype(peerSockAddr.in6.sin6_scope_id)>(intfId), CHIP_ERROR_INCORRECT_STATE);
+        peerSockAddr.in6.sin6_scope_id = static_cast<decltype(peerSockAddr.in6.sin6_scope_id)>(intfId);
+        msgHeader.msg_namelen          = sizeof(sockaddr_in6);
+    }
+#if INET_CONFIG_ENABLE_IPV4
+    else
+    {
+        peerSockAddr.in.sin_family = AF_INET;
+        peerSockAddr.in.sin_port   = htons(aPktInfo.DestPort);
+        peerSockAddr.in.sin_addr   = aPktInfo.DestAddress.ToIPv4();
+        msgHeader.msg_namelen      = sizeof(sockaddr_in);
+    }
+#endif // INET_CONFIG_ENABLE_IPV4
+
+    // If the endpoint has been bound to a particular interface,
+    // and the caller didn't supply a specific interface to send
+    // on, use the bound interface. This appears to be necessary
+    // for messages to multicast addresses, which under Linux
+    // don't seem to get sent out the correct interface, despite
+    // the socket being bound.
+    InterfaceId intf = aPktInfo.Interface;
+    if (!intf.IsPresent())
+    {
+        intf = boundIntfId;
+    }
+
+    // If the packet should be sent over a specific interface, or with a specific source
+    // address, construct an IP_PKTINFO/IPV6_PKTINFO "control message" to that effect
+    // add add it to the message header.  If the local OS doesn't support IP_PKTINFO/IPV6_PKTINFO
+    // fail with an error.
+    if (intf.IsPresent() || aPktInfo.SrcAddress.Type() != IPAddressType::kAny)
+    {
+#if defined(IP_PKTINFO) || defined(IPV6_PKTINFO)
+        msgHeader.msg_control    = controlData;
+        msgHeader.msg_controllen = sizeof(outgoing.controlData);
+
+        struct cmsghdr * controlHdr      = CMSG_FIRSTHDR(&msgHeader);
+        InterfaceId::PlatformType intfId = intf.GetPlatformInterface();
+
+#if INET_CONFIG_ENABLE_IPV4
+
+        if (addrType == IPAddressType::kIPv4)
+        {
+#if defined(IP_PKTINFO)
+            controlHdr->cmsg_level = IPPROTO_IP;
+            controlHdr->cmsg_type  = IP_PKTINFO;
+            controlHdr->cmsg_len   = CMSG_LEN(sizeof(in_pktinfo));
+
+            auto * pktInfo = reinterpret_cast<struct in_pktinfo *> CMSG_DATA(controlHdr);
+            if (!CanCastTo<decltype(pktInfo->ipi_ifindex)>(intfId))
+            {
+                return CHIP_ERROR_UNSUPPORTED_CHIP_FEATURE;
+            }
+
+            pktInfo->ipi_ifindex  = static_cast<decltype(pktInfo->ipi_ifindex)>(intfId);
+            pktInfo->ipi_spec_dst = aPktInfo.SrcAddress.ToIPv4();
+
+            msgHeader.msg_controllen = CMSG_SPACE(sizeof(in_pktinfo));
+#else  // !defined(IP_PKTINFO)
+            return CHIP_ERROR_UNSUPPORTED_CHIP_FEATURE;
+#endif // !defined(IP_PKTINFO)
+        }
+
+#endif // INET_CONFIG_ENABLE_IPV4
+
+        if (addrType == IPAddressType::kIPv6)
+        {
+#if defined(IPV6_PKTINFO)
+            controlHdr->cmsg_level = IPPROTO_IPV6;
+            controlHdr->cmsg_type  = IPV6_PKTINFO;
+            controlHdr->cmsg_len   = CMSG_LEN(sizeof(in6_pktinfo));
+
+            auto * pktInfo = reinterpret_cast<struct in6_pktinfo *> CMSG_DATA(controlHdr);
+            if (!CanCastTo<decltype(pktInfo->ipi6_ifindex)>(intfId))
+            {
+                return CHIP_ERROR_UNEXPECTED_EVENT;
+            }
+            pktInfo->ipi6_ifindex = static_cast<decltype(pktInfo->ipi6_ifindex)>(intfId);
+            pktInfo->ipi6_addr    = aPktInfo.SrcAddress.ToIPv6();
+
+            msgHeader.msg_controllen = CMSG_SPACE(sizeof(in6_pktinfo));
+#else  // !defined(IPV6_PKTINFO)
+            return CHIP_ERROR_UNSUPPORTED_CHIP_FEATURE;
+#endif // !defined(IPV6_PKTINFO)
+        }
+
+#else  // !(defined(IP_PKTINFO) && defined(IPV6_PKTINFO))
+        return CHIP_ERROR_UNSUPPORTED_CHIP_FEATURE;
+#endif // !(defined(IP_PKTINFO) && defined(IPV6_PKTINFO))
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+// Fills in the source and destination of a received datagram from the peer address and control data that came with it.
+CHIP_ERROR GetPacketInfo(struct msghdr & msgHeader, IPPacketInfo & packetInfo)
+{
+    const SockAddr & peerSockAddr = *static_cast<const SockAddr *>(msgHeader.msg_name);
+
+    if (peerSockAddr.any.sa_family == AF_INET6)
+    {
+        packetInfo.SrcAddress = IPAddress(peerSockAddr.in6.sin6_addr);
+        packetInfo.SrcPort    = ntohs(peerSockAddr.in6.sin6_port);
+    }
+#if INET_CONFIG_ENABLE_IPV4
+    else if (peerSockAddr.any.sa_family == AF_INET)
+    {
+        packetInfo.SrcAddress = IPAddress(peerSockAddr.in.sin_addr);
+        packetInfo.SrcPort    = ntohs(peerSockAddr.in.sin_port);
+    }
+#endif // INET_CONFIG_ENABLE_IPV4
+    else
+    {
+        return CHIP_ERROR_INCORRECT_STATE;
+    }
+
+    for (struct cmsghdr * controlHdr = CMSG_FIRSTHDR(&msgHeader); controlHdr != nullptr;
+         controlHdr                  = CMSG_NXTHDR(&msgHeader, controlHdr))
+    {
+#if INET_CONFIG_ENABLE_IPV4
+#ifdef IP_PKTINFO
+        if (controlHdr->cmsg_level == IPPROTO_IP && controlHdr->cmsg_type == IP_PKTINFO)
+        {
+            auto * inPktInfo = reinterpret_cast<struct in_pktinfo *> CMSG_DATA(controlHdr);
+            if (!CanCastTo<InterfaceId::PlatformType>(inPktInfo->ipi_ifindex))
+            {
+                return CHIP_ERROR_INCORRECT_STATE;
+            }
+            packetInfo.Interface   = InterfaceId(static_cast<InterfaceId::PlatformType>(inPktInfo->ipi_ifindex));
+            packetInfo.DestAddress = IPAddress(inPktInfo->ipi_addr);
+            continue;
+        }
+#endif // defined(IP_PKTINFO)
+#endif // INET_CONFIG_ENABLE_IPV4
+
+#ifdef IPV6_PKTINFO
+        if (controlHdr->cmsg_level == IPPROTO_IPV6 && controlHdr->cmsg_type == IPV6_PKTINFO)
+        {
+            auto * in6PktInfo = reinterpret_cast<struct in6_pktinfo *> CMSG_DATA(controlHdr);
+            if (!CanCastTo<InterfaceId::PlatformType>(in6PktInfo->ipi6_ifindex))
+            {
+                return CHIP_ERROR_INCORRECT_STATE;
+            }
+            packetInfo.Interface   = InterfaceId(static_cast<InterfaceId::PlatformType>(in6PktInfo->ipi6_ifindex));
+            packetInfo.DestAddress = IPAddress(in6PktInfo->ipi6_addr);
+            continue;
+        }
+#endif // defined(IPV6_PKTINFO)
+    }
+
+    return CHIP_NO_ERROR;
+}
+
 } // anonymous namespace
 
 #if CHIP_SYSTEM_CONFIG_USE_PLATFORM_MULTICAST_API
@@ -292,136 +489,94 @@ CHIP_ERROR UDPEndPointImplSockets::SendMsgImpl(const IPPacketInfo * aPktInfo, Sy
     // Ensure the destination address type is compatible with the endpoint address type.
     VerifyOrReturnError(mAddrType == aPktInfo->DestAddress.Type(), CHIP_ERROR_INVALID_ARGUMENT);
 
-    // For now the entire message must fit within a single buffer.
-    VerifyOrReturnError(!msg->HasChainedBuffer(), CHIP_ERROR_MESSAGE_TOO_LONG);
-
-    struct iovec msgIOV;
-    msgIOV.iov_base = msg->Start();
-    msgIOV.iov_len  = msg->DataLength();
-
-#if defined(IP_PKTINFO) || defined(IPV6_PKTINFO)
-    uint8_t controlData[256];
-    memset(controlData, 0, sizeof(controlData));
-#endif // defined(IP_PKTINFO) || defined(IPV6_PKTINFO)
-
+    OutgoingMsg outgoing;
     struct msghdr msgHeader;
-    memset(&msgHeader, 0, sizeof(msgHeader));
-    msgHeader.msg_iov    = &msgIOV;
-    msgHeader.msg_iovlen = 1;
+    ReturnErrorOnFailure(PrepareOutgoingMsg(mAddrType, mBoundIntfId, *aPktInfo, msg, outgoing, msgHeader));
 
-    // Construct a sockaddr_in/sockaddr_in6 structure containing the destination information.
-    SockAddr peerSockAddr;
-    memset(&peerSockAddr, 0, sizeof(peerSockAddr));
-    msgHeader.msg_name = &peerSockAddr;
-    if (mAddrType == IPAddressType::kIPv6)
-    {
-        peerSockAddr.in6.sin6_family     = AF_INET6;
-        peerSockAddr.in6.sin6_port       = htons(aPktInfo->DestPort);
-        peerSockAddr.in6.sin6_addr       = aPktInfo->DestAddress.ToIPv6();
-        InterfaceId::PlatformType intfId = aPktInfo->Interface.GetPlatformInterface();
-        VerifyOrReturnError(CanCastTo<decltype(peerSockAddr.in6.sin6_scope_id)>(intfId), CHIP_ERROR_INCORRECT_STATE);
-        peerSockAddr.in6.sin6_scope_id = static_cast<decltype(peerSockAddr.in6.sin6_scope_id)>(intfId);
-        msgHeader.msg_namelen          = sizeof(sockaddr_in6);
-    }
-#if INET_CONFIG_ENABLE_IPV4
-    else
+    // Send IP packet.
+    const ssize_t lenSent = sendmsg(mSocket, &msgHeader, 0);
+#if INET_CONFIG_TEST
+    sSendSyscallCount++;
+#endif // INET_CONFIG_TEST
+    if (lenSent == -1)
     {
-        peerSockAddr.in.sin_family = AF_INET;
-        peerSockAddr.in.sin_port   = htons(aPktInfo->DestPort);
-        peerSockAddr.in.sin_addr   = aPktInfo->DestAddress.ToIPv4();
-        msgHeader.msg_namelen      = sizeof(sockaddr_in);
+        return CHIP_ERROR_POSIX(errno);
     }
-#endif // INET_CONFIG_ENABLE_IPV4
-
-    // If the endpoint has been bound to a particular interface,
-    // and the caller didn't supply a specific interface to send
-    // on, use the bound interface. This appears to be necessary
-    // for messages to multicast addresses, which under Linux
-    // don't seem to get sent out the correct interface, despite
-    // the socket being bound.
-    InterfaceId intf = aPktInfo->Interface;
-    if (!intf.IsPresent())
+    if (lenSent != msg->DataLength())
     {
-        intf = mBoundIntfId;
+        return CHIP_ERROR_OUTBOUND_MESSAGE_TOO_BIG;
     }
+    return CHIP_NO_ERROR;
+}
 
-    // If the packet should be sent over a specific interface, or with a specific source
-    // address, construct an IP_PKTINFO/IPV6_PKTINFO "control message" to that effect
-    // add add it to the message header.  If the local OS doesn't support IP_PKTINFO/IPV6_PKTINFO
-    // fail with an error.
-    if (intf.IsPresent() || aPktInfo->SrcAddress.Type() != IPAddressType::kAny)
-    {
-#if defined(IP_PKTINFO) || defined(IPV6_PKTINFO)
-        msgHeader.msg_control    = controlData;
-        msgHeader.msg_controllen = sizeof(controlData);
-
-        struct cmsghdr * controlHdr      = CMSG_FIRSTHDR(&msgHeader);
-        InterfaceId::PlatformType intfId = intf.GetPlatformInterface();
+#if HAVE_SENDMMSG && INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE > 1
+CHIP_ERROR UDPEndPointImplSockets::SendMsgsImpl(const IPPacketInfo * aPktInfos, System::PacketBufferHandle * msgs, size_t count,
+                                                size_t & sentCount)
+{
+    constexpr size_t kBatchSize = INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE;
 
-#if INET_CONFIG_ENABLE_IPV4
+    struct mmsghdr messages[kBatchSize];
+    OutgoingMsg outgoing[kBatchSize];
 
-        if (mAddrType == IPAddressType::kIPv4)
+    while (sentCount < count)
+    {
+        // Prepare as many messages as fit in one call, stopping before the first one that can not be sent.
+        CHIP_ERROR err    = CHIP_NO_ERROR;
+        size_t batchCount = 0;
+        for (; batchCount < kBatchSize && sentCount + batchCount < count; batchCount++)
         {
-#if defined(IP_PKTINFO)
-            controlHdr->cmsg_level = IPPROTO_IP;
-            controlHdr->cmsg_type  = IP_PKTINFO;
-            controlHdr->cmsg_len   = CMSG_LEN(sizeof(in_pktinfo));
+            const IPPacketInfo & pktInfo = aPktInfos[sentCount + batchCount];
 
-            auto * pktInfo = reinterpret_cast<struct in_pktinfo *> CMSG_DATA(controlHdr);
-            if (!CanCastTo<decltype(pktInfo->ipi_ifindex)>(intfId))
+            err = GetSocket(pktInfo.DestAddress.Type());
+            if (err == CHIP_NO_ERROR && mAddrType != pktInfo.DestAddress.Type())
             {
-                return CHIP_ERROR_UNSUPPORTED_CHIP_FEATURE;
+                err = CHIP_ERROR_INVALID_ARGUMENT;
+            }
+            if (err == CHIP_NO_ERROR)
+            {
+                memset(&messages[batchCount], 0, sizeof(messages[batchCount]));
+                err = PrepareOutgoingMsg(mAddrType, mBoundIntfId, pktInfo, msgs[sentCount + batchCount], outgoing[batchCount],
+                                         messages[batchCount].msg_hdr);
+            }
+            if (err != CHIP_NO_ERROR)
+            {
+                break;
             }
-
-            pktInfo->ipi_ifindex  = static_cast<decltype(pktInfo->ipi_ifindex)>(intfId);
-            pktInfo->ipi_spec_dst = aPktInfo->SrcAddress.ToIPv4();
-
-            msgHeader.msg_controllen = CMSG_SPACE(sizeof(in_pktinfo));
-#else  // !defined(IP_PKTINFO)
-            return CHIP_ERROR_UNSUPPORTED_CHIP_FEATURE;
-#endif // !defined(IP_PKTINFO)
         }
 
-#endif // INET_CONFIG_ENABLE_IPV4
-
-        if (mAddrType == IPAddressType::kIPv6)
+        if (batchCount > 0)
         {
-#if defined(IPV6_PKTINFO)
-            controlHdr->cmsg_level = IPPROTO_IPV6;
-            controlHdr->cmsg_type  = IPV6_PKTINFO;
-            controlHdr->cmsg_len   = CMSG_LEN(sizeof(in6_pktinfo));
-
-            auto * pktInfo = reinterpret_cast<struct in6_pktinfo *> CMSG_DATA(controlHdr);
-            if (!CanCastTo<decltype(pktInfo->ipi6_ifindex)>(intfId))
+            const int batchSent = sendmmsg(mSocket, messages, static_cast<unsigned int>(batchCount), 0);
+#if INET_CONFIG_TEST
+            sSendSyscallCount++;
+#endif // INET_CONFIG_TEST
+            VerifyOrReturnError(batchSent > 0, CHIP_ERROR_POSIX(errno));
+
+            // Every message the call took has left, so all of them count as sent, even one that was cut short: stopping at
+            // it would have the caller send the ones after it again.
+            for (size_t i = 0; i < static_cast<size_t>(batchSent); i++, sentCount++)
             {
-                return CHIP_ERROR_UNEXPECTED_EVENT;
+                if (messages[i].msg_len != msgs[sentCount]->DataLength())
+                {
+                    ChipLogError(Inet, "Sent %u of %u bytes of a UDP message", static_cast<unsigned>(messages[i].msg_len),
+                                 static_cast<unsigned>(msgs[sentCount]->DataLength()));
+                }
+                msgs[sentCount] = nullptr;
             }
-            pktInfo->ipi6_ifindex = static_cast<decltype(pktInfo->ipi6_ifindex)>(intfId);
-            pktInfo->ipi6_addr    = aPktInfo->SrcAddress.ToIPv6();
 
-            msgHeader.msg_controllen = CMSG_SPACE(sizeof(in6_pktinfo));
-#else  // !defined(IPV6_PKTINFO)
-            return CHIP_ERROR_UNSUPPORTED_CHIP_FEATURE;
-#endif // !defined(IPV6_PKTINFO)
+            // If the call stopped early, the next one reports why.
+            if (static_cast<size_t>(batchSent) < batchCount)
+            {
+                continue;
+            }
         }
 
-#else  // !(defined(IP_PKTINFO) && defined(IPV6_PKTINFO))
-        return CHIP_ERROR_UNSUPPORTED_CHIP_FEATURE;
-#endif // !(defined(IP_PKTINFO) && defined(IPV6_PKTINFO))
+        ReturnErrorOnFailure(err);
     }
 
-    // Send IP packet.
-    const ssize_t lenSent = sendmsg(mSocket, &msgHeader, 0);
-    if (lenSent == -1)
-    {
-        return CHIP_ERROR_POSIX(errno);
-    }
-    if (lenSent != msg->DataLength())
-    {
-        return CHIP_ERROR_OUTBOUND_MESSAGE_TOO_BIG;
-    }
     return CHIP_NO_ERROR;
 }
+#endif // HAVE_SENDMMSG && INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE > 1
 
 void UDPEndPointImplSockets::CloseImpl()
 {
@@ -432,6 +587,13 @@ void UDPEndPointImplSockets::CloseImpl()
         mSocket = kInvalidSocketFd;
     }
 
+#if HAVE_RECVMMSG && INET_CONFIG_UDP_SOCKET_RECEIVE_BATCH_SIZE > 1
+    for (System::PacketBufferHandle & buffer : mReceiveBuffers)
+    {
+        buffer = nullptr;
+    }
+#endif // HAVE_RECVMMSG && INET_CONFIG_UDP_SOCKET_RECEIVE_BATCH_SIZE > 1
+
 #if CHIP_SYSTEM_CONFIG_USE_DISPATCH
     if (mReadableSource)
     {
@@ -576,6 +738,9 @@ void UDPEndPointImplSockets::HandlePendingIO(System::SocketEvents events)
         return;
     }
 
+#if HAVE_RECVMMSG && INET_CONFIG_UDP_SOCKET_RECEIVE_BATCH_SIZE > 1
+    ReceiveBatch();
+#else
     CHIP_ERROR lStatus = CHIP_NO_ERROR;
     IPPacketInfo lPacketInfo;
     System::PacketBufferHandle lBuffer;
@@ -619,62 +784,7 @@ void UDPEndPointImplSockets::HandlePendingIO(System::SocketEvents events)
         else
         {
             lBuffer->SetDataLength(static_cast<uint16_t>(rcvLen));
-
-            if (lPeerSockAddr.any.sa_family == AF_INET6)
-            {
-                lPacketInfo.SrcAddress = IPAddress(lPeerSockAddr.in6.sin6_addr);
-                lPacketInfo.SrcPort    = ntohs(lPeerSockAddr.in6.sin6_port);
-            }
-#if INET_CONFIG_ENABLE_IPV4
-            else if (lPeerSockAddr.any.sa_family == AF_INET)
-            {
-                lPacketInfo.SrcAddress = IPAddress(lPeerSockAddr.in.sin_addr);
-                lPacketInfo.SrcPort    = ntohs(lPeerSockAddr.in.sin_port);
-            }
-#endif // INET_CONFIG_ENABLE_IPV4
-            else
-            {
-                lStatus = CHIP_ERROR_INCORRECT_STATE;
-            }
-        }
-
-        if (lStatus == CHIP_NO_ERROR)
-        {
-            for (struct cmsghdr * controlHdr = CMSG_FIRSTHDR(&msgHeader); controlHdr != nullptr;
-                 controlHdr                  = CMSG_NXTHDR(&msgHeader, controlHdr))
-            {
-#if INET_CONFIG_ENABLE_IPV4
-#ifdef IP_PKTINFO
-                if (controlHdr->cmsg_level == IPPROTO_IP && controlHdr->cmsg_type == IP_PKTINFO)
-                {
-                    auto * inPktInfo = reinterpret_cast<struct in_pktinfo *> CMSG_DATA(controlHdr);
-                    if (!CanCastTo<InterfaceId::PlatformType>(inPktInfo->ipi_ifindex))
-                    {
-                        lStatus = CHIP_ERROR_INCORRECT_STATE;
-                        break;
-                    }
-                    lPacketInfo.Interface   = InterfaceId(static_cast<InterfaceId::PlatformType>(inPktInfo->ipi_ifindex));
-                    lPacketInfo.DestAddress = IPAddress(inPktInfo->ipi_addr);
-                    continue;
-                }
-#endif // defined(IP_PKTINFO)
-#endif // INET_CONFIG_ENABLE_IPV4
-
-#ifdef IPV6_PKTINFO
-                if (controlHdr->cmsg_level == IPPROTO_IPV6 && controlHdr->cmsg_type == IPV6_PKTINFO)
-                {
-                    auto * in6PktInfo = reinterpret_cast<struct in6_pktinfo *> CMSG_DATA(controlHdr);
-                    if (!CanCastTo<InterfaceId::PlatformType>(in6PktInfo->ipi6_ifindex))
-                    {
-                        lStatus = CHIP_ERROR_INCORRECT_STATE;
-                        break;
-                    }
-                    lPacketInfo.Interface   = InterfaceId(static_cast<InterfaceId::PlatformType>(in6PktInfo->ipi6_ifindex));
-                    lPacketInfo.DestAddress = IPAddress(in6PktInfo->ipi6_addr);
-                    continue;
-                }
-#endif // defined(IPV6_PKTINFO)
-            }
+            lStatus = GetPacketInfo(msgHeader, lPacketInfo);
         }
     }
     else
@@ -684,7 +794,8 @@ void UDPEndPointImplSockets::HandlePendingIO(System::SocketEvents events)
 
     if (lStatus == CHIP_NO_ERROR)
     {
-        lBuffer.RightSize();
+        // The datagram is passed up in the buffer it was received into. It is not right-sized: its data is decrypted and
+        // consumed in place by the layers above, and the buffer is usually freed before the next one is read.
         OnMessageReceived(this, std::move(lBuffer), &lPacketInfo);
     }
     else
@@ -694,7 +805,110 @@ void UDPEndPointImplSockets::HandlePendingIO(System::SocketEvents events)
             OnReceiveError(this, lStatus, nullptr);
         }
     }
+#endif // HAVE_RECVMMSG && INET_CONFIG_UDP_SOCKET_RECEIVE_BATCH_SIZE > 1
+}
+
+#if HAVE_RECVMMSG && INET_CONFIG_UDP_SOCKET_RECEIVE_BATCH_SIZE > 1
+void UDPEndPointImplSockets::ReceiveBatch()
+{
+    constexpr size_t kBatchSize = INET_CONFIG_UDP_SOCKET_RECEIVE_BATCH_SIZE;
+
+    struct mmsghdr messages[kBatchSize];
+    struct iovec msgIOVs[kBatchSize];
+    SockAddr peerSockAddrs[kBatchSize];
+    uint8_t controlData[kBatchSize][256];
+
+    // Replace the buffers that the previous read passed up. Reading stops at the first missing one.
+    size_t bufferCount = 0;
+    for (; bufferCount < kBatchSize; bufferCount++)
+    {
+        System::PacketBufferHandle & buffer = mReceiveBuffers[bufferCount];
+        if (buffer.IsNull())
+        {
+            buffer = System::PacketBufferHandle::New(System::PacketBuffer::kMaxSizeWithoutReserve, 0);
+            if (buffer.IsNull())
+            {
+                break;
+            }
+        }
+
+        msgIOVs[bufferCount].iov_base = buffer->Start();
+        msgIOVs[bufferCount].iov_len  = buffer->AvailableDataLength();
+
+        memset(&peerSockAddrs[bufferCount], 0, sizeof(peerSockAddrs[bufferCount]));
+        memset(&messages[bufferCount], 0, sizeof(messages[bufferCount]));
+
+        struct msghdr & msgHeader = messages[bufferCount].msg_hdr;
+        msgHeader.msg_name        = &peerSockAddrs[bufferCount];
+        msgHeader.msg_namelen     = sizeof(peerSockAddrs[bufferCount]);
+        msgHeader.msg_iov         = &msgIOVs[bufferCount];
+        msgHeader.msg_iovlen      = 1;
+        msgHeader.msg_control     = controlData[bufferCount];
+        msgHeader.msg_controllen  = sizeof(controlData[bufferCount]);
+    }
+
+    if (bufferCount == 0)
+    {
+        if (OnReceiveError != nullptr)
+        {
+            OnReceiveError(this, CHIP_ERROR_NO_MEMORY, nullptr);
+        }
+        return;
+    }
+
+    const int rcvCount = recvmmsg(mSocket, messages, static_cast<unsigned int>(bufferCount), MSG_DONTWAIT, nullptr);
+    if (rcvCount < 0)
+    {
+        const CHIP_ERROR lStatus = CHIP_ERROR_POSIX(errno);
+        if (OnReceiveError != nullptr && lStatus != CHIP_ERROR_POSIX(EAGAIN))
+        {
+            OnReceiveError(this, lStatus, nullptr);
+        }
+        return;
+    }
+
+    // The callbacks may close or free this end point. Keep it alive until the loop is done, and stop passing up datagrams
+    // once it is no longer listening.
+    Retain();
+
+    for (size_t i = 0; i < static_cast<size_t>(rcvCount) && mState == State::kListening && OnMessageReceived != nullptr; i++)
+    {
+        IPPacketInfo lPacketInfo;
+        lPacketInfo.Clear();
+        lPacketInfo.DestPort = mBoundPort;
+
+        // As in the single read case, the datagram is passed up in the buffer it was received into.
+        System::PacketBufferHandle lBuffer = std::move(mReceiveBuffers[i]);
+        CHIP_ERROR lStatus                 = CHIP_NO_ERROR;
+
+        if (messages[i].msg_len > lBuffer->AvailableDataLength() || (messages[i].msg_hdr.msg_flags & MSG_TRUNC) != 0)
+        {
+            lStatus = CHIP_ERROR_INBOUND_MESSAGE_TOO_BIG;
+        }
+        else
+        {
+            lBuffer->SetDataLength(static_cast<uint16_t>(messages[i].msg_len));
+            lStatus = GetPacketInfo(messages[i].msg_hdr, lPacketInfo);
+        }
+
+        if (lStatus == CHIP_NO_ERROR)
+        {
+            OnMessageReceived(this, std::move(lBuffer), &lPacketInfo);
+        }
+        else
+        {
+            // Keep the buffer for the next read.
+            mReceiveBuffers[i] = std::move(lBuffer);
+            if (OnReceiveError != nullptr)
+            {
+                OnReceiveError(this, lStatus, nullptr);
+            }
+        }
+    }
+
+    Release();
 }
+#endif // HAVE_RECVMMSG && INET_CONFIG_UDP_SOCKET_RECEIVE_BATCH_SIZE > 1
 
 #if IP_MULTICAST_LOOP || IPV6_MULTICAST_LOOP
 static CHIP_ERROR SocketsSetMulticastLoopback(int aSocket, bool aLoopback, int aProtocol, int aOption)
@@ -46,6 +46,13 @@ public:
     uint16_t GetBoundPort() const override;
     void Free() override;
 
+#if INET_CONFIG_TEST
+    /**
+     * Number of sendmsg() and sendmmsg() calls made by all the sockets-based UDP end points so far.
+     */
+    static uint32_t SendSyscallCount() { return sSendSyscallCount; }
+#endif // INET_CONFIG_TEST
+
 private:
     // UDPEndPoint overrides.
 #if INET_CONFIG_ENABLE_IPV4
@@ -56,6 +63,10 @@ private:
     CHIP_ERROR BindInterfaceImpl(IPAddressType addressType, InterfaceId interfaceId) override;
     CHIP_ERROR ListenImpl() override;
     CHIP_ERROR SendMsgImpl(const IPPacketInfo * pktInfo, chip::System::PacketBufferHandle && msg) override;
+#if HAVE_SENDMMSG && INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE > 1
+    CHIP_ERROR SendMsgsImpl(const IPPacketInfo * pktInfos, chip::System::PacketBufferHandle * msgs, size_t count,
+                            size_t & sentCount) override;
+#endif // HAVE_SENDMMSG && INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE > 1
     void CloseImpl() override;
 
     CHIP_ERROR GetSocket(IPAddressType addressType);
@@ -65,6 +76,17 @@ private:
     InterfaceId mBoundIntfId;
     uint16_t mBoundPort;
 
+#if INET_CONFIG_TEST
+    static uint32_t sSendSyscallCount;
+#endif // INET_CONFIG_TEST
+
+#if HAVE_RECVMMSG && INET_CONFIG_UDP_SOCKET_RECEIVE_BATCH_SIZE > 1
+    void ReceiveBatch();
+
+    // Buffers the next recvmmsg() call receives into. Those passed up with a datagram are replaced before the next call.
+    System::PacketBufferHandle mReceiveBuffers[INET_CONFIG_UDP_SOCKET_RECEIVE_BATCH_SIZE];
+#endif // HAVE_RECVMMSG && INET_CONFIG_UDP_SOCKET_RECEIVE_BATCH_SIZE > 1
+
 #if CHIP_SYSTEM_CONFIG_USE_DISPATCH
     dispatch_source_t mReadableSource = nullptr;
 #endif // CHIP_SYSTEM_CONFIG_USE_DISPATCH
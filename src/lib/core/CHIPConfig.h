@@ -242,6 +242,22 @@
 #define CHIP_CONFIG_SHA256_CONTEXT_SIZE ((sizeof(unsigned int) * (8 + 2 + 16 + 2)) + sizeof(uint64_t))
 #endif // CHIP_CONFIG_SHA256_CONTEXT_SIZE
 
+/**
+ *  @def CHIP_CONFIG_AES_CCM_CONTEXT_SIZE
+ *
+ *  @brief
+ *    Size of the statically allocated context of a Crypto::AesCcmKeyContext in CryptoPAL
+ *
+ *    The default size is based on the OpenSSL implementation, which keeps an
+ *    EVP_CIPHER_CTX pointer (padded with its nonce and tag lengths) for each of
+ *    encryption and decryption, and a copy of the key (up to 32 bytes). The mbedTLS
+ *    one only needs a pointer. A static assert will tell us if we are wrong.
+ *
+ */
+#ifndef CHIP_CONFIG_AES_CCM_CONTEXT_SIZE
+#define CHIP_CONFIG_AES_CCM_CONTEXT_SIZE ((sizeof(void *) * 4) + 32 + 8)
+#endif // CHIP_CONFIG_AES_CCM_CONTEXT_SIZE
+
 /**
  *  @def CHIP_CONFIG_MAX_PEER_NODES
  *
@@ -342,6 +358,18 @@
 #define CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS 16
 #endif // CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS
 
+/**
+ *  @def CHIP_CONFIG_BDX_MAX_FILE_SENDERS
+ *
+ *  @brief
+ *    Maximum number of simultaneous BDX transfers served by a
+ *    bdx::FileSenderPool, each of them using an exchange context.
+ *
+ */
+#ifndef CHIP_CONFIG_BDX_MAX_FILE_SENDERS
+#define CHIP_CONFIG_BDX_MAX_FILE_SENDERS 4
+#endif // CHIP_CONFIG_BDX_MAX_FILE_SENDERS
+
 /**
  *  @def CHIP_CONFIG_MAX_ACTIVE_CHANNELS
  *
@@ -1320,6 +1348,25 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #ifndef CHIP_CONFIG_MDNS_CACHE_SIZE
 #define CHIP_CONFIG_MDNS_CACHE_SIZE 20
 #endif
+
+/**
+ * @def CHIP_CONFIG_MDNS_RESPONSE_CACHE_SIZE
+ *
+ * @brief
+ *      Define the number of replies the minimal mDNS responder keeps to answer
+ *      repeated queries without building the reply again.
+ *
+ *      Each cached reply holds a packet buffer. It defaults to 0 (disabled)
+ *      when packet buffers come from a fixed pool.
+ *
+ */
+#ifndef CHIP_CONFIG_MDNS_RESPONSE_CACHE_SIZE
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE == 0
+#define CHIP_CONFIG_MDNS_RESPONSE_CACHE_SIZE 16
+#else
+#define CHIP_CONFIG_MDNS_RESPONSE_CACHE_SIZE 0
+#endif
+#endif
 /**
  *  @name Interaction Model object pool configuration.
  *
@@ -1332,6 +1379,7 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
  *      * #CHIP_IM_MAX_REPORTS_IN_FLIGHT
  *      * #CHIP_IM_SERVER_MAX_NUM_PATH_GROUPS
  *      * #CHIP_IM_SERVER_MAX_NUM_DIRTY_SET
+ *      * #CHIP_IM_SERVER_PATH_INDEX_BUCKETS
  *      * #CHIP_IM_MAX_NUM_WRITE_HANDLER
  *      * #CHIP_IM_MAX_NUM_WRITE_CLIENT
  *      * #CHIP_IM_MAX_NUM_TIMED_HANDLER
@@ -1393,6 +1441,17 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_IM_SERVER_MAX_NUM_DIRTY_SET 8
 #endif
 
+/**
+ * @def CHIP_IM_SERVER_PATH_INDEX_BUCKETS
+ *
+ * @brief Defines the number of (endpoint, cluster) hash buckets used by the reporting engine to index the dirty set and the
+ *        attribute paths of active read handlers. More buckets reduce the number of paths visited by each SetDirty at the cost
+ *        of one pointer per bucket and per index.
+ */
+#ifndef CHIP_IM_SERVER_PATH_INDEX_BUCKETS
+#define CHIP_IM_SERVER_PATH_INDEX_BUCKETS 8
+#endif
+
 /**
  * @def CHIP_IM_MAX_NUM_WRITE_HANDLER
  *
@@ -1486,6 +1545,30 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_DEVICE_MAX_ACTIVE_CASE_CLIENTS 2
 #endif
 
+/**
+ * @def CHIP_CONFIG_CASE_SERVER_MAX_HANDSHAKES
+ *
+ * @brief Number of incoming CASE sessions the CASE server can negotiate at the same time.
+ *
+ * Each handshake in progress holds an ephemeral key pair and its own ECDH and signature
+ * work, so this also bounds the public-key crypto a burst of Sigma1 messages can queue up.
+ * Further Sigma1 messages are answered with a Busy status report.
+ */
+#ifndef CHIP_CONFIG_CASE_SERVER_MAX_HANDSHAKES
+#define CHIP_CONFIG_CASE_SERVER_MAX_HANDSHAKES 4
+#endif
+
+/**
+ * @def CHIP_CONFIG_CASE_SERVER_MAX_HANDSHAKES_PER_PEER
+ *
+ * @brief Number of the CASE server handshakes that a single peer address can hold.
+ *
+ * Keeps one peer from taking every handshake slot while others are waiting.
+ */
+#ifndef CHIP_CONFIG_CASE_SERVER_MAX_HANDSHAKES_PER_PEER
+#define CHIP_CONFIG_CASE_SERVER_MAX_HANDSHAKES_PER_PEER 2
+#endif
+
 /**
  * @def CHIP_CONFIG_DEVICE_MAX_ACTIVE_DEVICES
  *
@@ -1539,6 +1622,20 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_MAX_GROUP_CONCURRENT_ITERATORS 2
 #endif
 
+/**
+ * @def CHIP_CONFIG_GROUP_KEY_CACHE_SIZE
+ *
+ * @brief Defines the number of operational group keys the group data provider keeps in memory
+ *
+ * Each keyset-group mapping contributes one entry per epoch key of its keyset (up to 3). The
+ * cache saves the storage reads and the AES key setup otherwise done for every group message;
+ * when the mappings need more entries than this, group sessions are looked up from storage.
+ * Set to 0 to disable the cache.
+ */
+#ifndef CHIP_CONFIG_GROUP_KEY_CACHE_SIZE
+#define CHIP_CONFIG_GROUP_KEY_CACHE_SIZE 12
+#endif
+
 /**
  * @def CHIP_CONFIG_MAX_GROUP_NAME_LENGTH
  *
@@ -1578,6 +1675,17 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_EXAMPLE_ACCESS_CONTROL_MAX_TARGETS_PER_ENTRY 3
 #endif
 
+/**
+ * @def CHIP_CONFIG_ACCESS_CONTROL_DECISION_CACHE_SIZE
+ *
+ * Defines the number of recent access control decisions remembered, so that
+ * repeated checks (e.g. for every path of a wildcard read) are answered
+ * without looking at the entries. 0 disables the cache.
+ */
+#ifndef CHIP_CONFIG_ACCESS_CONTROL_DECISION_CACHE_SIZE
+#define CHIP_CONFIG_ACCESS_CONTROL_DECISION_CACHE_SIZE 8
+#endif
+
 /**
  * @def CHIP_CONFIG_EXAMPLE_ACCESS_CONTROL_ENTRY_STORAGE_POOL_SIZE
  *
@@ -1666,6 +1774,17 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE 4
 #endif
 
+/**
+ * @def CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE_PER_FABRIC
+ *
+ * @brief
+ *   Maximum number of the cached CASE sessions that can belong to peers on any one fabric. When a
+ *   fabric is at this limit, its least recently used session is evicted rather than another fabric's.
+ */
+#ifndef CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE_PER_FABRIC
+#define CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE_PER_FABRIC CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE
+#endif
+
 /**
  * @def CHIP_CONFIG_EVENT_LOGGING_BYTE_THRESHOLD
  *
@@ -1686,6 +1805,49 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_EVENT_LOGGING_BYTE_THRESHOLD 512
 #endif /* CHIP_CONFIG_EVENT_LOGGING_BYTE_THRESHOLD */
 
+/**
+ * @def CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE
+ *
+ * @brief The number of events per priority buffer whose number, path and
+ *   fabric are kept in an index, so that fetching events for a reader skips
+ *   the ones it is not interested in without decoding them.
+ *
+ * Events beyond that are still found by decoding them. Each entry takes
+ * about 24 bytes; it defaults to 0 (no index) when packet buffers come
+ * from a fixed pool.
+ *
+ */
+#ifndef CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE == 0
+#define CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE 256
+#else
+#define CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE 0
+#endif
+#endif /* CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE */
+
+/**
+ * @def CHIP_CONFIG_EVENT_LOGGING_FILE_STORE_MAX_EVENT_SIZE
+ *
+ * @brief The largest event, in bytes of TLV, that the file event store
+ *   for Linux keeps once it is evicted from the event buffers.
+ *
+ */
+#ifndef CHIP_CONFIG_EVENT_LOGGING_FILE_STORE_MAX_EVENT_SIZE
+#define CHIP_CONFIG_EVENT_LOGGING_FILE_STORE_MAX_EVENT_SIZE 1024
+#endif /* CHIP_CONFIG_EVENT_LOGGING_FILE_STORE_MAX_EVENT_SIZE */
+
+/**
+ * @def CHIP_CONFIG_EVENT_LOGGING_FILE_STORE_INDEX_SIZE
+ *
+ * @brief The number of blocks each segment of the file event store for
+ *   Linux is split in, for reads to skip the blocks holding only events
+ *   older than requested.
+ *
+ */
+#ifndef CHIP_CONFIG_EVENT_LOGGING_FILE_STORE_INDEX_SIZE
+#define CHIP_CONFIG_EVENT_LOGGING_FILE_STORE_INDEX_SIZE 64
+#endif /* CHIP_CONFIG_EVENT_LOGGING_FILE_STORE_INDEX_SIZE */
+
 /**
  * @def CHIP_CONFIG_ENABLE_SERVER_IM_EVENT
  *
@@ -272,6 +272,7 @@ CHIP_ERROR AdvertiserMinMdns::Init(chip::Inet::EndPointManager<chip::Inet::UDPEn
     // Re-set the server in the response sender in case this has been swapped in the
     // GlobalMinimalMdnsServer (used for testing).
     mResponseSender.SetServer(&GlobalMinimalMdnsServer::Server());
+    mResponseSender.InvalidateCachedReplies();
 
     ReturnErrorOnFailure(GlobalMinimalMdnsServer::Instance().StartServer(udpEndPointManager, kMdnsPort));
 
@@ -295,6 +296,7 @@ CHIP_ERROR AdvertiserMinMdns::RemoveServices()
     }
     mQueryResponderAllocatorCommissionable.Clear();
     mQueryResponderAllocatorCommissioner.Clear();
+    mResponseSender.InvalidateCachedReplies();
     return CHIP_NO_ERROR;
 }
 
@@ -327,6 +329,9 @@ CHIP_ERROR AdvertiserMinMdns::Advertise(const OperationalAdvertisingParameters &
 {
     char nameBuffer[Operational::kInstanceNameMaxLength + 1] = "";
 
+    // Replies sent so far may miss or contradict the records set up below
+    mResponseSender.InvalidateCachedReplies();
+
     /// need to set server name
     ReturnErrorOnFailure(MakeInstanceName(nameBuffer, sizeof(nameBuffer), params.GetPeerId()));
 
@@ -436,6 +441,9 @@ CHIP_ERROR AdvertiserMinMdns::GetCommissionableInstanceName(char * instanceName,
 
 CHIP_ERROR AdvertiserMinMdns::Advertise(const CommissionAdvertisingParameters & params)
 {
+    // Replies sent so far may miss or contradict the records set up below
+    mResponseSender.InvalidateCachedReplies();
+
     if (params.GetCommissionAdvertiseMode() == CommssionAdvertiseMode::kCommissionableNode)
     {
         mQueryResponderAllocatorCommissionable.Clear();
@@ -40,12 +40,15 @@ template <size_t CACHE_SIZE>
 class DnssdCache
 {
 public:
-    DnssdCache() : elementsUsed(CACHE_SIZE)
+    DnssdCache() : elementsUsed(0)
     {
-        for (ResolvedNodeData & e : mLookupTable)
+        for (uint16_t & index : mIndex)
         {
-            // each unused entry decrements the count
-            MarkEntryUnused(e);
+            index = kNoEntry;
+        }
+        for (size_t i = 0; i < CACHE_SIZE; i++)
+        {
+            mFreeEntries[i] = static_cast<uint16_t>(CACHE_SIZE - 1 - i);
         }
         MdnsLogProgress(Discovery, "construct mdns cache of size %ld", CACHE_SIZE);
     }
@@ -58,19 +61,26 @@ public:
     {
         const System::Clock::Timestamp currentTime = System::SystemClock().GetMonotonicTimestamp();
 
-        ResolvedNodeData * entry;
-
-        entry = FindPeerId(nodeData.mPeerId, currentTime);
-        if (entry)
+        size_t slot;
+        if (FindSlot(nodeData.mPeerId, slot))
         {
-            *entry = nodeData;
+            mLookupTable[mIndex[slot]] = nodeData;
             return CHIP_NO_ERROR;
         }
 
-        VerifyOrReturnError(entry = findSlot(currentTime), CHIP_ERROR_TOO_MANY_KEYS);
+        if (elementsUsed == static_cast<int>(CACHE_SIZE))
+        {
+            RemoveExpired(currentTime);
+            VerifyOrReturnError(elementsUsed < static_cast<int>(CACHE_SIZE), CHIP_ERROR_TOO_MANY_KEYS);
 
-        // have a free slot for this entry
-        *entry = nodeData;
+            // Removing entries may have moved the free index slot found above.
+            FindSlot(nodeData.mPeerId, slot);
+        }
+
+        // have a free entry for this node
+        const uint16_t entry = mFreeEntries[CACHE_SIZE - 1 - static_cast<size_t>(elementsUsed)];
+        mLookupTable[entry]  = nodeData;
+        mIndex[slot]         = entry;
         elementsUsed++;
 
         return CHIP_NO_ERROR;
@@ -78,24 +88,32 @@ public:
 
     CHIP_ERROR Delete(PeerId peerId)
     {
-        ResolvedNodeData * pentry;
         const System::Clock::Timestamp currentTime = System::SystemClock().GetMonotonicTimestamp();
 
-        VerifyOrReturnError(pentry = FindPeerId(peerId, currentTime), CHIP_ERROR_KEY_NOT_FOUND);
+        size_t slot;
+        VerifyOrReturnError(FindSlot(peerId, slot), CHIP_ERROR_KEY_NOT_FOUND);
 
-        MarkEntryUnused(*pentry);
-        return CHIP_NO_ERROR;
+        const bool expired = mLookupTable[mIndex[slot]].mExpiryTime < currentTime;
+        RemoveSlot(slot);
+
+        return expired ? CHIP_ERROR_KEY_NOT_FOUND : CHIP_NO_ERROR;
     }
 
     // given a peerId, find the parameters if its in the cache, or return error
     CHIP_ERROR Lookup(PeerId peerId, ResolvedNodeData & nodeData)
     {
-        ResolvedNodeData * pentry;
         const System::Clock::Timestamp currentTime = System::SystemClock().GetMonotonicTimestamp();
 
-        VerifyOrReturnError(pentry = FindPeerId(peerId, currentTime), CHIP_ERROR_KEY_NOT_FOUND);
+        size_t slot;
+        VerifyOrReturnError(FindSlot(peerId, slot), CHIP_ERROR_KEY_NOT_FOUND);
+
+        if (mLookupTable[mIndex[slot]].mExpiryTime < currentTime)
+        {
+            RemoveSlot(slot);
+            return CHIP_ERROR_KEY_NOT_FOUND;
+        }
 
-        nodeData = *pentry;
+        nodeData = mLookupTable[mIndex[slot]];
 
         return CHIP_NO_ERROR;
     }
@@ -103,80 +121,103 @@ public:
     // only useful if MDNS_LOGGING is set.   If not used, should be optimized out
     void DumpCache()
     {
-        int i = 0;
-
         MdnsLogProgress(Discovery, "cache size = %d", elementsUsed);
-        for (ResolvedNodeData & e : mLookupTable)
+        for (uint16_t entry : mIndex)
         {
-            if (e.mPeerId == nullPeerId)
+            if (entry == kNoEntry)
             {
-                MdnsLogProgress(Discovery, "Entry %d unused", i);
+                continue;
             }
-            else
+
+            ResolvedNodeData & e = mLookupTable[entry];
+            MdnsLogProgress(Discovery, "Entry %d: node %lx fabric %lx, port = %d", entry, e.mPeerId.GetNodeId(),
+                            e.mPeerId.GetCompressedFabricId(), e.mPort);
+            for (size_t j = 0; j < e.mNumIPs; ++j)
             {
-                MdnsLogProgress(Discovery, "Entry %d: node %lx fabric %lx, port = %d", i, e.mPeerId.GetNodeId(),
-                                e.peerId.GetFabricId(), e.port);
-                for (size_t j = 0; j < e.mNumIPs; ++j)
-                {
-                    char address[Inet::IPAddress::kMaxStringLength];
-                    e.mAddress[i].ToString(address);
-                    MdnsLogProgress(Discovery, "    address %d: %s", j, address);
-                }
+                char address[Inet::IPAddress::kMaxStringLength];
+                e.mAddress[j].ToString(address);
+                MdnsLogProgress(Discovery, "    address %d: %s", j, address);
             }
-            i++;
         }
     }
 
 private:
-    PeerId nullPeerId; // indicates a cache entry is unused
-    int elementsUsed;  // running count of how many entries are used -- for a sanity check
+    static constexpr size_t RoundUpToPowerOfTwo(size_t value, size_t power = 1)
+    {
+        return power >= value ? power : RoundUpToPowerOfTwo(value, power * 2);
+    }
+
+    // The index is an open-addressing hash table from peer id to entry, kept at most half full so that
+    // lookups stay constant time however many nodes are cached.
+    static constexpr size_t kIndexSize = RoundUpToPowerOfTwo(2 * CACHE_SIZE);
+    static constexpr size_t kIndexMask = kIndexSize - 1;
+    static constexpr uint16_t kNoEntry = UINT16_MAX;
+    static_assert(CACHE_SIZE < kNoEntry, "Cache entries are indexed with 16 bits");
+
+    int elementsUsed; // running count of how many entries are used
 
     ResolvedNodeData mLookupTable[CACHE_SIZE];
+    uint16_t mIndex[kIndexSize];
+    // Stack of unused entries: the first (CACHE_SIZE - elementsUsed) elements are free.
+    uint16_t mFreeEntries[CACHE_SIZE];
 
-    ResolvedNodeData * findSlot(System::Clock::Timestamp currentTime)
+    static size_t HashPeerId(PeerId peerId)
     {
-        for (ResolvedNodeData & entry : mLookupTable)
-        {
-            if (entry.mPeerId == nullPeerId)
-                return &entry;
+        uint64_t hash = (peerId.GetCompressedFabricId() * 0x9E3779B97F4A7C15ull) ^ peerId.GetNodeId();
+        hash ^= hash >> 29;
+        hash *= 0xBF58476D1CE4E5B9ull;
+        hash ^= hash >> 32;
+        return static_cast<size_t>(hash) & kIndexMask;
+    }
 
-            if (entry.mExpiryTime <= currentTime)
+    // Returns true and sets slot to the index slot of peerId if it is cached. Otherwise returns false and sets
+    // slot to the free index slot where it would be inserted.
+    bool FindSlot(PeerId peerId, size_t & slot) const
+    {
+        for (slot = HashPeerId(peerId); mIndex[slot] != kNoEntry; slot = (slot + 1) & kIndexMask)
+        {
+            if (mLookupTable[mIndex[slot]].mPeerId == peerId)
             {
-                MarkEntryUnused(entry);
-                return &entry;
+                return true;
             }
         }
-        return nullptr;
+        return false;
     }
 
-    ResolvedNodeData * FindPeerId(PeerId peerId, System::Clock::Timestamp current_time)
+    void RemoveSlot(size_t slot)
     {
-        for (ResolvedNodeData & entry : mLookupTable)
+        mFreeEntries[CACHE_SIZE - static_cast<size_t>(elementsUsed)] = mIndex[slot];
+        elementsUsed--;
+
+        // Shift the following entries of the probe sequence back so that no lookup stops early at the hole.
+        size_t hole = slot;
+        for (size_t next = (hole + 1) & kIndexMask; mIndex[next] != kNoEntry; next = (next + 1) & kIndexMask)
         {
-            if (entry.mPeerId == peerId)
-            {
-                if (entry.mExpiryTime < current_time)
-                {
-                    MarkEntryUnused(entry);
-                    break; // return nullptr
-                }
-                else
-                    return &entry;
-            }
-            if (entry.mPeerId != nullPeerId && entry.mExpiryTime < current_time)
+            const size_t home = HashPeerId(mLookupTable[mIndex[next]].mPeerId);
+            if (((next - home) & kIndexMask) >= ((next - hole) & kIndexMask))
             {
-                MarkEntryUnused(entry);
+                mIndex[hole] = mIndex[next];
+                hole         = next;
             }
         }
-
-        return nullptr;
+        mIndex[hole] = kNoEntry;
     }
 
-    // have a method to mark ununused --  so its easy to change
-    void MarkEntryUnused(ResolvedNodeData & pentry)
+    void RemoveExpired(System::Clock::Timestamp currentTime)
     {
-        pentry.mPeerId = nullPeerId;
-        elementsUsed--;
+        size_t slot = 0;
+        while (slot < kIndexSize)
+        {
+            // Removing a slot may shift a not yet visited entry into it, so check the same slot again.
+            if (mIndex[slot] != kNoEntry && mLookupTable[mIndex[slot]].mExpiryTime <= currentTime)
+            {
+                RemoveSlot(slot);
+            }
+            else
+            {
+                slot++;
+            }
+        }
     }
 };
 
@@ -18,6 +18,7 @@
 #include "DnssdCache.h"
 #include "Resolver.h"
 
+#include <algorithm>
 #include <limits>
 
 #include <lib/core/CHIPConfig.h>
@@ -26,6 +27,7 @@
 #include <lib/dnssd/ServiceNaming.h>
 #include <lib/dnssd/TxtFields.h>
 #include <lib/dnssd/minimal_mdns/ActiveResolveAttempts.h>
+#include <lib/dnssd/minimal_mdns/KnownAnswerCache.h>
 #include <lib/dnssd/minimal_mdns/Parser.h>
 #include <lib/dnssd/minimal_mdns/QueryBuilder.h>
 #include <lib/dnssd/minimal_mdns/RecordData.h>
@@ -71,9 +73,9 @@ class PacketDataReporter : public ParserDelegate
 {
 public:
     PacketDataReporter(ResolverDelegate * delegate, chip::Inet::InterfaceId interfaceId, DiscoveryType discoveryType,
-                       const BytesRange & packet, DnssdCacheType & mdnsCache) :
+                       const BytesRange & packet, DnssdCacheType & mdnsCache, KnownAnswerCache & knownAnswers) :
         mDelegate(delegate),
-        mDiscoveryType(discoveryType), mPacketRange(packet)
+        mDiscoveryType(discoveryType), mPacketRange(packet), mDnssdCache(mdnsCache), mKnownAnswers(knownAnswers)
     {
         mInterfaceId = interfaceId;
     }
@@ -95,11 +97,17 @@ private:
     DiscoveredNodeData mDiscoveredNodeData;
     chip::Inet::InterfaceId mInterfaceId;
     BytesRange mPacketRange;
+    DnssdCacheType & mDnssdCache;
+    KnownAnswerCache & mKnownAnswers;
 
     bool mValid       = false;
     bool mHasNodePort = false;
     bool mHasIP       = false;
 
+    // Lowest TTL of the records that make up mNodeData: the resolution is only
+    // as fresh as the first of them to expire.
+    uint64_t mNodeTtlSeconds = std::numeric_limits<uint64_t>::max();
+
     void OnCommissionableNodeSrvRecord(SerializedQNameIterator name, const SrvRecord & srv);
     void OnOperationalSrvRecord(SerializedQNameIterator name, const SrvRecord & srv);
 
@@ -238,6 +246,7 @@ void PacketDataReporter::OnResource(ResourceType type, const ResourceData & data
             if (HasQNamePart(data.GetName(), kOperationalServiceName))
             {
                 OnOperationalSrvRecord(data.GetName(), srv);
+                mNodeTtlSeconds = std::min(mNodeTtlSeconds, data.GetTtlSeconds());
             }
         }
         else if (mDiscoveryType == DiscoveryType::kCommissionableNode || mDiscoveryType == DiscoveryType::kCommissionerNode)
@@ -251,11 +260,14 @@ void PacketDataReporter::OnResource(ResourceType type, const ResourceData & data
         break;
     }
     case QType::PTR: {
-        if (mDiscoveryType == DiscoveryType::kCommissionableNode)
+        if (mDiscoveryType == DiscoveryType::kCommissionableNode || mDiscoveryType == DiscoveryType::kCommissionerNode)
         {
             SerializedQNameIterator qname;
-            ParsePtrRecord(data.GetData(), mPacketRange, &qname);
-            if (qname.Next())
+            if (ParsePtrRecord(data.GetData(), mPacketRange, &qname))
+            {
+                mKnownAnswers.OnPtrRecord(data.GetName(), qname, data.GetTtlSeconds());
+            }
+            if (mDiscoveryType == DiscoveryType::kCommissionableNode && qname.Next())
             {
                 strncpy(mDiscoveredNodeData.instanceName, qname.Value(), sizeof(DiscoveredNodeData::instanceName));
             }
@@ -272,6 +284,7 @@ void PacketDataReporter::OnResource(ResourceType type, const ResourceData & data
         {
             TxtRecordDelegateImpl<ResolvedNodeData> textRecordDelegate(mNodeData);
             ParseTxtRecord(data.GetData(), &textRecordDelegate);
+            mNodeTtlSeconds = std::min(mNodeTtlSeconds, data.GetTtlSeconds());
         }
         break;
     case QType::A: {
@@ -286,6 +299,7 @@ void PacketDataReporter::OnResource(ResourceType type, const ResourceData & data
             if (mDiscoveryType == DiscoveryType::kOperational)
             {
                 OnOperationalIPAddress(addr);
+                mNodeTtlSeconds = std::min(mNodeTtlSeconds, data.GetTtlSeconds());
             }
             else if (mDiscoveryType == DiscoveryType::kCommissionableNode || mDiscoveryType == DiscoveryType::kCommissionerNode)
             {
@@ -306,6 +320,7 @@ void PacketDataReporter::OnResource(ResourceType type, const ResourceData & data
             if (mDiscoveryType == DiscoveryType::kOperational)
             {
                 OnOperationalIPAddress(addr);
+                mNodeTtlSeconds = std::min(mNodeTtlSeconds, data.GetTtlSeconds());
             }
             else if (mDiscoveryType == DiscoveryType::kCommissionableNode || mDiscoveryType == DiscoveryType::kCommissionerNode)
             {
@@ -332,6 +347,21 @@ void PacketDataReporter::OnComplete(ActiveResolveAttempts & activeAttempts)
 
         mNodeData.LogNodeIdResolved();
         mNodeData.PrioritizeAddresses();
+
+#if CHIP_CONFIG_MDNS_CACHE_SIZE > 0
+        if (mNodeTtlSeconds == 0)
+        {
+            // Goodbye packet: the node is withdrawing its records
+            mDnssdCache.Delete(mNodeData.mPeerId);
+        }
+        else
+        {
+            const uint32_t ttlSeconds = static_cast<uint32_t>(std::min<uint64_t>(mNodeTtlSeconds, UINT32_MAX));
+            mNodeData.mExpiryTime     = System::SystemClock().GetMonotonicTimestamp() + System::Clock::Seconds32(ttlSeconds);
+            LogErrorOnFailure(mDnssdCache.Insert(mNodeData));
+        }
+#endif
+
         mDelegate->OnNodeIdResolved(mNodeData);
     }
 }
@@ -339,7 +369,7 @@ void PacketDataReporter::OnComplete(ActiveResolveAttempts & activeAttempts)
 class MinMdnsResolver : public Resolver, public MdnsPacketDelegate
 {
 public:
-    MinMdnsResolver() : mActiveResolves(&chip::System::SystemClock())
+    MinMdnsResolver() : mActiveResolves(&chip::System::SystemClock()), mKnownAnswers(&chip::System::SystemClock())
     {
         GlobalMinimalMdnsServer::Instance().SetResponseDelegate(this);
     }
@@ -360,12 +390,21 @@ private:
     DiscoveryType mDiscoveryType = DiscoveryType::kUnknown;
     System::Layer * mSystemLayer = nullptr;
     ActiveResolveAttempts mActiveResolves;
+    KnownAnswerCache mKnownAnswers;
 
     CHIP_ERROR SendPendingResolveQueries();
     CHIP_ERROR ScheduleResolveRetries();
 
     static void ResolveRetryCallback(System::Layer *, void * self);
 
+#if CHIP_CONFIG_MDNS_CACHE_SIZE > 0
+    // Peers that ResolveNodeId found in the cache, waiting for ReportCacheHits to report them.
+    PeerId mCacheHits[CHIP_CONFIG_MDNS_CACHE_SIZE];
+    size_t mCacheHitCount = 0;
+
+    static void ReportCacheHits(System::Layer *, void * self);
+#endif
+
     CHIP_ERROR SendQuery(mdns::Minimal::FullQName qname, mdns::Minimal::QType type);
     CHIP_ERROR BrowseNodes(DiscoveryType type, DiscoveryFilter subtype);
     template <typename... Args>
@@ -392,7 +431,7 @@ void MinMdnsResolver::OnMdnsPacketData(const BytesRange & data, const chip::Inet
         return;
     }
 
-    PacketDataReporter reporter(mDelegate, info->Interface, mDiscoveryType, data, sDnssdCache);
+    PacketDataReporter reporter(mDelegate, info->Interface, mDiscoveryType, data, sDnssdCache, mKnownAnswers);
 
     if (!ParsePacket(data, &reporter))
     {
@@ -421,6 +460,14 @@ CHIP_ERROR MinMdnsResolver::Init(chip::Inet::EndPointManager<chip::Inet::UDPEndP
 
 void MinMdnsResolver::Shutdown()
 {
+#if CHIP_CONFIG_MDNS_CACHE_SIZE > 0
+    if (mSystemLayer != nullptr)
+    {
+        mSystemLayer->CancelTimer(&ReportCacheHits, this);
+    }
+    mCacheHitCount = 0;
+#endif
+
     GlobalMinimalMdnsServer::Instance().ShutdownServer();
 }
 
@@ -437,6 +484,7 @@ CHIP_ERROR MinMdnsResolver::SendQuery(mdns::Minimal::FullQName qname, mdns::Mini
     query.SetAnswerViaUnicast(true);
 
     builder.AddQuery(query);
+    mKnownAnswers.AddKnownAnswers(qname, builder);
 
     ReturnErrorCodeIf(!builder.Ok(), CHIP_ERROR_INTERNAL);
 
@@ -509,11 +557,63 @@ CHIP_ERROR MinMdnsResolver::BrowseNodes(DiscoveryType type, DiscoveryFilter filt
 CHIP_ERROR MinMdnsResolver::ResolveNodeId(const PeerId & peerId, Inet::IPAddressType type, Resolver::CacheBypass dnssdCacheBypass)
 {
     mDiscoveryType = DiscoveryType::kOperational;
+
+#if CHIP_CONFIG_MDNS_CACHE_SIZE > 0
+    if (dnssdCacheBypass == Resolver::CacheBypass::Off && mDelegate != nullptr && mSystemLayer != nullptr &&
+        mCacheHitCount < ArraySize(mCacheHits))
+    {
+        // Records still within their TTL need not be queried again. The answer is still reported
+        // from the event loop, as one from the network would be, so that the caller can finish
+        // setting up for it first.
+        ResolvedNodeData nodeData;
+        if (sDnssdCache.Lookup(peerId, nodeData) == CHIP_NO_ERROR)
+        {
+            ReturnErrorOnFailure(mSystemLayer->ScheduleWork(&ReportCacheHits, this));
+            mCacheHits[mCacheHitCount++] = peerId;
+            return CHIP_NO_ERROR;
+        }
+    }
+#endif
+
     mActiveResolves.MarkPending(peerId);
 
     return SendPendingResolveQueries();
 }
 
+#if CHIP_CONFIG_MDNS_CACHE_SIZE > 0
+void MinMdnsResolver::ReportCacheHits(System::Layer *, void * self)
+{
+    auto * resolver = static_cast<MinMdnsResolver *>(self);
+
+    // The delegate may resolve again from OnNodeIdResolved, so report from a copy.
+    PeerId hits[ArraySize(resolver->mCacheHits)];
+    size_t count = resolver->mCacheHitCount;
+    std::copy(resolver->mCacheHits, resolver->mCacheHits + count, hits);
+    resolver->mCacheHitCount = 0;
+
+    bool query = false;
+    for (size_t i = 0; i < count; i++)
+    {
+        // The entry may have expired since ResolveNodeId found it, in which case the peer is queried after all.
+        ResolvedNodeData nodeData;
+        if (resolver->sDnssdCache.Lookup(hits[i], nodeData) == CHIP_NO_ERROR && resolver->mDelegate != nullptr)
+        {
+            resolver->mDelegate->OnNodeIdResolved(nodeData);
+        }
+        else
+        {
+            resolver->mActiveResolves.MarkPending(hits[i]);
+            query = true;
+        }
+    }
+
+    if (query)
+    {
+        resolver->SendPendingResolveQueries();
+    }
+}
+#endif
+
 CHIP_ERROR MinMdnsResolver::ScheduleResolveRetries()
 {
     ReturnErrorCodeIf(mSystemLayer == nullptr, CHIP_ERROR_INCORRECT_STATE);
@@ -0,0 +1,207 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "KnownAnswerCache.h"
+
+#include <lib/dnssd/minimal_mdns/records/Ptr.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <strings.h>
+
+using namespace chip;
+
+namespace mdns {
+namespace Minimal {
+
+namespace {
+
+// FNV-1a over the lower case labels, as names are compared case insensitively
+void HashPart(uint32_t & hash, const char * part)
+{
+    for (; *part != '\0'; part++)
+    {
+        hash = (hash ^ static_cast<uint8_t>(tolower(static_cast<unsigned char>(*part)))) * 16777619u;
+    }
+    hash = (hash ^ '.') * 16777619u;
+}
+
+uint32_t HashName(SerializedQNameIterator name)
+{
+    uint32_t hash = 2166136261u;
+    while (name.Next())
+    {
+        HashPart(hash, name.Value());
+    }
+    return hash;
+}
+
+uint32_t HashName(const FullQName & name)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < name.nameCount; i++)
+    {
+        HashPart(hash, name.names[i]);
+    }
+    return hash;
+}
+
+} // namespace
+
+bool KnownAnswerCache::Entry::TargetEquals(const SerializedQNameIterator & name) const
+{
+    SerializedQNameIterator it = name;
+    const char * part          = target;
+
+    for (uint8_t i = 0; i < targetPartCount; i++)
+    {
+        if (!it.Next() || strcasecmp(it.Value(), part) != 0)
+        {
+            return false;
+        }
+        part += strlen(part) + 1;
+    }
+
+    return !it.Next() && it.IsValid();
+}
+
+void KnownAnswerCache::Reset()
+{
+    for (auto & entry : mEntries)
+    {
+        entry.targetPartCount = 0;
+    }
+}
+
+void KnownAnswerCache::OnPtrRecord(const SerializedQNameIterator & service, const SerializedQNameIterator & target,
+                                   uint64_t ttlSeconds)
+{
+    const uint32_t serviceHash                 = HashName(service);
+    const System::Clock::Timestamp currentTime = mClock->GetMonotonicTimestamp();
+
+    Entry * slot = nullptr;
+    for (auto & entry : mEntries)
+    {
+        if (entry.IsUsed() && (entry.serviceHash == serviceHash) && entry.TargetEquals(target))
+        {
+            slot = &entry;
+            break;
+        }
+    }
+
+    if (slot == nullptr)
+    {
+        if (ttlSeconds == 0)
+        {
+            return;
+        }
+
+        // Prefer a free or expired entry, otherwise replace the one expiring first
+        for (auto & entry : mEntries)
+        {
+            if (!entry.IsUsed() || (entry.expiryTime <= currentTime))
+            {
+                slot = &entry;
+                break;
+            }
+            if ((slot == nullptr) || (entry.expiryTime < slot->expiryTime))
+            {
+                slot = &entry;
+            }
+        }
+    }
+
+    // Forget the previous value, in case the new one cannot be stored
+    slot->targetPartCount = 0;
+
+    if (ttlSeconds == 0)
+    {
+        return;
+    }
+
+    Entry updated;
+    size_t offset = 0;
+
+    SerializedQNameIterator it = target;
+    while (it.Next())
+    {
+        const size_t partSize = strlen(it.Value()) + 1;
+        if ((updated.targetPartCount == kMaxTargetNameParts) || (offset + partSize > sizeof(updated.target)))
+        {
+            return;
+        }
+
+        memcpy(updated.target + offset, it.Value(), partSize);
+        offset += partSize;
+        updated.targetPartCount++;
+    }
+
+    if (!it.IsValid() || (updated.targetPartCount == 0))
+    {
+        return;
+    }
+
+    updated.serviceHash = serviceHash;
+    updated.ttlSeconds  = static_cast<uint32_t>(std::min<uint64_t>(ttlSeconds, UINT32_MAX));
+    updated.expiryTime  = currentTime + System::Clock::Seconds32(updated.ttlSeconds);
+
+    *slot = updated;
+}
+
+size_t KnownAnswerCache::AddKnownAnswers(const FullQName & service, QueryBuilder & builder)
+{
+    const uint32_t serviceHash                 = HashName(service);
+    const System::Clock::Timestamp currentTime = mClock->GetMonotonicTimestamp();
+    const uint16_t initialAnswerCount          = builder.Header().GetAnswerCount();
+
+    for (auto & entry : mEntries)
+    {
+        if (!entry.IsUsed() || (entry.serviceHash != serviceHash) || (entry.expiryTime <= currentTime))
+        {
+            continue;
+        }
+
+        // RFC 6762 section 7.1: a known answer is only valid if at least half of its TTL remains
+        const System::Clock::Timestamp remaining = entry.expiryTime - currentTime;
+        if (remaining * 2 < System::Clock::Seconds32(entry.ttlSeconds))
+        {
+            continue;
+        }
+
+        QNamePart parts[kMaxTargetNameParts];
+        const char * part = entry.target;
+        for (uint8_t i = 0; i < entry.targetPartCount; i++)
+        {
+            parts[i] = part;
+            part += strlen(part) + 1;
+        }
+
+        FullQName target;
+        target.names     = parts;
+        target.nameCount = entry.targetPartCount;
+
+        PtrResourceRecord record(service, target);
+        record.SetTtl(std::chrono::duration_cast<System::Clock::Seconds32>(remaining).count());
+        builder.AddAnswer(record);
+    }
+
+    return static_cast<size_t>(builder.Header().GetAnswerCount() - initialAnswerCount);
+}
+
+} // namespace Minimal
+} // namespace mdns
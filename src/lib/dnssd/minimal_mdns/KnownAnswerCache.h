@@ -0,0 +1,84 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <lib/dnssd/minimal_mdns/QueryBuilder.h>
+#include <lib/dnssd/minimal_mdns/core/QName.h>
+#include <system/SystemClock.h>
+
+namespace mdns {
+namespace Minimal {
+
+/// Remembers PTR records received while browsing for services, so that they
+/// can be sent as known answers (RFC 6762 section 7.1) the next time the same
+/// service is browsed.
+///
+/// Responders do not repeat a PTR record that the query lists with at least
+/// half of its TTL remaining, so the replies to a repeated browse only carry
+/// the instances that are new or about to expire.
+class KnownAnswerCache
+{
+public:
+    static constexpr size_t kCacheSize          = 16;
+    static constexpr size_t kMaxTargetNameParts = 6;
+    static constexpr size_t kMaxTargetNameSize  = 128;
+
+    KnownAnswerCache(chip::System::Clock::ClockBase * clock) : mClock(clock) { Reset(); }
+
+    /// Forget all cached records
+    void Reset();
+
+    /// Remember that `service` points to `target` for `ttlSeconds`.
+    ///
+    /// A zero TTL (goodbye packet) removes the record. When the cache is full,
+    /// the record closest to expiring is replaced.
+    void OnPtrRecord(const SerializedQNameIterator & service, const SerializedQNameIterator & target, uint64_t ttlSeconds);
+
+    /// Add the cached PTR records of `service` that still have more than half
+    /// of their TTL left to the answer section of `builder`.
+    ///
+    /// Returns the number of records offered as known answers.
+    size_t AddKnownAnswers(const FullQName & service, QueryBuilder & builder);
+
+private:
+    struct Entry
+    {
+        // Hash of the PTR record name. Entries are never compared by name: a
+        // collision at worst sends a known answer that no responder owns.
+        uint32_t serviceHash = 0;
+
+        // NUL separated labels of the PTR target. Unused entries have no parts.
+        char target[kMaxTargetNameSize];
+        uint8_t targetPartCount = 0;
+
+        uint32_t ttlSeconds = 0;
+        chip::System::Clock::Timestamp expiryTime;
+
+        bool IsUsed() const { return targetPartCount != 0; }
+        bool TargetEquals(const SerializedQNameIterator & name) const;
+    };
+
+    chip::System::Clock::ClockBase * mClock;
+    Entry mEntries[kCacheSize];
+};
+
+} // namespace Minimal
+} // namespace mdns
@@ -0,0 +1,250 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "ResponseCache.h"
+
+#if CHIP_CONFIG_MDNS_RESPONSE_CACHE_SIZE > 0
+
+#include <cstring>
+
+#include <lib/support/CodeUtils.h>
+
+using namespace chip;
+
+namespace mdns {
+namespace Minimal {
+
+namespace {
+
+/// Writes `name` as a sequence of length prefixed labels, ending with the
+/// empty label.
+///
+/// Returns false if the name is invalid or does not fit in `outSize` bytes.
+bool FlattenName(SerializedQNameIterator name, uint8_t * out, size_t outSize, size_t & size)
+{
+    size = 0;
+    while (name.Next())
+    {
+        size_t labelSize = strlen(name.Value());
+
+        // Leave room for the final empty label
+        if (size + 1 + labelSize + 1 > outSize)
+        {
+            return false;
+        }
+
+        out[size++] = static_cast<uint8_t>(labelSize);
+        memcpy(out + size, name.Value(), labelSize);
+        size += labelSize;
+    }
+
+    if (!name.IsValid())
+    {
+        return false;
+    }
+
+    out[size++] = 0;
+    return true;
+}
+
+/// Mirrors the multicast throttle that ResponseSender applies through
+/// QueryResponderRecordFilter (https://tools.ietf.org/html/rfc6762#section-6).
+bool IsMulticastThrottled(const QueryResponderRecord * record, System::Clock::Timestamp now)
+{
+    const System::Clock::Timestamp includeOnlyBefore = now - System::Clock::Seconds32(1);
+    return (includeOnlyBefore > System::Clock::kZero) && (record->lastMulticastTime >= includeOnlyBefore);
+}
+
+} // namespace
+
+constexpr System::Clock::Milliseconds32 ResponseCache::kMaxAge;
+
+bool ResponseCache::Entry::Matches(const uint8_t * name, size_t nameSize, const QueryData & query, Inet::InterfaceId queryInterface,
+                                   bool queryIncludeQuery) const
+{
+    // Whether the reply is sent unicast follows from unicastRequested and includeQuery (both set by a query from a port
+    // other than the mDNS one), so two queries that match also agree on it.
+    return (queryNameSize == nameSize) && (type == query.GetType()) && (klass == query.GetClass()) &&
+        (unicastRequested == query.RequestedUnicastAnswer()) && (includeQuery == queryIncludeQuery) &&
+        (interface == queryInterface) && (memcmp(queryName, name, nameSize) == 0);
+}
+
+void ResponseCache::Entry::Clear()
+{
+    queryNameSize = 0;
+    answerCount   = 0;
+    reply         = nullptr;
+    valid         = false;
+}
+
+void ResponseCache::Invalidate()
+{
+    for (auto & entry : mEntries)
+    {
+        entry.Clear();
+    }
+    mRecording = nullptr;
+}
+
+System::PacketBufferHandle ResponseCache::CopyReply(const QueryData & query, Inet::InterfaceId interface, bool includeQuery,
+                                                    bool sendUnicast, System::Clock::Timestamp now)
+{
+    uint8_t name[kMaxQueryNameSize];
+    size_t nameSize;
+
+    if (query.IsBootAdvertising() || !FlattenName(query.GetName(), name, sizeof(name), nameSize))
+    {
+        return System::PacketBufferHandle();
+    }
+
+    for (auto & entry : mEntries)
+    {
+        if (!entry.valid || !entry.Matches(name, nameSize, query, interface, includeQuery))
+        {
+            continue;
+        }
+
+        if (now - entry.createdTime >= kMaxAge)
+        {
+            entry.Clear();
+            return System::PacketBufferHandle();
+        }
+
+        if (!sendUnicast)
+        {
+            for (size_t i = 0; i < entry.answerCount; i++)
+            {
+                if (IsMulticastThrottled(entry.answers[i], now))
+                {
+                    return System::PacketBufferHandle();
+                }
+            }
+        }
+
+        System::PacketBufferHandle copy = entry.reply.CloneData();
+        if (!copy.IsNull() && !sendUnicast)
+        {
+            for (size_t i = 0; i < entry.answerCount; i++)
+            {
+                entry.answers[i]->lastMulticastTime = now;
+            }
+        }
+        return copy;
+    }
+
+    return System::PacketBufferHandle();
+}
+
+void ResponseCache::StartReply(const QueryData & query, Inet::InterfaceId interface, bool includeQuery,
+                               System::Clock::Timestamp now)
+{
+    uint8_t name[kMaxQueryNameSize];
+    size_t nameSize;
+
+    mRecording = nullptr;
+
+    if (query.IsBootAdvertising() || !FlattenName(query.GetName(), name, sizeof(name), nameSize))
+    {
+        return;
+    }
+
+    // Replace a stale reply to the same query if there is one, otherwise the
+    // first free entry, otherwise the oldest reply.
+    Entry * slot = nullptr;
+    for (auto & entry : mEntries)
+    {
+        if (entry.valid && entry.Matches(name, nameSize, query, interface, includeQuery))
+        {
+            slot = &entry;
+            break;
+        }
+        if (slot == nullptr || (slot->valid && (!entry.valid || entry.createdTime < slot->createdTime)))
+        {
+            slot = &entry;
+        }
+    }
+
+    slot->Clear();
+    memcpy(slot->queryName, name, nameSize);
+    slot->queryNameSize    = nameSize;
+    slot->type             = query.GetType();
+    slot->klass            = query.GetClass();
+    slot->unicastRequested = query.RequestedUnicastAnswer();
+    slot->includeQuery     = includeQuery;
+    slot->interface        = interface;
+    slot->createdTime      = now;
+
+    mRecording = slot;
+}
+
+void ResponseCache::AddAnswer(QueryResponderRecord * answer)
+{
+    VerifyOrReturn(mRecording != nullptr);
+
+    if (mRecording->answerCount == kMaxAnswers)
+    {
+        CancelReply();
+        return;
+    }
+
+    mRecording->answers[mRecording->answerCount++] = answer;
+}
+
+void ResponseCache::AddPacket(const System::PacketBufferHandle & packet)
+{
+    VerifyOrReturn(mRecording != nullptr);
+
+    if (!mRecording->reply.IsNull())
+    {
+        CancelReply();
+        return;
+    }
+
+    mRecording->reply = packet.CloneData();
+    if (mRecording->reply.IsNull())
+    {
+        CancelReply();
+    }
+}
+
+void ResponseCache::CancelReply()
+{
+    VerifyOrReturn(mRecording != nullptr);
+
+    mRecording->Clear();
+    mRecording = nullptr;
+}
+
+void ResponseCache::FinishReply()
+{
+    VerifyOrReturn(mRecording != nullptr);
+
+    if (mRecording->reply.IsNull())
+    {
+        mRecording->Clear();
+    }
+    else
+    {
+        mRecording->valid = true;
+    }
+    mRecording = nullptr;
+}
+
+} // namespace Minimal
+} // namespace mdns
+
+#endif // CHIP_CONFIG_MDNS_RESPONSE_CACHE_SIZE > 0
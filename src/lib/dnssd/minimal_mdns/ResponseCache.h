@@ -0,0 +1,140 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <inet/InetInterface.h>
+#include <lib/core/CHIPConfig.h>
+#include <lib/dnssd/minimal_mdns/Parser.h>
+#include <lib/dnssd/minimal_mdns/responders/QueryResponder.h>
+#include <system/SystemClock.h>
+#include <system/SystemPacketBuffer.h>
+
+namespace mdns {
+namespace Minimal {
+
+#if CHIP_CONFIG_MDNS_RESPONSE_CACHE_SIZE > 0
+
+/// Keeps the replies recently sent by a ResponseSender, so that a repeated
+/// query is answered with a copy of the previous reply instead of walking all
+/// responders and serializing every record again (which for A/AAAA records
+/// includes listing the interface addresses).
+///
+/// A cached reply is sent as is, with only the message id updated: name
+/// compression pointers are relative to the start of the packet and remain
+/// valid in the copy.
+///
+/// Cached replies must be invalidated whenever the responders change. They
+/// also expire after kMaxAge, as not all platforms report interface address
+/// changes.
+class ResponseCache
+{
+public:
+    static constexpr size_t kCacheSize        = CHIP_CONFIG_MDNS_RESPONSE_CACHE_SIZE;
+    static constexpr size_t kMaxAnswers       = 16;
+    static constexpr size_t kMaxQueryNameSize = 128;
+
+    static constexpr chip::System::Clock::Milliseconds32 kMaxAge = chip::System::Clock::Milliseconds32(1000);
+
+    /// Forget all cached replies
+    void Invalidate();
+
+    /// Returns a copy of the cached reply to `query`, or a null handle if
+    /// there is none.
+    ///
+    /// Multicast replies are not returned while any of their answers is still
+    /// throttled (multicast less than a second before `now`), as a reply built
+    /// from the responders would leave it out. When a multicast reply is
+    /// returned, its answers are marked as multicast at `now`.
+    chip::System::PacketBufferHandle CopyReply(const QueryData & query, chip::Inet::InterfaceId interface, bool includeQuery,
+                                               bool sendUnicast, chip::System::Clock::Timestamp now);
+
+    /// Start recording the reply to `query`. Queries that cannot be cached are
+    /// ignored.
+    void StartReply(const QueryData & query, chip::Inet::InterfaceId interface, bool includeQuery,
+                    chip::System::Clock::Timestamp now);
+
+    /// Add an answer of the reply being recorded
+    void AddAnswer(QueryResponderRecord * answer);
+
+    /// Add a packet of the reply being recorded. Replies split over several
+    /// packets are not cached.
+    void AddPacket(const chip::System::PacketBufferHandle & packet);
+
+    /// Prevent the reply being recorded from being cached
+    void CancelReply();
+
+    /// Cache the reply being recorded, if it was sent in a single packet
+    void FinishReply();
+
+private:
+    struct Entry
+    {
+        // Uncompressed query name, including the final empty label
+        uint8_t queryName[kMaxQueryNameSize];
+        size_t queryNameSize = 0;
+
+        QType type;
+        QClass klass;
+        bool unicastRequested;
+        bool includeQuery;
+        chip::Inet::InterfaceId interface;
+
+        QueryResponderRecord * answers[kMaxAnswers];
+        size_t answerCount = 0;
+
+        chip::System::Clock::Timestamp createdTime;
+        chip::System::PacketBufferHandle reply;
+        bool valid = false;
+
+        bool Matches(const uint8_t * name, size_t nameSize, const QueryData & query, chip::Inet::InterfaceId queryInterface,
+                     bool queryIncludeQuery) const;
+        void Clear();
+    };
+
+    Entry mEntries[kCacheSize];
+    Entry * mRecording = nullptr;
+};
+
+#else
+
+/// Response caching is disabled: every reply is built from the responders.
+class ResponseCache
+{
+public:
+    void Invalidate() {}
+    chip::System::PacketBufferHandle CopyReply(const QueryData & query, chip::Inet::InterfaceId interface, bool includeQuery,
+                                               bool sendUnicast, chip::System::Clock::Timestamp now)
+    {
+        return chip::System::PacketBufferHandle();
+    }
+    void StartReply(const QueryData & query, chip::Inet::InterfaceId interface, bool includeQuery,
+                    chip::System::Clock::Timestamp now)
+    {}
+    void AddAnswer(QueryResponderRecord * answer) {}
+    void AddPacket(const chip::System::PacketBufferHandle & packet) {}
+    void CancelReply() {}
+    void FinishReply() {}
+};
+
+#endif // CHIP_CONFIG_MDNS_RESPONSE_CACHE_SIZE > 0
+
+} // namespace Minimal
+} // namespace mdns
@@ -66,6 +66,7 @@ CHIP_ERROR ResponseSender::AddQueryResponder(QueryResponderBase * queryResponder
         if (mResponder[i] == nullptr || mResponder[i] == queryResponder)
         {
             mResponder[i] = queryResponder;
+            mResponseCache.Invalidate();
             return CHIP_NO_ERROR;
         }
     }
@@ -76,6 +77,19 @@ CHIP_ERROR ResponseSender::Respond(uint32_t messageId, const QueryData & query,
 {
     mSendState.Reset(messageId, query, querySource);
 
+    const chip::System::Clock::Timestamp kTimeNow = chip::System::SystemClock().GetMonotonicTimestamp();
+
+    // A repeated query gets a copy of the reply sent last time
+    chip::System::PacketBufferHandle cachedReply = mResponseCache.CopyReply(
+        query, querySource->Interface, mSendState.IncludeQuery(), mSendState.SendUnicast(), kTimeNow);
+    if (!cachedReply.IsNull())
+    {
+        HeaderRef(cachedReply->Start()).SetMessageId(static_cast<uint16_t>(messageId));
+        return SendReply(std::move(cachedReply));
+    }
+
+    mResponseCache.StartReply(query, querySource->Interface, mSendState.IncludeQuery(), kTimeNow);
+
     // Responder has a stateful 'additional replies required' that is used within the response
     // loop. 'no additionals required' is set at the start and additionals are marked as the query
     // reply is built.
@@ -89,13 +103,15 @@ CHIP_ERROR ResponseSender::Respond(uint32_t messageId, const QueryData & query,
 
     // send all 'Answer' replies
     {
-        const chip::System::Clock::Timestamp kTimeNow = chip::System::SystemClock().GetMonotonicTimestamp();
-
         QueryReplyFilter queryReplyFilter(query);
         QueryResponderRecordFilter responseFilter;
 
         responseFilter.SetReplyFilter(&queryReplyFilter);
 
+        // Records that are throttled are skipped below rather than filtered out, as
+        // a reply missing some of them must not be cached.
+        QueryResponderRecordFilter unthrottledFilter = responseFilter;
+
         if (!mSendState.SendUnicast())
         {
             // According to https://tools.ietf.org/html/rfc6762#section-6  we should multicast at most 1/sec
@@ -110,11 +126,18 @@ CHIP_ERROR ResponseSender::Respond(uint32_t messageId, const QueryData & query,
             {
                 continue;
             }
-            for (auto it = mResponder[i]->begin(&responseFilter); it != mResponder[i]->end(); it++)
+            for (auto it = mResponder[i]->begin(&unthrottledFilter); it != mResponder[i]->end(); it++)
             {
+                if (!responseFilter.Accept(it.GetInternal()))
+                {
+                    mResponseCache.CancelReply();
+                    continue;
+                }
+
                 it->responder->AddAllResponses(querySource, this);
                 ReturnErrorOnFailure(mSendState.GetError());
 
+                mResponseCache.AddAnswer(&*it);
                 mResponder[i]->MarkAdditionalRepliesFor(it);
 
                 if (!mSendState.SendUnicast())
@@ -151,7 +174,10 @@ CHIP_ERROR ResponseSender::Respond(uint32_t messageId, const QueryData & query,
         }
     }
 
-    return FlushReply();
+    ReturnErrorOnFailure(FlushReply());
+    mResponseCache.FinishReply();
+
+    return CHIP_NO_ERROR;
 }
 
 CHIP_ERROR ResponseSender::FlushReply()
@@ -160,27 +186,31 @@ CHIP_ERROR ResponseSender::FlushReply()
 
     if (mResponseBuilder.HasResponseRecords())
     {
-        char srcAddressString[chip::Inet::IPAddress::kMaxStringLength];
-        VerifyOrDie(mSendState.GetSourceAddress().ToString(srcAddressString) != nullptr);
-
-        if (mSendState.SendUnicast())
-        {
-            ChipLogDetail(Discovery, "Directly sending mDns reply to peer %s on port %d", srcAddressString,
-                          mSendState.GetSourcePort());
-            ReturnErrorOnFailure(mServer->DirectSend(mResponseBuilder.ReleasePacket(), mSendState.GetSourceAddress(),
-                                                     mSendState.GetSourcePort(), mSendState.GetSourceInterfaceId()));
-        }
-        else
-        {
-            ChipLogDetail(Discovery, "Broadcasting mDns reply for query from %s", srcAddressString);
-            ReturnErrorOnFailure(mServer->BroadcastSend(mResponseBuilder.ReleasePacket(), kMdnsStandardPort,
-                                                        mSendState.GetSourceInterfaceId(), mSendState.GetSourceAddress().Type()));
-        }
+        chip::System::PacketBufferHandle reply = mResponseBuilder.ReleasePacket();
+        mResponseCache.AddPacket(reply);
+        ReturnErrorOnFailure(SendReply(std::move(reply)));
     }
 
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR ResponseSender::SendReply(chip::System::PacketBufferHandle && reply)
+{
+    char srcAddressString[chip::Inet::IPAddress::kMaxStringLength];
+    VerifyOrDie(mSendState.GetSourceAddress().ToString(srcAddressString) != nullptr);
+
+    if (mSendState.SendUnicast())
+    {
+        ChipLogDetail(Discovery, "Directly sending mDns reply to peer %s on port %d", srcAddressString, mSendState.GetSourcePort());
+        return mServer->DirectSend(std::move(reply), mSendState.GetSourceAddress(), mSendState.GetSourcePort(),
+                                   mSendState.GetSourceInterfaceId());
+    }
+
+    ChipLogDetail(Discovery, "Broadcasting mDns reply for query from %s", srcAddressString);
+    return mServer->BroadcastSend(std::move(reply), kMdnsStandardPort, mSendState.GetSourceInterfaceId(),
+                                  mSendState.GetSourceAddress().Type());
+}
+
 CHIP_ERROR ResponseSender::PrepareNewReplyPacket()
 {
     chip::System::PacketBufferHandle buffer = chip::System::PacketBufferHandle::New(kPacketSizeBytes);
@@ -19,6 +19,7 @@
 
 #include "Parser.h"
 #include "ResponseBuilder.h"
+#include "ResponseCache.h"
 #include "Server.h"
 
 #include <lib/dnssd/minimal_mdns/responders/QueryResponder.h>
@@ -102,12 +103,18 @@ public:
 
     void SetServer(ServerBase * server) { mServer = server; }
 
+    /// Forget previously sent replies. Must be called whenever the records
+    /// of any of the query responders change.
+    void InvalidateCachedReplies() { mResponseCache.Invalidate(); }
+
 private:
     CHIP_ERROR FlushReply();
+    CHIP_ERROR SendReply(chip::System::PacketBufferHandle && reply);
     CHIP_ERROR PrepareNewReplyPacket();
 
     ServerBase * mServer;
     QueryResponderBase * mResponder[kMaxQueryResponders] = {};
+    ResponseCache mResponseCache; // replies to repeated queries
 
     /// Current send state
     ResponseBuilder mResponseBuilder;          // packet being built
@@ -0,0 +1,216 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <lib/dnssd/minimal_mdns/KnownAnswerCache.h>
+
+#include <lib/dnssd/minimal_mdns/Parser.h>
+#include <lib/dnssd/minimal_mdns/QueryBuilder.h>
+#include <lib/dnssd/minimal_mdns/RecordData.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <system/SystemPacketBuffer.h>
+
+#include <nlunit-test.h>
+
+#include <string.h>
+
+namespace {
+
+using namespace chip;
+using namespace chip::System::Clock::Literals;
+using namespace mdns::Minimal;
+
+const uint8_t kService[] = "\010_matterc\004_udp\005local";
+const uint8_t kNode1[]   = "\005node1\010_matterc\004_udp\005local";
+const uint8_t kNode2[]   = "\005NODE2\010_matterc\004_udp\005local";
+const uint8_t kOther[]   = "\010_matterd\004_udp\005local";
+
+SerializedQNameIterator Name(const uint8_t * data, size_t size)
+{
+    return SerializedQNameIterator(BytesRange(data, data + size), data);
+}
+
+#define NAME(n) Name(n, sizeof(n))
+
+const QNamePart kServiceParts[] = { "_matterc", "_udp", "local" };
+
+/// Collects the PTR known answers of a query packet
+class AnswerCollector : public ParserDelegate
+{
+public:
+    static constexpr size_t kMaxAnswers = KnownAnswerCache::kCacheSize;
+
+    AnswerCollector(const BytesRange & packet) : mPacket(packet) {}
+
+    void OnHeader(ConstHeaderRef & header) override { mTruncated = header.GetFlags().IsTruncated(); }
+    void OnQuery(const QueryData & data) override { mQueryCount++; }
+    void OnResource(ResourceType type, const ResourceData & data) override
+    {
+        if ((type != ResourceType::kAnswer) || (data.GetType() != QType::PTR) || (mAnswerCount == kMaxAnswers))
+        {
+            return;
+        }
+
+        mNameMatches[mAnswerCount] = (data.GetName() == FullQName(kServiceParts));
+        mTtl[mAnswerCount]         = data.GetTtlSeconds();
+
+        SerializedQNameIterator target;
+        if (ParsePtrRecord(data.GetData(), mPacket, &target) && target.Next())
+        {
+            strncpy(mTargets[mAnswerCount], target.Value(), sizeof(mTargets[mAnswerCount]) - 1);
+        }
+        mAnswerCount++;
+    }
+
+    size_t mQueryCount  = 0;
+    size_t mAnswerCount = 0;
+    bool mTruncated     = false;
+    bool mNameMatches[kMaxAnswers];
+    uint64_t mTtl[kMaxAnswers];
+    char mTargets[kMaxAnswers][64] = {};
+
+private:
+    BytesRange mPacket;
+};
+
+/// Builds a browse query for kService with known answers from the cache and parses it back
+size_t BuildQuery(nlTestSuite * inSuite, KnownAnswerCache & cache, AnswerCollector & collector, System::PacketBufferHandle & buffer,
+                  size_t bufferSize = 1024)
+{
+    buffer = System::PacketBufferHandle::New(bufferSize);
+    NL_TEST_ASSERT(inSuite, !buffer.IsNull());
+
+    QueryBuilder builder(std::move(buffer));
+    builder.Header().SetMessageId(0);
+    builder.AddQuery(Query(FullQName(kServiceParts)).SetType(QType::ANY).SetClass(QClass::IN));
+    size_t added = cache.AddKnownAnswers(FullQName(kServiceParts), builder);
+    NL_TEST_ASSERT(inSuite, builder.Ok());
+
+    buffer = builder.ReleasePacket();
+    BytesRange packet(buffer->Start(), buffer->Start() + buffer->DataLength());
+    collector = AnswerCollector(packet);
+    NL_TEST_ASSERT(inSuite, ParsePacket(packet, &collector));
+    NL_TEST_ASSERT(inSuite, collector.mQueryCount == 1);
+    NL_TEST_ASSERT(inSuite, collector.mAnswerCount == added);
+
+    return added;
+}
+
+void TestAddKnownAnswers(nlTestSuite * inSuite, void * inContext)
+{
+    System::Clock::Internal::MockClock mockClock;
+    KnownAnswerCache cache(&mockClock);
+    System::PacketBufferHandle buffer;
+    AnswerCollector collector(BytesRange(nullptr, nullptr));
+
+    mockClock.AdvanceMonotonic(1000_ms32);
+
+    // Nothing cached: the query has no answers
+    NL_TEST_ASSERT(inSuite, BuildQuery(inSuite, cache, collector, buffer) == 0);
+
+    cache.OnPtrRecord(NAME(kService), NAME(kNode1), 120);
+    cache.OnPtrRecord(NAME(kService), NAME(kNode2), 4500);
+    cache.OnPtrRecord(NAME(kOther), NAME(kNode1), 120);
+
+    NL_TEST_ASSERT(inSuite, BuildQuery(inSuite, cache, collector, buffer) == 2);
+    NL_TEST_ASSERT(inSuite, collector.mNameMatches[0] && collector.mNameMatches[1]);
+    NL_TEST_ASSERT(inSuite, strcmp(collector.mTargets[0], "node1") == 0);
+    NL_TEST_ASSERT(inSuite, collector.mTtl[0] == 120);
+    NL_TEST_ASSERT(inSuite, strcmp(collector.mTargets[1], "NODE2") == 0);
+    NL_TEST_ASSERT(inSuite, collector.mTtl[1] == 4500);
+    NL_TEST_ASSERT(inSuite, !collector.mTruncated);
+
+    // Known answers carry the remaining TTL
+    mockClock.AdvanceMonotonic(30_s);
+    NL_TEST_ASSERT(inSuite, BuildQuery(inSuite, cache, collector, buffer) == 2);
+    NL_TEST_ASSERT(inSuite, collector.mTtl[0] == 90);
+    NL_TEST_ASSERT(inSuite, collector.mTtl[1] == 4470);
+
+    // Past half of its TTL a record is no longer a valid known answer
+    mockClock.AdvanceMonotonic(31_s);
+    NL_TEST_ASSERT(inSuite, BuildQuery(inSuite, cache, collector, buffer) == 1);
+    NL_TEST_ASSERT(inSuite, strcmp(collector.mTargets[0], "NODE2") == 0);
+
+    // A refreshed record is offered again, names are not case sensitive
+    const uint8_t node1Upper[] = "\005NoDe1\010_MATTERC\004_udp\005local";
+    cache.OnPtrRecord(NAME(kService), NAME(node1Upper), 120);
+    NL_TEST_ASSERT(inSuite, BuildQuery(inSuite, cache, collector, buffer) == 2);
+
+    // Goodbye packets remove the record
+    cache.OnPtrRecord(NAME(kService), NAME(kNode2), 0);
+    NL_TEST_ASSERT(inSuite, BuildQuery(inSuite, cache, collector, buffer) == 1);
+    NL_TEST_ASSERT(inSuite, strcasecmp(collector.mTargets[0], "node1") == 0);
+
+    cache.Reset();
+    NL_TEST_ASSERT(inSuite, BuildQuery(inSuite, cache, collector, buffer) == 0);
+}
+
+void TestCacheFull(nlTestSuite * inSuite, void * inContext)
+{
+    System::Clock::Internal::MockClock mockClock;
+    KnownAnswerCache cache(&mockClock);
+    System::PacketBufferHandle buffer;
+    AnswerCollector collector(BytesRange(nullptr, nullptr));
+
+    uint8_t node[] = "\005nodeA\010_matterc\004_udp\005local";
+
+    // The record expiring first is replaced when the cache is full
+    for (size_t i = 0; i <= KnownAnswerCache::kCacheSize; i++)
+    {
+        node[5] = static_cast<uint8_t>('A' + i);
+        cache.OnPtrRecord(NAME(kService), NAME(node), 1000 + i);
+    }
+
+    NL_TEST_ASSERT(inSuite, BuildQuery(inSuite, cache, collector, buffer) == KnownAnswerCache::kCacheSize);
+    for (size_t i = 0; i < collector.mAnswerCount; i++)
+    {
+        NL_TEST_ASSERT(inSuite, strcmp(collector.mTargets[i], "nodeA") != 0);
+    }
+
+    // Answers that do not fit are left out without failing the query
+    const size_t fitting = BuildQuery(inSuite, cache, collector, buffer, 128);
+    NL_TEST_ASSERT(inSuite, fitting > 0);
+    NL_TEST_ASSERT(inSuite, fitting < KnownAnswerCache::kCacheSize);
+    NL_TEST_ASSERT(inSuite, !collector.mTruncated);
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("TestAddKnownAnswers", TestAddKnownAnswers), //
+    NL_TEST_DEF("TestCacheFull", TestCacheFull),             //
+    NL_TEST_SENTINEL()                                       //
+};
+
+int Setup(void * inContext)
+{
+    return (Platform::MemoryInit() == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+int Teardown(void * inContext)
+{
+    Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+} // namespace
+
+int TestKnownAnswerCache(void)
+{
+    nlTestSuite theSuite = { "KnownAnswerCache", sTests, Setup, Teardown };
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestKnownAnswerCache)
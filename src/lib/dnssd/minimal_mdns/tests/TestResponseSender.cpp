@@ -22,6 +22,7 @@
 #include <lib/dnssd/minimal_mdns/RecordData.h>
 #include <lib/dnssd/minimal_mdns/core/FlatAllocatedQName.h>
 #include <lib/dnssd/minimal_mdns/core/RecordWriter.h>
+#include <lib/dnssd/minimal_mdns/responders/IP.h>
 #include <lib/dnssd/minimal_mdns/responders/Ptr.h>
 #include <lib/dnssd/minimal_mdns/responders/Srv.h>
 #include <lib/dnssd/minimal_mdns/responders/Txt.h>
@@ -29,6 +30,7 @@
 
 #include <lib/support/CHIPMem.h>
 #include <lib/support/UnitTestRegistration.h>
+#include <system/SystemClock.h>
 
 #include <nlunit-test.h>
 
@@ -339,6 +341,192 @@ void PtrSrvTxtMultipleRespondersToServiceListing(nlTestSuite * inSuite, void * i
     NL_TEST_ASSERT(inSuite, common1.server.GetHeaderFound());
 }
 
+/// Counts the replies it is asked to add its record to
+class CountingSrvResponder : public SrvResponder
+{
+public:
+    CountingSrvResponder(const SrvResourceRecord & record) : SrvResponder(record) {}
+
+    void AddAllResponses(const chip::Inet::IPPacketInfo * source, ResponderDelegate * delegate) override
+    {
+        mCallCount++;
+        SrvResponder::AddAllResponses(source, delegate);
+    }
+
+    uint32_t GetCallCount() const { return mCallCount; }
+
+private:
+    uint32_t mCallCount = 0;
+};
+
+void RepeatedQueryToInstance(nlTestSuite * inSuite, void * inContext)
+{
+    CommonTestElements common(inSuite, "test");
+    CountingSrvResponder srvResponder(common.srvRecord);
+    ResponseSender responseSender(&common.server);
+    NL_TEST_ASSERT(inSuite, responseSender.AddQueryResponder(&common.queryResponder) == CHIP_NO_ERROR);
+    common.queryResponder.AddResponder(&srvResponder);
+
+    // Build a query for the instance name
+    common.recordWriter.WriteQName(common.instance);
+
+    QueryData queryData = QueryData(QType::ANY, QClass::IN, false, common.requestNameStart, common.requestBytesRange);
+
+    // The same query twice gets the same reply.
+    for (uint32_t messageId : { 1u, 2u })
+    {
+        common.server.Reset();
+        common.server.AddExpectedRecord(&common.srvRecord);
+        responseSender.Respond(messageId, queryData, &common.packetInfo);
+
+        NL_TEST_ASSERT(inSuite, common.server.GetSendCalled());
+        NL_TEST_ASSERT(inSuite, common.server.GetHeaderFound());
+    }
+
+#if CHIP_CONFIG_MDNS_RESPONSE_CACHE_SIZE > 0
+    // The second reply is the cached copy of the first: the responders were not asked again.
+    NL_TEST_ASSERT(inSuite, srvResponder.GetCallCount() == 1);
+#else
+    NL_TEST_ASSERT(inSuite, srvResponder.GetCallCount() == 2);
+#endif // CHIP_CONFIG_MDNS_RESPONSE_CACHE_SIZE > 0
+
+    // Once the records change and the previous replies are dropped, the new record is included.
+    common.queryResponder.AddResponder(&common.txtResponder);
+    responseSender.InvalidateCachedReplies();
+
+    common.server.Reset();
+    common.server.AddExpectedRecord(&common.srvRecord);
+    common.server.AddExpectedRecord(&common.txtRecord);
+    responseSender.Respond(3, queryData, &common.packetInfo);
+
+    NL_TEST_ASSERT(inSuite, common.server.GetSendCalled());
+    NL_TEST_ASSERT(inSuite, common.server.GetHeaderFound());
+#if CHIP_CONFIG_MDNS_RESPONSE_CACHE_SIZE > 0
+    NL_TEST_ASSERT(inSuite, srvResponder.GetCallCount() == 2);
+#else
+    NL_TEST_ASSERT(inSuite, srvResponder.GetCallCount() == 3);
+#endif // CHIP_CONFIG_MDNS_RESPONSE_CACHE_SIZE > 0
+}
+
+/// Counts the replies sent, without looking at them
+class CountingServer : private chip::PoolImpl<ServerBase::EndpointInfo, 0, chip::ObjectPoolMem::kInline,
+                                              ServerBase::EndpointInfoPoolType::Interface>,
+                       public ServerBase
+{
+public:
+    CountingServer() : ServerBase(*static_cast<ServerBase::EndpointInfoPoolType *>(this)) {}
+
+    CHIP_ERROR DirectSend(System::PacketBufferHandle && data, const Inet::IPAddress & addr, uint16_t port,
+                          Inet::InterfaceId interface) override
+    {
+        mSendCount++;
+        return CHIP_NO_ERROR;
+    }
+
+    uint32_t GetSendCount() const { return mSendCount; }
+
+private:
+    uint32_t mSendCount = 0;
+};
+
+/// A query for a single name, kept in its own storage
+struct QueryStorage
+{
+    uint8_t storage[64];
+    QueryData query;
+
+    QueryStorage(const QueryStorage &) = delete;
+    QueryStorage & operator=(const QueryStorage &) = delete;
+
+    QueryStorage(const FullQName & name, QType type)
+    {
+        Encoding::BigEndian::BufferWriter output(storage, sizeof(storage));
+        RecordWriter writer(&output);
+        writer.WriteQName(name);
+        query = QueryData(type, QClass::IN, true /* unicast */, storage, BytesRange(storage, storage + sizeof(storage)));
+    }
+};
+
+/**
+ * Measures the rate at which replies are sent to a node advertising an operational and a commissionable service, for
+ * queries arriving on 4 interfaces, with every reply built from the responders and with repeated replies copied.
+ */
+void BenchmarkRepeatedQueries(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr size_t kInterfaceCount = 4;
+    constexpr uint32_t kRounds       = 250;
+
+    CommonTestElements operational(inSuite, "operational");
+    CommonTestElements commissionable(inSuite, "commissionable");
+    IPv6Responder operationalIpResponder(operational.host);
+    IPv6Responder commissionableIpResponder(commissionable.host);
+
+    CountingServer server;
+    ResponseSender responseSender(&server);
+    for (CommonTestElements * common : { &operational, &commissionable })
+    {
+        NL_TEST_ASSERT(inSuite, responseSender.AddQueryResponder(&common->queryResponder) == CHIP_NO_ERROR);
+        common->queryResponder.AddResponder(&common->ptrResponder)
+            .SetReportAdditional(common->instance)
+            .SetReportInServiceListing(true);
+        common->queryResponder.AddResponder(&common->srvResponder).SetReportAdditional(common->host);
+        common->queryResponder.AddResponder(&common->txtResponder);
+    }
+    operational.queryResponder.AddResponder(&operationalIpResponder);
+    commissionable.queryResponder.AddResponder(&commissionableIpResponder);
+
+    QueryStorage operationalService(operational.service, QType::PTR);
+    QueryStorage operationalInstance(operational.instance, QType::ANY);
+    QueryStorage commissionableService(commissionable.service, QType::PTR);
+    QueryStorage * queries[] = { &operationalService, &operationalInstance, &commissionableService };
+
+    // Queries come from the first interfaces of the system, repeated if there are fewer than kInterfaceCount.
+    Inet::IPPacketInfo packetInfos[kInterfaceCount];
+    size_t systemInterfaceCount = 0;
+    for (auto & packetInfo : packetInfos)
+    {
+        packetInfo.Clear();
+        packetInfo.SrcPort  = 5353;
+        packetInfo.DestPort = 5353;
+    }
+    for (Inet::InterfaceIterator it; it.HasCurrent() && systemInterfaceCount < kInterfaceCount; it.Next())
+    {
+        packetInfos[systemInterfaceCount++].Interface = it.GetInterfaceId();
+    }
+    for (size_t i = systemInterfaceCount; (systemInterfaceCount > 0) && (i < kInterfaceCount); i++)
+    {
+        packetInfos[i].Interface = packetInfos[i % systemInterfaceCount].Interface;
+    }
+
+    const uint32_t replyCount = static_cast<uint32_t>(kRounds * kInterfaceCount * ArraySize(queries));
+    for (bool cached : { false, true })
+    {
+        const uint32_t sendCountBefore = server.GetSendCount();
+
+        System::Clock::Microseconds64 start = System::SystemClock().GetMonotonicMicroseconds64();
+        for (uint32_t round = 0; round < kRounds; round++)
+        {
+            for (auto & packetInfo : packetInfos)
+            {
+                for (QueryStorage * query : queries)
+                {
+                    if (!cached)
+                    {
+                        responseSender.InvalidateCachedReplies();
+                    }
+                    NL_TEST_ASSERT(inSuite, responseSender.Respond(round, query->query, &packetInfo) == CHIP_NO_ERROR);
+                }
+            }
+        }
+        System::Clock::Microseconds64 elapsed = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+        NL_TEST_ASSERT(inSuite, server.GetSendCount() - sendCountBefore == replyCount);
+        ChipLogProgress(Discovery, "mDNS replies x%" PRIu32 " %s reply cache: %" PRIu64 "us, %" PRIu64 " replies/s", replyCount,
+                        cached ? "with" : "without", elapsed.count(),
+                        elapsed.count() ? (static_cast<uint64_t>(replyCount) * 1000000u / elapsed.count()) : 0);
+    }
+}
+
 const nlTest sTests[] = {
     NL_TEST_DEF("SrvAnyResponseToInstance", SrvAnyResponseToInstance),                                       //
     NL_TEST_DEF("SrvTxtAnyResponseToInstance", SrvTxtAnyResponseToInstance),                                 //
@@ -350,6 +538,8 @@ const nlTest sTests[] = {
     NL_TEST_DEF("AddManyQueryResponders", AddManyQueryResponders),                                           //
     NL_TEST_DEF("PtrSrvTxtMultipleRespondersToInstance", PtrSrvTxtMultipleRespondersToInstance),             //
     NL_TEST_DEF("PtrSrvTxtMultipleRespondersToServiceListing", PtrSrvTxtMultipleRespondersToServiceListing), //
+    NL_TEST_DEF("RepeatedQueryToInstance", RepeatedQueryToInstance),                                         //
+    NL_TEST_DEF("BenchmarkRepeatedQueries", BenchmarkRepeatedQueries),                                       //
 
     NL_TEST_SENTINEL() //
 };
@@ -133,7 +133,83 @@ void TestInsert(nlTestSuite * inSuite, void * inContext)
     NL_TEST_ASSERT(inSuite, tDnssdCache.Lookup(peerId, nodeDataOut) != CHIP_NO_ERROR);
 }
 
-static const nlTest sTests[] = { NL_TEST_DEF_FN(TestCreate), NL_TEST_DEF_FN(TestInsert), NL_TEST_SENTINEL() };
+void TestManyNodes(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr uint16_t sizeOfCache = 256;
+    static DnssdCache<sizeOfCache> tDnssdCache;
+    const System::Clock::Timestamp shortTtl = System::Clock::Seconds16(10);
+    const System::Clock::Timestamp longTtl  = System::Clock::Seconds16(100);
+    ResolvedNodeData nodeData;
+    ResolvedNodeData nodeDataOut;
+
+    auto makePeerId = [](uint16_t i) {
+        // spread the nodes over two fabrics, with the same node ids on both
+        return PeerId().SetCompressedFabricId(0x1000 + (i & 1)).SetNodeId(static_cast<NodeId>(i >> 1));
+    };
+
+    Inet::IPAddress::FromString("fd00::1", nodeData.mAddress[nodeData.mNumIPs++]);
+    for (uint16_t i = 0; i < sizeOfCache; i++)
+    {
+        nodeData.mPeerId     = makePeerId(i);
+        nodeData.mPort       = i;
+        nodeData.mExpiryTime = fakeClock.GetMonotonicTimestamp() + ((i % 4 == 0) ? shortTtl : longTtl);
+        NL_TEST_ASSERT(inSuite, tDnssdCache.Insert(nodeData) == CHIP_NO_ERROR);
+    }
+
+    nodeData.mPeerId = makePeerId(sizeOfCache);
+    NL_TEST_ASSERT(inSuite, tDnssdCache.Insert(nodeData) == CHIP_ERROR_TOO_MANY_KEYS);
+
+    for (uint16_t i = 0; i < sizeOfCache; i++)
+    {
+        NL_TEST_ASSERT(inSuite, tDnssdCache.Lookup(makePeerId(i), nodeDataOut) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, nodeDataOut.mPeerId == makePeerId(i));
+        NL_TEST_ASSERT(inSuite, nodeDataOut.mPort == i);
+    }
+
+    // Deleting entries must not hide the others sharing their probe sequences
+    for (uint16_t i = 1; i < sizeOfCache; i += 2)
+    {
+        NL_TEST_ASSERT(inSuite, tDnssdCache.Delete(makePeerId(i)) == CHIP_NO_ERROR);
+    }
+    for (uint16_t i = 0; i < sizeOfCache; i++)
+    {
+        CHIP_ERROR expected = (i & 1) ? CHIP_ERROR_KEY_NOT_FOUND : CHIP_NO_ERROR;
+        NL_TEST_ASSERT(inSuite, tDnssdCache.Lookup(makePeerId(i), nodeDataOut) == expected);
+    }
+
+    // Updating an entry keeps a single copy of it
+    nodeData.mPeerId     = makePeerId(2);
+    nodeData.mPort       = 4242;
+    nodeData.mExpiryTime = fakeClock.GetMonotonicTimestamp() + longTtl;
+    NL_TEST_ASSERT(inSuite, tDnssdCache.Insert(nodeData) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, tDnssdCache.Lookup(makePeerId(2), nodeDataOut) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, nodeDataOut.mPort == 4242);
+    NL_TEST_ASSERT(inSuite, tDnssdCache.Delete(makePeerId(2)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, tDnssdCache.Lookup(makePeerId(2), nodeDataOut) == CHIP_ERROR_KEY_NOT_FOUND);
+
+    // Refill the cache, then let the short lived entries expire to make room for more
+    for (uint16_t i = sizeOfCache; i < sizeOfCache + sizeOfCache / 2 + 1; i++)
+    {
+        nodeData.mPeerId     = makePeerId(i);
+        nodeData.mPort       = i;
+        nodeData.mExpiryTime = fakeClock.GetMonotonicTimestamp() + longTtl;
+        NL_TEST_ASSERT(inSuite, tDnssdCache.Insert(nodeData) == CHIP_NO_ERROR);
+    }
+    nodeData.mPeerId = makePeerId(1);
+    NL_TEST_ASSERT(inSuite, tDnssdCache.Insert(nodeData) == CHIP_ERROR_TOO_MANY_KEYS);
+
+    fakeClock.AdvanceMonotonic(shortTtl + System::Clock::Seconds16(1));
+    NL_TEST_ASSERT(inSuite, tDnssdCache.Insert(nodeData) == CHIP_NO_ERROR);
+
+    for (uint16_t i = 0; i < sizeOfCache + sizeOfCache / 2 + 1; i++)
+    {
+        const bool present = (i == 1) || ((i >= sizeOfCache) || ((i % 2 == 0) && (i % 4 != 0) && (i != 2)));
+        NL_TEST_ASSERT(inSuite, (tDnssdCache.Lookup(makePeerId(i), nodeDataOut) == CHIP_NO_ERROR) == present);
+    }
+}
+
+static const nlTest sTests[] = { NL_TEST_DEF_FN(TestCreate), NL_TEST_DEF_FN(TestInsert), NL_TEST_DEF_FN(TestManyNodes),
+                                 NL_TEST_SENTINEL() };
 
 static int TestSetup(void * inContext)
 {
@@ -37,6 +37,7 @@ extern CHIP_ERROR MemoryAllocatorInit(void * buf, size_t bufSize);
 extern void MemoryAllocatorShutdown();
 
 static std::atomic_int memoryInitializationCount{ 0 };
+static void (*memoryShutdownHandler)() = nullptr;
 
 CHIP_ERROR MemoryInit(void * buf, size_t bufSize)
 {
@@ -58,10 +59,19 @@ void MemoryShutdown()
 {
     if ((memoryInitializationCount > 0) && (--memoryInitializationCount == 0))
     {
+        if (memoryShutdownHandler != nullptr)
+        {
+            memoryShutdownHandler();
+        }
         // Here we undo things like mbedtls_platform_set_calloc_free()
         MemoryAllocatorShutdown();
     }
 }
 
+void SetMemoryShutdownHandler(void (*handler)())
+{
+    memoryShutdownHandler = handler;
+}
+
 } // namespace Platform
 } // namespace chip
@@ -77,6 +77,16 @@ extern CHIP_ERROR MemoryInit(void * buf = nullptr, size_t bufSize = 0);
  */
 extern void MemoryShutdown();
 
+/**
+ * Set a function for MemoryShutdown() to call before it releases the allocator, to free the memory a module keeps for
+ * reuse instead of returning it to the allocator, such as the freed packet buffers of each size class. There is a
+ * single such function.
+ *
+ * @param[in]  handler          The function to call, or nullptr for none.
+ *
+ */
+extern void SetMemoryShutdownHandler(void (*handler)());
+
 /**
  * This function is called by the CHIP layer to allocate a block of memory of "size" bytes.
  *
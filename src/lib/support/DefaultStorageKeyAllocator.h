@@ -46,6 +46,10 @@ public:
         return Format("acl/%x", static_cast<unsigned int>(index));
     }
 
+    // CASE session resumption
+
+    const char * CASESessionResumption(size_t index) { return Format("cr/%x", static_cast<unsigned int>(index)); }
+
     // Group Data Provider
 
     const char * FabricTable() { return Format("f/t"); }
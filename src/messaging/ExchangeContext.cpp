@@ -274,6 +274,7 @@ ExchangeContext::ExchangeContext(ExchangeManager * em, uint16_t ExchangeId, cons
     mSession.Grab(session);
     mFlags.Set(Flags::kFlagInitiator, Initiator);
     mDelegate = delegate;
+    mExchangeMgr->mContextIndex.Add(this);
 
     SetDropAckDebug(false);
     SetAckPending(false);
@@ -303,6 +304,7 @@ ExchangeContext::~ExchangeContext()
     // the boolean parameter passed to DoClose() should not matter.
 
     DoClose(false);
+    mExchangeMgr->mContextIndex.Remove(this);
     mExchangeMgr = nullptr;
 
 #if defined(CHIP_EXCHANGE_CONTEXT_DETAIL_LOGGING)
@@ -28,6 +28,7 @@
 #include <lib/support/DLLUtil.h>
 #include <lib/support/ReferenceCountedHandle.h>
 #include <lib/support/TypeTraits.h>
+#include <messaging/ExchangeContextIndex.h>
 #include <messaging/ExchangeDelegate.h>
 #include <messaging/Flags.h>
 #include <messaging/ReliableMessageContext.h>
@@ -61,6 +62,7 @@ class DLL_EXPORT ExchangeContext : public ReliableMessageContext,
 {
     friend class ExchangeManager;
     friend class ExchangeContextDeletor;
+    friend class ExchangeContextIndex;
 
 public:
     typedef System::Clock::Timeout Timeout; // Type used to express the timeout in this ExchangeContext
@@ -185,6 +187,9 @@ private:
     SessionHolderWithDelegate mSession; // The connection state
     uint16_t mExchangeId;               // Assigned exchange ID.
 
+    // Slot of this exchange in the ExchangeManager's index of the active exchanges.
+    uint16_t mIndexSlot = ExchangeContextIndex::kNotIndexed;
+
     /**
      *  Determine whether a response is currently expected for a message that was sent over
      *  this exchange.  While this is true, attempts to send other messages that expect a response
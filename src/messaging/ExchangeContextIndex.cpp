@@ -0,0 +1,108 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements the index of the active exchanges.
+ *
+ */
+
+#include <messaging/ExchangeContextIndex.h>
+
+#include <lib/support/CodeUtils.h>
+#include <messaging/ExchangeContext.h>
+
+namespace chip {
+namespace Messaging {
+
+uint32_t ExchangeContextIndex::Hash(const Transport::Session * session, uint16_t exchangeId, bool initiator)
+{
+    uint64_t address = reinterpret_cast<uintptr_t>(session);
+    uint32_t hash    = static_cast<uint32_t>(address ^ (address >> 32)) ^ ((static_cast<uint32_t>(exchangeId) << 1) | initiator);
+
+    // Finalizer of MurmurHash3, so that exchanges opened one after the other spread over the table.
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+void ExchangeContextIndex::Place(size_t slot, const Slot & entry)
+{
+    mSlots[slot]               = entry;
+    entry.mContext->mIndexSlot = static_cast<uint16_t>(slot);
+}
+
+void ExchangeContextIndex::Add(ExchangeContext * ec)
+{
+    Slot entry;
+    entry.mContext = ec;
+    entry.mHash    = Hash(ec->mSession.operator->(), ec->GetExchangeId(), ec->IsInitiator());
+
+    // There are always free slots, since there are twice as many slots as exchanges.
+    size_t slot = entry.mHash & kMask;
+    while (mSlots[slot].mContext != nullptr)
+    {
+        slot = (slot + 1) & kMask;
+    }
+    Place(slot, entry);
+}
+
+void ExchangeContextIndex::Remove(ExchangeContext * ec)
+{
+    VerifyOrReturn(ec->mIndexSlot != kNotIndexed);
+
+    size_t hole    = ec->mIndexSlot;
+    ec->mIndexSlot = kNotIndexed;
+
+    // Move back the entries that follow in the same run of used slots and can no longer be reached
+    // past the hole, instead of leaving a tombstone there.
+    for (size_t slot = (hole + 1) & kMask; mSlots[slot].mContext != nullptr; slot = (slot + 1) & kMask)
+    {
+        size_t home = mSlots[slot].mHash & kMask;
+        // The entry can stay if its home is cyclically in (hole, slot].
+        if (((slot - home) & kMask) < ((slot - hole) & kMask))
+        {
+            continue;
+        }
+        Place(hole, mSlots[slot]);
+        hole = slot;
+    }
+    mSlots[hole] = Slot();
+}
+
+ExchangeContext * ExchangeContextIndex::Find(const SessionHandle & session, const PacketHeader & packetHeader,
+                                             const PayloadHeader & payloadHeader) const
+{
+    // The message was sent by the initiator of the exchange if our side of it is the responder.
+    const uint32_t hash = Hash(session.operator->(), payloadHeader.GetExchangeID(), !payloadHeader.IsInitiator());
+
+    for (size_t slot = hash & kMask; mSlots[slot].mContext != nullptr; slot = (slot + 1) & kMask)
+    {
+        ExchangeContext * ec = mSlots[slot].mContext;
+        if (mSlots[slot].mHash == hash && ec->MatchExchange(session, packetHeader, payloadHeader))
+        {
+            return ec;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace Messaging
+} // namespace chip
@@ -0,0 +1,90 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines the index the ExchangeManager uses to find the exchange
+ *      an incoming message belongs to.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <lib/core/CHIPConfig.h>
+#include <transport/SessionHandle.h>
+#include <transport/raw/MessageHeader.h>
+
+namespace chip {
+namespace Messaging {
+
+class ExchangeContext;
+
+namespace Internal {
+constexpr size_t RoundUpToPowerOfTwo(size_t value, size_t power = 1)
+{
+    return power >= value ? power : RoundUpToPowerOfTwo(value, power * 2);
+}
+} // namespace Internal
+
+/**
+ *  @brief
+ *    Open-addressing hash table of the active exchanges, keyed by session, exchange ID and role,
+ *    so that finding the exchange of an incoming message does not depend on how many exchanges
+ *    are open.
+ *
+ *    Exchanges are added when they are created and removed when they are destroyed. An exchange
+ *    stays in the index after its session is released; it is then no longer matched by Find(),
+ *    since every candidate is checked with ExchangeContext::MatchExchange.
+ */
+class ExchangeContextIndex
+{
+public:
+    void Add(ExchangeContext * ec);
+    void Remove(ExchangeContext * ec);
+
+    /**
+     *  Find the exchange that a received message belongs to, or nullptr if there is none.
+     */
+    ExchangeContext * Find(const SessionHandle & session, const PacketHeader & packetHeader,
+                           const PayloadHeader & payloadHeader) const;
+
+    static constexpr uint16_t kNotIndexed = UINT16_MAX;
+
+private:
+    // At most half of the slots are ever used, which keeps the probe sequences short.
+    static constexpr size_t kCapacity = Internal::RoundUpToPowerOfTwo(2 * CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS);
+    static constexpr size_t kMask     = kCapacity - 1;
+    static_assert(kCapacity < kNotIndexed, "Exchange index slots are 16 bits");
+
+    static uint32_t Hash(const Transport::Session * session, uint16_t exchangeId, bool initiator);
+
+    struct Slot
+    {
+        ExchangeContext * mContext = nullptr;
+        uint32_t mHash             = 0;
+    };
+
+    void Place(size_t slot, const Slot & entry);
+
+    Slot mSlots[kCapacity];
+};
+
+} // namespace Messaging
+} // namespace chip
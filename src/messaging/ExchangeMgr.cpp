@@ -201,30 +201,21 @@ void ExchangeManager::OnMessageReceived(const PacketHeader & packetHeader, const
     if (!packetHeader.IsGroupSession())
     {
         // Search for an existing exchange that the message applies to. If a match is found...
-        bool found = false;
-        mContextPool.ForEachActiveObject([&](auto * ec) {
-            if (ec->MatchExchange(session, packetHeader, payloadHeader))
+        ExchangeContext * ec = mContextIndex.Find(session, packetHeader, payloadHeader);
+        if (ec != nullptr)
+        {
+            // Found a matching exchange. Set flag for correct subsequent MRP
+            // retransmission timeout selection.
+            if (!ec->HasRcvdMsgFromPeer())
             {
-                // Found a matching exchange. Set flag for correct subsequent MRP
-                // retransmission timeout selection.
-                if (!ec->HasRcvdMsgFromPeer())
-                {
-                    ec->SetMsgRcvdFromPeer(true);
-                }
-
-                ChipLogDetail(ExchangeManager, "Found matching exchange: " ChipLogFormatExchange ", Delegate: %p",
-                              ChipLogValueExchange(ec), ec->GetDelegate());
-
-                // Matched ExchangeContext; send to message handler.
-                ec->HandleMessage(packetHeader.GetMessageCounter(), payloadHeader, source, msgFlags, std::move(msgBuf));
-                found = true;
-                return Loop::Break;
+                ec->SetMsgRcvdFromPeer(true);
             }
-            return Loop::Continue;
-        });
 
-        if (found)
-        {
+            ChipLogDetail(ExchangeManager, "Found matching exchange: " ChipLogFormatExchange ", Delegate: %p",
+                          ChipLogValueExchange(ec), ec->GetDelegate());
+
+            // Matched ExchangeContext; send to message handler.
+            ec->HandleMessage(packetHeader.GetMessageCounter(), payloadHeader, source, msgFlags, std::move(msgBuf));
             return;
         }
     }
@@ -30,6 +30,7 @@
 #include <lib/support/Pool.h>
 #include <lib/support/TypeTraits.h>
 #include <messaging/ExchangeContext.h>
+#include <messaging/ExchangeContextIndex.h>
 #include <messaging/ReliableMessageMgr.h>
 #include <protocols/Protocols.h>
 #include <transport/SessionManager.h>
@@ -230,6 +231,8 @@ private:
 
     FabricIndex mFabricIndex = 0;
 
+    // Declared before the pool, as exchanges remove themselves from it when they are destroyed.
+    ExchangeContextIndex mContextIndex;
     BitMapObjectPool<ExchangeContext, CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS> mContextPool;
 
     UnsolicitedMessageHandler UMHandlerPool[CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS];
@@ -39,7 +39,7 @@
 namespace chip {
 namespace Messaging {
 
-ReliableMessageContext::ReliableMessageContext() : mNextAckTime(0), mPendingPeerAckMessageCounter(0) {}
+ReliableMessageContext::ReliableMessageContext() : mNextAckTime(0), mPendingPeerAckMessageCounter(0), mRetransEntry(nullptr) {}
 
 ExchangeContext * ReliableMessageContext::GetExchangeContext()
 {
@@ -42,6 +42,7 @@ class ChipMessageInfo;
 class ExchangeContext;
 enum class MessageFlagValues : uint32_t;
 class ReliableMessageMgr;
+struct RetransTableEntry;
 
 class ReliableMessageContext
 {
@@ -231,11 +232,15 @@ private:
 
 private:
     friend class ReliableMessageMgr;
+    friend struct RetransTableEntry;
     friend class ExchangeContext;
     friend class ExchangeMessageDispatch;
 
     System::Clock::Timestamp mNextAckTime; // Next time for triggering Solo Ack
     uint32_t mPendingPeerAckMessageCounter;
+
+    // The entry of the message sent on this exchange that is waiting for an acknowledgment, if any.
+    RetransTableEntry * mRetransEntry;
 };
 
 inline bool ReliableMessageContext::AutoRequestAck() const
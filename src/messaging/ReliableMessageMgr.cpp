@@ -40,13 +40,14 @@ using namespace chip::System::Clock::Literals;
 namespace chip {
 namespace Messaging {
 
-ReliableMessageMgr::RetransTableEntry::RetransTableEntry(ReliableMessageContext * rc) :
-    ec(*rc->GetExchangeContext()), retainedBuf(EncryptedPacketBufferHandle()), nextRetransTime(0), sendCount(0)
+RetransTableEntry::RetransTableEntry(ReliableMessageContext * rc) :
+    ec(*rc->GetExchangeContext()), retainedBuf(EncryptedPacketBufferHandle()), nextRetransTime(0), sendCount(0),
+    queueIndex(kNotQueued)
 {
     ec->SetMessageNotAcked(true);
 }
 
-ReliableMessageMgr::RetransTableEntry::~RetransTableEntry()
+RetransTableEntry::~RetransTableEntry()
 {
     ec->SetMessageNotAcked(false);
 }
@@ -68,7 +69,7 @@ void ReliableMessageMgr::Shutdown()
 
     // Clear the retransmit table
     mRetransTable.ForEachActiveObject([&](auto * entry) {
-        mRetransTable.ReleaseObject(entry);
+        RemoveFromRetransTable(*entry);
         return Loop::Continue;
     });
 
@@ -116,10 +117,13 @@ void ReliableMessageMgr::ExecuteActions()
         }
     });
 
-    // Retransmit / cancel anything in the retrans table whose retrans timeout has expired
-    mRetransTable.ForEachActiveObject([&](auto * entry) {
+    // Retransmit / cancel anything in the retrans table whose retrans timeout has expired. Each entry is
+    // handled at most once: it is either removed or rescheduled, which moves it to its new place in the queue.
+    for (size_t remaining = mRetransQueueSize; remaining > 0 && mRetransQueueSize > 0; remaining--)
+    {
+        RetransTableEntry * entry = mRetransQueue[0];
         if (entry->nextRetransTime > now)
-            return Loop::Continue;
+            break;
 
         VerifyOrDie(!entry->retainedBuf.IsNull());
 
@@ -136,8 +140,8 @@ void ReliableMessageMgr::ExecuteActions()
                          messageCounter, ChipLogValueExchange(&entry->ec.Get()), sendCount, CHIP_CONFIG_RMP_DEFAULT_MAX_RETRANS);
 
             // Do not StartTimer, we will schedule the timer at the end of the timer handler.
-            mRetransTable.ReleaseObject(entry);
-            return Loop::Continue;
+            RemoveFromRetransTable(*entry);
+            continue;
         }
 
         ChipLogDetail(ExchangeManager,
@@ -145,13 +149,12 @@ void ReliableMessageMgr::ExecuteActions()
                       " Send Cnt %d",
                       messageCounter, ChipLogValueExchange(&entry->ec.Get()), entry->sendCount);
         // TODO: Choose active/idle timeout corresponding to the activity of exchanges of the session.
-        entry->nextRetransTime =
-            System::SystemClock().GetMonotonicTimestamp() + entry->ec->GetSessionHandle()->GetMRPConfig().mActiveRetransTimeout;
+        ScheduleRetransmission(*entry,
+                               System::SystemClock().GetMonotonicTimestamp() +
+                                   entry->ec->GetSessionHandle()->GetMRPConfig().mActiveRetransTimeout);
         SendFromRetransTable(entry);
         // For test not using async IO loop, the entry may have been removed after send, do not use entry below
-
-        return Loop::Continue;
-    });
+    }
 
     TicklessDebugDumpRetransTable("ReliableMessageMgr::ExecuteActions Dumping mRetransTable entries after processing");
 }
@@ -183,6 +186,7 @@ CHIP_ERROR ReliableMessageMgr::AddToRetransTable(ReliableMessageContext * rc, Re
         ChipLogError(ExchangeManager, "mRetransTable Already Full");
         return CHIP_ERROR_RETRANS_TABLE_FULL;
     }
+    rc->mRetransEntry = *rEntry;
 
     return CHIP_NO_ERROR;
 }
@@ -190,31 +194,28 @@ CHIP_ERROR ReliableMessageMgr::AddToRetransTable(ReliableMessageContext * rc, Re
 void ReliableMessageMgr::StartRetransmision(RetransTableEntry * entry)
 {
     // TODO: Choose active/idle timeout corresponding to the activity of exchanges of the session.
-    entry->nextRetransTime =
-        System::SystemClock().GetMonotonicTimestamp() + entry->ec->GetSessionHandle()->GetMRPConfig().mIdleRetransTimeout;
+    ScheduleRetransmission(*entry,
+                           System::SystemClock().GetMonotonicTimestamp() +
+                               entry->ec->GetSessionHandle()->GetMRPConfig().mIdleRetransTimeout);
     StartTimer();
 }
 
 bool ReliableMessageMgr::CheckAndRemRetransTable(ReliableMessageContext * rc, uint32_t ackMessageCounter)
 {
-    bool removed = false;
-    mRetransTable.ForEachActiveObject([&](auto * entry) {
-        if (entry->ec->GetReliableMessageContext() == rc && entry->retainedBuf.GetMessageCounter() == ackMessageCounter)
-        {
-            // Clear the entry from the retransmision table.
-            ClearRetransTable(*entry);
-
-            ChipLogDetail(ExchangeManager,
-                          "Rxd Ack; Removing MessageCounter:" ChipLogFormatMessageCounter
-                          " from Retrans Table on exchange " ChipLogFormatExchange,
-                          ackMessageCounter, ChipLogValueExchange(rc->GetExchangeContext()));
-            removed = true;
-            return Loop::Break;
-        }
-        return Loop::Continue;
-    });
+    RetransTableEntry * entry = rc->mRetransEntry;
+    if (entry == nullptr || entry->retainedBuf.GetMessageCounter() != ackMessageCounter)
+    {
+        return false;
+    }
+
+    // Clear the entry from the retransmision table.
+    ClearRetransTable(*entry);
 
-    return removed;
+    ChipLogDetail(ExchangeManager,
+                  "Rxd Ack; Removing MessageCounter:" ChipLogFormatMessageCounter
+                  " from Retrans Table on exchange " ChipLogFormatExchange,
+                  ackMessageCounter, ChipLogValueExchange(rc->GetExchangeContext()));
+    return true;
 }
 
 CHIP_ERROR ReliableMessageMgr::SendFromRetransTable(RetransTableEntry * entry)
@@ -231,8 +232,10 @@ CHIP_ERROR ReliableMessageMgr::SendFromRetransTable(RetransTableEntry * entry)
         return CHIP_ERROR_INCORRECT_STATE;
     }
 
+    // Retransmissions that fall due together go out together on transports that can batch them. A retransmission that the
+    // transport then fails to send is only logged; the next one, or the retransmission timeout, takes care of it.
     auto * sessionManager = entry->ec->GetExchangeMgr()->GetSessionManager();
-    CHIP_ERROR err        = sessionManager->SendPreparedMessage(entry->ec->GetSessionHandle(), entry->retainedBuf);
+    CHIP_ERROR err        = sessionManager->QueuePreparedMessage(entry->ec->GetSessionHandle(), entry->retainedBuf);
 
     if (err == CHIP_NO_ERROR)
     {
@@ -267,23 +270,105 @@ CHIP_ERROR ReliableMessageMgr::SendFromRetransTable(RetransTableEntry * entry)
 
 void ReliableMessageMgr::ClearRetransTable(ReliableMessageContext * rc)
 {
-    mRetransTable.ForEachActiveObject([&](auto * entry) {
-        if (entry->ec->GetReliableMessageContext() == rc)
-        {
-            ClearRetransTable(*entry);
-            return Loop::Break;
-        }
-        return Loop::Continue;
-    });
+    if (rc->mRetransEntry != nullptr)
+    {
+        ClearRetransTable(*rc->mRetransEntry);
+    }
 }
 
 void ReliableMessageMgr::ClearRetransTable(RetransTableEntry & entry)
 {
-    mRetransTable.ReleaseObject(&entry);
+    RemoveFromRetransTable(entry);
     // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
     StartTimer();
 }
 
+void ReliableMessageMgr::RemoveFromRetransTable(RetransTableEntry & entry)
+{
+    if (entry.queueIndex != RetransTableEntry::kNotQueued)
+    {
+        size_t index = entry.queueIndex;
+        mRetransQueueSize--;
+        if (index != mRetransQueueSize)
+        {
+            // Fill the hole with the last entry, which may belong either above or below it.
+            RetransTableEntry * last = mRetransQueue[mRetransQueueSize];
+            SetQueuePosition(index, last);
+            SiftUp(index);
+            SiftDown(last->queueIndex);
+        }
+    }
+
+    entry.ec->mRetransEntry = nullptr;
+    mRetransTable.ReleaseObject(&entry);
+}
+
+void ReliableMessageMgr::ScheduleRetransmission(RetransTableEntry & entry, System::Clock::Timestamp retransTime)
+{
+    bool later            = retransTime > entry.nextRetransTime;
+    entry.nextRetransTime = retransTime;
+
+    if (entry.queueIndex == RetransTableEntry::kNotQueued)
+    {
+        SetQueuePosition(mRetransQueueSize++, &entry);
+        SiftUp(entry.queueIndex);
+    }
+    else if (later)
+    {
+        SiftDown(entry.queueIndex);
+    }
+    else
+    {
+        SiftUp(entry.queueIndex);
+    }
+}
+
+void ReliableMessageMgr::SetQueuePosition(size_t index, RetransTableEntry * entry)
+{
+    mRetransQueue[index] = entry;
+    entry->queueIndex    = index;
+}
+
+void ReliableMessageMgr::SiftUp(size_t index)
+{
+    RetransTableEntry * entry = mRetransQueue[index];
+    while (index > 0)
+    {
+        size_t parent = (index - 1) / 2;
+        if (mRetransQueue[parent]->nextRetransTime <= entry->nextRetransTime)
+        {
+            break;
+        }
+        SetQueuePosition(index, mRetransQueue[parent]);
+        index = parent;
+    }
+    SetQueuePosition(index, entry);
+}
+
+void ReliableMessageMgr::SiftDown(size_t index)
+{
+    RetransTableEntry * entry = mRetransQueue[index];
+    while (true)
+    {
+        size_t child = 2 * index + 1;
+        if (child >= mRetransQueueSize)
+        {
+            break;
+        }
+        if (child + 1 < mRetransQueueSize && mRetransQueue[child + 1]->nextRetransTime < mRetransQueue[child]->nextRetransTime)
+        {
+            child++;
+        }
+        if (entry->nextRetransTime <= mRetransQueue[child]->nextRetransTime)
+        {
+            break;
+        }
+        SetQueuePosition(index, mRetransQueue[child]);
+        index = child;
+    }
+    SetQueuePosition(index, entry);
+}
+
 void ReliableMessageMgr::StartTimer()
 {
     // When do we need to next wake up to send an ACK?
@@ -297,13 +382,10 @@ void ReliableMessageMgr::StartTimer()
     });
 
     // When do we need to next wake up for ReliableMessageProtocol retransmit?
-    mRetransTable.ForEachActiveObject([&](auto * entry) {
-        if (entry->nextRetransTime < nextWakeTime)
-        {
-            nextWakeTime = entry->nextRetransTime;
-        }
-        return Loop::Continue;
-    });
+    if (mRetransQueueSize > 0 && mRetransQueue[0]->nextRetransTime < nextWakeTime)
+    {
+        nextWakeTime = mRetransQueue[0]->nextRetransTime;
+    }
 
     if (nextWakeTime != System::Clock::Timestamp::max())
     {
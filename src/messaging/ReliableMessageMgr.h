@@ -44,30 +44,35 @@ using ExchangeHandle = ReferenceCountedHandle<ExchangeContext>;
 enum class SendMessageFlags : uint16_t;
 class ReliableMessageContext;
 
+/**
+ *  @class RetransTableEntry
+ *
+ *  @brief
+ *    This class is part of the CHIP Reliable Messaging Protocol and is used
+ *    to keep track of CHIP messages that have been sent and are expecting an
+ *    acknowledgment back. If the acknowledgment is not received within a
+ *    specific timeout, the message would be retransmitted from this table.
+ *
+ */
+struct RetransTableEntry
+{
+    static constexpr size_t kNotQueued = SIZE_MAX;
+
+    RetransTableEntry(ReliableMessageContext * rc);
+    ~RetransTableEntry();
+
+    ExchangeHandle ec;                        /**< The context for the stored CHIP message. */
+    EncryptedPacketBufferHandle retainedBuf;  /**< The packet buffer holding the CHIP message. */
+    System::Clock::Timestamp nextRetransTime; /**< A counter representing the next retransmission time for the message. */
+    uint8_t sendCount;                        /**< The number of times we have tried to send this entry,
+                                                   including both successfully and failure send. */
+    size_t queueIndex;                        /**< The position of the entry in the retransmission queue. */
+};
+
 class ReliableMessageMgr
 {
 public:
-    /**
-     *  @class RetransTableEntry
-     *
-     *  @brief
-     *    This class is part of the CHIP Reliable Messaging Protocol and is used
-     *    to keep track of CHIP messages that have been sent and are expecting an
-     *    acknowledgment back. If the acknowledgment is not received within a
-     *    specific timeout, the message would be retransmitted from this table.
-     *
-     */
-    struct RetransTableEntry
-    {
-        RetransTableEntry(ReliableMessageContext * rc);
-        ~RetransTableEntry();
-
-        ExchangeHandle ec;                        /**< The context for the stored CHIP message. */
-        EncryptedPacketBufferHandle retainedBuf;  /**< The packet buffer holding the CHIP message. */
-        System::Clock::Timestamp nextRetransTime; /**< A counter representing the next retransmission time for the message. */
-        uint8_t sendCount;                        /**< The number of times we have tried to send this entry,
-                                                       including both successfully and failure send. */
-    };
+    using RetransTableEntry = Messaging::RetransTableEntry;
 
 public:
     ReliableMessageMgr(BitMapObjectPool<ExchangeContext, CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS> & contextPool);
@@ -112,8 +117,7 @@ public:
     void StartRetransmision(RetransTableEntry * entry);
 
     /**
-     *  Iterate through active exchange contexts and retrans table entries. Clear the entry matching
-     *  the specified ExchangeContext and the message ID from the retransmision table.
+     *  Clear the entry matching the specified ExchangeContext and the message ID from the retransmision table.
      *
      *  @param[in]    rc                 A pointer to the ExchangeContext object.
      *  @param[in]    ackMessageCounter  The acknowledged message counter of the received packet.
@@ -148,7 +152,7 @@ public:
     void ClearRetransTable(RetransTableEntry & rEntry);
 
     /**
-     * Iterate through active exchange contexts and retrans table entries.
+     * Iterate through active exchange contexts and look at the earliest retransmission.
      * Determine how many ReliableMessageProtocol ticks we need to sleep before we
      * need to physically wake the CPU to perform an action.  Set a timer to go off
      * when we next need to wake the system.
@@ -183,8 +187,18 @@ private:
 
     void TicklessDebugDumpRetransTable(const char * log);
 
+    // The retransmission queue is a binary min-heap of the scheduled entries, ordered by their next
+    // retransmission time, so that the next entry to send is always at its front.
+    void ScheduleRetransmission(RetransTableEntry & entry, System::Clock::Timestamp retransTime);
+    void RemoveFromRetransTable(RetransTableEntry & entry);
+    void SetQueuePosition(size_t index, RetransTableEntry * entry);
+    void SiftUp(size_t index);
+    void SiftDown(size_t index);
+
     // ReliableMessageProtocol Global tables for timer context
     BitMapObjectPool<RetransTableEntry, CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE> mRetransTable;
+    RetransTableEntry * mRetransQueue[CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE];
+    size_t mRetransQueueSize = 0;
 };
 
 } // namespace Messaging
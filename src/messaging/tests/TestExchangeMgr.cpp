@@ -27,11 +27,13 @@
 #include <lib/support/CHIPMem.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/UnitTestRegistration.h>
+#include <lib/support/logging/CHIPLogging.h>
 #include <messaging/ExchangeContext.h>
 #include <messaging/ExchangeMgr.h>
 #include <messaging/Flags.h>
 #include <messaging/tests/MessagingContext.h>
 #include <protocols/Protocols.h>
+#include <system/SystemClock.h>
 #include <transport/SessionManager.h>
 #include <transport/TransportMgr.h>
 #include <transport/raw/tests/NetworkTestHelpers.h>
@@ -88,6 +90,23 @@ public:
     bool IsOnResponseTimeoutCalled = false;
 };
 
+// Keeps its exchange open after each message, so that the exchange can receive the next one.
+class CountingDelegate : public ExchangeDelegate
+{
+public:
+    CHIP_ERROR OnMessageReceived(ExchangeContext * ec, const PayloadHeader & payloadHeader,
+                                 System::PacketBufferHandle && buffer) override
+    {
+        ec->WillSendMessage();
+        mMessageCount++;
+        return CHIP_NO_ERROR;
+    }
+
+    void OnResponseTimeout(ExchangeContext * ec) override {}
+
+    uint32_t mMessageCount = 0;
+};
+
 void CheckNewContextTest(nlTestSuite * inSuite, void * inContext)
 {
     TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
@@ -226,6 +245,97 @@ void CheckExchangeMessages(nlTestSuite * inSuite, void * inContext)
     NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
 }
 
+void CheckExchangeDispatchBenchmark(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    constexpr size_t kExchangeCount  = (CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS < 256) ? CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS : 256;
+    constexpr uint32_t kMessageCount = 1000000;
+
+    CountingDelegate delegates[kExchangeCount];
+    ExchangeContext * exchanges[kExchangeCount];
+    for (size_t i = 0; i < kExchangeCount; i++)
+    {
+        exchanges[i] = ctx.NewExchangeToBob(&delegates[i]);
+        NL_TEST_ASSERT(inSuite, exchanges[i] != nullptr);
+        VerifyOrReturn(exchanges[i] != nullptr);
+    }
+
+    // Feed the messages straight to the exchange manager, as the session manager does once it has
+    // decrypted them, so that only the dispatch to the exchanges is measured.
+    SessionMessageDelegate & exchangeMgr = ctx.GetExchangeManager();
+    SessionHandle session                = exchanges[0]->GetSessionHandle();
+    PacketHeader packetHeader;
+    packetHeader.SetSessionId(ctx.GetBobKeyId());
+    PayloadHeader payloadHeader;
+    payloadHeader.SetMessageType(Protocols::BDX::Id, kMsgType_TEST1).SetInitiator(false);
+
+    auto dispatch = [&](size_t exchangeCount, size_t step) {
+        System::Clock::Microseconds64 start = System::SystemClock().GetMonotonicMicroseconds64();
+        for (uint32_t i = 0; i < kMessageCount; i++)
+        {
+            payloadHeader.SetExchangeID(exchanges[(i % exchangeCount) * step]->GetExchangeId());
+            packetHeader.SetMessageCounter(i);
+            exchangeMgr.OnMessageReceived(packetHeader, payloadHeader, session, Transport::PeerAddress(),
+                                          SessionMessageDelegate::DuplicateMessage::No, System::PacketBufferHandle());
+        }
+        return System::SystemClock().GetMonotonicMicroseconds64() - start;
+    };
+
+    // Every message is logged on receipt; keep that out of the measurement.
+    uint8_t logFilter = Logging::GetLogFilter();
+    Logging::SetLogFilter(Logging::kLogCategory_Error);
+    System::Clock::Microseconds64 oneExchange  = dispatch(1, 1);
+    System::Clock::Microseconds64 allExchanges = dispatch(kExchangeCount, 1);
+    Logging::SetLogFilter(logFilter);
+
+    ChipLogProgress(ExchangeManager, "Dispatched %u messages to 1 of %u open exchanges: %u ns per message",
+                    static_cast<unsigned>(kMessageCount), static_cast<unsigned>(kExchangeCount),
+                    static_cast<unsigned>(oneExchange.count() * 1000 / kMessageCount));
+    ChipLogProgress(ExchangeManager, "Dispatched %u messages to all of %u open exchanges: %u ns per message",
+                    static_cast<unsigned>(kMessageCount), static_cast<unsigned>(kExchangeCount),
+                    static_cast<unsigned>(allExchanges.count() * 1000 / kMessageCount));
+
+    uint32_t total = 0;
+    for (size_t i = 0; i < kExchangeCount; i++)
+    {
+        NL_TEST_ASSERT(inSuite, delegates[i].mMessageCount >= kMessageCount / kExchangeCount);
+        total += delegates[i].mMessageCount;
+    }
+    NL_TEST_ASSERT(inSuite, delegates[0].mMessageCount >= kMessageCount);
+    NL_TEST_ASSERT(inSuite, total == 2 * kMessageCount);
+
+    // Close every other exchange; the ones left must still be found, and no message may reach a closed one.
+    for (size_t i = 1; i < kExchangeCount; i += 2)
+    {
+        exchanges[i]->Close();
+        exchanges[i]               = nullptr;
+        delegates[i].mMessageCount = 0;
+    }
+    for (size_t i = 0; i < kExchangeCount; i += 2)
+    {
+        delegates[i].mMessageCount = 0;
+    }
+
+    Logging::SetLogFilter(Logging::kLogCategory_Error);
+    dispatch((kExchangeCount + 1) / 2, 2);
+    Logging::SetLogFilter(logFilter);
+
+    total = 0;
+    for (size_t i = 0; i < kExchangeCount; i++)
+    {
+        NL_TEST_ASSERT(inSuite, (i % 2 == 0) == (delegates[i].mMessageCount > 0));
+        total += delegates[i].mMessageCount;
+    }
+    NL_TEST_ASSERT(inSuite, total == kMessageCount);
+
+    for (size_t i = 0; i < kExchangeCount; i += 2)
+    {
+        exchanges[i]->Close();
+    }
+    NL_TEST_ASSERT(inSuite, ctx.GetExchangeManager().GetNumActiveExchanges() == 0);
+}
+
 // Test Suite
 
 /**
@@ -239,6 +349,7 @@ const nlTest sTests[] =
     NL_TEST_DEF("Test ExchangeMgr::CheckExchangeMessages",    CheckExchangeMessages),
     NL_TEST_DEF("Test OnConnectionExpired basics",            CheckSessionExpirationBasics),
     NL_TEST_DEF("Test OnConnectionExpired timeout handling",  CheckSessionExpirationTimeout),
+    NL_TEST_DEF("Test ExchangeMgr dispatch benchmark",        CheckExchangeDispatchBenchmark),
 
     NL_TEST_SENTINEL()
 };
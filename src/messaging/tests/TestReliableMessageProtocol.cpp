@@ -28,6 +28,7 @@
 #include <lib/support/CodeUtils.h>
 #include <lib/support/UnitTestRegistration.h>
 #include <lib/support/UnitTestUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
 #include <messaging/ReliableMessageContext.h>
 #include <messaging/ReliableMessageMgr.h>
 #include <protocols/Protocols.h>
@@ -38,6 +39,7 @@
 #include <nlbyteorder.h>
 #include <nlunit-test.h>
 
+#include <algorithm>
 #include <errno.h>
 
 #include <messaging/ExchangeContext.h>
@@ -125,6 +127,21 @@ public:
     nlTestSuite * mTestSuite       = nullptr;
 };
 
+class CountingReceiver : public ExchangeDelegate
+{
+public:
+    CHIP_ERROR OnMessageReceived(ExchangeContext * ec, const PayloadHeader & payloadHeader,
+                                 System::PacketBufferHandle && buffer) override
+    {
+        mMessageCount++;
+        return CHIP_NO_ERROR;
+    }
+
+    void OnResponseTimeout(ExchangeContext * ec) override {}
+
+    uint32_t mMessageCount = 0;
+};
+
 class MockSessionEstablishmentExchangeDispatch : public Messaging::ApplicationExchangeDispatch
 {
 public:
@@ -1343,6 +1360,85 @@ void CheckLostStandaloneAck(nlTestSuite * inSuite, void * inContext)
     NL_TEST_ASSERT(inSuite, rm->TestGetCountRetransTable() == 0);
 }
 
+void CheckRetransmissionStress(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    // Each exchange has at most one message waiting for an ack, and the receiving exchanges come out
+    // of the same pool as the sending ones.
+    constexpr size_t kMaxMessageCount =
+        std::min<size_t>(CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE, CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS / 2);
+    constexpr size_t kMessageCount = std::min<size_t>(1000, kMaxMessageCount);
+
+    ReliableMessageMgr * rm = ctx.GetExchangeManager().GetReliableMessageMgr();
+    NL_TEST_ASSERT(inSuite, rm != nullptr);
+    NL_TEST_ASSERT(inSuite, rm->TestGetCountRetransTable() == 0);
+
+    CountingReceiver receiver;
+    CHIP_ERROR err = ctx.GetExchangeManager().RegisterUnsolicitedMessageHandlerForType(Echo::MsgType::EchoRequest, &receiver);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    ctx.GetSessionBobToAlice()->AsSecureSession()->SetMRPConfig({
+        64_ms32, // CHIP_CONFIG_MRP_DEFAULT_IDLE_RETRY_INTERVAL
+        64_ms32, // CHIP_CONFIG_MRP_DEFAULT_ACTIVE_RETRY_INTERVAL
+    });
+
+    // Lose every first transmission, and the first half of the retransmissions.
+    gLoopback.mSentMessageCount    = 0;
+    gLoopback.mNumMessagesToDrop   = static_cast<uint32_t>(kMessageCount + kMessageCount / 2);
+    gLoopback.mDroppedMessageCount = 0;
+
+    uint8_t logFilter = Logging::GetLogFilter();
+    Logging::SetLogFilter(Logging::kLogCategory_Error);
+
+    MockAppDelegate senders[kMessageCount];
+    ExchangeContext * exchanges[kMessageCount];
+    System::Clock::Microseconds64 start = System::SystemClock().GetMonotonicMicroseconds64();
+    for (size_t i = 0; i < kMessageCount; i++)
+    {
+        exchanges[i] = ctx.NewExchangeToAlice(&senders[i]);
+        NL_TEST_ASSERT(inSuite, exchanges[i] != nullptr);
+
+        chip::System::PacketBufferHandle buffer = chip::MessagePacketBuffer::NewWithData(PAYLOAD, sizeof(PAYLOAD));
+        err = exchanges[i]->SendMessage(Echo::MsgType::EchoRequest, std::move(buffer), SendMessageFlags::kExpectResponse);
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    }
+    System::Clock::Microseconds64 queued = System::SystemClock().GetMonotonicMicroseconds64() - start;
+    NL_TEST_ASSERT(inSuite, rm->TestGetCountRetransTable() == static_cast<int>(kMessageCount));
+
+    ctx.GetIOContext().DriveIOUntil(5000_ms32, [rm] { return rm->TestGetCountRetransTable() == 0; });
+    ctx.DrainAndServiceIO();
+    System::Clock::Microseconds64 elapsed = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+    Logging::SetLogFilter(logFilter);
+
+    ChipLogProgress(ExchangeManager, "Queued %u reliable messages in %u us", static_cast<unsigned>(kMessageCount),
+                    static_cast<unsigned>(queued.count()));
+    ChipLogProgress(ExchangeManager, "Acknowledged %u reliable messages after %u losses in %u ms", static_cast<unsigned>(kMessageCount),
+                    static_cast<unsigned>(gLoopback.mDroppedMessageCount), static_cast<unsigned>(elapsed.count() / 1000));
+
+    NL_TEST_ASSERT(inSuite, gLoopback.mDroppedMessageCount == kMessageCount + kMessageCount / 2);
+    NL_TEST_ASSERT(inSuite, rm->TestGetCountRetransTable() == 0);
+    // Every message was acknowledged, but those that arrived too far behind the peer's message counter
+    // window are acknowledged as duplicates without being delivered.
+    NL_TEST_ASSERT(inSuite, receiver.mMessageCount > 0 && receiver.mMessageCount <= kMessageCount);
+    if (kMessageCount <= CHIP_CONFIG_MESSAGE_COUNTER_WINDOW_SIZE)
+    {
+        NL_TEST_ASSERT(inSuite, receiver.mMessageCount == kMessageCount);
+    }
+
+    for (ExchangeContext * exchange : exchanges)
+    {
+        if (exchange != nullptr)
+        {
+            exchange->Close();
+        }
+    }
+
+    err = ctx.GetExchangeManager().UnregisterUnsolicitedMessageHandlerForType(Echo::MsgType::EchoRequest);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+}
+
 int InitializeTestCase(void * inContext)
 {
     TestContext & ctx = *static_cast<TestContext *>(inContext);
@@ -1390,6 +1486,7 @@ const nlTest sTests[] =
     NL_TEST_DEF("Test that unencrypted message is dropped if exchange requires encryption", CheckUnencryptedMessageReceiveFailure),
     NL_TEST_DEF("Test that dropping an application-level message with a piggyback ack works ok once both sides retransmit", CheckLostResponseWithPiggyback),
     NL_TEST_DEF("Test that an application-level response-to-response after a lost standalone ack to the initial message works", CheckLostStandaloneAck),
+    NL_TEST_DEF("Test ReliableMessageMgr under load with 1k messages waiting for an ack and lost transmissions", CheckRetransmissionStress),
 
     NL_TEST_SENTINEL()
 };
@@ -70,6 +70,53 @@
 #define CHIP_DEVICE_LAYER_BLE_CONN_CFG_TAG 1
 #endif // CHIP_DEVICE_LAYER_BLE_CONN_CFG_TAG
 
+/**
+ * @def CHIP_DEVICE_CONFIG_LINUX_STORAGE_WRITE_BACK_WINDOW_MS
+ *
+ * The initial write-back window of the Linux configuration stores, in milliseconds.
+ *
+ * With a window of 0, every commit rewrites the whole configuration file. Otherwise commits are
+ * appended to a journal next to the file, which is synced at most once per window and folded back
+ * into the file when it grows past CHIP_DEVICE_CONFIG_LINUX_STORAGE_JOURNAL_COMPACT_SIZE. Changes
+ * committed less than one window before a crash may be lost, but the stored data stays consistent.
+ */
+#ifndef CHIP_DEVICE_CONFIG_LINUX_STORAGE_WRITE_BACK_WINDOW_MS
+#define CHIP_DEVICE_CONFIG_LINUX_STORAGE_WRITE_BACK_WINDOW_MS 0
+#endif // CHIP_DEVICE_CONFIG_LINUX_STORAGE_WRITE_BACK_WINDOW_MS
+
+/**
+ * @def CHIP_DEVICE_CONFIG_LINUX_STORAGE_JOURNAL_COMPACT_SIZE
+ *
+ * The journal size, in bytes, above which a Linux configuration store in write-back mode rewrites
+ * its configuration file and empties the journal. Compaction also waits for the journal to grow
+ * past the size of the configuration file, so that its cost stays proportional to the writes.
+ */
+#ifndef CHIP_DEVICE_CONFIG_LINUX_STORAGE_JOURNAL_COMPACT_SIZE
+#define CHIP_DEVICE_CONFIG_LINUX_STORAGE_JOURNAL_COMPACT_SIZE (64 * 1024)
+#endif // CHIP_DEVICE_CONFIG_LINUX_STORAGE_JOURNAL_COMPACT_SIZE
+
+/**
+ * @def CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_COMPACT_SIZE
+ *
+ * The number of bytes of overwritten and deleted values above which the log-structured key-value
+ * store (see chip_linux_kvs_backend) copies its live records to a new file. Compaction also waits
+ * for these to take more than half of the file.
+ */
+#ifndef CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_COMPACT_SIZE
+#define CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_COMPACT_SIZE (64 * 1024)
+#endif // CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_COMPACT_SIZE
+
+/**
+ * @def CHIP_DEVICE_CONFIG_LINUX_CRYPTO_WORKER_THREADS
+ *
+ * The number of threads that run CASE and PASE public-key operations (ECDH, ECDSA, certificate
+ * chain validation, SPAKE2+) off the CHIP event loop. With 0, these run inline on the event loop.
+ * Only used with the OpenSSL crypto PAL; the mbedTLS PAL is not safe to call from several threads.
+ */
+#ifndef CHIP_DEVICE_CONFIG_LINUX_CRYPTO_WORKER_THREADS
+#define CHIP_DEVICE_CONFIG_LINUX_CRYPTO_WORKER_THREADS 2
+#endif // CHIP_DEVICE_CONFIG_LINUX_CRYPTO_WORKER_THREADS
+
 // ========== Platform-specific Configuration Overrides =========
 
 #ifndef CHIP_DEVICE_CONFIG_CHIP_TASK_STACK_SIZE
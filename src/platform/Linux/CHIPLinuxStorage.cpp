@@ -23,11 +23,15 @@
  *
  */
 
+#include <ctype.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <fstream>
 #include <inttypes.h>
+#include <iterator>
 #include <libgen.h>
 #include <string>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include <lib/support/Base64.h>
@@ -42,19 +46,61 @@ namespace chip {
 namespace DeviceLayer {
 namespace Internal {
 
+namespace {
+
+// Parses the journal record at the given offset, see ChipLinuxStorage::AppendJournalRecord(). Returns the offset of the
+// next record, or 0 if the record is incomplete.
+size_t ParseJournalRecord(const std::string & journal, size_t offset, char & op, std::string & key, std::string & value)
+{
+    const char * record = journal.c_str() + offset;
+    char * end          = nullptr;
+
+    VerifyOrReturnError(record[0] != '\0' && record[1] == ' ' && isdigit(record[2]), 0);
+    unsigned long keyLen = strtoul(&record[2], &end, 10);
+    VerifyOrReturnError(end[0] == ' ' && isdigit(end[1]), 0);
+    unsigned long valueLen = strtoul(&end[1], &end, 10);
+    VerifyOrReturnError(end[0] == ' ', 0);
+
+    size_t start     = static_cast<size_t>(end + 1 - journal.c_str());
+    size_t available = journal.size() - start;
+
+    VerifyOrReturnError(keyLen < available && valueLen < available - keyLen, 0);
+    VerifyOrReturnError(journal[start + keyLen + valueLen] == '\n', 0);
+
+    op = record[0];
+    key.assign(journal, start, keyLen);
+    value.assign(journal, start + keyLen, valueLen);
+
+    return start + keyLen + valueLen + 1;
+}
+
+} // namespace
+
 ChipLinuxStorage::ChipLinuxStorage()
 {
     mDirty = false;
 }
 
-ChipLinuxStorage::~ChipLinuxStorage() {}
+ChipLinuxStorage::~ChipLinuxStorage()
+{
+    if (mWriteBackWindow > System::Clock::kZero)
+    {
+        SetWriteBackWindow(System::Clock::kZero);
+    }
+}
 
 CHIP_ERROR ChipLinuxStorage::Init(const char * configFile)
 {
     CHIP_ERROR retval = CHIP_NO_ERROR;
 
+    if (mWriteBackWindow > System::Clock::kZero)
+    {
+        SetWriteBackWindow(System::Clock::kZero);
+    }
+
     mConfigPath.assign(configFile);
-    retval = ChipLinuxStorageIni::Init();
+    mJournalPath = mConfigPath + ".journal";
+    retval       = ChipLinuxStorageIni::Init();
 
     if (retval == CHIP_NO_ERROR)
     {
@@ -76,6 +122,16 @@ CHIP_ERROR ChipLinuxStorage::Init(const char * configFile)
         retval = ChipLinuxStorageIni::AddConfig(mConfigPath);
     }
 
+    if (retval == CHIP_NO_ERROR)
+    {
+        retval = ReplayJournal();
+    }
+
+    if (retval == CHIP_NO_ERROR && CHIP_DEVICE_CONFIG_LINUX_STORAGE_WRITE_BACK_WINDOW_MS > 0)
+    {
+        retval = SetWriteBackWindow(System::Clock::Milliseconds32(CHIP_DEVICE_CONFIG_LINUX_STORAGE_WRITE_BACK_WINDOW_MS));
+    }
+
     return retval;
 }
 
@@ -188,6 +244,11 @@ CHIP_ERROR ChipLinuxStorage::WriteValueStr(const char * key, const char * val)
 
     retval = ChipLinuxStorageIni::AddEntry(key, val);
 
+    if (retval == CHIP_NO_ERROR)
+    {
+        AppendJournalRecord('S', key, val);
+    }
+
     mDirty = true;
 
     mLock.unlock();
@@ -248,6 +309,7 @@ CHIP_ERROR ChipLinuxStorage::ClearValue(const char * key)
 
     if (retval == CHIP_NO_ERROR)
     {
+        AppendJournalRecord('D', key, nullptr);
         mDirty = true;
     }
     else
@@ -268,6 +330,11 @@ CHIP_ERROR ChipLinuxStorage::ClearAll()
 
     retval = ChipLinuxStorageIni::RemoveAll();
 
+    if (retval == CHIP_NO_ERROR)
+    {
+        AppendJournalRecord('X', "", nullptr);
+    }
+
     mLock.unlock();
 
     if (retval == CHIP_NO_ERROR)
@@ -304,7 +371,15 @@ CHIP_ERROR ChipLinuxStorage::Commit()
     {
         mLock.lock();
 
-        retval = ChipLinuxStorageIni::CommitConfig(mConfigPath);
+        if (mWriteBackWindow > System::Clock::kZero)
+        {
+            // The changes are already queued for the journal, the write-back thread writes them out.
+            mWriteBackCondition.notify_one();
+        }
+        else
+        {
+            retval = ChipLinuxStorageIni::CommitConfig(mConfigPath);
+        }
 
         mLock.unlock();
     }
@@ -316,6 +391,290 @@ CHIP_ERROR ChipLinuxStorage::Commit()
     return retval;
 }
 
+CHIP_ERROR ChipLinuxStorage::SetWriteBackWindow(System::Clock::Milliseconds32 window)
+{
+    CHIP_ERROR retval = CHIP_NO_ERROR;
+
+    StopWriteBack();
+
+    std::lock_guard<std::mutex> lock(mLock);
+
+    VerifyOrReturnError(!mConfigPath.empty(), CHIP_ERROR_INCORRECT_STATE);
+
+    if (window == System::Clock::kZero)
+    {
+        // Fold the journal back into the configuration file, which is then complete on its own.
+        if (mJournalFd != -1)
+        {
+            retval = CompactJournal();
+            close(mJournalFd);
+            mJournalFd = -1;
+            if (retval == CHIP_NO_ERROR)
+            {
+                unlink(mJournalPath.c_str());
+            }
+        }
+        mWriteBackWindow = window;
+        return retval;
+    }
+
+    if (mJournalFd == -1)
+    {
+        struct stat info;
+
+        mJournalFd = open(mJournalPath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, S_IRUSR | S_IWUSR);
+        if (mJournalFd == -1)
+        {
+            ChipLogError(DeviceLayer, "failed to open journal (%s), %s (%d)", mJournalPath.c_str(), strerror(errno), errno);
+            return CHIP_ERROR_OPEN_FAILED;
+        }
+
+        mJournalSize    = (fstat(mJournalFd, &info) == 0) ? static_cast<size_t>(info.st_size) : 0;
+        mConfigFileSize = (stat(mConfigPath.c_str(), &info) == 0) ? static_cast<size_t>(info.st_size) : 0;
+    }
+
+    mWriteBackWindow = window;
+    mWriteBackThread = std::thread(&ChipLinuxStorage::WriteBackThread, this);
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ChipLinuxStorage::Flush()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    // Without write-back, every Commit() has already written the configuration file.
+    VerifyOrReturnError(mWriteBackWindow > System::Clock::kZero, CHIP_NO_ERROR);
+
+    return SyncJournal();
+}
+
+// Journal records are "<op> <key length> <value length> <key><value>\n", where op is 'S' to set a
+// value, 'D' to delete one and 'X' to delete all of them. Replaying a journal onto a configuration
+// file that already has some or all of its changes gives the same result, so the configuration
+// file can be rewritten before the journal is emptied.
+void ChipLinuxStorage::AppendJournalRecord(char op, const char * key, const char * value)
+{
+    VerifyOrReturn(mWriteBackWindow > System::Clock::kZero);
+
+    size_t keyLen   = strlen(key);
+    size_t valueLen = (value != nullptr) ? strlen(value) : 0;
+    char header[48];
+
+    snprintf(header, sizeof(header), "%c %zu %zu ", op, keyLen, valueLen);
+
+    mPendingRecords.append(header);
+    mPendingRecords.append(key, keyLen);
+    mPendingRecords.append((value != nullptr) ? value : "", valueLen);
+    mPendingRecords.push_back('\n');
+}
+
+CHIP_ERROR ChipLinuxStorage::ReplayJournal()
+{
+    std::ifstream ifs;
+
+    ifs.open(mJournalPath, std::ifstream::in | std::ifstream::binary);
+    VerifyOrReturnError(ifs.is_open(), CHIP_NO_ERROR);
+
+    std::string journal((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    std::string key;
+    std::string value;
+    size_t offset  = 0;
+    size_t records = 0;
+    char op;
+
+    ifs.close();
+
+    while (offset < journal.size())
+    {
+        // A record cut short by a crash ends the journal.
+        size_t next = ParseJournalRecord(journal, offset, op, key, value);
+        if (next == 0)
+        {
+            break;
+        }
+
+        if (op == 'S')
+        {
+            ReturnErrorOnFailure(ChipLinuxStorageIni::AddEntry(key.c_str(), value.c_str()));
+        }
+        else if (op == 'D')
+        {
+            ChipLinuxStorageIni::RemoveEntry(key.c_str());
+        }
+        else if (op == 'X')
+        {
+            ChipLinuxStorageIni::RemoveAll();
+        }
+        else
+        {
+            break;
+        }
+
+        offset = next;
+        records++;
+    }
+
+    if (offset < journal.size())
+    {
+        ChipLogError(DeviceLayer, "ignoring %u bytes of incomplete journal (%s)", static_cast<unsigned>(journal.size() - offset),
+                     mJournalPath.c_str());
+    }
+
+    ChipLogProgress(DeviceLayer, "replayed %u records from journal (%s)", static_cast<unsigned>(records), mJournalPath.c_str());
+
+    std::lock_guard<std::mutex> lock(mLock);
+    return CompactJournal();
+}
+
+CHIP_ERROR ChipLinuxStorage::SyncJournal()
+{
+    VerifyOrReturnError(!mPendingRecords.empty(), CHIP_NO_ERROR);
+    VerifyOrReturnError(mJournalFd != -1, CHIP_ERROR_INCORRECT_STATE);
+
+    const char * data = mPendingRecords.data();
+    size_t remaining  = mPendingRecords.size();
+
+    while (remaining > 0)
+    {
+        ssize_t written = write(mJournalFd, data, remaining);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            break;
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+
+    if (remaining > 0 || fdatasync(mJournalFd) != 0)
+    {
+        ChipLogError(DeviceLayer, "failed to write journal (%s), %s (%d)", mJournalPath.c_str(), strerror(errno), errno);
+
+        // Drop any partial record, so that records appended later are not hidden behind it.
+        if (ftruncate(mJournalFd, static_cast<off_t>(mJournalSize)) != 0)
+        {
+            ChipLogError(DeviceLayer, "failed to truncate journal (%s)", mJournalPath.c_str());
+        }
+        return CHIP_ERROR_WRITE_FAILED;
+    }
+
+    mJournalSize += mPendingRecords.size();
+    mPendingRecords.clear();
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ChipLinuxStorage::CompactJournal()
+{
+    struct stat info;
+
+    ReturnErrorOnFailure(ChipLinuxStorageIni::CommitConfig(mConfigPath));
+
+    mConfigFileSize = (stat(mConfigPath.c_str(), &info) == 0) ? static_cast<size_t>(info.st_size) : 0;
+    mPendingRecords.clear();
+
+    return TruncateJournal();
+}
+
+// Same as CompactJournal, but the configuration file is written with mLock released, so that the
+// storage can still be read and written meanwhile. Only the image of the configuration is made
+// under the lock.
+CHIP_ERROR ChipLinuxStorage::CompactJournalUnlocked(std::unique_lock<std::mutex> & lock)
+{
+    std::string image;
+
+    ReturnErrorOnFailure(ChipLinuxStorageIni::GenerateConfig(image));
+    const size_t journalSize = mJournalSize;
+
+    lock.unlock();
+    CHIP_ERROR err = ChipLinuxStorageIni::WriteConfigFile(mConfigPath, image);
+    lock.lock();
+
+    ReturnErrorOnFailure(err);
+    mConfigFileSize = image.size();
+
+    // The changes made meanwhile are either still pending, or were synced to the journal by Flush().
+    // In the latter case they may not be in the image, so the journal is kept until the next
+    // compaction: replaying it onto the new configuration file gives the same result.
+    VerifyOrReturnError(mJournalSize == journalSize, CHIP_NO_ERROR);
+
+    return TruncateJournal();
+}
+
+CHIP_ERROR ChipLinuxStorage::TruncateJournal()
+{
+    mJournalSize = 0;
+
+    if (mJournalFd == -1)
+    {
+        unlink(mJournalPath.c_str());
+    }
+    else if (ftruncate(mJournalFd, 0) != 0 || fdatasync(mJournalFd) != 0)
+    {
+        ChipLogError(DeviceLayer, "failed to truncate journal (%s), %s (%d)", mJournalPath.c_str(), strerror(errno), errno);
+        return CHIP_ERROR_WRITE_FAILED;
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+bool ChipLinuxStorage::ShouldCompactJournal() const
+{
+    // Waiting for the journal to outgrow the configuration file keeps the cost of rewriting it in
+    // proportion to the number of writes.
+    return mJournalSize > CHIP_DEVICE_CONFIG_LINUX_STORAGE_JOURNAL_COMPACT_SIZE && mJournalSize > mConfigFileSize;
+}
+
+void ChipLinuxStorage::StopWriteBack()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mStopWriteBack = true;
+    }
+    mWriteBackCondition.notify_one();
+
+    if (mWriteBackThread.joinable())
+    {
+        mWriteBackThread.join();
+    }
+
+    mStopWriteBack = false;
+}
+
+void ChipLinuxStorage::WriteBackThread()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+
+    while (!mStopWriteBack)
+    {
+        if (mPendingRecords.empty())
+        {
+            mWriteBackCondition.wait(lock);
+            continue;
+        }
+
+        // Let the changes committed within the window join this write.
+        if (mWriteBackCondition.wait_for(lock, mWriteBackWindow, [this] { return mStopWriteBack; }))
+        {
+            break;
+        }
+
+        CHIP_ERROR err = SyncJournal();
+        if (err == CHIP_NO_ERROR && ShouldCompactJournal())
+        {
+            err = CompactJournalUnlocked(lock);
+        }
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(DeviceLayer, "write-back to (%s) failed: %s", mConfigPath.c_str(), ErrorStr(err));
+        }
+    }
+}
+
 } // namespace Internal
 } // namespace DeviceLayer
 } // namespace chip
@@ -29,12 +29,22 @@
  *
  *         ChipLinuxStorage wraps the storage class ChipLinuxStorageIni with mutex.
  *
+ *         In write-back mode, committed changes are appended to a journal file
+ *         next to the configuration file (with a ".journal" suffix) and the
+ *         configuration file is only rewritten when the journal has grown large.
+ *         The journal is replayed by Init(), so a crash loses at most the changes
+ *         committed within the last write-back window.
+ *
  */
 
 #pragma once
 
+#include <condition_variable>
 #include <mutex>
 #include <platform/Linux/CHIPLinuxStorageIni.h>
+#include <string>
+#include <system/SystemClock.h>
+#include <thread>
 
 #ifndef FATCONFDIR
 #define FATCONFDIR "/tmp"
@@ -84,10 +94,42 @@ public:
     CHIP_ERROR Commit();
     bool HasValue(const char * key);
 
+    /**
+     * Set how long committed changes may be held in memory before they are written to the journal. A window of 0 turns
+     * write-back mode off, so that every Commit() rewrites the configuration file again.
+     */
+    CHIP_ERROR SetWriteBackWindow(System::Clock::Milliseconds32 window);
+
+    /**
+     * Make all committed changes durable now, whatever the write-back window.
+     */
+    CHIP_ERROR Flush();
+
 private:
+    CHIP_ERROR ReplayJournal();
+    void AppendJournalRecord(char op, const char * key, const char * value);
+    CHIP_ERROR SyncJournal();
+    CHIP_ERROR CompactJournal();
+    CHIP_ERROR CompactJournalUnlocked(std::unique_lock<std::mutex> & lock);
+    CHIP_ERROR TruncateJournal();
+    bool ShouldCompactJournal() const;
+    void StopWriteBack();
+    void WriteBackThread();
+
     std::mutex mLock;
     bool mDirty;
     std::string mConfigPath;
+
+    // Write-back state, all guarded by mLock.
+    System::Clock::Milliseconds32 mWriteBackWindow = System::Clock::kZero;
+    std::string mJournalPath;
+    int mJournalFd         = -1;
+    size_t mJournalSize    = 0; // Bytes synced to the journal
+    size_t mConfigFileSize = 0; // Size of the configuration file when last written
+    std::string mPendingRecords;
+    bool mStopWriteBack = false;
+    std::condition_variable mWriteBackCondition;
+    std::thread mWriteBackThread;
 };
 
 } // namespace Internal
@@ -23,7 +23,10 @@
  *
  */
 
+#include <fcntl.h>
 #include <fstream>
+#include <libgen.h>
+#include <sstream>
 #include <string>
 #include <unistd.h>
 
@@ -82,11 +85,31 @@ CHIP_ERROR ChipLinuxStorageIni::AddConfig(const std::string & configFile)
     return retval;
 }
 
+CHIP_ERROR ChipLinuxStorageIni::CommitConfig(const std::string & configFile)
+{
+    std::string image;
+
+    ReturnErrorOnFailure(GenerateConfig(image));
+    return WriteConfigFile(configFile, image);
+}
+
+CHIP_ERROR ChipLinuxStorageIni::GenerateConfig(std::string & image)
+{
+    std::ostringstream oss;
+
+    mConfigStore.generate(oss);
+    VerifyOrReturnError(!oss.fail(), CHIP_ERROR_NO_MEMORY);
+    image = oss.str();
+
+    return CHIP_NO_ERROR;
+}
+
 // Updating a file atomically and durably on Linux requires:
 // 1. Writing to a temporary file
 // 2. Sync'ing the temp file to commit updated data
 // 3. Using rename() to overwrite the existing file
-CHIP_ERROR ChipLinuxStorageIni::CommitConfig(const std::string & configFile)
+// 4. Sync'ing the directory to commit the rename
+CHIP_ERROR ChipLinuxStorageIni::WriteConfigFile(const std::string & configFile, const std::string & image)
 {
     CHIP_ERROR retval   = CHIP_NO_ERROR;
     std::string tmpPath = configFile + "-XXXXXX";
@@ -99,13 +122,32 @@ CHIP_ERROR ChipLinuxStorageIni::CommitConfig(const std::string & configFile)
         ChipLogProgress(DeviceLayer, "writing settings to file (%s)", tmpPath.c_str());
 
         ofs.open(tmpPath, std::ofstream::out | std::ofstream::trunc);
-        mConfigStore.generate(ofs);
+        ofs << image;
+        ofs.close();
+
+        if (ofs.fail() || fsync(fd) != 0)
+        {
+            ChipLogError(DeviceLayer, "failed to write (%s)", tmpPath.c_str());
+            retval = CHIP_ERROR_WRITE_FAILED;
+        }
 
         close(fd);
 
-        if (rename(tmpPath.c_str(), configFile.c_str()) == 0)
+        if (retval != CHIP_NO_ERROR)
+        {
+            unlink(tmpPath.c_str());
+        }
+        else if (rename(tmpPath.c_str(), configFile.c_str()) == 0)
         {
             ChipLogError(DeviceLayer, "renamed tmp file to file (%s)", configFile.c_str());
+
+            std::string dirPath = configFile;
+            int dirFd           = open(dirname(&dirPath[0]), O_RDONLY | O_DIRECTORY);
+            if (dirFd != -1)
+            {
+                fsync(dirFd);
+                close(dirFd);
+            }
         }
         else
         {
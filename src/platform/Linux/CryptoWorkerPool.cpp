@@ -0,0 +1,173 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *         Implementation of the Linux crypto worker pool.
+ */
+
+#include <platform/Linux/CryptoWorkerPool.h>
+
+#include <algorithm>
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <platform/PlatformManager.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+CryptoWorkerPool & CryptoWorkerPool::Instance()
+{
+    static CryptoWorkerPool sInstance;
+    return sInstance;
+}
+
+CHIP_ERROR CryptoWorkerPool::Init(size_t threadCount)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    VerifyOrReturnError(mThreads.empty(), CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(threadCount > 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    mShutdown = false;
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        mThreads.emplace_back(&CryptoWorkerPool::WorkerThread, this);
+    }
+
+    ChipLogProgress(DeviceLayer, "Started %u crypto worker threads", static_cast<unsigned>(threadCount));
+    return CHIP_NO_ERROR;
+}
+
+void CryptoWorkerPool::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mShutdown = true;
+    }
+    mCondition.notify_all();
+
+    for (std::thread & thread : mThreads)
+    {
+        thread.join();
+    }
+    mThreads.clear();
+
+    std::lock_guard<std::mutex> lock(mLock);
+    for (Crypto::CryptoJob * job : mPending)
+    {
+        Platform::Delete(job);
+    }
+    mPending.clear();
+    for (auto & done : mDone)
+    {
+        Platform::Delete(done.first);
+    }
+    mDone.clear();
+}
+
+void CryptoWorkerPool::Post(Crypto::CryptoJob * job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        if (!mThreads.empty() && !mShutdown)
+        {
+            mPending.push_back(job);
+            mCondition.notify_one();
+            return;
+        }
+    }
+
+    job->OnComplete(job->Run());
+    Platform::Delete(job);
+}
+
+void CryptoWorkerPool::Cancel(Crypto::CryptoJob * job)
+{
+    std::unique_lock<std::mutex> lock(mLock);
+
+    auto pending = std::find(mPending.begin(), mPending.end(), job);
+    if (pending == mPending.end())
+    {
+        mCondition.wait(lock, [this, job] { return std::find(mRunning.begin(), mRunning.end(), job) == mRunning.end(); });
+        // The completion already scheduled for this job will find nothing to dispatch.
+        mDone.erase(job);
+    }
+    else
+    {
+        mPending.erase(pending);
+    }
+
+    Platform::Delete(job);
+}
+
+void CryptoWorkerPool::WorkerThread()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+
+    while (true)
+    {
+        mCondition.wait(lock, [this] { return mShutdown || !mPending.empty(); });
+        if (mShutdown)
+        {
+            return;
+        }
+
+        Crypto::CryptoJob * job = mPending.front();
+        mPending.pop_front();
+        mRunning.push_back(job);
+
+        lock.unlock();
+        CHIP_ERROR err = job->Run();
+        lock.lock();
+
+        mRunning.erase(std::find(mRunning.begin(), mRunning.end(), job));
+        mDone.emplace(job, err);
+        // Wake any Cancel() waiting for this job to return.
+        mCondition.notify_all();
+
+        PlatformMgr().ScheduleWork(DispatchCompletion, reinterpret_cast<intptr_t>(job));
+    }
+}
+
+void CryptoWorkerPool::DispatchCompletion(intptr_t arg)
+{
+    CryptoWorkerPool & pool = Instance();
+    auto * job              = reinterpret_cast<Crypto::CryptoJob *>(arg);
+    CHIP_ERROR err;
+
+    {
+        std::lock_guard<std::mutex> lock(pool.mLock);
+        auto done = pool.mDone.find(job);
+        // Cancelled, or the pool was shut down. A job posted since then at the same address may
+        // be completed here rather than by its own dispatch, which then finds nothing; either way
+        // its Run() has returned.
+        VerifyOrReturn(done != pool.mDone.end());
+        err = done->second;
+        pool.mDone.erase(done);
+    }
+
+    job->OnComplete(err);
+    Platform::Delete(job);
+}
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
@@ -0,0 +1,82 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *         This file defines a crypto job queue for Linux that runs jobs on a
+ *         fixed number of worker threads, so that CASE and PASE public-key
+ *         operations do not stall the CHIP event loop. Completions are handed
+ *         back to the CHIP stack thread with PlatformMgr().ScheduleWork().
+ *
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <crypto/CryptoJobQueue.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+class CryptoWorkerPool : public Crypto::CryptoJobQueue
+{
+public:
+    static CryptoWorkerPool & Instance();
+
+    /**
+     * Start the worker threads. Jobs posted while the pool is not running are run inline.
+     */
+    CHIP_ERROR Init(size_t threadCount);
+
+    /**
+     * Stop the worker threads, after any jobs they are running have returned. Jobs that have not
+     * completed yet are destroyed without their completion being called.
+     */
+    void Shutdown();
+
+    void Post(Crypto::CryptoJob * job) override;
+    void Cancel(Crypto::CryptoJob * job) override;
+
+private:
+    CryptoWorkerPool() = default;
+    ~CryptoWorkerPool() { Shutdown(); }
+
+    void WorkerThread();
+    static void DispatchCompletion(intptr_t job);
+
+    std::mutex mLock;
+    std::condition_variable mCondition;
+    std::vector<std::thread> mThreads;
+    bool mShutdown = false;
+
+    std::deque<Crypto::CryptoJob *> mPending;
+    std::vector<Crypto::CryptoJob *> mRunning;
+    // Jobs whose Run() has returned, waiting for their completion to be dispatched.
+    std::unordered_map<Crypto::CryptoJob *, CHIP_ERROR> mDone;
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
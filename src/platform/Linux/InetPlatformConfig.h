@@ -46,3 +46,14 @@
 
 // On linux platform, we have sys/socket.h, so HAVE_SO_BINDTODEVICE should be set to 1
 #define HAVE_SO_BINDTODEVICE 1
+
+#define HAVE_RECVMMSG 1
+#define HAVE_SENDMMSG 1
+
+#ifndef INET_CONFIG_UDP_SOCKET_RECEIVE_BATCH_SIZE
+#define INET_CONFIG_UDP_SOCKET_RECEIVE_BATCH_SIZE 8
+#endif // INET_CONFIG_UDP_SOCKET_RECEIVE_BATCH_SIZE
+
+#ifndef INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE
+#define INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE 16
+#endif // INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE
@@ -0,0 +1,659 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *         This file implements a log-structured key-value store for Linux.
+ *
+ *         The log file starts with an 8 byte magic, followed by records of:
+ *
+ *           uint32_t crc          CRC-32 of the rest of the record
+ *           uint32_t valueLength
+ *           uint16_t keyLength
+ *           uint8_t  type         kRecordPut or kRecordDelete
+ *           uint8_t  reserved
+ *           key, then value
+ *
+ *         with all integers little-endian.
+ *
+ */
+
+#include <platform/Linux/KeyValueStoreLog.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include <lib/core/CHIPEncoding.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <platform/internal/CHIPDeviceLayerInternal.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+namespace {
+
+constexpr uint8_t kMagic[8]     = { 'C', 'H', 'I', 'P', 'K', 'V', 'L', 1 };
+constexpr size_t kHeaderLength  = 12;
+constexpr uint8_t kRecordPut    = 1;
+constexpr uint8_t kRecordDelete = 2;
+
+// The mapping grows in powers of two from this size, so that appending rarely needs to remap the file.
+constexpr size_t kMinMapSize = 1024 * 1024;
+
+// Compaction writes the live records out in chunks of this size.
+constexpr size_t kCompactionBufferSize = 64 * 1024;
+
+uint32_t Crc32(uint32_t crc, const void * data, size_t length)
+{
+    static const std::array<uint32_t, 256> sTable = [] {
+        std::array<uint32_t, 256> table;
+        for (uint32_t i = 0; i < table.size(); i++)
+        {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; bit++)
+            {
+                value = (value & 1) ? (0xEDB88320 ^ (value >> 1)) : (value >> 1);
+            }
+            table[i] = value;
+        }
+        return table;
+    }();
+
+    const uint8_t * bytes = static_cast<const uint8_t *>(data);
+
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++)
+    {
+        crc = sTable[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+bool WriteAll(int fd, const std::string & data)
+{
+    size_t written = 0;
+
+    while (written < data.size())
+    {
+        ssize_t result = write(fd, data.data() + written, data.size() - written);
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (result <= 0)
+        {
+            return false;
+        }
+        written += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+// Appends length bytes of fd, from offset, to buffer.
+bool ReadAll(int fd, size_t offset, size_t length, std::string & buffer)
+{
+    size_t start = buffer.size();
+    size_t done  = 0;
+
+    buffer.resize(start + length);
+    while (done < length)
+    {
+        ssize_t result = pread(fd, &buffer[start + done], length - done, static_cast<off_t>(offset + done));
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (result <= 0)
+        {
+            return false;
+        }
+        done += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+// Appends the bytes of sourceFd from offset from to offset to at the end of fd, whose size is then size.
+bool CopyRange(int sourceFd, size_t from, size_t to, int fd, size_t & size)
+{
+    std::string buffer;
+
+    for (size_t offset = from; offset < to; offset += buffer.size())
+    {
+        buffer.clear();
+        if (!ReadAll(sourceFd, offset, std::min(to - offset, kCompactionBufferSize), buffer) || !WriteAll(fd, buffer))
+        {
+            return false;
+        }
+        size += buffer.size();
+    }
+    return true;
+}
+
+void SyncDirectory(const std::string & path)
+{
+    std::string dirPath = path;
+    int dirFd           = open(dirname(&dirPath[0]), O_RDONLY | O_DIRECTORY);
+    if (dirFd != -1)
+    {
+        fsync(dirFd);
+        close(dirFd);
+    }
+}
+
+} // namespace
+
+KeyValueStoreLog::~KeyValueStoreLog()
+{
+    Shutdown();
+}
+
+CHIP_ERROR KeyValueStoreLog::Init(const char * file)
+{
+    VerifyOrReturnError(file != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    Shutdown();
+
+    std::lock_guard<std::mutex> lock(mLock);
+
+    mPath.assign(file);
+
+    // Left behind by a compaction that did not finish, the log itself is intact.
+    unlink((mPath + ".compact").c_str());
+
+    mFd = open(file, O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (mFd == -1)
+    {
+        ChipLogError(DeviceLayer, "failed to open (%s), %s (%d)", file, strerror(errno), errno);
+        return CHIP_ERROR_OPEN_FAILED;
+    }
+
+    CHIP_ERROR err = Load();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(DeviceLayer, "failed to load (%s): %s", file, ErrorStr(err));
+        if (mMap != nullptr)
+        {
+            munmap(const_cast<uint8_t *>(mMap), mMapSize);
+            mMap     = nullptr;
+            mMapSize = 0;
+        }
+        close(mFd);
+        mFd = -1;
+        mIndex.clear();
+        return err;
+    }
+
+    mCompactionThread = std::thread(&KeyValueStoreLog::CompactionThread, this);
+
+    return CHIP_NO_ERROR;
+}
+
+void KeyValueStoreLog::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mStopCompaction = true;
+    }
+    mCompactionCondition.notify_one();
+
+    if (mCompactionThread.joinable())
+    {
+        mCompactionThread.join();
+    }
+
+    // A Compact() called by the application may still be copying records from the file.
+    std::lock_guard<std::mutex> compactionLock(mCompactionLock);
+    std::lock_guard<std::mutex> lock(mLock);
+
+    mStopCompaction = false;
+
+    if (mMap != nullptr)
+    {
+        munmap(const_cast<uint8_t *>(mMap), mMapSize);
+        mMap     = nullptr;
+        mMapSize = 0;
+    }
+    if (mFd != -1)
+    {
+        close(mFd);
+        mFd = -1;
+    }
+    mIndex.clear();
+    mFileSize  = 0;
+    mDeadBytes = 0;
+}
+
+CHIP_ERROR KeyValueStoreLog::Get(const char * key, void * value, size_t value_size, size_t * read_bytes_size, size_t offset)
+{
+    VerifyOrReturnError(key != nullptr && value != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    std::lock_guard<std::mutex> lock(mLock);
+
+    VerifyOrReturnError(mMap != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    auto entry = mIndex.find(key);
+    VerifyOrReturnError(entry != mIndex.end(), CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+    VerifyOrReturnError(offset <= entry->second.valueLength, CHIP_ERROR_INVALID_ARGUMENT);
+
+    // Copy straight out of the mapping of the log.
+    size_t remaining = entry->second.valueLength - offset;
+    size_t copy_size = std::min(value_size, remaining);
+    memcpy(value, mMap + entry->second.recordOffset + kHeaderLength + entry->first.size() + offset, copy_size);
+
+    if (read_bytes_size != nullptr)
+    {
+        *read_bytes_size = copy_size;
+    }
+
+    return (copy_size < remaining) ? CHIP_ERROR_BUFFER_TOO_SMALL : CHIP_NO_ERROR;
+}
+
+CHIP_ERROR KeyValueStoreLog::Put(const char * key, const void * value, size_t value_size)
+{
+    VerifyOrReturnError(key != nullptr && (value != nullptr || value_size == 0), CHIP_ERROR_INVALID_ARGUMENT);
+
+    std::lock_guard<std::mutex> lock(mLock);
+
+    std::string name(key);
+    size_t offset = mFileSize;
+
+    ReturnErrorOnFailure(Append(kRecordPut, name, value, value_size));
+
+    IndexEntry newEntry = { offset, static_cast<uint32_t>(value_size) };
+    auto entry          = mIndex.find(name);
+    if (entry != mIndex.end())
+    {
+        mDeadBytes += kHeaderLength + entry->first.size() + entry->second.valueLength;
+        entry->second = newEntry;
+    }
+    else
+    {
+        mIndex.emplace(std::move(name), newEntry);
+    }
+
+    if (ShouldCompact())
+    {
+        mCompactionCondition.notify_one();
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR KeyValueStoreLog::Delete(const char * key)
+{
+    VerifyOrReturnError(key != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    std::lock_guard<std::mutex> lock(mLock);
+
+    auto entry = mIndex.find(key);
+    VerifyOrReturnError(entry != mIndex.end(), CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+
+    size_t offset = mFileSize;
+    ReturnErrorOnFailure(Append(kRecordDelete, entry->first, nullptr, 0));
+
+    // The delete record itself is only needed until the deleted value is compacted away.
+    mDeadBytes += mFileSize - offset;
+    Forget(entry);
+
+    if (ShouldCompact())
+    {
+        mCompactionCondition.notify_one();
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR KeyValueStoreLog::Compact()
+{
+    std::lock_guard<std::mutex> compactionLock(mCompactionLock);
+
+    std::vector<MovedRecord> records;
+    std::string tmpPath;
+    std::string path;
+    size_t snapshotEnd = 0;
+    int sourceFd       = -1;
+
+    // The log is only appended to, so the records before snapshotEnd stay as they are and can be copied without the lock.
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+
+        VerifyOrReturnError(mFd != -1, CHIP_ERROR_INCORRECT_STATE);
+
+        records.reserve(mIndex.size());
+        for (const auto & entry : mIndex)
+        {
+            records.push_back({ entry.second.recordOffset, 0, kHeaderLength + entry.first.size() + entry.second.valueLength });
+        }
+        path        = mPath;
+        snapshotEnd = mFileSize;
+        sourceFd    = dup(mFd);
+    }
+
+    if (sourceFd == -1)
+    {
+        ChipLogError(DeviceLayer, "failed to open (%s), %s (%d)", path.c_str(), strerror(errno), errno);
+        return CHIP_ERROR_OPEN_FAILED;
+    }
+
+    tmpPath = path + ".compact";
+    int fd  = open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd == -1)
+    {
+        ChipLogError(DeviceLayer, "failed to open (%s), %s (%d)", tmpPath.c_str(), strerror(errno), errno);
+        close(sourceFd);
+        return CHIP_ERROR_OPEN_FAILED;
+    }
+
+    // Records are copied as they are, CRC included, in the order of the old file.
+    std::sort(records.begin(), records.end(), [](const MovedRecord & a, const MovedRecord & b) { return a.from < b.from; });
+
+    std::string buffer;
+    size_t size = 0;
+    bool ok     = true;
+
+    buffer.reserve(kCompactionBufferSize);
+    buffer.append(reinterpret_cast<const char *>(kMagic), sizeof(kMagic));
+
+    for (auto & record : records)
+    {
+        record.to = size + buffer.size();
+        ok        = ReadAll(sourceFd, record.from, record.length, buffer);
+
+        if (ok && buffer.size() >= kCompactionBufferSize)
+        {
+            ok = WriteAll(fd, buffer);
+            size += buffer.size();
+            buffer.clear();
+        }
+        if (!ok)
+        {
+            break;
+        }
+    }
+    ok = ok && WriteAll(fd, buffer);
+    size += buffer.size();
+
+    // Catch up with the records appended in the meantime, so that few are left to copy under the lock.
+    size_t copiedEnd = snapshotEnd;
+    size_t end       = GetFileSize();
+    ok               = ok && CopyRange(sourceFd, copiedEnd, end, fd, size) && fsync(fd) == 0;
+    copiedEnd        = end;
+
+    std::lock_guard<std::mutex> lock(mLock);
+
+    ok = ok && mFd != -1 && CopyRange(sourceFd, copiedEnd, mFileSize, fd, size) && fdatasync(fd) == 0 &&
+        rename(tmpPath.c_str(), mPath.c_str()) == 0;
+    close(sourceFd);
+
+    if (!ok)
+    {
+        ChipLogError(DeviceLayer, "failed to compact (%s), %s (%d)", path.c_str(), strerror(errno), errno);
+        close(fd);
+        unlink(tmpPath.c_str());
+        return CHIP_ERROR_WRITE_FAILED;
+    }
+
+    // Before the next append to the new file.
+    SyncDirectory(mPath);
+
+    ChipLogProgress(DeviceLayer, "compacted (%s) from %u to %u bytes", mPath.c_str(), static_cast<unsigned>(mFileSize),
+                    static_cast<unsigned>(size));
+
+    // The records appended since the snapshot follow the copied ones, in the same order.
+    const size_t tailStart = size - (mFileSize - snapshotEnd);
+    size_t liveBytes       = 0;
+    for (auto & entry : mIndex)
+    {
+        size_t & offset = entry.second.recordOffset;
+        if (offset >= snapshotEnd)
+        {
+            offset = tailStart + (offset - snapshotEnd);
+        }
+        else
+        {
+            // Every record before snapshotEnd that is still live was in the snapshot.
+            offset = std::lower_bound(records.begin(), records.end(), offset,
+                                      [](const MovedRecord & record, size_t from) { return record.from < from; })
+                         ->to;
+        }
+        liveBytes += kHeaderLength + entry.first.size() + entry.second.valueLength;
+    }
+
+    munmap(const_cast<uint8_t *>(mMap), mMapSize);
+    close(mFd);
+    mMap     = nullptr;
+    mMapSize = 0;
+    mFd      = fd;
+
+    mFileSize  = size;
+    mDeadBytes = size - sizeof(kMagic) - liveBytes;
+
+    return Map(mFileSize);
+}
+
+size_t KeyValueStoreLog::GetFileSize()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    return mFileSize;
+}
+
+size_t KeyValueStoreLog::GetDeadBytes()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    return mDeadBytes;
+}
+
+CHIP_ERROR KeyValueStoreLog::Load()
+{
+    struct stat info;
+
+    VerifyOrReturnError(fstat(mFd, &info) == 0, CHIP_ERROR_OPEN_FAILED);
+    size_t size = static_cast<size_t>(info.st_size);
+
+    if (size == 0)
+    {
+        VerifyOrReturnError(pwrite(mFd, kMagic, sizeof(kMagic), 0) == static_cast<ssize_t>(sizeof(kMagic)) && fdatasync(mFd) == 0,
+                            CHIP_ERROR_WRITE_FAILED);
+        size = sizeof(kMagic);
+    }
+
+    ReturnErrorOnFailure(Map(size));
+    VerifyOrReturnError(size >= sizeof(kMagic) && memcmp(mMap, kMagic, sizeof(kMagic)) == 0, CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+
+    size_t offset  = sizeof(kMagic);
+    size_t records = 0;
+
+    while (size - offset >= kHeaderLength)
+    {
+        const uint8_t * record = mMap + offset;
+        uint32_t valueLength   = Encoding::LittleEndian::Get32(&record[4]);
+        uint16_t keyLength     = Encoding::LittleEndian::Get16(&record[8]);
+        uint8_t type           = record[10];
+        size_t available       = size - offset - kHeaderLength;
+
+        // A record cut short by a crash ends the log.
+        if (keyLength > available || valueLength > available - keyLength)
+        {
+            break;
+        }
+
+        size_t recordLength = kHeaderLength + keyLength + valueLength;
+        if (Encoding::LittleEndian::Get32(record) != Crc32(0, &record[4], recordLength - 4) ||
+            (type != kRecordPut && type != kRecordDelete))
+        {
+            break;
+        }
+
+        std::string key(reinterpret_cast<const char *>(&record[kHeaderLength]), keyLength);
+        auto entry = mIndex.find(key);
+        if (entry != mIndex.end())
+        {
+            Forget(entry);
+        }
+
+        if (type == kRecordPut)
+        {
+            mIndex.emplace(std::move(key), IndexEntry{ offset, valueLength });
+        }
+        else
+        {
+            mDeadBytes += recordLength;
+        }
+
+        offset += recordLength;
+        records++;
+    }
+
+    if (offset < size)
+    {
+        ChipLogError(DeviceLayer, "dropping %u bytes of incomplete records from (%s)", static_cast<unsigned>(size - offset),
+                     mPath.c_str());
+        VerifyOrReturnError(ftruncate(mFd, static_cast<off_t>(offset)) == 0, CHIP_ERROR_WRITE_FAILED);
+    }
+
+    ChipLogProgress(DeviceLayer, "loaded %u records, %u keys from (%s)", static_cast<unsigned>(records),
+                    static_cast<unsigned>(mIndex.size()), mPath.c_str());
+
+    mFileSize = offset;
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR KeyValueStoreLog::Map(size_t size)
+{
+    VerifyOrReturnError(size > mMapSize, CHIP_NO_ERROR);
+
+    size_t mapSize = kMinMapSize;
+    while (mapSize < size)
+    {
+        mapSize *= 2;
+    }
+
+    // Only the part of the mapping before the end of the file is ever read.
+    void * map;
+    if (mMap == nullptr)
+    {
+        map = mmap(nullptr, mapSize, PROT_READ, MAP_SHARED, mFd, 0);
+    }
+    else
+    {
+        map = mremap(const_cast<uint8_t *>(mMap), mMapSize, mapSize, MREMAP_MAYMOVE);
+    }
+
+    if (map == MAP_FAILED)
+    {
+        ChipLogError(DeviceLayer, "failed to map (%s), %s (%d)", mPath.c_str(), strerror(errno), errno);
+        return CHIP_ERROR_NO_MEMORY;
+    }
+
+    mMap     = static_cast<const uint8_t *>(map);
+    mMapSize = mapSize;
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR KeyValueStoreLog::Append(uint8_t type, const std::string & key, const void * value, size_t value_size)
+{
+    VerifyOrReturnError(mFd != -1, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(key.size() <= UINT16_MAX && value_size <= UINT32_MAX, CHIP_ERROR_INVALID_ARGUMENT);
+
+    size_t recordLength = kHeaderLength + key.size() + value_size;
+    ReturnErrorOnFailure(Map(mFileSize + recordLength));
+
+    uint8_t header[kHeaderLength];
+    Encoding::LittleEndian::Put32(&header[4], static_cast<uint32_t>(value_size));
+    Encoding::LittleEndian::Put16(&header[8], static_cast<uint16_t>(key.size()));
+    header[10] = type;
+    header[11] = 0;
+
+    uint32_t crc = Crc32(0, &header[4], kHeaderLength - 4);
+    crc          = Crc32(crc, key.data(), key.size());
+    crc          = Crc32(crc, value, value_size);
+    Encoding::LittleEndian::Put32(&header[0], crc);
+
+    struct iovec iov[3] = {
+        { header, kHeaderLength },
+        { const_cast<char *>(key.data()), key.size() },
+        { const_cast<void *>(value), value_size },
+    };
+
+    ssize_t written = pwritev(mFd, iov, 3, static_cast<off_t>(mFileSize));
+    if (written != static_cast<ssize_t>(recordLength) || fdatasync(mFd) != 0)
+    {
+        ChipLogError(DeviceLayer, "failed to write (%s), %s (%d)", mPath.c_str(), strerror(errno), errno);
+
+        // Drop any partial record, so that records appended later are not hidden behind it.
+        if (ftruncate(mFd, static_cast<off_t>(mFileSize)) != 0)
+        {
+            ChipLogError(DeviceLayer, "failed to truncate (%s)", mPath.c_str());
+        }
+        return CHIP_ERROR_WRITE_FAILED;
+    }
+
+    mFileSize += recordLength;
+
+    return CHIP_NO_ERROR;
+}
+
+void KeyValueStoreLog::Forget(Index::iterator entry)
+{
+    mDeadBytes += kHeaderLength + entry->first.size() + entry->second.valueLength;
+    mIndex.erase(entry);
+}
+
+bool KeyValueStoreLog::ShouldCompact() const
+{
+    // Waiting for most of the file to be dead keeps the cost of compaction in proportion to the number of writes.
+    return mDeadBytes > CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_COMPACT_SIZE && mDeadBytes > mFileSize - mDeadBytes;
+}
+
+void KeyValueStoreLog::CompactionThread()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+
+    while (!mStopCompaction)
+    {
+        if (ShouldCompact())
+        {
+            // Compact() takes the lock itself, only to copy the index and to swap the files.
+            lock.unlock();
+            Compact();
+            lock.lock();
+        }
+        if (!mStopCompaction)
+        {
+            mCompactionCondition.wait(lock);
+        }
+    }
+}
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
@@ -0,0 +1,127 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *         This file defines a log-structured key-value store for Linux, an
+ *         alternative to ChipLinuxStorage for KeyValueStoreManagerImpl.
+ *
+ *         Values are kept in a binary file of records that is only ever
+ *         appended to, and read through a memory mapping of that file. An
+ *         in-memory hash index maps each key to its latest record, and is
+ *         rebuilt by reading the records once at startup. Every record carries
+ *         a CRC, so a record cut short by a crash ends the log. Once most of
+ *         the file is taken by overwritten or deleted values, a background
+ *         thread copies the live records to a new file.
+ *
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include <lib/core/CHIPError.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+class KeyValueStoreLog
+{
+public:
+    KeyValueStoreLog() = default;
+    ~KeyValueStoreLog();
+
+    KeyValueStoreLog(const KeyValueStoreLog &) = delete;
+    KeyValueStoreLog & operator=(const KeyValueStoreLog &) = delete;
+
+    /**
+     * Open the log at the given path, creating it if needed, and index its records.
+     */
+    CHIP_ERROR Init(const char * file);
+
+    /**
+     * Close the log. Called by the destructor.
+     */
+    void Shutdown();
+
+    // These follow the semantics of the KeyValueStoreManager methods of the same name.
+    CHIP_ERROR Get(const char * key, void * value, size_t value_size, size_t * read_bytes_size = nullptr, size_t offset = 0);
+    CHIP_ERROR Put(const char * key, const void * value, size_t value_size);
+    CHIP_ERROR Delete(const char * key);
+
+    /**
+     * Copy the live records to a new file now, rather than waiting for the background thread.
+     *
+     * Gets, Puts and Deletes only wait for the index to be copied and for the files to be swapped, not for the records to be
+     * written out.
+     */
+    CHIP_ERROR Compact();
+
+    /**
+     * Size of the log file, and the part of it taken by overwritten and deleted values.
+     */
+    size_t GetFileSize();
+    size_t GetDeadBytes();
+
+private:
+    struct IndexEntry
+    {
+        size_t recordOffset;
+        uint32_t valueLength;
+    };
+
+    using Index = std::unordered_map<std::string, IndexEntry>;
+
+    // A live record copied by a compaction, from its offset in the old file to its offset in the new one.
+    struct MovedRecord
+    {
+        size_t from;
+        size_t to;
+        size_t length;
+    };
+
+    CHIP_ERROR Load();
+    CHIP_ERROR Map(size_t size);
+    CHIP_ERROR Append(uint8_t type, const std::string & key, const void * value, size_t value_size);
+    void Forget(Index::iterator entry);
+    bool ShouldCompact() const;
+    void CompactionThread();
+
+    std::mutex mLock;
+    std::mutex mCompactionLock; // Held for the whole of a compaction, so compactions run one at a time
+    std::string mPath;
+    int mFd              = -1;
+    const uint8_t * mMap = nullptr;
+    size_t mMapSize      = 0; // Length of the mapping, which may extend past the end of the file
+    size_t mFileSize     = 0; // End of the last valid record
+    size_t mDeadBytes    = 0;
+    Index mIndex;
+
+    bool mStopCompaction = false;
+    std::condition_variable mCompactionCondition;
+    std::thread mCompactionThread;
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
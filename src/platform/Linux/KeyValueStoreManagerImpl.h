@@ -23,7 +23,9 @@
 
 #pragma once
 
+#include <platform/CHIPDeviceConfig.h>
 #include <platform/Linux/CHIPLinuxStorage.h>
+#include <platform/Linux/KeyValueStoreLog.h>
 
 namespace chip {
 namespace DeviceLayer {
@@ -38,12 +40,30 @@ public:
      */
     CHIP_ERROR Init(const char * file) { return mStorage.Init(file); }
 
+#if !CHIP_DEVICE_CONFIG_LINUX_KVS_LOG
+    /**
+     * @brief
+     * Set how long writes may be held back to be written together, see ChipLinuxStorage::SetWriteBackWindow().
+     */
+    CHIP_ERROR SetWriteBackWindow(System::Clock::Milliseconds32 window) { return mStorage.SetWriteBackWindow(window); }
+
+    /**
+     * @brief
+     * Make all writes durable now, whatever the write-back window.
+     */
+    CHIP_ERROR Flush() { return mStorage.Flush(); }
+#endif // !CHIP_DEVICE_CONFIG_LINUX_KVS_LOG
+
     CHIP_ERROR _Get(const char * key, void * value, size_t value_size, size_t * read_bytes_size = nullptr, size_t offset = 0);
     CHIP_ERROR _Delete(const char * key);
     CHIP_ERROR _Put(const char * key, const void * value, size_t value_size);
 
 private:
+#if CHIP_DEVICE_CONFIG_LINUX_KVS_LOG
+    DeviceLayer::Internal::KeyValueStoreLog mStorage;
+#else
     DeviceLayer::Internal::ChipLinuxStorage mStorage;
+#endif
 
     // ===== Members for internal use by the following friends.
     friend KeyValueStoreManager & KeyValueStoreMgr();
@@ -26,9 +26,11 @@
 
 #include <app-common/zap-generated/enums.h>
 #include <app-common/zap-generated/ids/Events.h>
+#include <crypto/CryptoBuildConfig.h>
 #include <lib/support/CHIPMem.h>
 #include <lib/support/logging/CHIPLogging.h>
 #include <platform/DeviceControlServer.h>
+#include <platform/Linux/CryptoWorkerPool.h>
 #include <platform/Linux/DiagnosticDataProviderImpl.h>
 #include <platform/PlatformManager.h>
 #include <platform/internal/GenericPlatformManagerImpl_POSIX.cpp>
@@ -245,6 +247,14 @@ CHIP_ERROR PlatformManagerImpl::_InitChipStack()
     err = Internal::GenericPlatformManagerImpl_POSIX<PlatformManagerImpl>::_InitChipStack();
     SuccessOrExit(err);
 
+    // The mbedTLS PAL draws all of its randomness from one DRBG without a lock, so only the OpenSSL PAL
+    // may run crypto operations on several threads at once.
+#if CHIP_DEVICE_CONFIG_LINUX_CRYPTO_WORKER_THREADS > 0 && CHIP_CRYPTO_OPENSSL
+    err = Internal::CryptoWorkerPool::Instance().Init(CHIP_DEVICE_CONFIG_LINUX_CRYPTO_WORKER_THREADS);
+    SuccessOrExit(err);
+    Crypto::SetCryptoJobQueue(&Internal::CryptoWorkerPool::Instance());
+#endif
+
     mStartTime = System::SystemClock().GetMonotonicTimestamp();
 
 exit:
@@ -273,6 +283,11 @@ CHIP_ERROR PlatformManagerImpl::_Shutdown()
         ChipLogError(DeviceLayer, "Failed to get current uptime since the Node’s last reboot");
     }
 
+#if CHIP_DEVICE_CONFIG_LINUX_CRYPTO_WORKER_THREADS > 0 && CHIP_CRYPTO_OPENSSL
+    Crypto::SetCryptoJobQueue(nullptr);
+    Internal::CryptoWorkerPool::Instance().Shutdown();
+#endif
+
     return Internal::GenericPlatformManagerImpl_POSIX<PlatformManagerImpl>::_Shutdown();
 }
 
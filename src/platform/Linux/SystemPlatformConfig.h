@@ -46,4 +46,11 @@ struct ChipDeviceEvent;
 #define CHIP_SYSTEM_CONFIG_NUM_TIMERS 16
 #endif // CHIP_SYSTEM_CONFIG_NUM_TIMERS
 
-#define CHIP_CONFIG_MDNS_CACHE_SIZE 4
+#ifndef CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL
+#define CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL 1
+#endif // CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
+// Large enough for a controller to keep every node of a small fabric resolved.
+#ifndef CHIP_CONFIG_MDNS_CACHE_SIZE
+#define CHIP_CONFIG_MDNS_CACHE_SIZE 64
+#endif // CHIP_CONFIG_MDNS_CACHE_SIZE
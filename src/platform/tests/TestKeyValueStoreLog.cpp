@@ -0,0 +1,389 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests for the Linux log-structured key-value
+ *      store, and a benchmark comparing it with the INI file backend.
+ *
+ */
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <nlunit-test.h>
+#include <platform/Linux/CHIPLinuxStorage.h>
+#include <platform/Linux/KeyValueStoreLog.h>
+#include <system/SystemClock.h>
+
+using namespace chip;
+using namespace chip::DeviceLayer::Internal;
+
+namespace {
+
+std::string MakePath()
+{
+    char path[] = "/tmp/chip_kvs_log_test-XXXXXX";
+    int fd      = mkstemp(path);
+    if (fd != -1)
+    {
+        close(fd);
+        unlink(path);
+    }
+    return path;
+}
+
+size_t FileSize(const std::string & path)
+{
+    struct stat info;
+    return (stat(path.c_str(), &info) == 0) ? static_cast<size_t>(info.st_size) : 0;
+}
+
+void FormatKey(char (&key)[32], uint32_t index)
+{
+    snprintf(key, sizeof(key), "f/1/s/%08" PRIX32, index);
+}
+
+void FormatValue(uint8_t (&value)[64], uint32_t index)
+{
+    for (size_t i = 0; i < sizeof(value); i++)
+    {
+        value[i] = static_cast<uint8_t>(index * 7 + i);
+    }
+}
+
+void TestPutGetDelete(nlTestSuite * inSuite, void * inContext)
+{
+    std::string path = MakePath();
+    KeyValueStoreLog store;
+    uint8_t buf[16];
+    size_t len = 0;
+
+    NL_TEST_ASSERT(inSuite, store.Init(path.c_str()) == CHIP_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, store.Get("a", buf, sizeof(buf), &len) == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+    NL_TEST_ASSERT(inSuite, store.Put("a", "0123456789", 10) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, store.Put("empty", nullptr, 0) == CHIP_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, store.Get("a", buf, sizeof(buf), &len) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, len == 10 && memcmp(buf, "0123456789", 10) == 0);
+    NL_TEST_ASSERT(inSuite, store.Get("empty", buf, sizeof(buf), &len) == CHIP_NO_ERROR && len == 0);
+
+    // Partial and offset reads
+    NL_TEST_ASSERT(inSuite, store.Get("a", buf, 4, &len) == CHIP_ERROR_BUFFER_TOO_SMALL);
+    NL_TEST_ASSERT(inSuite, len == 4 && memcmp(buf, "0123", 4) == 0);
+    NL_TEST_ASSERT(inSuite, store.Get("a", buf, sizeof(buf), &len, 6) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, len == 4 && memcmp(buf, "6789", 4) == 0);
+    NL_TEST_ASSERT(inSuite, store.Get("a", buf, sizeof(buf), &len, 11) == CHIP_ERROR_INVALID_ARGUMENT);
+
+    // Overwrite
+    NL_TEST_ASSERT(inSuite, store.Put("a", "xyz", 3) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, store.Get("a", buf, sizeof(buf), &len) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, len == 3 && memcmp(buf, "xyz", 3) == 0);
+    NL_TEST_ASSERT(inSuite, store.GetDeadBytes() > 0);
+
+    // Delete
+    NL_TEST_ASSERT(inSuite, store.Delete("a") == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, store.Delete("a") == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+    NL_TEST_ASSERT(inSuite, store.Get("a", buf, sizeof(buf), &len) == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+
+    // Everything survives a restart
+    NL_TEST_ASSERT(inSuite, store.Put("b", "bee", 3) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, store.Init(path.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, store.Get("a", buf, sizeof(buf), &len) == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+    NL_TEST_ASSERT(inSuite, store.Get("b", buf, sizeof(buf), &len) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, len == 3 && memcmp(buf, "bee", 3) == 0);
+    NL_TEST_ASSERT(inSuite, store.Get("empty", buf, sizeof(buf), &len) == CHIP_NO_ERROR && len == 0);
+
+    store.Shutdown();
+    unlink(path.c_str());
+}
+
+void TestDamagedLog(nlTestSuite * inSuite, void * inContext)
+{
+    std::string path = MakePath();
+    KeyValueStoreLog store;
+    uint8_t buf[16];
+    size_t len = 0;
+
+    NL_TEST_ASSERT(inSuite, store.Init(path.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, store.Put("k", "old", 3) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, store.Put("k", "new", 3) == CHIP_NO_ERROR);
+    size_t size = store.GetFileSize();
+    store.Shutdown();
+
+    // A record cut short by a crash is dropped
+    int fd = open(path.c_str(), O_WRONLY | O_APPEND);
+    NL_TEST_ASSERT(inSuite, fd != -1);
+    NL_TEST_ASSERT(inSuite, write(fd, "\x12\x34\x56\x78\x20\x00", 6) == 6);
+    close(fd);
+
+    NL_TEST_ASSERT(inSuite, store.Init(path.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, store.GetFileSize() == size && FileSize(path) == size);
+    NL_TEST_ASSERT(inSuite, store.Get("k", buf, sizeof(buf), &len) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, len == 3 && memcmp(buf, "new", 3) == 0);
+    store.Shutdown();
+
+    // So is one that fails its CRC, which brings the previous value back
+    fd = open(path.c_str(), O_WRONLY);
+    NL_TEST_ASSERT(inSuite, fd != -1);
+    NL_TEST_ASSERT(inSuite, pwrite(fd, "N", 1, static_cast<off_t>(size - 3)) == 1);
+    close(fd);
+
+    NL_TEST_ASSERT(inSuite, store.Init(path.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, store.GetFileSize() < size);
+    NL_TEST_ASSERT(inSuite, store.Get("k", buf, sizeof(buf), &len) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, len == 3 && memcmp(buf, "old", 3) == 0);
+
+    // New records go where the damaged one was
+    NL_TEST_ASSERT(inSuite, store.Put("k", "fix", 3) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, store.Init(path.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, store.Get("k", buf, sizeof(buf), &len) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, len == 3 && memcmp(buf, "fix", 3) == 0);
+
+    // A file that is not a log is not touched
+    store.Shutdown();
+    fd = open(path.c_str(), O_WRONLY);
+    NL_TEST_ASSERT(inSuite, pwrite(fd, "[DEFAULT]", 9, 0) == 9);
+    close(fd);
+    NL_TEST_ASSERT(inSuite, store.Init(path.c_str()) == CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+
+    unlink(path.c_str());
+}
+
+void TestCompaction(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr uint32_t kKeyCount     = 100;
+    constexpr uint32_t kRewriteCount = 20;
+
+    std::string path = MakePath();
+    KeyValueStoreLog store;
+    uint8_t expected[64];
+    uint8_t value[64];
+    char key[32];
+    size_t len = 0;
+
+    NL_TEST_ASSERT(inSuite, store.Init(path.c_str()) == CHIP_NO_ERROR);
+    for (uint32_t round = 0; round < kRewriteCount; round++)
+    {
+        for (uint32_t i = 0; i < kKeyCount; i++)
+        {
+            FormatKey(key, i);
+            FormatValue(value, i + round);
+            NL_TEST_ASSERT(inSuite, store.Put(key, value, sizeof(value)) == CHIP_NO_ERROR);
+        }
+    }
+    for (uint32_t i = 0; i < kKeyCount; i += 2)
+    {
+        FormatKey(key, i);
+        NL_TEST_ASSERT(inSuite, store.Delete(key) == CHIP_NO_ERROR);
+    }
+
+    NL_TEST_ASSERT(inSuite, store.Compact() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, store.GetDeadBytes() == 0);
+    NL_TEST_ASSERT(inSuite, store.GetFileSize() == FileSize(path));
+    NL_TEST_ASSERT(inSuite, store.GetFileSize() < (kKeyCount / 2) * (sizeof(value) + sizeof(key) + 12) + 8);
+
+    // The values are the same, before and after a restart
+    for (int pass = 0; pass < 2; pass++)
+    {
+        uint32_t matched = 0;
+        for (uint32_t i = 0; i < kKeyCount; i++)
+        {
+            FormatKey(key, i);
+            FormatValue(expected, i + kRewriteCount - 1);
+            CHIP_ERROR err = store.Get(key, value, sizeof(value), &len);
+            if ((i % 2 == 0 && err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND) ||
+                (i % 2 == 1 && err == CHIP_NO_ERROR && len == sizeof(value) && memcmp(value, expected, sizeof(value)) == 0))
+            {
+                matched++;
+            }
+        }
+        NL_TEST_ASSERT(inSuite, matched == kKeyCount);
+        NL_TEST_ASSERT(inSuite, store.Init(path.c_str()) == CHIP_NO_ERROR);
+    }
+
+    store.Shutdown();
+    unlink(path.c_str());
+}
+
+uint64_t Now()
+{
+    return System::SystemClock().GetMonotonicMicroseconds64().count();
+}
+
+/**
+ * Measures Put, Get and Delete latency, and the time taken to load a store of kKeyCount keys, of the log-structured store
+ * and of the INI file store, used the way KeyValueStoreManagerImpl uses them.
+ */
+void BenchmarkBackends(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr uint32_t kKeyCount = 1000;
+
+    std::string logPath = MakePath();
+    std::string iniPath = MakePath();
+    uint8_t expected[64];
+    uint8_t value[64];
+    char key[32];
+    size_t len = 0;
+    uint32_t matched[2] = { 0, 0 };
+    uint64_t start;
+    uint64_t put[2], get[2], load[2], del[2];
+
+    // Log
+    {
+        KeyValueStoreLog store;
+        NL_TEST_ASSERT(inSuite, store.Init(logPath.c_str()) == CHIP_NO_ERROR);
+
+        start = Now();
+        for (uint32_t i = 0; i < kKeyCount; i++)
+        {
+            FormatKey(key, i);
+            FormatValue(value, i);
+            NL_TEST_ASSERT(inSuite, store.Put(key, value, sizeof(value)) == CHIP_NO_ERROR);
+        }
+        put[0] = Now() - start;
+
+        start = Now();
+        NL_TEST_ASSERT(inSuite, store.Init(logPath.c_str()) == CHIP_NO_ERROR);
+        load[0] = Now() - start;
+
+        start = Now();
+        for (uint32_t i = 0; i < kKeyCount; i++)
+        {
+            FormatKey(key, i);
+            FormatValue(expected, i);
+            if (store.Get(key, value, sizeof(value), &len) == CHIP_NO_ERROR && memcmp(value, expected, sizeof(value)) == 0)
+            {
+                matched[0]++;
+            }
+        }
+        get[0] = Now() - start;
+
+        start = Now();
+        for (uint32_t i = 0; i < kKeyCount; i++)
+        {
+            FormatKey(key, i);
+            NL_TEST_ASSERT(inSuite, store.Delete(key) == CHIP_NO_ERROR);
+        }
+        del[0] = Now() - start;
+    }
+
+    // INI, committed after every change as KeyValueStoreManagerImpl does
+    {
+        ChipLinuxStorage store;
+        NL_TEST_ASSERT(inSuite, store.Init(iniPath.c_str()) == CHIP_NO_ERROR);
+
+        start = Now();
+        for (uint32_t i = 0; i < kKeyCount; i++)
+        {
+            FormatKey(key, i);
+            FormatValue(value, i);
+            NL_TEST_ASSERT(inSuite, store.WriteValueBin(key, value, sizeof(value)) == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(inSuite, store.Commit() == CHIP_NO_ERROR);
+        }
+        put[1] = Now() - start;
+    }
+    {
+        ChipLinuxStorage store;
+
+        start = Now();
+        NL_TEST_ASSERT(inSuite, store.Init(iniPath.c_str()) == CHIP_NO_ERROR);
+        load[1] = Now() - start;
+
+        start = Now();
+        for (uint32_t i = 0; i < kKeyCount; i++)
+        {
+            FormatKey(key, i);
+            FormatValue(expected, i);
+            // KeyValueStoreManagerImpl reads once for the size, then again for the value
+            store.ReadValueBin(key, nullptr, 0, len);
+            if (store.ReadValueBin(key, value, sizeof(value), len) == CHIP_NO_ERROR && memcmp(value, expected, sizeof(value)) == 0)
+            {
+                matched[1]++;
+            }
+        }
+        get[1] = Now() - start;
+
+        start = Now();
+        for (uint32_t i = 0; i < kKeyCount; i++)
+        {
+            FormatKey(key, i);
+            NL_TEST_ASSERT(inSuite, store.ClearValue(key) == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(inSuite, store.Commit() == CHIP_NO_ERROR);
+        }
+        del[1] = Now() - start;
+    }
+
+    const char * names[2] = { "log", "ini" };
+    for (int i = 0; i < 2; i++)
+    {
+        ChipLogProgress(DeviceLayer,
+                        "%s: %" PRIu32 " keys, put %" PRIu64 "us/key, get %" PRIu64 "us/key, delete %" PRIu64
+                        "us/key, load %" PRIu64 "us",
+                        names[i], kKeyCount, put[i] / kKeyCount, get[i] / kKeyCount, del[i] / kKeyCount, load[i]);
+    }
+
+    NL_TEST_ASSERT(inSuite, matched[0] == kKeyCount);
+    NL_TEST_ASSERT(inSuite, matched[1] == kKeyCount);
+
+    unlink(logPath.c_str());
+    unlink(iniPath.c_str());
+}
+
+int TestSetup(void * inContext)
+{
+    VerifyOrReturnError(CHIP_NO_ERROR == chip::Platform::MemoryInit(), FAILURE);
+    return SUCCESS;
+}
+
+int TestTeardown(void * inContext)
+{
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("Test put, get and delete", TestPutGetDelete),
+    NL_TEST_DEF("Test damaged log", TestDamagedLog),
+    NL_TEST_DEF("Test compaction", TestCompaction),
+    NL_TEST_DEF("Benchmark backends", BenchmarkBackends),
+    NL_TEST_SENTINEL(),
+};
+
+} // namespace
+
+int TestKeyValueStoreLog()
+{
+    nlTestSuite theSuite = { "KeyValueStoreLog tests", &sTests[0], TestSetup, TestTeardown };
+
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestKeyValueStoreLog)
@@ -0,0 +1,252 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests and a write benchmark for the
+ *      write-back mode of ChipLinuxStorage.
+ *
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <nlunit-test.h>
+#include <platform/Linux/CHIPLinuxStorage.h>
+#include <system/SystemClock.h>
+
+using namespace chip;
+using namespace chip::DeviceLayer::Internal;
+using namespace chip::System::Clock::Literals;
+
+namespace {
+
+constexpr System::Clock::Milliseconds32 kWriteBackWindow = 50_ms32;
+
+std::string MakeConfigPath()
+{
+    char path[] = "/tmp/chip_storage_test-XXXXXX";
+    int fd      = mkstemp(path);
+    if (fd != -1)
+    {
+        close(fd);
+        unlink(path);
+    }
+    return path;
+}
+
+void RemoveConfig(const std::string & path)
+{
+    unlink(path.c_str());
+    unlink((path + ".journal").c_str());
+}
+
+std::string ReadFile(const std::string & path)
+{
+    std::ifstream ifs(path, std::ifstream::in | std::ifstream::binary);
+    return std::string((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+}
+
+void FormatKey(char (&key)[32], uint32_t index)
+{
+    snprintf(key, sizeof(key), "g/key-%" PRIu32, index);
+}
+
+void FormatValue(uint8_t (&value)[32], uint32_t index)
+{
+    for (size_t i = 0; i < sizeof(value); i++)
+    {
+        value[i] = static_cast<uint8_t>(index + i);
+    }
+}
+
+void TestWriteBackJournal(nlTestSuite * inSuite, void * inContext)
+{
+    std::string path = MakeConfigPath();
+    uint32_t value   = 0;
+
+    ChipLinuxStorage writer;
+    NL_TEST_ASSERT(inSuite, writer.Init(path.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.SetWriteBackWindow(kWriteBackWindow) == CHIP_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, writer.WriteValue("kept", static_cast<uint32_t>(1)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.WriteValue("removed", static_cast<uint32_t>(2)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.WriteValueStr("spaced", "a value with spaces") == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.ClearValue("removed") == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.Commit() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.Flush() == CHIP_NO_ERROR);
+
+    // The changes are in the journal, not in the configuration file
+    NL_TEST_ASSERT(inSuite, ReadFile(path).find("kept") == std::string::npos);
+    NL_TEST_ASSERT(inSuite, ReadFile(path + ".journal").find("kept") != std::string::npos);
+
+    // Simulate a crash in the middle of writing a record
+    {
+        std::ofstream ofs(path + ".journal", std::ofstream::out | std::ofstream::app | std::ofstream::binary);
+        ofs << "S 4 10 torn123";
+    }
+
+    // Loading the configuration replays the journal and folds it into the configuration file
+    {
+        ChipLinuxStorage reader;
+        char buf[32];
+        size_t len = 0;
+
+        NL_TEST_ASSERT(inSuite, reader.Init(path.c_str()) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, reader.ReadValue("kept", value) == CHIP_NO_ERROR && value == 1);
+        NL_TEST_ASSERT(inSuite, !reader.HasValue("removed"));
+        NL_TEST_ASSERT(inSuite, !reader.HasValue("torn"));
+        NL_TEST_ASSERT(inSuite, reader.ReadValueStr("spaced", buf, sizeof(buf), len) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, strcmp(buf, "a value with spaces") == 0);
+        NL_TEST_ASSERT(inSuite, ReadFile(path).find("kept") != std::string::npos);
+        NL_TEST_ASSERT(inSuite, access((path + ".journal").c_str(), F_OK) != 0);
+    }
+
+    // Clearing everything is journaled too
+    NL_TEST_ASSERT(inSuite, writer.ClearAll() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.WriteValue("after", static_cast<uint32_t>(3)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.Commit() == CHIP_NO_ERROR);
+
+    // Leaving write-back mode writes the configuration file
+    NL_TEST_ASSERT(inSuite, writer.SetWriteBackWindow(System::Clock::kZero) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, access((path + ".journal").c_str(), F_OK) != 0);
+    {
+        ChipLinuxStorage reader;
+
+        NL_TEST_ASSERT(inSuite, reader.Init(path.c_str()) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, !reader.HasValue("kept"));
+        NL_TEST_ASSERT(inSuite, reader.ReadValue("after", value) == CHIP_NO_ERROR && value == 3);
+    }
+
+    RemoveConfig(path);
+}
+
+uint64_t WriteKeys(nlTestSuite * inSuite, const std::string & path, uint32_t count, System::Clock::Milliseconds32 window,
+                   uint64_t & longestWrite)
+{
+    ChipLinuxStorage storage;
+    uint8_t value[32];
+    char key[32];
+
+    NL_TEST_ASSERT(inSuite, storage.Init(path.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, storage.SetWriteBackWindow(window) == CHIP_NO_ERROR);
+
+    longestWrite                        = 0;
+    System::Clock::Microseconds64 start = System::SystemClock().GetMonotonicMicroseconds64();
+    for (uint32_t i = 0; i < count; i++)
+    {
+        FormatKey(key, i);
+        FormatValue(value, i);
+        // Commit every write, as PosixConfig and KeyValueStoreManagerImpl do
+        System::Clock::Microseconds64 writeStart = System::SystemClock().GetMonotonicMicroseconds64();
+        NL_TEST_ASSERT(inSuite, storage.WriteValueBin(key, value, sizeof(value)) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, storage.Commit() == CHIP_NO_ERROR);
+        longestWrite = std::max(longestWrite, (System::SystemClock().GetMonotonicMicroseconds64() - writeStart).count());
+    }
+    NL_TEST_ASSERT(inSuite, storage.Flush() == CHIP_NO_ERROR);
+    System::Clock::Microseconds64 elapsed = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+    return elapsed.count();
+}
+
+/**
+ * Writes 10k keys in write-back mode, and a smaller number in write-through mode (each write of which rewrites the whole
+ * file), and checks that all the keys can be read back. In write-back mode, the longest write shows whether the writes
+ * wait for the configuration file to be rewritten when the journal is compacted.
+ */
+void BenchmarkWrites(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr uint32_t kWriteBackCount    = 10000;
+    constexpr uint32_t kWriteThroughCount = 500;
+
+    std::string path = MakeConfigPath();
+
+    uint64_t longestWriteThrough;
+    uint64_t longestWriteBack;
+
+    uint64_t writeThroughTime = WriteKeys(inSuite, path, kWriteThroughCount, System::Clock::kZero, longestWriteThrough);
+    RemoveConfig(path);
+    uint64_t writeBackTime = WriteKeys(inSuite, path, kWriteBackCount, kWriteBackWindow, longestWriteBack);
+
+    ChipLogProgress(DeviceLayer, "write-through: %" PRIu32 " keys in %" PRIu64 "us (%" PRIu64 "us/key, longest %" PRIu64 "us)",
+                    kWriteThroughCount, writeThroughTime, writeThroughTime / kWriteThroughCount, longestWriteThrough);
+    ChipLogProgress(DeviceLayer, "write-back: %" PRIu32 " keys in %" PRIu64 "us (%" PRIu64 "us/key, longest %" PRIu64 "us)",
+                    kWriteBackCount, writeBackTime, writeBackTime / kWriteBackCount, longestWriteBack);
+
+    ChipLinuxStorage storage;
+    uint8_t expected[32];
+    uint8_t value[32];
+    char key[32];
+    size_t len    = 0;
+    uint32_t read = 0;
+
+    NL_TEST_ASSERT(inSuite, storage.Init(path.c_str()) == CHIP_NO_ERROR);
+    for (uint32_t i = 0; i < kWriteBackCount; i++)
+    {
+        FormatKey(key, i);
+        FormatValue(expected, i);
+        if (storage.ReadValueBin(key, value, sizeof(value), len) == CHIP_NO_ERROR && len == sizeof(value) &&
+            memcmp(value, expected, sizeof(value)) == 0)
+        {
+            read++;
+        }
+    }
+    NL_TEST_ASSERT(inSuite, read == kWriteBackCount);
+
+    RemoveConfig(path);
+}
+
+int TestSetup(void * inContext)
+{
+    VerifyOrReturnError(CHIP_NO_ERROR == chip::Platform::MemoryInit(), FAILURE);
+    return SUCCESS;
+}
+
+int TestTeardown(void * inContext)
+{
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("Test write-back journal", TestWriteBackJournal),
+    NL_TEST_DEF("Benchmark writes", BenchmarkWrites),
+    NL_TEST_SENTINEL(),
+};
+
+} // namespace
+
+int TestLinuxStorage()
+{
+    nlTestSuite theSuite = { "ChipLinuxStorage tests", &sTests[0], TestSetup, TestTeardown };
+
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestLinuxStorage)
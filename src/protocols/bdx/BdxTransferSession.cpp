@@ -59,6 +59,8 @@ void PrepareOutgoingMessageEvent(MessageType messageType, chip::bdx::TransferSes
 namespace chip {
 namespace bdx {
 
+constexpr uint16_t TransferSession::kMaxBlockSize;
+
 TransferSession::TransferSession()
 {
     mSuppportedXferOpts.ClearAll();
@@ -12,6 +12,7 @@
 #include <system/SystemPacketBuffer.h>
 #include <transport/raw/MessageHeader.h>
 
+#include <algorithm>
 #include <type_traits>
 
 namespace chip {
@@ -144,6 +145,14 @@ public:
         static OutputEvent QueryWithSkipEvent(TransferSkipData bytesToSkip);
     };
 
+    /**
+     * The largest block size that fits in a Block message: the application payload of a message is capped at kMaxAppMessageLen on
+     * every transport, TCP included, and has to fit in a single packet buffer along with the message footer. The block counter
+     * takes the rest of the payload.
+     */
+    static constexpr uint16_t kMaxBlockSize = static_cast<uint16_t>(
+        std::min<size_t>(kMaxAppMessageLen, System::PacketBuffer::kMaxSize - kMaxTagLen) - sizeof(uint32_t));
+
     /**
      * @brief
      *   Indicates the presence of pending output and includes any data for the caller to take action on.
@@ -0,0 +1,421 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <protocols/bdx/FileSender.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include <lib/support/CHIPMemString.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/TypeTraits.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <messaging/Flags.h>
+#include <protocols/Protocols.h>
+#include <protocols/bdx/BdxMessages.h>
+#include <protocols/secure_channel/Constants.h>
+#include <protocols/secure_channel/StatusReport.h>
+#include <system/SystemPacketBuffer.h>
+#include <transport/SessionManager.h>
+
+namespace chip {
+namespace bdx {
+
+constexpr size_t FileSender::kReadAheadSize;
+
+CHIP_ERROR MappedFile::Open(const char * path)
+{
+    VerifyOrReturnError(path != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    Close();
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    VerifyOrReturnError(fd >= 0, CHIP_ERROR_POSIX(errno));
+
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    struct stat info;
+    void * data = MAP_FAILED;
+
+    VerifyOrExit(fstat(fd, &info) == 0, err = CHIP_ERROR_POSIX(errno));
+    VerifyOrExit(info.st_size > 0, err = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(static_cast<uint64_t>(static_cast<size_t>(info.st_size)) == static_cast<uint64_t>(info.st_size),
+                 err = CHIP_ERROR_INVALID_ARGUMENT);
+
+    data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    VerifyOrExit(data != MAP_FAILED, err = CHIP_ERROR_POSIX(errno));
+
+    mData   = static_cast<uint8_t *>(data);
+    mSize   = static_cast<size_t>(info.st_size);
+    mDevice = static_cast<uint64_t>(info.st_dev);
+    mInode  = static_cast<uint64_t>(info.st_ino);
+
+    // Transfers go through the file in order, so let the kernel read ahead more and drop the pages behind sooner.
+    madvise(mData, mSize, MADV_SEQUENTIAL);
+
+exit:
+    close(fd);
+    return err;
+}
+
+void MappedFile::Close()
+{
+    VerifyOrReturn(mData != nullptr);
+
+    munmap(mData, mSize);
+    mData   = nullptr;
+    mSize   = 0;
+    mDevice = 0;
+    mInode  = 0;
+}
+
+bool MappedFile::HasChanged(const char * path) const
+{
+    struct stat info;
+    VerifyOrReturnError(mData != nullptr && path != nullptr && stat(path, &info) == 0, true);
+
+    return static_cast<uint64_t>(info.st_dev) != mDevice || static_cast<uint64_t>(info.st_ino) != mInode ||
+        static_cast<uint64_t>(info.st_size) != static_cast<uint64_t>(mSize);
+}
+
+void MappedFile::ReadAhead(size_t offset, size_t length) const
+{
+    VerifyOrReturn(mData != nullptr && offset < mSize);
+
+    // madvise only takes page aligned addresses
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t start    = offset - offset % pageSize;
+    const size_t end      = std::min(mSize, offset + length);
+
+    madvise(mData + start, end - start, MADV_WILLNEED);
+}
+
+CHIP_ERROR FileSender::PrepareToSend(System::Layer * layer, const MappedFile & file, uint16_t maxBlockSize,
+                                     System::Clock::Timeout timeout, System::Clock::Timeout pollFreq)
+{
+    VerifyOrReturnError(!IsBusy(), CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(file.IsOpen(), CHIP_ERROR_INVALID_ARGUMENT);
+
+    BitFlags<TransferControlFlags> xferControlOpts(TransferControlFlags::kReceiverDrive);
+    ReturnErrorOnFailure(PrepareForTransfer(layer, TransferRole::kSender, xferControlOpts,
+                                            std::min(maxBlockSize, TransferSession::kMaxBlockSize), timeout, pollFreq));
+
+    mFile = &file;
+    return CHIP_NO_ERROR;
+}
+
+void FileSender::EndTransfer()
+{
+    Messaging::ExchangeContext * ec = mExchangeCtx;
+
+    // Clear mExchangeCtx first, so OnExchangeClosing ignores the closing of the exchange.
+    mExchangeCtx = nullptr;
+    Reset();
+
+    if (ec != nullptr)
+    {
+        ec->Close();
+    }
+}
+
+void FileSender::Shutdown()
+{
+    EndTransfer();
+
+    VerifyOrReturn(mSystemLayer != nullptr);
+    mSystemLayer->CancelTimer(PollTimerHandler, this);
+    mSystemLayer = nullptr;
+}
+
+void FileSender::HandleTransferSessionOutput(TransferSession::OutputEvent & event)
+{
+    if (event.EventType != TransferSession::OutputEventType::kNone)
+    {
+        ChipLogDetail(BDX, "OutputEvent type: %s", event.ToString(event.EventType));
+    }
+
+    switch (event.EventType)
+    {
+    case TransferSession::OutputEventType::kNone:
+        break;
+    case TransferSession::OutputEventType::kMsgToSend: {
+        VerifyOrReturn(mExchangeCtx != nullptr, ChipLogError(BDX, "%s: mExchangeCtx is null", __FUNCTION__));
+
+        // All messages sent from the Sender expect a response, except for a StatusReport which would indicate an error and the
+        // end of the transfer.
+        const bool isStatusReport = event.msgTypeData.HasMessageType(Protocols::SecureChannel::MsgType::StatusReport);
+        Messaging::SendFlags sendFlags;
+        if (!isStatusReport)
+        {
+            sendFlags.Set(Messaging::SendMessageFlags::kExpectResponse);
+        }
+
+        CHIP_ERROR err = mExchangeCtx->SendMessage(event.msgTypeData.ProtocolId, event.msgTypeData.MessageType,
+                                                   std::move(event.MsgData), sendFlags);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(BDX, "SendMessage failed: %s", ErrorStr(err));
+        }
+        if (err != CHIP_NO_ERROR || isStatusReport)
+        {
+            EndTransfer();
+        }
+        break;
+    }
+    case TransferSession::OutputEventType::kInitReceived:
+        AcceptTransfer();
+        break;
+    case TransferSession::OutputEventType::kQueryReceived:
+        SendBlock();
+        break;
+    case TransferSession::OutputEventType::kQueryWithSkipReceived:
+        mOffset = static_cast<size_t>(std::min<uint64_t>(mEnd, mOffset + event.bytesToSkip.BytesToSkip));
+        SendBlock();
+        break;
+    case TransferSession::OutputEventType::kAckReceived:
+        break;
+    case TransferSession::OutputEventType::kAckEOFReceived:
+        ChipLogDetail(BDX, "Transfer completed, got AckEOF");
+        EndTransfer();
+        break;
+    case TransferSession::OutputEventType::kStatusReceived:
+        ChipLogError(BDX, "Got StatusReport %x", static_cast<uint16_t>(event.statusData.statusCode));
+        EndTransfer();
+        break;
+    case TransferSession::OutputEventType::kInternalError:
+        ChipLogError(BDX, "InternalError");
+        EndTransfer();
+        break;
+    case TransferSession::OutputEventType::kTransferTimeout:
+        ChipLogError(BDX, "Transfer timed out");
+        EndTransfer();
+        break;
+    case TransferSession::OutputEventType::kAcceptReceived:
+    case TransferSession::OutputEventType::kBlockReceived:
+    default:
+        // TransferSession should prevent this case from happening.
+        ChipLogError(BDX, "%s: unsupported event type", __FUNCTION__);
+    }
+}
+
+void FileSender::AcceptTransfer()
+{
+    VerifyOrReturn(mFile != nullptr, ChipLogError(BDX, "%s: no file to send", __FUNCTION__));
+
+    const uint64_t startOffset = mTransfer.GetStartOffset();
+    const uint64_t length      = mTransfer.GetTransferLength();
+    const size_t fileSize      = mFile->GetSize();
+    CHIP_ERROR err             = CHIP_NO_ERROR;
+
+    if (startOffset > fileSize)
+    {
+        err = mTransfer.AbortTransfer(StatusCode::kStartOffsetNotSupported);
+    }
+    else if (length > fileSize - startOffset)
+    {
+        err = mTransfer.AbortTransfer(StatusCode::kLengthTooLarge);
+    }
+    else
+    {
+        mOffset       = static_cast<size_t>(startOffset);
+        mEnd          = (length > 0) ? static_cast<size_t>(startOffset + length) : fileSize;
+        mReadAheadEnd = mOffset;
+
+        // TransferSession will automatically reject a transfer if there are no common supported control modes. It will also
+        // default to the smaller block size.
+        TransferSession::TransferAcceptData acceptData;
+        acceptData.ControlMode  = TransferControlFlags::kReceiverDrive;
+        acceptData.MaxBlockSize = mTransfer.GetTransferBlockSize();
+        acceptData.StartOffset  = startOffset;
+        acceptData.Length       = length;
+        err                     = mTransfer.AcceptTransfer(acceptData);
+    }
+
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(BDX, "%s: %s", __FUNCTION__, ErrorStr(err));
+        EndTransfer();
+    }
+}
+
+void FileSender::SendBlock()
+{
+    VerifyOrReturn(mFile != nullptr, ChipLogError(BDX, "%s: no file to send", __FUNCTION__));
+
+    // Keep the kernel reading at least half a read ahead window past the block.
+    mReadAheadEnd = std::max(mReadAheadEnd, mOffset);
+    if (mReadAheadEnd < mEnd && mReadAheadEnd - mOffset < kReadAheadSize / 2)
+    {
+        const size_t length = std::min(kReadAheadSize, mEnd - mReadAheadEnd);
+        mFile->ReadAhead(mReadAheadEnd, length);
+        mReadAheadEnd += length;
+    }
+
+    // The block is copied from the mapping into the message buffer by PrepareBlock.
+    TransferSession::BlockData blockData;
+    blockData.Data   = mFile->GetData() + mOffset;
+    blockData.Length = std::min<size_t>(mTransfer.GetTransferBlockSize(), mEnd - mOffset);
+    blockData.IsEof  = (mOffset + blockData.Length == mEnd);
+
+    CHIP_ERROR err = mTransfer.PrepareBlock(blockData);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(BDX, "%s: PrepareBlock failed: %s", __FUNCTION__, ErrorStr(err));
+        mTransfer.AbortTransfer(StatusCode::kUnknown);
+        return;
+    }
+
+    mOffset += blockData.Length;
+}
+
+void FileSender::OnResponseTimeout(Messaging::ExchangeContext * ec)
+{
+    ChipLogError(BDX, "%s, ec: " ChipLogFormatExchange, __FUNCTION__, ChipLogValueExchange(ec));
+
+    // The exchange closes itself after a response timeout.
+    mExchangeCtx = nullptr;
+    Reset();
+}
+
+void FileSender::OnExchangeClosing(Messaging::ExchangeContext * ec)
+{
+    VerifyOrReturn(ec == mExchangeCtx);
+
+    // The exchange was closed under the transfer, e.g. because its session went away.
+    mExchangeCtx = nullptr;
+    Reset();
+}
+
+void FileSender::Reset()
+{
+    mTransfer.Reset();
+    mFile         = nullptr;
+    mOffset       = 0;
+    mEnd          = 0;
+    mReadAheadEnd = 0;
+}
+
+CHIP_ERROR FileSenderPool::Init(System::Layer * layer, uint16_t maxBlockSize, System::Clock::Timeout timeout,
+                                System::Clock::Timeout pollFreq)
+{
+    VerifyOrReturnError(layer != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    mSystemLayer  = layer;
+    mMaxBlockSize = maxBlockSize;
+    mTimeout      = timeout;
+    mPollFreq     = pollFreq;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR FileSenderPool::SetFile(const char * path)
+{
+    VerifyOrReturnError(path != nullptr && strlen(path) < kMaxPathLength, CHIP_ERROR_INVALID_ARGUMENT);
+    if (mFile.IsOpen() && strcmp(path, mPath) == 0)
+    {
+        return RemapIfChanged();
+    }
+    VerifyOrReturnError(GetActiveTransferCount() == 0, CHIP_ERROR_INCORRECT_STATE);
+
+    mPath[0] = '\0';
+    ReturnErrorOnFailure(mFile.Open(path));
+    Platform::CopyString(mPath, path);
+    return CHIP_NO_ERROR;
+}
+
+void FileSenderPool::Shutdown()
+{
+    for (auto & sender : mSenders)
+    {
+        sender.Shutdown();
+    }
+
+    mFile.Close();
+    mPath[0] = '\0';
+}
+
+size_t FileSenderPool::GetActiveTransferCount() const
+{
+    return static_cast<size_t>(
+        std::count_if(std::begin(mSenders), std::end(mSenders), [](const FileSender & sender) { return sender.IsBusy(); }));
+}
+
+CHIP_ERROR FileSenderPool::OnMessageReceived(Messaging::ExchangeContext * ec, const PayloadHeader & payloadHeader,
+                                             System::PacketBufferHandle && payload)
+{
+    // Only the first message of each transfer comes here: the exchange is handed over to a sender afterwards.
+    VerifyOrReturnError(payloadHeader.HasMessageType(MessageType::ReceiveInit), RejectTransfer(ec, StatusCode::kUnexpectedMessage));
+    VerifyOrReturnError(mFile.IsOpen() && mSystemLayer != nullptr, RejectTransfer(ec, StatusCode::kFileDesignatorUnknown));
+
+    // The sender parses the message again, so the pool only keeps a reference to it.
+    ReceiveInit init;
+    VerifyOrReturnError(init.Parse(payload.Retain()) == CHIP_NO_ERROR, RejectTransfer(ec, StatusCode::kBadMessageContents));
+    VerifyOrReturnError(init.FileDesLength == strlen(mPath) && memcmp(init.FileDesignator, mPath, init.FileDesLength) == 0,
+                        RejectTransfer(ec, StatusCode::kFileDesignatorUnknown));
+    VerifyOrReturnError(RemapIfChanged() == CHIP_NO_ERROR, RejectTransfer(ec, StatusCode::kFileDesignatorUnknown));
+
+    FileSender * sender = std::find_if(std::begin(mSenders), std::end(mSenders), [](const FileSender & s) { return !s.IsBusy(); });
+    VerifyOrReturnError(sender != std::end(mSenders), RejectTransfer(ec, StatusCode::kTransferFailedUnknownError));
+
+    ReturnErrorOnFailure(sender->PrepareToSend(mSystemLayer, mFile, mMaxBlockSize, mTimeout, mPollFreq));
+
+    ec->SetDelegate(sender);
+    return static_cast<Messaging::ExchangeDelegate *>(sender)->OnMessageReceived(ec, payloadHeader, std::move(payload));
+}
+
+CHIP_ERROR FileSenderPool::RejectTransfer(Messaging::ExchangeContext * ec, StatusCode code)
+{
+    ChipLogError(BDX, "Rejecting transfer: status %x", to_underlying(code));
+
+    Protocols::SecureChannel::StatusReport report(Protocols::SecureChannel::GeneralStatusCode::kFailure,
+                                                  Protocols::BDX::Id.ToFullyQualifiedSpecForm(), to_underlying(code));
+    size_t msgSize = report.Size();
+    Encoding::LittleEndian::PacketBufferWriter bbuf(MessagePacketBuffer::New(msgSize), msgSize);
+    VerifyOrReturnError(!bbuf.IsNull(), CHIP_ERROR_NO_MEMORY);
+
+    report.WriteToBuffer(bbuf);
+    System::PacketBufferHandle msg = bbuf.Finalize();
+    VerifyOrReturnError(!msg.IsNull(), CHIP_ERROR_NO_MEMORY);
+
+    // The exchange closes once this message is handled, as no response is expected.
+    return ec->SendMessage(Protocols::SecureChannel::MsgType::StatusReport, std::move(msg));
+}
+
+CHIP_ERROR FileSenderPool::RemapIfChanged()
+{
+    VerifyOrReturnError(mFile.HasChanged(mPath), CHIP_NO_ERROR);
+
+    // The ongoing transfers read the old mapping, which may now end past the end of the file.
+    ChipLogProgress(BDX, "%s changed, mapping it again", mPath);
+    for (auto & sender : mSenders)
+    {
+        sender.EndTransfer();
+    }
+
+    CHIP_ERROR err = mFile.Open(mPath);
+    if (err != CHIP_NO_ERROR)
+    {
+        mPath[0] = '\0';
+    }
+    return err;
+}
+
+} // namespace bdx
+} // namespace chip
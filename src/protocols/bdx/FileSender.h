@@ -0,0 +1,205 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @file FileSender.h
+ *
+ *  This file defines a BDX Responder that sends a file to receiver driven transfers, and a pool of them that serves one file to
+ *  many concurrent transfers, e.g. OTA images to OTA requestors.
+ *
+ *  The file is mapped to memory once and blocks are copied from the mapping straight into the messages, so there is no file
+ *  access for each block. The pages ahead of the transfer are requested from the kernel in advance.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPConfig.h>
+#include <lib/core/CHIPError.h>
+#include <messaging/ExchangeContext.h>
+#include <messaging/ExchangeDelegate.h>
+#include <protocols/bdx/BdxTransferSession.h>
+#include <protocols/bdx/TransferFacilitator.h>
+#include <system/SystemLayer.h>
+
+namespace chip {
+namespace bdx {
+
+/**
+ * A read-only memory mapping of a whole file.
+ *
+ * Accessing the mapping past the end of the file raises SIGBUS, so the file must not be truncated while the mapping is in use.
+ * Check HasChanged, and map the file again, before each use.
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile & operator=(const MappedFile &) = delete;
+
+    /**
+     * Map the file at path, which must not be empty. The file descriptor is closed once the file is mapped.
+     */
+    CHIP_ERROR Open(const char * path);
+
+    /**
+     * Unmap the file. Called by the destructor.
+     */
+    void Close();
+
+    bool IsOpen() const { return mData != nullptr; }
+    const uint8_t * GetData() const { return mData; }
+    size_t GetSize() const { return mSize; }
+
+    /**
+     * Whether the file at path is not the mapped file anymore, or its size changed, e.g. because it was replaced or truncated.
+     */
+    bool HasChanged(const char * path) const;
+
+    /**
+     * Ask the kernel to start reading the given range of the file, so it is in memory by the time it is accessed.
+     */
+    void ReadAhead(size_t offset, size_t length) const;
+
+private:
+    uint8_t * mData  = nullptr;
+    size_t mSize     = 0;
+    uint64_t mDevice = 0;
+    uint64_t mInode  = 0;
+};
+
+/**
+ * A Responder that sends (a range of) a MappedFile to a receiver driven transfer.
+ *
+ * The transfer ends, and the exchange is closed, once the receiver acknowledges the last block or when the transfer fails.
+ */
+class FileSender : public Responder
+{
+public:
+    /**
+     * How far ahead of the transfer offset the file is read.
+     */
+    static constexpr size_t kReadAheadSize = 64 * 1024;
+
+    /**
+     * Wait for an incoming transfer request, and start the polling timer.
+     *
+     * @param[in] layer        A System::Layer pointer to use to start the polling timer
+     * @param[in] file         The file to send, which has to stay open until the transfer ends
+     * @param[in] maxBlockSize The supported maximum size of BDX Block data, at most TransferSession::kMaxBlockSize
+     * @param[in] timeout      The chosen timeout delay for the BDX transfer
+     * @param[in] pollFreq     The period for the TransferSession poll timer
+     */
+    CHIP_ERROR PrepareToSend(System::Layer * layer, const MappedFile & file, uint16_t maxBlockSize, System::Clock::Timeout timeout,
+                             System::Clock::Timeout pollFreq);
+
+    /**
+     * Whether the sender was prepared for a transfer that has not ended yet.
+     */
+    bool IsBusy() const { return mFile != nullptr; }
+
+    /**
+     * End the transfer, if any, and close its exchange.
+     */
+    void EndTransfer();
+
+    /**
+     * End the transfer, if any, and stop the polling timer.
+     */
+    void Shutdown();
+
+private:
+    // Inherited from bdx::TransferFacilitator
+    void HandleTransferSessionOutput(TransferSession::OutputEvent & event) override;
+
+    // Inherited from Messaging::ExchangeDelegate
+    void OnResponseTimeout(Messaging::ExchangeContext * ec) override;
+    void OnExchangeClosing(Messaging::ExchangeContext * ec) override;
+
+    void AcceptTransfer();
+    void SendBlock();
+    void Reset();
+
+    const MappedFile * mFile = nullptr;
+    size_t mOffset           = 0; // Of the next block
+    size_t mEnd              = 0; // Of the range to send
+    size_t mReadAheadEnd     = 0; // Of the range the kernel was asked to read
+};
+
+/**
+ * An unsolicited message handler for BDX that serves a MappedFile to up to CHIP_CONFIG_BDX_MAX_FILE_SENDERS concurrent receiver
+ * driven transfers, with a FileSender for each of them. The file designator of the ReceiveInit has to be the path the file was
+ * set with.
+ *
+ * Transfer requests for another file, received while all the senders are busy, or before a file is set, are rejected with a
+ * StatusReport.
+ */
+class FileSenderPool : public Messaging::ExchangeDelegate
+{
+public:
+    ~FileSenderPool() override { Shutdown(); }
+
+    /**
+     * Set the parameters of the transfers. May be called again to change the parameters of the transfers that start afterwards.
+     *
+     * @param[in] layer        A System::Layer pointer to use to start the polling timers
+     * @param[in] maxBlockSize The supported maximum size of BDX Block data, at most TransferSession::kMaxBlockSize
+     * @param[in] timeout      The chosen timeout delay for the BDX transfers
+     * @param[in] pollFreq     The period for the TransferSession poll timers
+     */
+    CHIP_ERROR Init(System::Layer * layer, uint16_t maxBlockSize, System::Clock::Timeout timeout, System::Clock::Timeout pollFreq);
+
+    /**
+     * Map the file to serve. Nothing is done if the file at the same path is already mapped and has not changed since, and it
+     * fails with CHIP_ERROR_INCORRECT_STATE if another file is mapped and transfers of it are ongoing.
+     *
+     * The file is also mapped again when a transfer starts after it changed, ending the ongoing transfers of the old one.
+     */
+    CHIP_ERROR SetFile(const char * path);
+
+    /**
+     * End all the transfers and unmap the file. Called by the destructor.
+     */
+    void Shutdown();
+
+    size_t GetActiveTransferCount() const;
+
+private:
+    // Inherited from Messaging::ExchangeDelegate
+    CHIP_ERROR OnMessageReceived(Messaging::ExchangeContext * ec, const PayloadHeader & payloadHeader,
+                                 System::PacketBufferHandle && payload) override;
+    void OnResponseTimeout(Messaging::ExchangeContext * ec) override {}
+
+    CHIP_ERROR RejectTransfer(Messaging::ExchangeContext * ec, StatusCode code);
+    CHIP_ERROR RemapIfChanged();
+
+    static constexpr size_t kMaxPathLength = 256;
+
+    FileSender mSenders[CHIP_CONFIG_BDX_MAX_FILE_SENDERS];
+    MappedFile mFile;
+    char mPath[kMaxPathLength] = {};
+
+    System::Layer * mSystemLayer     = nullptr;
+    uint16_t mMaxBlockSize           = 0;
+    System::Clock::Timeout mTimeout  = System::Clock::kZero;
+    System::Clock::Timeout mPollFreq = System::Clock::kZero;
+};
+
+} // namespace bdx
+} // namespace chip
@@ -55,6 +55,10 @@ CHIP_ERROR TransferFacilitator::OnMessageReceived(chip::Messaging::ExchangeConte
     // transfer is finished.
     mExchangeCtx->WillSendMessage();
 
+    // Poll for the output of the message right away, rather than at the next poll period, so a transfer moves at the pace of
+    // the messages rather than at that of the poll timer.
+    ScheduleImmediatePoll();
+
     return err;
 }
 
@@ -77,8 +81,13 @@ void TransferFacilitator::PollForOutput()
     mTransfer.PollOutput(outEvent, System::SystemClock().GetMonotonicTimestamp());
     HandleTransferSessionOutput(outEvent);
 
+    // Handling an output often queues another one (e.g. a block in response to a query), so keep polling without delay as long as
+    // there is output.
+    const System::Clock::Timeout delay =
+        (outEvent.EventType == TransferSession::OutputEventType::kNone) ? mPollFreq : kImmediatePollDelay;
+
     VerifyOrReturn(mSystemLayer != nullptr, ChipLogError(BDX, "%s mSystemLayer is null", __FUNCTION__));
-    mSystemLayer->StartTimer(mPollFreq, PollTimerHandler, this);
+    mSystemLayer->StartTimer(delay, PollTimerHandler, this);
 }
 
 void TransferFacilitator::ScheduleImmediatePoll()
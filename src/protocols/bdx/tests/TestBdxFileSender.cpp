@@ -0,0 +1,595 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements tests of the BDX file sender, with transfers of an image to receivers over loopback
+ *      sessions, and a benchmark of OTA image transfers.
+ */
+
+#include <lib/core/CHIPError.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <messaging/ExchangeContext.h>
+#include <messaging/Flags.h>
+#include <messaging/tests/MessagingContext.h>
+#include <protocols/Protocols.h>
+#include <protocols/bdx/BdxMessages.h>
+#include <protocols/bdx/BdxTransferSession.h>
+#include <protocols/bdx/FileSender.h>
+#include <protocols/bdx/TransferFacilitator.h>
+#include <protocols/secure_channel/Constants.h>
+#include <system/SystemClock.h>
+
+#include <nlunit-test.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <string>
+
+using namespace ::chip;
+using namespace ::chip::bdx;
+
+namespace {
+
+using TestContext = Test::LoopbackMessagingContext<>;
+
+constexpr size_t kImageSize                           = 128 * 1024;
+constexpr uint16_t kLegacyBlockSize                   = 1024; // Of the OTA provider example before FileSender
+constexpr uint16_t kLargestProposedBlockSize          = std::numeric_limits<uint16_t>::max();
+constexpr char kFileDesignator[]                      = "test.ota";
+constexpr System::Clock::Timeout kTransferTimeout     = System::Clock::Seconds16(30);
+constexpr System::Clock::Timeout kPollFreq            = System::Clock::Milliseconds32(500);
+constexpr System::Clock::Timeout kMaxTransferDuration = System::Clock::Seconds16(60);
+
+uint8_t ImageByte(size_t offset)
+{
+    return static_cast<uint8_t>((offset * 31) ^ (offset >> 8));
+}
+
+std::string WriteImage()
+{
+    char path[] = "/tmp/chip_bdx_file_sender_test-XXXXXX";
+    int fd      = mkstemp(path);
+    if (fd == -1)
+    {
+        return std::string();
+    }
+
+    uint8_t buf[4096];
+    for (size_t offset = 0; offset < kImageSize; offset += sizeof(buf))
+    {
+        const size_t length = std::min(sizeof(buf), kImageSize - offset);
+        for (size_t i = 0; i < length; i++)
+        {
+            buf[i] = ImageByte(offset + i);
+        }
+        if (write(fd, buf, length) != static_cast<ssize_t>(length))
+        {
+            close(fd);
+            unlink(path);
+            return std::string();
+        }
+    }
+
+    close(fd);
+    return path;
+}
+
+CHIP_ERROR SendTransferMessage(Messaging::ExchangeContext * ec, TransferSession::OutputEvent & event, bool expectResponse)
+{
+    VerifyOrReturnError(ec != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    Messaging::SendFlags sendFlags;
+    if (expectResponse)
+    {
+        sendFlags.Set(Messaging::SendMessageFlags::kExpectResponse);
+    }
+    return ec->SendMessage(event.msgTypeData.ProtocolId, event.msgTypeData.MessageType, std::move(event.MsgData), sendFlags);
+}
+
+// Receives the image, or a range of it, checking its bytes against ImageByte.
+class TestReceiver : public Initiator
+{
+public:
+    ~TestReceiver()
+    {
+        if (mSystemLayer != nullptr)
+        {
+            mSystemLayer->CancelTimer(PollTimerHandler, this);
+        }
+        if (mExchangeCtx != nullptr)
+        {
+            mExchangeCtx->Close();
+        }
+    }
+
+    CHIP_ERROR Start(TestContext & ctx, const std::string & fileDesignator, uint16_t maxBlockSize, uint64_t startOffset = 0,
+                     uint64_t length = 0)
+    {
+        mExchangeCtx = ctx.NewExchangeToBob(this);
+        VerifyOrReturnError(mExchangeCtx != nullptr, CHIP_ERROR_NO_MEMORY);
+
+        mOffset = static_cast<size_t>(startOffset);
+
+        TransferSession::TransferInitData initData;
+        initData.TransferCtlFlags = TransferControlFlags::kReceiverDrive;
+        initData.MaxBlockSize     = maxBlockSize;
+        initData.StartOffset      = startOffset;
+        initData.Length           = length;
+        initData.FileDesignator   = reinterpret_cast<const uint8_t *>(fileDesignator.data());
+        initData.FileDesLength    = static_cast<uint16_t>(fileDesignator.size());
+        ReturnErrorOnFailure(
+            InitiateTransfer(&ctx.GetSystemLayer(), TransferRole::kReceiver, initData, kTransferTimeout, kPollFreq));
+
+        ScheduleImmediatePoll();
+        return CHIP_NO_ERROR;
+    }
+
+    bool IsDone() const { return mSucceeded || mFailed; }
+    bool Succeeded() const { return mSucceeded && !mMismatch; }
+    bool Failed() const { return mFailed; }
+    size_t GetReceivedLength() const { return mReceivedLength; }
+    uint16_t GetBlockSize() const { return mBlockSize; }
+
+private:
+    void HandleTransferSessionOutput(TransferSession::OutputEvent & event) override
+    {
+        switch (event.EventType)
+        {
+        case TransferSession::OutputEventType::kMsgToSend: {
+            // The BlockAckEOF ends the transfer, and a StatusReport aborts it.
+            const bool isAckEOF = event.msgTypeData.HasMessageType(MessageType::BlockAckEOF);
+            const bool isLast   = isAckEOF || event.msgTypeData.HasMessageType(Protocols::SecureChannel::MsgType::StatusReport);
+            const bool sent     = (SendTransferMessage(mExchangeCtx, event, !isLast) == CHIP_NO_ERROR);
+            if (!sent || isLast)
+            {
+                Finish(isAckEOF && sent);
+            }
+            break;
+        }
+        case TransferSession::OutputEventType::kAcceptReceived:
+            mBlockSize = event.transferAcceptData.MaxBlockSize;
+            if (mTransfer.PrepareBlockQuery() != CHIP_NO_ERROR)
+            {
+                Finish(false);
+            }
+            break;
+        case TransferSession::OutputEventType::kBlockReceived:
+            for (size_t i = 0; i < event.blockdata.Length; i++)
+            {
+                mMismatch = mMismatch || (event.blockdata.Data[i] != ImageByte(mOffset + i));
+            }
+            mOffset += event.blockdata.Length;
+            mReceivedLength += event.blockdata.Length;
+            if ((event.blockdata.IsEof ? mTransfer.PrepareBlockAck() : mTransfer.PrepareBlockQuery()) != CHIP_NO_ERROR)
+            {
+                Finish(false);
+            }
+            break;
+        case TransferSession::OutputEventType::kStatusReceived:
+        case TransferSession::OutputEventType::kInternalError:
+        case TransferSession::OutputEventType::kTransferTimeout:
+            Finish(false);
+            break;
+        default:
+            break;
+        }
+    }
+
+    // The exchange closes by itself once the last message is sent, as no response is expected.
+    void OnExchangeClosing(Messaging::ExchangeContext * ec) override { mExchangeCtx = nullptr; }
+
+    void Finish(bool succeeded)
+    {
+        (succeeded ? mSucceeded : mFailed) = true;
+        if (mExchangeCtx != nullptr)
+        {
+            mExchangeCtx->Close();
+            mExchangeCtx = nullptr;
+        }
+    }
+
+    size_t mOffset         = 0;
+    size_t mReceivedLength = 0;
+    uint16_t mBlockSize    = 0;
+    bool mSucceeded        = false;
+    bool mFailed           = false;
+    bool mMismatch         = false;
+};
+
+// Sends the image the way the OTA provider example did before FileSender: the file is opened, seeked and read for each block.
+class StreamSender : public Responder
+{
+public:
+    ~StreamSender()
+    {
+        if (mSystemLayer != nullptr)
+        {
+            mSystemLayer->CancelTimer(PollTimerHandler, this);
+        }
+        if (mExchangeCtx != nullptr)
+        {
+            mExchangeCtx->Close();
+        }
+    }
+
+    void SetPath(const std::string & path) { mPath = path; }
+
+private:
+    void HandleTransferSessionOutput(TransferSession::OutputEvent & event) override
+    {
+        switch (event.EventType)
+        {
+        case TransferSession::OutputEventType::kMsgToSend:
+            SendTransferMessage(mExchangeCtx, event,
+                                !event.msgTypeData.HasMessageType(Protocols::SecureChannel::MsgType::StatusReport));
+            break;
+        case TransferSession::OutputEventType::kInitReceived: {
+            TransferSession::TransferAcceptData acceptData;
+            acceptData.ControlMode  = TransferControlFlags::kReceiverDrive;
+            acceptData.MaxBlockSize = mTransfer.GetTransferBlockSize();
+            mTransfer.AcceptTransfer(acceptData);
+            break;
+        }
+        case TransferSession::OutputEventType::kQueryReceived: {
+            uint8_t buf[TransferSession::kMaxBlockSize];
+            std::ifstream file(mPath, std::ifstream::in | std::ifstream::binary);
+            file.seekg(static_cast<std::streamoff>(mBytesSent));
+            file.read(reinterpret_cast<char *>(buf), mTransfer.GetTransferBlockSize());
+
+            TransferSession::BlockData blockData;
+            blockData.Data   = buf;
+            blockData.Length = static_cast<size_t>(file.gcount());
+            blockData.IsEof  = (mBytesSent + blockData.Length == kImageSize);
+            mBytesSent += blockData.Length;
+            mTransfer.PrepareBlock(blockData);
+            break;
+        }
+        case TransferSession::OutputEventType::kAckEOFReceived:
+        case TransferSession::OutputEventType::kStatusReceived:
+        case TransferSession::OutputEventType::kInternalError:
+        case TransferSession::OutputEventType::kTransferTimeout:
+            mTransfer.Reset();
+            mBytesSent = 0;
+            if (mExchangeCtx != nullptr)
+            {
+                mExchangeCtx->Close();
+                mExchangeCtx = nullptr;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    std::string mPath;
+    size_t mBytesSent = 0;
+};
+
+bool StartPool(TestContext & ctx, FileSenderPool & pool, const std::string & path, uint16_t maxBlockSize)
+{
+    return pool.Init(&ctx.GetSystemLayer(), maxBlockSize, kTransferTimeout, kPollFreq) == CHIP_NO_ERROR &&
+        (path.empty() || pool.SetFile(path.c_str()) == CHIP_NO_ERROR) &&
+        ctx.GetExchangeManager().RegisterUnsolicitedMessageHandlerForProtocol(Protocols::BDX::Id, &pool) == CHIP_NO_ERROR;
+}
+
+void StopPool(TestContext & ctx, FileSenderPool & pool)
+{
+    ctx.GetExchangeManager().UnregisterUnsolicitedMessageHandlerForProtocol(Protocols::BDX::Id);
+    pool.Shutdown();
+    ctx.DrainAndServiceIO();
+}
+
+// The sender handles the acknowledgement of the last block at its next poll, so it may still be busy when the receiver is done.
+bool WaitForIdle(TestContext & ctx, FileSenderPool & pool)
+{
+    ctx.GetIOContext().DriveIOUntil(kMaxTransferDuration, [&]() { return pool.GetActiveTransferCount() == 0; });
+    return pool.GetActiveTransferCount() == 0;
+}
+
+// Starts the transfers of all the receivers and waits for them to end. Returns how long they took.
+System::Clock::Microseconds64 RunTransfers(nlTestSuite * inSuite, TestContext & ctx, TestReceiver * receivers, size_t count,
+                                           const std::string & fileDesignator, uint16_t maxBlockSize, uint64_t startOffset = 0,
+                                           uint64_t length = 0)
+{
+    const System::Clock::Microseconds64 start = System::SystemClock().GetMonotonicMicroseconds64();
+
+    for (size_t i = 0; i < count; i++)
+    {
+        NL_TEST_ASSERT(inSuite, receivers[i].Start(ctx, fileDesignator, maxBlockSize, startOffset, length) == CHIP_NO_ERROR);
+    }
+    ctx.GetIOContext().DriveIOUntil(kMaxTransferDuration, [&]() {
+        return std::all_of(receivers, receivers + count, [](const TestReceiver & receiver) { return receiver.IsDone(); });
+    });
+
+    const System::Clock::Microseconds64 elapsed = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+    ctx.DrainAndServiceIO();
+    return elapsed;
+}
+
+void TestTransfer(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    std::string path  = WriteImage();
+    FileSenderPool pool;
+    TestReceiver receiver;
+
+    NL_TEST_ASSERT(inSuite, !path.empty());
+    NL_TEST_ASSERT(inSuite, StartPool(ctx, pool, path, TransferSession::kMaxBlockSize));
+
+    RunTransfers(inSuite, ctx, &receiver, 1, path, kLargestProposedBlockSize);
+
+    // The block size is the largest a message can carry.
+    NL_TEST_ASSERT(inSuite, receiver.Succeeded());
+    NL_TEST_ASSERT(inSuite, receiver.GetReceivedLength() == kImageSize);
+    NL_TEST_ASSERT(inSuite, receiver.GetBlockSize() == TransferSession::kMaxBlockSize);
+    NL_TEST_ASSERT(inSuite, WaitForIdle(ctx, pool));
+
+    StopPool(ctx, pool);
+    unlink(path.c_str());
+}
+
+void TestRangeTransfer(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr uint64_t kStartOffset = 1000;
+    constexpr uint64_t kLength      = 5000;
+
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    std::string path  = WriteImage();
+    FileSenderPool pool;
+    TestReceiver receivers[2];
+
+    NL_TEST_ASSERT(inSuite, !path.empty());
+    NL_TEST_ASSERT(inSuite, StartPool(ctx, pool, path, kLegacyBlockSize));
+
+    RunTransfers(inSuite, ctx, &receivers[0], 1, path, kLargestProposedBlockSize, kStartOffset, kLength);
+    NL_TEST_ASSERT(inSuite, receivers[0].Succeeded());
+    NL_TEST_ASSERT(inSuite, receivers[0].GetReceivedLength() == kLength);
+    NL_TEST_ASSERT(inSuite, receivers[0].GetBlockSize() == kLegacyBlockSize);
+
+    // A range past the end of the image is rejected
+    RunTransfers(inSuite, ctx, &receivers[1], 1, path, kLargestProposedBlockSize, kImageSize - kLength + 1, kLength);
+    NL_TEST_ASSERT(inSuite, receivers[1].Failed());
+    NL_TEST_ASSERT(inSuite, WaitForIdle(ctx, pool));
+
+    StopPool(ctx, pool);
+    unlink(path.c_str());
+}
+
+void TestConcurrentTransfers(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr size_t kReceiverCount = CHIP_CONFIG_BDX_MAX_FILE_SENDERS + 1;
+
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    std::string path  = WriteImage();
+    FileSenderPool pool;
+    TestReceiver receivers[kReceiverCount];
+
+    NL_TEST_ASSERT(inSuite, !path.empty());
+    NL_TEST_ASSERT(inSuite, StartPool(ctx, pool, path, TransferSession::kMaxBlockSize));
+
+    RunTransfers(inSuite, ctx, receivers, kReceiverCount, path, kLargestProposedBlockSize);
+
+    // All the senders serve a transfer, and the request that comes once they are all busy is rejected.
+    size_t succeeded = 0;
+    size_t failed    = 0;
+    for (const TestReceiver & receiver : receivers)
+    {
+        NL_TEST_ASSERT(inSuite, receiver.IsDone());
+        succeeded += (receiver.Succeeded() && receiver.GetReceivedLength() == kImageSize) ? 1 : 0;
+        failed += receiver.Failed() ? 1 : 0;
+    }
+    NL_TEST_ASSERT(inSuite, succeeded == CHIP_CONFIG_BDX_MAX_FILE_SENDERS);
+    NL_TEST_ASSERT(inSuite, failed == 1);
+    NL_TEST_ASSERT(inSuite, WaitForIdle(ctx, pool));
+
+    StopPool(ctx, pool);
+    unlink(path.c_str());
+}
+
+void TestNoFile(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    FileSenderPool pool;
+    TestReceiver receiver;
+
+    NL_TEST_ASSERT(inSuite, pool.SetFile("/nonexistent/chip_bdx_file_sender_test") != CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, StartPool(ctx, pool, std::string(), TransferSession::kMaxBlockSize));
+
+    RunTransfers(inSuite, ctx, &receiver, 1, kFileDesignator, kLargestProposedBlockSize);
+    NL_TEST_ASSERT(inSuite, receiver.Failed());
+
+    StopPool(ctx, pool);
+}
+
+void TestOtherFileDesignator(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    std::string path  = WriteImage();
+    FileSenderPool pool;
+    TestReceiver receiver;
+
+    NL_TEST_ASSERT(inSuite, !path.empty());
+    NL_TEST_ASSERT(inSuite, StartPool(ctx, pool, path, TransferSession::kMaxBlockSize));
+
+    // A request for another file is rejected, rather than served with the mapped one.
+    RunTransfers(inSuite, ctx, &receiver, 1, kFileDesignator, kLargestProposedBlockSize);
+    NL_TEST_ASSERT(inSuite, receiver.Failed());
+    NL_TEST_ASSERT(inSuite, receiver.GetReceivedLength() == 0);
+    NL_TEST_ASSERT(inSuite, pool.GetActiveTransferCount() == 0);
+
+    StopPool(ctx, pool);
+    unlink(path.c_str());
+}
+
+void TestChangedFile(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    std::string path  = WriteImage();
+    FileSenderPool pool;
+    TestReceiver receivers[3];
+
+    NL_TEST_ASSERT(inSuite, !path.empty());
+    NL_TEST_ASSERT(inSuite, StartPool(ctx, pool, path, TransferSession::kMaxBlockSize));
+
+    RunTransfers(inSuite, ctx, &receivers[0], 1, path, kLargestProposedBlockSize);
+    NL_TEST_ASSERT(inSuite, receivers[0].Succeeded());
+    NL_TEST_ASSERT(inSuite, WaitForIdle(ctx, pool));
+
+    // Sending from the old mapping past the new end of the file would raise SIGBUS.
+    NL_TEST_ASSERT(inSuite, truncate(path.c_str(), kImageSize / 2) == 0);
+    RunTransfers(inSuite, ctx, &receivers[1], 1, path, kLargestProposedBlockSize);
+    NL_TEST_ASSERT(inSuite, receivers[1].Succeeded());
+    NL_TEST_ASSERT(inSuite, receivers[1].GetReceivedLength() == kImageSize / 2);
+    NL_TEST_ASSERT(inSuite, WaitForIdle(ctx, pool));
+
+    // A file replaced at the same path is mapped again by SetFile.
+    std::string newPath = WriteImage();
+    NL_TEST_ASSERT(inSuite, !newPath.empty());
+    NL_TEST_ASSERT(inSuite, rename(newPath.c_str(), path.c_str()) == 0);
+    NL_TEST_ASSERT(inSuite, pool.SetFile(path.c_str()) == CHIP_NO_ERROR);
+    RunTransfers(inSuite, ctx, &receivers[2], 1, path, kLargestProposedBlockSize);
+    NL_TEST_ASSERT(inSuite, receivers[2].Succeeded());
+    NL_TEST_ASSERT(inSuite, receivers[2].GetReceivedLength() == kImageSize);
+    NL_TEST_ASSERT(inSuite, WaitForIdle(ctx, pool));
+
+    StopPool(ctx, pool);
+    unlink(path.c_str());
+}
+
+void LogThroughput(const char * label, size_t bytes, System::Clock::Microseconds64 elapsed)
+{
+    ChipLogProgress(BDX, "OTA transfer of %u bytes, %s: %" PRIu64 " us, %" PRIu64 " kB/s", static_cast<unsigned>(bytes), label,
+                    elapsed.count(), elapsed.count() ? (static_cast<uint64_t>(bytes) * 1000000u / 1024u / elapsed.count()) : 0);
+}
+
+void BenchmarkOtaTransfer(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    std::string path  = WriteImage();
+    NL_TEST_ASSERT(inSuite, !path.empty());
+
+    // Reading the file for each block, with the block size of the OTA provider example before FileSender
+    {
+        StreamSender sender;
+        TestReceiver receiver;
+        BitFlags<TransferControlFlags> xferControlOpts(TransferControlFlags::kReceiverDrive);
+
+        sender.SetPath(path);
+        NL_TEST_ASSERT(inSuite,
+                       sender.PrepareForTransfer(&ctx.GetSystemLayer(), TransferRole::kSender, xferControlOpts, kLegacyBlockSize,
+                                                 kTransferTimeout, kPollFreq) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite,
+                       ctx.GetExchangeManager().RegisterUnsolicitedMessageHandlerForProtocol(Protocols::BDX::Id, &sender) ==
+                           CHIP_NO_ERROR);
+
+        System::Clock::Microseconds64 elapsed = RunTransfers(inSuite, ctx, &receiver, 1, path, kLargestProposedBlockSize);
+        NL_TEST_ASSERT(inSuite, receiver.Succeeded() && receiver.GetReceivedLength() == kImageSize);
+        LogThroughput("stream read per block", kImageSize, elapsed);
+
+        ctx.GetExchangeManager().UnregisterUnsolicitedMessageHandlerForProtocol(Protocols::BDX::Id);
+    }
+
+    // From the mapping, with the largest block size
+    {
+        FileSenderPool pool;
+        TestReceiver receiver;
+
+        NL_TEST_ASSERT(inSuite, StartPool(ctx, pool, path, TransferSession::kMaxBlockSize));
+
+        System::Clock::Microseconds64 elapsed = RunTransfers(inSuite, ctx, &receiver, 1, path, kLargestProposedBlockSize);
+        NL_TEST_ASSERT(inSuite, receiver.Succeeded() && receiver.GetReceivedLength() == kImageSize);
+        LogThroughput("mapped file", kImageSize, elapsed);
+
+        StopPool(ctx, pool);
+    }
+
+    // From the mapping, to as many requestors as there are senders
+    {
+        FileSenderPool pool;
+        TestReceiver receivers[CHIP_CONFIG_BDX_MAX_FILE_SENDERS];
+
+        NL_TEST_ASSERT(inSuite, StartPool(ctx, pool, path, TransferSession::kMaxBlockSize));
+
+        System::Clock::Microseconds64 elapsed =
+            RunTransfers(inSuite, ctx, receivers, CHIP_CONFIG_BDX_MAX_FILE_SENDERS, path, kLargestProposedBlockSize);
+        for (const TestReceiver & receiver : receivers)
+        {
+            NL_TEST_ASSERT(inSuite, receiver.Succeeded() && receiver.GetReceivedLength() == kImageSize);
+        }
+        LogThroughput("mapped file, concurrent requestors", kImageSize * CHIP_CONFIG_BDX_MAX_FILE_SENDERS, elapsed);
+
+        StopPool(ctx, pool);
+    }
+
+    unlink(path.c_str());
+}
+
+// Test Suite
+
+/**
+ *  Test Suite that lists all the test functions.
+ */
+// clang-format off
+const nlTest sTests[] =
+{
+    NL_TEST_DEF("TestTransfer", TestTransfer),
+    NL_TEST_DEF("TestRangeTransfer", TestRangeTransfer),
+    NL_TEST_DEF("TestConcurrentTransfers", TestConcurrentTransfers),
+    NL_TEST_DEF("TestNoFile", TestNoFile),
+    NL_TEST_DEF("TestOtherFileDesignator", TestOtherFileDesignator),
+    NL_TEST_DEF("TestChangedFile", TestChangedFile),
+    NL_TEST_DEF("BenchmarkOtaTransfer", BenchmarkOtaTransfer),
+    NL_TEST_SENTINEL()
+};
+
+nlTestSuite sSuite =
+{
+    "Test-CHIP-BdxFileSender",
+    &sTests[0],
+    TestContext::InitializeAsync,
+    TestContext::Finalize
+};
+// clang-format on
+
+} // namespace
+
+/**
+ *  Main
+ */
+int TestBdxFileSender()
+{
+    TestContext sContext;
+
+    // Run test suit against one context
+    nlTestRunner(&sSuite, &sContext);
+
+    return (nlTestRunnerStats(&sSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestBdxFileSender)
@@ -21,6 +21,7 @@
 #include <lib/support/CodeUtils.h>
 #include <lib/support/SafeInt.h>
 #include <lib/support/logging/CHIPLogging.h>
+#include <protocols/secure_channel/StatusReport.h>
 #include <transport/SessionManager.h>
 
 using namespace ::chip::Inet;
@@ -29,6 +30,15 @@ using namespace ::chip::Credentials;
 
 namespace chip {
 
+CASEServer::~CASEServer()
+{
+    if (mExchangeManager != nullptr)
+    {
+        mExchangeManager->UnregisterUnsolicitedMessageHandlerForType(Protocols::SecureChannel::MsgType::CASE_Sigma1);
+    }
+    ReleaseAllHandshakes();
+}
+
 CHIP_ERROR CASEServer::ListenForSessionEstablishment(Messaging::ExchangeManager * exchangeManager, TransportMgrBase * transportMgr,
                                                      Ble::BleLayer * bleLayer, SessionManager * sessionManager,
                                                      FabricTable * fabrics, SessionIDAllocator * idAllocator)
@@ -38,17 +48,34 @@ CHIP_ERROR CASEServer::ListenForSessionEstablishment(Messaging::ExchangeManager
     VerifyOrReturnError(sessionManager != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrReturnError(fabrics != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
 
+    ReleaseAllHandshakes();
+
     mBleLayer        = bleLayer;
     mSessionManager  = sessionManager;
     mFabrics         = fabrics;
     mExchangeManager = exchangeManager;
     mIDAllocator     = idAllocator;
 
-    Cleanup();
-    return CHIP_NO_ERROR;
+    ChipLogProgress(Inet, "CASE Server enabling CASE session setups");
+    return mExchangeManager->RegisterUnsolicitedMessageHandlerForType(Protocols::SecureChannel::MsgType::CASE_Sigma1, this);
 }
 
-CHIP_ERROR CASEServer::InitCASEHandshake(Messaging::ExchangeContext * ec)
+namespace {
+
+PeerAddress GetSigma1PeerAddress(Messaging::ExchangeContext * ec)
+{
+    // Sigma1 comes over an unauthenticated session, which knows where the message came from.
+    SessionHandle session = ec->GetSessionHandle();
+    if (session->GetSessionType() == Session::SessionType::kUnauthenticated)
+    {
+        return session->AsUnauthenticatedSession()->GetPeerAddress();
+    }
+    return PeerAddress::Uninitialized();
+}
+
+} // namespace
+
+CHIP_ERROR CASEServer::InitCASEHandshake(Messaging::ExchangeContext * ec, const PeerAddress & peerAddress, Handshake *& handshake)
 {
     ReturnErrorCodeIf(ec == nullptr, CHIP_ERROR_INVALID_ARGUMENT);
 
@@ -68,75 +95,142 @@ CHIP_ERROR CASEServer::InitCASEHandshake(Messaging::ExchangeContext * ec)
     }
 #endif
 
-    ReturnErrorOnFailure(mIDAllocator->Allocate(mSessionKeyId));
+    CASESession * session = AllocateSession();
+    VerifyOrReturnError(session != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    handshake = mHandshakes.CreateObject(*this, *session, peerAddress);
+    if (handshake == nullptr)
+    {
+        ReleaseSession(session);
+        return CHIP_ERROR_NO_MEMORY;
+    }
 
-    // Setup CASE state machine using the credentials for the current fabric.
-    ReturnErrorOnFailure(GetSession().ListenForSessionEstablishment(
-        mSessionKeyId, mFabrics, this, Optional<ReliableMessageProtocolConfig>::Value(GetLocalMRPConfig())));
+    CHIP_ERROR err = mIDAllocator->Allocate(handshake->mSessionKeyId);
+    if (err == CHIP_NO_ERROR)
+    {
+        // Setup CASE state machine using the credentials for the current fabric.
+        session->SetSessionResumptionCache(mSessionResumptionCache);
+        err = session->ListenForSessionEstablishment(handshake->mSessionKeyId, mFabrics, handshake,
+                                                     Optional<ReliableMessageProtocolConfig>::Value(GetLocalMRPConfig()));
+        if (err != CHIP_NO_ERROR)
+        {
+            mIDAllocator->Free(handshake->mSessionKeyId);
+        }
+    }
+    if (err != CHIP_NO_ERROR)
+    {
+        ReleaseHandshake(*handshake);
+        handshake = nullptr;
+        return err;
+    }
 
     // Hand over the exchange context to the CASE session.
-    ec->SetDelegate(&GetSession());
+    ec->SetDelegate(session);
 
     return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR CASEServer::OnMessageReceived(Messaging::ExchangeContext * ec, const PayloadHeader & payloadHeader,
-                                         System::PacketBufferHandle && payload)
+size_t CASEServer::CountHandshakes(const PeerAddress & peerAddress)
 {
-    ChipLogProgress(Inet, "CASE Server received Sigma1 message. Starting handshake. EC %p", ec);
-    CHIP_ERROR err = InitCASEHandshake(ec);
-    SuccessOrExit(err);
+    size_t count = 0;
+    mHandshakes.ForEachActiveObject([&](Handshake * handshake) {
+        if (handshake->mPeerAddress == peerAddress)
+        {
+            count++;
+        }
+        return Loop::Continue;
+    });
+    return count;
+}
+
+void CASEServer::SendBusy(Messaging::ExchangeContext * ec)
+{
+    Protocols::SecureChannel::StatusReport statusReport(Protocols::SecureChannel::GeneralStatusCode::kBusy,
+                                                        Protocols::SecureChannel::Id.ToFullyQualifiedSpecForm(),
+                                                        Protocols::SecureChannel::kProtocolCodeBusy);
 
-    // TODO - Enable multiple concurrent CASE session establishment
-    // https://github.com/project-chip/connectedhomeip/issues/8342
-    ChipLogProgress(Inet, "CASE Server disabling CASE session setups");
-    mExchangeManager->UnregisterUnsolicitedMessageHandlerForType(Protocols::SecureChannel::MsgType::CASE_Sigma1);
+    Encoding::LittleEndian::PacketBufferWriter bbuf(System::PacketBufferHandle::New(statusReport.Size()));
+    statusReport.WriteToBuffer(bbuf);
 
-    err = GetSession().OnMessageReceived(ec, payloadHeader, std::move(payload));
-    SuccessOrExit(err);
+    System::PacketBufferHandle msg = bbuf.Finalize();
+    VerifyOrReturn(!msg.IsNull(), ChipLogError(Inet, "Failed to allocate status report message"));
 
-exit:
+    // The exchange closes itself once the status report is sent, as no response is expected.
+    CHIP_ERROR err = ec->SendMessage(Protocols::SecureChannel::MsgType::StatusReport, std::move(msg));
     if (err != CHIP_NO_ERROR)
     {
-        Cleanup();
+        ChipLogError(Inet, "Failed to send busy status report: %s", ErrorStr(err));
     }
-    return err;
 }
 
-void CASEServer::Cleanup()
+CHIP_ERROR CASEServer::OnMessageReceived(Messaging::ExchangeContext * ec, const PayloadHeader & payloadHeader,
+                                         System::PacketBufferHandle && payload)
 {
-    // Let's re-register for CASE Sigma1 message, so that the next CASE session setup request can be processed.
-    // https://github.com/project-chip/connectedhomeip/issues/8342
-    ChipLogProgress(Inet, "CASE Server enabling CASE session setups");
-    mExchangeManager->RegisterUnsolicitedMessageHandlerForType(Protocols::SecureChannel::MsgType::CASE_Sigma1, this);
+    VerifyOrReturnError(ec != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    // Refuse the handshake, rather than dropping the Sigma1, so that the initiator can try again
+    // later instead of waiting for its retransmissions to time out.
+    PeerAddress peerAddress = GetSigma1PeerAddress(ec);
+    if (mHandshakes.Allocated() >= CHIP_CONFIG_CASE_SERVER_MAX_HANDSHAKES || CountHandshakes(peerAddress) >= mMaxHandshakesPerPeer)
+    {
+        ChipLogProgress(Inet, "CASE Server busy (%u handshakes in progress), refusing Sigma1. EC %p",
+                        static_cast<unsigned>(mHandshakes.Allocated()), ec);
+        SendBusy(ec);
+        return CHIP_NO_ERROR;
+    }
+
+    ChipLogProgress(Inet, "CASE Server received Sigma1 message. Starting handshake. EC %p", ec);
+    Handshake * handshake = nullptr;
+    ReturnErrorOnFailure(InitCASEHandshake(ec, peerAddress, handshake));
 
-    GetSession().Clear();
+    // The session reports any failure to its delegate, which releases the handshake, so there is
+    // nothing left to clean up here.
+    return handshake->mSession.OnMessageReceived(ec, payloadHeader, std::move(payload));
 }
 
-void CASEServer::OnSessionEstablishmentError(CHIP_ERROR err)
+void CASEServer::ReleaseHandshake(Handshake & handshake)
+{
+    CASESession & session = handshake.mSession;
+
+    mHandshakes.ReleaseObject(&handshake);
+    ReleaseSession(&session);
+}
+
+void CASEServer::ReleaseAllHandshakes()
+{
+    mHandshakes.ForEachActiveObject([&](Handshake * handshake) {
+        mIDAllocator->Free(handshake->mSessionKeyId);
+        ReleaseHandshake(*handshake);
+        return Loop::Continue;
+    });
+}
+
+void CASEServer::OnHandshakeError(Handshake & handshake, CHIP_ERROR err)
 {
     ChipLogProgress(Inet, "CASE Session establishment failed: %s", ErrorStr(err));
-    mIDAllocator->Free(mSessionKeyId);
-    Cleanup();
+    mIDAllocator->Free(handshake.mSessionKeyId);
+    ReleaseHandshake(handshake);
 }
 
-void CASEServer::OnSessionEstablished()
+void CASEServer::OnHandshakeComplete(Handshake & handshake)
 {
+    CASESession & session = handshake.mSession;
+
     ChipLogProgress(Inet, "CASE Session established. Setting up the secure channel.");
-    mSessionManager->ExpireAllPairings(GetSession().GetPeerNodeId(), GetSession().GetFabricIndex());
+    mSessionManager->ExpireAllPairings(session.GetPeerNodeId(), session.GetFabricIndex());
 
     SessionHolder sessionHolder;
     CHIP_ERROR err = mSessionManager->NewPairing(
-        sessionHolder, Optional<Transport::PeerAddress>::Value(GetSession().GetPeerAddress()), GetSession().GetPeerNodeId(),
-        &GetSession(), CryptoContext::SessionRole::kResponder, GetSession().GetFabricIndex());
+        sessionHolder, Optional<Transport::PeerAddress>::Value(session.GetPeerAddress()), session.GetPeerNodeId(), &session,
+        CryptoContext::SessionRole::kResponder, session.GetFabricIndex());
     if (err != CHIP_NO_ERROR)
     {
         ChipLogError(Inet, "Failed in setting up secure channel: err %s", ErrorStr(err));
-        OnSessionEstablishmentError(err);
+        OnHandshakeError(handshake, err);
         return;
     }
 
     ChipLogProgress(Inet, "CASE secure channel is available now.");
-    Cleanup();
+    ReleaseHandshake(handshake);
 }
 } // namespace chip
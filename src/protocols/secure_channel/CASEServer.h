@@ -18,56 +18,102 @@
 #pragma once
 
 #include <ble/BleLayer.h>
+#include <lib/support/Pool.h>
 #include <messaging/ExchangeDelegate.h>
 #include <messaging/ExchangeMgr.h>
 #include <protocols/secure_channel/CASESession.h>
 #include <protocols/secure_channel/SessionIDAllocator.h>
+#include <transport/raw/PeerAddress.h>
 
 namespace chip {
 
-class CASEServer : public SessionEstablishmentDelegate, public Messaging::ExchangeDelegate
+/**
+ * Responder side of CASE. Each incoming Sigma1 gets its own CASESession, up to
+ * CHIP_CONFIG_CASE_SERVER_MAX_HANDSHAKES of them at a time, and at most
+ * CHIP_CONFIG_CASE_SERVER_MAX_HANDSHAKES_PER_PEER from any one peer address.
+ * A Sigma1 over either limit is answered with a Busy status report.
+ */
+class CASEServer : public Messaging::ExchangeDelegate
 {
 public:
     CASEServer() {}
-    ~CASEServer()
-    {
-        if (mExchangeManager != nullptr)
-        {
-            mExchangeManager->UnregisterUnsolicitedMessageHandlerForType(Protocols::SecureChannel::MsgType::CASE_Sigma1);
-        }
-    }
+    virtual ~CASEServer();
 
     CHIP_ERROR ListenForSessionEstablishment(Messaging::ExchangeManager * exchangeManager, TransportMgrBase * transportMgr,
                                              Ble::BleLayer * bleLayer, SessionManager * sessionManager, FabricTable * fabrics,
                                              SessionIDAllocator * idAllocator);
 
-    //////////// SessionEstablishmentDelegate Implementation ///////////////
-    void OnSessionEstablishmentError(CHIP_ERROR error) override;
-    void OnSessionEstablished() override;
+    /**
+     * Change the number of handshakes a single peer address can hold, e.g. where all the
+     * peers share an address. Handshakes already in progress are not affected.
+     */
+    void SetMaxHandshakesPerPeer(size_t maxHandshakes) { mMaxHandshakesPerPeer = maxHandshakes; }
+
+    /**
+     * Resume sessions recorded in the given cache, and record the sessions established in it.
+     * The cache must outlive the server.
+     */
+    void SetSessionResumptionCache(CASESessionCache * cache) { mSessionResumptionCache = cache; }
+
+    /**
+     * Number of handshakes in progress, and the most there have been at the same time.
+     */
+    size_t GetActiveHandshakeCount() const { return mHandshakes.Allocated(); }
+    size_t GetHandshakeHighWaterMark() const { return mHandshakes.HighWaterMark(); }
 
     //// ExchangeDelegate Implementation ////
     CHIP_ERROR OnMessageReceived(Messaging::ExchangeContext * ec, const PayloadHeader & payloadHeader,
                                  System::PacketBufferHandle && payload) override;
     void OnResponseTimeout(Messaging::ExchangeContext * ec) override {}
-    Messaging::ExchangeMessageDispatch & GetMessageDispatch() override { return GetSession().GetMessageDispatch(); }
+    Messaging::ExchangeMessageDispatch & GetMessageDispatch() override { return SessionEstablishmentExchangeDispatch::Instance(); }
 
-    virtual CASESession & GetSession() { return mPairingSession; }
+protected:
+    // The CASESession objects used by the handshakes come from here, so that tests can substitute their own.
+    virtual CASESession * AllocateSession() { return mSessionPool.CreateObject(); }
+    virtual void ReleaseSession(CASESession * session) { mSessionPool.ReleaseObject(session); }
 
 private:
+    class Handshake : public SessionEstablishmentDelegate
+    {
+    public:
+        Handshake(CASEServer & server, CASESession & session, const Transport::PeerAddress & peerAddress) :
+            mServer(server), mSession(session), mPeerAddress(peerAddress)
+        {}
+
+        void OnSessionEstablishmentError(CHIP_ERROR error) override { mServer.OnHandshakeError(*this, error); }
+        void OnSessionEstablished() override { mServer.OnHandshakeComplete(*this); }
+
+        CASEServer & mServer;
+        CASESession & mSession;
+        Transport::PeerAddress mPeerAddress;
+        uint16_t mSessionKeyId = 0;
+    };
+
     Messaging::ExchangeManager * mExchangeManager = nullptr;
 
-    CASESession mPairingSession;
-    uint16_t mSessionKeyId           = 0;
     SessionManager * mSessionManager = nullptr;
     Ble::BleLayer * mBleLayer        = nullptr;
 
-    FabricTable * mFabrics = nullptr;
+    FabricTable * mFabrics                     = nullptr;
+    CASESessionCache * mSessionResumptionCache = nullptr;
+
+    size_t mMaxHandshakesPerPeer = CHIP_CONFIG_CASE_SERVER_MAX_HANDSHAKES_PER_PEER;
+
+    ObjectPool<Handshake, CHIP_CONFIG_CASE_SERVER_MAX_HANDSHAKES> mHandshakes;
+    ObjectPool<CASESession, CHIP_CONFIG_CASE_SERVER_MAX_HANDSHAKES> mSessionPool;
+
+    CHIP_ERROR InitCASEHandshake(Messaging::ExchangeContext * ec, const Transport::PeerAddress & peerAddress,
+                                 Handshake *& handshake);
+    size_t CountHandshakes(const Transport::PeerAddress & peerAddress);
+    void SendBusy(Messaging::ExchangeContext * ec);
 
-    CHIP_ERROR InitCASEHandshake(Messaging::ExchangeContext * ec);
+    void OnHandshakeError(Handshake & handshake, CHIP_ERROR error);
+    void OnHandshakeComplete(Handshake & handshake);
 
     SessionIDAllocator * mIDAllocator = nullptr;
 
-    void Cleanup();
+    void ReleaseHandshake(Handshake & handshake);
+    void ReleaseAllHandshakes();
 };
 
 } // namespace chip
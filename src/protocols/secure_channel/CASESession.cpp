@@ -36,6 +36,7 @@
 #include <lib/support/ScopedBuffer.h>
 #include <lib/support/TypeTraits.h>
 #include <protocols/Protocols.h>
+#include <protocols/secure_channel/CASESessionCache.h>
 #include <protocols/secure_channel/StatusReport.h>
 #include <system/TLVPacketBufferBackingStore.h>
 #include <trace/trace.h>
@@ -89,6 +90,22 @@ using HKDF_sha_crypto = HKDF_sha;
 // The session establishment fails if the response is not received within timeout window.
 static constexpr ExchangeContext::Timeout kSigma_Response_Timeout = System::Clock::Seconds16(30);
 
+class CASESession::CryptoStep : public CryptoJob
+{
+public:
+    CryptoStep(CASESession & session, CryptoStepHandler work, CryptoStepHandler done) :
+        mSession(session), mWork(work), mDone(done)
+    {}
+
+    CHIP_ERROR Run() override { return (mSession.*mWork)(); }
+    void OnComplete(CHIP_ERROR err) override { mSession.OnCryptoStepComplete(err, mDone); }
+
+private:
+    CASESession & mSession;
+    CryptoStepHandler mWork;
+    CryptoStepHandler mDone;
+};
+
 CASESession::CASESession() : PairingSession(Transport::SecureSession::Type::kCASE)
 {
     mTrustedRootId = CertificateKeyId();
@@ -104,8 +121,21 @@ void CASESession::Clear()
 {
     // This function zeroes out and resets the memory used by the object.
     // It's done so that no security related information will be leaked.
+    // A crypto step still running may be using any of it, so stop that first.
+    if (mCryptoJob != nullptr)
+    {
+        GetCryptoJobQueue().Cancel(mCryptoJob);
+        mCryptoJob = nullptr;
+    }
+    mTBEData.Free();
+    mTBEDataLength = 0;
+    mFabricCredentials.Reset();
+    mTrustedRootId = CertificateKeyId();
+
     mCommissioningHash.Clear();
     mCASESessionEstablished = false;
+    mResumptionRequested    = false;
+    mSessionResumed         = false;
     PairingSession::Clear();
 
     mState = kInitialized;
@@ -135,6 +165,57 @@ void CASESession::DiscardExchange()
     }
 }
 
+CHIP_ERROR CASESession::RunCryptoStep(CryptoStepHandler work, CryptoStepHandler done)
+{
+    VerifyOrReturnError(mCryptoJob == nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(mExchangeCtxt != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    CryptoStep * step = Platform::New<CryptoStep>(*this, work, done);
+    VerifyOrReturnError(step != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    // Keep the exchange open until the step completes and sends the next message.
+    mExchangeCtxt->WillSendMessage();
+    mCryptoJob = step;
+    GetCryptoJobQueue().Post(step);
+
+    return CHIP_NO_ERROR;
+}
+
+void CASESession::OnCryptoStepComplete(CHIP_ERROR err, CryptoStepHandler done)
+{
+    mCryptoJob = nullptr;
+
+    if (err == CHIP_NO_ERROR)
+    {
+        // On success, the handler may have ended the handshake, and the delegate freed us.
+        err = (this->*done)();
+        VerifyOrReturn(err != CHIP_NO_ERROR);
+    }
+
+    ChipLogError(SecureChannel, "Failed during CASE session setup: %" CHIP_ERROR_FORMAT, err.Format());
+    SendStatusReportAndReleaseExchange(kProtocolCodeInvalidParam);
+    Clear();
+
+    // Do this last in case the delegate frees us.
+    mDelegate->OnSessionEstablishmentError(err);
+}
+
+void CASESession::SendStatusReportAndReleaseExchange(uint16_t protocolCode)
+{
+    VerifyOrReturn(mExchangeCtxt != nullptr);
+
+    // A status report that was sent closes the exchange, which may free it. If it could not be sent, the exchange is
+    // still open, either for the last crypto step or for the message being handled, and closing it is safe in both cases.
+    if (SendStatusReport(mExchangeCtxt, protocolCode) == CHIP_NO_ERROR)
+    {
+        mExchangeCtxt = nullptr;
+    }
+    else
+    {
+        CloseExchange();
+    }
+}
+
 CHIP_ERROR CASESession::ToCachable(CASESessionCachable & cachableSession)
 {
     const NodeId peerNodeId = GetPeerNodeId();
@@ -147,8 +228,7 @@ CHIP_ERROR CASESession::ToCachable(CASESessionCachable & cachableSession)
     {
         cachableSession.mPeerCATs.values[i] = LittleEndian::HostSwap32(GetPeerCATs().values[i]);
     }
-    // TODO: Get the fabric index
-    cachableSession.mLocalFabricIndex      = 0;
+    cachableSession.mLocalFabricIndex      = GetFabricIndex();
     cachableSession.mSessionSetupTimeStamp = LittleEndian::HostSwap64(mSessionSetupTimeStamp);
 
     memcpy(cachableSession.mResumptionId, mResumptionId, sizeof(mResumptionId));
@@ -158,6 +238,15 @@ CHIP_ERROR CASESession::ToCachable(CASESessionCachable & cachableSession)
 }
 
 CHIP_ERROR CASESession::FromCachable(const CASESessionCachable & cachableSession)
+{
+    ReturnErrorOnFailure(RestoreSessionState(cachableSession));
+
+    mCASESessionEstablished = true;
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CASESession::RestoreSessionState(const CASESessionCachable & cachableSession)
 {
     uint16_t length = LittleEndian::HostSwap16(cachableSession.mSharedSecretLen);
     ReturnErrorOnFailure(mSharedSecret.SetLength(static_cast<size_t>(length)));
@@ -181,11 +270,44 @@ CHIP_ERROR CASESession::FromCachable(const CASESessionCachable & cachableSession
     VerifyOrReturnError(ipkListSpan->size() == sizeof(mIPK), CHIP_ERROR_INVALID_ARGUMENT);
     memcpy(mIPK, ipkListSpan->data(), sizeof(mIPK));
 
-    mCASESessionEstablished = true;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CASESession::RestoreSessionToResume(const ByteSpan & resumptionId)
+{
+    VerifyOrReturnError(mSessionResumptionCache != nullptr && mFabricsTable != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
+    VerifyOrReturnError(resumptionId.size() == kCASEResumptionIDSize, CHIP_ERROR_INVALID_ARGUMENT);
+
+    CASESessionCachable cachableSession;
+    ReturnErrorOnFailure(mSessionResumptionCache->Get(ResumptionID(resumptionId.data()), cachableSession));
+
+    // The session can't be resumed if its fabric was removed since.
+    FabricInfo * fabric = mFabricsTable->FindFabricWithIndex(cachableSession.mLocalFabricIndex);
+    VerifyOrReturnError(fabric != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
+
+    ReturnErrorOnFailure(RestoreSessionState(cachableSession));
+    mFabricInfo = fabric;
 
     return CHIP_NO_ERROR;
 }
 
+void CASESession::AddToSessionResumptionCache()
+{
+    VerifyOrReturn(mSessionResumptionCache != nullptr);
+
+    CASESessionCachable cachableSession;
+    CHIP_ERROR err = ToCachable(cachableSession);
+    if (err == CHIP_NO_ERROR)
+    {
+        err = mSessionResumptionCache->Add(cachableSession);
+    }
+    if (err != CHIP_NO_ERROR)
+    {
+        // The session is established all the same; it just can't be resumed.
+        ChipLogError(SecureChannel, "Failed to cache CASE session for resumption: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+}
+
 CHIP_ERROR CASESession::Init(uint16_t localSessionId, SessionEstablishmentDelegate * delegate)
 {
     VerifyOrReturnError(delegate != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
@@ -244,11 +366,23 @@ CHIP_ERROR CASESession::EstablishSession(const Transport::PeerAddress peerAddres
 
     mFabricInfo     = fabric;
     mLocalMRPConfig = mrpConfig;
+    SuccessOrExit(err = mFabricInfo->CopyCredentialsTo(mFabricCredentials));
 
     mExchangeCtxt->SetResponseTimeout(kSigma_Response_Timeout + mExchangeCtxt->GetSessionHandle()->GetAckTimeout());
     SetPeerAddress(peerAddress);
     SetPeerNodeId(peerNodeId);
 
+    // Offer to resume the last session with this peer, if there is one. The peer may still choose a full handshake.
+    if (mSessionResumptionCache != nullptr)
+    {
+        CASESessionCachable cachableSession;
+        if (mSessionResumptionCache->Get(fabric->GetFabricIndex(), peerNodeId, cachableSession) == CHIP_NO_ERROR &&
+            RestoreSessionState(cachableSession) == CHIP_NO_ERROR)
+        {
+            mResumptionRequested = true;
+        }
+    }
+
     err = SendSigma1();
     SuccessOrExit(err);
 
@@ -283,6 +417,19 @@ CHIP_ERROR CASESession::DeriveSecureSession(CryptoContext & session, CryptoConte
 
     VerifyOrReturnError(mCASESessionEstablished, CHIP_ERROR_INCORRECT_STATE);
 
+    if (mSessionResumed)
+    {
+        // The keys of a resumed session are derived from the shared secret of the session it resumes.
+        uint8_t resumptionSalt[kSigmaParamRandomNumberSize + kCASEResumptionIDSize];
+        Encoding::LittleEndian::BufferWriter bbuf(resumptionSalt, sizeof(resumptionSalt));
+        bbuf.Put(mInitiatorRandom, sizeof(mInitiatorRandom));
+        bbuf.Put(mResumptionId, sizeof(mResumptionId));
+        VerifyOrReturnError(bbuf.Fit(), CHIP_ERROR_BUFFER_TOO_SMALL);
+
+        return session.InitFromSecret(ByteSpan(mSharedSecret, mSharedSecret.Length()), ByteSpan(resumptionSalt),
+                                      CryptoContext::SessionInfoType::kSessionResumption, role);
+    }
+
     // Generate Salt for Encryption keys
     saltlen = sizeof(mIPK) + kSHA256_Hash_Length;
 
@@ -355,7 +502,7 @@ CHIP_ERROR CASESession::SendSigma1()
     // If CASE session was previously established using the current state information, let's fill in the session resumption
     // information in the the Sigma1 request. It'll speed up the session establishment process if the peer can resume the old
     // session, since no certificate chains will have to be verified.
-    if (mCASESessionEstablished)
+    if (mCASESessionEstablished || mResumptionRequested)
     {
         ReturnErrorOnFailure(tlvWriter.PutBytes(TLV::ContextTag(6), mResumptionId, kCASEResumptionIDSize));
 
@@ -422,12 +569,16 @@ CHIP_ERROR CASESession::HandleSigma1(System::PacketBufferHandle && msg)
     ChipLogDetail(SecureChannel, "Peer assigned session key ID %d", initiatorSessionId);
     SetPeerSessionId(initiatorSessionId);
 
-    if (sessionResumptionRequested && resumptionId.data_equal(ByteSpan(mResumptionId)))
+    if (sessionResumptionRequested && RestoreSessionToResume(resumptionId) == CHIP_NO_ERROR)
     {
         // Cross check resume1MIC with the shared secret
         if (ValidateSigmaResumeMIC(resume1MIC, initiatorRandom, resumptionId, ByteSpan(kKDFS1RKeyInfo),
                                    ByteSpan(kResume1MIC_Nonce)) == CHIP_NO_ERROR)
         {
+            // ParseSigma1 ensures that initiatorRandom.size() == sizeof(mInitiatorRandom).
+            memcpy(mInitiatorRandom, initiatorRandom.data(), sizeof(mInitiatorRandom));
+            mSessionResumed = true;
+
             // Send Sigma2Resume message to the initiator
             SuccessOrExit(err = SendSigma2Resume(initiatorRandom));
 
@@ -447,14 +598,14 @@ CHIP_ERROR CASESession::HandleSigma1(System::PacketBufferHandle && msg)
 
     mFabricInfo = mFabricsTable->FindFabricWithIndex(fabricIndex);
     VerifyOrExit(mFabricInfo != nullptr, err = CHIP_ERROR_INCORRECT_STATE);
+    SuccessOrExit(err = mFabricInfo->CopyCredentialsTo(mFabricCredentials));
 
     // ParseSigma1 ensures that:
     // mRemotePubKey.Length() == initiatorPubKey.size() == kP256_PublicKey_Length.
     memcpy(mRemotePubKey.Bytes(), initiatorPubKey.data(), mRemotePubKey.Length());
 
-    SuccessOrExit(err = SendSigma2());
-
-    mDelegate->OnSessionEstablishmentStarted();
+    SuccessOrExit(err = RunCryptoStep(&CASESession::GenerateSigma2, &CASESession::SendSigma2));
+    return CHIP_NO_ERROR;
 
 exit:
 
@@ -522,23 +673,22 @@ CHIP_ERROR CASESession::SendSigma2Resume(const ByteSpan & initiatorRandom)
     return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR CASESession::SendSigma2()
+CHIP_ERROR CASESession::GenerateSigma2()
 {
-    TRACE_EVENT_SCOPE("SendSigma2", "CASESession");
+    TRACE_EVENT_SCOPE("GenerateSigma2", "CASESession");
     VerifyOrReturnError(mFabricInfo != nullptr, CHIP_ERROR_INCORRECT_STATE);
 
     ByteSpan icaCert;
-    ReturnErrorOnFailure(mFabricInfo->GetICACert(icaCert));
+    ReturnErrorOnFailure(mFabricCredentials.GetICACert(icaCert));
 
     ByteSpan nocCert;
-    ReturnErrorOnFailure(mFabricInfo->GetNOCCert(nocCert));
+    ReturnErrorOnFailure(mFabricCredentials.GetNOCCert(nocCert));
 
-    ReturnErrorOnFailure(mFabricInfo->GetTrustedRootId(mTrustedRootId));
+    ReturnErrorOnFailure(mFabricCredentials.GetTrustedRootId(mTrustedRootId));
     VerifyOrReturnError(!mTrustedRootId.empty(), CHIP_ERROR_INTERNAL);
 
     // Fill in the random value
-    uint8_t msg_rand[kSigmaParamRandomNumberSize];
-    ReturnErrorOnFailure(DRBG_get_bytes(&msg_rand[0], sizeof(msg_rand)));
+    ReturnErrorOnFailure(DRBG_get_bytes(mResponderRandom, sizeof(mResponderRandom)));
 
     // Generate an ephemeral keypair
 #ifdef ENABLE_HSM_CASE_EPHEMERAL_KEY
@@ -552,7 +702,7 @@ CHIP_ERROR CASESession::SendSigma2()
     uint8_t msg_salt[kIPKSize + kSigmaParamRandomNumberSize + kP256_PublicKey_Length + kSHA256_Hash_Length];
 
     MutableByteSpan saltSpan(msg_salt);
-    ReturnErrorOnFailure(ConstructSaltSigma2(ByteSpan(msg_rand), mEphemeralKey.Pubkey(), ByteSpan(mIPK), saltSpan));
+    ReturnErrorOnFailure(ConstructSaltSigma2(ByteSpan(mResponderRandom), mEphemeralKey.Pubkey(), ByteSpan(mIPK), saltSpan));
 
     HKDF_sha_crypto mHKDF;
     uint8_t sr2k[CHIP_CRYPTO_SYMMETRIC_KEY_LENGTH_BYTES];
@@ -570,11 +720,11 @@ CHIP_ERROR CASESession::SendSigma2()
                                           ByteSpan(mRemotePubKey, mRemotePubKey.Length()), msg_R2_Signed.Get(), msg_r2_signed_len));
 
     // Generate a Signature
-    VerifyOrReturnError(mFabricInfo->GetOperationalKey() != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(mFabricCredentials.GetOperationalKey() != nullptr, CHIP_ERROR_INCORRECT_STATE);
 
     P256ECDSASignature tbsData2Signature;
     ReturnErrorOnFailure(
-        mFabricInfo->GetOperationalKey()->ECDSA_sign_msg(msg_R2_Signed.Get(), msg_r2_signed_len, tbsData2Signature));
+        mFabricCredentials.GetOperationalKey()->ECDSA_sign_msg(msg_R2_Signed.Get(), msg_r2_signed_len, tbsData2Signature));
 
     msg_R2_Signed.Free();
 
@@ -582,13 +732,12 @@ CHIP_ERROR CASESession::SendSigma2()
     size_t msg_r2_signed_enc_len =
         TLV::EstimateStructOverhead(nocCert.size(), icaCert.size(), tbsData2Signature.Length(), kCASEResumptionIDSize);
 
-    chip::Platform::ScopedMemoryBuffer<uint8_t> msg_R2_Encrypted;
-    VerifyOrReturnError(msg_R2_Encrypted.Alloc(msg_r2_signed_enc_len + CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES), CHIP_ERROR_NO_MEMORY);
+    VerifyOrReturnError(mTBEData.Alloc(msg_r2_signed_enc_len + CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES), CHIP_ERROR_NO_MEMORY);
 
     TLV::TLVWriter tlvWriter;
     TLV::TLVType outerContainerType = TLV::kTLVType_NotSpecified;
 
-    tlvWriter.Init(msg_R2_Encrypted.Get(), msg_r2_signed_enc_len);
+    tlvWriter.Init(mTBEData.Get(), msg_r2_signed_enc_len);
     ReturnErrorOnFailure(tlvWriter.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerContainerType));
     ReturnErrorOnFailure(tlvWriter.Put(TLV::ContextTag(kTag_TBEData_SenderNOC), nocCert));
     if (!icaCert.empty())
@@ -608,30 +757,37 @@ CHIP_ERROR CASESession::SendSigma2()
     msg_r2_signed_enc_len = static_cast<size_t>(tlvWriter.GetLengthWritten());
 
     // Generate the encrypted data blob
-    ReturnErrorOnFailure(AES_CCM_encrypt(msg_R2_Encrypted.Get(), msg_r2_signed_enc_len, nullptr, 0, sr2k,
+    ReturnErrorOnFailure(AES_CCM_encrypt(mTBEData.Get(), msg_r2_signed_enc_len, nullptr, 0, sr2k,
                                          CHIP_CRYPTO_SYMMETRIC_KEY_LENGTH_BYTES, kTBEData2_Nonce, kTBEDataNonceLength,
-                                         msg_R2_Encrypted.Get(), msg_R2_Encrypted.Get() + msg_r2_signed_enc_len,
+                                         mTBEData.Get(), mTBEData.Get() + msg_r2_signed_enc_len,
                                          CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES));
+    mTBEDataLength = msg_r2_signed_enc_len + CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES;
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CASESession::SendSigma2()
+{
+    TRACE_EVENT_SCOPE("SendSigma2", "CASESession");
 
     // Construct Sigma2 Msg
     const size_t mrpParamsSize = mLocalMRPConfig.HasValue() ? TLV::EstimateStructOverhead(sizeof(uint16_t), sizeof(uint16_t)) : 0;
     size_t data_len            = TLV::EstimateStructOverhead(kSigmaParamRandomNumberSize, sizeof(uint16_t), kP256_PublicKey_Length,
-                                                  msg_r2_signed_enc_len, CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES, mrpParamsSize);
+                                                  mTBEDataLength, mrpParamsSize);
 
     System::PacketBufferHandle msg_R2 = System::PacketBufferHandle::New(data_len);
     VerifyOrReturnError(!msg_R2.IsNull(), CHIP_ERROR_NO_MEMORY);
 
     System::PacketBufferTLVWriter tlvWriterMsg2;
-    outerContainerType = TLV::kTLVType_NotSpecified;
+    TLV::TLVType outerContainerType = TLV::kTLVType_NotSpecified;
 
     tlvWriterMsg2.Init(std::move(msg_R2));
     ReturnErrorOnFailure(tlvWriterMsg2.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerContainerType));
-    ReturnErrorOnFailure(tlvWriterMsg2.PutBytes(TLV::ContextTag(1), &msg_rand[0], sizeof(msg_rand)));
+    ReturnErrorOnFailure(tlvWriterMsg2.PutBytes(TLV::ContextTag(1), mResponderRandom, sizeof(mResponderRandom)));
     ReturnErrorOnFailure(tlvWriterMsg2.Put(TLV::ContextTag(2), GetLocalSessionId()));
     ReturnErrorOnFailure(
         tlvWriterMsg2.PutBytes(TLV::ContextTag(3), mEphemeralKey.Pubkey(), static_cast<uint32_t>(mEphemeralKey.Pubkey().Length())));
-    ReturnErrorOnFailure(tlvWriterMsg2.PutBytes(TLV::ContextTag(4), msg_R2_Encrypted.Get(),
-                                                static_cast<uint32_t>(msg_r2_signed_enc_len + CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES)));
+    ReturnErrorOnFailure(tlvWriterMsg2.PutBytes(TLV::ContextTag(4), mTBEData.Get(), static_cast<uint32_t>(mTBEDataLength)));
     if (mLocalMRPConfig.HasValue())
     {
         ChipLogDetail(SecureChannel, "Including MRP parameters");
@@ -647,9 +803,12 @@ CHIP_ERROR CASESession::SendSigma2()
                                                     SendFlags(SendMessageFlags::kExpectResponse)));
 
     mState = kSentSigma2;
+    mTBEData.Free();
 
     ChipLogDetail(SecureChannel, "Sent Sigma2 msg");
 
+    mDelegate->OnSessionEstablishmentStarted();
+
     return CHIP_NO_ERROR;
 }
 
@@ -668,6 +827,8 @@ CHIP_ERROR CASESession::HandleSigma2Resume(System::PacketBufferHandle && msg)
 
     uint8_t sigma2ResumeMIC[CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES];
 
+    VerifyOrExit(mResumptionRequested, err = CHIP_ERROR_INVALID_MESSAGE_TYPE);
+
     tlvReader.Init(std::move(msg));
     SuccessOrExit(err = tlvReader.Next(containerType, TLV::AnonymousTag()));
     SuccessOrExit(err = tlvReader.EnterContainer(containerType));
@@ -703,6 +864,8 @@ CHIP_ERROR CASESession::HandleSigma2Resume(System::PacketBufferHandle && msg)
     // on running out of session contexts.
 
     mCASESessionEstablished = true;
+    mSessionResumed         = true;
+    AddToSessionResumptionCache();
 
     // Discard the exchange so that Clear() doesn't try closing it.  The
     // exchange will handle that.
@@ -723,8 +886,8 @@ exit:
 CHIP_ERROR CASESession::HandleSigma2_and_SendSigma3(System::PacketBufferHandle && msg)
 {
     TRACE_EVENT_SCOPE("HandleSigma2_and_SendSigma3", "CASESession");
+    // Sigma3 is sent by the crypto step that HandleSigma2 starts.
     ReturnErrorOnFailure(HandleSigma2(std::move(msg)));
-    ReturnErrorOnFailure(SendSigma3());
 
     return CHIP_NO_ERROR;
 }
@@ -734,30 +897,12 @@ CHIP_ERROR CASESession::HandleSigma2(System::PacketBufferHandle && msg)
     TRACE_EVENT_SCOPE("HandleSigma2", "CASESession");
     CHIP_ERROR err = CHIP_NO_ERROR;
     System::PacketBufferTLVReader tlvReader;
-    TLV::TLVReader decryptedDataTlvReader;
     TLV::TLVType containerType = TLV::kTLVType_Structure;
 
     const uint8_t * buf = msg->Start();
     size_t buflen       = msg->DataLength();
 
-    uint8_t msg_salt[kIPKSize + kSigmaParamRandomNumberSize + kP256_PublicKey_Length + kSHA256_Hash_Length];
-
-    chip::Platform::ScopedMemoryBuffer<uint8_t> msg_R2_Encrypted;
-    size_t msg_r2_encrypted_len          = 0;
-    size_t msg_r2_encrypted_len_with_tag = 0;
-
-    chip::Platform::ScopedMemoryBuffer<uint8_t> msg_R2_Signed;
-    size_t msg_r2_signed_len;
-
-    uint8_t sr2k[CHIP_CRYPTO_SYMMETRIC_KEY_LENGTH_BYTES];
-
-    P256ECDSASignature tbsData2Signature;
-
-    P256PublicKey remoteCredential;
-
     uint8_t responderRandom[kSigmaParamRandomNumberSize];
-    ByteSpan responderNOC;
-    ByteSpan responderICAC;
 
     uint16_t responderSessionId;
 
@@ -789,110 +934,137 @@ CHIP_ERROR CASESession::HandleSigma2(System::PacketBufferHandle && msg)
     VerifyOrExit(TLV::TagNumFromTag(tlvReader.GetTag()) == ++decodeTagIdSeq, err = CHIP_ERROR_INVALID_TLV_TAG);
     SuccessOrExit(err = tlvReader.GetBytes(mRemotePubKey, static_cast<uint32_t>(mRemotePubKey.Length())));
 
+    // The S2K key salt covers the transcript up to Sigma1
+    {
+        MutableByteSpan saltSpan(mSigma2Salt);
+        SuccessOrExit(err = ConstructSaltSigma2(ByteSpan(responderRandom), mRemotePubKey, ByteSpan(mIPK), saltSpan));
+        mSigma2SaltLength = saltSpan.size();
+    }
+
+    SuccessOrExit(err = mCommissioningHash.AddData(ByteSpan{ buf, buflen }));
+
+    // Retrieve the encrypted data, which ValidateSigma2 decrypts
+    SuccessOrExit(err = tlvReader.Next());
+    VerifyOrExit(TLV::TagNumFromTag(tlvReader.GetTag()) == ++decodeTagIdSeq, err = CHIP_ERROR_INVALID_TLV_TAG);
+    mTBEDataLength = tlvReader.GetLength();
+    VerifyOrExit(mTBEDataLength > CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES, err = CHIP_ERROR_INVALID_TLV_ELEMENT);
+    VerifyOrExit(mTBEData.Alloc(mTBEDataLength), err = CHIP_ERROR_NO_MEMORY);
+    SuccessOrExit(err = tlvReader.GetBytes(mTBEData.Get(), static_cast<uint32_t>(mTBEDataLength)));
+
+    // Retrieve responderMRPParams if present
+    if (tlvReader.Next() != CHIP_END_OF_TLV)
+    {
+        SuccessOrExit(err = DecodeMRPParametersIfPresent(TLV::ContextTag(5), tlvReader));
+    }
+
+    SuccessOrExit(err = RunCryptoStep(&CASESession::ValidateSigma2_and_GenerateSigma3, &CASESession::SendSigma3));
+    return CHIP_NO_ERROR;
+
+exit:
+    if (err != CHIP_NO_ERROR)
+    {
+        SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
+    }
+    return err;
+}
+
+CHIP_ERROR CASESession::ValidateSigma2_and_GenerateSigma3()
+{
+    ReturnErrorOnFailure(ValidateSigma2());
+    ReturnErrorOnFailure(GenerateSigma3());
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CASESession::ValidateSigma2()
+{
+    TRACE_EVENT_SCOPE("ValidateSigma2", "CASESession");
+    TLV::TLVReader decryptedDataTlvReader;
+    TLV::TLVType containerType = TLV::kTLVType_Structure;
+
+    size_t msg_r2_encrypted_len = mTBEDataLength - CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES;
+
+    chip::Platform::ScopedMemoryBuffer<uint8_t> msg_R2_Signed;
+    size_t msg_r2_signed_len;
+
+    uint8_t sr2k[CHIP_CRYPTO_SYMMETRIC_KEY_LENGTH_BYTES];
+
+    P256ECDSASignature tbsData2Signature;
+
+    P256PublicKey remoteCredential;
+
+    ByteSpan responderNOC;
+    ByteSpan responderICAC;
+
     // Generate a Shared Secret
-    SuccessOrExit(err = mEphemeralKey.ECDH_derive_secret(mRemotePubKey, mSharedSecret));
+    ReturnErrorOnFailure(mEphemeralKey.ECDH_derive_secret(mRemotePubKey, mSharedSecret));
 
     // Generate the S2K key
     {
-        MutableByteSpan saltSpan(msg_salt);
-        err = ConstructSaltSigma2(ByteSpan(responderRandom), mRemotePubKey, ByteSpan(mIPK), saltSpan);
-        SuccessOrExit(err);
-
         HKDF_sha_crypto mHKDF;
-        err = mHKDF.HKDF_SHA256(mSharedSecret, mSharedSecret.Length(), saltSpan.data(), saltSpan.size(), kKDFSR2Info,
-                                kKDFInfoLength, sr2k, CHIP_CRYPTO_SYMMETRIC_KEY_LENGTH_BYTES);
-        SuccessOrExit(err);
+        ReturnErrorOnFailure(mHKDF.HKDF_SHA256(mSharedSecret, mSharedSecret.Length(), mSigma2Salt, mSigma2SaltLength, kKDFSR2Info,
+                                               kKDFInfoLength, sr2k, CHIP_CRYPTO_SYMMETRIC_KEY_LENGTH_BYTES));
     }
 
-    SuccessOrExit(err = mCommissioningHash.AddData(ByteSpan{ buf, buflen }));
-
     // Generate decrypted data
-    SuccessOrExit(err = tlvReader.Next());
-    VerifyOrExit(TLV::TagNumFromTag(tlvReader.GetTag()) == ++decodeTagIdSeq, err = CHIP_ERROR_INVALID_TLV_TAG);
-    VerifyOrExit(msg_R2_Encrypted.Alloc(tlvReader.GetLength()), err = CHIP_ERROR_NO_MEMORY);
-    msg_r2_encrypted_len_with_tag = tlvReader.GetLength();
-    VerifyOrExit(msg_r2_encrypted_len_with_tag > CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES, err = CHIP_ERROR_INVALID_TLV_ELEMENT);
-    SuccessOrExit(err = tlvReader.GetBytes(msg_R2_Encrypted.Get(), static_cast<uint32_t>(msg_r2_encrypted_len_with_tag)));
-    msg_r2_encrypted_len = msg_r2_encrypted_len_with_tag - CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES;
-
-    SuccessOrExit(err = AES_CCM_decrypt(msg_R2_Encrypted.Get(), msg_r2_encrypted_len, nullptr, 0,
-                                        msg_R2_Encrypted.Get() + msg_r2_encrypted_len, CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES, sr2k,
-                                        CHIP_CRYPTO_SYMMETRIC_KEY_LENGTH_BYTES, kTBEData2_Nonce, kTBEDataNonceLength,
-                                        msg_R2_Encrypted.Get()));
-
-    decryptedDataTlvReader.Init(msg_R2_Encrypted.Get(), msg_r2_encrypted_len);
-    containerType = TLV::kTLVType_Structure;
-    SuccessOrExit(err = decryptedDataTlvReader.Next(containerType, TLV::AnonymousTag()));
-    SuccessOrExit(err = decryptedDataTlvReader.EnterContainer(containerType));
-
-    SuccessOrExit(err = decryptedDataTlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_TBEData_SenderNOC)));
-    SuccessOrExit(err = decryptedDataTlvReader.Get(responderNOC));
-
-    SuccessOrExit(err = decryptedDataTlvReader.Next());
+    ReturnErrorOnFailure(AES_CCM_decrypt(mTBEData.Get(), msg_r2_encrypted_len, nullptr, 0, mTBEData.Get() + msg_r2_encrypted_len,
+                                         CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES, sr2k, CHIP_CRYPTO_SYMMETRIC_KEY_LENGTH_BYTES,
+                                         kTBEData2_Nonce, kTBEDataNonceLength, mTBEData.Get()));
+
+    decryptedDataTlvReader.Init(mTBEData.Get(), msg_r2_encrypted_len);
+    ReturnErrorOnFailure(decryptedDataTlvReader.Next(containerType, TLV::AnonymousTag()));
+    ReturnErrorOnFailure(decryptedDataTlvReader.EnterContainer(containerType));
+
+    ReturnErrorOnFailure(decryptedDataTlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_TBEData_SenderNOC)));
+    ReturnErrorOnFailure(decryptedDataTlvReader.Get(responderNOC));
+
+    ReturnErrorOnFailure(decryptedDataTlvReader.Next());
     if (TLV::TagNumFromTag(decryptedDataTlvReader.GetTag()) == kTag_TBEData_SenderICAC)
     {
-        VerifyOrExit(decryptedDataTlvReader.GetType() == TLV::kTLVType_ByteString, err = CHIP_ERROR_WRONG_TLV_TYPE);
-        SuccessOrExit(err = decryptedDataTlvReader.Get(responderICAC));
-        SuccessOrExit(err = decryptedDataTlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_TBEData_Signature)));
+        VerifyOrReturnError(decryptedDataTlvReader.GetType() == TLV::kTLVType_ByteString, CHIP_ERROR_WRONG_TLV_TYPE);
+        ReturnErrorOnFailure(decryptedDataTlvReader.Get(responderICAC));
+        ReturnErrorOnFailure(decryptedDataTlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_TBEData_Signature)));
     }
 
     // Validate responder identity located in msg_r2_encrypted
     // Constructing responder identity
-    SuccessOrExit(err = Validate_and_RetrieveResponderID(responderNOC, responderICAC, remoteCredential));
+    ReturnErrorOnFailure(Validate_and_RetrieveResponderID(responderNOC, responderICAC, remoteCredential));
 
     // Construct msg_R2_Signed and validate the signature in msg_r2_encrypted
     msg_r2_signed_len = TLV::EstimateStructOverhead(sizeof(uint16_t), responderNOC.size(), responderICAC.size(),
                                                     kP256_PublicKey_Length, kP256_PublicKey_Length);
 
-    VerifyOrExit(msg_R2_Signed.Alloc(msg_r2_signed_len), err = CHIP_ERROR_NO_MEMORY);
+    VerifyOrReturnError(msg_R2_Signed.Alloc(msg_r2_signed_len), CHIP_ERROR_NO_MEMORY);
 
-    SuccessOrExit(err = ConstructTBSData(responderNOC, responderICAC, ByteSpan(mRemotePubKey, mRemotePubKey.Length()),
-                                         ByteSpan(mEphemeralKey.Pubkey(), mEphemeralKey.Pubkey().Length()), msg_R2_Signed.Get(),
-                                         msg_r2_signed_len));
+    ReturnErrorOnFailure(ConstructTBSData(responderNOC, responderICAC, ByteSpan(mRemotePubKey, mRemotePubKey.Length()),
+                                          ByteSpan(mEphemeralKey.Pubkey(), mEphemeralKey.Pubkey().Length()), msg_R2_Signed.Get(),
+                                          msg_r2_signed_len));
 
-    VerifyOrExit(TLV::TagNumFromTag(decryptedDataTlvReader.GetTag()) == kTag_TBEData_Signature, err = CHIP_ERROR_INVALID_TLV_TAG);
-    VerifyOrExit(tbsData2Signature.Capacity() >= decryptedDataTlvReader.GetLength(), err = CHIP_ERROR_INVALID_TLV_ELEMENT);
+    VerifyOrReturnError(TLV::TagNumFromTag(decryptedDataTlvReader.GetTag()) == kTag_TBEData_Signature, CHIP_ERROR_INVALID_TLV_TAG);
+    VerifyOrReturnError(tbsData2Signature.Capacity() >= decryptedDataTlvReader.GetLength(), CHIP_ERROR_INVALID_TLV_ELEMENT);
     tbsData2Signature.SetLength(decryptedDataTlvReader.GetLength());
-    SuccessOrExit(err = decryptedDataTlvReader.GetBytes(tbsData2Signature, tbsData2Signature.Length()));
+    ReturnErrorOnFailure(decryptedDataTlvReader.GetBytes(tbsData2Signature, tbsData2Signature.Length()));
 
     // Validate signature
-    SuccessOrExit(err = remoteCredential.ECDSA_validate_msg_signature(msg_R2_Signed.Get(), msg_r2_signed_len, tbsData2Signature));
+    ReturnErrorOnFailure(remoteCredential.ECDSA_validate_msg_signature(msg_R2_Signed.Get(), msg_r2_signed_len, tbsData2Signature));
 
     // Retrieve session resumption ID
-    SuccessOrExit(err = decryptedDataTlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_TBEData_ResumptionID)));
-    SuccessOrExit(err = decryptedDataTlvReader.GetBytes(mResumptionId, static_cast<uint32_t>(sizeof(mResumptionId))));
+    ReturnErrorOnFailure(decryptedDataTlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_TBEData_ResumptionID)));
+    ReturnErrorOnFailure(decryptedDataTlvReader.GetBytes(mResumptionId, static_cast<uint32_t>(sizeof(mResumptionId))));
 
     // Retrieve peer CASE Authenticated Tags (CATs) from peer's NOC.
     {
         CATValues peerCATs;
-        SuccessOrExit(err = ExtractCATsFromOpCert(responderNOC, peerCATs));
+        ReturnErrorOnFailure(ExtractCATsFromOpCert(responderNOC, peerCATs));
         SetPeerCATs(peerCATs);
     }
 
-    // Retrieve responderMRPParams if present
-    if (tlvReader.Next() != CHIP_END_OF_TLV)
-    {
-        SuccessOrExit(err = DecodeMRPParametersIfPresent(TLV::ContextTag(5), tlvReader));
-    }
-
-exit:
-    if (err != CHIP_NO_ERROR)
-    {
-        SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
-    }
-    return err;
+    return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR CASESession::SendSigma3()
+CHIP_ERROR CASESession::GenerateSigma3()
 {
-    TRACE_EVENT_SCOPE("SendSigma3", "CASESession");
-    CHIP_ERROR err = CHIP_NO_ERROR;
-
-    MutableByteSpan messageDigestSpan(mMessageDigest);
-    System::PacketBufferHandle msg_R3;
-    size_t data_len;
-
-    chip::Platform::ScopedMemoryBuffer<uint8_t> msg_R3_Encrypted;
+    TRACE_EVENT_SCOPE("GenerateSigma3", "CASESession");
     size_t msg_r3_encrypted_len;
 
     uint8_t msg_salt[kIPKSize + kSHA256_Hash_Length];
@@ -904,147 +1076,127 @@ CHIP_ERROR CASESession::SendSigma3()
 
     P256ECDSASignature tbsData3Signature;
 
-    ChipLogDetail(SecureChannel, "Sending Sigma3");
-
     ByteSpan icaCert;
     ByteSpan nocCert;
 
-    VerifyOrExit(mFabricInfo != nullptr, err = CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(mFabricInfo != nullptr, CHIP_ERROR_INCORRECT_STATE);
 
-    SuccessOrExit(err = mFabricInfo->GetICACert(icaCert));
-    SuccessOrExit(err = mFabricInfo->GetNOCCert(nocCert));
+    ReturnErrorOnFailure(mFabricCredentials.GetICACert(icaCert));
+    ReturnErrorOnFailure(mFabricCredentials.GetNOCCert(nocCert));
 
-    SuccessOrExit(err = mFabricInfo->GetTrustedRootId(mTrustedRootId));
-    VerifyOrExit(!mTrustedRootId.empty(), err = CHIP_ERROR_INTERNAL);
+    ReturnErrorOnFailure(mFabricCredentials.GetTrustedRootId(mTrustedRootId));
+    VerifyOrReturnError(!mTrustedRootId.empty(), CHIP_ERROR_INTERNAL);
 
     // Prepare Sigma3 TBS Data Blob
     msg_r3_signed_len = TLV::EstimateStructOverhead(icaCert.size(), nocCert.size(), kP256_PublicKey_Length, kP256_PublicKey_Length);
 
-    VerifyOrExit(msg_R3_Signed.Alloc(msg_r3_signed_len), err = CHIP_ERROR_NO_MEMORY);
+    VerifyOrReturnError(msg_R3_Signed.Alloc(msg_r3_signed_len), CHIP_ERROR_NO_MEMORY);
 
-    SuccessOrExit(err = ConstructTBSData(nocCert, icaCert, ByteSpan(mEphemeralKey.Pubkey(), mEphemeralKey.Pubkey().Length()),
-                                         ByteSpan(mRemotePubKey, mRemotePubKey.Length()), msg_R3_Signed.Get(), msg_r3_signed_len));
+    ReturnErrorOnFailure(ConstructTBSData(nocCert, icaCert, ByteSpan(mEphemeralKey.Pubkey(), mEphemeralKey.Pubkey().Length()),
+                                          ByteSpan(mRemotePubKey, mRemotePubKey.Length()), msg_R3_Signed.Get(), msg_r3_signed_len));
 
     // Generate a signature
-    VerifyOrExit(mFabricInfo->GetOperationalKey() != nullptr, err = CHIP_ERROR_INCORRECT_STATE);
-    err = mFabricInfo->GetOperationalKey()->ECDSA_sign_msg(msg_R3_Signed.Get(), msg_r3_signed_len, tbsData3Signature);
-    SuccessOrExit(err);
+    VerifyOrReturnError(mFabricCredentials.GetOperationalKey() != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    ReturnErrorOnFailure(
+        mFabricCredentials.GetOperationalKey()->ECDSA_sign_msg(msg_R3_Signed.Get(), msg_r3_signed_len, tbsData3Signature));
 
     // Prepare Sigma3 TBE Data Blob
     msg_r3_encrypted_len = TLV::EstimateStructOverhead(nocCert.size(), icaCert.size(), tbsData3Signature.Length());
 
-    VerifyOrExit(msg_R3_Encrypted.Alloc(msg_r3_encrypted_len + CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES), err = CHIP_ERROR_NO_MEMORY);
+    VerifyOrReturnError(mTBEData.Alloc(msg_r3_encrypted_len + CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES), CHIP_ERROR_NO_MEMORY);
 
     {
         TLV::TLVWriter tlvWriter;
         TLV::TLVType outerContainerType = TLV::kTLVType_NotSpecified;
 
-        tlvWriter.Init(msg_R3_Encrypted.Get(), msg_r3_encrypted_len);
-        SuccessOrExit(err = tlvWriter.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerContainerType));
-        SuccessOrExit(err = tlvWriter.Put(TLV::ContextTag(kTag_TBEData_SenderNOC), nocCert));
+        tlvWriter.Init(mTBEData.Get(), msg_r3_encrypted_len);
+        ReturnErrorOnFailure(tlvWriter.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerContainerType));
+        ReturnErrorOnFailure(tlvWriter.Put(TLV::ContextTag(kTag_TBEData_SenderNOC), nocCert));
         if (!icaCert.empty())
         {
-            SuccessOrExit(err = tlvWriter.Put(TLV::ContextTag(kTag_TBEData_SenderICAC), icaCert));
+            ReturnErrorOnFailure(tlvWriter.Put(TLV::ContextTag(kTag_TBEData_SenderICAC), icaCert));
         }
-        SuccessOrExit(err = tlvWriter.PutBytes(TLV::ContextTag(kTag_TBEData_Signature), tbsData3Signature,
-                                               static_cast<uint32_t>(tbsData3Signature.Length())));
-        SuccessOrExit(err = tlvWriter.EndContainer(outerContainerType));
-        SuccessOrExit(err = tlvWriter.Finalize());
+        ReturnErrorOnFailure(tlvWriter.PutBytes(TLV::ContextTag(kTag_TBEData_Signature), tbsData3Signature,
+                                                static_cast<uint32_t>(tbsData3Signature.Length())));
+        ReturnErrorOnFailure(tlvWriter.EndContainer(outerContainerType));
+        ReturnErrorOnFailure(tlvWriter.Finalize());
         msg_r3_encrypted_len = static_cast<size_t>(tlvWriter.GetLengthWritten());
     }
 
     // Generate S3K key
     {
         MutableByteSpan saltSpan(msg_salt);
-        err = ConstructSaltSigma3(ByteSpan(mIPK), saltSpan);
-        SuccessOrExit(err);
+        ReturnErrorOnFailure(ConstructSaltSigma3(ByteSpan(mIPK), saltSpan));
 
         HKDF_sha_crypto mHKDF;
-        err = mHKDF.HKDF_SHA256(mSharedSecret, mSharedSecret.Length(), saltSpan.data(), saltSpan.size(), kKDFSR3Info,
-                                kKDFInfoLength, sr3k, CHIP_CRYPTO_SYMMETRIC_KEY_LENGTH_BYTES);
-        SuccessOrExit(err);
+        ReturnErrorOnFailure(mHKDF.HKDF_SHA256(mSharedSecret, mSharedSecret.Length(), saltSpan.data(), saltSpan.size(), kKDFSR3Info,
+                                               kKDFInfoLength, sr3k, CHIP_CRYPTO_SYMMETRIC_KEY_LENGTH_BYTES));
     }
 
     // Generated Encrypted data blob
-    err = AES_CCM_encrypt(msg_R3_Encrypted.Get(), msg_r3_encrypted_len, nullptr, 0, sr3k, CHIP_CRYPTO_SYMMETRIC_KEY_LENGTH_BYTES,
-                          kTBEData3_Nonce, kTBEDataNonceLength, msg_R3_Encrypted.Get(),
-                          msg_R3_Encrypted.Get() + msg_r3_encrypted_len, CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES);
-    SuccessOrExit(err);
+    ReturnErrorOnFailure(AES_CCM_encrypt(mTBEData.Get(), msg_r3_encrypted_len, nullptr, 0, sr3k,
+                                         CHIP_CRYPTO_SYMMETRIC_KEY_LENGTH_BYTES, kTBEData3_Nonce, kTBEDataNonceLength,
+                                         mTBEData.Get(), mTBEData.Get() + msg_r3_encrypted_len, CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES));
+    mTBEDataLength = msg_r3_encrypted_len + CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES;
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CASESession::SendSigma3()
+{
+    TRACE_EVENT_SCOPE("SendSigma3", "CASESession");
+    MutableByteSpan messageDigestSpan(mMessageDigest);
+
+    ChipLogDetail(SecureChannel, "Sending Sigma3");
 
     // Generate Sigma3 Msg
-    data_len = TLV::EstimateStructOverhead(CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES, msg_r3_encrypted_len);
+    size_t data_len = TLV::EstimateStructOverhead(mTBEDataLength);
 
-    msg_R3 = System::PacketBufferHandle::New(data_len);
-    VerifyOrExit(!msg_R3.IsNull(), err = CHIP_ERROR_NO_MEMORY);
+    System::PacketBufferHandle msg_R3 = System::PacketBufferHandle::New(data_len);
+    VerifyOrReturnError(!msg_R3.IsNull(), CHIP_ERROR_NO_MEMORY);
 
     {
         System::PacketBufferTLVWriter tlvWriter;
         TLV::TLVType outerContainerType = TLV::kTLVType_NotSpecified;
 
         tlvWriter.Init(std::move(msg_R3));
-        err = tlvWriter.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerContainerType);
-        SuccessOrExit(err);
-        err = tlvWriter.PutBytes(TLV::ContextTag(1), msg_R3_Encrypted.Get(),
-                                 static_cast<uint32_t>(msg_r3_encrypted_len + CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES));
-        SuccessOrExit(err);
-        err = tlvWriter.EndContainer(outerContainerType);
-        SuccessOrExit(err);
-        err = tlvWriter.Finalize(&msg_R3);
-        SuccessOrExit(err);
+        ReturnErrorOnFailure(tlvWriter.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerContainerType));
+        ReturnErrorOnFailure(tlvWriter.PutBytes(TLV::ContextTag(1), mTBEData.Get(), static_cast<uint32_t>(mTBEDataLength)));
+        ReturnErrorOnFailure(tlvWriter.EndContainer(outerContainerType));
+        ReturnErrorOnFailure(tlvWriter.Finalize(&msg_R3));
     }
 
-    err = mCommissioningHash.AddData(ByteSpan{ msg_R3->Start(), msg_R3->DataLength() });
-    SuccessOrExit(err);
+    ReturnErrorOnFailure(mCommissioningHash.AddData(ByteSpan{ msg_R3->Start(), msg_R3->DataLength() }));
 
     // Call delegate to send the Msg3 to peer
-    err = mExchangeCtxt->SendMessage(Protocols::SecureChannel::MsgType::CASE_Sigma3, std::move(msg_R3),
-                                     SendFlags(SendMessageFlags::kExpectResponse));
-    SuccessOrExit(err);
+    ReturnErrorOnFailure(mExchangeCtxt->SendMessage(Protocols::SecureChannel::MsgType::CASE_Sigma3, std::move(msg_R3),
+                                                    SendFlags(SendMessageFlags::kExpectResponse)));
 
     ChipLogDetail(SecureChannel, "Sent Sigma3 msg");
 
-    err = mCommissioningHash.Finish(messageDigestSpan);
-    SuccessOrExit(err);
+    ReturnErrorOnFailure(mCommissioningHash.Finish(messageDigestSpan));
 
     mState = kSentSigma3;
+    mTBEData.Free();
 
-exit:
-
-    if (err != CHIP_NO_ERROR)
-    {
-        SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
-        mState = kInitialized;
-    }
-    return err;
+    return CHIP_NO_ERROR;
 }
 
 CHIP_ERROR CASESession::HandleSigma3(System::PacketBufferHandle && msg)
 {
     TRACE_EVENT_SCOPE("HandleSigma3", "CASESession");
     CHIP_ERROR err = CHIP_NO_ERROR;
-    MutableByteSpan messageDigestSpan(mMessageDigest);
     System::PacketBufferTLVReader tlvReader;
-    TLV::TLVReader decryptedDataTlvReader;
     TLV::TLVType containerType = TLV::kTLVType_Structure;
 
     const uint8_t * buf   = msg->Start();
     const uint16_t bufLen = msg->DataLength();
 
-    chip::Platform::ScopedMemoryBuffer<uint8_t> msg_R3_Encrypted;
     size_t msg_r3_encrypted_len          = 0;
     size_t msg_r3_encrypted_len_with_tag = 0;
-    chip::Platform::ScopedMemoryBuffer<uint8_t> msg_R3_Signed;
-    size_t msg_r3_signed_len;
 
     uint8_t sr3k[CHIP_CRYPTO_SYMMETRIC_KEY_LENGTH_BYTES];
 
-    P256ECDSASignature tbsData3Signature;
-
-    P256PublicKey remoteCredential;
-
-    ByteSpan initiatorNOC;
-    ByteSpan initiatorICAC;
-
     uint8_t msg_salt[kIPKSize + kSHA256_Hash_Length];
 
     uint32_t decodeTagIdSeq = 0;
@@ -1058,10 +1210,10 @@ CHIP_ERROR CASESession::HandleSigma3(System::PacketBufferHandle && msg)
     // Fetch encrypted data
     SuccessOrExit(err = tlvReader.Next());
     VerifyOrExit(TLV::TagNumFromTag(tlvReader.GetTag()) == ++decodeTagIdSeq, err = CHIP_ERROR_INVALID_TLV_TAG);
-    VerifyOrExit(msg_R3_Encrypted.Alloc(tlvReader.GetLength()), err = CHIP_ERROR_NO_MEMORY);
+    VerifyOrExit(mTBEData.Alloc(tlvReader.GetLength()), err = CHIP_ERROR_NO_MEMORY);
     msg_r3_encrypted_len_with_tag = tlvReader.GetLength();
     VerifyOrExit(msg_r3_encrypted_len_with_tag > CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES, err = CHIP_ERROR_INVALID_TLV_ELEMENT);
-    SuccessOrExit(err = tlvReader.GetBytes(msg_R3_Encrypted.Get(), static_cast<uint32_t>(msg_r3_encrypted_len_with_tag)));
+    SuccessOrExit(err = tlvReader.GetBytes(mTBEData.Get(), static_cast<uint32_t>(msg_r3_encrypted_len_with_tag)));
     msg_r3_encrypted_len = msg_r3_encrypted_len_with_tag - CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES;
 
     // Step 1
@@ -1079,46 +1231,73 @@ CHIP_ERROR CASESession::HandleSigma3(System::PacketBufferHandle && msg)
     SuccessOrExit(err = mCommissioningHash.AddData(ByteSpan{ buf, bufLen }));
 
     // Step 2 - Decrypt data blob
-    SuccessOrExit(err = AES_CCM_decrypt(msg_R3_Encrypted.Get(), msg_r3_encrypted_len, nullptr, 0,
-                                        msg_R3_Encrypted.Get() + msg_r3_encrypted_len, CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES, sr3k,
-                                        CHIP_CRYPTO_SYMMETRIC_KEY_LENGTH_BYTES, kTBEData3_Nonce, kTBEDataNonceLength,
-                                        msg_R3_Encrypted.Get()));
+    SuccessOrExit(err = AES_CCM_decrypt(mTBEData.Get(), msg_r3_encrypted_len, nullptr, 0, mTBEData.Get() + msg_r3_encrypted_len,
+                                        CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES, sr3k, CHIP_CRYPTO_SYMMETRIC_KEY_LENGTH_BYTES,
+                                        kTBEData3_Nonce, kTBEDataNonceLength, mTBEData.Get()));
+    mTBEDataLength = msg_r3_encrypted_len;
+
+    // Steps 4 to 7 check the initiator's certificates and signature.
+    SuccessOrExit(err = RunCryptoStep(&CASESession::ValidateSigma3, &CASESession::FinishSigma3));
+    return CHIP_NO_ERROR;
+
+exit:
+    if (err != CHIP_NO_ERROR)
+    {
+        SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
+    }
+    return err;
+}
+
+CHIP_ERROR CASESession::ValidateSigma3()
+{
+    TRACE_EVENT_SCOPE("ValidateSigma3", "CASESession");
+    TLV::TLVReader decryptedDataTlvReader;
+    TLV::TLVType containerType = TLV::kTLVType_Structure;
+
+    chip::Platform::ScopedMemoryBuffer<uint8_t> msg_R3_Signed;
+    size_t msg_r3_signed_len;
+
+    P256ECDSASignature tbsData3Signature;
+
+    P256PublicKey remoteCredential;
+
+    ByteSpan initiatorNOC;
+    ByteSpan initiatorICAC;
 
-    decryptedDataTlvReader.Init(msg_R3_Encrypted.Get(), msg_r3_encrypted_len);
-    containerType = TLV::kTLVType_Structure;
-    SuccessOrExit(err = decryptedDataTlvReader.Next(containerType, TLV::AnonymousTag()));
-    SuccessOrExit(err = decryptedDataTlvReader.EnterContainer(containerType));
+    decryptedDataTlvReader.Init(mTBEData.Get(), mTBEDataLength);
+    ReturnErrorOnFailure(decryptedDataTlvReader.Next(containerType, TLV::AnonymousTag()));
+    ReturnErrorOnFailure(decryptedDataTlvReader.EnterContainer(containerType));
 
-    SuccessOrExit(err = decryptedDataTlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_TBEData_SenderNOC)));
-    SuccessOrExit(err = decryptedDataTlvReader.Get(initiatorNOC));
+    ReturnErrorOnFailure(decryptedDataTlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_TBEData_SenderNOC)));
+    ReturnErrorOnFailure(decryptedDataTlvReader.Get(initiatorNOC));
 
-    SuccessOrExit(err = decryptedDataTlvReader.Next());
+    ReturnErrorOnFailure(decryptedDataTlvReader.Next());
     if (TLV::TagNumFromTag(decryptedDataTlvReader.GetTag()) == kTag_TBEData_SenderICAC)
     {
-        VerifyOrExit(decryptedDataTlvReader.GetType() == TLV::kTLVType_ByteString, err = CHIP_ERROR_WRONG_TLV_TYPE);
-        SuccessOrExit(err = decryptedDataTlvReader.Get(initiatorICAC));
-        SuccessOrExit(err = decryptedDataTlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_TBEData_Signature)));
+        VerifyOrReturnError(decryptedDataTlvReader.GetType() == TLV::kTLVType_ByteString, CHIP_ERROR_WRONG_TLV_TYPE);
+        ReturnErrorOnFailure(decryptedDataTlvReader.Get(initiatorICAC));
+        ReturnErrorOnFailure(decryptedDataTlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_TBEData_Signature)));
     }
 
     // Step 5/6
     // Validate initiator identity located in msg->Start()
     // Constructing responder identity
-    SuccessOrExit(err = Validate_and_RetrieveResponderID(initiatorNOC, initiatorICAC, remoteCredential));
+    ReturnErrorOnFailure(Validate_and_RetrieveResponderID(initiatorNOC, initiatorICAC, remoteCredential));
 
     // Step 4 - Construct Sigma3 TBS Data
     msg_r3_signed_len = TLV::EstimateStructOverhead(sizeof(uint16_t), initiatorNOC.size(), initiatorICAC.size(),
                                                     kP256_PublicKey_Length, kP256_PublicKey_Length);
 
-    VerifyOrExit(msg_R3_Signed.Alloc(msg_r3_signed_len), err = CHIP_ERROR_NO_MEMORY);
+    VerifyOrReturnError(msg_R3_Signed.Alloc(msg_r3_signed_len), CHIP_ERROR_NO_MEMORY);
 
-    SuccessOrExit(err = ConstructTBSData(initiatorNOC, initiatorICAC, ByteSpan(mRemotePubKey, mRemotePubKey.Length()),
-                                         ByteSpan(mEphemeralKey.Pubkey(), mEphemeralKey.Pubkey().Length()), msg_R3_Signed.Get(),
-                                         msg_r3_signed_len));
+    ReturnErrorOnFailure(ConstructTBSData(initiatorNOC, initiatorICAC, ByteSpan(mRemotePubKey, mRemotePubKey.Length()),
+                                          ByteSpan(mEphemeralKey.Pubkey(), mEphemeralKey.Pubkey().Length()), msg_R3_Signed.Get(),
+                                          msg_r3_signed_len));
 
-    VerifyOrExit(TLV::TagNumFromTag(decryptedDataTlvReader.GetTag()) == kTag_TBEData_Signature, err = CHIP_ERROR_INVALID_TLV_TAG);
-    VerifyOrExit(tbsData3Signature.Capacity() >= decryptedDataTlvReader.GetLength(), err = CHIP_ERROR_INVALID_TLV_ELEMENT);
+    VerifyOrReturnError(TLV::TagNumFromTag(decryptedDataTlvReader.GetTag()) == kTag_TBEData_Signature, CHIP_ERROR_INVALID_TLV_TAG);
+    VerifyOrReturnError(tbsData3Signature.Capacity() >= decryptedDataTlvReader.GetLength(), CHIP_ERROR_INVALID_TLV_ELEMENT);
     tbsData3Signature.SetLength(decryptedDataTlvReader.GetLength());
-    SuccessOrExit(err = decryptedDataTlvReader.GetBytes(tbsData3Signature, tbsData3Signature.Length()));
+    ReturnErrorOnFailure(decryptedDataTlvReader.GetBytes(tbsData3Signature, tbsData3Signature.Length()));
 
     // TODO - Validate message signature prior to validating the received operational credentials.
     //        The op cert check requires traversal of cert chain, that is a more expensive operation.
@@ -1126,38 +1305,38 @@ CHIP_ERROR CASESession::HandleSigma3(System::PacketBufferHandle && msg)
     //        current flow of code, a malicious node can trigger a DoS style attack on the device.
     //        The same change should be made in Sigma2 processing.
     // Step 7 - Validate Signature
-    SuccessOrExit(err = remoteCredential.ECDSA_validate_msg_signature(msg_R3_Signed.Get(), msg_r3_signed_len, tbsData3Signature));
-
-    SuccessOrExit(err = mCommissioningHash.Finish(messageDigestSpan));
+    ReturnErrorOnFailure(remoteCredential.ECDSA_validate_msg_signature(msg_R3_Signed.Get(), msg_r3_signed_len, tbsData3Signature));
 
     // Retrieve peer CASE Authenticated Tags (CATs) from peer's NOC.
     {
         CATValues peerCATs;
-        SuccessOrExit(err = ExtractCATsFromOpCert(initiatorNOC, peerCATs));
+        ReturnErrorOnFailure(ExtractCATsFromOpCert(initiatorNOC, peerCATs));
         SetPeerCATs(peerCATs);
     }
 
-    SendStatusReport(mExchangeCtxt, kProtocolCodeSuccess);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CASESession::FinishSigma3()
+{
+    MutableByteSpan messageDigestSpan(mMessageDigest);
+
+    ReturnErrorOnFailure(mCommissioningHash.Finish(messageDigestSpan));
+    mTBEData.Free();
+
+    SendStatusReportAndReleaseExchange(kProtocolCodeSuccess);
 
     // TODO: Set timestamp on the new session, to allow selecting a least-recently-used session for eviction
     // on running out of session contexts.
 
     mCASESessionEstablished = true;
-
-    // Discard the exchange so that Clear() doesn't try closing it.  The
-    // exchange will handle that.
-    DiscardExchange();
+    AddToSessionResumptionCache();
 
     // Call delegate to indicate session establishment is successful
     // Do this last in case the delegate frees us.
     mDelegate->OnSessionEstablished();
 
-exit:
-    if (err != CHIP_NO_ERROR)
-    {
-        SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
-    }
-    return err;
+    return CHIP_NO_ERROR;
 }
 
 CHIP_ERROR CASESession::ConstructSaltSigma2(const ByteSpan & rand, const Crypto::P256PublicKey & pubkey, const ByteSpan & ipk,
@@ -1266,7 +1445,7 @@ CHIP_ERROR CASESession::Validate_and_RetrieveResponderID(const ByteSpan & respon
     PeerId peerId;
     FabricId rawFabricId;
     ReturnErrorOnFailure(
-        mFabricInfo->VerifyCredentials(responderNOC, responderICAC, mValidContext, peerId, rawFabricId, responderID));
+        mFabricCredentials.VerifyCredentials(responderNOC, responderICAC, mValidContext, peerId, rawFabricId, responderID));
 
     SetPeerNodeId(peerId.GetNodeId());
 
@@ -1348,6 +1527,7 @@ void CASESession::OnSuccessStatusReport()
 {
     ChipLogProgress(SecureChannel, "Success status report received. Session was established");
     mCASESessionEstablished = true;
+    AddToSessionResumptionCache();
 
     // Discard the exchange so that Clear() doesn't try closing it.  The
     // exchange will handle that.
@@ -1376,6 +1556,10 @@ CHIP_ERROR CASESession::OnFailureStatusReport(Protocols::SecureChannel::GeneralS
         err = CHIP_ERROR_NO_SHARED_TRUSTED_ROOT;
         break;
 
+    case kProtocolCodeBusy:
+        err = CHIP_ERROR_SECURITY_MANAGER_BUSY;
+        break;
+
     default:
         err = CHIP_ERROR_INTERNAL;
         break;
@@ -1502,6 +1686,9 @@ CHIP_ERROR CASESession::OnMessageReceived(ExchangeContext * ec, const PayloadHea
     Protocols::SecureChannel::MsgType msgType = static_cast<Protocols::SecureChannel::MsgType>(payloadHeader.GetMessageType());
     SuccessOrExit(err);
 
+    // Nothing but an error can arrive while a crypto step is computing our next message.
+    VerifyOrExit(mCryptoJob == nullptr, err = CHIP_ERROR_INCORRECT_STATE);
+
     // By default, CHIP_ERROR_INVALID_MESSAGE_TYPE is returned if in the current state
     // a message handler is not defined for the received message type.
     err = CHIP_ERROR_INVALID_MESSAGE_TYPE;
@@ -1573,8 +1760,11 @@ exit:
     if (err != CHIP_NO_ERROR)
     {
         // Discard the exchange so that Clear() doesn't try closing it.  The
-        // exchange will handle that.
-        DiscardExchange();
+        // exchange will handle that, unless it was kept open for a crypto step.
+        if (mCryptoJob == nullptr)
+        {
+            DiscardExchange();
+        }
         Clear();
         // Do this last in case the delegate frees us.
         mDelegate->OnSessionEstablishmentError(err);
@@ -27,12 +27,14 @@
 
 #include <credentials/CHIPCert.h>
 #include <crypto/CHIPCryptoPAL.h>
+#include <crypto/CryptoJobQueue.h>
 #if CHIP_CRYPTO_HSM
 #include <crypto/hsm/CHIPCryptoPALHsm.h>
 #endif
 #include <credentials/FabricTable.h>
 #include <lib/core/CHIPTLV.h>
 #include <lib/support/Base64.h>
+#include <lib/support/ScopedBuffer.h>
 #include <messaging/ExchangeContext.h>
 #include <messaging/ExchangeDelegate.h>
 #include <protocols/secure_channel/Constants.h>
@@ -46,6 +48,8 @@
 
 namespace chip {
 
+class CASESessionCache;
+
 constexpr uint16_t kSigmaParamRandomNumberSize = 32;
 constexpr uint16_t kTrustedRootIdSize          = Crypto::kSubjectKeyIdentifierLength;
 constexpr uint16_t kMaxTrustedRootIds          = 5;
@@ -74,7 +78,7 @@ class DLL_EXPORT CASESession : public Messaging::ExchangeDelegate, public Pairin
 public:
     CASESession();
     CASESession(CASESession &&)      = default;
-    CASESession(const CASESession &) = default;
+    CASESession(const CASESession &) = delete;
 
     virtual ~CASESession();
 
@@ -154,6 +158,14 @@ public:
      **/
     CHIP_ERROR FromCachable(const CASESessionCachable & output);
 
+    /**
+     * @brief
+     *   Resume sessions from, and record established sessions in, the given cache. A session with a
+     *   peer the cache has a record for is resumed with Sigma2Resume, without checking certificates
+     *   again. The cache must outlive the session.
+     */
+    void SetSessionResumptionCache(CASESessionCache * cache) { mSessionResumptionCache = cache; }
+
     //// ExchangeDelegate Implementation ////
     CHIP_ERROR OnMessageReceived(Messaging::ExchangeContext * ec, const PayloadHeader & payloadHeader,
                                  System::PacketBufferHandle && payload) override;
@@ -184,18 +196,44 @@ private:
 
     CHIP_ERROR Init(uint16_t mySessionId, SessionEstablishmentDelegate * delegate);
 
+    class CryptoStep;
+    using CryptoStepHandler = CHIP_ERROR (CASESession::*)();
+
+    /**
+     * Run the public-key part of a handshake step on the crypto job queue, then call the given
+     * handler on the CHIP stack thread to send the next message. A failure of either aborts the
+     * handshake. This must be the last thing the caller does on success, since the handshake may
+     * already have ended, and the delegate freed this object, by the time it returns.
+     */
+    CHIP_ERROR RunCryptoStep(CryptoStepHandler work, CryptoStepHandler done);
+    void OnCryptoStepComplete(CHIP_ERROR err, CryptoStepHandler done);
+
+    // Send a final status report, and give up the exchange whether or not it could be sent.
+    void SendStatusReportAndReleaseExchange(uint16_t protocolCode);
+
+    // Steps whose names start with Generate or Validate run on the crypto job queue.
     CHIP_ERROR SendSigma1();
     CHIP_ERROR HandleSigma1_and_SendSigma2(System::PacketBufferHandle && msg);
     CHIP_ERROR HandleSigma1(System::PacketBufferHandle && msg);
+    CHIP_ERROR GenerateSigma2();
     CHIP_ERROR SendSigma2();
     CHIP_ERROR HandleSigma2_and_SendSigma3(System::PacketBufferHandle && msg);
     CHIP_ERROR HandleSigma2(System::PacketBufferHandle && msg);
+    CHIP_ERROR ValidateSigma2_and_GenerateSigma3();
+    CHIP_ERROR ValidateSigma2();
     CHIP_ERROR HandleSigma2Resume(System::PacketBufferHandle && msg);
+    CHIP_ERROR GenerateSigma3();
     CHIP_ERROR SendSigma3();
     CHIP_ERROR HandleSigma3(System::PacketBufferHandle && msg);
+    CHIP_ERROR ValidateSigma3();
+    CHIP_ERROR FinishSigma3();
 
     CHIP_ERROR SendSigma2Resume(const ByteSpan & initiatorRandom);
 
+    CHIP_ERROR RestoreSessionState(const CASESessionCachable & cachableSession);
+    CHIP_ERROR RestoreSessionToResume(const ByteSpan & resumptionId);
+    void AddToSessionResumptionCache();
+
     CHIP_ERROR ConstructSaltSigma2(const ByteSpan & rand, const Crypto::P256PublicKey & pubkey, const ByteSpan & ipk,
                                    MutableByteSpan & salt);
     CHIP_ERROR Validate_and_RetrieveResponderID(const ByteSpan & responderNOC, const ByteSpan & responderICAC,
@@ -251,10 +289,26 @@ private:
 
     FabricTable * mFabricsTable = nullptr;
     FabricInfo * mFabricInfo    = nullptr;
+    // Copy of mFabricInfo taken when the handshake picks its fabric. The crypto steps read this instead, since
+    // they may run off the stack thread, where the fabric table can change under them.
+    FabricInfo mFabricCredentials;
 
     uint8_t mResumptionId[kCASEResumptionIDSize];
     // Sigma1 initiator random, maintained to be reused post-Sigma1, such as when generating Sigma2 S2RK key
     uint8_t mInitiatorRandom[kSigmaParamRandomNumberSize];
+    // Sigma2 responder random, generated by the responder in one handshake step and sent in the next
+    uint8_t mResponderRandom[kSigmaParamRandomNumberSize];
+    // S2K key salt, which the initiator computes before adding Sigma2 to the transcript hash
+    uint8_t mSigma2Salt[kIPKSize + kSigmaParamRandomNumberSize + Crypto::kP256_PublicKey_Length + Crypto::kSHA256_Hash_Length];
+    size_t mSigma2SaltLength = 0;
+
+    // TBE data of the Sigma message being built or checked by a crypto step: encrypted, with its
+    // MIC, for messages being built or received, and decrypted once the receiver has checked it.
+    Platform::ScopedMemoryBuffer<uint8_t> mTBEData;
+    size_t mTBEDataLength = 0;
+
+    // The crypto step in progress, if any. No messages are handled until it completes.
+    Crypto::CryptoJob * mCryptoJob = nullptr;
 
     State mState;
 
@@ -263,6 +317,11 @@ private:
 
     Optional<ReliableMessageProtocolConfig> mLocalMRPConfig;
 
+    CASESessionCache * mSessionResumptionCache = nullptr;
+    // Whether our Sigma1 offers to resume a session, and whether the session was resumed rather than established anew.
+    bool mResumptionRequested = false;
+    bool mSessionResumed      = false;
+
 protected:
     bool mCASESessionEstablished = false;
 
@@ -17,89 +17,411 @@
 
 #include <protocols/secure_channel/CASESessionCache.h>
 
+#include <crypto/CHIPCryptoPAL.h>
+#include <lib/core/CHIPEncoding.h>
+#include <lib/core/CHIPTLV.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/DefaultStorageKeyAllocator.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <string.h>
+
 namespace chip {
 
+namespace {
+
+// Tags of the TLV structure a record is stored as. Integers are stored in host order.
+constexpr TLV::Tag kTagResumptionID = TLV::ContextTag(1);
+constexpr TLV::Tag kTagSharedSecret = TLV::ContextTag(2);
+constexpr TLV::Tag kTagFabricIndex  = TLV::ContextTag(3);
+constexpr TLV::Tag kTagPeerNodeId   = TLV::ContextTag(4);
+constexpr TLV::Tag kTagPeerCATs     = TLV::ContextTag(5);
+constexpr TLV::Tag kTagSequence     = TLV::ContextTag(6);
+constexpr TLV::Tag kTagTimeStamp    = TLV::ContextTag(7);
+
+constexpr size_t kMaxSerializedSize =
+    TLV::EstimateStructOverhead(kCASEResumptionIDSize, Crypto::kMax_ECDH_Secret_Length, sizeof(FabricIndex), sizeof(NodeId),
+                                TLV::EstimateStructOverhead() + kMaxSubjectCATAttributeCount * (sizeof(CASEAuthTag) + 4u),
+                                sizeof(uint32_t), sizeof(uint64_t));
+
+// CASESessionCachable keeps its integers in little-endian order.
+NodeId PeerNodeIdOf(const CASESessionCachable & session)
+{
+    return Encoding::LittleEndian::HostSwap64(session.mPeerNodeId);
+}
+
+int ComparePeer(const CASESessionCachable & session, FabricIndex fabricIndex, NodeId peerNodeId)
+{
+    if (session.mLocalFabricIndex != fabricIndex)
+    {
+        return session.mLocalFabricIndex < fabricIndex ? -1 : 1;
+    }
+    const NodeId nodeId = PeerNodeIdOf(session);
+    if (nodeId != peerNodeId)
+    {
+        return nodeId < peerNodeId ? -1 : 1;
+    }
+    return 0;
+}
+
+} // namespace
+
 CASESessionCache::CASESessionCache() {}
 
 CASESessionCache::~CASESessionCache()
 {
-    mCachePool.ForEachActiveObject([&](auto * ec) {
-        mCachePool.ReleaseObject(ec);
-        return Loop::Continue;
-    });
+    for (Entry & entry : mEntries)
+    {
+        Crypto::ClearSecretData(entry.mSession.mSharedSecret, sizeof(entry.mSession.mSharedSecret));
+    }
 }
 
-CASESessionCachable * CASESessionCache::GetLRUSession()
+CHIP_ERROR CASESessionCache::Init(PersistentStorageDelegate * storage)
 {
-    uint64_t minTimeStamp            = UINT64_MAX;
-    CASESessionCachable * lruSession = nullptr;
-    mCachePool.ForEachActiveObject([&](auto * ec) {
-        if (minTimeStamp > ec->mSessionSetupTimeStamp)
+    VerifyOrReturnError(storage != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    while (mCount > 0)
+    {
+        Release(mByResumptionID[0]);
+    }
+    mStorage      = storage;
+    mNextSequence = 1;
+
+    for (size_t slot = 0; slot < kCacheSize; slot++)
+    {
+        CHIP_ERROR err = Load(slot);
+        if (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+        {
+            continue;
+        }
+        if (err != CHIP_NO_ERROR)
+        {
+            // A record that can't be read can't be resumed either, so drop it rather than fail.
+            ChipLogError(SecureChannel, "Dropping unreadable CASE resumption record %u: %" CHIP_ERROR_FORMAT,
+                         static_cast<unsigned>(slot), err.Format());
+            Crypto::ClearSecretData(mEntries[slot].mSession.mSharedSecret, sizeof(mEntries[slot].mSession.mSharedSecret));
+            Delete(slot);
+            continue;
+        }
+
+        Insert(slot);
+        if (mEntries[slot].mSequence >= mNextSequence)
         {
-            minTimeStamp = ec->mSessionSetupTimeStamp;
-            lruSession   = ec;
+            mNextSequence = mEntries[slot].mSequence + 1;
         }
-        return Loop::Continue;
-    });
-    return lruSession;
+    }
+
+    ChipLogProgress(SecureChannel, "Loaded %u CASE resumption records", static_cast<unsigned>(mCount));
+    return CHIP_NO_ERROR;
 }
 
 CHIP_ERROR CASESessionCache::Add(CASESessionCachable & cachableSession)
 {
-    // It's not an error if a device doesn't have cache for storing the sessions.
-    VerifyOrReturnError(mCachePool.Capacity() > 0, CHIP_NO_ERROR);
+    const FabricIndex fabricIndex = cachableSession.mLocalFabricIndex;
+    const NodeId peerNodeId       = PeerNodeIdOf(cachableSession);
+    size_t slot                   = kCacheSize;
+
+    // Resumption IDs are random, so this only happens if the same record is added twice.
+    ReturnErrorOnFailure(Remove(ResumptionID(cachableSession.mResumptionId)));
 
-    // If the cache is full, get the least recently used session index and release that.
-    if (mCachePool.Allocated() >= kCacheSize)
+    // A newer session with a peer replaces the older one. Otherwise room is made by evicting the
+    // least recently used record, of this fabric if it is at its limit.
+    Position existing = FindPeer(fabricIndex, peerNodeId);
+    Range fabric      = FindFabric(fabricIndex);
+    if (existing.mFound)
     {
-        mCachePool.ReleaseObject(GetLRUSession());
+        slot = mByPeer[existing.mIndex];
+    }
+    else if (fabric.mEnd - fabric.mBegin >= kMaxPerFabric)
+    {
+        slot = FindLRUSlot(fabric);
+    }
+    else if (mCount >= kCacheSize)
+    {
+        slot = FindLRUSlot(Range{ 0, mCount });
     }
 
-    mCachePool.CreateObject(cachableSession);
-    return CHIP_NO_ERROR;
+    if (slot < kCacheSize)
+    {
+        Release(slot);
+    }
+    for (size_t i = 0; slot == kCacheSize && i < kCacheSize; i++)
+    {
+        if (!mEntries[i].mInUse)
+        {
+            slot = i;
+        }
+    }
+    VerifyOrReturnError(slot < kCacheSize, CHIP_ERROR_INTERNAL);
+
+    mEntries[slot].mSession  = cachableSession;
+    mEntries[slot].mSequence = mNextSequence++;
+    Insert(slot);
+
+    return Save(slot);
 }
 
 CHIP_ERROR CASESessionCache::Remove(ResumptionID resumptionID)
 {
-    CHIP_ERROR err = CHIP_NO_ERROR;
-    CASESession session;
-    mCachePool.ForEachActiveObject([&](auto * ec) {
-        if (resumptionID.data_equal(ResumptionID(ec->mResumptionId)))
+    Position position = FindResumptionID(resumptionID);
+    VerifyOrReturnError(position.mFound, CHIP_NO_ERROR);
+
+    const size_t slot = mByResumptionID[position.mIndex];
+    Release(slot);
+    return Delete(slot);
+}
+
+CHIP_ERROR CASESessionCache::Get(ResumptionID resumptionID, CASESessionCachable & outSessionCachable)
+{
+    Position position = FindResumptionID(resumptionID);
+    VerifyOrReturnError(position.mFound, CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+
+    outSessionCachable = mEntries[mByResumptionID[position.mIndex]].mSession;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CASESessionCache::Get(FabricIndex fabricIndex, NodeId peerNodeId, CASESessionCachable & outSessionCachable)
+{
+    Position position = FindPeer(fabricIndex, peerNodeId);
+    VerifyOrReturnError(position.mFound, CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+
+    outSessionCachable = mEntries[mByPeer[position.mIndex]].mSession;
+    return CHIP_NO_ERROR;
+}
+
+void CASESessionCache::RemoveFabric(FabricIndex fabricIndex)
+{
+    for (Range range = FindFabric(fabricIndex); range.mBegin < range.mEnd; range.mEnd--)
+    {
+        const size_t slot = mByPeer[range.mBegin];
+        Release(slot);
+        Delete(slot);
+    }
+}
+
+CASESessionCache::Position CASESessionCache::FindResumptionID(const ByteSpan & resumptionID) const
+{
+    size_t low  = 0;
+    size_t high = mCount;
+    while (low < high)
+    {
+        const size_t middle = low + (high - low) / 2;
+        const int order     = memcmp(mEntries[mByResumptionID[middle]].mSession.mResumptionId, resumptionID.data(),
+                                 kCASEResumptionIDSize);
+        if (order == 0)
+        {
+            return { middle, true };
+        }
+        if (order < 0)
         {
-            mCachePool.ReleaseObject(ec);
+            low = middle + 1;
         }
-        return Loop::Continue;
-    });
+        else
+        {
+            high = middle;
+        }
+    }
+    return { low, false };
+}
 
-    return err;
+CASESessionCache::Position CASESessionCache::FindPeer(FabricIndex fabricIndex, NodeId peerNodeId) const
+{
+    size_t low  = 0;
+    size_t high = mCount;
+    while (low < high)
+    {
+        const size_t middle = low + (high - low) / 2;
+        const int order     = ComparePeer(mEntries[mByPeer[middle]].mSession, fabricIndex, peerNodeId);
+        if (order == 0)
+        {
+            return { middle, true };
+        }
+        if (order < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return { low, false };
 }
 
-CHIP_ERROR CASESessionCache::Get(ResumptionID resumptionID, CASESessionCachable & outSessionCachable)
+CASESessionCache::Range CASESessionCache::FindFabric(FabricIndex fabricIndex) const
+{
+    // No node ID is below 0, so the fabric's records start where its first one would be inserted.
+    Range range;
+    range.mBegin = FindPeer(fabricIndex, 0).mIndex;
+    range.mEnd   = range.mBegin;
+    while (range.mEnd < mCount && mEntries[mByPeer[range.mEnd]].mSession.mLocalFabricIndex == fabricIndex)
+    {
+        range.mEnd++;
+    }
+    return range;
+}
+
+size_t CASESessionCache::FindLRUSlot(Range range) const
 {
-    CHIP_ERROR err = CHIP_NO_ERROR;
-    bool found     = false;
-    mCachePool.ForEachActiveObject([&](auto * ec) {
-        if (resumptionID.data_equal(ResumptionID(ec->mResumptionId)))
+    size_t lruSlot = mByPeer[range.mBegin];
+    for (size_t i = range.mBegin + 1; i < range.mEnd; i++)
+    {
+        if (mEntries[mByPeer[i]].mSequence < mEntries[lruSlot].mSequence)
         {
-            found              = true;
-            outSessionCachable = *ec;
-            return Loop::Break;
+            lruSlot = mByPeer[i];
         }
-        return Loop::Continue;
-    });
+    }
+    return lruSlot;
+}
+
+void CASESessionCache::Insert(size_t slot)
+{
+    const CASESessionCachable & session = mEntries[slot].mSession;
+
+    const size_t idIndex = FindResumptionID(ByteSpan(session.mResumptionId)).mIndex;
+    memmove(&mByResumptionID[idIndex + 1], &mByResumptionID[idIndex], mCount - idIndex);
+    mByResumptionID[idIndex] = static_cast<uint8_t>(slot);
+
+    const size_t peerIndex = FindPeer(session.mLocalFabricIndex, PeerNodeIdOf(session)).mIndex;
+    memmove(&mByPeer[peerIndex + 1], &mByPeer[peerIndex], mCount - peerIndex);
+    mByPeer[peerIndex] = static_cast<uint8_t>(slot);
+
+    mEntries[slot].mInUse = true;
+    mCount++;
+}
+
+void CASESessionCache::Release(size_t slot)
+{
+    CASESessionCachable & session = mEntries[slot].mSession;
+
+    const size_t idIndex = FindResumptionID(ByteSpan(session.mResumptionId)).mIndex;
+    memmove(&mByResumptionID[idIndex], &mByResumptionID[idIndex + 1], mCount - idIndex - 1);
+
+    const size_t peerIndex = FindPeer(session.mLocalFabricIndex, PeerNodeIdOf(session)).mIndex;
+    memmove(&mByPeer[peerIndex], &mByPeer[peerIndex + 1], mCount - peerIndex - 1);
+
+    mCount--;
+    mEntries[slot].mInUse = false;
+    Crypto::ClearSecretData(session.mSharedSecret, sizeof(session.mSharedSecret));
+}
+
+CHIP_ERROR CASESessionCache::Save(size_t slot)
+{
+    VerifyOrReturnError(mStorage != nullptr, CHIP_NO_ERROR);
+
+    const Entry & entry                 = mEntries[slot];
+    const CASESessionCachable & session = entry.mSession;
+    const uint16_t sharedSecretLen      = Encoding::LittleEndian::HostSwap16(session.mSharedSecretLen);
+    VerifyOrReturnError(sharedSecretLen <= sizeof(session.mSharedSecret), CHIP_ERROR_INVALID_ARGUMENT);
 
-    if (!found)
+    uint8_t buffer[kMaxSerializedSize];
+    TLV::TLVWriter writer;
+    TLV::TLVType outerType;
+    TLV::TLVType arrayType;
+    writer.Init(buffer, sizeof(buffer));
+
+    ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerType));
+    ReturnErrorOnFailure(writer.Put(kTagResumptionID, ByteSpan(session.mResumptionId)));
+    ReturnErrorOnFailure(writer.Put(kTagSharedSecret, ByteSpan(session.mSharedSecret, sharedSecretLen)));
+    ReturnErrorOnFailure(writer.Put(kTagFabricIndex, session.mLocalFabricIndex));
+    ReturnErrorOnFailure(writer.Put(kTagPeerNodeId, PeerNodeIdOf(session)));
+    ReturnErrorOnFailure(writer.StartContainer(kTagPeerCATs, TLV::kTLVType_Array, arrayType));
+    for (CASEAuthTag cat : session.mPeerCATs.values)
     {
-        err = CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND;
+        ReturnErrorOnFailure(writer.Put(TLV::AnonymousTag(), Encoding::LittleEndian::HostSwap32(cat)));
     }
+    ReturnErrorOnFailure(writer.EndContainer(arrayType));
+    ReturnErrorOnFailure(writer.Put(kTagSequence, entry.mSequence));
+    ReturnErrorOnFailure(writer.Put(kTagTimeStamp, Encoding::LittleEndian::HostSwap64(session.mSessionSetupTimeStamp)));
+    ReturnErrorOnFailure(writer.EndContainer(outerType));
 
+    DefaultStorageKeyAllocator key;
+    CHIP_ERROR err = mStorage->SyncSetKeyValue(key.CASESessionResumption(slot), buffer,
+                                               static_cast<uint16_t>(writer.GetLengthWritten()));
+    Crypto::ClearSecretData(buffer, sizeof(buffer));
     return err;
 }
 
-CHIP_ERROR CASESessionCache::Get(const PeerId & peer, CASESessionCachable & outSessionCachable)
+CHIP_ERROR CASESessionCache::Load(size_t slot)
 {
-    // TODO: Implement this based on peer id
+    uint8_t buffer[kMaxSerializedSize];
+    uint16_t size = sizeof(buffer);
+    DefaultStorageKeyAllocator key;
+    ReturnErrorOnFailure(mStorage->SyncGetKeyValue(key.CASESessionResumption(slot), buffer, size));
+
+    TLV::TLVReader reader;
+    reader.Init(buffer, size);
+    CHIP_ERROR err = Deserialize(reader, mEntries[slot]);
+    Crypto::ClearSecretData(buffer, sizeof(buffer));
+    ReturnErrorOnFailure(err);
+
+    // The indexes hold one record per resumption ID and per peer.
+    const CASESessionCachable & session = mEntries[slot].mSession;
+    VerifyOrReturnError(!FindResumptionID(ByteSpan(session.mResumptionId)).mFound, CHIP_ERROR_DUPLICATE_KEY_ID);
+    VerifyOrReturnError(!FindPeer(session.mLocalFabricIndex, PeerNodeIdOf(session)).mFound, CHIP_ERROR_DUPLICATE_KEY_ID);
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR CASESessionCache::Deserialize(TLV::TLVReader & reader, Entry & entry)
+{
+    CASESessionCachable & session = entry.mSession;
+    TLV::TLVType outerType;
+    TLV::TLVType arrayType;
+    ByteSpan resumptionID;
+    ByteSpan sharedSecret;
+    NodeId peerNodeId;
+    uint64_t timeStamp;
+
+    session = CASESessionCachable();
+
+    ReturnErrorOnFailure(reader.Next(TLV::kTLVType_Structure, TLV::AnonymousTag()));
+    ReturnErrorOnFailure(reader.EnterContainer(outerType));
+
+    ReturnErrorOnFailure(reader.Next(kTagResumptionID));
+    ReturnErrorOnFailure(reader.Get(resumptionID));
+    VerifyOrReturnError(resumptionID.size() == kCASEResumptionIDSize, CHIP_ERROR_INVALID_TLV_ELEMENT);
+    memcpy(session.mResumptionId, resumptionID.data(), kCASEResumptionIDSize);
+
+    ReturnErrorOnFailure(reader.Next(kTagSharedSecret));
+    ReturnErrorOnFailure(reader.Get(sharedSecret));
+    VerifyOrReturnError(sharedSecret.size() <= sizeof(session.mSharedSecret), CHIP_ERROR_INVALID_TLV_ELEMENT);
+    memcpy(session.mSharedSecret, sharedSecret.data(), sharedSecret.size());
+    session.mSharedSecretLen = Encoding::LittleEndian::HostSwap16(static_cast<uint16_t>(sharedSecret.size()));
+
+    ReturnErrorOnFailure(reader.Next(kTagFabricIndex));
+    ReturnErrorOnFailure(reader.Get(session.mLocalFabricIndex));
+
+    ReturnErrorOnFailure(reader.Next(kTagPeerNodeId));
+    ReturnErrorOnFailure(reader.Get(peerNodeId));
+    session.mPeerNodeId = Encoding::LittleEndian::HostSwap64(peerNodeId);
+
+    ReturnErrorOnFailure(reader.Next(TLV::kTLVType_Array, kTagPeerCATs));
+    ReturnErrorOnFailure(reader.EnterContainer(arrayType));
+    for (CASEAuthTag & cat : session.mPeerCATs.values)
+    {
+        ReturnErrorOnFailure(reader.Next(TLV::AnonymousTag()));
+        ReturnErrorOnFailure(reader.Get(cat));
+        cat = Encoding::LittleEndian::HostSwap32(cat);
+    }
+    ReturnErrorOnFailure(reader.ExitContainer(arrayType));
+
+    ReturnErrorOnFailure(reader.Next(kTagSequence));
+    ReturnErrorOnFailure(reader.Get(entry.mSequence));
+
+    ReturnErrorOnFailure(reader.Next(kTagTimeStamp));
+    ReturnErrorOnFailure(reader.Get(timeStamp));
+    session.mSessionSetupTimeStamp = Encoding::LittleEndian::HostSwap64(timeStamp);
+
+    return reader.ExitContainer(outerType);
+}
+
+CHIP_ERROR CASESessionCache::Delete(size_t slot)
+{
+    VerifyOrReturnError(mStorage != nullptr, CHIP_NO_ERROR);
+
+    DefaultStorageKeyAllocator key;
+    CHIP_ERROR err = mStorage->SyncDeleteKeyValue(key.CASESessionResumption(slot));
+    return err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND ? CHIP_NO_ERROR : err;
+}
+
 } // namespace chip
@@ -18,28 +18,95 @@
 #pragma once
 
 #include <lib/core/CHIPError.h>
-#include <lib/core/PeerId.h>
+#include <lib/core/CHIPPersistentStorageDelegate.h>
+#include <lib/core/CHIPTLV.h>
 #include <protocols/secure_channel/CASESession.h>
 
 namespace chip {
 
 using ResumptionID = FixedByteSpan<kCASEResumptionIDSize>;
 
+/**
+ * Keeps the state needed to resume CASE sessions with Sigma2Resume, indexed by resumption ID and
+ * by peer. There is at most one record per peer, and adding a record for a peer replaces the
+ * previous one. When the cache, or the part of it one fabric may use, is full, the least recently
+ * added record is evicted.
+ *
+ * Once Init() has been given persistent storage, records are written through to it and loaded
+ * back from it by Init(), so that sessions can still be resumed after a restart.
+ */
 class CASESessionCache
 {
 public:
     CASESessionCache();
     virtual ~CASESessionCache();
 
+    /**
+     * Load the records kept in the given storage, and keep them there from now on.
+     */
+    CHIP_ERROR Init(PersistentStorageDelegate * storage);
+
     CHIP_ERROR Add(CASESessionCachable & cachableSession);
     CHIP_ERROR Remove(ResumptionID resumptionID);
     CHIP_ERROR Get(ResumptionID resumptionID, CASESessionCachable & outCachableSession);
-    CHIP_ERROR Get(const PeerId & peer, CASESessionCachable & outCachableSession);
+    CHIP_ERROR Get(FabricIndex fabricIndex, NodeId peerNodeId, CASESessionCachable & outCachableSession);
+
+    /**
+     * Remove the records of every peer on the given fabric. This must be done when the fabric is
+     * removed, before its index can be reused.
+     */
+    void RemoveFabric(FabricIndex fabricIndex);
+
+    size_t Count() const { return mCount; }
 
 private:
-    static constexpr size_t kCacheSize = CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE;
-    ObjectPool<CASESessionCachable, kCacheSize> mCachePool;
-    CASESessionCachable * GetLRUSession();
+    static constexpr size_t kCacheSize    = CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE;
+    static constexpr size_t kMaxPerFabric = CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE_PER_FABRIC;
+    static_assert(kCacheSize > 0 && kCacheSize <= UINT8_MAX, "Slot numbers in the cache indexes are 8 bits");
+
+    struct Entry
+    {
+        CASESessionCachable mSession;
+        // Records are numbered in the order they were added; the lowest number is the least recently used.
+        uint32_t mSequence = 0;
+        bool mInUse        = false;
+    };
+
+    // Position of a record in mByResumptionID or mByPeer, and whether it is there.
+    struct Position
+    {
+        size_t mIndex;
+        bool mFound;
+    };
+
+    // Positions [mBegin, mEnd) in mByPeer.
+    struct Range
+    {
+        size_t mBegin;
+        size_t mEnd;
+    };
+
+    Position FindResumptionID(const ByteSpan & resumptionID) const;
+    Position FindPeer(FabricIndex fabricIndex, NodeId peerNodeId) const;
+    Range FindFabric(FabricIndex fabricIndex) const;
+    size_t FindLRUSlot(Range range) const;
+
+    void Insert(size_t slot);
+    void Release(size_t slot);
+
+    CHIP_ERROR Save(size_t slot);
+    CHIP_ERROR Load(size_t slot);
+    CHIP_ERROR Delete(size_t slot);
+    static CHIP_ERROR Deserialize(TLV::TLVReader & reader, Entry & entry);
+
+    Entry mEntries[kCacheSize];
+    // Slots of the records in use, sorted by resumption ID, and by fabric index and peer node ID.
+    uint8_t mByResumptionID[kCacheSize];
+    uint8_t mByPeer[kCacheSize];
+    size_t mCount = 0;
+
+    uint32_t mNextSequence               = 1;
+    PersistentStorageDelegate * mStorage = nullptr;
 };
 
 } // namespace chip
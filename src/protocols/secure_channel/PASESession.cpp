@@ -71,6 +71,22 @@ using PBKDF2_sha256_crypto = PBKDF2_sha256HSM;
 using PBKDF2_sha256_crypto = PBKDF2_sha256;
 #endif
 
+class PASESession::CryptoStep : public CryptoJob
+{
+public:
+    CryptoStep(PASESession & session, CryptoStepHandler work, CryptoStepHandler done) :
+        mSession(session), mWork(work), mDone(done)
+    {}
+
+    CHIP_ERROR Run() override { return (mSession.*mWork)(); }
+    void OnComplete(CHIP_ERROR err) override { mSession.OnCryptoStepComplete(err, mDone); }
+
+private:
+    PASESession & mSession;
+    CryptoStepHandler mWork;
+    CryptoStepHandler mDone;
+};
+
 PASESession::PASESession() : PairingSession(Transport::SecureSession::Type::kPASE) {}
 
 PASESession::~PASESession()
@@ -83,7 +99,17 @@ void PASESession::Clear()
 {
     // This function zeroes out and resets the memory used by the object.
     // It's done so that no security related information will be leaked.
+    if (mCryptoJob != nullptr)
+    {
+        GetCryptoJobQueue().Cancel(mCryptoJob);
+        mCryptoJob = nullptr;
+    }
+
     memset(&mPoint[0], 0, sizeof(mPoint));
+    memset(&mShare[0], 0, sizeof(mShare));
+    memset(&mConfirmation[0], 0, sizeof(mConfirmation));
+    mPeerShareLength    = 0;
+    mConfirmationLength = 0;
     memset(&mPASEVerifier, 0, sizeof(mPASEVerifier));
     memset(&mKe[0], 0, sizeof(mKe));
     mNextExpectedMsg = MsgType::PASE_PakeError;
@@ -127,6 +153,44 @@ void PASESession::DiscardExchange()
     }
 }
 
+CHIP_ERROR PASESession::RunCryptoStep(CryptoStepHandler work, CryptoStepHandler done)
+{
+    VerifyOrReturnError(mCryptoJob == nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(mExchangeCtxt != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    CryptoStep * step = Platform::New<CryptoStep>(*this, work, done);
+    VerifyOrReturnError(step != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    // Keep the exchange open until the step completes and sends the next message.
+    mExchangeCtxt->WillSendMessage();
+    mCryptoJob = step;
+    GetCryptoJobQueue().Post(step);
+
+    return CHIP_NO_ERROR;
+}
+
+void PASESession::OnCryptoStepComplete(CHIP_ERROR err, CryptoStepHandler done)
+{
+    mCryptoJob = nullptr;
+
+    if (err == CHIP_NO_ERROR)
+    {
+        err = (this->*done)();
+        VerifyOrReturn(err != CHIP_NO_ERROR);
+    }
+
+    // A status report that was sent closes the exchange. Otherwise Clear() has to close it, since it
+    // was kept open for this step.
+    if (SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam) == CHIP_NO_ERROR)
+    {
+        mExchangeCtxt = nullptr;
+    }
+    Clear();
+    ChipLogError(SecureChannel, "Failed during PASE session setup. %s", ErrorStr(err));
+    // Do this last in case the delegate frees us.
+    mDelegate->OnSessionEstablishmentError(err);
+}
+
 CHIP_ERROR PASESession::Serialize(PASESessionSerialized & output)
 {
     PASESessionSerializable serializable;
@@ -677,69 +741,74 @@ CHIP_ERROR PASESession::HandleMsg1_and_SendMsg2(System::PacketBufferHandle && ms
     TRACE_EVENT_SCOPE("HandleMsg1_and_SendMsg2", "PASESession");
     CHIP_ERROR err = CHIP_NO_ERROR;
 
-    uint8_t Y[kMAX_Point_Length];
-    size_t Y_len = sizeof(Y);
-
-    uint8_t verifier[kMAX_Hash_Length];
-    size_t verifier_len = kMAX_Hash_Length;
-
     ChipLogDetail(SecureChannel, "Received spake2p msg1");
 
     System::PacketBufferTLVReader tlvReader;
     TLV::TLVType containerType = TLV::kTLVType_Structure;
 
-    const uint8_t * X;
-    size_t X_len = 0;
-
     tlvReader.Init(std::move(msg1));
     SuccessOrExit(err = tlvReader.Next(containerType, TLV::AnonymousTag()));
     SuccessOrExit(err = tlvReader.EnterContainer(containerType));
 
     SuccessOrExit(err = tlvReader.Next());
     VerifyOrExit(TLV::TagNumFromTag(tlvReader.GetTag()) == 1, err = CHIP_ERROR_INVALID_TLV_TAG);
-    X_len = tlvReader.GetLength();
-    SuccessOrExit(err = tlvReader.GetDataPtr(X));
-    SuccessOrExit(
-        err = mSpake2p.BeginVerifier(nullptr, 0, nullptr, 0, mPASEVerifier.mW0, kSpake2p_WS_Length, mPoint, sizeof(mPoint)));
-
-    SuccessOrExit(err = mSpake2p.ComputeRoundOne(X, X_len, Y, &Y_len));
-    VerifyOrReturnError(Y_len == sizeof(Y), CHIP_ERROR_INTERNAL);
-    SuccessOrExit(err = mSpake2p.ComputeRoundTwo(X, X_len, verifier, &verifier_len));
+    VerifyOrExit(tlvReader.GetLength() <= sizeof(mPeerShare), err = CHIP_ERROR_INVALID_TLV_ELEMENT);
+    mPeerShareLength = tlvReader.GetLength();
+    SuccessOrExit(err = tlvReader.GetBytes(mPeerShare, static_cast<uint32_t>(mPeerShareLength)));
     msg1 = nullptr;
 
+    SuccessOrExit(err = RunCryptoStep(&PASESession::ComputeMsg2, &PASESession::SendMsg2));
+    return CHIP_NO_ERROR;
+
+exit:
+
+    if (err != CHIP_NO_ERROR)
     {
-        const size_t max_msg_len    = TLV::EstimateStructOverhead(Y_len, verifier_len);
-        constexpr uint8_t kPake2_pB = 1;
-        constexpr uint8_t kPake2_cB = 2;
+        SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
+    }
+    return err;
+}
 
-        System::PacketBufferHandle msg2 = System::PacketBufferHandle::New(max_msg_len);
-        VerifyOrExit(!msg2.IsNull(), err = CHIP_ERROR_NO_MEMORY);
+CHIP_ERROR PASESession::ComputeMsg2()
+{
+    TRACE_EVENT_SCOPE("ComputeMsg2", "PASESession");
+    size_t Y_len        = sizeof(mShare);
+    mConfirmationLength = sizeof(mConfirmation);
 
-        System::PacketBufferTLVWriter tlvWriter;
-        tlvWriter.Init(std::move(msg2));
+    ReturnErrorOnFailure(
+        mSpake2p.BeginVerifier(nullptr, 0, nullptr, 0, mPASEVerifier.mW0, kSpake2p_WS_Length, mPoint, sizeof(mPoint)));
 
-        TLV::TLVType outerContainerType = TLV::kTLVType_NotSpecified;
-        SuccessOrExit(err = tlvWriter.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerContainerType));
-        SuccessOrExit(err = tlvWriter.Put(TLV::ContextTag(kPake2_pB), ByteSpan(Y)));
-        SuccessOrExit(err = tlvWriter.Put(TLV::ContextTag(kPake2_cB), ByteSpan(verifier, verifier_len)));
-        SuccessOrExit(err = tlvWriter.EndContainer(outerContainerType));
-        SuccessOrExit(err = tlvWriter.Finalize(&msg2));
+    ReturnErrorOnFailure(mSpake2p.ComputeRoundOne(mPeerShare, mPeerShareLength, mShare, &Y_len));
+    VerifyOrReturnError(Y_len == sizeof(mShare), CHIP_ERROR_INTERNAL);
+    return mSpake2p.ComputeRoundTwo(mPeerShare, mPeerShareLength, mConfirmation, &mConfirmationLength);
+}
 
-        err = mExchangeCtxt->SendMessage(MsgType::PASE_Pake2, std::move(msg2), SendFlags(SendMessageFlags::kExpectResponse));
-        SuccessOrExit(err);
+CHIP_ERROR PASESession::SendMsg2()
+{
+    const size_t max_msg_len    = TLV::EstimateStructOverhead(sizeof(mShare), mConfirmationLength);
+    constexpr uint8_t kPake2_pB = 1;
+    constexpr uint8_t kPake2_cB = 2;
 
-        mNextExpectedMsg = MsgType::PASE_Pake3;
-    }
+    System::PacketBufferHandle msg2 = System::PacketBufferHandle::New(max_msg_len);
+    VerifyOrReturnError(!msg2.IsNull(), CHIP_ERROR_NO_MEMORY);
 
-    ChipLogDetail(SecureChannel, "Sent spake2p msg2");
+    System::PacketBufferTLVWriter tlvWriter;
+    tlvWriter.Init(std::move(msg2));
 
-exit:
+    TLV::TLVType outerContainerType = TLV::kTLVType_NotSpecified;
+    ReturnErrorOnFailure(tlvWriter.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerContainerType));
+    ReturnErrorOnFailure(tlvWriter.Put(TLV::ContextTag(kPake2_pB), ByteSpan(mShare)));
+    ReturnErrorOnFailure(tlvWriter.Put(TLV::ContextTag(kPake2_cB), ByteSpan(mConfirmation, mConfirmationLength)));
+    ReturnErrorOnFailure(tlvWriter.EndContainer(outerContainerType));
+    ReturnErrorOnFailure(tlvWriter.Finalize(&msg2));
 
-    if (err != CHIP_NO_ERROR)
-    {
-        SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
-    }
-    return err;
+    ReturnErrorOnFailure(
+        mExchangeCtxt->SendMessage(MsgType::PASE_Pake2, std::move(msg2), SendFlags(SendMessageFlags::kExpectResponse)));
+
+    mNextExpectedMsg = MsgType::PASE_Pake3;
+    ChipLogDetail(SecureChannel, "Sent spake2p msg2");
+
+    return CHIP_NO_ERROR;
 }
 
 CHIP_ERROR PASESession::HandleMsg2_and_SendMsg3(System::PacketBufferHandle && msg2)
@@ -934,6 +1003,9 @@ CHIP_ERROR PASESession::OnMessageReceived(ExchangeContext * exchange, const Payl
     CHIP_ERROR err = ValidateReceivedMessage(exchange, payloadHeader, std::move(msg));
     SuccessOrExit(err);
 
+    // Nothing but an error can arrive while a crypto step is computing our next message.
+    VerifyOrExit(mCryptoJob == nullptr, err = CHIP_ERROR_INCORRECT_STATE);
+
     switch (static_cast<MsgType>(payloadHeader.GetMessageType()))
     {
     case MsgType::PBKDFParamRequest:
@@ -971,8 +1043,11 @@ exit:
     if (err != CHIP_NO_ERROR)
     {
         // Discard the exchange so that Clear() doesn't try closing it.  The
-        // exchange will handle that.
-        DiscardExchange();
+        // exchange will handle that, unless it was kept open for a crypto step.
+        if (mCryptoJob == nullptr)
+        {
+            DiscardExchange();
+        }
         Clear();
         ChipLogError(SecureChannel, "Failed during PASE session setup. %s", ErrorStr(err));
         // Do this last in case the delegate frees us.
@@ -27,6 +27,7 @@
 #pragma once
 
 #include <crypto/CHIPCryptoPAL.h>
+#include <crypto/CryptoJobQueue.h>
 #if CHIP_CRYPTO_HSM
 #include <crypto/hsm/CHIPCryptoPALHsm.h>
 #endif
@@ -268,9 +269,22 @@ private:
     CHIP_ERROR SendPBKDFParamResponse(ByteSpan initiatorRandom, bool initiatorHasPBKDFParams);
     CHIP_ERROR HandlePBKDFParamResponse(System::PacketBufferHandle && msg);
 
+    class CryptoStep;
+    using CryptoStepHandler = CHIP_ERROR (PASESession::*)();
+
+    /**
+     * Run the Spake2p computation of a handshake step on the crypto job queue, then call the given
+     * handler on the CHIP stack thread to send the next message. As for CASESession, this must be
+     * the last thing the caller does on success.
+     */
+    CHIP_ERROR RunCryptoStep(CryptoStepHandler work, CryptoStepHandler done);
+    void OnCryptoStepComplete(CHIP_ERROR err, CryptoStepHandler done);
+
     CHIP_ERROR SendMsg1();
 
     CHIP_ERROR HandleMsg1_and_SendMsg2(System::PacketBufferHandle && msg);
+    CHIP_ERROR ComputeMsg2(); // Runs on the crypto job queue
+    CHIP_ERROR SendMsg2();
     CHIP_ERROR HandleMsg2_and_SendMsg3(System::PacketBufferHandle && msg);
     CHIP_ERROR HandleMsg3(System::PacketBufferHandle && msg);
 
@@ -296,6 +310,15 @@ private:
 #endif
     uint8_t mPoint[kMAX_Point_Length];
 
+    /* pA from pake1, and pB and cB for pake2, kept while pake2 is computed */
+    uint8_t mPeerShare[kMAX_Point_Length];
+    size_t mPeerShareLength = 0;
+    uint8_t mShare[kMAX_Point_Length];
+    uint8_t mConfirmation[kMAX_Hash_Length];
+    size_t mConfirmationLength = 0;
+
+    Crypto::CryptoJob * mCryptoJob = nullptr;
+
     /* w0s and w1s */
     PASEVerifier mPASEVerifier;
 
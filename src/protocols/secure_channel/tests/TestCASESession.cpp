@@ -21,22 +21,36 @@
  *      This file implements unit tests for the CASESession implementation.
  */
 
+#include <algorithm>
 #include <errno.h>
+#include <functional>
+#include <inttypes.h>
 #include <nlunit-test.h>
 
 #include <credentials/CHIPCert.h>
+#include <crypto/CryptoJobQueue.h>
 #include <lib/core/CHIPCore.h>
 #include <lib/core/CHIPSafeCasts.h>
 #include <lib/support/CHIPMem.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/ScopedBuffer.h>
+#include <lib/support/TestPersistentStorageDelegate.h>
 #include <lib/support/UnitTestRegistration.h>
 #include <messaging/tests/MessagingContext.h>
 #include <protocols/secure_channel/CASEServer.h>
 #include <protocols/secure_channel/CASESession.h>
+#include <protocols/secure_channel/CASESessionCache.h>
 #include <stdarg.h>
 #include <transport/raw/tests/NetworkTestHelpers.h>
 
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
 #include "credentials/tests/CHIPCert_test_vectors.h"
 
 using namespace chip;
@@ -98,16 +112,17 @@ protected:
 
 class TestCASEServerIPK : public CASEServer
 {
-public:
-    TestCASESessionIPK & GetSession() override { return mPairingSession; }
+protected:
+    CASESession * AllocateSession() override { return mSessions.CreateObject(); }
+    void ReleaseSession(CASESession * session) override { mSessions.ReleaseObject(static_cast<TestCASESessionIPK *>(session)); }
 
 private:
-    TestCASESessionIPK mPairingSession;
+    ObjectPool<TestCASESessionIPK, CHIP_CONFIG_CASE_SERVER_MAX_HANDSHAKES> mSessions;
 };
 
-static CHIP_ERROR InitCredentialSets()
+static CHIP_ERROR AddNode01_01Fabric(FabricTable & fabrics, FabricIndex * fabricIndex)
 {
-    FabricInfo commissionerFabric;
+    FabricInfo fabric;
 
     P256SerializedKeypair opKeysSerialized;
     memcpy((uint8_t *) (opKeysSerialized), sTestCert_Node01_01_PublicKey, sTestCert_Node01_01_PublicKey_Len);
@@ -118,32 +133,19 @@ static CHIP_ERROR InitCredentialSets()
 
     P256Keypair opKey;
     ReturnErrorOnFailure(opKey.Deserialize(opKeysSerialized));
-    ReturnErrorOnFailure(commissionerFabric.SetOperationalKeypair(&opKey));
-
-    ReturnErrorOnFailure(commissionerFabric.SetRootCert(ByteSpan(sTestCert_Root01_Chip, sTestCert_Root01_Chip_Len)));
-    ReturnErrorOnFailure(commissionerFabric.SetICACert(ByteSpan(sTestCert_ICA01_Chip, sTestCert_ICA01_Chip_Len)));
-    ReturnErrorOnFailure(commissionerFabric.SetNOCCert(ByteSpan(sTestCert_Node01_01_Chip, sTestCert_Node01_01_Chip_Len)));
-
-    ReturnErrorOnFailure(gCommissionerFabrics.AddNewFabric(commissionerFabric, &gCommissionerFabricIndex));
-
-    FabricInfo deviceFabric;
-
-    memcpy((uint8_t *) (opKeysSerialized), sTestCert_Node01_01_PublicKey, sTestCert_Node01_01_PublicKey_Len);
-    memcpy((uint8_t *) (opKeysSerialized) + sTestCert_Node01_01_PublicKey_Len, sTestCert_Node01_01_PrivateKey,
-           sTestCert_Node01_01_PrivateKey_Len);
-
-    ReturnErrorOnFailure(opKeysSerialized.SetLength(sTestCert_Node01_01_PublicKey_Len + sTestCert_Node01_01_PrivateKey_Len));
-
-    ReturnErrorOnFailure(opKey.Deserialize(opKeysSerialized));
-    ReturnErrorOnFailure(deviceFabric.SetOperationalKeypair(&opKey));
+    ReturnErrorOnFailure(fabric.SetOperationalKeypair(&opKey));
 
-    ReturnErrorOnFailure(deviceFabric.SetRootCert(ByteSpan(sTestCert_Root01_Chip, sTestCert_Root01_Chip_Len)));
-    ReturnErrorOnFailure(deviceFabric.SetICACert(ByteSpan(sTestCert_ICA01_Chip, sTestCert_ICA01_Chip_Len)));
-    ReturnErrorOnFailure(deviceFabric.SetNOCCert(ByteSpan(sTestCert_Node01_01_Chip, sTestCert_Node01_01_Chip_Len)));
+    ReturnErrorOnFailure(fabric.SetRootCert(ByteSpan(sTestCert_Root01_Chip, sTestCert_Root01_Chip_Len)));
+    ReturnErrorOnFailure(fabric.SetICACert(ByteSpan(sTestCert_ICA01_Chip, sTestCert_ICA01_Chip_Len)));
+    ReturnErrorOnFailure(fabric.SetNOCCert(ByteSpan(sTestCert_Node01_01_Chip, sTestCert_Node01_01_Chip_Len)));
 
-    ReturnErrorOnFailure(gDeviceFabrics.AddNewFabric(deviceFabric, &gDeviceFabricIndex));
+    return fabrics.AddNewFabric(fabric, fabricIndex);
+}
 
-    return CHIP_NO_ERROR;
+static CHIP_ERROR InitCredentialSets()
+{
+    ReturnErrorOnFailure(AddNode01_01Fabric(gCommissionerFabrics, &gCommissionerFabricIndex));
+    return AddNode01_01Fabric(gDeviceFabrics, &gDeviceFabricIndex);
 }
 
 void CASE_SecurePairingWaitTest(nlTestSuite * inSuite, void * inContext)
@@ -260,138 +262,638 @@ void CASE_SecurePairingHandshakeTest(nlTestSuite * inSuite, void * inContext)
     CASE_SecurePairingHandshakeTestCommon(inSuite, inContext, pairingCommissioner, delegateCommissioner);
 }
 
-class TestPersistentStorageDelegate : public PersistentStorageDelegate, public FabricStorage
+TestPersistentStorageDelegate gCommissionerStorageDelegate;
+TestPersistentStorageDelegate gDeviceStorageDelegate;
+
+TestCASEServerIPK gPairingServer;
+
+void CASE_SecurePairingHandshakeServerTest(nlTestSuite * inSuite, void * inContext)
 {
-public:
-    TestPersistentStorageDelegate()
+    TestCASESecurePairingDelegate delegateCommissioner;
+
+    auto * pairingCommissioner = chip::Platform::New<TestCASESessionIPK>();
+
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    gLoopback.mSentMessageCount = 0;
+
+    SessionIDAllocator idAllocator;
+
+    NL_TEST_ASSERT(inSuite,
+                   gPairingServer.ListenForSessionEstablishment(&ctx.GetExchangeManager(), &ctx.GetTransportMgr(), nullptr,
+                                                                &ctx.GetSecureSessionManager(), &gDeviceFabrics,
+                                                                &idAllocator) == CHIP_NO_ERROR);
+
+    ExchangeContext * contextCommissioner = ctx.NewUnauthenticatedExchangeToBob(pairingCommissioner);
+
+    FabricInfo * fabric = gCommissionerFabrics.FindFabricWithIndex(gCommissionerFabricIndex);
+    NL_TEST_ASSERT(inSuite, fabric != nullptr);
+
+    NL_TEST_ASSERT(inSuite,
+                   pairingCommissioner->EstablishSession(Transport::PeerAddress(Transport::Type::kBle), fabric, Node01_01, 0,
+                                                         contextCommissioner, &delegateCommissioner) == CHIP_NO_ERROR);
+    ctx.DrainAndServiceIO();
+
+    NL_TEST_ASSERT(inSuite, gLoopback.mSentMessageCount == 5);
+    NL_TEST_ASSERT(inSuite, delegateCommissioner.mNumPairingComplete == 1);
+
+    auto * pairingCommissioner1            = chip::Platform::New<TestCASESessionIPK>();
+    ExchangeContext * contextCommissioner1 = ctx.NewUnauthenticatedExchangeToBob(pairingCommissioner1);
+
+    NL_TEST_ASSERT(inSuite,
+                   pairingCommissioner1->EstablishSession(Transport::PeerAddress(Transport::Type::kBle), fabric, Node01_01, 0,
+                                                          contextCommissioner1, &delegateCommissioner) == CHIP_NO_ERROR);
+    ctx.DrainAndServiceIO();
+
+    chip::Platform::Delete(pairingCommissioner);
+    chip::Platform::Delete(pairingCommissioner1);
+}
+
+struct TestCASEInitiator
+{
+    TestCASESessionIPK mSession;
+    TestCASESecurePairingDelegate mDelegate;
+};
+
+// Sends the Sigma1 of each of the given initiators, without delivering any of them.
+void SendSigma1s(nlTestSuite * inSuite, TestContext & ctx, TestCASEInitiator ** initiators, size_t count)
+{
+    FabricInfo * fabric = gCommissionerFabrics.FindFabricWithIndex(gCommissionerFabricIndex);
+    NL_TEST_ASSERT(inSuite, fabric != nullptr);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        ExchangeContext * context = ctx.NewUnauthenticatedExchangeToBob(&initiators[i]->mSession);
+        NL_TEST_ASSERT(inSuite, context != nullptr);
+        NL_TEST_ASSERT(inSuite,
+                       initiators[i]->mSession.EstablishSession(Transport::PeerAddress(Transport::Type::kBle), fabric, Node01_01, 0,
+                                                                context, &initiators[i]->mDelegate) == CHIP_NO_ERROR);
+    }
+}
+
+// Starts the handshakes of the given initiators together, before any of their messages are delivered.
+void StartInitiators(nlTestSuite * inSuite, TestContext & ctx, TestCASEInitiator ** initiators, size_t count)
+{
+    SendSigma1s(inSuite, ctx, initiators, count);
+    ctx.DrainAndServiceIO();
+}
+
+void CASE_SecurePairingHandshakeServerBusyTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+    SessionIDAllocator idAllocator;
+    TestCASEServerIPK server;
+    TestCASEInitiator * initiators[2];
+
+    NL_TEST_ASSERT(inSuite,
+                   server.ListenForSessionEstablishment(&ctx.GetExchangeManager(), &ctx.GetTransportMgr(), nullptr,
+                                                        &ctx.GetSecureSessionManager(), &gDeviceFabrics,
+                                                        &idAllocator) == CHIP_NO_ERROR);
+
+    // Every initiator here shares the loopback address, so with one handshake per peer the
+    // second Sigma1 is refused while the first handshake is in progress.
+    server.SetMaxHandshakesPerPeer(1);
+    for (auto & initiator : initiators)
+    {
+        initiator = chip::Platform::New<TestCASEInitiator>();
+    }
+    StartInitiators(inSuite, ctx, initiators, 2);
+
+    NL_TEST_ASSERT(inSuite, initiators[0]->mDelegate.mNumPairingComplete == 1);
+    NL_TEST_ASSERT(inSuite, initiators[0]->mDelegate.mNumPairingErrors == 0);
+    NL_TEST_ASSERT(inSuite, initiators[1]->mDelegate.mNumPairingComplete == 0);
+    NL_TEST_ASSERT(inSuite, initiators[1]->mDelegate.mNumPairingErrors == 1);
+    NL_TEST_ASSERT(inSuite, server.GetActiveHandshakeCount() == 0);
+    NL_TEST_ASSERT(inSuite, server.GetHandshakeHighWaterMark() == 1);
+
+    // With two per peer, both go through at the same time.
+    server.SetMaxHandshakesPerPeer(2);
+    for (auto & initiator : initiators)
     {
-        memset(keys, 0, sizeof(keys));
-        memset(keysize, 0, sizeof(keysize));
-        memset(values, 0, sizeof(values));
-        memset(valuesize, 0, sizeof(valuesize));
+        chip::Platform::Delete(initiator);
+        initiator = chip::Platform::New<TestCASEInitiator>();
     }
+    StartInitiators(inSuite, ctx, initiators, 2);
+
+    NL_TEST_ASSERT(inSuite, initiators[0]->mDelegate.mNumPairingComplete == 1);
+    NL_TEST_ASSERT(inSuite, initiators[1]->mDelegate.mNumPairingComplete == 1);
+    NL_TEST_ASSERT(inSuite, server.GetActiveHandshakeCount() == 0);
+    NL_TEST_ASSERT(inSuite, server.GetHandshakeHighWaterMark() == 2);
+
+    for (auto & initiator : initiators)
+    {
+        chip::Platform::Delete(initiator);
+    }
+}
+
+/**
+ * Measures the time for kInitiatorCount initiators to establish sessions with one CASE server, when
+ * the server takes one handshake at a time and when it takes them concurrently. Each round starts
+ * every initiator still without a session; the ones refused as busy try again in the next round.
+ *
+ * The loopback transport gives all the initiators the same address, and both ends of every
+ * handshake share one table of unauthenticated sessions, so with the default pool sizes no more
+ * than two handshakes fit in a round here.
+ */
+void CASE_ConcurrentHandshakeServerTest(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr size_t kInitiatorCount = 8;
+    constexpr size_t kConcurrency    = 2;
 
-    ~TestPersistentStorageDelegate() { Cleanup(); }
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
 
-    void Cleanup()
+    for (size_t maxPerPeer = 1; maxPerPeer <= kConcurrency; maxPerPeer++)
     {
-        for (int i = 0; i < 16; i++)
+        SessionIDAllocator idAllocator;
+        TestCASEServerIPK server;
+        size_t established = 0;
+        size_t rounds      = 0;
+
+        NL_TEST_ASSERT(inSuite,
+                       server.ListenForSessionEstablishment(&ctx.GetExchangeManager(), &ctx.GetTransportMgr(), nullptr,
+                                                            &ctx.GetSecureSessionManager(), &gDeviceFabrics,
+                                                            &idAllocator) == CHIP_NO_ERROR);
+        server.SetMaxHandshakesPerPeer(maxPerPeer);
+
+        System::Clock::Microseconds64 start = System::SystemClock().GetMonotonicMicroseconds64();
+        while (established < kInitiatorCount && rounds < kInitiatorCount)
         {
-            if (keys[i] != nullptr)
+            TestCASEInitiator * initiators[kConcurrency];
+            size_t count = std::min(kConcurrency, kInitiatorCount - established);
+
+            for (size_t i = 0; i < count; i++)
             {
-                chip::Platform::MemoryFree(keys[i]);
-                keys[i] = nullptr;
+                initiators[i] = chip::Platform::New<TestCASEInitiator>();
             }
-            if (values[i] != nullptr)
+            StartInitiators(inSuite, ctx, initiators, count);
+            for (size_t i = 0; i < count; i++)
             {
-                chip::Platform::MemoryFree(values[i]);
-                values[i] = nullptr;
+                established += initiators[i]->mDelegate.mNumPairingComplete;
+                chip::Platform::Delete(initiators[i]);
             }
+            rounds++;
+        }
+        System::Clock::Microseconds64 elapsed = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+        ChipLogProgress(SecureChannel, "%u initiators, %u handshakes per peer: %u rounds, %" PRIu64 "us",
+                        static_cast<unsigned>(kInitiatorCount), static_cast<unsigned>(maxPerPeer), static_cast<unsigned>(rounds),
+                        elapsed.count());
+
+        NL_TEST_ASSERT(inSuite, established == kInitiatorCount);
+        NL_TEST_ASSERT(inSuite, rounds == kInitiatorCount / maxPerPeer);
+        NL_TEST_ASSERT(inSuite, server.GetHandshakeHighWaterMark() == maxPerPeer);
+        NL_TEST_ASSERT(inSuite, server.GetActiveHandshakeCount() == 0);
+    }
+}
+
+/**
+ * Measures event loop latency for the test below: while started, it keeps a zero-delay timer
+ * pending and records how late each one fires, which is how long a newly queued event would have
+ * waited. Crypto job completions are dispatched from the same timer, the way
+ * PlatformMgr().ScheduleWork() would dispatch them on a device.
+ */
+class EventLoopProbe
+{
+public:
+    EventLoopProbe(System::Layer & systemLayer, std::function<void()> tick) : mSystemLayer(systemLayer), mTick(tick) {}
+
+    void Start() { Schedule(); }
+
+    void Stop() { mSystemLayer.CancelTimer(OnTimer, this); }
+
+    System::Clock::Microseconds64 GetMaxLatency() const { return mMaxLatency; }
+    System::Clock::Microseconds64 GetAverageLatency() const
+    {
+        return System::Clock::Microseconds64(mSamples > 0 ? mTotalLatency.count() / mSamples : 0);
+    }
+
+private:
+    void Schedule()
+    {
+        mScheduled = System::SystemClock().GetMonotonicMicroseconds64();
+        mSystemLayer.StartTimer(System::Clock::kZero, OnTimer, this);
+    }
+
+    static void OnTimer(System::Layer *, void * context)
+    {
+        auto * probe                          = static_cast<EventLoopProbe *>(context);
+        System::Clock::Microseconds64 latency = System::SystemClock().GetMonotonicMicroseconds64() - probe->mScheduled;
+
+        probe->mMaxLatency = std::max(probe->mMaxLatency, latency);
+        probe->mTotalLatency += latency;
+        probe->mSamples++;
+
+        probe->mTick();
+        probe->Schedule();
+    }
+
+    System::Layer & mSystemLayer;
+    std::function<void()> mTick;
+    System::Clock::Microseconds64 mScheduled;
+    System::Clock::Microseconds64 mMaxLatency   = System::Clock::Microseconds64(0);
+    System::Clock::Microseconds64 mTotalLatency = System::Clock::Microseconds64(0);
+    uint64_t mSamples = 0;
+};
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+/**
+ * A crypto job queue with worker threads, like the Linux CryptoWorkerPool, except that completions
+ * wait until DispatchCompletions() is called on the test thread.
+ */
+class TestThreadedCryptoJobQueue : public Crypto::CryptoJobQueue
+{
+public:
+    void Start(size_t threadCount)
+    {
+        mShutdown = false;
+        for (size_t i = 0; i < threadCount; i++)
+        {
+            mThreads.emplace_back([this] { WorkerThread(); });
+        }
+    }
+
+    void Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mLock);
+            mShutdown = true;
+        }
+        mCondition.notify_all();
+        for (std::thread & thread : mThreads)
+        {
+            thread.join();
         }
+        mThreads.clear();
+    }
+
+    void Post(Crypto::CryptoJob * job) override
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mPending.push_back(job);
+        mCondition.notify_one();
+    }
+
+    void Cancel(Crypto::CryptoJob * job) override
+    {
+        std::unique_lock<std::mutex> lock(mLock);
+        mCondition.wait(lock, [this, job] { return std::find(mRunning.begin(), mRunning.end(), job) == mRunning.end(); });
+        mPending.erase(std::remove(mPending.begin(), mPending.end(), job), mPending.end());
+        mDone.erase(std::remove_if(mDone.begin(), mDone.end(), [job](const Done & done) { return done.mJob == job; }),
+                    mDone.end());
+        Platform::Delete(job);
     }
 
-    CHIP_ERROR SyncGetKeyValue(const char * key, void * buffer, uint16_t & size) override
+    void DispatchCompletions()
     {
-        for (int i = 0; i < 16; i++)
+        while (true)
         {
-            if (keys[i] != nullptr && keysize[i] != 0 && size >= valuesize[i])
+            Done done;
             {
-                if (memcmp(key, keys[i], keysize[i]) == 0)
+                std::lock_guard<std::mutex> lock(mLock);
+                if (mDone.empty())
                 {
-                    memcpy(buffer, values[i], valuesize[i]);
-                    size = valuesize[i];
-                    return CHIP_NO_ERROR;
+                    return;
                 }
+                done = mDone.front();
+                mDone.pop_front();
             }
+            done.mJob->OnComplete(done.mError);
+            Platform::Delete(done.mJob);
         }
-        return CHIP_ERROR_INTERNAL;
     }
 
-    CHIP_ERROR SyncSetKeyValue(const char * key, const void * value, uint16_t size) override
+private:
+    struct Done
+    {
+        Crypto::CryptoJob * mJob;
+        CHIP_ERROR mError;
+    };
+
+    void WorkerThread()
     {
-        for (int i = 0; i < 16; i++)
+        std::unique_lock<std::mutex> lock(mLock);
+        while (true)
         {
-            if (keys[i] == nullptr && keysize[i] == 0 && valuesize[i] == 0)
+            mCondition.wait(lock, [this] { return mShutdown || !mPending.empty(); });
+            if (mShutdown)
             {
-                keysize[i] = static_cast<uint16_t>(strlen(key));
-                keysize[i]++;
-                keys[i] = reinterpret_cast<char *>(chip::Platform::MemoryAlloc(keysize[i]));
-                strcpy(keys[i], key);
-                values[i] = reinterpret_cast<char *>(chip::Platform::MemoryAlloc(size));
-                memcpy(values[i], value, size);
-                valuesize[i] = size;
-                return CHIP_NO_ERROR;
+                return;
             }
+
+            Crypto::CryptoJob * job = mPending.front();
+            mPending.pop_front();
+            mRunning.push_back(job);
+
+            lock.unlock();
+            CHIP_ERROR err = job->Run();
+            lock.lock();
+
+            mRunning.erase(std::find(mRunning.begin(), mRunning.end(), job));
+            mDone.push_back({ job, err });
+            mCondition.notify_all();
         }
-        return CHIP_ERROR_INTERNAL;
     }
 
-    CHIP_ERROR SyncDeleteKeyValue(const char * key) override { return CHIP_NO_ERROR; }
+    std::mutex mLock;
+    std::condition_variable mCondition;
+    std::vector<std::thread> mThreads;
+    bool mShutdown = false;
 
-    CHIP_ERROR SyncStore(FabricIndex fabricIndex, const char * key, const void * buffer, uint16_t size) override
-    {
-        return SyncSetKeyValue(key, buffer, size);
-    };
+    std::deque<Crypto::CryptoJob *> mPending;
+    std::vector<Crypto::CryptoJob *> mRunning;
+    std::deque<Done> mDone;
+};
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+/**
+ * Starts kHandshakeCount handshakes against one CASE server at once, with the public-key work of
+ * both ends on the inline crypto job queue and then on kWorkerThreads worker threads, and logs how
+ * long events waited in the event loop while they were in flight.
+ */
+void CASE_HandshakeEventLoopLatencyTest(nlTestSuite * inSuite, void * inContext)
+{
+    // Each handshake holds a server slot, and an unauthenticated session and an exchange at both ends.
+    constexpr size_t kHandshakeCount = std::min<size_t>({ 50, CHIP_CONFIG_CASE_SERVER_MAX_HANDSHAKES,
+                                                          CHIP_CONFIG_UNAUTHENTICATED_CONNECTION_POOL_SIZE / 2,
+                                                          CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS / 2 });
+    constexpr size_t kWorkerThreads  = 2;
 
-    CHIP_ERROR SyncLoad(FabricIndex fabricIndex, const char * key, void * buffer, uint16_t & size) override
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    TestThreadedCryptoJobQueue threadedQueue;
+    Crypto::CryptoJobQueue * queues[] = { &Crypto::GetCryptoJobQueue(), &threadedQueue };
+    threadedQueue.Start(kWorkerThreads);
+#else
+    Crypto::CryptoJobQueue * queues[] = { &Crypto::GetCryptoJobQueue() };
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+    for (Crypto::CryptoJobQueue * queue : queues)
     {
-        return SyncGetKeyValue(key, buffer, size);
-    };
+        SessionIDAllocator idAllocator;
+        TestCASEServerIPK server;
+        TestCASEInitiator * initiators[kHandshakeCount];
+        size_t established = 0;
+
+        EventLoopProbe probe(ctx.GetSystemLayer(), [&] {
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+            threadedQueue.DispatchCompletions();
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+        });
+
+        NL_TEST_ASSERT(inSuite,
+                       server.ListenForSessionEstablishment(&ctx.GetExchangeManager(), &ctx.GetTransportMgr(), nullptr,
+                                                            &ctx.GetSecureSessionManager(), &gDeviceFabrics,
+                                                            &idAllocator) == CHIP_NO_ERROR);
+        // Every initiator here shares the loopback address.
+        server.SetMaxHandshakesPerPeer(kHandshakeCount);
+        Crypto::SetCryptoJobQueue(queue);
+
+        for (auto & initiator : initiators)
+        {
+            initiator = chip::Platform::New<TestCASEInitiator>();
+        }
+        // The initiators' key generation runs before the probe starts, so that only the event loop
+        // is measured.
+        SendSigma1s(inSuite, ctx, initiators, kHandshakeCount);
+        probe.Start();
+        ctx.GetIOContext().DriveIOUntil(System::Clock::Seconds16(30), [&] {
+            return std::all_of(std::begin(initiators), std::end(initiators), [](TestCASEInitiator * initiator) {
+                return initiator->mDelegate.mNumPairingComplete + initiator->mDelegate.mNumPairingErrors > 0;
+            });
+        });
+        // Deliver the acks of the last messages.
+        ctx.DrainAndServiceIO();
+        probe.Stop();
+
+        for (auto & initiator : initiators)
+        {
+            established += initiator->mDelegate.mNumPairingComplete;
+            chip::Platform::Delete(initiator);
+        }
 
-    CHIP_ERROR SyncDelete(FabricIndex fabricIndex, const char * key) override { return SyncDeleteKeyValue(key); };
+        Crypto::SetCryptoJobQueue(nullptr);
 
-private:
-    char * keys[16];
-    void * values[16];
-    uint16_t keysize[16];
-    uint16_t valuesize[16];
-};
+        ChipLogProgress(SecureChannel,
+                        "%u handshakes in flight, %s crypto: event loop latency max %" PRIu64 "us, average %" PRIu64 "us",
+                        static_cast<unsigned>(kHandshakeCount), (queue == queues[0]) ? "inline" : "threaded",
+                        probe.GetMaxLatency().count(), probe.GetAverageLatency().count());
 
-TestPersistentStorageDelegate gCommissionerStorageDelegate;
-TestPersistentStorageDelegate gDeviceStorageDelegate;
+        NL_TEST_ASSERT(inSuite, established == kHandshakeCount);
+        NL_TEST_ASSERT(inSuite, server.GetActiveHandshakeCount() == 0);
+        NL_TEST_ASSERT(inSuite, server.GetHandshakeHighWaterMark() == kHandshakeCount);
+    }
 
-TestCASEServerIPK gPairingServer;
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    threadedQueue.Stop();
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+}
 
-void CASE_SecurePairingHandshakeServerTest(nlTestSuite * inSuite, void * inContext)
+/**
+ * A crypto job queue that holds on to posted jobs until the test runs them.
+ */
+class TestDeferredCryptoJobQueue : public Crypto::CryptoJobQueue
 {
-    TestCASESecurePairingDelegate delegateCommissioner;
+public:
+    void Post(Crypto::CryptoJob * job) override { mPending.push_back(job); }
 
-    auto * pairingCommissioner = chip::Platform::New<TestCASESessionIPK>();
+    void Cancel(Crypto::CryptoJob * job) override
+    {
+        mPending.erase(std::remove(mPending.begin(), mPending.end(), job), mPending.end());
+        Platform::Delete(job);
+    }
+
+    size_t GetPendingCount() const { return mPending.size(); }
 
+    // Runs the oldest pending job and completes it. Returns false if there was none.
+    bool RunNext()
+    {
+        VerifyOrReturnError(!mPending.empty(), false);
+        Crypto::CryptoJob * job = mPending.front();
+        mPending.pop_front();
+        job->OnComplete(job->Run());
+        Platform::Delete(job);
+        return true;
+    }
+
+private:
+    std::deque<Crypto::CryptoJob *> mPending;
+};
+
+/**
+ * Removes the responder's fabric while its Sigma2 is waiting to be generated. The crypto steps work
+ * on the credentials the fabric had when the handshake started, so the handshake still completes.
+ */
+void CASE_FabricRemovedDuringCryptoStepTest(nlTestSuite * inSuite, void * inContext)
+{
     TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
 
-    gLoopback.mSentMessageCount = 0;
+    TestPersistentStorageDelegate storage;
+    FabricTable deviceFabrics;
+    FabricIndex deviceFabricIndex;
+    NL_TEST_ASSERT(inSuite, deviceFabrics.Init(&storage) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, AddNode01_01Fabric(deviceFabrics, &deviceFabricIndex) == CHIP_NO_ERROR);
 
-    SessionIDAllocator idAllocator;
+    TestDeferredCryptoJobQueue queue;
+    TestCASESecurePairingDelegate delegateCommissioner;
+    TestCASESecurePairingDelegate delegateAccessory;
+    TestCASESessionIPK pairingCommissioner;
+    TestCASESessionIPK pairingAccessory;
 
     NL_TEST_ASSERT(inSuite,
-                   gPairingServer.ListenForSessionEstablishment(&ctx.GetExchangeManager(), &ctx.GetTransportMgr(), nullptr,
-                                                                &ctx.GetSecureSessionManager(), &gDeviceFabrics,
-                                                                &idAllocator) == CHIP_NO_ERROR);
+                   ctx.GetExchangeManager().RegisterUnsolicitedMessageHandlerForType(Protocols::SecureChannel::MsgType::CASE_Sigma1,
+                                                                                     &pairingAccessory) == CHIP_NO_ERROR);
 
-    ExchangeContext * contextCommissioner = ctx.NewUnauthenticatedExchangeToBob(pairingCommissioner);
+    ExchangeContext * contextCommissioner = ctx.NewUnauthenticatedExchangeToBob(&pairingCommissioner);
 
     FabricInfo * fabric = gCommissionerFabrics.FindFabricWithIndex(gCommissionerFabricIndex);
     NL_TEST_ASSERT(inSuite, fabric != nullptr);
 
+    Crypto::SetCryptoJobQueue(&queue);
+
+    NL_TEST_ASSERT(inSuite, pairingAccessory.ListenForSessionEstablishment(0, &deviceFabrics, &delegateAccessory) == CHIP_NO_ERROR);
     NL_TEST_ASSERT(inSuite,
-                   pairingCommissioner->EstablishSession(Transport::PeerAddress(Transport::Type::kBle), fabric, Node01_01, 0,
-                                                         contextCommissioner, &delegateCommissioner) == CHIP_NO_ERROR);
+                   pairingCommissioner.EstablishSession(Transport::PeerAddress(Transport::Type::kBle), fabric, Node01_01, 0,
+                                                        contextCommissioner, &delegateCommissioner) == CHIP_NO_ERROR);
     ctx.DrainAndServiceIO();
 
-    NL_TEST_ASSERT(inSuite, gLoopback.mSentMessageCount == 5);
+    // Sigma1 was received, and Sigma2 generation is waiting in the queue.
+    NL_TEST_ASSERT(inSuite, queue.GetPendingCount() == 1);
+    NL_TEST_ASSERT(inSuite, deviceFabrics.Delete(deviceFabricIndex) == CHIP_NO_ERROR);
+
+    while (queue.RunNext())
+    {
+        ctx.DrainAndServiceIO();
+    }
+
+    Crypto::SetCryptoJobQueue(nullptr);
+
+    NL_TEST_ASSERT(inSuite, delegateAccessory.mNumPairingErrors == 0);
+    NL_TEST_ASSERT(inSuite, delegateAccessory.mNumPairingComplete == 1);
     NL_TEST_ASSERT(inSuite, delegateCommissioner.mNumPairingComplete == 1);
 
-    auto * pairingCommissioner1            = chip::Platform::New<TestCASESessionIPK>();
-    ExchangeContext * contextCommissioner1 = ctx.NewUnauthenticatedExchangeToBob(pairingCommissioner1);
+    ctx.GetExchangeManager().UnregisterUnsolicitedMessageHandlerForType(Protocols::SecureChannel::MsgType::CASE_Sigma1);
+}
 
-    NL_TEST_ASSERT(inSuite,
-                   pairingCommissioner1->EstablishSession(Transport::PeerAddress(Transport::Type::kBle), fabric, Node01_01, 0,
-                                                          contextCommissioner1, &delegateCommissioner) == CHIP_NO_ERROR);
-    ctx.DrainAndServiceIO();
+/**
+ * Establishes a session, then resumes it, with both ends keeping resumption records. The resumed
+ * session has to get the same keys at both ends.
+ */
+void CASE_SessionResumptionTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
 
-    chip::Platform::Delete(pairingCommissioner);
-    chip::Platform::Delete(pairingCommissioner1);
+    CASESessionCache initiatorCache;
+    CASESessionCache responderCache;
+
+    FabricInfo * fabric = gCommissionerFabrics.FindFabricWithIndex(gCommissionerFabricIndex);
+    NL_TEST_ASSERT(inSuite, fabric != nullptr);
+
+    for (bool resume : { false, true })
+    {
+        TestCASESecurePairingDelegate delegateInitiator;
+        TestCASESecurePairingDelegate delegateResponder;
+        TestCASESessionIPK initiator;
+        TestCASESessionIPK responder;
+        initiator.SetSessionResumptionCache(&initiatorCache);
+        responder.SetSessionResumptionCache(&responderCache);
+
+        gLoopback.mSentMessageCount = 0;
+
+        NL_TEST_ASSERT(inSuite,
+                       ctx.GetExchangeManager().RegisterUnsolicitedMessageHandlerForType(
+                           Protocols::SecureChannel::MsgType::CASE_Sigma1, &responder) == CHIP_NO_ERROR);
+        ExchangeContext * context = ctx.NewUnauthenticatedExchangeToBob(&initiator);
+
+        NL_TEST_ASSERT(inSuite, responder.ListenForSessionEstablishment(0, &gDeviceFabrics, &delegateResponder) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite,
+                       initiator.EstablishSession(Transport::PeerAddress(Transport::Type::kBle), fabric, Node01_01, 0, context,
+                                                  &delegateInitiator) == CHIP_NO_ERROR);
+        ctx.DrainAndServiceIO();
+
+        NL_TEST_ASSERT(inSuite, delegateInitiator.mNumPairingComplete == 1);
+        NL_TEST_ASSERT(inSuite, delegateResponder.mNumPairingComplete == 1);
+        // Resuming leaves out Sigma2 and Sigma3, and the ack of Sigma2 that Sigma3 carries.
+        NL_TEST_ASSERT(inSuite, gLoopback.mSentMessageCount == (resume ? 4u : 5u));
+
+        // Each end keeps one record for the other, with the resumption ID of the latest session.
+        CASESessionCachable record;
+        NL_TEST_ASSERT(inSuite, initiatorCache.Count() == 1);
+        NL_TEST_ASSERT(inSuite, responderCache.Count() == 1);
+        NL_TEST_ASSERT(inSuite, initiatorCache.Get(gCommissionerFabricIndex, Node01_01, record) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, responderCache.Get(ResumptionID(record.mResumptionId), record) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, record.mLocalFabricIndex == gDeviceFabricIndex);
+
+        CryptoContext initiatorKeys;
+        CryptoContext responderKeys;
+        NL_TEST_ASSERT(inSuite, initiator.DeriveSecureSession(initiatorKeys, CryptoContext::SessionRole::kInitiator) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, responder.DeriveSecureSession(responderKeys, CryptoContext::SessionRole::kResponder) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, initiatorKeys.GetAttestationChallenge().data_equal(responderKeys.GetAttestationChallenge()));
+
+        ctx.GetExchangeManager().UnregisterUnsolicitedMessageHandlerForType(Protocols::SecureChannel::MsgType::CASE_Sigma1);
+    }
+}
+
+/**
+ * Runs kHandshakeCount full handshakes against a CASE server, and then as many handshakes resuming
+ * the sessions they set up, and logs how long each took. The server reloads its resumption records
+ * from storage in between, as it would after a restart. All the crypto runs inline on this thread.
+ */
+void CASE_SessionResumptionBenchmark(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr size_t kHandshakeCount = 20;
+
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    chip::TestPersistentStorageDelegate serverStorage;
+    CASESessionCache initiatorCache;
+    uint32_t messageCounts[2];
+
+    for (bool resume : { false, true })
+    {
+        CASESessionCache serverCache;
+        SessionIDAllocator idAllocator;
+        TestCASEServerIPK server;
+        size_t established = 0;
+
+        NL_TEST_ASSERT(inSuite, serverCache.Init(&serverStorage) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, serverCache.Count() == (resume ? 1u : 0u));
+        server.SetSessionResumptionCache(&serverCache);
+        NL_TEST_ASSERT(inSuite,
+                       server.ListenForSessionEstablishment(&ctx.GetExchangeManager(), &ctx.GetTransportMgr(), nullptr,
+                                                            &ctx.GetSecureSessionManager(), &gDeviceFabrics,
+                                                            &idAllocator) == CHIP_NO_ERROR);
+
+        gLoopback.mSentMessageCount = 0;
+
+        System::Clock::Microseconds64 start = System::SystemClock().GetMonotonicMicroseconds64();
+        for (size_t i = 0; i < kHandshakeCount; i++)
+        {
+            TestCASEInitiator * initiator = chip::Platform::New<TestCASEInitiator>();
+            if (!resume)
+            {
+                // Forget the previous session, so that this handshake is a full one too.
+                initiatorCache.RemoveFabric(gCommissionerFabricIndex);
+            }
+            initiator->mSession.SetSessionResumptionCache(&initiatorCache);
+            StartInitiators(inSuite, ctx, &initiator, 1);
+            established += initiator->mDelegate.mNumPairingComplete;
+            chip::Platform::Delete(initiator);
+        }
+        System::Clock::Microseconds64 elapsed = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+        messageCounts[resume] = gLoopback.mSentMessageCount;
+
+        ChipLogProgress(SecureChannel, "%u %s handshakes: %" PRIu64 "us, %" PRIu64 "us each", static_cast<unsigned>(kHandshakeCount),
+                        resume ? "resumed" : "full", elapsed.count(), elapsed.count() / kHandshakeCount);
+
+        NL_TEST_ASSERT(inSuite, established == kHandshakeCount);
+        NL_TEST_ASSERT(inSuite, server.GetActiveHandshakeCount() == 0);
+    }
+
+    // Every handshake of the second run was resumed.
+    NL_TEST_ASSERT(inSuite, messageCounts[0] == kHandshakeCount * 5);
+    NL_TEST_ASSERT(inSuite, messageCounts[1] == kHandshakeCount * 4);
 }
 
 struct Sigma1Params
@@ -621,6 +1123,12 @@ static const nlTest sTests[] =
     NL_TEST_DEF("Start",       CASE_SecurePairingStartTest),
     NL_TEST_DEF("Handshake",   CASE_SecurePairingHandshakeTest),
     NL_TEST_DEF("ServerHandshake", CASE_SecurePairingHandshakeServerTest),
+    NL_TEST_DEF("ServerHandshakeBusy", CASE_SecurePairingHandshakeServerBusyTest),
+    NL_TEST_DEF("ServerConcurrentHandshakes", CASE_ConcurrentHandshakeServerTest),
+    NL_TEST_DEF("HandshakeEventLoopLatency", CASE_HandshakeEventLoopLatencyTest),
+    NL_TEST_DEF("FabricRemovedDuringCryptoStep", CASE_FabricRemovedDuringCryptoStepTest),
+    NL_TEST_DEF("SessionResumption", CASE_SessionResumptionTest),
+    NL_TEST_DEF("SessionResumptionBenchmark", CASE_SessionResumptionBenchmark),
     NL_TEST_DEF("Sigma1Parsing", CASE_Sigma1ParsingTest),
 
     NL_TEST_SENTINEL()
@@ -677,8 +1185,6 @@ int CASE_TestSecurePairing_Setup(void * inContext)
  */
 int CASE_TestSecurePairing_Teardown(void * inContext)
 {
-    gCommissionerStorageDelegate.Cleanup();
-    gDeviceStorageDelegate.Cleanup();
     gCommissionerFabrics.Reset();
     gDeviceFabrics.Reset();
     static_cast<TestContext *>(inContext)->Shutdown();
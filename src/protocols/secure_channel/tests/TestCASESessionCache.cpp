@@ -25,6 +25,9 @@
 #include <nlunit-test.h>
 
 #include <lib/core/CHIPConfig.h>
+#include <lib/core/CHIPEncoding.h>
+#include <lib/support/DefaultStorageKeyAllocator.h>
+#include <lib/support/TestPersistentStorageDelegate.h>
 #include <lib/support/UnitTestRegistration.h>
 #include <messaging/tests/MessagingContext.h>
 #include <protocols/secure_channel/CASESession.h>
@@ -43,6 +46,36 @@ uint8_t sTest_SharedSecret[] = {
 
 uint8_t sTest_ResumptionId[kCASEResumptionIDSize] = { 0 };
 
+CASESessionCachable MakeCachable(FabricIndex fabricIndex, NodeId peerNodeId, uint8_t resumptionIdByte)
+{
+    CASESessionCachable cachable;
+    cachable.mSharedSecretLen = Encoding::LittleEndian::HostSwap16(sizeof(sTest_SharedSecret));
+    memcpy(cachable.mSharedSecret, sTest_SharedSecret, sizeof(sTest_SharedSecret));
+    cachable.mSharedSecret[0]    = resumptionIdByte;
+    cachable.mLocalFabricIndex   = fabricIndex;
+    cachable.mPeerNodeId         = Encoding::LittleEndian::HostSwap64(peerNodeId);
+    cachable.mPeerCATs.values[0] = Encoding::LittleEndian::HostSwap32(0xABCD0001);
+    memset(cachable.mResumptionId, resumptionIdByte, sizeof(cachable.mResumptionId));
+    return cachable;
+}
+
+bool IsSameRecord(const CASESessionCachable & a, const CASESessionCachable & b)
+{
+    return a.mSharedSecretLen == b.mSharedSecretLen && memcmp(a.mSharedSecret, b.mSharedSecret, sizeof(a.mSharedSecret)) == 0 &&
+        a.mLocalFabricIndex == b.mLocalFabricIndex && a.mPeerNodeId == b.mPeerNodeId &&
+        memcmp(a.mPeerCATs.values, b.mPeerCATs.values, sizeof(a.mPeerCATs.values)) == 0 &&
+        memcmp(a.mResumptionId, b.mResumptionId, sizeof(a.mResumptionId)) == 0 &&
+        a.mSessionSetupTimeStamp == b.mSessionSetupTimeStamp;
+}
+
+bool HasResumptionId(CASESessionCache & cache, uint8_t resumptionIdByte)
+{
+    uint8_t resumptionId[kCASEResumptionIDSize];
+    CASESessionCachable outCachableSession;
+    memset(resumptionId, resumptionIdByte, sizeof(resumptionId));
+    return cache.Get(ResumptionID(resumptionId), outCachableSession) == CHIP_NO_ERROR;
+}
+
 } // namespace
 
 class CASESessionTest : public CASESession
@@ -160,6 +193,98 @@ static void CASESessionCache_Remove_Test(nlTestSuite * inSuite, void * inContext
     }
 }
 
+static void CASESessionCache_Replace_Peer_Test(nlTestSuite * inSuite, void * inContext)
+{
+    CASESessionCache cache;
+    CASESessionCachable first  = MakeCachable(1, sTest_PeerId, 0x11);
+    CASESessionCachable second = MakeCachable(1, sTest_PeerId, 0x12);
+
+    NL_TEST_ASSERT(inSuite, cache.Add(first) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, cache.Add(second) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, cache.Count() == 1);
+    NL_TEST_ASSERT(inSuite, !HasResumptionId(cache, 0x11));
+    NL_TEST_ASSERT(inSuite, HasResumptionId(cache, 0x12));
+
+    // The same peer node ID on another fabric is another peer.
+    CASESessionCachable outCachableSession;
+    NL_TEST_ASSERT(inSuite, cache.Get(2, sTest_PeerId, outCachableSession) == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+    NL_TEST_ASSERT(inSuite, cache.Get(1, sTest_PeerId, outCachableSession) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ResumptionID(outCachableSession.mResumptionId).data_equal(ResumptionID(second.mResumptionId)));
+}
+
+static void CASESessionCache_Fabric_Limit_Test(nlTestSuite * inSuite, void * inContext)
+{
+    CASESessionCache cache;
+    CASESessionCachable other = MakeCachable(2, sTest_PeerId, 0x20);
+    NL_TEST_ASSERT(inSuite, cache.Add(other) == CHIP_NO_ERROR);
+
+    for (uint8_t i = 0; i < CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE; i++)
+    {
+        CASESessionCachable cachable = MakeCachable(1, sTest_PeerId + i, static_cast<uint8_t>(0x10 + i));
+        NL_TEST_ASSERT(inSuite, cache.Add(cachable) == CHIP_NO_ERROR);
+    }
+
+    // Fabric 1 fills the cache, so it evicts fabric 2's older record unless it is held to fewer records.
+    const bool limited = CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE_PER_FABRIC < CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE;
+    NL_TEST_ASSERT(inSuite,
+                   cache.Count() ==
+                       (limited ? CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE_PER_FABRIC + 1 : CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE));
+    NL_TEST_ASSERT(inSuite, HasResumptionId(cache, 0x20) == limited);
+    NL_TEST_ASSERT(inSuite, HasResumptionId(cache, 0x10) == !limited);
+    NL_TEST_ASSERT(inSuite, HasResumptionId(cache, static_cast<uint8_t>(0x10 + CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE - 1)));
+}
+
+static void CASESessionCache_Persist_Test(nlTestSuite * inSuite, void * inContext)
+{
+    TestPersistentStorageDelegate storage;
+    CASESessionCachable records[] = {
+        MakeCachable(1, sTest_PeerId, 0x10),
+        MakeCachable(1, sTest_PeerId + 1, 0x11),
+        MakeCachable(2, sTest_PeerId, 0x12),
+    };
+
+    {
+        CASESessionCache cache;
+        NL_TEST_ASSERT(inSuite, cache.Init(&storage) == CHIP_NO_ERROR);
+        for (CASESessionCachable & record : records)
+        {
+            NL_TEST_ASSERT(inSuite, cache.Add(record) == CHIP_NO_ERROR);
+        }
+    }
+
+    // A record that can't be read back is dropped.
+    DefaultStorageKeyAllocator key;
+    const uint8_t garbage[] = { 0x15, 0x30, 0x01 };
+    storage.SyncSetKeyValue(key.CASESessionResumption(CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE - 1), garbage, sizeof(garbage));
+
+    CASESessionCache cache;
+    NL_TEST_ASSERT(inSuite, cache.Init(&storage) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, cache.Count() == ArraySize(records));
+
+    CASESessionCachable outCachableSession;
+    NL_TEST_ASSERT(inSuite, cache.Get(2, sTest_PeerId, outCachableSession) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, IsSameRecord(outCachableSession, records[2]));
+    NL_TEST_ASSERT(inSuite, cache.Get(ResumptionID(records[1].mResumptionId), outCachableSession) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, IsSameRecord(outCachableSession, records[1]));
+
+    // Records added before the restart are still the least recently used ones.
+    for (uint8_t i = 0; i < CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE - 2; i++)
+    {
+        CASESessionCachable cachable = MakeCachable(3, sTest_PeerId + i, static_cast<uint8_t>(0x30 + i));
+        NL_TEST_ASSERT(inSuite, cache.Add(cachable) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(inSuite, !HasResumptionId(cache, 0x10));
+    NL_TEST_ASSERT(inSuite, HasResumptionId(cache, 0x11));
+
+    // Removing a fabric removes its records from storage too.
+    cache.RemoveFabric(3);
+    NL_TEST_ASSERT(inSuite, cache.Count() == 2);
+    NL_TEST_ASSERT(inSuite, cache.Init(&storage) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, cache.Count() == 2);
+    NL_TEST_ASSERT(inSuite, HasResumptionId(cache, 0x11));
+    NL_TEST_ASSERT(inSuite, HasResumptionId(cache, 0x12));
+}
+
 // Test Suite
 
 /**
@@ -173,6 +298,9 @@ static const nlTest sTests[] =
     NL_TEST_DEF("Get",   CASESessionCache_Get_Test),
     NL_TEST_DEF("AddWhenFull", CASESessionCache_Add_When_Full_Test),
     NL_TEST_DEF("Remove", CASESessionCache_Remove_Test),
+    NL_TEST_DEF("ReplacePeer", CASESessionCache_Replace_Peer_Test),
+    NL_TEST_DEF("FabricLimit", CASESessionCache_Fabric_Limit_Test),
+    NL_TEST_DEF("Persist", CASESessionCache_Persist_Test),
 
     NL_TEST_SENTINEL()
 };
@@ -320,6 +320,66 @@
 #define CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE 15
 #endif /* CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE */
 
+/**
+ *  @def CHIP_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+ *
+ *  @brief
+ *      This defines whether (1) or not (0) packet buffers allocated using malloc (i.e. when
+ *      CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE is zero) are rounded up to one of three size classes -- small, MTU and
+ *      large -- and kept for reuse when they are freed, instead of being returned to the heap.
+ *
+ *      Freed buffers are first kept by the thread that freed them, and only go through a shared, locked cache when that
+ *      thread has too many or too few of them, so that threads that send and receive packets concurrently (e.g. the BLE,
+ *      TCP and UDP receive threads and the CHIP thread) seldom contend.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+#define CHIP_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES 0
+#endif /* CHIP_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES */
+
+/**
+ *  @def CHIP_SYSTEM_CONFIG_PACKETBUFFER_SMALL_SIZE
+ *
+ *  @brief
+ *      The size, including the reserved header space, of the buffers of the small size class, which holds
+ *      acknowledgements, status reports and other short messages.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_PACKETBUFFER_SMALL_SIZE
+#define CHIP_SYSTEM_CONFIG_PACKETBUFFER_SMALL_SIZE 256
+#endif /* CHIP_SYSTEM_CONFIG_PACKETBUFFER_SMALL_SIZE */
+
+/**
+ *  @def CHIP_SYSTEM_CONFIG_PACKETBUFFER_MTU_SIZE
+ *
+ *  @brief
+ *      The size, including the reserved header space, of the buffers of the MTU size class, which holds any message that
+ *      fits in the IPv6 minimum MTU. Larger allocations use buffers of CHIP_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX bytes.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_PACKETBUFFER_MTU_SIZE
+#define CHIP_SYSTEM_CONFIG_PACKETBUFFER_MTU_SIZE 1280
+#endif /* CHIP_SYSTEM_CONFIG_PACKETBUFFER_MTU_SIZE */
+
+/**
+ *  @def CHIP_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE
+ *
+ *  @brief
+ *      The number of freed packet buffers of each size class that one thread keeps for itself, when
+ *      CHIP_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES is enabled.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE
+#define CHIP_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE 16
+#endif /* CHIP_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE */
+
+/**
+ *  @def CHIP_SYSTEM_CONFIG_PACKETBUFFER_SHARED_CACHE_SIZE
+ *
+ *  @brief
+ *      The number of freed packet buffers of each size class kept in the cache shared by all threads, when
+ *      CHIP_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES is enabled. Buffers freed beyond that are returned to the heap.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_PACKETBUFFER_SHARED_CACHE_SIZE
+#define CHIP_SYSTEM_CONFIG_PACKETBUFFER_SHARED_CACHE_SIZE 32
+#endif /* CHIP_SYSTEM_CONFIG_PACKETBUFFER_SHARED_CACHE_SIZE */
+
 /**
  *  @def CHIP_SYSTEM_CONFIG_PACKETBUFFER_LWIP_PBUF_TYPE
  *
@@ -451,6 +511,18 @@ struct LwIPEvent;
 #define CHIP_SYSTEM_CONFIG_NUM_TIMERS 32
 #endif /* CHIP_SYSTEM_CONFIG_NUM_TIMERS */
 
+/**
+ *  @def CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL
+ *
+ *  @brief
+ *      Use a hierarchical timer wheel (chip::System::TimerWheel) rather than a sorted list for the timers of the sockets-based
+ *      System::Layer implementations, making timer start and cancellation O(1) at the cost of about 6 KB of state per layer.
+ *      Worthwhile on platforms that may run thousands of concurrent timers.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL
+#define CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL 0
+#endif /* CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL */
+
 /**
  *  @def CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
  *
@@ -472,6 +544,17 @@ struct LwIPEvent;
 #define CHIP_SYSTEM_CONFIG_TEST 0
 #endif
 
+/**
+ *  @def CHIP_SYSTEM_CONFIG_PACKETBUFFER_COUNTERS
+ *
+ *  @brief
+ *    Defines whether (1) or not (0) chip::System::PacketBufferCounters keeps count of packet buffer allocations and copies
+ *    once a test enables it. This is a testing aid, and only changes the behaviour of SystemPacketBuffer.cpp.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_PACKETBUFFER_COUNTERS
+#define CHIP_SYSTEM_CONFIG_PACKETBUFFER_COUNTERS 0
+#endif
+
 // clang-format on
 
 // Configuration parameters with header inclusion dependencies
@@ -0,0 +1,422 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements Layer using epoll() and timerfd.
+ */
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/TimeUtils.h>
+#include <platform/LockTracker.h>
+#include <system/SystemFaultInjection.h>
+#include <system/SystemLayer.h>
+#include <system/SystemLayerImplEpoll.h>
+
+#include <errno.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+// Choose an approximation of PTHREAD_NULL if pthread.h doesn't define one.
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING && !defined(PTHREAD_NULL)
+#define PTHREAD_NULL 0
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING && !defined(PTHREAD_NULL)
+
+namespace chip {
+namespace System {
+
+constexpr Clock::Seconds64 kDefaultMinSleepPeriod = Clock::Seconds64(60 * 60 * 24 * 30); // Month [sec]
+
+CHIP_ERROR LayerImplEpoll::Init()
+{
+    VerifyOrReturnError(mLayerState.SetInitializing(), CHIP_ERROR_INCORRECT_STATE);
+
+    RegisterPOSIXErrorFormatter();
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    mHandleSelectThread = PTHREAD_NULL;
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+    mEventCount     = 0;
+    mStoppedWatches = nullptr;
+
+    mEpollFd = epoll_create1(EPOLL_CLOEXEC);
+    VerifyOrReturnError(mEpollFd >= 0, CHIP_ERROR_POSIX(errno));
+
+    mTimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    VerifyOrReturnError(mTimerFd >= 0, CHIP_ERROR_POSIX(errno));
+
+    // The timerfd is the only entry in the epoll set whose data pointer is null.
+    epoll_event event = {};
+    event.events      = EPOLLIN;
+    event.data.ptr    = nullptr;
+    VerifyOrReturnError(epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mTimerFd, &event) == 0, CHIP_ERROR_POSIX(errno));
+
+    // Create an event to allow an arbitrary thread to wake the thread in the epoll loop.
+    ReturnErrorOnFailure(mWakeEvent.Open(*this));
+
+    VerifyOrReturnError(mLayerState.SetInitialized(), CHIP_ERROR_INCORRECT_STATE);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LayerImplEpoll::Shutdown()
+{
+    VerifyOrReturnError(mLayerState.SetShuttingDown(), CHIP_ERROR_INCORRECT_STATE);
+
+    mTimerList.Clear();
+    mTimerPool.ReleaseAll();
+
+    mWakeEvent.Close(*this);
+
+    ReleaseStoppedWatches();
+    mSocketWatchPool.ReleaseAll();
+    mEventCount = 0;
+
+    if (mTimerFd >= 0)
+    {
+        close(mTimerFd);
+        mTimerFd = kInvalidFd;
+    }
+    if (mEpollFd >= 0)
+    {
+        close(mEpollFd);
+        mEpollFd = kInvalidFd;
+    }
+
+    mLayerState.ResetFromShuttingDown(); // Return to uninitialized state to permit re-initialization.
+    return CHIP_NO_ERROR;
+}
+
+void LayerImplEpoll::Signal()
+{
+    /*
+     * Wake up the I/O thread through the wake event.
+     *
+     * If this is being called from within an I/O event callback, then notifying can be skipped, since the I/O thread is
+     * already awake.
+     *
+     * Furthermore, we don't care if this fails as the only reasonably likely failure is that the event is already
+     * signalled, in which case the waiting thread is going to wake up anyway.
+     */
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    if (pthread_equal(mHandleSelectThread, pthread_self()))
+    {
+        return;
+    }
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+    CHIP_ERROR status = mWakeEvent.Notify();
+    if (status != CHIP_NO_ERROR)
+    {
+        ChipLogError(chipSystemLayer, "System wake event notify failed: %" CHIP_ERROR_FORMAT, status.Format());
+    }
+}
+
+CHIP_ERROR LayerImplEpoll::StartTimer(Clock::Timeout delay, TimerCompleteCallback onComplete, void * appState)
+{
+    VerifyOrReturnError(mLayerState.IsInitialized(), CHIP_ERROR_INCORRECT_STATE);
+
+    CHIP_SYSTEM_FAULT_INJECT(FaultInjection::kFault_TimeoutImmediate, delay = System::Clock::kZero);
+
+    CancelTimer(onComplete, appState);
+
+    TimerList::Node * timer = mTimerPool.Create(*this, SystemClock().GetMonotonicTimestamp() + delay, onComplete, appState);
+    VerifyOrReturnError(timer != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    if (mTimerList.Add(timer) == timer)
+    {
+        // The new timer is the earliest, so the timerfd has to be re-armed.
+        Signal();
+    }
+    return CHIP_NO_ERROR;
+}
+
+void LayerImplEpoll::CancelTimer(TimerCompleteCallback onComplete, void * appState)
+{
+    VerifyOrReturn(mLayerState.IsInitialized());
+
+    TimerList::Node * timer = mTimerList.Remove(onComplete, appState);
+    VerifyOrReturn(timer != nullptr);
+
+    mTimerPool.Release(timer);
+    Signal();
+}
+
+CHIP_ERROR LayerImplEpoll::ScheduleWork(TimerCompleteCallback onComplete, void * appState)
+{
+    VerifyOrReturnError(mLayerState.IsInitialized(), CHIP_ERROR_INCORRECT_STATE);
+
+    CancelTimer(onComplete, appState);
+
+    TimerList::Node * timer = mTimerPool.Create(*this, SystemClock().GetMonotonicTimestamp(), onComplete, appState);
+    VerifyOrReturnError(timer != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    if (mTimerList.Add(timer) == timer)
+    {
+        // The new timer is the earliest, so the time until the next event has probably changed.
+        Signal();
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LayerImplEpoll::StartWatchingSocket(int fd, SocketWatchToken * tokenOut)
+{
+    VerifyOrReturnError(fd >= 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    SocketWatch * watch = mSocketWatchPool.CreateObject();
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_ENDPOINT_POOL_FULL);
+
+    watch->mFD = fd;
+
+    // Add the descriptor with an empty interest set right away, so that the kernel catches duplicate registrations.
+    epoll_event event = {};
+    event.data.ptr    = watch;
+    if (epoll_ctl(mEpollFd, EPOLL_CTL_ADD, fd, &event) != 0)
+    {
+        CHIP_ERROR err = (errno == EEXIST) ? CHIP_ERROR_INVALID_ARGUMENT : CHIP_ERROR_POSIX(errno);
+        mSocketWatchPool.ReleaseObject(watch);
+        return err;
+    }
+    watch->mRegistered = true;
+
+    *tokenOut = reinterpret_cast<SocketWatchToken>(watch);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LayerImplEpoll::SetCallback(SocketWatchToken token, SocketWatchCallback callback, intptr_t data)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(token);
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    watch->mCallback     = callback;
+    watch->mCallbackData = data;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LayerImplEpoll::RequestCallbackOnPendingRead(SocketWatchToken token)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(token);
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    watch->mPendingIO.Set(SocketEventFlags::kRead);
+    return UpdateRegistration(*watch);
+}
+
+CHIP_ERROR LayerImplEpoll::RequestCallbackOnPendingWrite(SocketWatchToken token)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(token);
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    watch->mPendingIO.Set(SocketEventFlags::kWrite);
+    return UpdateRegistration(*watch);
+}
+
+CHIP_ERROR LayerImplEpoll::ClearCallbackOnPendingRead(SocketWatchToken token)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(token);
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    watch->mPendingIO.Clear(SocketEventFlags::kRead);
+    return UpdateRegistration(*watch);
+}
+
+CHIP_ERROR LayerImplEpoll::ClearCallbackOnPendingWrite(SocketWatchToken token)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(token);
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    watch->mPendingIO.Clear(SocketEventFlags::kWrite);
+    return UpdateRegistration(*watch);
+}
+
+CHIP_ERROR LayerImplEpoll::StopWatchingSocket(SocketWatchToken * tokenInOut)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(*tokenInOut);
+    *tokenInOut         = InvalidSocketWatchToken();
+
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(watch->mFD >= 0, CHIP_ERROR_INCORRECT_STATE);
+
+    if (watch->mRegistered)
+    {
+        // The descriptor may already have been closed, in which case the kernel has dropped it from the set already.
+        (void) epoll_ctl(mEpollFd, EPOLL_CTL_DEL, watch->mFD, nullptr);
+    }
+
+    watch->mFD = kInvalidFd;
+    watch->mPendingIO.ClearAll();
+    watch->mCallback     = nullptr;
+    watch->mCallbackData = 0;
+    watch->mRegistered   = false;
+
+    watch->mNextStopped = mStoppedWatches;
+    mStoppedWatches     = watch;
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LayerImplEpoll::UpdateRegistration(SocketWatch & watch)
+{
+    VerifyOrReturnError(watch.mFD >= 0, CHIP_ERROR_INCORRECT_STATE);
+
+    // Level-triggered, since socket callbacks are only expected to consume one datagram or buffer per notification.
+    epoll_event event = {};
+    event.data.ptr    = &watch;
+    if (watch.mPendingIO.Has(SocketEventFlags::kRead))
+    {
+        event.events |= EPOLLIN;
+    }
+    if (watch.mPendingIO.Has(SocketEventFlags::kWrite))
+    {
+        event.events |= EPOLLOUT;
+    }
+
+    // Interest set changes from other threads are picked up by an epoll_wait() in progress, so no Signal() is needed here.
+    VerifyOrReturnError(epoll_ctl(mEpollFd, watch.mRegistered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, watch.mFD, &event) == 0,
+                        CHIP_ERROR_POSIX(errno));
+    watch.mRegistered = true;
+    return CHIP_NO_ERROR;
+}
+
+void LayerImplEpoll::ReleaseStoppedWatches()
+{
+    while (mStoppedWatches != nullptr)
+    {
+        SocketWatch * watch = mStoppedWatches;
+        mStoppedWatches     = watch->mNextStopped;
+        mSocketWatchPool.ReleaseObject(watch);
+    }
+}
+
+void LayerImplEpoll::PrepareEvents()
+{
+    assertChipStackLockedByCurrentThread();
+
+    // Nothing can refer to stopped watches any more, since the events of the previous pass have been handled.
+    mEventCount = 0;
+    ReleaseStoppedWatches();
+
+    const Clock::Timestamp currentTime = SystemClock().GetMonotonicTimestamp();
+    Clock::Timestamp awakenTime        = currentTime + kDefaultMinSleepPeriod;
+
+    TimerList::Node * timer = mTimerList.Earliest();
+    if (timer && timer->AwakenTime() < awakenTime)
+    {
+        awakenTime = timer->AwakenTime();
+    }
+
+    const Clock::Timestamp sleepTime = (awakenTime > currentTime) ? (awakenTime - currentTime) : Clock::kZero;
+
+    // A zero it_value would disarm the timerfd, so due timers are handled by polling instead.
+    itimerspec timerSpec = {};
+    mWaitTimeout         = 0;
+    if (sleepTime > Clock::kZero)
+    {
+        const Clock::Microseconds64 sleepMicros = sleepTime;
+        timerSpec.it_value.tv_sec               = static_cast<time_t>(sleepMicros.count() / kMicrosecondsPerSecond);
+        timerSpec.it_value.tv_nsec =
+            static_cast<long>((sleepMicros.count() % kMicrosecondsPerSecond) * kNanosecondsPerMicrosecond);
+        mWaitTimeout = -1;
+    }
+
+    if (timerfd_settime(mTimerFd, 0, &timerSpec, nullptr) != 0)
+    {
+        ChipLogError(chipSystemLayer, "timerfd_settime failed: %" CHIP_ERROR_FORMAT, CHIP_ERROR_POSIX(errno).Format());
+        mWaitTimeout = static_cast<int>(Clock::Milliseconds32(sleepTime).count());
+    }
+}
+
+void LayerImplEpoll::WaitForEvents()
+{
+    mEventCount = epoll_wait(mEpollFd, mEvents, kMaxEvents, mWaitTimeout);
+}
+
+void LayerImplEpoll::HandleEvents()
+{
+    assertChipStackLockedByCurrentThread();
+
+    if (!IsSelectResultValid())
+    {
+        ChipLogError(DeviceLayer, "epoll_wait failed: %s\n", ErrorStr(CHIP_ERROR_POSIX(errno)));
+        return;
+    }
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    mHandleSelectThread = pthread_self();
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+    // Obtain the list of currently expired timers. Any new timers added by timer callback are NOT handled on this pass,
+    // since that could result in infinite handling of new timers blocking any other progress.
+    TimerList expiredTimers = mTimerList.ExtractEarlier(Clock::Timeout(1) + SystemClock().GetMonotonicTimestamp());
+    TimerList::Node * timer = nullptr;
+    while ((timer = expiredTimers.PopEarliest()) != nullptr)
+    {
+        mTimerPool.Invoke(timer);
+    }
+
+    for (int i = 0; i < mEventCount; i++)
+    {
+        SocketWatch * watch = static_cast<SocketWatch *>(mEvents[i].data.ptr);
+        if (watch == nullptr)
+        {
+            // The timerfd fired; expired timers have already been handled above, so just consume the expiration count.
+            uint64_t expirations;
+            (void) read(mTimerFd, &expirations, sizeof(expirations));
+            continue;
+        }
+
+        // Skip watches that were stopped by an earlier callback (or from another thread) after epoll_wait() returned.
+        if (watch->mFD == kInvalidFd)
+        {
+            continue;
+        }
+
+        // Errors and hang-ups are reported regardless of the interest set, and are surfaced as whatever I/O the watch was
+        // waiting for, so that the subsequent read or write sees the failure, just as with select().
+        const uint32_t failure = mEvents[i].events & (EPOLLERR | EPOLLHUP);
+        SocketEvents events;
+        if ((mEvents[i].events & EPOLLIN) || (failure && watch->mPendingIO.Has(SocketEventFlags::kRead)))
+        {
+            events.Set(SocketEventFlags::kRead);
+        }
+        if ((mEvents[i].events & EPOLLOUT) || (failure && watch->mPendingIO.Has(SocketEventFlags::kWrite)))
+        {
+            events.Set(SocketEventFlags::kWrite);
+        }
+
+        if (!events.HasAny())
+        {
+            // Nobody is interested in this descriptor right now; drop it from the set so that a level-triggered error or
+            // hang-up doesn't keep waking the loop. It is added back by the next request for a callback.
+            (void) epoll_ctl(mEpollFd, EPOLL_CTL_DEL, watch->mFD, nullptr);
+            watch->mRegistered = false;
+            continue;
+        }
+
+        if (watch->mCallback != nullptr)
+        {
+            watch->mCallback(events, watch->mCallbackData);
+        }
+    }
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    mHandleSelectThread = PTHREAD_NULL;
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+}
+
+} // namespace System
+} // namespace chip
@@ -0,0 +1,136 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file declares an implementation of System::Layer using Linux epoll() and timerfd.
+ */
+
+#pragma once
+
+#include <sys/epoll.h>
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+#include <atomic>
+#include <pthread.h>
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+#include <lib/support/ObjectLifeCycle.h>
+#include <lib/support/Pool.h>
+#include <system/SystemLayer.h>
+#include <system/SystemTimer.h>
+#include <system/WakeEvent.h>
+
+namespace chip {
+namespace System {
+
+/**
+ * A System::Layer for Linux that keeps its socket watches registered with an epoll instance, so that each pass through the
+ * event loop costs in proportion to the number of ready sockets rather than the number of watched ones, and that sleeps on a
+ * timerfd armed for the earliest timer so wakeups are not rounded to the millisecond resolution of epoll_wait().
+ */
+class LayerImplEpoll : public LayerSocketsLoop
+{
+public:
+    LayerImplEpoll() = default;
+    ~LayerImplEpoll() { VerifyOrDie(mLayerState.Destroy()); }
+
+    // Layer overrides.
+    CHIP_ERROR Init() override;
+    CHIP_ERROR Shutdown() override;
+    bool IsInitialized() const override { return mLayerState.IsInitialized(); }
+    CHIP_ERROR StartTimer(Clock::Timeout delay, TimerCompleteCallback onComplete, void * appState) override;
+    void CancelTimer(TimerCompleteCallback onComplete, void * appState) override;
+    CHIP_ERROR ScheduleWork(TimerCompleteCallback onComplete, void * appState) override;
+
+    // LayerSocket overrides.
+    CHIP_ERROR StartWatchingSocket(int fd, SocketWatchToken * tokenOut) override;
+    CHIP_ERROR SetCallback(SocketWatchToken token, SocketWatchCallback callback, intptr_t data) override;
+    CHIP_ERROR RequestCallbackOnPendingRead(SocketWatchToken token) override;
+    CHIP_ERROR RequestCallbackOnPendingWrite(SocketWatchToken token) override;
+    CHIP_ERROR ClearCallbackOnPendingRead(SocketWatchToken token) override;
+    CHIP_ERROR ClearCallbackOnPendingWrite(SocketWatchToken token) override;
+    CHIP_ERROR StopWatchingSocket(SocketWatchToken * tokenInOut) override;
+    SocketWatchToken InvalidSocketWatchToken() override { return reinterpret_cast<SocketWatchToken>(nullptr); }
+
+    // LayerSocketLoop overrides.
+    void Signal() override;
+    void EventLoopBegins() override {}
+    void PrepareEvents() override;
+    void WaitForEvents() override;
+    void HandleEvents() override;
+    void EventLoopEnds() override {}
+
+    // Expose the result of WaitForEvents() for non-blocking socket implementations.
+    bool IsSelectResultValid() const { return mEventCount >= 0; }
+
+protected:
+    static constexpr int kSocketWatchMax = (INET_CONFIG_ENABLE_TCP_ENDPOINT ? INET_CONFIG_NUM_TCP_ENDPOINTS : 0) +
+        (INET_CONFIG_ENABLE_UDP_ENDPOINT ? INET_CONFIG_NUM_UDP_ENDPOINTS : 0);
+
+    // Maximum number of ready descriptors collected by one epoll_wait(); any others are picked up on the next pass.
+    static constexpr int kMaxEvents = 64;
+
+    struct SocketWatch
+    {
+        int mFD = kInvalidFd;
+        SocketEvents mPendingIO;
+        SocketWatchCallback mCallback = nullptr;
+        intptr_t mCallbackData        = 0;
+
+        // Whether mFD is currently in the epoll set.
+        bool mRegistered = false;
+
+        // Link in the list of watches stopped since the last PrepareEvents().
+        SocketWatch * mNextStopped = nullptr;
+    };
+
+    CHIP_ERROR UpdateRegistration(SocketWatch & watch);
+    void ReleaseStoppedWatches();
+
+    /*
+     * Watches stay allocated until the next PrepareEvents() after they are stopped, since the results of an epoll_wait()
+     * that is in progress (or whose events have not been handled yet) may still point at them.
+     */
+    ObjectPool<SocketWatch, kSocketWatchMax> mSocketWatchPool;
+    SocketWatch * mStoppedWatches = nullptr;
+
+    TimerPool<TimerList::Node> mTimerPool;
+    TimerQueue mTimerList;
+
+    int mEpollFd = kInvalidFd;
+    int mTimerFd = kInvalidFd;
+
+    // Timeout passed to epoll_wait(): 0 when a timer is already due, otherwise -1 and mTimerFd is armed.
+    int mWaitTimeout = -1;
+
+    // Results of epoll_wait(), carried between WaitForEvents() and HandleEvents().
+    epoll_event mEvents[kMaxEvents];
+    int mEventCount = 0;
+
+    ObjectLifeCycle mLayerState;
+    WakeEvent mWakeEvent;
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    std::atomic<pthread_t> mHandleSelectThread;
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+};
+
+using LayerImpl = LayerImplEpoll;
+
+} // namespace System
+} // namespace chip
@@ -95,7 +95,7 @@ protected:
     SocketWatch mSocketWatchPool[kSocketWatchMax];
 
     TimerPool<TimerList::Node> mTimerPool;
-    TimerList mTimerList;
+    TimerQueue mTimerList;
     timeval mNextTimeout;
 
     // Members for select loop
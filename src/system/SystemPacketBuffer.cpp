@@ -47,6 +47,10 @@
 #include <string.h>
 #include <utility>
 
+#if CHIP_SYSTEM_CONFIG_TEST
+#include <atomic>
+#endif // CHIP_SYSTEM_CONFIG_TEST
+
 #if CHIP_SYSTEM_CONFIG_USE_LWIP
 #include <lwip/mem.h>
 #include <lwip/pbuf.h>
@@ -59,6 +63,60 @@
 namespace chip {
 namespace System {
 
+namespace {
+
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_COUNTERS
+std::atomic<bool> sPacketBufferCountersEnabled{ false };
+std::atomic<uint32_t> sPacketBufferAllocations{ 0 };
+std::atomic<uint32_t> sPacketBufferCopies{ 0 };
+
+inline void CountAllocation()
+{
+    if (sPacketBufferCountersEnabled.load(std::memory_order_relaxed))
+    {
+        sPacketBufferAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+inline void CountCopy()
+{
+    if (sPacketBufferCountersEnabled.load(std::memory_order_relaxed))
+    {
+        sPacketBufferCopies.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+#else  // CHIP_SYSTEM_CONFIG_PACKETBUFFER_COUNTERS
+inline void CountAllocation() {}
+inline void CountCopy() {}
+#endif // CHIP_SYSTEM_CONFIG_PACKETBUFFER_COUNTERS
+
+} // namespace
+
+void PacketBufferCounters::Enable()
+{
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_COUNTERS
+    sPacketBufferCountersEnabled.store(true, std::memory_order_relaxed);
+#endif // CHIP_SYSTEM_CONFIG_PACKETBUFFER_COUNTERS
+}
+
+uint32_t PacketBufferCounters::Allocations()
+{
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_COUNTERS
+    return sPacketBufferAllocations.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif // CHIP_SYSTEM_CONFIG_PACKETBUFFER_COUNTERS
+}
+
+uint32_t PacketBufferCounters::Copies()
+{
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_COUNTERS
+    return sPacketBufferCopies.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif // CHIP_SYSTEM_CONFIG_PACKETBUFFER_COUNTERS
+}
+
 #if CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_POOL
 //
 // Pool allocation for PacketBuffer objects.
@@ -107,6 +165,248 @@ PacketBuffer * PacketBuffer::BuildFreeList()
 // Heap allocation for PacketBuffer objects.
 //
 
+#if CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP_SIZE_CLASSES
+
+namespace {
+
+// Allocation sizes of the size classes, in increasing order.
+constexpr uint16_t kSizeClassAllocSizes[] = { CHIP_SYSTEM_CONFIG_PACKETBUFFER_SMALL_SIZE, CHIP_SYSTEM_CONFIG_PACKETBUFFER_MTU_SIZE,
+                                              PacketBuffer::kMaxSizeWithoutReserve };
+constexpr size_t kNumSizeClasses          = sizeof(kSizeClassAllocSizes) / sizeof(kSizeClassAllocSizes[0]);
+constexpr uint16_t kThreadCacheSize       = CHIP_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE;
+constexpr uint16_t kSharedCacheSize       = CHIP_SYSTEM_CONFIG_PACKETBUFFER_SHARED_CACHE_SIZE;
+
+static_assert(CHIP_SYSTEM_CONFIG_PACKETBUFFER_SMALL_SIZE < CHIP_SYSTEM_CONFIG_PACKETBUFFER_MTU_SIZE &&
+                  CHIP_SYSTEM_CONFIG_PACKETBUFFER_MTU_SIZE < PacketBuffer::kMaxSizeWithoutReserve,
+              "PacketBuffer size classes must be in increasing size order");
+static_assert(kThreadCacheSize >= 2, "Threads exchange half of their cache with the shared cache");
+
+// Freed blocks of one size class, linked through their first word.
+struct BlockList
+{
+    void * mHead    = nullptr;
+    uint16_t mCount = 0;
+
+    void Push(void * aBlock)
+    {
+        *static_cast<void **>(aBlock) = mHead;
+        mHead                         = aBlock;
+        ++mCount;
+    }
+
+    void * Pop()
+    {
+        void * block = mHead;
+        if (block != nullptr)
+        {
+            mHead = *static_cast<void **>(block);
+            --mCount;
+        }
+        return block;
+    }
+};
+
+void FreeBlocks(BlockList & aList)
+{
+    for (void * block = aList.Pop(); block != nullptr; block = aList.Pop())
+    {
+        chip::Platform::MemoryFree(block);
+    }
+}
+
+struct ThreadCache;
+
+void FreeCachedBlocks();
+
+// Freed blocks that any thread can take.
+struct SharedCache
+{
+    SharedCache()
+    {
+#if !CHIP_SYSTEM_CONFIG_NO_LOCKING
+        Mutex::Init(mMutex);
+#endif // !CHIP_SYSTEM_CONFIG_NO_LOCKING
+        chip::Platform::SetMemoryShutdownHandler(FreeCachedBlocks);
+    }
+
+    BlockList mLists[kNumSizeClasses];
+    ThreadCache * mThreadCaches = nullptr; // So that MemoryShutdown can free the blocks they keep
+#if !CHIP_SYSTEM_CONFIG_NO_LOCKING
+    Mutex mMutex;
+#endif // !CHIP_SYSTEM_CONFIG_NO_LOCKING
+};
+
+SharedCache sSharedCache;
+
+#if !CHIP_SYSTEM_CONFIG_NO_LOCKING
+#define LOCK_SHARED_CACHE()                                                                                                        \
+    do                                                                                                                             \
+    {                                                                                                                              \
+        sSharedCache.mMutex.Lock();                                                                                                \
+    } while (0)
+#define UNLOCK_SHARED_CACHE()                                                                                                      \
+    do                                                                                                                             \
+    {                                                                                                                              \
+        sSharedCache.mMutex.Unlock();                                                                                              \
+    } while (0)
+#else // CHIP_SYSTEM_CONFIG_NO_LOCKING
+#define LOCK_SHARED_CACHE()                                                                                                        \
+    do                                                                                                                             \
+    {                                                                                                                              \
+    } while (0)
+#define UNLOCK_SHARED_CACHE()                                                                                                      \
+    do                                                                                                                             \
+    {                                                                                                                              \
+    } while (0)
+#endif // CHIP_SYSTEM_CONFIG_NO_LOCKING
+
+// Moves up to aCount blocks of a size class from a thread cache to the shared cache, and returns those that do not fit
+// there to the heap.
+void ReturnToSharedCache(BlockList & aList, size_t aSizeClass, uint16_t aCount)
+{
+    BlockList excess;
+
+    LOCK_SHARED_CACHE();
+    BlockList & shared = sSharedCache.mLists[aSizeClass];
+    for (; aCount > 0 && aList.mHead != nullptr; aCount--)
+    {
+        void * block = aList.Pop();
+        if (shared.mCount < kSharedCacheSize)
+        {
+            shared.Push(block);
+        }
+        else
+        {
+            excess.Push(block);
+        }
+    }
+    UNLOCK_SHARED_CACHE();
+
+    FreeBlocks(excess);
+}
+
+// Freed blocks kept by one thread. They go to the shared cache when the thread exits.
+struct ThreadCache
+{
+    ThreadCache()
+    {
+        LOCK_SHARED_CACHE();
+        mNext                      = sSharedCache.mThreadCaches;
+        sSharedCache.mThreadCaches = this;
+        UNLOCK_SHARED_CACHE();
+    }
+
+    ~ThreadCache()
+    {
+        for (size_t sizeClass = 0; sizeClass < kNumSizeClasses; sizeClass++)
+        {
+            ReturnToSharedCache(mLists[sizeClass], sizeClass, mLists[sizeClass].mCount);
+        }
+
+        LOCK_SHARED_CACHE();
+        ThreadCache ** link = &sSharedCache.mThreadCaches;
+        while (*link != this)
+        {
+            link = &(*link)->mNext;
+        }
+        *link = mNext;
+        UNLOCK_SHARED_CACHE();
+    }
+
+    BlockList mLists[kNumSizeClasses];
+    ThreadCache * mNext;
+};
+
+// Returns the cached blocks to the heap before it is shut down, which happens when no other thread uses packet buffers
+// any more: their caches are emptied without their knowledge.
+void FreeCachedBlocks()
+{
+    LOCK_SHARED_CACHE();
+    for (ThreadCache * threadCache = sSharedCache.mThreadCaches; threadCache != nullptr; threadCache = threadCache->mNext)
+    {
+        for (BlockList & list : threadCache->mLists)
+        {
+            FreeBlocks(list);
+        }
+    }
+    for (BlockList & list : sSharedCache.mLists)
+    {
+        FreeBlocks(list);
+    }
+    UNLOCK_SHARED_CACHE();
+}
+
+#if !CHIP_SYSTEM_CONFIG_NO_LOCKING
+thread_local ThreadCache sThreadCache;
+#else
+ThreadCache sThreadCache;
+#endif
+
+// Returns the smallest size class whose buffers can hold aAllocSize bytes.
+size_t SizeClassFor(size_t aAllocSize)
+{
+    size_t sizeClass = 0;
+    while (sizeClass + 1 < kNumSizeClasses && kSizeClassAllocSizes[sizeClass] < aAllocSize)
+    {
+        sizeClass++;
+    }
+    return sizeClass;
+}
+
+} // namespace
+
+PacketBuffer * PacketBuffer::AllocateFromSizeClass(size_t aAllocSize)
+{
+    const size_t sizeClass = SizeClassFor(aAllocSize);
+    BlockList & cache      = sThreadCache.mLists[sizeClass];
+
+    if (cache.mHead == nullptr)
+    {
+        // Take half a thread cache from the shared cache, so that the next allocations do not need the lock.
+        LOCK_SHARED_CACHE();
+        BlockList & shared = sSharedCache.mLists[sizeClass];
+        for (uint16_t i = 0; i < kThreadCacheSize / 2 && shared.mHead != nullptr; i++)
+        {
+            cache.Push(shared.Pop());
+        }
+        UNLOCK_SHARED_CACHE();
+    }
+
+    PacketBuffer * lPacket = reinterpret_cast<PacketBuffer *>(cache.Pop());
+    if (lPacket == nullptr)
+    {
+        lPacket = reinterpret_cast<PacketBuffer *>(chip::Platform::MemoryAlloc(kStructureSize + kSizeClassAllocSizes[sizeClass]));
+        VerifyOrReturnError(lPacket != nullptr, nullptr);
+    }
+
+    lPacket->alloc_size = kSizeClassAllocSizes[sizeClass];
+    SYSTEM_STATS_INCREMENT(chip::System::Stats::kSystemLayer_NumSmallPacketBufs + sizeClass);
+    return lPacket;
+}
+
+void PacketBuffer::ReleaseToSizeClass(PacketBuffer * aPacket, uint16_t aAllocSize)
+{
+    const size_t sizeClass = SizeClassFor(aAllocSize);
+
+    // A buffer that was not allocated from a size class, e.g. one that was adopted, goes back to the heap.
+    if (kSizeClassAllocSizes[sizeClass] != aAllocSize)
+    {
+        chip::Platform::MemoryFree(aPacket);
+        return;
+    }
+
+    SYSTEM_STATS_DECREMENT(chip::System::Stats::kSystemLayer_NumSmallPacketBufs + sizeClass);
+
+    BlockList & cache = sThreadCache.mLists[sizeClass];
+    if (cache.mCount >= kThreadCacheSize)
+    {
+        ReturnToSharedCache(cache, sizeClass, kThreadCacheSize / 2);
+    }
+    cache.Push(aPacket);
+}
+
+#endif // CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP_SIZE_CLASSES
+
 #if CHIP_SYSTEM_PACKETBUFFER_HAS_CHECK
 void PacketBuffer::InternalCheck(const PacketBuffer * buffer)
 {
@@ -140,8 +440,18 @@ void PacketBufferHandle::InternalRightSize()
         return;
     }
 
+#if CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP_SIZE_CLASSES
+    // Reallocate only if the data fits in a smaller size class.
+    if (kSizeClassAllocSizes[SizeClassFor(usedSize)] >= mBuffer->alloc_size)
+    {
+        return;
+    }
+
+    PacketBuffer * newBuffer = PacketBuffer::AllocateFromSizeClass(usedSize);
+#else
     const size_t blockSize   = usedSize + PacketBuffer::kStructureSize;
     PacketBuffer * newBuffer = reinterpret_cast<PacketBuffer *>(chip::Platform::MemoryAlloc(blockSize));
+#endif
     if (newBuffer == nullptr)
     {
         ChipLogError(chipSystemLayer, "PacketBuffer: pool EMPTY.");
@@ -154,8 +464,12 @@ void PacketBufferHandle::InternalRightSize()
     newBuffer->tot_len       = mBuffer->tot_len;
     newBuffer->len           = mBuffer->len;
     newBuffer->ref           = 1;
-    newBuffer->alloc_size    = static_cast<uint16_t>(usedSize);
+#if !CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP_SIZE_CLASSES
+    newBuffer->alloc_size = static_cast<uint16_t>(usedSize);
+#endif
     memcpy(reinterpret_cast<uint8_t *>(newBuffer) + PacketBuffer::kStructureSize, start, usedSize);
+    CountAllocation();
+    CountCopy();
 
     PacketBuffer::Free(mBuffer);
     mBuffer = newBuffer;
@@ -169,6 +483,8 @@ void PacketBufferHandle::InternalRightSize()
     if (lNewPacket != mBuffer)
     {
         mBuffer = lNewPacket;
+        CountAllocation();
+        CountCopy();
         SYSTEM_STATS_UPDATE_LWIP_PBUF_COUNTS();
         ChipLogProgress(chipSystemLayer, "PacketBuffer: RightSize Copied");
     }
@@ -287,6 +603,7 @@ void PacketBuffer::CompactHead()
     {
         memmove(kStart, this->payload, this->len);
         this->payload = kStart;
+        CountCopy();
     }
 
     uint16_t lAvailLength = this->AvailableDataLength();
@@ -301,6 +618,7 @@ void PacketBuffer::CompactHead()
             lMoveLength = lAvailLength;
 
         memcpy(static_cast<uint8_t *>(this->payload) + this->len, lNextPacket.payload, lMoveLength);
+        CountCopy();
 
         lNextPacket.payload = static_cast<uint8_t *>(lNextPacket.payload) + lMoveLength;
         this->len           = static_cast<uint16_t>(this->len + lMoveLength);
@@ -482,6 +800,13 @@ PacketBufferHandle PacketBufferHandle::New(size_t aAvailableSize, uint16_t aRese
 
     UNLOCK_BUF_POOL();
 
+#elif CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP_SIZE_CLASSES
+
+    static_cast<void>(lBlockSize);
+
+    lPacket = PacketBuffer::AllocateFromSizeClass(lAllocSize);
+    SYSTEM_STATS_INCREMENT(chip::System::Stats::kSystemLayer_NumPacketBufs);
+
 #elif CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP
 
     lPacket = reinterpret_cast<PacketBuffer *>(chip::Platform::MemoryAlloc(lBlockSize));
@@ -497,11 +822,13 @@ PacketBufferHandle PacketBufferHandle::New(size_t aAvailableSize, uint16_t aRese
         return PacketBufferHandle();
     }
 
+    CountAllocation();
+
     lPacket->payload = reinterpret_cast<uint8_t *>(lPacket) + PacketBuffer::kStructureSize + aReservedSize;
     lPacket->len = lPacket->tot_len = 0;
     lPacket->next                   = nullptr;
     lPacket->ref                    = 1;
-#if CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP
+#if CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP && !CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP_SIZE_CLASSES
     lPacket->alloc_size = static_cast<uint16_t>(lAllocSize);
 #endif
 
@@ -562,12 +889,15 @@ void PacketBuffer::Free(PacketBuffer * aPacket)
         {
             SYSTEM_STATS_DECREMENT(chip::System::Stats::kSystemLayer_NumPacketBufs);
 #if CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP
-            ::chip::Platform::MemoryDebugCheckPointer(aPacket, aPacket->alloc_size + kStructureSize);
+            const uint16_t lAllocSize = aPacket->alloc_size;
+            ::chip::Platform::MemoryDebugCheckPointer(aPacket, lAllocSize + kStructureSize);
 #endif
             aPacket->Clear();
 #if CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_POOL
             aPacket->next = sFreeList;
             sFreeList     = aPacket;
+#elif CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP_SIZE_CLASSES
+            ReleaseToSizeClass(aPacket, lAllocSize);
 #elif CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP
             chip::Platform::MemoryFree(aPacket);
 #endif
@@ -663,6 +993,7 @@ PacketBufferHandle PacketBufferHandle::CloneData() const
         clone.mBuffer->tot_len = clone.mBuffer->len = original->len;
         memcpy(reinterpret_cast<uint8_t *>(clone.mBuffer) + PacketBuffer::kStructureSize,
                reinterpret_cast<uint8_t *>(original) + PacketBuffer::kStructureSize, originalDataSize + originalReservedSize);
+        CountCopy();
 
         if (cloneHead.IsNull())
         {
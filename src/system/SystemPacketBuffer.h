@@ -51,6 +51,22 @@ namespace System {
 
 class PacketBufferHandle;
 
+/**
+ *  @class PacketBufferCounters
+ *
+ *  @brief
+ *    Running totals of packet buffer allocations and of buffer payloads copied by the PacketBuffer methods, so that tests can
+ *    check how many of each a code path makes. The totals are only kept when CHIP_SYSTEM_CONFIG_PACKETBUFFER_COUNTERS is
+ *    enabled, and only once a test has called Enable(); otherwise they stay zero.
+ */
+class DLL_EXPORT PacketBufferCounters
+{
+public:
+    static void Enable();
+    static uint32_t Allocations();
+    static uint32_t Copies();
+};
+
 #if !CHIP_SYSTEM_CONFIG_USE_LWIP
 struct pbuf
 {
@@ -369,6 +385,11 @@ private:
     static PacketBuffer * BuildFreeList();
 #endif // CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_POOL || defined(DOXYGEN)
 
+#if CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP_SIZE_CLASSES
+    static PacketBuffer * AllocateFromSizeClass(size_t aAllocSize);
+    static void ReleaseToSizeClass(PacketBuffer * aPacket, uint16_t aAllocSize);
+#endif // CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP_SIZE_CLASSES
+
 #if CHIP_SYSTEM_PACKETBUFFER_HAS_CHECK
     static void InternalCheck(const PacketBuffer * buffer);
 #endif
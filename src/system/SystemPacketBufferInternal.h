@@ -49,6 +49,17 @@
 #define CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_POOL 0
 #endif
 
+/**
+ * CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP_SIZE_CLASSES
+ *
+ * True if packet buffers allocated using Platform::MemoryAlloc are rounded up to size classes and cached for reuse.
+ */
+#if CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP && CHIP_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+#define CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP_SIZE_CLASSES 1
+#else
+#define CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP_SIZE_CLASSES 0
+#endif
+
 /**
  * CHIP_SYSTEM_PACKETBUFFER_FROM_LWIP_POOL
  *
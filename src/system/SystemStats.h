@@ -32,6 +32,7 @@
 // Include configuration headers
 #include <inet/InetConfig.h>
 #include <lib/core/CHIPConfig.h>
+#include <system/SystemPacketBufferInternal.h>
 
 // Include dependent headers
 #include <lib/support/DLLUtil.h>
@@ -58,6 +59,12 @@ enum
 #undef LWIP_PBUF_MEMPOOL
 #else
     kSystemLayer_NumPacketBufs,
+#if CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP_SIZE_CLASSES
+    // One entry per size class, in increasing size order.
+    kSystemLayer_NumSmallPacketBufs,
+    kSystemLayer_NumMTUPacketBufs,
+    kSystemLayer_NumLargePacketBufs,
+#endif
 #endif
     kSystemLayer_NumTimers,
 #if INET_CONFIG_NUM_TCP_ENDPOINTS
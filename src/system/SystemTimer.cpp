@@ -33,6 +33,7 @@
 #include <system/SystemFaultInjection.h>
 #include <system/SystemLayer.h>
 
+#include <lib/support/CHIPMem.h>
 #include <lib/support/CodeUtils.h>
 
 namespace chip {
@@ -160,5 +161,438 @@ TimerList TimerList::ExtractEarlier(Clock::Timestamp t)
     return out;
 }
 
+#if CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
+namespace {
+
+unsigned LowestSetBit(uint64_t bits)
+{
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_ctzll(bits));
+#else
+    unsigned index = 0;
+    while ((bits & 1) == 0)
+    {
+        bits >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+} // namespace
+
+TimerWheel::TimerWheel() : mBuckets(&mInlineBucket), mBucketCount(1)
+{
+    memset(mOccupied, 0, sizeof(mOccupied));
+}
+
+TimerWheel::~TimerWheel()
+{
+    FreeBuckets();
+}
+
+TimerWheel::Node * TimerWheel::Add(Node * add)
+{
+    VerifyOrDie(add->mWheelSlot == Node::kNotQueued);
+
+    if (mCount == 0)
+    {
+        // Restart the wheel near the current time, so that the levels are not wasted on time that has already passed.
+        const Clock::Timestamp now = SystemClock().GetMonotonicTimestamp();
+        mNow                       = ((add->AwakenTime() < now) ? add->AwakenTime() : now).count();
+    }
+
+    Insert(add);
+    HashInsert(add);
+    mCount++;
+
+    if (mCount == 1 || (mEarliest != nullptr && add->AwakenTime() < mEarliest->AwakenTime()))
+    {
+        mEarliest = add;
+    }
+    return Earliest();
+}
+
+TimerWheel::Node * TimerWheel::Remove(Node * remove)
+{
+    if (remove != nullptr && remove->mWheelSlot != Node::kNotQueued)
+    {
+        Detach(remove);
+    }
+    return Earliest();
+}
+
+TimerWheel::Node * TimerWheel::Remove(TimerCompleteCallback aOnComplete, void * aAppState)
+{
+    Node * found = nullptr;
+    for (Node * timer = mBuckets[BucketFor(aOnComplete, aAppState)]; timer != nullptr; timer = timer->mNextInBucket)
+    {
+        if (timer->GetCallback().GetOnComplete() == aOnComplete && timer->GetCallback().GetAppState() == aAppState &&
+            (found == nullptr || timer->AwakenTime() < found->AwakenTime()))
+        {
+            found = timer;
+        }
+    }
+    return (found == nullptr) ? nullptr : Detach(found);
+}
+
+TimerWheel::Node * TimerWheel::PopEarliest()
+{
+    return PopNotLaterThan(UINT64_MAX);
+}
+
+TimerWheel::Node * TimerWheel::PopIfEarlier(Clock::Timestamp t)
+{
+    return (t.count() == 0) ? nullptr : PopNotLaterThan(t.count() - 1);
+}
+
+TimerWheel::Node * TimerWheel::Earliest() const
+{
+    if (mEarliest == nullptr && mCount != 0)
+    {
+        mEarliest = FindEarliest();
+    }
+    return mEarliest;
+}
+
+TimerList TimerWheel::ExtractEarlier(Clock::Timestamp t)
+{
+    TimerList out;
+    Node * last = nullptr;
+    Node * timer;
+
+    while ((timer = PopIfEarlier(t)) != nullptr)
+    {
+        if (last == nullptr)
+        {
+            out.mEarliestTimer = timer;
+        }
+        else
+        {
+            last->mNextTimer = timer;
+        }
+        last = timer;
+    }
+    return out;
+}
+
+void TimerWheel::Clear()
+{
+    for (Slot & slot : mSlots)
+    {
+        for (Node * timer = slot.mHead; timer != nullptr;)
+        {
+            Node * next         = timer->mNextTimer;
+            timer->mNextTimer    = nullptr;
+            timer->mPrevTimer    = nullptr;
+            timer->mNextInBucket = nullptr;
+            timer->mWheelSlot    = Node::kNotQueued;
+            timer                = next;
+        }
+        slot.mHead = slot.mTail = nullptr;
+    }
+    memset(mOccupied, 0, sizeof(mOccupied));
+    mCount    = 0;
+    mEarliest = nullptr;
+    FreeBuckets();
+}
+
+uint16_t TimerWheel::SlotFor(uint64_t awakenTime) const
+{
+    if (awakenTime < mNow)
+    {
+        return kEarlySlot;
+    }
+
+    // The level is given by the most significant group of bits in which the expiration time differs from mNow.
+    uint64_t diff  = awakenTime ^ mNow;
+    unsigned level = 0;
+    while (diff >= kSlotsPerLevel)
+    {
+        diff >>= kSlotBits;
+        if (++level == kLevels)
+        {
+            return kOverflowSlot;
+        }
+    }
+    const unsigned index = static_cast<unsigned>(awakenTime >> (kSlotBits * level)) & (kSlotsPerLevel - 1);
+    return static_cast<uint16_t>(level * kSlotsPerLevel + index);
+}
+
+uint64_t TimerWheel::SlotStartTime(unsigned level, unsigned index) const
+{
+    const unsigned shift = kSlotBits * level;
+    return ((mNow >> (shift + kSlotBits)) << (shift + kSlotBits)) | (static_cast<uint64_t>(index) << shift);
+}
+
+void TimerWheel::Insert(Node * timer)
+{
+    const uint16_t slotIndex = SlotFor(timer->AwakenTime().count());
+    Slot & slot              = mSlots[slotIndex];
+
+    // Slots are FIFO; only the list of timers that are already late needs to be kept sorted, and new timers usually go last.
+    Node * after = slot.mTail;
+    if (slotIndex == kEarlySlot)
+    {
+        while (after != nullptr && timer->AwakenTime() < after->AwakenTime())
+        {
+            after = after->mPrevTimer;
+        }
+    }
+
+    timer->mWheelSlot = slotIndex;
+    timer->mPrevTimer = after;
+    timer->mNextTimer = (after == nullptr) ? slot.mHead : after->mNextTimer;
+    if (after == nullptr)
+    {
+        slot.mHead = timer;
+    }
+    else
+    {
+        after->mNextTimer = timer;
+    }
+    if (timer->mNextTimer == nullptr)
+    {
+        slot.mTail = timer;
+    }
+    else
+    {
+        timer->mNextTimer->mPrevTimer = timer;
+    }
+
+    if (slotIndex < kEarlySlot)
+    {
+        mOccupied[slotIndex / kSlotsPerLevel] |= static_cast<uint64_t>(1) << (slotIndex % kSlotsPerLevel);
+    }
+}
+
+void TimerWheel::Unlink(Node * timer)
+{
+    const uint16_t slotIndex = timer->mWheelSlot;
+    Slot & slot              = mSlots[slotIndex];
+
+    if (timer->mPrevTimer == nullptr)
+    {
+        slot.mHead = timer->mNextTimer;
+    }
+    else
+    {
+        timer->mPrevTimer->mNextTimer = timer->mNextTimer;
+    }
+    if (timer->mNextTimer == nullptr)
+    {
+        slot.mTail = timer->mPrevTimer;
+    }
+    else
+    {
+        timer->mNextTimer->mPrevTimer = timer->mPrevTimer;
+    }
+
+    if (slot.mHead == nullptr && slotIndex < kEarlySlot)
+    {
+        mOccupied[slotIndex / kSlotsPerLevel] &= ~(static_cast<uint64_t>(1) << (slotIndex % kSlotsPerLevel));
+    }
+
+    timer->mNextTimer = nullptr;
+    timer->mPrevTimer = nullptr;
+    timer->mWheelSlot = Node::kNotQueued;
+}
+
+TimerWheel::Node * TimerWheel::Detach(Node * timer)
+{
+    Unlink(timer);
+    HashRemove(timer);
+    mCount--;
+    if (timer == mEarliest)
+    {
+        mEarliest = nullptr;
+    }
+    return timer;
+}
+
+void TimerWheel::Cascade(uint16_t slotIndex)
+{
+    Slot & slot  = mSlots[slotIndex];
+    Node * timer = slot.mHead;
+
+    slot.mHead = slot.mTail = nullptr;
+    if (slotIndex < kEarlySlot)
+    {
+        mOccupied[slotIndex / kSlotsPerLevel] &= ~(static_cast<uint64_t>(1) << (slotIndex % kSlotsPerLevel));
+    }
+
+    // Re-inserting in slot order keeps timers with the same expiration time in the order they were added.
+    while (timer != nullptr)
+    {
+        Node * next = timer->mNextTimer;
+        Insert(timer);
+        timer = next;
+    }
+}
+
+TimerWheel::Node * TimerWheel::PopNotLaterThan(uint64_t limit)
+{
+    while (mCount != 0)
+    {
+        // Late timers precede everything in the wheel.
+        Node * late = mSlots[kEarlySlot].mHead;
+        if (late != nullptr)
+        {
+            return (late->AwakenTime().count() <= limit) ? Detach(late) : nullptr;
+        }
+
+        unsigned level = 0;
+        while (level < kLevels && mOccupied[level] == 0)
+        {
+            level++;
+        }
+
+        if (level == kLevels)
+        {
+            // Only timers beyond the range of the wheel are left; restart the wheel at the earliest of them.
+            Node * earliest = Earliest();
+            if (earliest->AwakenTime().count() > limit)
+            {
+                return nullptr;
+            }
+            mNow = earliest->AwakenTime().count();
+            Cascade(kOverflowSlot);
+            continue;
+        }
+
+        const unsigned index     = LowestSetBit(mOccupied[level]);
+        const uint16_t slotIndex = static_cast<uint16_t>(level * kSlotsPerLevel + index);
+        if (level == 0)
+        {
+            // All timers in a slot of the first level expire at the same time.
+            Node * first = mSlots[slotIndex].mHead;
+            return (first->AwakenTime().count() <= limit) ? Detach(first) : nullptr;
+        }
+
+        // Move the wheel to the start of the slot and redistribute its timers to the lower levels.
+        const uint64_t start = SlotStartTime(level, index);
+        if (start > limit)
+        {
+            return nullptr;
+        }
+        mNow = start;
+        Cascade(slotIndex);
+    }
+    return nullptr;
+}
+
+TimerWheel::Node * TimerWheel::FindEarliest() const
+{
+    const Slot * slot = &mSlots[kOverflowSlot];
+
+    if (mSlots[kEarlySlot].mHead != nullptr)
+    {
+        return mSlots[kEarlySlot].mHead;
+    }
+    for (unsigned level = 0; level < kLevels; level++)
+    {
+        if (mOccupied[level] != 0)
+        {
+            slot = &mSlots[level * kSlotsPerLevel + LowestSetBit(mOccupied[level])];
+            if (level == 0)
+            {
+                return slot->mHead;
+            }
+            break;
+        }
+    }
+
+    Node * earliest = slot->mHead;
+    for (Node * timer = earliest; timer != nullptr; timer = timer->mNextTimer)
+    {
+        if (timer->AwakenTime() < earliest->AwakenTime())
+        {
+            earliest = timer;
+        }
+    }
+    return earliest;
+}
+
+size_t TimerWheel::BucketFor(TimerCompleteCallback onComplete, void * appState) const
+{
+    uint64_t hash = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(onComplete)) * UINT64_C(0x9E3779B97F4A7C15);
+    hash ^= static_cast<uint64_t>(reinterpret_cast<uintptr_t>(appState));
+    hash *= UINT64_C(0xBF58476D1CE4E5B9);
+    hash ^= hash >> 31;
+    return static_cast<size_t>(hash) & (mBucketCount - 1);
+}
+
+void TimerWheel::HashInsert(Node * timer)
+{
+    if (mCount >= mBucketCount)
+    {
+        GrowBuckets();
+    }
+    Node *& bucket       = mBuckets[BucketFor(timer->GetCallback().GetOnComplete(), timer->GetCallback().GetAppState())];
+    timer->mNextInBucket = bucket;
+    bucket               = timer;
+}
+
+void TimerWheel::HashRemove(Node * timer)
+{
+    Node ** link = &mBuckets[BucketFor(timer->GetCallback().GetOnComplete(), timer->GetCallback().GetAppState())];
+    while (*link != nullptr)
+    {
+        if (*link == timer)
+        {
+            *link = timer->mNextInBucket;
+            break;
+        }
+        link = &(*link)->mNextInBucket;
+    }
+    timer->mNextInBucket = nullptr;
+}
+
+void TimerWheel::GrowBuckets()
+{
+    const size_t count = (mBucketCount < kMinBucketCount) ? kMinBucketCount : mBucketCount * 2;
+    Node ** buckets    = static_cast<Node **>(Platform::MemoryCalloc(count, sizeof(Node *)));
+    if (buckets == nullptr)
+    {
+        // Keep using the current table; cancellation just gets slower.
+        return;
+    }
+
+    Node ** oldBuckets    = mBuckets;
+    const size_t oldCount = mBucketCount;
+    mBuckets              = buckets;
+    mBucketCount          = count;
+    for (size_t i = 0; i < oldCount; i++)
+    {
+        for (Node * timer = oldBuckets[i]; timer != nullptr;)
+        {
+            Node * next          = timer->mNextInBucket;
+            Node *& bucket       = mBuckets[BucketFor(timer->GetCallback().GetOnComplete(), timer->GetCallback().GetAppState())];
+            timer->mNextInBucket = bucket;
+            bucket               = timer;
+            timer                = next;
+        }
+    }
+
+    if (oldBuckets != &mInlineBucket)
+    {
+        Platform::MemoryFree(oldBuckets);
+    }
+}
+
+void TimerWheel::FreeBuckets()
+{
+    if (mBuckets != &mInlineBucket)
+    {
+        Platform::MemoryFree(mBuckets);
+    }
+    mBuckets      = &mInlineBucket;
+    mBucketCount  = 1;
+    mInlineBucket = nullptr;
+}
+
+#endif // CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
 } // namespace System
 } // namespace chip
@@ -111,6 +111,14 @@ public:
             TimerData(systemLayer, awakenTime, onComplete, appState), mNextTimer(nullptr)
         {}
         Node * mNextTimer;
+
+#if CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL
+        // State used while the timer is queued in a TimerWheel, where mNextTimer links the timers of a wheel slot.
+        static constexpr uint16_t kNotQueued = UINT16_MAX;
+        Node * mPrevTimer    = nullptr;
+        Node * mNextInBucket = nullptr;
+        uint16_t mWheelSlot  = kNotQueued;
+#endif // CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL
     };
 
     TimerList() : mEarliestTimer(nullptr) {}
@@ -174,9 +182,153 @@ public:
     void Clear() { mEarliestTimer = nullptr; }
 
 private:
+#if CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    friend class TimerWheel;
+#endif // CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL
     Node * mEarliestTimer;
 };
 
+#if CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
+/**
+ * Hierarchical timing wheel of `Timer`s, with the same interface and ordering as TimerList.
+ *
+ * Timers are hashed into one of kLevels levels of kSlotsPerLevel slots, where a slot at level L covers 2^(kSlotBits * L)
+ * milliseconds, so that adding a timer is O(1), and a slot of a higher level is redistributed (cascaded) to lower levels
+ * only once the wheel gets to it. Timers with the same expiration time are returned in the order they were added.
+ * Removal by callback and context goes through a hash table, which makes CancelTimer() O(1) as well.
+ *
+ * Unlike TimerList, a timer in a TimerWheel must not be added to another TimerWheel or TimerList until it is removed.
+ */
+class TimerWheel
+{
+public:
+    using Node = TimerList::Node;
+
+    TimerWheel();
+    ~TimerWheel();
+
+    /**
+     * Add a timer to the wheel.
+     *
+     * @return  The new earliest timer in the wheel.
+     */
+    Node * Add(Node * timer);
+
+    /**
+     * Remove the given timer from the wheel, if present. It is not an error for the timer not to be present.
+     *
+     * @return  The new earliest timer in the wheel, or nullptr if the wheel is empty.
+     */
+    Node * Remove(Node * remove);
+
+    /**
+     * Remove the first timer with the given properties, if present. It is not an error for no such timer to be present.
+     *
+     * @return  The removed timer, or nullptr if the wheel contains no matching timer.
+     */
+    Node * Remove(TimerCompleteCallback onComplete, void * appState);
+
+    /**
+     * Remove and return the earliest timer in the wheel.
+     *
+     * @return  The earliest timer, or nullptr if the wheel is empty.
+     */
+    Node * PopEarliest();
+
+    /**
+     * Remove and return the earliest timer in the wheel, provided it expires earlier than the given time @a t.
+     *
+     * @return  The earliest timer expiring before @a t, or nullptr if there is no such timer.
+     */
+    Node * PopIfEarlier(Clock::Timestamp t);
+
+    /**
+     * Get the earliest timer in the wheel.
+     *
+     * @return  The earliest timer, or nullptr if there are no timers.
+     */
+    Node * Earliest() const;
+
+    /**
+     * Test whether there are any timers.
+     */
+    bool Empty() const { return mCount == 0; }
+
+    /**
+     * Remove and return all timers that expire before the given time @a t, as a TimerList.
+     */
+    TimerList ExtractEarlier(Clock::Timestamp t);
+
+    /**
+     * Remove all timers.
+     */
+    void Clear();
+
+private:
+    static constexpr unsigned kSlotBits      = 6;
+    static constexpr unsigned kSlotsPerLevel = 1u << kSlotBits;
+    static constexpr unsigned kLevels        = 6;
+
+    // Timers that expire before mNow, kept sorted.
+    static constexpr uint16_t kEarlySlot = kLevels * kSlotsPerLevel;
+    // Timers beyond the range of the wheel, unsorted.
+    static constexpr uint16_t kOverflowSlot = kEarlySlot + 1;
+    static constexpr size_t kSlotCount      = kOverflowSlot + 1;
+
+    static constexpr size_t kMinBucketCount = 64;
+
+    struct Slot
+    {
+        Node * mHead = nullptr;
+        Node * mTail = nullptr;
+    };
+
+    uint16_t SlotFor(uint64_t awakenTime) const;
+    void Insert(Node * timer);
+    void Unlink(Node * timer);
+    Node * Detach(Node * timer);
+    void Cascade(uint16_t slot);
+    Node * PopNotLaterThan(uint64_t limit);
+    uint64_t SlotStartTime(unsigned level, unsigned index) const;
+    Node * FindEarliest() const;
+
+    size_t BucketFor(TimerCompleteCallback onComplete, void * appState) const;
+    void HashInsert(Node * timer);
+    void HashRemove(Node * timer);
+    void GrowBuckets();
+    void FreeBuckets();
+
+    Slot mSlots[kSlotCount];
+    uint64_t mOccupied[kLevels];
+
+    // Lower bound for the expiration time of every timer in the wheel levels; never ahead of the time timers were popped at.
+    uint64_t mNow = 0;
+    size_t mCount = 0;
+
+    // Cached result of Earliest(), or nullptr if it needs to be looked up again.
+    mutable Node * mEarliest = nullptr;
+
+    // Hash table of timers by callback and context, chained through Node::mNextInBucket.
+    Node ** mBuckets;
+    size_t mBucketCount;
+    Node * mInlineBucket = nullptr;
+
+    TimerWheel(const TimerWheel &) = delete;
+    TimerWheel & operator=(const TimerWheel &) = delete;
+};
+
+/**
+ * The timer queue used by System::Layer implementations that keep their own timers.
+ */
+using TimerQueue = TimerWheel;
+
+#else // CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
+using TimerQueue = TimerList;
+
+#endif // CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
 /**
  * ObjectPool wrapper that keeps System Timer statistics.
  */
@@ -37,7 +37,9 @@
 #include <lib/support/CHIPMem.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/UnitTestRegistration.h>
+#include <lib/support/logging/CHIPLogging.h>
 #include <platform/CHIPDeviceLayer.h>
+#include <system/SystemClock.h>
 #include <system/SystemPacketBuffer.h>
 
 #if CHIP_SYSTEM_CONFIG_USE_LWIP
@@ -47,6 +49,10 @@
 
 #include <nlunit-test.h>
 
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING && !CHIP_SYSTEM_CONFIG_USE_LWIP
+#include <thread>
+#endif
+
 #if CHIP_SYSTEM_CONFIG_USE_LWIP
 #if (LWIP_VERSION_MAJOR == 2) && (LWIP_VERSION_MINOR == 0)
 #define PBUF_TYPE(pbuf) (pbuf)->type
@@ -132,6 +138,8 @@ public:
     static void CheckHandleRightSize(nlTestSuite * inSuite, void * inContext);
     static void CheckHandleCloneData(nlTestSuite * inSuite, void * inContext);
     static void CheckPacketBufferWriter(nlTestSuite * inSuite, void * inContext);
+    static void CheckSizeClasses(nlTestSuite * inSuite, void * inContext);
+    static void CheckAllocationThroughput(nlTestSuite * inSuite, void * inContext);
     static void CheckBuildFreeList(nlTestSuite * inSuite, void * inContext);
 
     static void PrintHandle(const char * tag, const PacketBuffer * buffer)
@@ -1962,6 +1970,147 @@ void PacketBufferTest::CheckPacketBufferWriter(nlTestSuite * inSuite, void * inC
     NL_TEST_ASSERT(inSuite, memcmp(yayBuffer->Start(), kPayload, sizeof kPayload) == 0);
 }
 
+void PacketBufferTest::CheckSizeClasses(nlTestSuite * inSuite, void * inContext)
+{
+    struct TestContext * const theContext = static_cast<struct TestContext *>(inContext);
+    PacketBufferTest * const test         = theContext->test;
+    NL_TEST_ASSERT(inSuite, test->mContext == theContext);
+
+#if CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP_SIZE_CLASSES
+
+    // Allocations are rounded up to the smallest size class that fits them.
+    PacketBufferHandle small = PacketBufferHandle::New(1, 0);
+    PacketBufferHandle mtu   = PacketBufferHandle::New(CHIP_SYSTEM_CONFIG_PACKETBUFFER_SMALL_SIZE + 1, 0);
+    PacketBufferHandle large = PacketBufferHandle::New(CHIP_SYSTEM_CONFIG_PACKETBUFFER_MTU_SIZE + 1, 0);
+    NL_TEST_ASSERT(inSuite, !small.IsNull() && !mtu.IsNull() && !large.IsNull());
+    NL_TEST_ASSERT(inSuite, small->AllocSize() == CHIP_SYSTEM_CONFIG_PACKETBUFFER_SMALL_SIZE);
+    NL_TEST_ASSERT(inSuite, mtu->AllocSize() == CHIP_SYSTEM_CONFIG_PACKETBUFFER_MTU_SIZE);
+    NL_TEST_ASSERT(inSuite, large->AllocSize() == PacketBuffer::kMaxSizeWithoutReserve);
+
+    // A freed buffer is reused by the next allocation of its size class on the same thread.
+    const PacketBuffer * const freed = small.mBuffer;
+    small                            = nullptr;
+    small                            = PacketBufferHandle::New(CHIP_SYSTEM_CONFIG_PACKETBUFFER_SMALL_SIZE, 0);
+    NL_TEST_ASSERT(inSuite, small.mBuffer == freed);
+
+    // The whole size class is usable, and keeps working across the thread and shared caches.
+    memset(small->Start(), 0xA5, small->MaxDataLength());
+    small->SetDataLength(small->MaxDataLength());
+
+    constexpr size_t kCount = 2 * CHIP_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE + CHIP_SYSTEM_CONFIG_PACKETBUFFER_SHARED_CACHE_SIZE;
+    PacketBufferHandle handles[kCount];
+    for (int round = 0; round < 2; round++)
+    {
+        for (PacketBufferHandle & handle : handles)
+        {
+            handle = PacketBufferHandle::New(CHIP_SYSTEM_CONFIG_PACKETBUFFER_MTU_SIZE, 0);
+            NL_TEST_ASSERT(inSuite, !handle.IsNull() && handle->AllocSize() == CHIP_SYSTEM_CONFIG_PACKETBUFFER_MTU_SIZE);
+        }
+        for (PacketBufferHandle & handle : handles)
+        {
+            handle = nullptr;
+        }
+    }
+
+#endif // CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP_SIZE_CLASSES
+}
+
+namespace {
+
+constexpr uint32_t kThroughputAllocations = 100000;
+// Buffers held at once by each allocating thread; small enough for the default buffer pool.
+constexpr size_t kThroughputBurst         = 8;
+constexpr size_t kThroughputThreads       = 4;
+constexpr size_t kThroughputThreadBurst   = 2;
+
+const char * AllocationMode()
+{
+#if CHIP_SYSTEM_CONFIG_USE_LWIP
+    return "LwIP";
+#elif CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_POOL
+    return "pool";
+#elif CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP_SIZE_CLASSES
+    return "heap size classes";
+#else
+    return "heap";
+#endif
+}
+
+// Allocates aCount buffers of aSize bytes, holding up to aBurst of them at once, and returns how many allocations succeeded.
+uint32_t AllocateBursts(size_t aSize, uint32_t aCount, size_t aBurst)
+{
+    PacketBufferHandle handles[kThroughputBurst];
+    uint32_t allocated = 0;
+
+    for (uint32_t i = 0; i < aCount; i += static_cast<uint32_t>(aBurst))
+    {
+        for (size_t j = 0; j < aBurst; j++)
+        {
+            handles[j] = PacketBufferHandle::New(aSize);
+            allocated += handles[j].IsNull() ? 0 : 1;
+        }
+        for (size_t j = 0; j < aBurst; j++)
+        {
+            handles[j] = nullptr;
+        }
+    }
+    return allocated;
+}
+
+} // namespace
+
+/**
+ * Measure the time to allocate and free packet buffers of each size class, from one thread and then from concurrent threads,
+ * in the allocation mode of this build.
+ */
+void PacketBufferTest::CheckAllocationThroughput(nlTestSuite * inSuite, void * inContext)
+{
+    struct TestContext * const theContext = static_cast<struct TestContext *>(inContext);
+    PacketBufferTest * const test         = theContext->test;
+    NL_TEST_ASSERT(inSuite, test->mContext == theContext);
+
+    const size_t sizes[] = { 32, 1024, PacketBuffer::kMaxSize };
+
+    for (size_t size : sizes)
+    {
+        chip::System::Clock::Microseconds64 start   = chip::System::SystemClock().GetMonotonicMicroseconds64();
+        const uint32_t allocated                    = AllocateBursts(size, kThroughputAllocations, kThroughputBurst);
+        chip::System::Clock::Microseconds64 elapsed = chip::System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+        ChipLogProgress(chipSystemLayer, "PacketBuffer %s, 1 thread, %u bytes: %" PRIu64 "ns per allocation", AllocationMode(),
+                        static_cast<unsigned>(size), elapsed.count() * 1000u / kThroughputAllocations);
+        NL_TEST_ASSERT(inSuite, allocated == kThroughputAllocations);
+    }
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING && !CHIP_SYSTEM_CONFIG_USE_LWIP
+    for (size_t size : sizes)
+    {
+        uint32_t allocated[kThroughputThreads] = {};
+        std::thread threads[kThroughputThreads];
+
+        chip::System::Clock::Microseconds64 start = chip::System::SystemClock().GetMonotonicMicroseconds64();
+        for (size_t i = 0; i < kThroughputThreads; i++)
+        {
+            threads[i] = std::thread(
+                [size, &allocated, i]() { allocated[i] = AllocateBursts(size, kThroughputAllocations, kThroughputThreadBurst); });
+        }
+        for (std::thread & thread : threads)
+        {
+            thread.join();
+        }
+        chip::System::Clock::Microseconds64 elapsed = chip::System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+        ChipLogProgress(chipSystemLayer, "PacketBuffer %s, %u threads, %u bytes: %" PRIu64 "ns per allocation", AllocationMode(),
+                        static_cast<unsigned>(kThroughputThreads), static_cast<unsigned>(size),
+                        elapsed.count() * 1000u / (kThroughputThreads * kThroughputAllocations));
+        for (uint32_t count : allocated)
+        {
+            NL_TEST_ASSERT(inSuite, count == kThroughputAllocations);
+        }
+    }
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING && !CHIP_SYSTEM_CONFIG_USE_LWIP
+}
+
 /**
  *   Test Suite. It lists all the test functions.
  */
@@ -2002,6 +2151,8 @@ const nlTest sTests[] =
     NL_TEST_DEF("PacketBuffer::HandleRightSize",        PacketBufferTest::CheckHandleRightSize),
     NL_TEST_DEF("PacketBuffer::HandleCloneData",        PacketBufferTest::CheckHandleCloneData),
     NL_TEST_DEF("PacketBuffer::PacketBufferWriter",     PacketBufferTest::CheckPacketBufferWriter),
+    NL_TEST_DEF("PacketBuffer::SizeClasses",            PacketBufferTest::CheckSizeClasses),
+    NL_TEST_DEF("PacketBuffer::AllocationThroughput",   PacketBufferTest::CheckAllocationThroughput),
 
     NL_TEST_SENTINEL()
 };
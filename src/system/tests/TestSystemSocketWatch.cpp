@@ -0,0 +1,365 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This is a unit test suite for the socket watch API of the configured sockets-based
+ *      <tt>chip::System::Layer</tt>, with a benchmark of the wakeup latency and CPU time of
+ *      the event loop with many watched sockets. Run it once per event loop implementation
+ *      (chip_system_config_event_loop = "Select" or "Epoll") to compare them.
+ *
+ */
+
+#include <system/SystemConfig.h>
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <nlunit-test.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayerImpl.h>
+
+#if CHIP_SYSTEM_CONFIG_USE_SOCKETS
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/select.h>
+#include <time.h>
+#include <unistd.h>
+
+#if !CHIP_SYSTEM_CONFIG_USE_POSIX_PIPE
+#include <sys/eventfd.h>
+#endif
+
+using namespace chip;
+using namespace chip::System;
+
+namespace {
+
+// Number of sockets the benchmark tries to watch. The select() loop is further limited by its watch pool and FD_SETSIZE.
+constexpr size_t kBenchmarkWatchCount = 1000;
+
+// Number of single-socket wakeups measured by the benchmark.
+constexpr uint32_t kBenchmarkWakeupCount = 2000;
+
+/*
+ * A readable descriptor that can be made ready on demand: an eventfd, or a pipe on platforms without one.
+ */
+struct Notifier
+{
+    int mReadFd             = kInvalidFd;
+    int mWriteFd            = kInvalidFd;
+    SocketWatchToken mWatch = 0;
+    uint32_t mCallbackCount = 0;
+    SocketEvents mLastEvents;
+
+    bool Open()
+    {
+#if CHIP_SYSTEM_CONFIG_USE_POSIX_PIPE
+        int fds[2];
+        VerifyOrReturnError(::pipe(fds) == 0, false);
+        ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL, 0) | O_NONBLOCK);
+        mReadFd  = fds[0];
+        mWriteFd = fds[1];
+#else
+        mReadFd  = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        mWriteFd = mReadFd;
+#endif
+        return mReadFd >= 0;
+    }
+
+    void Close()
+    {
+        if (mWriteFd != mReadFd && mWriteFd >= 0)
+        {
+            ::close(mWriteFd);
+        }
+        if (mReadFd >= 0)
+        {
+            ::close(mReadFd);
+        }
+        mReadFd = mWriteFd = kInvalidFd;
+    }
+
+    void Notify()
+    {
+        uint64_t value = 1;
+        ssize_t res    = ::write(mWriteFd, &value, mWriteFd == mReadFd ? sizeof(value) : 1);
+        (void) res;
+    }
+
+    void Drain()
+    {
+        uint64_t value;
+        while (::read(mReadFd, &value, sizeof(value)) > 0)
+        {
+        }
+    }
+
+    static void HandleIO(SocketEvents events, intptr_t data)
+    {
+        Notifier * notifier = reinterpret_cast<Notifier *>(data);
+        notifier->mCallbackCount++;
+        notifier->mLastEvents = events;
+        notifier->Drain();
+    }
+};
+
+struct TestContext
+{
+    LayerImpl mSystemLayer;
+    Notifier mNotifiers[kBenchmarkWatchCount];
+    size_t mWatchCount = 0;
+
+    // Watch up to aCount notifiers, stopping early once the layer (or the process) runs out of room.
+    size_t WatchNotifiers(size_t aCount)
+    {
+        for (mWatchCount = 0; mWatchCount < aCount; mWatchCount++)
+        {
+            Notifier & notifier = mNotifiers[mWatchCount];
+            if (!notifier.Open())
+            {
+                break;
+            }
+            // Keep within FD_SETSIZE so that the same number of sockets can be compared across implementations.
+            if (notifier.mReadFd >= FD_SETSIZE ||
+                mSystemLayer.StartWatchingSocket(notifier.mReadFd, &notifier.mWatch) != CHIP_NO_ERROR)
+            {
+                notifier.Close();
+                break;
+            }
+            mSystemLayer.SetCallback(notifier.mWatch, Notifier::HandleIO, reinterpret_cast<intptr_t>(&notifier));
+            mSystemLayer.RequestCallbackOnPendingRead(notifier.mWatch);
+        }
+        return mWatchCount;
+    }
+
+    void UnwatchNotifiers()
+    {
+        for (size_t i = 0; i < mWatchCount; i++)
+        {
+            mSystemLayer.StopWatchingSocket(&mNotifiers[i].mWatch);
+            mNotifiers[i].Close();
+            mNotifiers[i] = Notifier();
+        }
+        mWatchCount = 0;
+    }
+
+    void ServiceEvents()
+    {
+        mSystemLayer.PrepareEvents();
+        mSystemLayer.WaitForEvents();
+        mSystemLayer.HandleEvents();
+    }
+};
+
+uint64_t ThreadCpuMicroseconds()
+{
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000u + static_cast<uint64_t>(ts.tv_nsec) / 1000u;
+}
+
+void TestReadCallback(nlTestSuite * inSuite, void * aContext)
+{
+    TestContext & context = *static_cast<TestContext *>(aContext);
+
+    NL_TEST_ASSERT(inSuite, context.WatchNotifiers(2) == 2);
+    Notifier & first  = context.mNotifiers[0];
+    Notifier & second = context.mNotifiers[1];
+
+    // Only the notified socket gets a callback.
+    first.Notify();
+    context.ServiceEvents();
+    NL_TEST_ASSERT(inSuite, first.mCallbackCount == 1);
+    NL_TEST_ASSERT(inSuite, first.mLastEvents.Has(SocketEventFlags::kRead));
+    NL_TEST_ASSERT(inSuite, second.mCallbackCount == 0);
+
+    // Data left unread is reported again on the next pass.
+    auto countOnly = [](SocketEvents, intptr_t data) { reinterpret_cast<Notifier *>(data)->mCallbackCount++; };
+    second.Notify();
+    context.mSystemLayer.SetCallback(second.mWatch, countOnly, reinterpret_cast<intptr_t>(&second));
+    context.ServiceEvents();
+    context.ServiceEvents();
+    NL_TEST_ASSERT(inSuite, second.mCallbackCount == 2);
+    second.Drain();
+
+    // No callback once read interest is cleared.
+    first.Notify();
+    NL_TEST_ASSERT(inSuite, context.mSystemLayer.ClearCallbackOnPendingRead(first.mWatch) == CHIP_NO_ERROR);
+    second.Notify();
+    context.ServiceEvents();
+    NL_TEST_ASSERT(inSuite, first.mCallbackCount == 1);
+    NL_TEST_ASSERT(inSuite, second.mCallbackCount == 3);
+    second.Drain();
+
+    // ...and the pending data is reported as soon as it is requested again.
+    NL_TEST_ASSERT(inSuite, context.mSystemLayer.RequestCallbackOnPendingRead(first.mWatch) == CHIP_NO_ERROR);
+    context.ServiceEvents();
+    NL_TEST_ASSERT(inSuite, first.mCallbackCount == 2);
+
+    // A descriptor can't be watched twice.
+    SocketWatchToken duplicate;
+    NL_TEST_ASSERT(inSuite, context.mSystemLayer.StartWatchingSocket(first.mReadFd, &duplicate) == CHIP_ERROR_INVALID_ARGUMENT);
+
+    context.UnwatchNotifiers();
+}
+
+void TestStopWatchingFromCallback(nlTestSuite * inSuite, void * aContext)
+{
+    TestContext & context = *static_cast<TestContext *>(aContext);
+
+    NL_TEST_ASSERT(inSuite, context.WatchNotifiers(2) == 2);
+    Notifier & first  = context.mNotifiers[0];
+    Notifier & second = context.mNotifiers[1];
+
+    // Whichever callback runs first stops watching the other socket, so exactly one callback must be delivered.
+    static TestContext * sContext = nullptr;
+    sContext                      = &context;
+    auto stopOther                = [](SocketEvents, intptr_t data) {
+        Notifier * notifier = reinterpret_cast<Notifier *>(data);
+        Notifier * other    = (notifier == &sContext->mNotifiers[0]) ? &sContext->mNotifiers[1] : &sContext->mNotifiers[0];
+        notifier->mCallbackCount++;
+        notifier->Drain();
+        sContext->mSystemLayer.StopWatchingSocket(&other->mWatch);
+    };
+    context.mSystemLayer.SetCallback(first.mWatch, stopOther, reinterpret_cast<intptr_t>(&first));
+    context.mSystemLayer.SetCallback(second.mWatch, stopOther, reinterpret_cast<intptr_t>(&second));
+
+    first.Notify();
+    second.Notify();
+    context.ServiceEvents();
+    NL_TEST_ASSERT(inSuite, first.mCallbackCount + second.mCallbackCount == 1);
+
+    // Stop watching the surviving socket too, then clean up the descriptors.
+    Notifier & survivor = (first.mCallbackCount == 1) ? first : second;
+    context.mSystemLayer.StopWatchingSocket(&survivor.mWatch);
+    for (size_t i = 0; i < context.mWatchCount; i++)
+    {
+        context.mNotifiers[i].Close();
+        context.mNotifiers[i] = Notifier();
+    }
+    context.mWatchCount = 0;
+
+    // Nothing is left to report.
+    context.mSystemLayer.ScheduleWork([](Layer *, void *) {}, nullptr);
+    context.ServiceEvents();
+}
+
+/**
+ * Watch as many sockets as the layer allows (up to kBenchmarkWatchCount), then repeatedly make a single one of them readable
+ * and run the event loop until its callback fires, measuring the wall clock and CPU time per wakeup.
+ */
+void BenchmarkWakeups(nlTestSuite * inSuite, void * aContext)
+{
+    TestContext & context = *static_cast<TestContext *>(aContext);
+
+    const size_t watchCount = context.WatchNotifiers(kBenchmarkWatchCount);
+    NL_TEST_ASSERT(inSuite, watchCount > 0);
+    VerifyOrReturn(watchCount > 0);
+
+    uint32_t passes                     = 0;
+    const uint64_t cpuStart             = ThreadCpuMicroseconds();
+    System::Clock::Microseconds64 start = System::SystemClock().GetMonotonicMicroseconds64();
+    for (uint32_t i = 0; i < kBenchmarkWakeupCount; i++)
+    {
+        Notifier & notifier = context.mNotifiers[(i * 7919u) % watchCount];
+        uint32_t expected   = notifier.mCallbackCount + 1;
+
+        notifier.Notify();
+        while (notifier.mCallbackCount != expected && passes < 4 * kBenchmarkWakeupCount)
+        {
+            context.ServiceEvents();
+            passes++;
+        }
+    }
+    System::Clock::Microseconds64 elapsed = System::SystemClock().GetMonotonicMicroseconds64() - start;
+    const uint64_t cpuElapsed             = ThreadCpuMicroseconds() - cpuStart;
+
+    uint64_t callbacks = 0;
+    for (size_t i = 0; i < watchCount; i++)
+    {
+        callbacks += context.mNotifiers[i].mCallbackCount;
+    }
+
+    ChipLogProgress(chipSystemLayer, "%u wakeups with %u watched sockets: %" PRIu64 "us (%" PRIu64 "us CPU), %u loop passes",
+                    static_cast<unsigned>(kBenchmarkWakeupCount), static_cast<unsigned>(watchCount), elapsed.count(), cpuElapsed,
+                    static_cast<unsigned>(passes));
+    ChipLogProgress(chipSystemLayer, "Mean wakeup latency: %" PRIu64 "ns", elapsed.count() * 1000u / kBenchmarkWakeupCount);
+
+    NL_TEST_ASSERT(inSuite, callbacks == kBenchmarkWakeupCount);
+    NL_TEST_ASSERT(inSuite, passes < 2 * kBenchmarkWakeupCount);
+
+    context.UnwatchNotifiers();
+}
+
+int TestSetup(void * aContext)
+{
+    TestContext & context = *static_cast<TestContext *>(aContext);
+
+    if (chip::Platform::MemoryInit() != CHIP_NO_ERROR)
+    {
+        return FAILURE;
+    }
+    return (context.mSystemLayer.Init() == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+int TestTeardown(void * aContext)
+{
+    TestContext & context = *static_cast<TestContext *>(aContext);
+    context.UnwatchNotifiers();
+    CHIP_ERROR err = context.mSystemLayer.Shutdown();
+    chip::Platform::MemoryShutdown();
+    return (err == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+} // namespace
+
+// Test Suite
+
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+// clang-format off
+static const nlTest sTests[] =
+{
+    NL_TEST_DEF("SocketWatch::TestReadCallback",              TestReadCallback),
+    NL_TEST_DEF("SocketWatch::TestStopWatchingFromCallback",  TestStopWatchingFromCallback),
+    NL_TEST_DEF("SocketWatch::BenchmarkWakeups",              BenchmarkWakeups),
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+static nlTestSuite kTheSuite = { "chip-system-socket-watch", sTests, TestSetup, TestTeardown };
+
+int TestSystemSocketWatch(void)
+{
+    static TestContext context;
+
+    nlTestRunner(&kTheSuite, &context);
+
+    return nlTestRunnerStats(&kTheSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestSystemSocketWatch)
+#else  // CHIP_SYSTEM_CONFIG_USE_SOCKETS
+int TestSystemSocketWatch(void)
+{
+    return SUCCESS;
+}
+#endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS
@@ -404,6 +404,199 @@ void chip::System::TestTimer::CheckTimerPool(nlTestSuite * inSuite, void * aCont
     NL_TEST_ASSERT(suite, SYSTEM_STATS_TEST_HIGH_WATER_MARK(Stats::kSystemLayer_NumTimers, 4));
 }
 
+#if CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
+namespace {
+
+void HandleWheelTimer(Layer * aLayer, void * aState) {}
+
+} // namespace
+
+// Run the TimerList sequence of CheckTimerPool() against a TimerWheel, plus the cases specific to the wheel.
+static void CheckTimerWheel(nlTestSuite * inSuite, void * aContext)
+{
+    using Timer = TimerWheel::Node;
+    using namespace Clock::Literals;
+
+    TestContext & testContext = *static_cast<TestContext *>(aContext);
+    Layer & systemLayer       = *testContext.mLayer;
+    int states[6];
+
+    const Clock::Timestamp now = SystemClock().GetMonotonicTimestamp();
+    Timer timer0(systemLayer, now + 111_ms, HandleWheelTimer, &states[0]);
+    Timer timer1(systemLayer, now + 100_ms, HandleWheelTimer, &states[1]);
+    Timer timer2(systemLayer, now + 202_ms, HandleWheelTimer, &states[2]);
+    Timer timer3(systemLayer, now + 303_ms, HandleWheelTimer, &states[3]);
+    Timer sameAs0(systemLayer, now + 111_ms, HandleWheelTimer, &states[4]);
+    Timer distant(systemLayer, now + Clock::Milliseconds64(UINT64_C(1) << 40), HandleWheelTimer, &states[5]);
+    Timer late(systemLayer, Clock::Timestamp(1), HandleWheelTimer, &states[5]);
+
+    TimerWheel wheel;
+    NL_TEST_ASSERT(inSuite, wheel.Remove(nullptr) == nullptr);
+    NL_TEST_ASSERT(inSuite, wheel.Remove(nullptr, nullptr) == nullptr);
+    NL_TEST_ASSERT(inSuite, wheel.PopEarliest() == nullptr);
+    NL_TEST_ASSERT(inSuite, wheel.PopIfEarlier(now + 500_ms) == nullptr);
+    NL_TEST_ASSERT(inSuite, wheel.Earliest() == nullptr);
+    NL_TEST_ASSERT(inSuite, wheel.Empty());
+
+    NL_TEST_ASSERT(inSuite, wheel.Add(&timer0) == &timer0);
+    NL_TEST_ASSERT(inSuite, wheel.PopIfEarlier(now + 10_ms) == nullptr);
+    NL_TEST_ASSERT(inSuite, wheel.Add(&timer1) == &timer1);
+    NL_TEST_ASSERT(inSuite, wheel.Add(&timer2) == &timer1);
+    NL_TEST_ASSERT(inSuite, wheel.Add(&timer3) == &timer1);
+    NL_TEST_ASSERT(inSuite, wheel.Remove(&timer1) == &timer0);
+    NL_TEST_ASSERT(inSuite, wheel.Remove(HandleWheelTimer, &states[2]) == &timer2);
+    NL_TEST_ASSERT(inSuite, wheel.Remove(HandleWheelTimer, &states[2]) == nullptr);
+    NL_TEST_ASSERT(inSuite, wheel.Earliest() == &timer0);
+    NL_TEST_ASSERT(inSuite, wheel.PopEarliest() == &timer0);
+    NL_TEST_ASSERT(inSuite, wheel.Earliest() == &timer3);
+    NL_TEST_ASSERT(inSuite, wheel.PopIfEarlier(now + 10_ms) == nullptr);
+    NL_TEST_ASSERT(inSuite, wheel.PopIfEarlier(now + 500_ms) == &timer3);
+    NL_TEST_ASSERT(inSuite, wheel.Empty());
+
+    NL_TEST_ASSERT(inSuite, wheel.Add(&timer3) == &timer3);
+    wheel.Clear();
+    NL_TEST_ASSERT(inSuite, wheel.Empty());
+    NL_TEST_ASSERT(inSuite, wheel.Earliest() == nullptr);
+
+    // Timers with the same expiration time come out in the order they were added, wherever they are in the wheel.
+    wheel.Add(&distant);
+    wheel.Add(&timer3);
+    wheel.Add(&timer0);
+    wheel.Add(&timer2);
+    wheel.Add(&sameAs0);
+    wheel.Add(&timer1);
+    NL_TEST_ASSERT(inSuite, wheel.Earliest() == &timer1);
+    NL_TEST_ASSERT(inSuite, wheel.Add(&late) == &late);
+
+    TimerList early = wheel.ExtractEarlier(now + 200_ms);
+    NL_TEST_ASSERT(inSuite, early.PopEarliest() == &late);
+    NL_TEST_ASSERT(inSuite, early.PopEarliest() == &timer1);
+    NL_TEST_ASSERT(inSuite, early.PopEarliest() == &timer0);
+    NL_TEST_ASSERT(inSuite, early.PopEarliest() == &sameAs0);
+    NL_TEST_ASSERT(inSuite, early.PopEarliest() == nullptr);
+
+    NL_TEST_ASSERT(inSuite, wheel.PopEarliest() == &timer2);
+    NL_TEST_ASSERT(inSuite, wheel.PopIfEarlier(distant.AwakenTime()) == &timer3);
+    NL_TEST_ASSERT(inSuite, wheel.PopIfEarlier(distant.AwakenTime()) == nullptr);
+    NL_TEST_ASSERT(inSuite, wheel.Earliest() == &distant);
+    NL_TEST_ASSERT(inSuite, wheel.PopEarliest() == &distant);
+    NL_TEST_ASSERT(inSuite, wheel.Empty());
+}
+
+/**
+ * Start 100k timers spread over ten minutes (and a few far beyond), cancel a third of them, and expire the rest in 1 s steps,
+ * checking that they come out in order.
+ */
+static void CheckTimerWheelStress(nlTestSuite * inSuite, void * aContext)
+{
+    using Timer = TimerWheel::Node;
+
+    constexpr size_t kTimerCount = 100000;
+    constexpr uint64_t kSpanMs   = 600000;
+    constexpr uint64_t kStepMs   = 1000;
+
+    TestContext & testContext = *static_cast<TestContext *>(aContext);
+    Layer & systemLayer       = *testContext.mLayer;
+
+    Timer ** timers = static_cast<Timer **>(chip::Platform::MemoryCalloc(kTimerCount, sizeof(Timer *)));
+    NL_TEST_ASSERT(inSuite, timers != nullptr);
+    VerifyOrReturn(timers != nullptr);
+
+    const Clock::Timestamp now = SystemClock().GetMonotonicTimestamp();
+    uint32_t seed              = 1;
+    size_t allocated           = 0;
+    for (size_t i = 0; i < kTimerCount; i++)
+    {
+        seed           = seed * 1103515245u + 12345u;
+        uint64_t delay = (seed >> 8) % kSpanMs;
+        if (i % 13 == 0)
+        {
+            delay %= 64;
+        }
+        else if (i % 997 == 0)
+        {
+            delay += UINT64_C(1) << 37;
+        }
+        timers[i] = chip::Platform::New<Timer>(systemLayer, now + Clock::Milliseconds64(delay), HandleWheelTimer,
+                                               reinterpret_cast<void *>(i + 1));
+        if (timers[i] == nullptr)
+        {
+            break;
+        }
+        allocated++;
+    }
+
+    NL_TEST_ASSERT(inSuite, allocated == kTimerCount);
+    if (allocated == kTimerCount)
+    {
+        TimerWheel wheel;
+        size_t expected  = 0;
+        size_t extracted = 0;
+        bool ordered     = true;
+
+        Clock::Microseconds64 start = SystemClock().GetMonotonicMicroseconds64();
+        for (size_t i = 0; i < kTimerCount; i++)
+        {
+            wheel.Add(timers[i]);
+        }
+        const Clock::Microseconds64 addTime = SystemClock().GetMonotonicMicroseconds64() - start;
+
+        start = SystemClock().GetMonotonicMicroseconds64();
+        for (size_t i = 0; i < kTimerCount; i += 3)
+        {
+            ordered &= (wheel.Remove(HandleWheelTimer, reinterpret_cast<void *>(i + 1)) == timers[i]);
+        }
+        const Clock::Microseconds64 cancelTime = SystemClock().GetMonotonicMicroseconds64() - start;
+        expected                               = kTimerCount - (kTimerCount + 2) / 3;
+
+        start                = SystemClock().GetMonotonicMicroseconds64();
+        const Timer * last   = nullptr;
+        auto checkAndAdvance = [&](const Timer * timer) {
+            if (last != nullptr)
+            {
+                // Non-decreasing, and in the order they were added when equal.
+                ordered &= !(timer->AwakenTime() < last->AwakenTime());
+                ordered &= (timer->AwakenTime() != last->AwakenTime()) ||
+                    (reinterpret_cast<uintptr_t>(timer->GetCallback().GetAppState()) >
+                     reinterpret_cast<uintptr_t>(last->GetCallback().GetAppState()));
+            }
+            last = timer;
+            extracted++;
+        };
+        for (uint64_t t = 0; t <= kSpanMs; t += kStepMs)
+        {
+            TimerList expired = wheel.ExtractEarlier(now + Clock::Milliseconds64(t));
+            for (const Timer * timer = expired.PopEarliest(); timer != nullptr; timer = expired.PopEarliest())
+            {
+                ordered &= timer->AwakenTime() < now + Clock::Milliseconds64(t);
+                checkAndAdvance(timer);
+            }
+        }
+        for (const Timer * timer = wheel.PopEarliest(); timer != nullptr; timer = wheel.PopEarliest())
+        {
+            checkAndAdvance(timer);
+        }
+        const Clock::Microseconds64 expireTime = SystemClock().GetMonotonicMicroseconds64() - start;
+
+        ChipLogProgress(Test, "TimerWheel x%u: add %" PRIu64 "us, cancel %u in %" PRIu64 "us, expire %u in %" PRIu64 "us",
+                        static_cast<unsigned>(kTimerCount), addTime.count(), static_cast<unsigned>(kTimerCount - expected),
+                        cancelTime.count(), static_cast<unsigned>(extracted), expireTime.count());
+
+        NL_TEST_ASSERT(inSuite, ordered);
+        NL_TEST_ASSERT(inSuite, extracted == expected);
+        NL_TEST_ASSERT(inSuite, wheel.Empty());
+    }
+
+    for (size_t i = 0; i < allocated; i++)
+    {
+        chip::Platform::Delete(timers[i]);
+    }
+    chip::Platform::MemoryFree(timers);
+}
+
+#endif // CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
 // Test Suite
 
 /**
@@ -416,6 +609,10 @@ static const nlTest sTests[] =
     NL_TEST_DEF("Timer::TestTimerStarvation",      CheckStarvation),
     NL_TEST_DEF("Timer::TestTimerOrder",           CheckOrder),
     NL_TEST_DEF("Timer::TestTimerPool",            chip::System::TestTimer::CheckTimerPool),
+#if CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    NL_TEST_DEF("Timer::TestTimerWheel",           CheckTimerWheel),
+    NL_TEST_DEF("Timer::TestTimerWheelStress",     CheckTimerWheelStress),
+#endif // CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL
     NL_TEST_SENTINEL()
 };
 // clang-format on
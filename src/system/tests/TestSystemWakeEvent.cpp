@@ -27,6 +27,7 @@
 
 #include <system/SystemConfig.h>
 
+#include <lib/support/CHIPMem.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/ErrorStr.h>
 #include <lib/support/UnitTestRegistration.h>
@@ -178,11 +179,20 @@ static nlTestSuite kTheSuite = { "chip-system-wake-event", sTests };
 
 int TestSystemWakeEvent(void)
 {
-    TestContext context;
+    // Socket watches may be allocated from the heap, depending on the System::Layer implementation.
+    if (chip::Platform::MemoryInit() != CHIP_NO_ERROR)
+    {
+        return FAILURE;
+    }
 
-    // Run test suit againt one lContext.
-    nlTestRunner(&kTheSuite, &context);
+    {
+        TestContext context;
+
+        // Run test suit againt one lContext.
+        nlTestRunner(&kTheSuite, &context);
+    }
 
+    chip::Platform::MemoryShutdown();
     return nlTestRunnerStats(&kTheSuite);
 }
 
@@ -40,6 +40,18 @@ namespace {
 constexpr size_t kAESCCMIVLen = 13;
 constexpr size_t kMaxAADLen   = 128;
 
+// The largest encoded packet header (fixed part, source and destination node ids) is 24 bytes, so a batch can keep the
+// additional authenticated data of each message in a much smaller buffer than kMaxAADLen.
+constexpr size_t kMaxBatchAADLen = 32;
+
+// Per-message nonce, additional authenticated data and tag of a batch.
+struct BatchScratch
+{
+    uint8_t iv[kAESCCMIVLen];
+    uint8_t aad[kMaxBatchAADLen];
+    uint8_t tag[kMaxTagLen];
+};
+
 /* Session Establish Key Info */
 constexpr uint8_t SEKeysInfo[] = { 0x53, 0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x4b, 0x65, 0x79, 0x73 };
 
@@ -112,6 +124,12 @@ CHIP_ERROR CryptoContext::InitFromSecret(const ByteSpan & secret, const ByteSpan
 
 #endif
 
+    // Message is encrypted with the I2R key by the session initiator, and with the R2I key by the responder.
+    const KeyUsage encryptionKey = (role == SessionRole::kInitiator) ? kI2RKey : kR2IKey;
+    const KeyUsage decryptionKey = (role == SessionRole::kInitiator) ? kR2IKey : kI2RKey;
+    ReturnErrorOnFailure(mEncryptionKey.Init(mKeys[encryptionKey], Crypto::kAES_CCM128_Key_Length));
+    ReturnErrorOnFailure(mDecryptionKey.Init(mKeys[decryptionKey], Crypto::kAES_CCM128_Key_Length));
+
     mKeyAvailable = true;
     mSessionRole  = role;
 
@@ -192,18 +210,11 @@ CHIP_ERROR CryptoContext::Encrypt(const uint8_t * input, size_t input_length, ui
     else
     {
         VerifyOrReturnError(mKeyAvailable, CHIP_ERROR_INVALID_USE_OF_SESSION_KEY);
-        KeyUsage usage = kR2IKey;
 
         // Message is encrypted before sending. If the secure session was created by session
-        // initiator, we'll use I2R key to encrypt the message that's being transmitted.
-        // Otherwise, we'll use R2I key, as the responder is sending the message.
-        if (mSessionRole == SessionRole::kInitiator)
-        {
-            usage = kI2RKey;
-        }
-
-        ReturnErrorOnFailure(AES_CCM_encrypt(input, input_length, AAD, aadLen, mKeys[usage], Crypto::kAES_CCM128_Key_Length, IV,
-                                             sizeof(IV), output, tag, taglen));
+        // initiator, mEncryptionKey is the I2R key, otherwise it is the R2I key, as the responder
+        // is sending the message.
+        ReturnErrorOnFailure(mEncryptionKey.Encrypt(input, input_length, AAD, aadLen, IV, sizeof(IV), output, tag, taglen));
     }
 
     mac.SetTag(&header, tag, taglen);
@@ -239,20 +250,115 @@ CHIP_ERROR CryptoContext::Decrypt(const uint8_t * input, size_t input_length, ui
     else
     {
         VerifyOrReturnError(mKeyAvailable, CHIP_ERROR_INVALID_USE_OF_SESSION_KEY);
-        KeyUsage usage = kI2RKey;
 
         // Message is decrypted on receive. If the secure session was created by session
-        // initiator, we'll use R2I key to decrypt the message (as it was sent by responder).
-        // Otherwise, we'll use I2R key, as the responder is sending the message.
-        if (mSessionRole == SessionRole::kInitiator)
+        // initiator, mDecryptionKey is the R2I key (as the message was sent by responder).
+        // Otherwise, it is the I2R key, as the initiator is sending the message.
+        ReturnErrorOnFailure(mDecryptionKey.Decrypt(input, input_length, AAD, aadLen, tag, taglen, IV, sizeof(IV), output));
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CryptoContext::EncryptBatch(const EncryptionBatchEntry * entries, size_t count) const
+{
+    VerifyOrReturnError(entries != nullptr || count == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(count <= kMaxBatchSize, CHIP_ERROR_INVALID_ARGUMENT);
+    ReturnErrorCodeIf(count == 0, CHIP_NO_ERROR);
+
+    // Group key contexts only take one message at a time.
+    if (nullptr != mKeyContext)
+    {
+        for (size_t i = 0; i < count; i++)
         {
-            usage = kR2IKey;
+            const EncryptionBatchEntry & entry = entries[i];
+            ReturnErrorOnFailure(Encrypt(entry.input, entry.inputLength, entry.output, *entry.header, *entry.mac));
         }
+        return CHIP_NO_ERROR;
+    }
+
+    VerifyOrReturnError(mKeyAvailable, CHIP_ERROR_INVALID_USE_OF_SESSION_KEY);
+
+    Crypto::AesCcmMessage messages[kMaxBatchSize];
+    BatchScratch scratch[kMaxBatchSize];
+    size_t taglen = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const EncryptionBatchEntry & entry = entries[i];
+
+        VerifyOrReturnError(entry.input != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+        VerifyOrReturnError(entry.inputLength > 0, CHIP_ERROR_INVALID_ARGUMENT);
+        VerifyOrReturnError(entry.output != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+        VerifyOrReturnError(entry.header != nullptr && entry.mac != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+        // The tag length only depends on the security flags, but the whole batch has to share it.
+        const size_t messageTaglen = entry.header->MICTagLength();
+        VerifyOrDie(messageTaglen <= kMaxTagLen);
+        VerifyOrReturnError(i == 0 || messageTaglen == taglen, CHIP_ERROR_INVALID_ARGUMENT);
+        taglen = messageTaglen;
+
+        uint16_t aadLen = sizeof(scratch[i].aad);
+        ReturnErrorOnFailure(GetIV(*entry.header, scratch[i].iv, sizeof(scratch[i].iv)));
+        ReturnErrorOnFailure(GetAdditionalAuthData(*entry.header, scratch[i].aad, aadLen));
 
-        ReturnErrorOnFailure(AES_CCM_decrypt(input, input_length, AAD, aadLen, tag, taglen, mKeys[usage],
-                                             Crypto::kAES_CCM128_Key_Length, IV, sizeof(IV), output));
+        messages[i] = { entry.input, entry.inputLength, scratch[i].aad, aadLen, scratch[i].iv, entry.output, scratch[i].tag };
     }
+
+    ReturnErrorOnFailure(mEncryptionKey.EncryptBatch(messages, count, kAESCCMIVLen, taglen));
+
+    for (size_t i = 0; i < count; i++)
+    {
+        entries[i].mac->SetTag(entries[i].header, scratch[i].tag, taglen);
+    }
+
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR CryptoContext::DecryptBatch(const DecryptionBatchEntry * entries, size_t count) const
+{
+    VerifyOrReturnError(entries != nullptr || count == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(count <= kMaxBatchSize, CHIP_ERROR_INVALID_ARGUMENT);
+    ReturnErrorCodeIf(count == 0, CHIP_NO_ERROR);
+
+    if (nullptr != mKeyContext)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            const DecryptionBatchEntry & entry = entries[i];
+            ReturnErrorOnFailure(Decrypt(entry.input, entry.inputLength, entry.output, *entry.header, *entry.mac));
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    VerifyOrReturnError(mKeyAvailable, CHIP_ERROR_INVALID_USE_OF_SESSION_KEY);
+
+    Crypto::AesCcmMessage messages[kMaxBatchSize];
+    BatchScratch scratch[kMaxBatchSize];
+    size_t taglen = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const DecryptionBatchEntry & entry = entries[i];
+
+        VerifyOrReturnError(entry.input != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+        VerifyOrReturnError(entry.inputLength > 0, CHIP_ERROR_INVALID_ARGUMENT);
+        VerifyOrReturnError(entry.output != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+        VerifyOrReturnError(entry.header != nullptr && entry.mac != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+        const size_t messageTaglen = entry.header->MICTagLength();
+        VerifyOrDie(messageTaglen <= kMaxTagLen);
+        VerifyOrReturnError(i == 0 || messageTaglen == taglen, CHIP_ERROR_INVALID_ARGUMENT);
+        taglen = messageTaglen;
+
+        uint16_t aadLen = sizeof(scratch[i].aad);
+        ReturnErrorOnFailure(GetIV(*entry.header, scratch[i].iv, sizeof(scratch[i].iv)));
+        ReturnErrorOnFailure(GetAdditionalAuthData(*entry.header, scratch[i].aad, aadLen));
+        memcpy(scratch[i].tag, entry.mac->GetTag(), taglen);
+
+        messages[i] = { entry.input, entry.inputLength, scratch[i].aad, aadLen, scratch[i].iv, entry.output, scratch[i].tag };
+    }
+
+    return mDecryptionKey.DecryptBatch(messages, count, kAESCCMIVLen, taglen);
+}
+
 } // namespace chip
@@ -37,11 +37,13 @@ class DLL_EXPORT CryptoContext
 public:
     CryptoContext();
     ~CryptoContext();
-    CryptoContext(CryptoContext &&)      = default;
-    CryptoContext(const CryptoContext &) = default;
-    CryptoContext(Crypto::SymmetricKeyContext * context) : mKeyContext(context){};
-    CryptoContext & operator=(const CryptoContext &) = default;
-    CryptoContext & operator=(CryptoContext &&) = default;
+    CryptoContext(Crypto::SymmetricKeyContext * context) : mKeyAvailable(false), mKeyContext(context){};
+
+    // The session cipher contexts are not shareable.
+    CryptoContext(CryptoContext &&)      = delete;
+    CryptoContext(const CryptoContext &) = delete;
+    CryptoContext & operator=(const CryptoContext &) = delete;
+    CryptoContext & operator=(CryptoContext &&) = delete;
 
     /**
      *    Whether the current node initiated the session, or it is responded to a session request.
@@ -115,6 +117,59 @@ public:
     CHIP_ERROR Decrypt(const uint8_t * input, size_t input_length, uint8_t * output, const PacketHeader & header,
                        const MessageAuthenticationCode & mac) const;
 
+    /**
+     * Largest number of messages passed to one call of EncryptBatch() or DecryptBatch().
+     */
+    static constexpr size_t kMaxBatchSize = 4;
+
+    /**
+     * One message of a batch passed to EncryptBatch(); the fields have the meaning of the arguments of Encrypt().
+     */
+    struct EncryptionBatchEntry
+    {
+        const uint8_t * input;
+        size_t inputLength;
+        uint8_t * output;
+        PacketHeader * header;
+        MessageAuthenticationCode * mac;
+    };
+
+    /**
+     * One message of a batch passed to DecryptBatch(); the fields have the meaning of the arguments of Decrypt().
+     */
+    struct DecryptionBatchEntry
+    {
+        const uint8_t * input;
+        size_t inputLength;
+        uint8_t * output;
+        const PacketHeader * header;
+        const MessageAuthenticationCode * mac;
+    };
+
+    /**
+     * @brief
+     *   Encrypt up to kMaxBatchSize messages with the keys established in the secure channel. The result is the same as
+     *   calling Encrypt() for each message in turn, but the session cipher is set up once for the whole batch.
+     *
+     * @param entries The messages to encrypt
+     * @param count Number of messages
+     *
+     * @return CHIP_ERROR The result of encryption. On failure, some of the messages may have been encrypted.
+     */
+    CHIP_ERROR EncryptBatch(const EncryptionBatchEntry * entries, size_t count) const;
+
+    /**
+     * @brief
+     *   Decrypt up to kMaxBatchSize messages with the keys established in the secure channel. The result is the same as
+     *   calling Decrypt() for each message in turn, but the session cipher is set up once for the whole batch.
+     *
+     * @param entries The messages to decrypt
+     * @param count Number of messages
+     *
+     * @return CHIP_ERROR The result of decryption. On failure, some of the messages may have been decrypted.
+     */
+    CHIP_ERROR DecryptBatch(const DecryptionBatchEntry * entries, size_t count) const;
+
     ByteSpan GetAttestationChallenge() const { return ByteSpan(mKeys[kAttestationChallengeKey], Crypto::kAES_CCM128_Key_Length); }
 
     /**
@@ -143,6 +198,11 @@ private:
     CryptoKey mKeys[KeyUsage::kNumCryptoKeys];
     Crypto::SymmetricKeyContext * mKeyContext = nullptr;
 
+    // Ciphers for the keys used to encrypt and decrypt messages, set up once in InitFromSecret() and reused for every message.
+    // Encrypt() and Decrypt() are logically const, but the cipher state changes with each message.
+    mutable Crypto::AesCcmKeyContext mEncryptionKey;
+    mutable Crypto::AesCcmKeyContext mDecryptionKey;
+
     static CHIP_ERROR GetIV(const PacketHeader & header, uint8_t * iv, size_t len);
 
     // Use unencrypted header as additional authenticated data (AAD) during encryption and decryption.
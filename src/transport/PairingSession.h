@@ -115,7 +115,11 @@ protected:
         return CHIP_ERROR_INTERNAL;
     }
 
-    void SendStatusReport(Messaging::ExchangeContext * exchangeCtxt, uint16_t protocolCode)
+    /**
+     * Send a status report on the given exchange. Once the report has been sent, the exchange closes itself unless a
+     * response is expected; if sending fails, the caller is still responsible for the exchange.
+     */
+    CHIP_ERROR SendStatusReport(Messaging::ExchangeContext * exchangeCtxt, uint16_t protocolCode)
     {
         Protocols::SecureChannel::GeneralStatusCode generalCode = (protocolCode == Protocols::SecureChannel::kProtocolCodeSuccess)
             ? Protocols::SecureChannel::GeneralStatusCode::kSuccess
@@ -131,13 +135,18 @@ protected:
         statusReport.WriteToBuffer(bbuf);
 
         System::PacketBufferHandle msg = bbuf.Finalize();
-        VerifyOrReturn(!msg.IsNull(), ChipLogError(SecureChannel, "Failed to allocate status report message"));
+        if (msg.IsNull())
+        {
+            ChipLogError(SecureChannel, "Failed to allocate status report message");
+            return CHIP_ERROR_NO_MEMORY;
+        }
 
         CHIP_ERROR err = exchangeCtxt->SendMessage(Protocols::SecureChannel::MsgType::StatusReport, std::move(msg));
         if (err != CHIP_NO_ERROR)
         {
             ChipLogError(SecureChannel, "Failed to send status report message. %s", ErrorStr(err));
         }
+        return err;
     }
 
     CHIP_ERROR HandleStatusReport(System::PacketBufferHandle && msg, bool successExpected)
@@ -29,6 +29,8 @@
 #include <lib/support/SafeInt.h>
 #include <transport/SecureMessageCodec.h>
 
+#include <algorithm>
+
 namespace chip {
 
 using System::PacketBuffer;
@@ -99,6 +101,104 @@ CHIP_ERROR Decrypt(const CryptoContext & context, PayloadHeader & payloadHeader,
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR EncryptBatch(const CryptoContext & context, PayloadHeader * payloadHeaders, PacketHeader * packetHeaders,
+                        System::PacketBufferHandle * msgBufs, size_t count)
+{
+    VerifyOrReturnError(count == 0 || (payloadHeaders != nullptr && packetHeaders != nullptr && msgBufs != nullptr),
+                        CHIP_ERROR_INVALID_ARGUMENT);
+
+    for (size_t first = 0; first < count; first += CryptoContext::kMaxBatchSize)
+    {
+        const size_t batchSize = std::min(count - first, CryptoContext::kMaxBatchSize);
+        CryptoContext::EncryptionBatchEntry entries[CryptoContext::kMaxBatchSize];
+        MessageAuthenticationCode macs[CryptoContext::kMaxBatchSize];
+
+        for (size_t i = 0; i < batchSize; i++)
+        {
+            PacketBufferHandle & msgBuf = msgBufs[first + i];
+
+            VerifyOrReturnError(!msgBuf.IsNull(), CHIP_ERROR_INVALID_ARGUMENT);
+            VerifyOrReturnError(!msgBuf->HasChainedBuffer(), CHIP_ERROR_INVALID_MESSAGE_LENGTH);
+            VerifyOrReturnError(msgBuf->TotalLength() <= kMaxAppMessageLen, CHIP_ERROR_MESSAGE_TOO_LONG);
+
+            ReturnErrorOnFailure(payloadHeaders[first + i].EncodeBeforeData(msgBuf));
+
+            uint8_t * data = msgBuf->Start();
+            entries[i]     = { data, msgBuf->TotalLength(), data, &packetHeaders[first + i], &macs[i] };
+        }
+
+        ReturnErrorOnFailure(context.EncryptBatch(entries, batchSize));
+
+        for (size_t i = 0; i < batchSize; i++)
+        {
+            PacketBufferHandle & msgBuf = msgBufs[first + i];
+            uint8_t * data              = msgBuf->Start();
+            uint16_t totalLen           = msgBuf->TotalLength();
+
+            uint16_t taglen = 0;
+            ReturnErrorOnFailure(macs[i].Encode(packetHeaders[first + i], &data[totalLen], msgBuf->AvailableDataLength(), &taglen));
+
+            VerifyOrReturnError(CanCastTo<uint16_t>(totalLen + taglen), CHIP_ERROR_INTERNAL);
+            msgBuf->SetDataLength(static_cast<uint16_t>(totalLen + taglen));
+        }
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR DecryptBatch(const CryptoContext & context, PayloadHeader * payloadHeaders, const PacketHeader * packetHeaders,
+                        System::PacketBufferHandle * msgBufs, size_t count)
+{
+    VerifyOrReturnError(count == 0 || (payloadHeaders != nullptr && packetHeaders != nullptr && msgBufs != nullptr),
+                        CHIP_ERROR_INVALID_ARGUMENT);
+
+#if CHIP_SYSTEM_CONFIG_USE_LWIP
+    // Decrypt() has to copy each message out of its LwIP buffer, so there is nothing to share between them.
+    for (size_t i = 0; i < count; i++)
+    {
+        ReturnErrorOnFailure(Decrypt(context, payloadHeaders[i], packetHeaders[i], msgBufs[i]));
+    }
+#else
+    for (size_t first = 0; first < count; first += CryptoContext::kMaxBatchSize)
+    {
+        const size_t batchSize = std::min(count - first, CryptoContext::kMaxBatchSize);
+        CryptoContext::DecryptionBatchEntry entries[CryptoContext::kMaxBatchSize];
+        MessageAuthenticationCode macs[CryptoContext::kMaxBatchSize];
+
+        for (size_t i = 0; i < batchSize; i++)
+        {
+            PacketBufferHandle & msg          = msgBufs[first + i];
+            const PacketHeader & packetHeader = packetHeaders[first + i];
+            ReturnErrorCodeIf(msg.IsNull(), CHIP_ERROR_INVALID_ARGUMENT);
+
+            uint8_t * data = msg->Start();
+            uint16_t len   = msg->DataLength();
+
+            uint16_t footerLen = packetHeader.MICTagLength();
+            VerifyOrReturnError(footerLen <= len, CHIP_ERROR_INVALID_MESSAGE_LENGTH);
+
+            uint16_t taglen = 0;
+            ReturnErrorOnFailure(macs[i].Decode(packetHeader, &data[len - footerLen], footerLen, &taglen));
+            VerifyOrReturnError(taglen == footerLen, CHIP_ERROR_INTERNAL);
+
+            len = static_cast<uint16_t>(len - taglen);
+            msg->SetDataLength(len);
+
+            entries[i] = { data, len, data, &packetHeader, &macs[i] };
+        }
+
+        ReturnErrorOnFailure(context.DecryptBatch(entries, batchSize));
+
+        for (size_t i = 0; i < batchSize; i++)
+        {
+            ReturnErrorOnFailure(payloadHeaders[first + i].DecodeAndConsume(msgBufs[first + i]));
+        }
+    }
+#endif // CHIP_SYSTEM_CONFIG_USE_LWIP
+
+    return CHIP_NO_ERROR;
+}
+
 } // namespace SecureMessageCodec
 
 } // namespace chip
@@ -69,6 +69,41 @@ CHIP_ERROR Encrypt(const CryptoContext & context, PayloadHeader & payloadHeader,
 CHIP_ERROR Decrypt(const CryptoContext & context, PayloadHeader & payloadHeader, const PacketHeader & packetHeader,
                    System::PacketBufferHandle & msgBuf);
 
+/**
+ * @brief
+ *  Attach the payload headers to several messages for the same peer and encrypt them, with the
+ *  same result as calling Encrypt() for each message in turn. The messages are handed to the
+ *  crypto context in batches of up to CryptoContext::kMaxBatchSize.
+ *
+ * @param context        The crypto context of the session with the peer node
+ * @param payloadHeaders Array of count payload headers, one per message
+ * @param packetHeaders  Array of count packet headers, one per message
+ * @param msgBufs        Array of count message buffers. If the operation is successful, each
+ *                       buffer will be mutated to contain the encrypted message.
+ * @param count          Number of messages
+ * @return A CHIP_ERROR value consistent with the result of the encryption operation. On
+ *         failure, some of the messages may have been encrypted.
+ */
+CHIP_ERROR EncryptBatch(const CryptoContext & context, PayloadHeader * payloadHeaders, PacketHeader * packetHeaders,
+                        System::PacketBufferHandle * msgBufs, size_t count);
+
+/**
+ * @brief
+ *  Decrypt several messages from the same peer, with the same result as calling Decrypt() for
+ *  each message in turn.
+ *
+ * @param context        The crypto context of the session with the peer node
+ * @param payloadHeaders Array of count payload headers that will be recovered from the messages
+ * @param packetHeaders  Array of count packet headers, one per message
+ * @param msgBufs        Array of count message buffers. If the operation is successful, each
+ *                       buffer will be mutated to contain the decrypted message.
+ * @param count          Number of messages
+ * @return A CHIP_ERROR value consistent with the result of the decryption operation. On
+ *         failure, some of the messages may have been decrypted.
+ */
+CHIP_ERROR DecryptBatch(const CryptoContext & context, PayloadHeader * payloadHeaders, const PacketHeader * packetHeaders,
+                        System::PacketBufferHandle * msgBufs, size_t count);
+
 } // namespace SecureMessageCodec
 
 } // namespace chip
@@ -230,8 +230,156 @@ CHIP_ERROR SessionManager::PrepareMessage(const SessionHandle & sessionHandle, P
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR SessionManager::PrepareMessages(const SessionHandle & sessionHandle, PayloadHeader * payloadHeaders,
+                                           System::PacketBufferHandle * messages, EncryptedPacketBufferHandle * preparedMessages,
+                                           size_t count)
+{
+    VerifyOrReturnError(count == 0 || (payloadHeaders != nullptr && messages != nullptr && preparedMessages != nullptr),
+                        CHIP_ERROR_INVALID_ARGUMENT);
+
+    Crypto::SymmetricKeyContext * keyContext = nullptr;
+
+    switch (sessionHandle->GetSessionType())
+    {
+    case Transport::Session::SessionType::kGroup: {
+        auto groupSession = sessionHandle->AsGroupSession();
+        auto * groups     = Credentials::GetGroupDataProvider();
+        VerifyOrReturnError(nullptr != groups, CHIP_ERROR_INTERNAL);
+
+        keyContext = groups->GetKeyContext(groupSession->GetFabricIndex(), groupSession->GetGroupId());
+        VerifyOrReturnError(nullptr != keyContext, CHIP_ERROR_INTERNAL);
+    }
+    break;
+    case Transport::Session::SessionType::kSecure:
+        VerifyOrReturnError(sessionHandle->AsSecureSession() != nullptr, CHIP_ERROR_NOT_CONNECTED);
+        break;
+    default:
+        // Nothing to share between messages that are not encrypted.
+        for (size_t i = 0; i < count; i++)
+        {
+            ReturnErrorOnFailure(PrepareMessage(sessionHandle, payloadHeaders[i], std::move(messages[i]), preparedMessages[i]));
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    for (size_t first = 0, batchSize = 0; first < count && err == CHIP_NO_ERROR; first += batchSize)
+    {
+        // The messages of a secure session batch all take their counter from the same MessageCounter, so control messages
+        // and the others go in separate batches.
+        for (batchSize = 1; first + batchSize < count && batchSize < CryptoContext::kMaxBatchSize; batchSize++)
+        {
+            if (keyContext == nullptr &&
+                IsControlMessage(payloadHeaders[first + batchSize]) != IsControlMessage(payloadHeaders[first]))
+            {
+                break;
+            }
+        }
+
+        err = PrepareMessageBatch(sessionHandle, keyContext, &payloadHeaders[first], &messages[first], &preparedMessages[first],
+                                  batchSize);
+    }
+
+    if (keyContext != nullptr)
+    {
+        keyContext->Release();
+    }
+
+    return err;
+}
+
+CHIP_ERROR SessionManager::PrepareMessageBatch(const SessionHandle & sessionHandle, Crypto::SymmetricKeyContext * groupKeyContext,
+                                               PayloadHeader * payloadHeaders, System::PacketBufferHandle * messages,
+                                               EncryptedPacketBufferHandle * preparedMessages, size_t count)
+{
+    PacketHeader packetHeaders[CryptoContext::kMaxBatchSize];
+    SecureSession * session  = (groupKeyContext == nullptr) ? sessionHandle->AsSecureSession() : nullptr;
+    MessageCounter * counter = (session != nullptr && count > 0) ? &GetSendCounterForPacket(payloadHeaders[0], *session) : nullptr;
+
+    VerifyOrReturnError(count <= CryptoContext::kMaxBatchSize, CHIP_ERROR_INVALID_ARGUMENT);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        PayloadHeader & payloadHeader        = payloadHeaders[i];
+        PacketHeader & packetHeader          = packetHeaders[i];
+        System::PacketBufferHandle & message = messages[i];
+
+        VerifyOrReturnError(!message.IsNull(), CHIP_ERROR_INVALID_ARGUMENT);
+
+        if (IsControlMessage(payloadHeader))
+        {
+            packetHeader.SetSecureSessionControlMsg(true);
+        }
+
+        if (session == nullptr)
+        {
+            // TODO : #11911
+            // Same headers as PrepareMessage() sets for a group session.
+            packetHeader.SetDestinationGroupId(sessionHandle->AsGroupSession()->GetGroupId());
+            packetHeader.SetFlags(Header::SecFlagValues::kPrivacyFlag);
+            packetHeader.SetSessionType(Header::SessionType::kGroupSession);
+            packetHeader.SetSourceNodeId(kUndefinedNodeId);
+            packetHeader.SetSessionId(groupKeyContext->GetKeyHash());
+
+            if (!packetHeader.IsValidGroupMsg())
+            {
+                return CHIP_ERROR_INTERNAL;
+            }
+        }
+        else
+        {
+            // Like PrepareMessage(), take the counter values now and only advance the counter once the messages are
+            // encrypted, so that a batch that fails does not use up any of them.
+            VerifyOrReturnError(&GetSendCounterForPacket(payloadHeader, *session) == counter, CHIP_ERROR_INVALID_ARGUMENT);
+            packetHeader
+                .SetMessageCounter(static_cast<uint32_t>(counter->Value() + i)) //
+                .SetSessionId(session->GetPeerSessionId())                      //
+                .SetSessionType(Header::SessionType::kUnicastSession);
+        }
+
+        // Trace before any encryption
+        CHIP_TRACE_MESSAGE_SENT(payloadHeader, packetHeader, message->Start(), message->TotalLength());
+    }
+
+    CryptoContext groupContext(groupKeyContext);
+    const CryptoContext & context = (session == nullptr) ? groupContext : session->GetCryptoContext();
+    ReturnErrorOnFailure(SecureMessageCodec::EncryptBatch(context, payloadHeaders, packetHeaders, messages, count));
+
+    for (size_t i = 0; i < count && counter != nullptr; i++)
+    {
+        ReturnErrorOnFailure(counter->Advance());
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        ChipLogProgress(Inet,
+                        "Prepared %s message %p of type " ChipLogFormatMessageType " and protocolId " ChipLogFormatProtocolId
+                        " on exchange " ChipLogFormatExchangeId " with MessageCounter:" ChipLogFormatMessageCounter ".",
+                        sessionHandle->GetSessionTypeString(), &preparedMessages[i], payloadHeaders[i].GetMessageType(),
+                        ChipLogValueProtocolId(payloadHeaders[i].GetProtocolID()),
+                        ChipLogValueExchangeIdFromSentHeader(payloadHeaders[i]), packetHeaders[i].GetMessageCounter());
+
+        ReturnErrorOnFailure(packetHeaders[i].EncodeBeforeData(messages[i]));
+        preparedMessages[i] = EncryptedPacketBufferHandle::MarkEncrypted(std::move(messages[i]));
+    }
+
+    return CHIP_NO_ERROR;
+}
+
 CHIP_ERROR SessionManager::SendPreparedMessage(const SessionHandle & sessionHandle,
                                                const EncryptedPacketBufferHandle & preparedMessage)
+{
+    return SendPreparedMessage(sessionHandle, preparedMessage, false);
+}
+
+CHIP_ERROR SessionManager::QueuePreparedMessage(const SessionHandle & sessionHandle,
+                                                const EncryptedPacketBufferHandle & preparedMessage)
+{
+    return SendPreparedMessage(sessionHandle, preparedMessage, true);
+}
+
+CHIP_ERROR SessionManager::SendPreparedMessage(const SessionHandle & sessionHandle,
+                                               const EncryptedPacketBufferHandle & preparedMessage, bool queue)
 {
     VerifyOrReturnError(mState == State::kInitialized, CHIP_ERROR_INCORRECT_STATE);
     VerifyOrReturnError(!preparedMessage.IsNull(), CHIP_ERROR_INVALID_ARGUMENT);
@@ -296,6 +444,10 @@ CHIP_ERROR SessionManager::SendPreparedMessage(const SessionHandle & sessionHand
 
     if (mTransportMgr != nullptr)
     {
+        if (queue)
+        {
+            return mTransportMgr->QueueMessage(*destination, std::move(msgBuf));
+        }
         return mTransportMgr->SendMessage(*destination, std::move(msgBuf));
     }
     else
@@ -139,12 +139,37 @@ public:
     CHIP_ERROR PrepareMessage(const SessionHandle & session, PayloadHeader & payloadHeader, System::PacketBufferHandle && msgBuf,
                               EncryptedPacketBufferHandle & encryptedMessage);
 
+    /**
+     * @brief
+     *   Prepare several messages for the same session, such as the chunks of a report, with the same
+     *   result as calling PrepareMessage() for each of them in turn.
+     *
+     * @details
+     *   Messages for secure and group sessions are encrypted in batches, so the session cipher (or
+     *   the group key) is looked up once for all of them rather than once per message.  Each message
+     *   still gets its own message counter, in order, and the counter is only advanced past the
+     *   messages of a batch once they are encrypted.  On failure, the messages of the batches before
+     *   the failing one are prepared already.
+     */
+    CHIP_ERROR PrepareMessages(const SessionHandle & session, PayloadHeader * payloadHeaders, System::PacketBufferHandle * msgBufs,
+                               EncryptedPacketBufferHandle * encryptedMessages, size_t count);
+
     /**
      * @brief
      *   Send a prepared message to a currently connected peer.
      */
     CHIP_ERROR SendPreparedMessage(const SessionHandle & session, const EncryptedPacketBufferHandle & preparedMessage);
 
+    /**
+     * @brief
+     *   Queue a prepared message to be sent to a currently connected peer with the others queued in the
+     *   same event loop pass, see TransportMgrBase::QueueMessage.
+     *
+     *   An error in sending the message once the queue is flushed is only logged, so this is meant for
+     *   messages whose loss the sender recovers from anyway, such as MRP retransmissions.
+     */
+    CHIP_ERROR QueuePreparedMessage(const SessionHandle & session, const EncryptedPacketBufferHandle & preparedMessage);
+
     /// @brief Set the delegate for handling incoming messages. There can be only one message delegate (probably the
     /// ExchangeManager)
     void SetMessageDelegate(SessionMessageDelegate * cb) { mCB = cb; }
@@ -291,6 +316,17 @@ private:
 
     void OnReceiveError(CHIP_ERROR error, const Transport::PeerAddress & source);
 
+    CHIP_ERROR SendPreparedMessage(const SessionHandle & sessionHandle, const EncryptedPacketBufferHandle & preparedMessage,
+                                   bool queue);
+
+    /**
+     * Prepare up to CryptoContext::kMaxBatchSize messages for a secure or group session.  groupKeyContext is the key of the
+     * group for a group session, and null otherwise.
+     */
+    CHIP_ERROR PrepareMessageBatch(const SessionHandle & sessionHandle, Crypto::SymmetricKeyContext * groupKeyContext,
+                                   PayloadHeader * payloadHeaders, System::PacketBufferHandle * msgBufs,
+                                   EncryptedPacketBufferHandle * encryptedMessages, size_t count);
+
     static bool IsControlMessage(PayloadHeader & payloadHeader)
     {
         return payloadHeader.HasMessageType(Protocols::SecureChannel::MsgType::MsgCounterSyncReq) ||
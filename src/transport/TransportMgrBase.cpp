@@ -27,6 +27,16 @@ CHIP_ERROR TransportMgrBase::SendMessage(const Transport::PeerAddress & address,
     return mTransport->SendMessage(address, std::move(msgBuf));
 }
 
+CHIP_ERROR TransportMgrBase::QueueMessage(const Transport::PeerAddress & address, System::PacketBufferHandle && msgBuf)
+{
+    return mTransport->QueueMessage(address, std::move(msgBuf));
+}
+
+CHIP_ERROR TransportMgrBase::FlushQueuedMessages()
+{
+    return mTransport->FlushQueuedMessages();
+}
+
 void TransportMgrBase::Disconnect(const Transport::PeerAddress & address)
 {
     mTransport->Disconnect(address);
@@ -37,6 +37,17 @@ public:
 
     CHIP_ERROR SendMessage(const Transport::PeerAddress & address, System::PacketBufferHandle && msgBuf);
 
+    /**
+     * Queue a message to be sent together with the others queued in the same event loop pass.
+     * See Transport::Base::QueueMessage.
+     */
+    CHIP_ERROR QueueMessage(const Transport::PeerAddress & address, System::PacketBufferHandle && msgBuf);
+
+    /**
+     * Send the messages queued by QueueMessage now, rather than at the end of the event loop pass.
+     */
+    CHIP_ERROR FlushQueuedMessages();
+
     void Close();
 
     void Disconnect(const Transport::PeerAddress & address);
@@ -65,6 +65,23 @@ public:
      */
     virtual CHIP_ERROR SendMessage(const PeerAddress & address, System::PacketBufferHandle && msgBuf) = 0;
 
+    /**
+     * @brief Queue a message to be sent to the specified target before the event loop next waits.
+     *
+     * Transports that can send several messages at once send those queued in one event loop pass together. Errors that
+     * only show when the queued messages are sent are logged rather than returned. Other transports send the message
+     * right away.
+     */
+    virtual CHIP_ERROR QueueMessage(const PeerAddress & address, System::PacketBufferHandle && msgBuf)
+    {
+        return SendMessage(address, std::move(msgBuf));
+    }
+
+    /**
+     * Send the messages queued by QueueMessage now.
+     */
+    virtual CHIP_ERROR FlushQueuedMessages() { return CHIP_NO_ERROR; }
+
     /**
      * Determine if this transport can SendMessage to the specified peer address.
      *
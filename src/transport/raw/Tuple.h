@@ -86,6 +86,13 @@ public:
         return SendMessageImpl<0>(address, std::move(msgBuf));
     }
 
+    CHIP_ERROR QueueMessage(const PeerAddress & address, System::PacketBufferHandle && msgBuf) override
+    {
+        return QueueMessageImpl<0>(address, std::move(msgBuf));
+    }
+
+    CHIP_ERROR FlushQueuedMessages() override { return FlushQueuedMessagesImpl<0>(); }
+
     CHIP_ERROR MulticastGroupJoinLeave(const Transport::PeerAddress & address, bool join) override
     {
         return MulticastGroupJoinLeaveImpl<0>(address, join);
@@ -208,6 +215,60 @@ private:
         return CHIP_ERROR_NO_MESSAGE_HANDLER;
     }
 
+    /**
+     * Recursive queuemessage implementation iterating through transport members.
+     *
+     * Message is queued on the first transport from index N or above, which returns 'CanSendToPeer'
+     *
+     * @tparam N the index of the underlying transport to run QueueMessage through.
+     *
+     * @param address where to send the message
+     * @param msgBuf the message to send.  Includes all CHIP message fields except optional length.
+     */
+    template <size_t N, typename std::enable_if<(N < sizeof...(TransportTypes))>::type * = nullptr>
+    CHIP_ERROR QueueMessageImpl(const PeerAddress & address, System::PacketBufferHandle && msgBuf)
+    {
+        Base * base = &std::get<N>(mTransports);
+        if (base->CanSendToPeer(address))
+        {
+            return base->QueueMessage(address, std::move(msgBuf));
+        }
+        return QueueMessageImpl<N + 1>(address, std::move(msgBuf));
+    }
+
+    /**
+     * QueueMessageImpl when N is out of range. Always returns an error code.
+     */
+    template <size_t N, typename std::enable_if<(N >= sizeof...(TransportTypes))>::type * = nullptr>
+    CHIP_ERROR QueueMessageImpl(const PeerAddress & address, System::PacketBufferHandle msgBuf)
+    {
+        return CHIP_ERROR_NO_MESSAGE_HANDLER;
+    }
+
+    /**
+     * Recursive flush implementation iterating through transport members.
+     *
+     * Every transport is flushed; the first error is returned.
+     *
+     * @tparam N the index of the underlying transport to flush
+     */
+    template <size_t N, typename std::enable_if<(N < sizeof...(TransportTypes))>::type * = nullptr>
+    CHIP_ERROR FlushQueuedMessagesImpl()
+    {
+        CHIP_ERROR err     = std::get<N>(mTransports).FlushQueuedMessages();
+        CHIP_ERROR nextErr = FlushQueuedMessagesImpl<N + 1>();
+        return (err != CHIP_NO_ERROR) ? err : nextErr;
+    }
+
+    /**
+     * FlushQueuedMessagesImpl template for out of range N.
+     */
+    template <size_t N, typename std::enable_if<(N >= sizeof...(TransportTypes))>::type * = nullptr>
+    CHIP_ERROR FlushQueuedMessagesImpl()
+    {
+        return CHIP_NO_ERROR;
+    }
+
     /**
      * Recursive GroupJoinLeave implementation iterating through transport members.
      *
@@ -89,6 +89,9 @@ void UDP::Close()
 {
     if (mUDPEndPoint)
     {
+        // Whoever queued these messages expects them to be sent.
+        FlushQueuedMessages();
+
         // Udp endpoint is only non null if udp endpoint is initialized and listening
         mUDPEndPoint->Close();
         mUDPEndPoint->Free();
@@ -113,6 +116,75 @@ CHIP_ERROR UDP::SendMessage(const Transport::PeerAddress & address, System::Pack
     return mUDPEndPoint->SendMsg(&addrInfo, std::move(msgBuf));
 }
 
+CHIP_ERROR UDP::QueueMessage(const Transport::PeerAddress & address, System::PacketBufferHandle && msgBuf)
+{
+    VerifyOrReturnError(address.GetTransportType() == Type::kUdp, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(mState == State::kInitialized, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(mUDPEndPoint != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    if (mSendQueueLength == kSendQueueSize)
+    {
+        // Whatever fails to go out is logged: it belongs to the callers that queued it, not to this one.
+        FlushQueuedMessages();
+    }
+
+    Inet::IPPacketInfo & addrInfo = mSendQueueInfo[mSendQueueLength];
+    addrInfo.Clear();
+
+    addrInfo.DestAddress = address.GetIPAddress();
+    addrInfo.DestPort    = address.GetPort();
+    addrInfo.Interface   = address.GetInterface();
+
+    mSendQueue[mSendQueueLength++] = std::move(msgBuf);
+
+    // A timer rather than ScheduleWork, so that Close can cancel it on every platform. If it can not be started, nothing
+    // would send the message later, so send it now; it is the only one queued, so the error is its own.
+    if (mSendQueueLength == 1 &&
+        mUDPEndPoint->GetSystemLayer().StartTimer(System::Clock::kZero, HandleFlushQueuedMessages, this) != CHIP_NO_ERROR)
+    {
+        return FlushQueuedMessages();
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR UDP::FlushQueuedMessages()
+{
+    VerifyOrReturnError(mSendQueueLength > 0, CHIP_NO_ERROR);
+
+    mUDPEndPoint->GetSystemLayer().CancelTimer(HandleFlushQueuedMessages, this);
+
+    const size_t count = mSendQueueLength;
+    mSendQueueLength   = 0;
+
+    // A message that can not be sent is dropped, but does not hold back the ones queued after it.
+    CHIP_ERROR firstErr = CHIP_NO_ERROR;
+    for (size_t offset = 0; offset < count;)
+    {
+        size_t sentCount = 0;
+        CHIP_ERROR err   = mUDPEndPoint->SendMsgs(&mSendQueueInfo[offset], &mSendQueue[offset], count - offset, sentCount);
+        offset += sentCount;
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(Inet, "Failed to send queued UDP message: %s", ErrorStr(err));
+            firstErr = (firstErr == CHIP_NO_ERROR) ? err : firstErr;
+            offset++;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        mSendQueue[i] = nullptr;
+    }
+
+    return firstErr;
+}
+
+void UDP::HandleFlushQueuedMessages(System::Layer * systemLayer, void * appState)
+{
+    static_cast<UDP *>(appState)->FlushQueuedMessages();
+}
+
 void UDP::OnUdpReceive(Inet::UDPEndPoint * endPoint, System::PacketBufferHandle && buffer, const Inet::IPPacketInfo * pktInfo)
 {
     CHIP_ERROR err          = CHIP_NO_ERROR;
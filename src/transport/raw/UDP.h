@@ -131,6 +131,18 @@ public:
 
     CHIP_ERROR SendMessage(const Transport::PeerAddress & address, System::PacketBufferHandle && msgBuf) override;
 
+    /**
+     * Queue a message to be sent with the others queued before the event loop next waits.
+     *
+     * The queued messages are sent with one UDPEndPoint::SendMsgs call, either from a zero-delay timer started when the
+     * first one is queued, or when one more is queued while INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE messages are waiting.
+     * Messages passed to SendMessage meanwhile are sent right away, ahead of the queued ones. The error returned is only
+     * ever about this message; errors in sending the queued messages are logged.
+     */
+    CHIP_ERROR QueueMessage(const Transport::PeerAddress & address, System::PacketBufferHandle && msgBuf) override;
+
+    CHIP_ERROR FlushQueuedMessages() override;
+
     CHIP_ERROR MulticastGroupJoinLeave(const Transport::PeerAddress & address, bool join) override;
 
     bool CanListenMulticast() override
@@ -151,9 +163,17 @@ private:
 
     static void OnUdpError(Inet::UDPEndPoint * endPoint, CHIP_ERROR err, const Inet::IPPacketInfo * pktInfo);
 
+    static void HandleFlushQueuedMessages(System::Layer * systemLayer, void * appState);
+
+    static constexpr size_t kSendQueueSize = INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE;
+
     Inet::UDPEndPoint * mUDPEndPoint     = nullptr;                       ///< UDP socket used by the transport
     Inet::IPAddressType mUDPEndpointType = Inet::IPAddressType::kUnknown; ///< Socket listening type
     State mState                         = State::kNotReady;              ///< State of the UDP transport
+
+    Inet::IPPacketInfo mSendQueueInfo[kSendQueueSize];    ///< Destinations of the queued messages
+    System::PacketBufferHandle mSendQueue[kSendQueueSize]; ///< Messages waiting for FlushQueuedMessages
+    size_t mSendQueueLength = 0;                           ///< Number of queued messages
 };
 
 } // namespace Transport
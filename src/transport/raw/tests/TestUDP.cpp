@@ -26,13 +26,19 @@
 #include <lib/core/CHIPCore.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/UnitTestRegistration.h>
+#include <system/SystemClock.h>
 #include <transport/TransportMgr.h>
 #include <transport/raw/UDP.h>
 
+#if CHIP_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_TEST
+#include <inet/UDPEndPointImplSockets.h>
+#endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_TEST
+
 #include <nlbyteorder.h>
 #include <nlunit-test.h>
 
 #include <errno.h>
+#include <inttypes.h>
 
 using namespace chip;
 using namespace chip::Inet;
@@ -161,6 +167,239 @@ void CheckMessageTest6(nlTestSuite * inSuite, void * inContext)
     CheckMessageTest(inSuite, inContext, addr);
 }
 
+/////////////////////////// Queued messages test
+
+void CheckQueuedMessageTest(nlTestSuite * inSuite, void * inContext, const IPAddress & addr)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    constexpr int kMessageCount = 3;
+
+    Transport::UDP udp;
+
+    CHIP_ERROR err =
+        udp.Init(Transport::UdpListenParameters(ctx.GetUDPEndPointManager()).SetAddressType(addr.Type()).SetListenPort(0));
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    MockTransportMgrDelegate gMockTransportMgrDelegate(inSuite);
+    TransportMgrBase gTransportMgrBase;
+    gTransportMgrBase.SetSessionManager(&gMockTransportMgrDelegate);
+    gTransportMgrBase.Init(&udp);
+
+    ReceiveHandlerCallCount = 0;
+
+    PacketHeader header;
+    header.SetSourceNodeId(kSourceNodeId).SetDestinationNodeId(kDestinationNodeId).SetMessageCounter(kMessageCounter);
+
+    for (int i = 0; i < kMessageCount; i++)
+    {
+        chip::System::PacketBufferHandle buffer = chip::System::PacketBufferHandle::NewWithData(PAYLOAD, sizeof(PAYLOAD));
+        NL_TEST_ASSERT(inSuite, !buffer.IsNull());
+
+        err = header.EncodeBeforeData(buffer);
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+        err = gTransportMgrBase.QueueMessage(Transport::PeerAddress::UDP(addr, udp.GetBoundPort()), std::move(buffer));
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    }
+
+    // The queued messages are sent by the event loop, without an explicit flush.
+    ctx.DriveIOUntil(chip::System::Clock::Seconds16(1), []() { return ReceiveHandlerCallCount == kMessageCount; });
+
+    NL_TEST_ASSERT(inSuite, ReceiveHandlerCallCount == kMessageCount);
+}
+
+void CheckQueuedMessageTest4(nlTestSuite * inSuite, void * inContext)
+{
+    IPAddress addr;
+    IPAddress::FromString("127.0.0.1", addr);
+    CheckQueuedMessageTest(inSuite, inContext, addr);
+}
+
+void CheckQueuedMessageTest6(nlTestSuite * inSuite, void * inContext)
+{
+    IPAddress addr;
+    IPAddress::FromString("::1", addr);
+    CheckQueuedMessageTest(inSuite, inContext, addr);
+}
+
+void CheckQueuedMessageCloseTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    IPAddress addr;
+    IPAddress::FromString("::1", addr);
+
+    {
+        Transport::UDP udp;
+
+        CHIP_ERROR err =
+            udp.Init(Transport::UdpListenParameters(ctx.GetUDPEndPointManager()).SetAddressType(addr.Type()).SetListenPort(0));
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+        PacketHeader header;
+        header.SetSourceNodeId(kSourceNodeId).SetDestinationNodeId(kDestinationNodeId).SetMessageCounter(kMessageCounter);
+
+        chip::System::PacketBufferHandle buffer = chip::System::PacketBufferHandle::NewWithData(PAYLOAD, sizeof(PAYLOAD));
+        NL_TEST_ASSERT(inSuite, !buffer.IsNull());
+        NL_TEST_ASSERT(inSuite, header.EncodeBeforeData(buffer) == CHIP_NO_ERROR);
+
+        err = udp.QueueMessage(Transport::PeerAddress::UDP(addr, udp.GetBoundPort()), std::move(buffer));
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    }
+
+    // The transport is gone with its flush still pending: the flush must not run.
+    ctx.DriveIO();
+}
+
+void CheckQueuedMessageErrorTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    constexpr int kMessageCount = INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE + 1;
+
+    IPAddress addr;
+    IPAddress::FromString("::1", addr);
+
+    Transport::UDP udp;
+
+    CHIP_ERROR err =
+        udp.Init(Transport::UdpListenParameters(ctx.GetUDPEndPointManager()).SetAddressType(addr.Type()).SetListenPort(0));
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    MockTransportMgrDelegate gMockTransportMgrDelegate(inSuite);
+    TransportMgrBase gTransportMgrBase;
+    gTransportMgrBase.SetSessionManager(&gMockTransportMgrDelegate);
+    gTransportMgrBase.Init(&udp);
+
+    ReceiveHandlerCallCount = 0;
+
+    PacketHeader header;
+    header.SetSourceNodeId(kSourceNodeId).SetDestinationNodeId(kDestinationNodeId).SetMessageCounter(kMessageCounter);
+
+    // The first message can not be sent, since port 0 is not a valid destination. The queue is full when the last one is
+    // queued, which sends the others: their errors must not be returned for the last message.
+    for (int i = 0; i < kMessageCount; i++)
+    {
+        chip::System::PacketBufferHandle buffer = chip::System::PacketBufferHandle::NewWithData(PAYLOAD, sizeof(PAYLOAD));
+        NL_TEST_ASSERT(inSuite, !buffer.IsNull());
+        NL_TEST_ASSERT(inSuite, header.EncodeBeforeData(buffer) == CHIP_NO_ERROR);
+
+        const uint16_t port = (i == 0) ? 0 : udp.GetBoundPort();
+        err                 = udp.QueueMessage(Transport::PeerAddress::UDP(addr, port), std::move(buffer));
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    }
+
+    // The message that failed does not hold back the others.
+    ctx.DriveIOUntil(chip::System::Clock::Seconds16(1), []() { return ReceiveHandlerCallCount == kMessageCount - 1; });
+
+    NL_TEST_ASSERT(inSuite, ReceiveHandlerCallCount == kMessageCount - 1);
+}
+
+/////////////////////////// Batched send benchmark
+
+constexpr int kBenchmarkRounds        = 16;
+constexpr int kBenchmarkRoundMessages = 32;
+
+// Sends kBenchmarkRounds bursts of messages to itself, with one SendMessage call per message or queued and flushed
+// together, and returns the time spent sending. Each burst is received before the next one is sent, so that none is
+// dropped for lack of socket buffer space.
+chip::System::Clock::Microseconds64 SendBursts(nlTestSuite * inSuite, TestContext & ctx, Transport::UDP & udp,
+                                               const IPAddress & addr, bool queue)
+{
+    chip::System::Clock::Microseconds64 sendTime(0);
+
+    PacketHeader header;
+    header.SetSourceNodeId(kSourceNodeId).SetDestinationNodeId(kDestinationNodeId).SetMessageCounter(kMessageCounter);
+
+    const Transport::PeerAddress peer = Transport::PeerAddress::UDP(addr, udp.GetBoundPort());
+
+    for (int round = 0; round < kBenchmarkRounds; round++)
+    {
+        chip::System::PacketBufferHandle buffers[kBenchmarkRoundMessages];
+        for (auto & buffer : buffers)
+        {
+            buffer = chip::System::PacketBufferHandle::NewWithData(PAYLOAD, sizeof(PAYLOAD));
+            NL_TEST_ASSERT(inSuite, !buffer.IsNull());
+            NL_TEST_ASSERT(inSuite, header.EncodeBeforeData(buffer) == CHIP_NO_ERROR);
+        }
+
+        ReceiveHandlerCallCount = 0;
+
+        const chip::System::Clock::Microseconds64 start = chip::System::SystemClock().GetMonotonicMicroseconds64();
+        for (auto & buffer : buffers)
+        {
+            CHIP_ERROR err = queue ? udp.QueueMessage(peer, std::move(buffer)) : udp.SendMessage(peer, std::move(buffer));
+            NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+        }
+        if (queue)
+        {
+            NL_TEST_ASSERT(inSuite, udp.FlushQueuedMessages() == CHIP_NO_ERROR);
+        }
+        sendTime += chip::System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+        ctx.DriveIOUntil(chip::System::Clock::Seconds16(1), []() { return ReceiveHandlerCallCount == kBenchmarkRoundMessages; });
+        NL_TEST_ASSERT(inSuite, ReceiveHandlerCallCount == kBenchmarkRoundMessages);
+    }
+
+    return sendTime;
+}
+
+void CheckSendBatchBenchmark(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    constexpr int kMessageCount = kBenchmarkRounds * kBenchmarkRoundMessages;
+
+    IPAddress addr;
+    IPAddress::FromString("::1", addr);
+
+    Transport::UDP udp;
+
+    CHIP_ERROR err =
+        udp.Init(Transport::UdpListenParameters(ctx.GetUDPEndPointManager()).SetAddressType(addr.Type()).SetListenPort(0));
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    MockTransportMgrDelegate gMockTransportMgrDelegate(inSuite);
+    TransportMgrBase gTransportMgrBase;
+    gTransportMgrBase.SetSessionManager(&gMockTransportMgrDelegate);
+    gTransportMgrBase.Init(&udp);
+
+#if CHIP_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_TEST
+    uint32_t syscalls = Inet::UDPEndPointImplSockets::SendSyscallCount();
+#endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_TEST
+
+    const chip::System::Clock::Microseconds64 loopTime = SendBursts(inSuite, ctx, udp, addr, false);
+
+#if CHIP_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_TEST
+    const uint32_t loopSyscalls = Inet::UDPEndPointImplSockets::SendSyscallCount() - syscalls;
+    syscalls                    = Inet::UDPEndPointImplSockets::SendSyscallCount();
+#endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_TEST
+
+    const chip::System::Clock::Microseconds64 batchTime = SendBursts(inSuite, ctx, udp, addr, true);
+
+    ChipLogProgress(Inet, "Sent %d messages one at a time in %" PRIu64 " us, %" PRIu64 " messages/s", kMessageCount,
+                    loopTime.count(), kMessageCount * UINT64_C(1000000) / (loopTime.count() + 1));
+    ChipLogProgress(Inet, "Sent %d messages in batches of up to %d in %" PRIu64 " us, %" PRIu64 " messages/s",
+                    kMessageCount, INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE, batchTime.count(),
+                    kMessageCount * UINT64_C(1000000) / (batchTime.count() + 1));
+
+#if CHIP_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_TEST
+    const uint32_t batchSyscalls = Inet::UDPEndPointImplSockets::SendSyscallCount() - syscalls;
+    ChipLogProgress(Inet, "Send system calls: %" PRIu32 " one at a time, %" PRIu32 " batched", loopSyscalls,
+                    batchSyscalls);
+
+    NL_TEST_ASSERT(inSuite, loopSyscalls == kMessageCount);
+#if HAVE_SENDMMSG
+    constexpr int kBatchesPerRound =
+        (kBenchmarkRoundMessages + INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE - 1) / INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE;
+    NL_TEST_ASSERT(inSuite, batchSyscalls == kBenchmarkRounds * kBatchesPerRound);
+#else
+    NL_TEST_ASSERT(inSuite, batchSyscalls == kMessageCount);
+#endif // HAVE_SENDMMSG
+#endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_TEST
+}
+
 // Test Suite
 
 /**
@@ -170,12 +409,17 @@ void CheckMessageTest6(nlTestSuite * inSuite, void * inContext)
 static const nlTest sTests[] =
 {
 #if INET_CONFIG_ENABLE_IPV4
-    NL_TEST_DEF("Simple Init Test IPV4",   CheckSimpleInitTest4),
-    NL_TEST_DEF("Message Self Test IPV4",  CheckMessageTest4),
+    NL_TEST_DEF("Simple Init Test IPV4",     CheckSimpleInitTest4),
+    NL_TEST_DEF("Message Self Test IPV4",    CheckMessageTest4),
+    NL_TEST_DEF("Queued Message Test IPV4",  CheckQueuedMessageTest4),
 #endif
 
-    NL_TEST_DEF("Simple Init Test IPV6",   CheckSimpleInitTest6),
-    NL_TEST_DEF("Message Self Test IPV6",  CheckMessageTest6),
+    NL_TEST_DEF("Simple Init Test IPV6",     CheckSimpleInitTest6),
+    NL_TEST_DEF("Message Self Test IPV6",    CheckMessageTest6),
+    NL_TEST_DEF("Queued Message Test IPV6",  CheckQueuedMessageTest6),
+    NL_TEST_DEF("Queued Message Close Test", CheckQueuedMessageCloseTest),
+    NL_TEST_DEF("Queued Message Error Test", CheckQueuedMessageErrorTest),
+    NL_TEST_DEF("Send Batch Benchmark",      CheckSendBatchBenchmark),
 
     NL_TEST_SENTINEL()
 };
@@ -196,7 +440,7 @@ static nlTestSuite sSuite =
  */
 static int Initialize(void * aContext)
 {
-    CHIP_ERROR err = reinterpret_cast<TestContext *>(aContext)->Init(&sSuite);
+    CHIP_ERROR err = reinterpret_cast<TestContext *>(aContext)->Init();
     return (err == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
 }
 
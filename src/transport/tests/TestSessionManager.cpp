@@ -33,6 +33,7 @@
 #include <protocols/secure_channel/PASESession.h>
 #include <transport/SessionManager.h>
 #include <transport/TransportMgr.h>
+#include <transport/raw/UDP.h>
 #include <transport/raw/tests/NetworkTestHelpers.h>
 
 #include <nlbyteorder.h>
@@ -203,6 +204,92 @@ void CheckMessageTest(nlTestSuite * inSuite, void * inContext)
     sessionManager.Shutdown();
 }
 
+void PrepareMessagesTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    // More than one batch, so the messages are split across calls to the crypto context.
+    constexpr size_t kMessageCount = CryptoContext::kMaxBatchSize + 2;
+
+    TestSessMgrCallback callback;
+    callback.LargeMessageSent = false;
+
+    IPAddress addr;
+    IPAddress::FromString("::1", addr);
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    TransportMgr<LoopbackTransport> transportMgr;
+    SessionManager sessionManager;
+    secure_channel::MessageCounterManager gMessageCounterManager;
+
+    err = transportMgr.Init("LOOPBACK");
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    err = sessionManager.Init(&ctx.GetSystemLayer(), &transportMgr, &gMessageCounterManager);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    callback.mSuite = inSuite;
+
+    sessionManager.SetMessageDelegate(&callback);
+
+    Optional<Transport::PeerAddress> peer(Transport::PeerAddress::UDP(addr, CHIP_PORT));
+    SessionHolder localToRemoteSession;
+    SessionHolder remoteToLocalSession;
+
+    SecurePairingUsingTestSecret pairing1(1, 2);
+    err =
+        sessionManager.NewPairing(localToRemoteSession, peer, kSourceNodeId, &pairing1, CryptoContext::SessionRole::kInitiator, 1);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    SecurePairingUsingTestSecret pairing2(2, 1);
+    err = sessionManager.NewPairing(remoteToLocalSession, peer, kDestinationNodeId, &pairing2,
+                                    CryptoContext::SessionRole::kResponder, 0);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    PayloadHeader payloadHeaders[kMessageCount];
+    chip::System::PacketBufferHandle buffers[kMessageCount];
+    EncryptedPacketBufferHandle preparedMessages[kMessageCount];
+
+    for (size_t i = 0; i < kMessageCount; i++)
+    {
+        payloadHeaders[i].SetExchangeID(static_cast<uint16_t>(i));
+        payloadHeaders[i].SetMessageType(chip::Protocols::Echo::MsgType::EchoRequest);
+
+        buffers[i] = chip::MessagePacketBuffer::NewWithData(PAYLOAD, sizeof(PAYLOAD));
+        NL_TEST_ASSERT(inSuite, !buffers[i].IsNull());
+    }
+
+    callback.ReceiveHandlerCallCount = 0;
+
+    err = sessionManager.PrepareMessages(localToRemoteSession.Get(), payloadHeaders, buffers, preparedMessages, kMessageCount);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    // Every message gets its own counter, in order.
+    for (size_t i = 1; i < kMessageCount; i++)
+    {
+        NL_TEST_ASSERT(inSuite, preparedMessages[i].GetMessageCounter() == preparedMessages[0].GetMessageCounter() + i);
+    }
+
+    for (auto & preparedMessage : preparedMessages)
+    {
+        err = sessionManager.SendPreparedMessage(localToRemoteSession.Get(), preparedMessage);
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    }
+
+    NL_TEST_ASSERT(inSuite, callback.ReceiveHandlerCallCount == static_cast<int>(kMessageCount));
+
+    // The session counter moved past every message of the batches, and no further.
+    PayloadHeader payloadHeader;
+    payloadHeader.SetMessageType(chip::Protocols::Echo::MsgType::EchoRequest);
+    EncryptedPacketBufferHandle nextMessage;
+    err = sessionManager.PrepareMessage(localToRemoteSession.Get(), payloadHeader,
+                                        chip::MessagePacketBuffer::NewWithData(PAYLOAD, sizeof(PAYLOAD)), nextMessage);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, nextMessage.GetMessageCounter() == preparedMessages[0].GetMessageCounter() + kMessageCount);
+
+    sessionManager.Shutdown();
+}
+
 void SendEncryptedPacketTest(nlTestSuite * inSuite, void * inContext)
 {
     TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
@@ -459,6 +546,90 @@ void StaleConnectionDropTest(nlTestSuite * inSuite, void * inContext)
     sessionManager.Shutdown();
 }
 
+void ReceiveCopiesTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    // Enough messages for several batched reads.
+    constexpr int kMessageCount = 3 * INET_CONFIG_UDP_SOCKET_RECEIVE_BATCH_SIZE;
+
+    TestSessMgrCallback callback;
+    callback.LargeMessageSent = false;
+    callback.mSuite           = inSuite;
+
+    IPAddress addr;
+    IPAddress::FromString("::1", addr);
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    TransportMgr<Transport::UDP> transportMgr;
+    SessionManager sessionManager;
+    secure_channel::MessageCounterManager gMessageCounterManager;
+
+    err = transportMgr.Init(
+        Transport::UdpListenParameters(ctx.GetUDPEndPointManager()).SetAddressType(IPAddressType::kIPv6).SetListenPort(0));
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    err = sessionManager.Init(&ctx.GetSystemLayer(), &transportMgr, &gMessageCounterManager);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    sessionManager.SetMessageDelegate(&callback);
+
+    const uint16_t port = transportMgr.GetTransport().GetImplAtIndex<0>().GetBoundPort();
+    Optional<Transport::PeerAddress> peer(Transport::PeerAddress::UDP(addr, port));
+    SessionHolder localToRemoteSession;
+    SessionHolder remoteToLocalSession;
+
+    SecurePairingUsingTestSecret pairing1(1, 2);
+    err =
+        sessionManager.NewPairing(localToRemoteSession, peer, kSourceNodeId, &pairing1, CryptoContext::SessionRole::kInitiator, 1);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    SecurePairingUsingTestSecret pairing2(2, 1);
+    err = sessionManager.NewPairing(remoteToLocalSession, peer, kDestinationNodeId, &pairing2,
+                                    CryptoContext::SessionRole::kResponder, 0);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    callback.ReceiveHandlerCallCount = 0;
+
+    PayloadHeader payloadHeader;
+    payloadHeader.SetExchangeID(0);
+    payloadHeader.SetMessageType(chip::Protocols::Echo::MsgType::EchoRequest);
+
+    for (int i = 0; i < kMessageCount; i++)
+    {
+        chip::System::PacketBufferHandle buffer = chip::MessagePacketBuffer::NewWithData(PAYLOAD, sizeof(PAYLOAD));
+        NL_TEST_ASSERT(inSuite, !buffer.IsNull());
+
+        EncryptedPacketBufferHandle preparedMessage;
+        err = sessionManager.PrepareMessage(localToRemoteSession.Get(), payloadHeader, std::move(buffer), preparedMessage);
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+        err = sessionManager.SendPreparedMessage(localToRemoteSession.Get(), preparedMessage);
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    }
+
+    // Everything from here on is the receive path: reading the datagrams, decrypting them and passing them to the delegate.
+    chip::System::PacketBufferCounters::Enable();
+    const uint32_t allocations = chip::System::PacketBufferCounters::Allocations();
+    const uint32_t copies      = chip::System::PacketBufferCounters::Copies();
+
+    ctx.DriveIOUntil(chip::System::Clock::Seconds16(1), [&callback]() { return callback.ReceiveHandlerCallCount == kMessageCount; });
+    NL_TEST_ASSERT(inSuite, callback.ReceiveHandlerCallCount == kMessageCount);
+
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_COUNTERS && CHIP_SYSTEM_CONFIG_USE_SOCKETS
+    // One buffer per message, plus those a batched read keeps ready for the next one, and no copies at all.
+    NL_TEST_ASSERT(inSuite,
+                   chip::System::PacketBufferCounters::Allocations() - allocations <=
+                       kMessageCount + INET_CONFIG_UDP_SOCKET_RECEIVE_BATCH_SIZE);
+    NL_TEST_ASSERT(inSuite, chip::System::PacketBufferCounters::Copies() == copies);
+#else
+    IgnoreUnusedVariable(allocations);
+    IgnoreUnusedVariable(copies);
+#endif // CHIP_SYSTEM_CONFIG_PACKETBUFFER_COUNTERS && CHIP_SYSTEM_CONFIG_USE_SOCKETS
+
+    sessionManager.Shutdown();
+}
+
 // Test Suite
 
 /**
@@ -469,9 +640,11 @@ const nlTest sTests[] =
 {
     NL_TEST_DEF("Simple Init Test",               CheckSimpleInitTest),
     NL_TEST_DEF("Message Self Test",              CheckMessageTest),
+    NL_TEST_DEF("Prepare Messages Test",          PrepareMessagesTest),
     NL_TEST_DEF("Send Encrypted Packet Test",     SendEncryptedPacketTest),
     NL_TEST_DEF("Send Bad Encrypted Packet Test", SendBadEncryptedPacketTest),
     NL_TEST_DEF("Drop stale connection Test",     StaleConnectionDropTest),
+    NL_TEST_DEF("Receive Copies Test",            ReceiveCopiesTest),
 
     NL_TEST_SENTINEL()
 };